@@ -0,0 +1,313 @@
+#!/bin/bash
+###############################################################################
+# GraphTool
+#   Tools for manipulating graphs
+###############################################################################
+# Authored by Samuel Grossman
+# Department of Electrical Engineering, Stanford University
+# Copyright (c) 2016-2017
+###############################################################################
+# bench/bench.sh
+#   Benchmark harness that measures the throughput of every reader, writer,
+#   and transformation on synthetic graphs. Invoked by "make bench".
+###############################################################################
+#
+# Usage: bench.sh <path-to-graphtool>
+#
+# Configuration comes from the environment, so it can also be given to make:
+#   BENCH_SCALES       Base-2 logarithms of the vertex counts.   Default: "12 14 16"
+#   BENCH_EDGEFACTOR   Edges per vertex.                         Default: 16
+#   BENCH_THREADS      Thread counts, or "all" for every core.   Default: "1 all"
+#   BENCH_REPEATS      Runs per measurement; the median is kept. Default: 5
+#   BENCH_WORKDIR      Directory for generated graphs and output. Default: output/bench
+#   BENCH_OUTPUT       File that receives a copy of the results. Default: $BENCH_WORKDIR/results.tsv
+#
+# Each result is one tab-separated line, in a fixed order, so that the results
+# of two builds can be compared directly with diff or a spreadsheet:
+#   component kind, component name, graph, scale, edges, threads,
+#   median edges/s, median MB/s, peak resident set size in kilobytes
+#
+# Components are measured through the statistics that graphtool writes with
+# --statsfile: readers by the "read" phase, writers by the "write" phase, and
+# transformations by the "transform" phase.
+#
+# Thread counts are limited by restricting the CPU affinity of graphtool with
+# taskset, which the topology library respects when sizing thread pools.
+#
+# Before measuring with each thread count, every graph is converted to a text
+# edge list with --stream=true and the edges in the output are counted, so
+# that a streamed conversion that loses or duplicates edges fails the run.
+# Every graph is also reordered by degree once grouped by source and once
+# grouped by destination, and the run fails unless both permutations match and
+# list the vertices in descending order of in-degree plus out-degree.
+###############################################################################
+
+set -e
+set -o pipefail
+
+
+# --------- CONFIGURATION -----------------------------------------------------
+
+GRAPHTOOL="$1"
+
+BENCH_SCALES="${BENCH_SCALES:-12 14 16}"
+BENCH_EDGEFACTOR="${BENCH_EDGEFACTOR:-16}"
+BENCH_THREADS="${BENCH_THREADS:-1 all}"
+BENCH_REPEATS="${BENCH_REPEATS:-5}"
+BENCH_WORKDIR="${BENCH_WORKDIR:-output/bench}"
+BENCH_OUTPUT="${BENCH_OUTPUT:-$BENCH_WORKDIR/results.tsv}"
+
+# Canonical names of the formats and transformations registered with the factories.
+# The input files of the readers are converted from a generated text edge list, see WriteReaderInput.
+BENCH_READERS="binaryedgelist compressed mtx snap snapshot textedgelist"
+BENCH_WRITERS="binaryedgelist compressed gap graphmat ligra ligrabinary matrix64 stats textedgelist vectorsparse xstream"
+BENCH_TRANSFORMS="compactvertices dedupedges dedupedgesmax dedupedgesmin dedupedgessum filterdegree filtervertexrange hashedgedata largestcomponent nullfloatedgedata nullintedgedata randomfloatedgedata randomintedgedata removeselfloops reorderdegree reordergorder reorderrcm sortedges symmetrize transpose"
+
+# Synthetic graph generators, see GenerateGraph.
+BENCH_GRAPHS="uniform rmat"
+
+if [ -z "$GRAPHTOOL" ] || [ ! -x "$GRAPHTOOL" ]; then
+    echo "Usage: $0 <path-to-graphtool>" >&2
+    exit 1
+fi
+
+if ! command -v taskset > /dev/null 2>&1; then
+    echo "$0: taskset is required to control the number of threads." >&2
+    exit 1
+fi
+
+NUM_CORES=$(nproc)
+mkdir -p "$BENCH_WORKDIR"
+
+
+# --------- HELPERS -----------------------------------------------------------
+
+# Writes a synthetic graph as a text edge list.
+# A Park-Miller generator implemented in integer arithmetic makes the graph identical on every machine, regardless of the awk implementation.
+# "uniform" picks both endpoints of each edge uniformly at random.
+# "rmat" uses the recursive matrix model with the Graph500 parameters (A=0.57, B=0.19, C=0.19), producing a skewed degree distribution.
+# Arguments: graph name, scale, edge factor, output file
+GenerateGraph()
+{
+    awk -v graph="$1" -v scale="$2" -v edgefactor="$3" 'BEGIN {
+        numVertices = 2 ^ scale;
+        numEdges = numVertices * edgefactor;
+        state = 20170101;
+
+        printf "%d\n%d\n", numVertices, numEdges;
+
+        for (e = 0; e < numEdges; ++e)
+        {
+            if ("uniform" == graph)
+            {
+                state = (state * 48271) % 2147483647; src = state % numVertices;
+                state = (state * 48271) % 2147483647; dst = state % numVertices;
+            }
+            else
+            {
+                src = 0; dst = 0;
+
+                for (bit = numVertices / 2; bit >= 1; bit /= 2)
+                {
+                    state = (state * 48271) % 2147483647;
+                    r = state / 2147483647;
+
+                    if (r >= 0.57)
+                    {
+                        if (r < 0.76)      dst += bit;
+                        else if (r < 0.95) src += bit;
+                        else             { src += bit; dst += bit; }
+                    }
+                }
+            }
+
+            printf "%d %d\n", src, dst;
+        }
+    }' > "$4"
+}
+
+# Writes the input file of a reader by converting the text edge list of a graph.
+# Formats that graphtool can write are converted by graphtool, snapshots are saved by graphtool while reading the text edge list, and the others are produced by rewriting the lines of the text edge list.
+# Arguments: reader, base name of the graph files
+WriteReaderInput()
+{
+    case "$1" in
+        mtx)
+            # Matrix Market coordinates are 1-based, and a pattern matrix holds no values.
+            awk 'NR == 1 { numVertices = $1; next }
+                 NR == 2 { printf "%%%%MatrixMarket matrix coordinate pattern general\n%d %d %d\n", numVertices, numVertices, $1; next }
+                 { printf "%d %d\n", $1 + 1, $2 + 1; }' "$2.textedgelist" > "$2.mtx"
+            ;;
+        snap)
+            # The counts go in a comment, so that the file is read only once.
+            awk 'NR == 1 { numVertices = $1; next }
+                 NR == 2 { printf "# Nodes: %d Edges: %d\n", numVertices, $1; next }
+                 { printf "%d\t%d\n", $1, $2; }' "$2.textedgelist" > "$2.snap"
+            ;;
+        snapshot)
+            RunGraphTool all "$BENCH_WORKDIR/stats.json" "--inputfile=$2.textedgelist" --inputformat=textedgelist "--savesnapshot=$2.snapshot" "--outputfile=$BENCH_WORKDIR/output" --outputformat=binaryedgelist
+            ;;
+        *)
+            RunGraphTool all "$BENCH_WORKDIR/stats.json" "--inputfile=$2.textedgelist" --inputformat=textedgelist "--outputfile=$2.$1" "--outputformat=$1"
+            ;;
+    esac
+}
+
+# Runs graphtool with the specified thread count and arguments, writing statistics to the specified file.
+# Arguments: thread count, statistics file, graphtool arguments...
+RunGraphTool()
+{
+    local threads="$1"
+    local statsfile="$2"
+    shift 2
+
+    if [ "all" = "$threads" ]; then
+        threads=$NUM_CORES
+    fi
+
+    taskset -c "0-$((threads - 1))" "$GRAPHTOOL" "$@" "--statsfile=$statsfile" > "$BENCH_WORKDIR/graphtool.log" 2>&1 || {
+        echo "$0: graphtool failed: $*" >&2
+        cat "$BENCH_WORKDIR/graphtool.log" >&2
+        exit 1
+    }
+}
+
+# Extracts a metric of the first phase whose name begins with the specified prefix from a statistics file.
+# Arguments: statistics file, phase name prefix, metric name
+ExtractPhaseMetric()
+{
+    awk -v prefix="\"$2" -v metric="\"$3\":" '
+        $1 == "\"name\":" { inPhase = (index($2, prefix) == 1); }
+        inPhase && $1 == metric { sub(/,$/, "", $2); print $2; exit; }
+    ' "$1"
+}
+
+# Extracts the peak resident set size from a statistics file, in kilobytes.
+# Arguments: statistics file
+ExtractPeakResidentKilobytes()
+{
+    awk '$1 == "\"peakResidentBytes\":" { sub(/,$/, "", $2); printf "%d\n", $2 / 1024; exit; }' "$1"
+}
+
+# Converts a graph to a text edge list with --stream=true and checks that the output holds every edge of the input.
+# The edges are counted as the lines of the output that follow the two lines holding the vertex and edge counts.
+# Arguments: input file, input format, expected edge count, thread count
+VerifyStreamedEdgeCount()
+{
+    local outputfile="$BENCH_WORKDIR/output.textedgelist"
+
+    RunGraphTool "$4" "$BENCH_WORKDIR/stats.json" "--inputfile=$1" "--inputformat=$2" --stream=true "--outputfile=$outputfile" --outputformat=textedgelist
+
+    local written=$(( $(wc -l < "$outputfile") - 2 ))
+    rm -f "$outputfile"
+
+    if [ "$written" -ne "$3" ]; then
+        echo "$0: streamed conversion of $1 with $4 threads wrote $written of $3 edges." >&2
+        exit 1
+    fi
+}
+
+# Reorders a graph by degree once grouped by source and once grouped by destination and checks that both produce the same permutation.
+# The permutation must list every vertex in descending order of in-degree plus out-degree, with ties broken by ascending identifier, as counted from the text edge list.
+# Arguments: base name of the graph files, thread count
+VerifyDegreeOrder()
+{
+    local permutationfile="$BENCH_WORKDIR/permutation"
+
+    for group in source dest; do
+        RunGraphTool "$2" "$BENCH_WORKDIR/stats.json" "--inputfile=$1.binaryedgelist" --inputformat=binaryedgelist --transform=reorderdegree "--transformoptions=permutationfile=$permutationfile.$group" "--outputfile=$BENCH_WORKDIR/output" --outputformat=binaryedgelist "--outputgroup=$group"
+    done
+
+    if ! cmp -s "$permutationfile.source" "$permutationfile.dest"; then
+        rm -f "$permutationfile.source" "$permutationfile.dest"
+        echo "$0: reordering $1 by degree with $2 threads produced different permutations when grouped by source and by destination." >&2
+        exit 1
+    fi
+
+    local misplaced=$(awk 'FNR == NR { if (FNR == 1) n = $1; else if (FNR > 2) { ++d[$1]; ++d[$2]; } next; }
+        { v = $1; if ((FNR > 1) && ((d[v] > d[p]) || ((d[v] == d[p]) && (v < p)))) ++bad; if (v in seen) ++bad; seen[v] = 1; p = v; }
+        END { print bad + ((FNR == n) ? 0 : 1); }' "$1.textedgelist" "$permutationfile.source")
+    rm -f "$permutationfile.source" "$permutationfile.dest"
+
+    if [ "$misplaced" -ne 0 ]; then
+        echo "$0: reordering $1 by degree with $2 threads did not number the vertices in descending order of in-degree plus out-degree." >&2
+        exit 1
+    fi
+}
+
+# Computes the median of the numbers given on standard input, one per line.
+Median()
+{
+    sort -g | awk '{ v[NR] = $1 } END { if (NR == 0) print "0"; else if (NR % 2) printf "%.2f\n", v[(NR + 1) / 2]; else printf "%.2f\n", (v[NR / 2] + v[NR / 2 + 1]) / 2; }'
+}
+
+# Measures a single component by running graphtool repeatedly and prints one result line.
+# Arguments: component kind, component name, graph, scale, edges, threads, phase name prefix, graphtool arguments...
+Measure()
+{
+    local kind="$1" name="$2" graph="$3" scale="$4" edges="$5" threads="$6" phase="$7"
+    shift 7
+
+    local statsfile="$BENCH_WORKDIR/stats.json"
+    local edgerates="" byterates="" peakkb=0
+
+    for ((run = 0; run < BENCH_REPEATS; ++run)); do
+        rm -f "$statsfile"
+        RunGraphTool "$threads" "$statsfile" "$@"
+
+        edgerates+="$(ExtractPhaseMetric "$statsfile" "$phase" edgesPerSecond)"$'\n'
+        byterates+="$(ExtractPhaseMetric "$statsfile" "$phase" megabytesPerSecond)"$'\n'
+
+        local runkb=$(ExtractPeakResidentKilobytes "$statsfile")
+        if [ "$runkb" -gt "$peakkb" ]; then
+            peakkb=$runkb
+        fi
+    done
+
+    printf "%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\n" "$kind" "$name" "$graph" "$scale" "$edges" "$threads" "$(printf "%s" "$edgerates" | Median)" "$(printf "%s" "$byterates" | Median)" "$peakkb" | tee -a "$BENCH_OUTPUT"
+}
+
+
+# --------- BENCHMARKS --------------------------------------------------------
+
+printf "# kind\tname\tgraph\tscale\tedges\tthreads\tedges_per_sec\tmb_per_sec\tpeak_rss_kb\n" | tee "$BENCH_OUTPUT"
+
+for graph in $BENCH_GRAPHS; do
+    for scale in $BENCH_SCALES; do
+        edges=$(( (1 << scale) * BENCH_EDGEFACTOR ))
+        base="$BENCH_WORKDIR/$graph-$scale"
+
+        # Generate the graph once and convert it to the input format of every reader.
+        if [ ! -f "$base.textedgelist" ]; then
+            GenerateGraph "$graph" "$scale" "$BENCH_EDGEFACTOR" "$base.textedgelist"
+        fi
+
+        for reader in $BENCH_READERS; do
+            if [ ! -f "$base.$reader" ]; then
+                WriteReaderInput "$reader" "$base"
+            fi
+        done
+
+        for threads in $BENCH_THREADS; do
+            VerifyStreamedEdgeCount "$base.binaryedgelist" binaryedgelist "$edges" "$threads"
+            VerifyDegreeOrder "$base" "$threads"
+
+            for reader in $BENCH_READERS; do
+                Measure reader "$reader" "$graph" "$scale" "$edges" "$threads" read "--inputfile=$base.$reader" "--inputformat=$reader" "--outputfile=$BENCH_WORKDIR/output" --outputformat=binaryedgelist
+            done
+
+            # The synthetic reader generates a graph of the same model and size instead of reading a file.
+            Measure reader synthetic "$graph" "$scale" "$edges" "$threads" read "--inputfile=$graph-$scale" --inputformat=synthetic "--inputoptions=generator=$graph,scale=$scale,edgefactor=$BENCH_EDGEFACTOR" "--outputfile=$BENCH_WORKDIR/output" --outputformat=binaryedgelist
+
+            for writer in $BENCH_WRITERS; do
+                Measure writer "$writer" "$graph" "$scale" "$edges" "$threads" write "--inputfile=$base.binaryedgelist" --inputformat=binaryedgelist "--outputfile=$BENCH_WORKDIR/output" "--outputformat=$writer"
+            done
+
+            for transform in $BENCH_TRANSFORMS; do
+                Measure transform "$transform" "$graph" "$scale" "$edges" "$threads" transform "--inputfile=$base.binaryedgelist" --inputformat=binaryedgelist "--transform=$transform" "--outputfile=$BENCH_WORKDIR/output" --outputformat=binaryedgelist
+            done
+        done
+    done
+done
+
+rm -f "$BENCH_WORKDIR/output" "$BENCH_WORKDIR/output.ini" "$BENCH_WORKDIR/output.config" "$BENCH_WORKDIR/output.idx" "$BENCH_WORKDIR/output.adj" "$BENCH_WORKDIR/stats.json" "$BENCH_WORKDIR/graphtool.log"
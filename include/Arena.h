@@ -0,0 +1,214 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file Arena.h
+ *   Declaration of a simple NUMA-aware bump allocator used to hold large
+ *   numbers of small graph objects.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Allocates memory by bumping a pointer within large chunks obtained from the operating system.
+    /// Individual allocations are never freed; instead, all memory is released at once when the arena is destroyed.
+    /// Chunks are NUMA-local to the node specified at construction and are backed by 2 MB huge pages where available.
+    /// Not thread-safe; each thread that allocates concurrently should use its own arena.
+    class Arena
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the alignment, in bytes, of every allocation made from an arena.
+        static const size_t kAllocationAlignment = 16;
+
+        /// Specifies the size, in bytes, of each chunk obtained from the operating system.
+        /// Must be a multiple of the huge page size.
+        static const size_t kChunkSize = 64ull * 1024ull * 1024ull;
+
+        /// Specifies the size, in bytes, of a huge page.
+        static const size_t kHugePageSize = 2ull * 1024ull * 1024ull;
+
+
+    private:
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Describes a single chunk of memory owned by an arena.
+        struct SChunk
+        {
+            void* base;                                                     ///< Base address of the chunk.
+            size_t size;                                                    ///< Size of the chunk, in bytes.
+            bool isExplicitHugePage;                                        ///< Specifies that the chunk was mapped directly from the explicit huge page pool, rather than obtained from Silo.
+        };
+
+
+        // -------- CLASS VARIABLES ---------------------------------------- //
+
+        /// Specifies that explicit huge pages should be attempted when obtaining new chunks.
+        /// Cleared the first time such an attempt fails so that the attempt is not repeated for every chunk.
+        static volatile bool tryExplicitHugePages;
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Holds all chunks owned by this arena.
+        std::vector<SChunk> chunks;
+
+        /// Points to the next free byte in the current chunk.
+        uint8_t* nextFree;
+
+        /// Holds the number of bytes remaining in the current chunk.
+        size_t bytesRemaining;
+
+        /// Holds the total number of bytes handed out by this arena.
+        size_t bytesAllocated;
+
+        /// Specifies the NUMA node on which chunks should be allocated.
+        uint32_t numaNode;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Initialization constructor.
+        /// No memory is obtained until the first allocation is made.
+        /// @param [in] numaNode NUMA node on which memory should be allocated.
+        Arena(const uint32_t numaNode);
+
+        /// Destructor.
+        /// Returns all chunks to the operating system.
+        ~Arena(void);
+
+
+    private:
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Obtains a new chunk large enough to hold an allocation of the specified size and makes it current.
+        /// @param [in] size Size of the allocation that triggered the refill, already rounded up to the allocation alignment.
+        /// @return `true` if a chunk was obtained, `false` otherwise.
+        bool Refill(const size_t size);
+
+
+    public:
+        // -------- INSTANCE METHODS --------------------------------------- //
+
+        /// Allocates the specified number of bytes from this arena.
+        /// @param [in] size Number of bytes to allocate.
+        /// @return Pointer to the allocated memory, or `NULL` if memory could not be obtained.
+        inline void* Allocate(size_t size)
+        {
+            size = (size + (kAllocationAlignment - 1)) & ~(kAllocationAlignment - 1);
+
+            if ((size > bytesRemaining) && !Refill(size))
+                return NULL;
+
+            void* const allocation = (void*)nextFree;
+            nextFree += size;
+            bytesRemaining -= size;
+            bytesAllocated += size;
+
+            return allocation;
+        }
+
+        /// Returns the total number of bytes handed out by this arena.
+        /// @return Number of bytes allocated.
+        inline size_t GetBytesAllocated(void) const
+        {
+            return bytesAllocated;
+        }
+    };
+
+
+    /// Adapts an arena for use as a standard library container allocator.
+    /// Deallocation is a no-op, as the memory is reclaimed when the arena is destroyed.
+    /// @tparam T Type of object to allocate.
+    template <typename T> class ArenaAllocator
+    {
+    public:
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Type of object allocated, as required by the standard library.
+        typedef T value_type;
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Arena from which all allocations are made.
+        Arena* arena;
+
+
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Initialization constructor.
+        /// @param [in] arena Arena from which all allocations are to be made.
+        inline ArenaAllocator(Arena& arena) : arena(&arena)
+        {
+            // Nothing to do here.
+        }
+
+        /// Conversion constructor, as required by the standard library.
+        /// @tparam U Type of object allocated by the other allocator.
+        /// @param [in] other Allocator from which to copy the arena.
+        template <typename U> inline ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena)
+        {
+            // Nothing to do here.
+        }
+
+
+        // -------- OPERATORS ---------------------------------------------- //
+
+        /// Compares two allocators for equality, as required by the standard library.
+        /// @tparam U Type of object allocated by the other allocator.
+        /// @param [in] other Allocator to compare.
+        /// @return `true` if both allocators use the same arena, `false` otherwise.
+        template <typename U> inline bool operator==(const ArenaAllocator<U>& other) const
+        {
+            return (arena == other.arena);
+        }
+
+        /// Compares two allocators for inequality, as required by the standard library.
+        /// @tparam U Type of object allocated by the other allocator.
+        /// @param [in] other Allocator to compare.
+        /// @return `true` if the allocators use different arenas, `false` otherwise.
+        template <typename U> inline bool operator!=(const ArenaAllocator<U>& other) const
+        {
+            return (arena != other.arena);
+        }
+
+
+        // -------- INSTANCE METHODS --------------------------------------- //
+
+        /// Allocates storage for the specified number of objects.
+        /// @param [in] n Number of objects.
+        /// Behaves like `new` in that failure to obtain memory results in an exception.
+        /// @return Pointer to the allocated storage.
+        inline T* allocate(size_t n)
+        {
+            T* const allocation = (T*)arena->Allocate(n * sizeof(T));
+
+            if (NULL == allocation)
+                throw std::bad_alloc();
+
+            return allocation;
+        }
+
+        /// Does nothing, as arena memory is only released when the arena is destroyed.
+        /// @param [in] p Pointer to the storage to be deallocated.
+        /// @param [in] n Number of objects.
+        inline void deallocate(T* p, size_t n)
+        {
+            // Nothing to do here.
+        }
+    };
+}
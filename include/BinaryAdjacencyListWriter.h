@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file BinaryAdjacencyListWriter.h
+ *   Declaration of a graph writer for Ligra's binary adjacency list files.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphWriter.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Writer object class for graphs represented in Ligra's binary adjacency list format, which consists of three files that share a common base name.
+    /// The ".config" file holds the number of vertices as text, the ".idx" file holds the offset of each vertex's first edge, and the ".adj" file holds the vertex at the other end of each edge.
+    /// For weighted graphs, the ".adj" file holds the weight of each edge immediately after the last neighbor, as expected by Ligra when built with weights.
+    /// Neighbors and weights are 32-bit values unless the number of vertices requires 64 bits, and offsets are 32-bit values unless the number of edges requires 64 bits, in which case Ligra must be built with "EDGELONG" or "LONG" respectively.
+    /// By default, edges are formatted by all consumer threads in parallel and written to the file in order, and the vertex offsets are likewise computed and written in parallel.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class BinaryAdjacencyListWriter : public GraphWriter<TEdgeData>
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Number of bytes used to represent each neighbor and each weight, determined when the file is opened.
+        size_t neighborSize;
+
+        /// Position within the ".adj" file at which the edge data section begins, determined when the file is opened.
+        int64_t edgeDataSectionPosition;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        BinaryAdjacencyListWriter(void);
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphWriter.h" for documentation.
+
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
+        virtual void FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const;
+        virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual FILE* OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool SupportsDirectIO(void) const;
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsParallelFormatting(void) const;
+        virtual bool UsesSecondaryGraphFile(void) const;
+        virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
+    };
+}
@@ -22,13 +22,48 @@
 namespace GraphTool
 {
     /// Reader object class for graphs represented in binary edge list format.
+    /// Where supported, the file is mapped into memory so that consumer threads can read edges directly from the page cache.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
     template <typename TEdgeData> class BinaryEdgeListReader : public GraphReader<TEdgeData>
     {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Base address of the mapping of the entire file, or `NULL` if the file is not mapped.
+        void* mappingBase;
+
+        /// Size of the mapping, in bytes.
+        size_t mappingSize;
+
+        /// Points to the first edge within the mapping.
+        const SEdge<TEdgeData>* mappedEdges;
+
+        /// Number of complete edges within the mapping.
+        TEdgeCount numMappedEdges;
+
+        /// Position of the next edge to provide from the mapping.
+        TEdgeCount nextMappedEdge;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        BinaryEdgeListReader(void);
+
+        /// Destructor.
+        virtual ~BinaryEdgeListReader(void);
+
+
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "GraphReader.h" for documentation.
         
+        virtual GraphReader<TEdgeData>* CreateShardReader(void) const;
+        virtual bool MapEdgesForRead(FILE* const graphfile);
         virtual FILE* OpenAndInitializeGraphFileForRead(const char* const filename);
+        virtual TEdgeCount ReadEdgesInPlace(const SEdge<TEdgeData>*& edges, const size_t count);
         virtual TEdgeCount ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count);
+        virtual bool SupportsDirectIO(void) const;
+        virtual void UnmapEdgesForRead(void);
     };
 }
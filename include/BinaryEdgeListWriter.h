@@ -28,7 +28,11 @@ namespace GraphTool
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "GraphWriter.h" for documentation.
 
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
         virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool SupportsDirectIO(void) const;
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsStreaming(void) const;
         virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
     };
 }
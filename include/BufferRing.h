@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file BufferRing.h
+ *   Declaration of a bounded queue of buffers that passes data from a single
+ *   producer to several groups of consumers without locks.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    /// Coordinates a single producer and one or more consumers that share a fixed number of buffers, which are used round-robin.
+    /// Each buffer produced is identified by a sequence number, starting at 0, and occupies the buffer whose index is that sequence number modulo the depth of the ring.
+    /// Every consumer consumes every buffer, in order, so a buffer becomes free only once all consumers have released it.
+    /// The producer can therefore run up to one full ring ahead of the slowest consumer, and consumers wait only when no buffer is ready, rather than all threads meeting at a barrier after every buffer.
+    /// A consumer may be a group of threads, in which case only one of them should release each buffer, after all of them are done with it.
+    /// The producer may also be a group of threads that fill different buffers at once, in which case each must wait for the buffer before its own to be published before publishing it.
+    /// Object does not own the buffers themselves, only the state that tracks them.
+    class BufferRing
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the largest supported number of buffers.
+        static const uint32_t kMaxDepth = 64;
+
+
+    private:
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Holds the number of buffers a consumer has released, padded to occupy its own cache line so that consumers do not contend.
+        struct SConsumerState
+        {
+            std::atomic<uint64_t> numReleased;                              ///< Number of buffers released by the consumer, which is also the sequence number of the next buffer it will consume.
+            uint8_t padding[64 - sizeof(std::atomic<uint64_t>)];            ///< Unused.
+        };
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Number of buffers in the ring.
+        uint32_t depth;
+
+        /// Number of consumers, each of which consumes every buffer.
+        uint32_t numConsumers;
+
+        /// Number of buffers the producer has published, which is also the sequence number of the next buffer it will produce.
+        std::atomic<uint64_t> numPublished;
+
+        /// State of each consumer.
+        SConsumerState* consumers;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Constructs a ring with the specified number of buffers and consumers, in which every buffer is free.
+        /// @param [in] depth Number of buffers, between 1 and kMaxDepth.
+        /// @param [in] numConsumers Number of consumers.
+        BufferRing(const uint32_t depth, const uint32_t numConsumers);
+
+        /// Destructor.
+        ~BufferRing(void);
+
+
+        // -------- INSTANCE METHODS --------------------------------------- //
+
+        /// Retrieves the index of the buffer that holds the specified buffer in the sequence.
+        /// @param [in] sequence Sequence number.
+        /// @return Index of the buffer.
+        inline uint32_t BufferIndex(const uint64_t sequence) const
+        {
+            return (uint32_t)(sequence % (uint64_t)depth);
+        }
+
+        /// Retrieves the number of buffers in the ring.
+        /// @return Number of buffers.
+        inline uint32_t GetDepth(void) const
+        {
+            return depth;
+        }
+
+        /// Makes the specified buffer in the sequence available to all consumers.
+        /// Invoked only by the producer, or by the thread that filled the buffer in a producer that is a group of threads, once it has finished writing the buffer and anything the consumers read along with it.
+        /// @param [in] sequence Sequence number of the buffer, which must be the next one to be published.
+        void Publish(const uint64_t sequence);
+
+        /// Indicates that the specified consumer is finished with the specified buffer in the sequence, so that the producer can reuse it once all other consumers are also finished with it.
+        /// Invoked only by the consumer, or by a single thread on behalf of a consumer that is a group of threads.
+        /// @param [in] consumer Index of the consumer.
+        /// @param [in] sequence Sequence number of the buffer, which must be the next one to be released by this consumer.
+        void Release(const uint32_t consumer, const uint64_t sequence);
+
+        /// Waits until the specified buffer in the sequence is free for the producer to fill, which happens once every consumer has released whatever the buffer previously held.
+        /// Invoked only by the producer.
+        /// @param [in] sequence Sequence number of the buffer to be filled.
+        /// @return Time spent waiting, in nanoseconds, or 0 if statistics are not being collected.
+        uint64_t WaitForFreeBuffer(const uint64_t sequence) const;
+
+        /// Waits until the producer has published the specified buffer in the sequence.
+        /// Invoked by consumers, and may be invoked by every thread in a consumer that is a group of threads, as well as by the threads of a producer that is a group of threads, so that they publish in order.
+        /// @param [in] sequence Sequence number of the buffer to be consumed.
+        /// @return Time spent waiting, in nanoseconds, or 0 if statistics are not being collected.
+        uint64_t WaitForPublishedBuffer(const uint64_t sequence) const;
+    };
+}
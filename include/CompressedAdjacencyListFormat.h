@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file CompressedAdjacencyListFormat.h
+ *   Declaration of the layout of compressed adjacency list files, shared by
+ *   the reader and the writer.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    /// Header at the start of every compressed adjacency list file.
+    struct SCompressedAdjacencyListFileHeader
+    {
+        uint64_t magic;                                                     ///< Identifies the file format, must be equal to CompressedAdjacencyListFormat::kFileMagic.
+        uint64_t numVertices;                                               ///< Number of vertices in the graph.
+        uint64_t numEdges;                                                  ///< Number of edges in the graph.
+        uint32_t edgeDataType;                                              ///< Type of edge data held with each edge, as an EEdgeDataType enumerator.
+        uint32_t flags;                                                     ///< Bitwise combination of flags that describe how edges are grouped.
+    };
+
+    /// Header at the start of every block of edges within a compressed adjacency list file.
+    struct SCompressedAdjacencyListBlockHeader
+    {
+        uint32_t numBytes;                                                  ///< Number of bytes of encoded edges that follow this header.
+        uint32_t numEdges;                                                  ///< Number of edges encoded within the block.
+    };
+
+    /// Describes the layout of compressed adjacency list files and provides the variable-length integer encoding they use.
+    /// After the file header, edges are stored in blocks of at most kMaxEdgesPerBlock edges, each of which can be decoded without reference to any other block.
+    /// Within a block, edges are grouped into runs that share a top-level vertex, which is the source or destination depending on how the file is grouped.
+    /// Each run holds the gap from the previous run's top-level vertex (or from 0 for the first run), the number of edges in the run, and then for each edge the gap from the previous edge's other vertex (or from 0 for the first edge) followed by its edge data.
+    /// Gaps and integer edge data are stored as little-endian base-128 variable-length integers, and floating-point edge data are stored as raw 8-byte or 4-byte values depending on their precision.
+    /// Gaps are computed modulo 2^64, so any order of edges can be represented, but sorted adjacency keeps nearly all gaps within one or two bytes.
+    class CompressedAdjacencyListFormat
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Identifies compressed adjacency list files; the ASCII characters "GTCADJ01" in file order.
+        static const uint64_t kFileMagic = 0x31304a4441435447ull;
+
+        /// Flag indicating that edges are grouped by destination, so the top-level vertex of each run is the destination and the other vertices are sources.
+        static const uint32_t kFileFlagGroupedByDestination = 0x00000001;
+
+        /// Specifies the maximum number of edges in each block.
+        /// Smaller blocks let readers spread decoding more evenly across threads, at the cost of slightly more overhead per edge.
+        static const size_t kMaxEdgesPerBlock = 4096;
+
+        /// Specifies the maximum number of bytes occupied by a single encoded 64-bit value.
+        static const size_t kMaxVarintBytes = 10;
+
+        /// Specifies the maximum number of bytes occupied by a single encoded edge, including the run information that may precede it.
+        static const size_t kMaxBytesPerEdge = 4 * kMaxVarintBytes;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Decodes a variable-length integer and advances past it.
+        /// Reads at most kMaxVarintBytes bytes, even from malformed input.
+        /// @param [in,out] position Pointer to the first byte of the encoded value, updated to point to the first byte after it.
+        /// @return Decoded value.
+        static inline uint64_t DecodeVarint(const uint8_t*& position)
+        {
+            // Nearly all gaps in sorted adjacency fit in a single byte.
+            if (*position < 0x80)
+                return (uint64_t)(*position++);
+
+            uint64_t value = 0;
+            unsigned int shift = 0;
+            uint8_t byte;
+
+            do
+            {
+                byte = *position++;
+                value |= ((uint64_t)(byte & 0x7f) << shift);
+                shift += 7;
+            } while ((0 != (byte & 0x80)) && (shift < 64));
+
+            return value;
+        }
+
+        /// Encodes a variable-length integer and advances past it.
+        /// @param [in,out] position Pointer to where the encoded value should be written, which must have space for kMaxVarintBytes bytes, updated to point to the first byte after it.
+        /// @param [in] value Value to encode.
+        static inline void EncodeVarint(uint8_t*& position, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                *position++ = (uint8_t)(value | 0x80);
+                value >>= 7;
+            }
+
+            *position++ = (uint8_t)value;
+        }
+
+        /// Identifies the type of edge data recorded in the header of files holding the specified type of edge data.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, held for each edge.
+        /// @return Edge data type enumerator.
+        template <typename TEdgeData> static EEdgeDataType GetEdgeDataType(void);
+    };
+
+
+    // -------- EXPLICIT TEMPLATE SPECIALIZATIONS -------------------------- //
+
+    template <> inline EEdgeDataType CompressedAdjacencyListFormat::GetEdgeDataType<void>(void)
+    {
+        return EEdgeDataType::EdgeDataTypeVoid;
+    }
+
+    // --------
+
+    template <> inline EEdgeDataType CompressedAdjacencyListFormat::GetEdgeDataType<uint64_t>(void)
+    {
+        return EEdgeDataType::EdgeDataTypeInteger;
+    }
+
+    // --------
+
+    template <> inline EEdgeDataType CompressedAdjacencyListFormat::GetEdgeDataType<double>(void)
+    {
+        return EEdgeDataType::EdgeDataTypeFloatingPoint;
+    }
+
+    // --------
+
+    template <> inline EEdgeDataType CompressedAdjacencyListFormat::GetEdgeDataType<uint32_t>(void)
+    {
+        return EEdgeDataType::EdgeDataTypeInteger32;
+    }
+
+    // --------
+
+    template <> inline EEdgeDataType CompressedAdjacencyListFormat::GetEdgeDataType<float>(void)
+    {
+        return EEdgeDataType::EdgeDataTypeFloatingPoint32;
+    }
+}
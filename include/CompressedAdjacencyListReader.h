@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file CompressedAdjacencyListReader.h
+ *   Declaration of a graph reader for compressed adjacency list files.
+ *****************************************************************************/
+
+#pragma once
+
+#include "CompressedAdjacencyListFormat.h"
+#include "GraphReader.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Reader object class for graphs represented in compressed adjacency list format, described in "CompressedAdjacencyListFormat.h".
+    /// The file is read in large chunks made up of whole blocks, and the blocks of each chunk are decoded by all consumer threads in parallel.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class CompressedAdjacencyListReader : public GraphReader<TEdgeData>
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Indicates that the edges in the file are grouped by destination instead of by source.
+        bool groupedByDestination;
+
+        /// Holds the header of the block that did not fit into the previous chunk.
+        SCompressedAdjacencyListBlockHeader pendingBlockHeader;
+
+        /// Indicates that pendingBlockHeader holds a header that has been read from the file but not yet placed into a chunk.
+        bool hasPendingBlockHeader;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        CompressedAdjacencyListReader(void);
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Decodes the edge data of a single edge and advances past it.
+        /// Actual encoding is determined by the type of data of interest, which would need to be specialized for each supported type.
+        /// @param [in,out] position Pointer to the first byte of the encoded edge data, updated to point to the first byte after it.
+        /// @param [out] edge Edge into which to place the decoded edge data.
+        static void DecodeEdgeData(const uint8_t*& position, SEdge<TEdgeData>& edge);
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Decodes a single block of edges and appends them to the specified container.
+        /// Decoding stops early if the encoded edges run past the end of the block, which only happens if the file is malformed.
+        /// @param [in] blockData Pointer to the first byte of encoded edges, just past the block header.
+        /// @param [in] blockDataEnd Pointer one past the last byte of encoded edges, which must be followed by at least kMaxBytesPerEdge readable bytes.
+        /// @param [in] numEdges Number of edges in the block, according to its header.
+        /// @param [in,out] edges Container to which to append decoded edges.
+        void DecodeBlock(const uint8_t* blockData, const uint8_t* const blockDataEnd, const size_t numEdges, std::vector<SEdge<TEdgeData>>& edges) const;
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphReader.h" for documentation.
+
+        virtual FILE* OpenAndInitializeGraphFileForRead(const char* const filename);
+        virtual void ParseEdgesFromChunk(const char* const chunk, const size_t chunkSize, const size_t rangeStart, const size_t rangeEnd, std::vector<SEdge<TEdgeData>>& edges) const;
+        virtual size_t ReadChunkToBuffer(FILE* const graphfile, char* const buf, const size_t size, const TEdgeCount maxEdges);
+        virtual TEdgeCount ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count);
+        virtual bool SupportsDirectIO(void) const;
+        virtual bool UsesParallelParsing(void) const;
+    };
+}
@@ -0,0 +1,61 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file CompressedAdjacencyListWriter.h
+ *   Declaration of a graph writer for compressed adjacency list files.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphWriter.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Writer object class for graphs represented in compressed adjacency list format, described in "CompressedAdjacencyListFormat.h".
+    /// Edges of each top-level vertex are sorted by the vertex at the other end within each block so that gaps are small.
+    /// Blocks are independent of one another, so by default they are encoded by all consumer threads in parallel and written to the file in order.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class CompressedAdjacencyListWriter : public GraphWriter<TEdgeData>
+    {
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Encodes a single block of edges, including its header, and advances past it.
+        /// @param [in,out] position Pointer to where the block should be written, which must have space for kMaxBytesPerEdge bytes per edge plus the header, updated to point to the first byte after it.
+        /// @param [in] edges Edges to encode, grouped by top-level vertex.
+        /// @param [in] count Number of edges to encode, at most kMaxEdgesPerBlock.
+        /// @param [in] groupedByDestination Indicates that graph edges are grouped by destination instead of by source.
+        static void EncodeBlock(uint8_t*& position, const SEdge<TEdgeData>* edges, const size_t count, const bool groupedByDestination);
+
+        /// Encodes the edge data of the specified edge and advances past it.
+        /// Actual encoding is determined by the type of data of interest, which would need to be specialized for each supported type.
+        /// @param [in,out] position Pointer to where the encoded edge data should be written, updated to point to the first byte after it.
+        /// @param [in] edge Edge whose edge data should be encoded.
+        static void EncodeEdgeData(uint8_t*& position, const SEdge<TEdgeData>& edge);
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphWriter.h" for documentation.
+
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
+        virtual void FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const;
+        virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool SupportsDirectIO(void) const;
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsParallelFormatting(void) const;
+        virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
+    };
+}
@@ -0,0 +1,224 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file CompressingFile.h
+ *   Declaration of a file backend that compresses everything written to it
+ *   using zstd or gzip, in parallel, before it reaches the underlying file.
+ *****************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Provides sequential write access to a file whose contents are compressed using zstd or gzip as they are written.
+    /// Files are exposed as standard C file handles, so writers that use the standard C library functions need no changes beyond how the file is opened.
+    /// Written data are divided into fixed-size segments, each of which is compressed by one of several background threads as an independent zstd frame or gzip member, so compression keeps pace with the threads producing the data.
+    /// Compressed segments are written to the underlying file in order, so the result is a standard multi-frame zstd file or multi-member gzip file that any decompressor accepts.
+    /// Every zstd frame records its decompressed size, so files produced this way are decompressed in parallel when read back by DecompressedFile.
+    /// Handles support only sequential access: the position, in uncompressed bytes, can be queried but not changed.
+    /// Currently supported only on Linux.
+    class CompressingFile
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the default number of threads that compress a file.
+        static const uint32_t kDefaultNumThreads = 4;
+
+        /// Specifies the largest supported number of compression threads.
+        static const uint32_t kMaxNumThreads = 64;
+
+        /// Specifies the largest supported compression level, which is that of zstd; gzip levels above 9 are treated as 9.
+        static const int kMaxLevel = 22;
+
+
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Enumerates the supported compression formats.
+        enum ECompressionFormat
+        {
+            CompressionFormatNone,                                          ///< Not compressed.
+            CompressionFormatGzip,                                          ///< gzip, compressed using zlib.
+            CompressionFormatZstd,                                          ///< zstd, compressed using libzstd.
+        };
+
+
+    private:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the number of uncompressed bytes in each segment, except the last, and hence in each frame or member of the compressed file.
+        static const size_t kSegmentSize = (4ull * 1024ull * 1024ull);
+
+
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Holds the uncompressed contents of one segment until it has been compressed and written.
+        struct SSegment
+        {
+            std::vector<uint8_t> data;                                      ///< Uncompressed contents, with capacity for a whole segment.
+            size_t size;                                                    ///< Number of valid bytes of uncompressed contents.
+            uint64_t sequenceNumber;                                        ///< Position of this segment within the file, counting segments.
+        };
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Format in which to compress the file.
+        ECompressionFormat format;
+
+        /// Compression level, or 0 for the default level of the format.
+        int level;
+
+        /// Underlying file to which compressed data are written.
+        FILE* output;
+
+        /// Name of the file to which the compressed data are appended once everything has been written, or empty if they are written there directly.
+        std::string appendFilename;
+
+        /// Segments, of which at most one is being filled and the rest are either free, waiting to be compressed, or being compressed.
+        std::vector<SSegment> segments;
+
+        /// Background threads that compress segments.
+        std::vector<std::thread> workers;
+
+        /// Segment being filled by the writer, or `NULL` if the writer does not currently hold one.
+        SSegment* currentSegment;
+
+        /// Protects all of the variables shared with the background threads, which are those below.
+        std::mutex lock;
+
+        /// Notified whenever a segment is queued for compression, or the file is being closed.
+        std::condition_variable segmentQueued;
+
+        /// Notified whenever a compressed segment has been written and its segment freed, or an error occurs.
+        std::condition_variable segmentWritten;
+
+        /// Segments that are free to be filled by the writer.
+        std::vector<SSegment*> freeSegments;
+
+        /// Segments that are waiting to be compressed, in order of sequence number.
+        std::deque<SSegment*> queuedSegments;
+
+        /// Sequence number to assign to the next segment filled by the writer.
+        uint64_t nextSegment;
+
+        /// Number of segments whose compressed contents have been written, which is also the sequence number of the next segment to be written.
+        uint64_t numSegmentsWritten;
+
+        /// Indicates that compression or writing has failed, after which all further writes fail.
+        bool failed;
+
+        /// Indicates that the file is being closed, so the background threads should exit once no segments are left to compress.
+        bool closing;
+
+        /// Number of uncompressed bytes written so far.
+        uint64_t position;
+
+
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        /// Objects are created only by OpenForWrite and OpenForAppendOnClose.
+        CompressingFile(void);
+
+        /// Destructor.
+        /// Stops the background threads and closes the underlying file, discarding anything not yet compressed.
+        ~CompressingFile(void);
+
+
+    public:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Determines if compression is supported on the current platform.
+        /// @return `true` if compressed files can be written, `false` otherwise.
+        static bool IsSupported(void);
+
+        /// Opens a stream whose contents are compressed and written to the specified file, which is closed when the stream is closed.
+        /// @param [in] file Underlying file, open for writing, which this object takes over even if opening fails.
+        /// @param [in] format Compression format, other than none.
+        /// @param [in] level Compression level, or 0 for the default level of the format.
+        /// @param [in] numThreads Number of threads that compress the file.
+        /// @return File handle, to be closed using `fclose`, or `NULL` in the event of an error.
+        static FILE* OpenForWrite(FILE* const file, const ECompressionFormat format, const int level, const uint32_t numThreads);
+
+        /// Opens a stream whose contents are compressed and held in a temporary file until the stream is closed, at which point they are appended to the specified file.
+        /// Because compressed frames and members are independent, this allows a later section of a compressed file to be produced concurrently with an earlier one, provided the stream for the earlier section is closed first.
+        /// @param [in] filename Name of the file to which to append the compressed data, which must exist by the time this stream is closed.
+        /// @param [in] format Compression format, other than none.
+        /// @param [in] level Compression level, or 0 for the default level of the format.
+        /// @param [in] numThreads Number of threads that compress the file.
+        /// @return File handle, to be closed using `fclose`, or `NULL` in the event of an error.
+        static FILE* OpenForAppendOnClose(const char* const filename, const ECompressionFormat format, const int level, const uint32_t numThreads);
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Closes the file on behalf of the standard C library, waiting for all remaining data to be compressed and written.
+        /// @param [in] cookie Pointer to the CompressingFile object.
+        /// @return 0 if successful and no compression or I/O errors occurred, -1 otherwise.
+        static int CookieClose(void* cookie);
+
+        /// Reports the position within the file on behalf of the standard C library.
+        /// Only queries, which do not change the position, are supported.
+        /// @param [in] cookie Pointer to the CompressingFile object.
+        /// @param [in,out] offset Requested offset, replaced by the resulting position.
+        /// @param [in] whence Origin of the requested offset.
+        /// @return 0 if successful, -1 otherwise.
+        static int CookieSeek(void* cookie, int64_t* offset, int whence);
+
+        /// Writes to the file on behalf of the standard C library.
+        /// @param [in] cookie Pointer to the CompressingFile object.
+        /// @param [in] buf Buffer from which to write.
+        /// @param [in] size Number of bytes to write.
+        /// @return Number of bytes written, or -1 in the event of an error.
+        static ptrdiff_t CookieWrite(void* cookie, const char* buf, size_t size);
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Appends the contents of the temporary file to the file named when the stream was opened.
+        /// @return `true` if successful, `false` otherwise.
+        bool AppendToNamedFile(void);
+
+        /// Waits for all queued segments to be compressed and written, then stops the background threads.
+        /// @return `true` if no compression or I/O errors occurred, `false` otherwise.
+        bool Finish(void);
+
+        /// Allocates segments and starts the background threads.
+        /// @param [in] file Underlying file, open for writing, which this object takes over.
+        /// @param [in] format Compression format, other than none.
+        /// @param [in] level Compression level, or 0 for the default level of the format.
+        /// @param [in] numThreads Number of threads that compress the file.
+        /// @return `true` if successful, `false` otherwise.
+        bool Initialize(FILE* const file, const ECompressionFormat format, const int level, const uint32_t numThreads);
+
+        /// Wraps this object in a standard C file handle, destroying it if that fails.
+        /// @return File handle, or `NULL` in the event of an error.
+        FILE* OpenStream(void);
+
+        /// Hands the segment being filled to the background threads, unless it is empty.
+        /// Must be called with the lock held.
+        void QueueCurrentSegment(void);
+
+        /// Compresses queued segments and writes them to the underlying file in order of sequence number until the file is closed or an error occurs.
+        /// Executed by each background thread.
+        void Worker(void);
+    };
+}
@@ -0,0 +1,233 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file DecompressedFile.h
+ *   Declaration of a file backend that transparently decompresses gzip and
+ *   zstd compressed files while they are being read.
+ *****************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Provides sequential read access to the decompressed contents of a gzip or zstd compressed file, which are never written to disk.
+    /// Files are exposed as standard C file handles, so readers that use the standard C library functions need no changes beyond how the file is opened.
+    /// Decompression runs on background threads, ahead of the position being read, and fills a ring of output segments that are handed to the reader in order.
+    /// A zstd file made up of several frames whose sizes are recorded in their headers, such as those produced by multithreaded or seekable zstd compression, is decompressed by several threads at once, each working on a different group of frames.
+    /// Any other compressed file, including every gzip file, is decompressed as a single stream by one background thread.
+    /// Handles support only sequential access: the position can be queried but not changed.
+    /// Currently supported only on Linux.
+    class DecompressedFile
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the default number of threads that decompress a file whose frames can be decompressed independently.
+        static const uint32_t kDefaultNumThreads = 4;
+
+        /// Specifies the largest supported number of decompression threads.
+        static const uint32_t kMaxNumThreads = 64;
+
+
+    private:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the number of decompressed bytes that each segment holds, except the last, when a file is decompressed as a single stream.
+        /// When frames are decompressed independently, this is instead the size beyond which consecutive frames are no longer grouped into the same segment.
+        static const size_t kSegmentSize = (4ull * 1024ull * 1024ull);
+
+        /// Specifies the largest decompressed size of a frame that can be decompressed independently, since the whole frame is held in memory at once.
+        static const size_t kMaxFrameSize = (64ull * 1024ull * 1024ull);
+
+
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Enumerates the supported compression formats.
+        enum ECompressionFormat
+        {
+            CompressionFormatNone,                                          ///< Not compressed, or compressed using an unsupported format.
+            CompressionFormatGzip,                                          ///< gzip, decompressed using zlib.
+            CompressionFormatZstd,                                          ///< zstd, decompressed using libzstd.
+        };
+
+        /// Describes a group of consecutive zstd frames that are decompressed together, independently of all other groups.
+        struct SSegment
+        {
+            size_t inputOffset;                                             ///< Offset within the compressed file of the first byte of the first frame.
+            size_t inputSize;                                               ///< Number of compressed bytes in all of the frames.
+            size_t outputSize;                                              ///< Number of decompressed bytes in all of the frames.
+        };
+
+        /// Holds the decompressed contents of one segment until they have been read.
+        struct SSlot
+        {
+            std::vector<uint8_t> data;                                      ///< Decompressed contents.
+            size_t size;                                                    ///< Number of valid bytes of decompressed contents.
+            bool ready;                                                     ///< Indicates that the contents are complete and have not yet been read in full.
+        };
+
+        /// Holds the state of a decompression stream, defined only in the implementation file.
+        struct SStream;
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Format of the compressed file.
+        ECompressionFormat format;
+
+        /// Descriptor of the compressed file.
+        int fd;
+
+        /// Read-only mapping of the whole compressed file.
+        const uint8_t* input;
+
+        /// Size of the compressed file.
+        size_t inputSize;
+
+        /// Groups of frames that are decompressed independently, or empty if the file is decompressed as a single stream.
+        std::vector<SSegment> segments;
+
+        /// Decompression stream, used only if the file is decompressed as a single stream.
+        SStream* stream;
+
+        /// Slots that hold decompressed segments, used in order, such that each segment is placed into the slot whose index is its sequence number modulo the number of slots.
+        std::vector<SSlot> slots;
+
+        /// Background threads that decompress segments.
+        std::vector<std::thread> workers;
+
+        /// Protects all of the variables shared with the background threads, which are those below.
+        std::mutex lock;
+
+        /// Notified whenever a segment becomes ready, decompression reaches the end of the file, or an error occurs.
+        std::condition_variable segmentReady;
+
+        /// Notified whenever a slot is freed, or the file is being closed.
+        std::condition_variable slotFreed;
+
+        /// Sequence number of the next segment to be decompressed by any background thread.
+        uint64_t nextSegment;
+
+        /// Number of segments that have been read in full, which is also the sequence number of the segment being read.
+        uint64_t numSegmentsRead;
+
+        /// Total number of segments, which is not known in advance when decompressing a single stream until the end of the stream is reached.
+        uint64_t numSegments;
+
+        /// Indicates that decompression has failed, after which all further reads fail.
+        bool failed;
+
+        /// Indicates that the file is being closed, so the background threads should exit.
+        bool closing;
+
+        /// Indicates that the reader holds the slot of the segment being read, so its contents can be copied without synchronization.
+        bool holdsSlot;
+
+        /// Position within the segment being read of the next byte to be read.
+        size_t currentSlotPosition;
+
+        /// Number of decompressed bytes read so far.
+        uint64_t position;
+
+
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        /// Objects are created only by OpenForRead.
+        DecompressedFile(void);
+
+        /// Destructor.
+        /// Stops the background threads and closes the file.
+        ~DecompressedFile(void);
+
+
+    public:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Determines if transparent decompression is supported on the current platform.
+        /// @return `true` if compressed files can be opened, `false` otherwise.
+        static bool IsSupported(void);
+
+        /// Determines if the specified file is compressed using a supported format, which is identified by the magic bytes at the start of the file rather than by the file name.
+        /// @param [in] filename Name of the file to check.
+        /// @return `true` if the file exists and is compressed using a supported format, `false` otherwise.
+        static bool IsCompressed(const char* const filename);
+
+        /// Opens a compressed file for sequential reading of its decompressed contents, starting from the beginning.
+        /// @param [in] filename Name of the file to open, which must be compressed using a supported format.
+        /// @param [in] numThreads Number of threads that decompress the file, if its frames can be decompressed independently.
+        /// @return File handle, to be closed using `fclose`, or `NULL` in the event of an error.
+        static FILE* OpenForRead(const char* const filename, const uint32_t numThreads);
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Closes the file on behalf of the standard C library.
+        /// @param [in] cookie Pointer to the DecompressedFile object.
+        /// @return 0 if successful and no decompression errors occurred, -1 otherwise.
+        static int CookieClose(void* cookie);
+
+        /// Reads from the file on behalf of the standard C library.
+        /// @param [in] cookie Pointer to the DecompressedFile object.
+        /// @param [out] buf Buffer to which to read.
+        /// @param [in] size Number of bytes requested.
+        /// @return Number of bytes read, 0 at the end of the file, or -1 in the event of an error.
+        static ptrdiff_t CookieRead(void* cookie, char* buf, size_t size);
+
+        /// Reports the position within the file on behalf of the standard C library.
+        /// Only queries, which do not change the position, are supported.
+        /// @param [in] cookie Pointer to the DecompressedFile object.
+        /// @param [in,out] offset Requested offset, replaced by the resulting position.
+        /// @param [in] whence Origin of the requested offset.
+        /// @return 0 if successful, -1 otherwise.
+        static int CookieSeek(void* cookie, int64_t* offset, int whence);
+
+        /// Identifies the compression format from the first bytes of a file.
+        /// @param [in] header First bytes of the file.
+        /// @param [in] headerSize Number of bytes available.
+        /// @return Compression format.
+        static ECompressionFormat DetectFormat(const uint8_t* const header, const size_t headerSize);
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Divides a zstd file into groups of frames that can be decompressed independently.
+        /// Leaves the list of segments empty if the file must instead be decompressed as a single stream, either because it holds only one frame, because some frame does not record its decompressed size or is too large, or because some frame is invalid.
+        void DivideFrames(void);
+
+        /// Decompresses the next part of a single stream into the specified slot, filling it unless the end of the stream is reached.
+        /// @param [in,out] slot Slot to fill.
+        /// @param [out] endOfStream Set to `true` if the end of the stream was reached.
+        /// @return `true` if successful, `false` if the compressed data are invalid.
+        bool DecompressStream(SSlot& slot, bool& endOfStream);
+
+        /// Maps the file, identifies its format, divides it into segments if possible, and starts the background threads.
+        /// @param [in] filename Name of the file to open.
+        /// @param [in] numThreads Number of threads that decompress the file, if its frames can be decompressed independently.
+        /// @return `true` if successful, `false` otherwise.
+        bool Initialize(const char* const filename, const uint32_t numThreads);
+
+        /// Wraps this object in a standard C file handle, destroying it if that fails.
+        /// @return File handle, or `NULL` in the event of an error.
+        FILE* OpenStream(void);
+
+        /// Decompresses segments in order of sequence number until there are none left, the file is closed, or an error occurs.
+        /// Executed by each background thread.
+        void Worker(void);
+    };
+}
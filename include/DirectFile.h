@@ -0,0 +1,206 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file DirectFile.h
+ *   Declaration of a file backend that reads and writes sequentially using
+ *   asynchronous direct I/O.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Provides sequential access to a file using asynchronous direct I/O, which bypasses the operating system's page cache and keeps several requests in flight at once.
+    /// Files are exposed as standard C file handles, so readers and writers that use the standard C library functions need no changes beyond how the file is opened.
+    /// Data pass through a ring of aligned blocks, each of which is transferred by a single request: when reading, blocks are requested ahead of the position being read, and when writing, each block is written in the background once it is full.
+    /// Requests are submitted using io_uring, or synchronously if io_uring is unavailable, and if the file system does not support direct I/O the page cache is used but released after each block.
+    /// Handles support only sequential access: the position can be queried but not changed.
+    /// Currently supported only on Linux.
+    class DirectFile
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the alignment, in bytes, of every block's memory, file offset, and size, as required for direct I/O.
+        static const size_t kBlockAlignment = 4096;
+
+        /// Specifies the size, in bytes, of each block, which is also the size of each request.
+        static const size_t kBlockSize = (1ull * 1024ull * 1024ull);
+
+        /// Specifies the default number of blocks, and hence the maximum number of requests in flight.
+        static const uint32_t kDefaultQueueDepth = 8;
+
+        /// Specifies the largest supported number of blocks.
+        static const uint32_t kMaxQueueDepth = 256;
+
+
+    private:
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Describes a single block in the ring.
+        struct SBlock
+        {
+            uint8_t* data;                                                  ///< Aligned memory that holds the block's contents.
+            uint64_t fileOffset;                                            ///< Offset within the file of the block's first byte.
+            size_t size;                                                    ///< Number of bytes requested, or 0 if no request has been made.
+            int64_t result;                                                 ///< Number of bytes transferred by the most recent request, or a negative error code.
+            bool pending;                                                   ///< Indicates that the most recent request has not yet completed.
+        };
+
+        /// Holds the state of an io_uring instance, defined only in the implementation file.
+        struct SRing;
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Descriptor of the open file.
+        int fd;
+
+        /// Indicates that the file is open for writing rather than reading.
+        bool forWrite;
+
+        /// Indicates that the file was opened for direct I/O, rather than falling back to the page cache.
+        bool usesDirectIO;
+
+        /// Indicates that an I/O error has occurred, after which all further transfers fail.
+        bool failed;
+
+        /// Blocks in the ring, used in order.
+        std::vector<SBlock> blocks;
+
+        /// Index of the block being read from or written to.
+        uint32_t currentBlock;
+
+        /// Position within the current block of the next byte to be read or written.
+        size_t currentBlockPosition;
+
+        /// Offset within the file of the next block to be requested.
+        uint64_t nextBlockOffset;
+
+        /// Size of the file, used only when reading.
+        uint64_t fileSize;
+
+        /// Number of bytes read or written so far.
+        uint64_t position;
+
+        /// io_uring instance used to submit requests, or `NULL` if requests are performed synchronously.
+        SRing* ring;
+
+
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        /// Objects are created only by OpenForRead and OpenForWrite.
+        DirectFile(void);
+
+        /// Destructor.
+        /// Waits for any requests still in flight and closes the file.
+        ~DirectFile(void);
+
+
+    public:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Determines if direct I/O is supported on the current platform.
+        /// @return `true` if files can be opened for direct I/O, `false` otherwise.
+        static bool IsSupported(void);
+
+        /// Opens a file for sequential reading using direct I/O, starting from the beginning of the file.
+        /// @param [in] filename Name of the file to open.
+        /// @param [in] queueDepth Number of blocks to use, which is also the maximum number of requests in flight.
+        /// @return File handle, to be closed using `fclose`, or `NULL` in the event of an error.
+        static FILE* OpenForRead(const char* const filename, const uint32_t queueDepth);
+
+        /// Creates or truncates a file and opens it for sequential writing using direct I/O.
+        /// @param [in] filename Name of the file to open.
+        /// @param [in] queueDepth Number of blocks to use, which is also the maximum number of requests in flight.
+        /// @return File handle, to be closed using `fclose`, or `NULL` in the event of an error.
+        static FILE* OpenForWrite(const char* const filename, const uint32_t queueDepth);
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Closes the file on behalf of the standard C library, writing out any remaining data.
+        /// @param [in] cookie Pointer to the DirectFile object.
+        /// @return 0 if successful and no I/O errors occurred, -1 otherwise.
+        static int CookieClose(void* cookie);
+
+        /// Reads from the file on behalf of the standard C library.
+        /// @param [in] cookie Pointer to the DirectFile object.
+        /// @param [out] buf Buffer to which to read.
+        /// @param [in] size Number of bytes requested.
+        /// @return Number of bytes read, 0 at the end of the file, or -1 in the event of an error.
+        static ptrdiff_t CookieRead(void* cookie, char* buf, size_t size);
+
+        /// Reports the position within the file on behalf of the standard C library.
+        /// Only queries, which do not change the position, are supported.
+        /// @param [in] cookie Pointer to the DirectFile object.
+        /// @param [in,out] offset Requested offset, replaced by the resulting position.
+        /// @param [in] whence Origin of the requested offset.
+        /// @return 0 if successful, -1 otherwise.
+        static int CookieSeek(void* cookie, int64_t* offset, int whence);
+
+        /// Writes to the file on behalf of the standard C library.
+        /// @param [in] cookie Pointer to the DirectFile object.
+        /// @param [in] buf Buffer from which to write.
+        /// @param [in] size Number of bytes to write.
+        /// @return Number of bytes written, or 0 in the event of an error.
+        static ptrdiff_t CookieWrite(void* cookie, const char* buf, size_t size);
+
+        /// Creates an io_uring instance with room for the specified number of requests in flight.
+        /// @param [in] numEntries Number of requests that can be in flight at once.
+        /// @return Pointer to the io_uring instance, or `NULL` if io_uring is unavailable.
+        static SRing* CreateRing(const uint32_t numEntries);
+
+        /// Destroys an io_uring instance created by CreateRing.
+        /// @param [in] ring Pointer to the io_uring instance.
+        static void DestroyRing(SRing* const ring);
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Releases the page cache that holds the specified block, if the file was not opened for direct I/O.
+        /// @param [in] block Block whose contents are no longer needed.
+        void ReleaseCachedBlock(const SBlock& block) const;
+
+        /// Collects the results of completed requests, optionally waiting until at least one completes.
+        /// @param [in] wait Indicates that this method should wait for a request to complete if none have.
+        /// @return `true` if successful, `false` if the io_uring instance reported an error.
+        bool CollectCompletions(const bool wait);
+
+        /// Opens the file, allocates the blocks, and sets up the io_uring instance.
+        /// @param [in] filename Name of the file to open.
+        /// @param [in] forWrite Indicates that the file should be created or truncated and opened for writing.
+        /// @param [in] queueDepth Number of blocks to use.
+        /// @return `true` if successful, `false` otherwise.
+        bool Initialize(const char* const filename, const bool forWrite, const uint32_t queueDepth);
+
+        /// Wraps this object in a standard C file handle, destroying it if that fails.
+        /// @return File handle, or `NULL` in the event of an error.
+        FILE* OpenStream(void);
+
+        /// Submits a request to read or write the specified block, or performs it synchronously if there is no io_uring instance.
+        /// @param [in] blockIndex Index of the block.
+        /// @param [in] fileOffset Offset within the file of the block's first byte.
+        /// @param [in] size Number of bytes to transfer, which must be a multiple of the block alignment if the file was opened for direct I/O.
+        /// @return `true` if the request was submitted, `false` otherwise.
+        bool SubmitBlock(const uint32_t blockIndex, const uint64_t fileOffset, const size_t size);
+
+        /// Waits for the most recent request made for the specified block to complete.
+        /// @param [in] blockIndex Index of the block.
+        /// @return `true` if the request transferred every byte requested, or when reading every byte up to the end of the file, or if no request had been made, `false` otherwise.
+        bool WaitForBlock(const uint32_t blockIndex);
+    };
+}
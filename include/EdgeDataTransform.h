@@ -15,6 +15,7 @@
 
 #include "GraphTransform.h"
 #include "Types.h"
+#include "WorkScheduler.h"
 
 #include <cstddef>
 #include <cstdio>
@@ -23,26 +24,73 @@
 namespace GraphTool
 {
     class Graph;
+    class VertexIndex;
 
     
     /// Abstract transformation class for generating edge data values.
     /// Schedules parallel work but leaves actual value generation to subclasses.
+    /// Frozen graphs are scheduled by edges rather than by vertices, splitting the edges of high-degree vertices across threads, since every edge is generated independently.
+    /// Subclasses are bound at compile time, rather than through virtual methods, so that value generation is inlined into the loops over each vertex's edges and can be vectorized.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
-    template <typename TEdgeData> class EdgeDataTransform : public GraphTransform
-    {   
+    /// @tparam TEdgeDataGenerator Subclass that generates edge data values, which must provide a `GenerateEdgeData` method and may hide GenerateEdgeDataBatch with a faster version. Either may be a const instance method rather than a static method, so that values can depend on options.
+    template <typename TEdgeData, typename TEdgeDataGenerator> class EdgeDataTransform : public GraphTransform
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+        
+        /// Hands out the edges of each frozen vertex index to threads.
+        /// Shared among all threads while the graph is being transformed.
+        WorkScheduler workScheduler;
+        
+        
+        // -------- HELPERS ------------------------------------------------ //
+        
+        /// Generates edge data for all of the edges in a frozen vertex index.
+        /// Invoked by all threads in the Spindle parallelized region.
+        /// @param [in,out] vertexIndex Vertex index whose edge data are to be generated.
+        /// @param [in] topLevelIsDestination Indicates that the top-level vertices of the index are the destinations of their edges.
+        void TransformVertexIndex(VertexIndex& vertexIndex, const bool topLevelIsDestination);
+        
+        
     public:
-        // -------- ABSTRACT INSTANCE METHODS ------------------------------ //
+        // -------- CLASS METHODS ------------------------------------------ //
         
-        /// Generates edge data given the source and destination vertex identifiers as well as the old edge data value.
-        /// @param [in] sourceVertex Source vertex identifier.
-        /// @param [in] destinationVertex Destination vertex identifier.
-        /// @param [in] oldEdgeData Edge data value for the specified edge prior to the transformation.
-        virtual TEdgeData GenerateEdgeData(const TVertexID sourceVertex, const TVertexID destinationVertex, const TEdgeData oldEdgeData) = 0;
+        /// Generates edge data for a batch of edges that share a top-level vertex, such as all of the edges of one vertex in a frozen vertex index or the part of them in one unit of work.
+        /// The default implementation invokes the subclass's `GenerateEdgeData` once per edge, which the compiler can inline and vectorize when it is simple enough, and requires that method to be static.
+        /// @tparam TNeighborID Type used to store the identifiers of the vertices at the other end of each edge.
+        /// @param [in] topLevelVertex Vertex identifier shared by all edges in the batch.
+        /// @param [in] topLevelIsDestination Indicates that the top-level vertex is the destination of each edge rather than its source.
+        /// @param [in] neighbors Identifiers of the vertices at the other end of each edge.
+        /// @param [in,out] edgeData Edge data of each edge, replaced by the generated values.
+        /// @param [in] count Number of edges in the batch.
+        template <typename TNeighborID> static inline void GenerateEdgeDataBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TNeighborID* const neighbors, UEdgeData* const edgeData, const size_t count)
+        {
+            if (topLevelIsDestination)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    edgeData[i] = TEdgeDataGenerator::GenerateEdgeData((TVertexID)neighbors[i], topLevelVertex, (TEdgeData)edgeData[i]);
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                    edgeData[i] = TEdgeDataGenerator::GenerateEdgeData(topLevelVertex, (TVertexID)neighbors[i], (TEdgeData)edgeData[i]);
+            }
+        }
         
         
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "GraphTransform.h" for documentation.
         
         virtual EGraphResult TransformGraph(Graph& graph);
+        
+        
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphTransform.h" for documentation.
+        
+        virtual void BeginFusedTransformation(Graph& graph);
+        virtual bool CanFuseTransformation(void) const;
+        virtual void EndFusedTransformation(Graph& graph);
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
     };
 }
@@ -13,10 +13,12 @@
 
 #pragma once
 
+#include "Arena.h"
 #include "Types.h"
 
 #include <cstddef>
-#include <list>
+#include <cstdint>
+#include <new>
 
 
 namespace GraphTool
@@ -25,83 +27,278 @@ namespace GraphTool
     /// Represents graph topology data and can hold edge data, such as weights, as well.
     /// This indexed data structure represents unidirectional edges but does not specify the direction.
     /// Direction information depends on the usage semantics and is governed by the code that instantiates objects of this type.
+    /// Edges are held in a chain of blocks whose capacity doubles as the list grows, each holding the other vertex of its edges contiguously followed by their edge data, which is omitted entirely from lists that hold no edge data.
+    /// All storage, including that of the edge list object itself, is obtained from an arena, so destruction is never required.
     class EdgeList
     {
     public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the number of edges that the first block of each list can hold.
+        static const uint32_t kInitialBlockCapacity = 4;
+
+        /// Specifies the largest number of edges that any one block can hold, which bounds the capacity left unused at the end of a long list.
+        static const uint32_t kMaxBlockCapacity = 256;
+
+
+    private:
         // -------- TYPE DEFINITIONS --------------------------------------- //
-        
-        /// Alias for the read-only iterator type used by this class.
-        typedef typename std::list<SIndexedEdge>::const_iterator EdgeIterator;
-        
-        /// Alias for the writable iterator type used by this class.
-        typedef typename std::list<SIndexedEdge>::iterator WritableEdgeIterator;
-        
-        
+
+        /// Header of a block of edges.
+        /// Immediately followed by the other vertex of each edge the block can hold and then, if the list holds edge data, the edge data of each such edge.
+        struct SEdgeBlock
+        {
+            SEdgeBlock* next;                                               ///< Next block in the list, or `NULL` if this is the last block.
+            uint32_t count;                                                 ///< Number of edges held in this block.
+            uint32_t capacity;                                              ///< Number of edges this block can hold.
+        };
+
+
+    public:
+        /// Read-only iterator over the edges in an edge list.
+        class EdgeIterator
+        {
+        protected:
+            // -------- INSTANCE VARIABLES --------------------------------- //
+
+            /// Block holding the current edge, or `NULL` if this iterator is past the end of the list.
+            SEdgeBlock* block;
+
+            /// Position of the current edge within its block.
+            uint32_t index;
+
+
+        public:
+            // -------- CONSTRUCTION AND DESTRUCTION ----------------------- //
+
+            /// Initialization constructor.
+            /// @param [in] block Block holding the edge to reference, or `NULL` to reference the end of the list.
+            /// @param [in] index Position of the edge to reference within its block.
+            inline EdgeIterator(SEdgeBlock* const block, const uint32_t index) : block(block), index(index)
+            {
+                // Nothing to do here.
+            }
+
+
+            // -------- OPERATORS ------------------------------------------ //
+
+            /// Advances to the next edge in the list.
+            /// Blocks after the last edge are empty, so reaching one ends the iteration.
+            /// @return Reference to this iterator.
+            inline EdgeIterator& operator++(void)
+            {
+                index += 1;
+
+                if (index == block->count)
+                {
+                    block = (((NULL != block->next) && (0 != block->next->count)) ? block->next : NULL);
+                    index = 0;
+                }
+
+                return *this;
+            }
+
+            /// Determines if two iterators reference the same edge.
+            /// @param [in] other Iterator to compare.
+            /// @return `true` if so, `false` otherwise.
+            inline bool operator==(const EdgeIterator& other) const
+            {
+                return ((block == other.block) && (index == other.index));
+            }
+
+            /// Determines if two iterators reference different edges.
+            /// @param [in] other Iterator to compare.
+            /// @return `true` if so, `false` otherwise.
+            inline bool operator!=(const EdgeIterator& other) const
+            {
+                return !(*this == other);
+            }
+
+
+            // -------- INSTANCE METHODS ----------------------------------- //
+
+            /// Retrieves the edge data of the current edge.
+            /// Must only be used with lists that hold edge data.
+            /// @return Edge data, such as a weight.
+            inline UEdgeData GetEdgeData(void) const
+            {
+                return BlockEdgeData(block)[index];
+            }
+
+            /// Retrieves the vertex at the other end of the current edge.
+            /// @return Other vertex identifier.
+            inline TVertexID GetOtherVertex(void) const
+            {
+                return BlockNeighbors(block)[index];
+            }
+        };
+
+        /// Writable iterator over the edges in an edge list.
+        /// Intended for use by transformation objects, which may change edge data but not the vertices at the other end of each edge.
+        class WritableEdgeIterator : public EdgeIterator
+        {
+        public:
+            // -------- CONSTRUCTION AND DESTRUCTION ----------------------- //
+
+            /// Initialization constructor.
+            /// @param [in] block Block holding the edge to reference, or `NULL` to reference the end of the list.
+            /// @param [in] index Position of the edge to reference within its block.
+            inline WritableEdgeIterator(SEdgeBlock* const block, const uint32_t index) : EdgeIterator(block, index)
+            {
+                // Nothing to do here.
+            }
+
+
+            // -------- OPERATORS ------------------------------------------ //
+
+            /// Advances to the next edge in the list.
+            /// @return Reference to this iterator.
+            inline WritableEdgeIterator& operator++(void)
+            {
+                EdgeIterator::operator++();
+                return *this;
+            }
+
+
+            // -------- INSTANCE METHODS ----------------------------------- //
+
+            /// Replaces the edge data of the current edge.
+            /// Must only be used with lists that hold edge data.
+            /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+            /// @param [in] edgeData New edge data.
+            template <typename TEdgeData> inline void SetEdgeData(const TEdgeData edgeData)
+            {
+                BlockEdgeData(this->block)[this->index] = edgeData;
+            }
+        };
+
+
     private:
         // -------- INSTANCE VARIABLES ------------------------------------- //
 
-        /// Holds all edge information.
-        /// Key is the edge block identifier, value is the edge information structure.
-        std::list<SIndexedEdge> edgeList;
+        /// Arena from which all blocks are allocated.
+        Arena* arena;
+
+        /// First block in the list, or `NULL` if no block has yet been allocated.
+        SEdgeBlock* firstBlock;
+
+        /// Block that receives the next edge appended, unless it is full, or `NULL` if no block has yet been allocated.
+        /// Blocks before it are full, and blocks after it are empty but retain their storage for reuse.
+        SEdgeBlock* appendBlock;
 
         /// Holds the total number of edges present in this data structure.
         TEdgeCount degree;
-        
+
         /// Holds the total number of Vector-Sparse vectors needed to represent the edges in this data structure.
         size_t numVectors;
 
+        /// Specifies that edge data are held alongside each edge.
+        bool hasEdgeData;
+
 
     public:
         // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
 
-        /// Default constructor.
-        EdgeList(void);
+        /// Initialization constructor.
+        /// @param [in] arena Arena from which all edge storage is to be allocated.
+        /// @param [in] hasEdgeData Specifies that edge data are to be held alongside each edge.
+        EdgeList(Arena& arena, const bool hasEdgeData);
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Creates a new edge list that, along with all of its edges, resides in the specified arena.
+        /// The returned object is never deleted; its memory is reclaimed when the arena is destroyed.
+        /// @param [in] arena Arena from which the edge list and all edge storage are to be allocated.
+        /// @param [in] hasEdgeData Specifies that edge data are to be held alongside each edge, which should be `false` for unweighted graphs so that no storage is spent on them.
+        /// @return Pointer to the new edge list.
+        static inline EdgeList* CreateInArena(Arena& arena, const bool hasEdgeData)
+        {
+            void* const storage = arena.Allocate(sizeof(EdgeList));
+
+            if (NULL == storage)
+                throw std::bad_alloc();
+
+            return new (storage) EdgeList(arena, hasEdgeData);
+        }
+
+        /// Estimates the number of bytes of block storage that edge lists hold for the specified number of edges, allowing for the capacity left unused at the end of each list.
+        /// @param [in] numEdges Total number of edges across all lists.
+        /// @param [in] numEdgeLists Number of edge lists that hold the edges.
+        /// @param [in] hasEdgeData Specifies that edge data are held alongside each edge.
+        /// @return Estimated number of bytes.
+        static uint64_t EstimateBlockBytes(const TEdgeCount numEdges, const uint64_t numEdgeLists, const bool hasEdgeData);
 
 
     private:
+        /// Locates the other vertex of each edge in the specified block.
+        /// @param [in] block Block whose edges are to be located.
+        /// @return Pointer to the first other vertex in the block.
+        static inline TVertexID* BlockNeighbors(SEdgeBlock* const block)
+        {
+            return (TVertexID*)(block + 1);
+        }
+
+        /// Locates the edge data of each edge in the specified block, which must belong to a list that holds edge data.
+        /// @param [in] block Block whose edge data are to be located.
+        /// @return Pointer to the first edge data element in the block.
+        static inline UEdgeData* BlockEdgeData(SEdgeBlock* const block)
+        {
+            return (UEdgeData*)(BlockNeighbors(block) + block->capacity);
+        }
+
+
         // -------- HELPERS ------------------------------------------------ //
 
-        /// Fills in an edge information structure with edge information.
+        /// Appends an edge to the end of this data structure and updates the degree and vector count accordingly.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
-        /// @param [out] edgeInfo Edge information structure to fill.
-        /// @param [in] edge Edge to use as the data source.
-        /// @param [in] useDestinationVertex Specifies that the destination vertex, rather than the source vertex, in the edge should be used as the other vertex identifier.
-        template <typename TEdgeData> void FillEdgeInfoFromEdge(SIndexedEdge& edgeInfo, const SEdge<TEdgeData>& edge, bool useDestinationVertex);
+        /// @param [in] otherVertex Vertex at the other end of the edge.
+        /// @param [in] edge Edge to use as the source of any edge data.
+        template <typename TEdgeData> void AppendEdge(const TVertexID otherVertex, const SEdge<TEdgeData>& edge);
+
+        /// Obtains a block with space for at least one more edge at the end of this data structure, reusing an empty block if one remains from an earlier removal and otherwise allocating a new block from the arena.
+        /// @return Block that is to receive the next edge.
+        SEdgeBlock* ReserveAppendBlock(void);
+
 
-        
     public:
         // -------- INSTANCE METHODS --------------------------------------- //
 
+        /// Adds storage for edge data to this data structure, if it does not already hold edge data.
+        /// Intended for transformations that add edge data to a graph that was read without any.
+        /// Edges are moved into a single new block, and their newly-allocated edge data are all invalid.
+        void AllocateEdgeData(void);
+
         /// Returns a read-only iterator for the beginning of the edge list.
         /// @return Read-only iterator to the beginning of the edge list.
         inline EdgeIterator BeginIterator(void) const
         {
-            return edgeList.cbegin();
+            return EdgeIterator((((NULL != firstBlock) && (0 != firstBlock->count)) ? firstBlock : NULL), 0);
         }
-        
+
         /// Returns a writable iterator for the beginning of the edge list.
         /// Intended for use by transformation objects.
         /// @return Writable iterator to the beginning of the edge list.
         inline WritableEdgeIterator BeginIteratorWritable(void)
         {
-            return edgeList.begin();
+            return WritableEdgeIterator((((NULL != firstBlock) && (0 != firstBlock->count)) ? firstBlock : NULL), 0);
         }
 
         /// Returns a read-only iterator for the end of the edge list.
         /// @return Read-only iterator for the end of the edge list.
         inline EdgeIterator EndIterator(void) const
         {
-            return edgeList.cend();
+            return EdgeIterator(NULL, 0);
         }
-        
+
         /// Returns a writable iterator for the end of the edge list.
         /// Intended for use by transformation objects.
         /// @return Writable iterator to the end of the edge list.
         inline WritableEdgeIterator EndIteratorWritable(void)
         {
-            return edgeList.end();
+            return WritableEdgeIterator(NULL, 0);
         }
-        
+
         /// Fills in an edge structure with information exported from the specified position in the edge list.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] position Iterator for the edge to use as the data source.
@@ -109,14 +306,14 @@ namespace GraphTool
         /// @param [in] topLevelVertex Top-level vertex to place into the edge structure.
         /// @param [in] topLevelIsDestination Specifies that the top-level vertex should be treated as the destination vertex, rather than the source vertex.
         template <typename TEdgeData> void FillEdge(EdgeIterator& position, SEdge<TEdgeData>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const;
-        
+
         /// Returns the total number of edges in this data structure (i.e. the degree of the top-level vertex it represents).
         /// @return Total number of edges, which could be 0.
         inline TEdgeCount GetDegree(void) const
         {
             return degree;
         }
-        
+
         /// Returns the number of Vector-Sparse vectors needed to represent the edges in this data structure.
         /// @return Total number of vectors, which could be 0.
         inline size_t GetNumVectors(void) const
@@ -124,6 +321,13 @@ namespace GraphTool
             return numVectors;
         }
 
+        /// Specifies if edge data are held alongside each edge in this data structure.
+        /// @return `true` if so, `false` otherwise.
+        inline bool HasEdgeData(void) const
+        {
+            return hasEdgeData;
+        }
+
         /// Inserts the specified edge into this data structure, using the destination as its data source.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] edge Edge to insert.
@@ -134,7 +338,8 @@ namespace GraphTool
         /// @param [in] edge Edge to insert.
         template <typename TEdgeData> void InsertEdgeUsingSource(const SEdge<TEdgeData>& edge);
 
-        /// Removes the specified edge from this data structure.
+        /// Removes the specified edge, including any duplicates of it, from this data structure.
+        /// Remaining edges keep their relative order and are compacted towards the front, leaving any emptied blocks for reuse by later insertions.
         /// @param [in] otherVertex Vertex at the other end of the edge to remove.
         void RemoveEdge(const TVertexID otherVertex);
     };
@@ -0,0 +1,136 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file EmbeddedGraph.h
+ *   Declaration of the interface through which other programs load, transform,
+ *   and access graphs in their own process using the GraphTool library.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    class Graph;
+
+
+    /// Read-only Compressed-Sparse view of one grouping of the edges of an EmbeddedGraph, which refers directly to the arrays held by the graph rather than to a copy of them.
+    /// Exactly one of the two neighbor arrays is present, depending on whether every vertex identifier fits in the narrower type.
+    struct SCompressedSparseView
+    {
+        TVertexCount numVertices;                                           ///< Number of top-level vertices, which is the number of vertices in the graph.
+        TEdgeCount numEdges;                                                ///< Number of edges.
+        const TEdgeCount* offsets;                                          ///< Position of the first edge of each top-level vertex, plus one past-the-end element, so the edges of vertex `v` occupy positions `offsets[v]` up to, but not including, `offsets[v + 1]`.
+        const TVertexID* neighbors;                                         ///< Vertex at the other end of each edge, or `NULL` if the neighbors are held in the compact array instead.
+        const TCompactVertexID* neighborsCompact;                           ///< Vertex at the other end of each edge, or `NULL` if the neighbors are held in the full-width array instead.
+        const UEdgeData* edgeData;                                          ///< Data of each edge, parallel to the neighbor array, or `NULL` if the graph has no edge data. 32-bit types are held widened to their 64-bit counterparts.
+        EEdgeDataType edgeDataType;                                         ///< Type of data held at each edge.
+        bool sorted;                                                        ///< Indicates that the edges of each top-level vertex are sorted in ascending order of the other vertex.
+    };
+
+    /// Signature of functions that receive the edges of an EmbeddedGraph as they are streamed, one top-level vertex at a time.
+    /// @param [in] context Caller-supplied value passed to every invocation.
+    /// @param [in] topLevelVertex Vertex whose edges are being delivered, which is the source or the destination of each edge depending on the grouping being streamed.
+    /// @param [in] neighbors Vertex at the other end of each edge.
+    /// @param [in] edgeData Data of each edge, or `NULL` if the graph has no edge data.
+    /// @param [in] count Number of edges, which is never 0.
+    /// @return `true` to continue streaming, `false` to stop.
+    typedef bool (*TEdgeBatchCallback)(void* context, const TVertexID topLevelVertex, const TVertexID* const neighbors, const UEdgeData* const edgeData, const size_t count);
+
+
+    /// Holds a graph that another program loads, transforms, and accesses directly in its own process, without writing the graph to a file and parsing it again.
+    /// This is the interface that the GraphTool library exposes, and it refers to readers, transformations, and their options by the same names the command-line tool uses, so that it does not change when the internal classes do.
+    /// Graphs are read grouped by source, and the grouping by destination is built the first time it is needed.
+    /// Every operation creates parallelized regions internally, so none may be invoked from within one, and an instance must not be used by more than one thread at a time.
+    class EmbeddedGraph
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Graph being held.
+        Graph* graph;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        /// Creates an empty graph.
+        EmbeddedGraph(void);
+
+        /// Copy constructor.
+        /// This is a deleted function.
+        EmbeddedGraph(const EmbeddedGraph& other) = delete;
+
+        /// Destructor.
+        ~EmbeddedGraph(void);
+
+
+        // -------- OPERATORS ---------------------------------------------- //
+
+        /// Copy assignment operator.
+        /// This is a deleted function.
+        EmbeddedGraph& operator=(const EmbeddedGraph& other) = delete;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Releases the threads that GraphTool keeps between operations, which are otherwise kept until the program exits.
+        /// Intended to be called once a program no longer needs any EmbeddedGraph, to return the cores to its own threads.
+        static void ReleaseThreads(void);
+
+
+        // -------- INSTANCE METHODS --------------------------------------- //
+
+        /// Applies a transformation to the graph, invalidating any views previously obtained.
+        /// @param [in] transformName Name of the transformation, as accepted by the `--transform` command-line option.
+        /// @param [in] options Options for the transformation, formatted as a comma-separated list of `name=value` pairs as accepted by the `--transformoptions` command-line option, or `NULL` if there are none.
+        /// @return Indicator of the result of the operation, which is GraphResultErrorUnknown if the transformation or any of its options is not recognized.
+        EGraphResult ApplyTransform(const char* const transformName, const char* const options = NULL);
+
+        /// Retrieves the type of data held at each edge.
+        /// @return Edge data type.
+        EEdgeDataType GetEdgeDataType(void) const;
+
+        /// Retrieves the number of edges in the graph.
+        /// @return Number of edges.
+        TEdgeCount GetNumEdges(void) const;
+
+        /// Retrieves the number of vertices in the graph.
+        /// @return Number of vertices.
+        TVertexCount GetNumVertices(void) const;
+
+        /// Obtains a read-only view of the edges of the graph, grouped as specified, building that grouping first if the graph does not already have it.
+        /// Views of both groupings may be held at once, and they remain valid until the graph is next read, transformed, or destroyed.
+        /// @param [in] groupedByDestination `true` to group edges by destination vertex, so that each vertex lists its in-edges, or `false` to group them by source vertex.
+        /// @param [out] view Filled with the view.
+        /// @return Indicator of the result of the operation.
+        EGraphResult GetView(const bool groupedByDestination, SCompressedSparseView& view);
+
+        /// Reads a graph from a file, replacing the contents of this graph and invalidating any views previously obtained.
+        /// @param [in] filename Name of the file to read, or of a directory, wildcard pattern, or list file naming several files that together hold the graph, as accepted by the `--inputfile` command-line option.
+        /// @param [in] formatName Name of the file format, as accepted by the `--inputformat` command-line option.
+        /// @param [in] edgeDataType Type of data to read for each edge.
+        /// @param [in] options Options for the reader, formatted as a comma-separated list of `name=value` pairs as accepted by the `--inputoptions` command-line option, or `NULL` if there are none.
+        /// @return Indicator of the result of the operation, which is GraphResultErrorUnknown if the format or any of the options is not recognized.
+        EGraphResult ReadGraphFromFile(const char* const filename, const char* const formatName, const EEdgeDataType edgeDataType, const char* const options = NULL);
+
+        /// Delivers every edge of the graph, grouped as specified, to a function one top-level vertex at a time in ascending order of vertex, building that grouping first if the graph does not already have it.
+        /// Vertices without any edges are skipped. The function is invoked from the calling thread.
+        /// @param [in] groupedByDestination `true` to group edges by destination vertex, or `false` to group them by source vertex.
+        /// @param [in] callback Function to which edges are delivered.
+        /// @param [in] context Value passed to every invocation of the function.
+        /// @return Indicator of the result of the operation, which is successful even if the function stops streaming early.
+        EGraphResult StreamEdges(const bool groupedByDestination, TEdgeBatchCallback callback, void* context);
+    };
+}
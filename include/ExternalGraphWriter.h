@@ -0,0 +1,291 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file ExternalGraphWriter.h
+ *   Declaration of a graph writer that converts graphs too large to fit in
+ *   memory by way of temporary files.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphWriter.h"
+#include "IGraphWriter.h"
+#include "Types.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace GraphTool
+{
+    class Graph;
+
+
+    /// Describes one of the files written by an external-memory conversion.
+    struct SExternalGraphOutput
+    {
+        IGraphWriter* writer;                                               ///< Graph writer object that writes the file, which must support edge sources.
+        const char* filename;                                               ///< File name of the file to be written.
+        bool groupedByDestination;                                          ///< Indicates that graph edges should be grouped by destination instead of by source.
+        EGraphResult result;                                                ///< Result of writing the file, filled in once the conversion ends.
+    };
+
+
+    /// Converts a graph that does not fit in memory by receiving its edges by streaming and writing them to other graph files grouped by vertex, using an amount of memory bounded by a budget.
+    /// While edges are streamed, every buffer is partitioned by range of top-level vertex into buckets, each appended to its own temporary file, separately for each grouping the outputs need, and the degree of each vertex is counted.
+    /// Once streaming ends, the degrees of each grouping become a graph that holds no edges, from which the writers obtain everything other than the edges themselves, and the buckets are read back in order in chunks that fit within the budget, sorted by top-level vertex, and supplied to the writers as an edge source.
+    /// Chunks are read and sorted by a background thread while the writers consume the previous chunk.
+    /// Sorting is stable, so the edges of each top-level vertex are written in the order in which they appear in the input file.
+    /// The budget covers the degree counts, the vertex offsets, the buffers of the temporary files, and the chunks being sorted, but not the buffers used to read the input file and write the outputs.
+    /// Presented as a single streaming writer, whose file name parameter is the directory in which to place the temporary files.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class ExternalGraphWriter : public IGraphWriter
+    {
+    private:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the largest number of buckets per grouping, which bounds the number of temporary files open at once.
+        static const uint32_t kMaxBuckets = 256;
+
+        /// Specifies the smallest number of edges that a chunk must be able to hold, below which the memory budget is considered too small.
+        static const size_t kMinChunkCapacity = 4096;
+
+        /// Specifies the smallest size, in bytes, of the buffer of each temporary file.
+        static const size_t kMinBucketBufferSize = (16ull * 1024ull);
+
+        /// Specifies the largest size, in bytes, of the buffer of each temporary file.
+        static const size_t kMaxBucketBufferSize = (4ull * 1024ull * 1024ull);
+
+        /// Specifies the largest number of threads that sort each chunk.
+        static const uint32_t kMaxSortThreads = 16;
+
+        /// Specifies the smallest number of edges per thread for which a chunk is sorted by more than one thread.
+        static const size_t kMinEdgesPerSortThread = 65536;
+
+
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Describes a range of consecutive top-level vertices whose edges are read, sorted, and supplied to the writers together.
+        struct SChunk
+        {
+            uint32_t bucket;                                                ///< Bucket that holds the edges of the chunk.
+            TVertexID vertexStart;                                          ///< First top-level vertex.
+            TVertexID vertexEnd;                                            ///< One past the last top-level vertex.
+            TEdgeCount edgeSkip;                                            ///< Number of edges of the first top-level vertex to skip, which is non-zero only for the later pieces of a vertex whose edges do not all fit in a single chunk.
+            TEdgeCount numEdges;                                            ///< Number of edges.
+            bool wholeBucket;                                               ///< Indicates that the chunk holds every edge in its bucket, which can then be read directly.
+        };
+
+        /// Holds a chunk from the time it is read until its edges have been supplied to the writers.
+        struct SSlot
+        {
+            SEdge<TEdgeData>* edges;                                        ///< Edges of the chunk, sorted by top-level vertex once ready.
+            SEdge<TEdgeData>* scratch;                                      ///< Space for as many edges, into which the bucket is read and which holds the intermediate result of sorting.
+            TEdgeCount* cursors;                                            ///< Position of the next edge of each top-level vertex of the chunk, used while sorting.
+            size_t numEdges;                                                ///< Number of edges in the chunk.
+            bool ready;                                                     ///< Indicates that the chunk is sorted and has not yet been supplied in full.
+        };
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Files to be written.
+        SExternalGraphOutput* const outputs;
+
+        /// Number of files to be written.
+        const size_t numOutputs;
+
+        /// Number of bytes of memory the conversion may use.
+        const uint64_t memoryBudget;
+
+        /// Indicates which groupings the outputs need, indexed by whether edges are grouped by destination.
+        bool needsGrouping[2];
+
+        /// Number of vertices given by the input file.
+        TVertexCount numVertices;
+
+        /// Number of edges given by the input file.
+        TEdgeCount numEdges;
+
+        /// Number of bits by which a top-level vertex is shifted right to obtain its bucket, so that every bucket covers the same power-of-two number of vertices.
+        uint32_t bucketShift;
+
+        /// Number of buckets per grouping.
+        uint32_t numBuckets;
+
+        /// Number of edges that each chunk can hold.
+        size_t chunkCapacity;
+
+        /// Number of threads that sort each chunk.
+        uint32_t numSortThreads;
+
+        /// Name of the directory in which temporary files are placed.
+        std::string tempDirectory;
+
+        /// Temporary file that holds each bucket, per grouping.
+        std::vector<FILE*> bucketFiles[2];
+
+        /// Name of each temporary file, per grouping, so that it can be removed.
+        std::vector<std::string> bucketFilenames[2];
+
+        /// Buffer of each temporary file.
+        std::vector<char*> bucketBuffers;
+
+        /// Degree of each vertex, per grouping, counted as edges are partitioned.
+        TEdgeCount* degrees[2];
+
+        /// Edges of the buffer being partitioned, placed in order of bucket.
+        std::vector<SEdge<TEdgeData>> stagedEdges;
+
+        /// Number of edges each thread places into each bucket, replaced by the position at which it places the next such edge.
+        std::vector<uint64_t> bucketPositions;
+
+        /// Position of the first edge of each bucket within the staged edges, plus one past-the-end element.
+        std::vector<uint64_t> bucketStarts;
+
+        /// Number of edges partitioned so far, not including any that refer to a vertex beyond the number given by the input file.
+        TEdgeCount numPartitionedEdges;
+
+        /// Result of the conversion as a whole, as opposed to that of writing each file.
+        EGraphResult externalWriteResult;
+
+        /// Chunks of the grouping being written, in order.
+        std::vector<SChunk> chunks;
+
+        /// Indicates that the grouping being written groups edges by destination.
+        bool currentGroupedByDestination;
+
+        /// Slots that hold chunks, used in order, such that each chunk is placed into the slot whose index is its sequence number modulo the number of slots.
+        SSlot slots[2];
+
+        /// Background thread that reads and sorts chunks.
+        std::thread loader;
+
+        /// Protects all of the variables shared with the background thread, which are those below.
+        std::mutex lock;
+
+        /// Notified whenever a chunk becomes ready or an error occurs.
+        std::condition_variable chunkReady;
+
+        /// Notified whenever a slot is freed, or the grouping being written is finished.
+        std::condition_variable slotFreed;
+
+        /// Number of chunks that have been supplied in full, which is also the sequence number of the chunk being supplied.
+        size_t numChunksSupplied;
+
+        /// Indicates that reading a temporary file has failed, after which no further edges are supplied.
+        bool loadFailed;
+
+        /// Indicates that the grouping being written is finished, so the background thread should exit.
+        bool closing;
+
+        /// Position within the chunk being supplied of the next edge to be supplied.
+        size_t currentSlotPosition;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Initialization constructor.
+        /// @param [in,out] outputs Files to be written, whose results are filled in once the conversion ends. Each writer must support edge sources and write the same type of edge data as this object.
+        /// @param [in] numOutputs Number of files to be written.
+        /// @param [in] memoryBudget Number of bytes of memory the conversion may use.
+        ExternalGraphWriter(SExternalGraphOutput* const outputs, const size_t numOutputs, const uint64_t memoryBudget);
+
+        /// Copy constructor.
+        /// This is a deleted function.
+        ExternalGraphWriter(const ExternalGraphWriter& other) = delete;
+
+        /// Destructor.
+        /// Removes any temporary files that remain.
+        virtual ~ExternalGraphWriter(void);
+
+
+        // -------- OPERATORS ---------------------------------------------- //
+
+        /// Copy assignment operator.
+        /// This is a deleted function.
+        ExternalGraphWriter& operator=(const ExternalGraphWriter& other) = delete;
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Fills a buffer with the next edges of the grouping being written, for use as the fill function of an edge source.
+        /// @param [in] arg Pointer to the ExternalGraphWriter object.
+        /// @param [out] buf Buffer to fill.
+        /// @param [in] capacity Number of edges that the buffer can hold.
+        /// @return Number of edges placed into the buffer, which is 0 once every edge has been supplied or an error has occurred.
+        static size_t FillEdgesFunc(void* arg, SEdge<TEdgeData>* const buf, const size_t capacity);
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Allocates the space needed to read and sort chunks.
+        /// @return `true` if successful, `false` otherwise.
+        bool AllocateSlots(void);
+
+        /// Closes and removes all temporary files and releases their buffers.
+        void CloseBucketFiles(void);
+
+        /// Fills a buffer with the next edges of the grouping being written.
+        /// @param [out] buf Buffer to fill.
+        /// @param [in] capacity Number of edges that the buffer can hold.
+        /// @return Number of edges placed into the buffer, which is 0 once every edge has been supplied or an error has occurred.
+        size_t FillEdges(SEdge<TEdgeData>* const buf, const size_t capacity);
+
+        /// Releases the space used to read and sort chunks, as well as the degree counts.
+        void FreeMemory(void);
+
+        /// Reads the edges of a chunk from its temporary file and sorts them by top-level vertex.
+        /// @param [in] chunk Chunk to read.
+        /// @param [in,out] slot Slot into which to place the chunk.
+        /// @return `true` if successful, `false` if an I/O error occurred.
+        bool LoadChunk(const SChunk& chunk, SSlot& slot);
+
+        /// Reads and sorts every chunk of the grouping being written, in order, for use as the body of the background thread.
+        void LoadChunks(void);
+
+        /// Divides the temporary files of the specified grouping into chunks, each of which fits within a slot.
+        /// @param [in] groupedByDestination Indicates that the grouping by destination is being written.
+        void PlanChunks(const bool groupedByDestination);
+
+        /// Sorts the edges of a chunk by top-level vertex, preserving the order of the edges of each top-level vertex.
+        /// Edges are first distributed among ranges of top-level vertices, one per sorting thread, holding roughly equal numbers of edges, and then each thread places the edges of its range at their final positions.
+        /// @param [in] chunk Chunk being sorted.
+        /// @param [in,out] slot Slot that holds the chunk, whose edges are sorted in place.
+        void SortChunk(const SChunk& chunk, SSlot& slot);
+
+        /// Writes every output file that needs the specified grouping.
+        /// @param [in] groupedByDestination Indicates that the grouping by destination is being written.
+        void WriteGrouping(const bool groupedByDestination);
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphWriter.h" for documentation.
+
+        virtual EGraphResult BeginStreamedWrite(const char* const filename, const Graph& graph, const TVertexCount numVertices, const TEdgeCount numEdges);
+        virtual EGraphResult EndStreamedWrite(void);
+        virtual EEdgeDataType GetEdgeDataType(void) const;
+        virtual uint32_t GetNumPartitions(void) const;
+        virtual bool RequiresBothEdgeGroupings(void) const;
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsStreaming(void) const;
+        virtual void WriteStreamedEdges(const void* const buf, const size_t count);
+        virtual EGraphResult WriteGraphToFile(const char* const filename, const Graph& graph, const bool groupedByDestination = false);
+        virtual void WriteGraphToFiles(IGraphWriter* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, EGraphResult* results);
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+    };
+}
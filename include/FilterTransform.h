@@ -0,0 +1,257 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file FilterTransform.h
+ *   Declaration of a graph transformation that removes the edges and
+ *   vertices that do not satisfy a predicate.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphTransform.h"
+#include "Types.h"
+#include "WorkScheduler.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    class Graph;
+    class VertexIndex;
+
+
+    /// Enumerates the predicates by which edges can be filtered.
+    enum EFilterType : int64_t
+    {
+        FilterTypeSelfLoops,                                                ///< Removes edges whose source and destination are the same vertex.
+        FilterTypeDegree,                                                   ///< Removes vertices whose total degree lies outside a range, along with all of their edges.
+        FilterTypeVertexRange,                                              ///< Removes vertices whose identifiers lie outside a range, along with all of their edges.
+        FilterTypeLargestComponent,                                         ///< Removes vertices outside the largest weakly connected component, along with all of their edges.
+    };
+
+
+    /// Transformation class for removing the edges of a graph that do not satisfy a predicate.
+    /// Removing a vertex removes all of its edges, in both directions, but does not renumber any vertices unless the largest component filter is asked to relabel the vertices it keeps.
+    /// Each grouping the graph maintains is filtered in place and compacted in a single parallel pass, which also refreshes its metadata.
+    /// Filters that decide each edge only from its own endpoints can be fused with other such transformations, whereas the degree and largest component filters cannot because they depend on the graph as a whole.
+    /// Weakly connected components are found using a lock-free parallel union-find over the edges of one grouping, in which each root is linked beneath the smaller of the two roots, so the root of every component is its smallest vertex regardless of the order in which threads link them.
+    /// Operates on the frozen representation, freezing the graph first if needed.
+    class FilterTransform : public GraphTransform
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Predicate by which edges are filtered.
+        EFilterType filterType;
+
+        /// Smallest total degree a vertex can have and still be kept, used only when filtering by degree.
+        TEdgeCount minDegree;
+
+        /// Largest total degree a vertex can have and still be kept, used only when filtering by degree.
+        TEdgeCount maxDegree;
+
+        /// First vertex identifier that is kept, used only when filtering by vertex range.
+        TVertexID rangeStart;
+
+        /// Vertex identifier one past the last that is kept, used only when filtering by vertex range.
+        TVertexID rangeEnd;
+
+        /// Temporary buffer shared among all threads, holding four locations per thread.
+        uint64_t* sharedBuf;
+
+        /// Holds the number of edges each top-level vertex keeps.
+        /// Shared among all threads while a vertex index is being filtered.
+        TEdgeCount* keptDegrees;
+
+        /// Holds the total degree of each vertex before any edges are removed, used only when filtering by degree.
+        /// Shared among all threads while the graph is being transformed.
+        std::atomic<TEdgeCount>* degrees;
+
+        /// Number of vertices represented in the degree array.
+        TVertexCount numDegrees;
+
+        /// Specifies that the vertices kept by the largest component filter should be renumbered consecutively from 0, in their original order.
+        bool relabelVertices;
+
+        /// Holds the union-find parent of each vertex and, once all edges are linked, the root of its weakly connected component, used only when filtering by largest component.
+        /// Shared among all threads while the graph is being transformed.
+        std::atomic<TVertexID>* componentParents;
+
+        /// Holds the number of vertices in the component rooted at each vertex, used only when filtering by largest component.
+        /// Shared among all threads while the graph is being transformed.
+        std::atomic<TVertexCount>* componentSizes;
+
+        /// Number of vertices represented in the component arrays.
+        TVertexCount numComponentVertices;
+
+        /// Root of the largest weakly connected component, which is its smallest vertex.
+        TVertexID largestComponent;
+
+        /// New identifier of each kept vertex, indexed by its current identifier, used only when relabeling.
+        /// Shared among all threads while the graph is being transformed.
+        TVertexID* newVertexIDs;
+
+        /// Current identifier of each kept vertex, indexed by its new identifier, used only when relabeling.
+        /// Shared among all threads while the graph is being transformed.
+        TVertexID* oldVertexIDs;
+
+        /// Hands out the vertices and edges of each vertex index to threads, in units balanced by the number of edges they hold.
+        /// Shared among all threads while the graph is being transformed.
+        WorkScheduler workScheduler;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Constructs a transformation that filters using the specified predicate.
+        /// @param [in] filterType Predicate by which edges are filtered.
+        FilterTransform(const EFilterType filterType);
+
+        /// Destructor.
+        virtual ~FilterTransform(void);
+
+
+    private:
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Computes the weakly connected components of the graph and identifies the largest of them, breaking ties in favor of the component with the smallest vertex.
+        /// Invoked by all threads in the Spindle parallelized region on a frozen graph.
+        /// @param [in] graph Graph whose components are to be computed.
+        void ComputeComponents(const Graph& graph);
+
+        /// Computes the total degree of every vertex of the graph, counting edges in both directions.
+        /// Invoked by all threads in the Spindle parallelized region on a frozen graph.
+        /// @param [in] graph Graph whose degrees are to be computed.
+        void ComputeDegrees(const Graph& graph);
+
+        /// Filters a batch of edges that share a top-level vertex, moving the edges that are kept to the front of the batch.
+        /// @tparam TNeighborID Type used to store the identifiers of neighboring vertices.
+        /// @param [in] topLevelVertex Vertex identifier shared by all edges in the batch.
+        /// @param [in,out] neighbors Identifiers of the vertices at the other end of each edge.
+        /// @param [in,out] edgeData Edge data of each edge, or `NULL` if the graph holds no edge data.
+        /// @param [in] count Number of edges in the batch.
+        /// @return Number of edges kept.
+        template <typename TNeighborID> size_t FilterEdgeBatch(const TVertexID topLevelVertex, TNeighborID* const neighbors, UEdgeData* const edgeData, const size_t count) const;
+
+        /// Finds the root of the union-find tree that holds the specified vertex, halving the path to it along the way.
+        /// Safe to invoke concurrently with other finds and with links, since parents only ever move closer to the root.
+        /// @param [in] vertex Vertex identifier.
+        /// @return Root of the tree.
+        inline TVertexID FindComponentRoot(TVertexID vertex) const
+        {
+            while (true)
+            {
+                TVertexID parent = componentParents[vertex].load(std::memory_order_relaxed);
+
+                if (parent == vertex)
+                    return vertex;
+
+                const TVertexID grandparent = componentParents[parent].load(std::memory_order_relaxed);
+
+                if (grandparent != parent)
+                    componentParents[vertex].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+
+                vertex = grandparent;
+            }
+        }
+
+        /// Determines if the edge between the specified vertices is kept.
+        /// @param [in] topLevelVertex Top-level vertex of the edge.
+        /// @param [in] neighbor Vertex at the other end of the edge.
+        /// @return `true` if the edge is kept, `false` otherwise.
+        inline bool KeepsEdge(const TVertexID topLevelVertex, const TVertexID neighbor) const
+        {
+            if (EFilterType::FilterTypeSelfLoops == filterType)
+                return (topLevelVertex != neighbor);
+            else
+                return KeepsVertex(neighbor);
+        }
+
+        /// Determines if the specified vertex is kept, which is a precondition for keeping any of its edges.
+        /// @param [in] vertex Vertex identifier.
+        /// @return `true` if the vertex is kept, `false` otherwise.
+        inline bool KeepsVertex(const TVertexID vertex) const
+        {
+            switch (filterType)
+            {
+            case EFilterType::FilterTypeDegree:
+                {
+                    const TEdgeCount degree = ((vertex < (TVertexID)numDegrees) ? degrees[vertex].load(std::memory_order_relaxed) : 0);
+                    return ((degree >= minDegree) && (degree <= maxDegree));
+                }
+
+            case EFilterType::FilterTypeVertexRange:
+                return ((vertex >= rangeStart) && (vertex < rangeEnd));
+
+            case EFilterType::FilterTypeLargestComponent:
+                return ((vertex < (TVertexID)numComponentVertices) && (largestComponent == componentParents[vertex].load(std::memory_order_relaxed)));
+
+            default:
+                return true;
+            }
+        }
+
+        /// Links the two endpoints of an edge into the same union-find tree, by linking the larger of their roots beneath the smaller.
+        /// Safe to invoke concurrently from multiple threads.
+        /// @param [in] vertexA One endpoint of the edge.
+        /// @param [in] vertexB Other endpoint of the edge.
+        inline void LinkComponents(TVertexID vertexA, TVertexID vertexB)
+        {
+            while (true)
+            {
+                vertexA = FindComponentRoot(vertexA);
+                vertexB = FindComponentRoot(vertexB);
+
+                if (vertexA == vertexB)
+                    return;
+
+                if (vertexA < vertexB)
+                {
+                    const TVertexID smallerRoot = vertexA;
+                    vertexA = vertexB;
+                    vertexB = smallerRoot;
+                }
+
+                // Another thread may have linked the larger root in the meantime, in which case both roots are found again.
+                TVertexID expectedParent = vertexA;
+
+                if (componentParents[vertexA].compare_exchange_strong(expectedParent, vertexB, std::memory_order_relaxed))
+                    return;
+            }
+        }
+
+        /// Renumbers the vertices kept by the largest component filter consecutively from 0, in their original order, leaving only that many vertices in the graph.
+        /// Invoked by all threads in the Spindle parallelized region once every grouping has been filtered, so that no remaining edge refers to a vertex that is not kept.
+        /// @param [in,out] graph Graph whose vertices are to be renumbered.
+        void RelabelKeptVertices(Graph& graph);
+
+        /// Filters all of the edges in a frozen vertex index and compacts what remains.
+        /// Invoked by all threads in the Spindle parallelized region.
+        /// @param [in,out] vertexIndex Vertex index to filter.
+        void TransformVertexIndex(VertexIndex& vertexIndex);
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphTransform.h" for documentation.
+
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        virtual EGraphResult TransformGraph(Graph& graph);
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphTransform.h" for documentation.
+
+        virtual bool CanFuseTransformation(void) const;
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
+    };
+}
@@ -0,0 +1,76 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GAPWriter.h
+ *   Declaration of a graph writer for the serialized graph files used by the
+ *   GAP Benchmark Suite.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphWriter.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Writer object class for graphs represented in the serialized compressed sparse row format of the GAP Benchmark Suite, known as ".sg" when unweighted and ".wsg" when weighted.
+    /// Files begin with a one-byte flag indicating that the graph is directed, followed by the number of edges and the number of vertices as 64-bit integers.
+    /// These are followed by the out-edge section and then the in-edge section, each consisting of one 64-bit offset per vertex plus one more holding the number of edges, and then the vertex at the other end of each edge as a 32-bit integer.
+    /// In weighted files, each neighbor is immediately followed by the weight of its edge as a 32-bit integer.
+    /// Both sections are always written, so the grouping opposite the one being traversed is written directly from the graph's other vertex index, in parallel.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class GAPWriter : public GraphWriter<TEdgeData>
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Indicates that the in-edge section follows the edges being traversed and is written through the secondary file, determined when the file is opened.
+        bool writesInEdgeSectionSeparately;
+
+        /// Position within the file at which the in-edge section begins, determined when the file is opened.
+        int64_t inEdgeSectionPosition;
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Writes one section of the file in parallel, using threads on every NUMA node.
+        /// @param [in] file File handle, positioned where the section begins.
+        /// @param [in] graph Graph to be written.
+        /// @param [in] numVertices Number of vertices to list.
+        /// @param [in] inEdges Indicates that the in-edge section, which comes from the destination-grouped vertex index, should be written instead of the out-edge section.
+        /// @param [in] writesNeighbors Indicates that the neighbors should be written after the offsets.
+        /// @return `true` if the section was written successfully, `false` otherwise.
+        bool WriteSection(FILE* const file, const Graph& graph, const TVertexCount numVertices, const bool inEdges, const bool writesNeighbors) const;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        GAPWriter(void);
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphWriter.h" for documentation.
+
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
+        virtual void FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const;
+        virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual FILE* OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool RequiresBothEdgeGroupings(void) const;
+        virtual bool SupportsParallelFormatting(void) const;
+        virtual bool UsesSecondaryGraphFile(void) const;
+        virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
+    };
+}
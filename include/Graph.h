@@ -18,12 +18,14 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 
 namespace GraphTool
 {
     /// Represents a graph.
     /// Internal format is like Compressed-Sparse and is optimized for mutability.
+    /// Once no further structural changes are expected, the graph can be frozen into a true Compressed-Sparse representation that is far more compact and faster to traverse.
     /// Holds topology information and per-edge data, such as weights.
     class Graph
     {
@@ -52,6 +54,14 @@ namespace GraphTool
         /// Maps from a source vertex ID to a set of vertices to which out-edges exist.
         VertexIndex edgesBySource;
         
+        /// Specifies that edges are maintained grouped by destination.
+        /// Otherwise, the destination-grouped data structure is left empty and all operations that would modify it are skipped.
+        bool hasEdgesByDestination;
+        
+        /// Specifies that edges are maintained grouped by source.
+        /// Otherwise, the source-grouped data structure is left empty and all operations that would modify it are skipped.
+        bool hasEdgesBySource;
+        
         
     public:
         // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
@@ -62,33 +72,123 @@ namespace GraphTool
 
         // -------- INSTANCE METHODS --------------------------------------- //
         
+        /// Allocates storage for edge data in all vertex indices, if it does not already exist.
+        /// Intended for transformations that add edge data to a graph that was read without any.
+        inline void AllocateEdgeData(void)
+        {
+            edgesByDestination.AllocateEdgeData();
+            edgesBySource.AllocateEdgeData();
+        }
+        
         /// Verifies that the edge data format in the graph matches the template argument.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @return `true` if so, `false` otherwise.
         template <typename TEdgeData> bool DoesEdgeDataTypeMatch(void) const;
         
+        /// Estimates the largest amount of memory that ingress of a graph of the specified size would need to hold its edges, considering only the groupings currently maintained and the current edge data type.
+        /// For ordinary ingress, this accounts for the mutable representations built while edges are inserted, each of which is replaced by its compact representation in turn when the graph is frozen.
+        /// For preallocated ingress, edges are placed directly into the compact representations, so only those and the degree counts are needed.
+        /// @param [in] numVertices Number of vertices, all of which have identifiers less than this value.
+        /// @param [in] numEdges Number of edges.
+        /// @param [in] preallocated Specifies that ingress is preallocated rather than ordinary.
+        /// @return Estimated number of bytes.
+        uint64_t EstimateIngressFootprint(const TVertexCount numVertices, const TEdgeCount numEdges, const bool preallocated) const;
+        
+        /// Counts the specified edge towards the degree of its destination vertex during the first pass of preallocated ingress.
+        /// Can be invoked from multiple threads, so long as each thread updates a different destination vertex.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] edge Edge to count.
+        template <typename TEdgeData> inline void FastCountEdgeByDestination(const SEdge<TEdgeData>& edge)
+        {
+            edgesByDestination.FastCountEdgeIndexedByDestination(edge);
+        }
+        
+        /// Counts the specified edge towards the degree of its source vertex during the first pass of preallocated ingress.
+        /// Can be invoked from multiple threads, so long as each thread updates a different source vertex.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] edge Edge to count.
+        template <typename TEdgeData> inline void FastCountEdgeBySource(const SEdge<TEdgeData>& edge)
+        {
+            edgesBySource.FastCountEdgeIndexedBySource(edge);
+        }
+        
         /// Performs a simple and fast insertion of the specified edge into the destination-grouped data structure.
         /// Does not update any internal counters for vectors or edges, nor does it automatically maintain consistency.
         /// Can be invoked from multiple threads, so long as each thread updates a different top-level vertex.
         /// Intended to be invoked during ingress or during large batch updates.
+        /// Requires that arenas first be initialized for all calling threads.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] edge Edge to insert.
-        template <typename TEdgeData> inline void FastInsertEdgeByDestination(const SEdge<TEdgeData>& edge)
+        /// @param [in] threadID Local thread identifier of the calling thread.
+        template <typename TEdgeData> inline void FastInsertEdgeByDestination(const SEdge<TEdgeData>& edge, const uint32_t threadID)
         {
-            edgesByDestination.FastInsertEdgeIndexedByDestination(edge);
+            edgesByDestination.FastInsertEdgeIndexedByDestination(edge, threadID);
         }
         
         /// Performs a simple and fast insertion of the specified edge into the source-grouped data structure.
         /// Does not update any internal counters for vectors or edges, nor does it automatically maintain consistency.
         /// Can be invoked from multiple threads, so long as each thread updates a different top-level vertex.
         /// Intended to be invoked during ingress or during large batch updates.
+        /// Requires that arenas first be initialized for all calling threads.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] edge Edge to insert.
-        template <typename TEdgeData> inline void FastInsertEdgeBySource(const SEdge<TEdgeData>& edge)
+        /// @param [in] threadID Local thread identifier of the calling thread.
+        template <typename TEdgeData> inline void FastInsertEdgeBySource(const SEdge<TEdgeData>& edge, const uint32_t threadID)
+        {
+            edgesBySource.FastInsertEdgeIndexedBySource(edge, threadID);
+        }
+        
+        /// Places the specified edge directly into the destination-grouped compact representation during the second pass of preallocated ingress.
+        /// Can be invoked from multiple threads, so long as each thread updates a different destination vertex.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] edge Edge to place.
+        template <typename TEdgeData> inline void FastScatterEdgeByDestination(const SEdge<TEdgeData>& edge)
+        {
+            edgesByDestination.FastScatterEdgeIndexedByDestination(edge);
+        }
+        
+        /// Places the specified edge directly into the source-grouped compact representation during the second pass of preallocated ingress.
+        /// Can be invoked from multiple threads, so long as each thread updates a different source vertex.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] edge Edge to place.
+        template <typename TEdgeData> inline void FastScatterEdgeBySource(const SEdge<TEdgeData>& edge)
         {
-            edgesBySource.FastInsertEdgeIndexedBySource(edge);
+            edgesBySource.FastScatterEdgeIndexedBySource(edge);
         }
         
+        /// Replaces the contents of the graph with a single grouping of edges that holds the specified degrees but no edges, so that the graph describes the shape of a graph whose edges are held elsewhere.
+        /// Intended for writing graphs whose edges are supplied to the writers from elsewhere, such as during an external-memory conversion, since writers can then obtain the number of vertices and edges and the degree of each top-level vertex from the graph.
+        /// The graph is frozen, but its edges cannot be accessed, modified, regrouped, or thawed.
+        /// Creates parallel regions internally, so this method must not be invoked from within one.
+        /// @param [in] groupedByDestination Specifies that the degrees are those of the destination-grouped edges instead of the source-grouped edges.
+        /// @param [in] degrees Degree of each vertex.
+        /// @param [in] numVertices Number of vertices.
+        /// @return Result of the operation.
+        EGraphResult AdoptDegrees(const bool groupedByDestination, const TEdgeCount* degrees, const TVertexCount numVertices);
+        
+        /// Applies a batch of edge deletions and insertions to all maintained vertex indices.
+        /// Each index is replaced by an updated compact representation built in parallel, into which the edges of unchanged vertices are copied in blocks.
+        /// Each deletion removes every edge between its source and destination vertices, and deletions are applied before insertions, so deleting and then inserting an edge replaces it.
+        /// The graph is frozen first, and grows to include any vertex named by an insertion. Sorted indices remain sorted.
+        /// Creates parallel regions internally, so this method must not be invoked from within one.
+        /// @param [in] insertions Edges to insert, in any order, each holding its source vertex as the top-level vertex and its destination vertex as the other vertex.
+        /// @param [in] deletions Edges to delete, in the same form as the insertions, whose edge data are ignored.
+        /// @return Result of the operation.
+        EGraphResult ApplyEdgeBatch(const std::vector<SBatchEdge>& insertions, const std::vector<SBatchEdge>& deletions);
+        
+        /// Ensures that edges are available grouped as specified, building the missing grouping if necessary by transposing the other one.
+        /// The graph is frozen first, and the newly-built grouping is frozen and sorted by the vertex at the other end of each edge.
+        /// Creates parallel regions internally, so this method must not be invoked from within one.
+        /// @param [in] groupedByDestination Specifies that edges are required grouped by destination instead of by source.
+        /// @return Result of the operation.
+        EGraphResult BuildEdgeGrouping(const bool groupedByDestination);
+        
+        /// Freezes all maintained vertex indices into their compact representations.
+        /// Creates a parallel region internally, so this method must not be invoked from within one.
+        /// The graph is automatically thawed if any subsequent non-fast modification is made to it.
+        /// @return Result of the freeze operation.
+        EGraphResult Freeze(void);
+        
         /// Retrieves and returns the type of data held at each edge.
         /// @return Edge data type.
         inline EEdgeDataType GetEdgeDataType(void) const
@@ -100,14 +200,14 @@ namespace GraphTool
         /// @return Number of edges in the graph.
         inline TEdgeCount GetNumEdges(void) const
         {
-            return edgesBySource.GetNumEdges();
+            return (hasEdgesBySource ? edgesBySource.GetNumEdges() : edgesByDestination.GetNumEdges());
         }
 
         /// Retrieves and returns the number of vertices in the graph.
         /// @return Number of vertices in the graph.
         inline TVertexCount GetNumVertices(void) const
         {
-            return edgesBySource.GetNumVertices();
+            return (hasEdgesBySource ? edgesBySource.GetNumVertices() : edgesByDestination.GetNumVertices());
         }
 
         /// Retrieves and returns the number of vertices having non-zero indegree.
@@ -139,6 +239,7 @@ namespace GraphTool
         }
         
         /// Retrieves and returns the in-degree of the specified vertex.
+        /// Requires that edges be maintained grouped by destination.
         /// @param [in] vertex Identifier of the vertex of interest.
         /// @return In-degree of the specified vertex. 0 is returned if the vertex has no in-edges or does not exist.
         inline TEdgeCount GetVertexIndegree(TVertexID vertex) const
@@ -147,6 +248,7 @@ namespace GraphTool
         }
         
         /// Retrieves and returns the out-degree of the specified vertex.
+        /// Requires that edges be maintained grouped by source.
         /// @param [in] vertex Identifier of the vertex of interest.
         /// @return Out-degree of the specified vertex. 0 is returned if the vertex has no out-edges or does not exist.
         inline TEdgeCount GetVertexOutdegree(TVertexID vertex) const
@@ -154,44 +256,195 @@ namespace GraphTool
             return edgesBySource.GetDegree(vertex);
         }
         
+        /// Specifies if edges are maintained grouped by destination.
+        /// @return `true` if so, `false` otherwise.
+        inline bool HasEdgesByDestination(void) const
+        {
+            return hasEdgesByDestination;
+        }
+        
+        /// Specifies if edges are maintained grouped by source.
+        /// @return `true` if so, `false` otherwise.
+        inline bool HasEdgesBySource(void) const
+        {
+            return hasEdgesBySource;
+        }
+        
         /// Inserts an edge into the graph.
         /// Intended to perform minor updates to the graph after ingress.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] edge Edge to insert.
         template <typename TEdgeData> inline void InsertEdge(const SEdge<TEdgeData>& edge)
         {
-            InsertEdgeByDestination(edge);
-            InsertEdgeBySource(edge);
+            if (hasEdgesByDestination)
+                InsertEdgeByDestination(edge);
+            
+            if (hasEdgesBySource)
+                InsertEdgeBySource(edge);
         }
         
         /// Inserts an edge into the destination-grouped representation using the specified edge buffer.
         /// Does not automatically maintain consistency.
         /// Intended to be invoked during ingress or during large batch updates.
+        /// If edges are not also maintained grouped by source, the destination-grouped representation grows to cover the source vertex as well, so that the number of vertices bounds every identifier.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] edge Edge to insert.
         template <typename TEdgeData> inline void InsertEdgeByDestination(const SEdge<TEdgeData>& edge)
         {
+            if (!hasEdgesBySource && (edge.sourceVertex >= edgesByDestination.GetNumVertices()))
+                edgesByDestination.SetNumVertices(1 + edge.sourceVertex);
+            
             edgesByDestination.InsertEdgeIndexedByDestination(edge);
         }
         
         /// Inserts an edge into the source-grouped representation using the specified edge buffer.
         /// Does not automatically maintain consistency.
         /// Intended to be invoked during ingress or during large batch updates.
+        /// If edges are not also maintained grouped by destination, the source-grouped representation grows to cover the destination vertex as well, so that the number of vertices bounds every identifier.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] edge Edge to insert.
         template <typename TEdgeData> inline void InsertEdgeBySource(const SEdge<TEdgeData>& edge)
         {
+            if (!hasEdgesByDestination && (edge.destinationVertex >= edgesBySource.GetNumVertices()))
+                edgesBySource.SetNumVertices(1 + edge.destinationVertex);
+            
             edgesBySource.InsertEdgeIndexedBySource(edge);
         }
         
+        /// Specifies if the graph is currently frozen into its compact representation.
+        /// @return `true` if so, `false` otherwise.
+        inline bool IsFrozen(void) const
+        {
+            return ((!hasEdgesByDestination || edgesByDestination.IsFrozen()) && (!hasEdgesBySource || edgesBySource.IsFrozen()));
+        }
+        
+        /// Allocates the compact representations of all maintained vertex indices using the degrees counted during the first pass of preallocated ingress.
+        /// Intended to be called from within a Spindle parallelized region.
+        /// @param [in] buf Temporary array allocated with one location per thread.
+        inline void ParallelAllocateFromDegrees(uint64_t* buf)
+        {
+            const bool keepEdgeData = (EEdgeDataType::EdgeDataTypeVoid != edgeDataType);
+            
+            if (hasEdgesByDestination)
+                edgesByDestination.ParallelAllocateFromDegrees(keepEdgeData, buf);
+            
+            if (hasEdgesBySource)
+                edgesBySource.ParallelAllocateFromDegrees(keepEdgeData, buf);
+        }
+        
+        /// Prepares the graph for preallocated ingress, in which edges are read twice and placed directly into the compact representation.
+        /// The first pass counts degrees, after which storage is allocated exactly once, and the second pass places each edge into its final position.
+        /// Any existing contents of the graph are destroyed.
+        /// Intended to be called from within a Spindle parallelized region.
+        /// @param [in] numVertices Number of vertices, all of which must have identifiers less than this value.
+        inline void ParallelBeginPreallocatedIngress(const TVertexCount numVertices)
+        {
+            if (hasEdgesByDestination)
+                edgesByDestination.ParallelBeginPreallocatedIngress(numVertices);
+            
+            if (hasEdgesBySource)
+                edgesBySource.ParallelBeginPreallocatedIngress(numVertices);
+        }
+        
+        /// Builds the specified grouping of edges by transposing the other grouping, which must be frozen.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// Does not record that the grouping is now maintained, which is left to BuildEdgeGrouping once the region completes.
+        /// @param [in] groupedByDestination Specifies that the destination-grouped edges are to be built from the source-grouped edges, rather than the other way around.
+        /// @param [in] edgeBuf Temporary array allocated with two locations per edge.
+        /// @param [in] buf Temporary array allocated with four locations per thread in the region, plus one location per pair of threads.
+        inline void ParallelBuildEdgeGrouping(const bool groupedByDestination, uint64_t* edgeBuf, uint64_t* buf)
+        {
+            const bool keepEdgeData = (EEdgeDataType::EdgeDataTypeVoid != edgeDataType);
+            
+            if (groupedByDestination)
+                edgesByDestination.ParallelTransposeFrom(edgesBySource, keepEdgeData, edgeBuf, buf);
+            else
+                edgesBySource.ParallelTransposeFrom(edgesByDestination, keepEdgeData, edgeBuf, buf);
+        }
+        
+        /// Completes preallocated ingress once all edges have been placed.
+        /// Intended to be called from within a Spindle parallelized region.
+        /// Metadata must subsequently be refreshed.
+        inline void ParallelEndPreallocatedIngress(void)
+        {
+            if (hasEdgesByDestination)
+                edgesByDestination.ParallelEndPreallocatedIngress();
+            
+            if (hasEdgesBySource)
+                edgesBySource.ParallelEndPreallocatedIngress();
+        }
+        
+        /// Freezes all maintained vertex indices into their compact representations, partitioned across NUMA nodes.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// @param [in] buf Temporary array allocated with one location per thread in the region.
+        inline void ParallelFreeze(uint64_t* buf)
+        {
+            const bool keepEdgeData = (EEdgeDataType::EdgeDataTypeVoid != edgeDataType);
+            
+            // Every source identifier is bounded by the size of the source-grouped index, and likewise for destinations, so the larger of the two bounds all identifiers.
+            // An index maintained on its own grows to cover both ends of every edge, so its size alone is enough.
+            const TVertexCount otherVertexLimit = ((edgesByDestination.GetNumVertices() > edgesBySource.GetNumVertices()) ? edgesByDestination.GetNumVertices() : edgesBySource.GetNumVertices());
+            
+            if (hasEdgesByDestination)
+                edgesByDestination.ParallelFreeze(keepEdgeData, otherVertexLimit, buf);
+            
+            if (hasEdgesBySource)
+                edgesBySource.ParallelFreeze(keepEdgeData, otherVertexLimit, buf);
+        }
+        
+        /// Ensures that all maintained vertex indices have an arena for each thread in the calling Spindle parallelized region.
+        /// Must be called before any fast insertion methods are invoked.
+        /// @param [in] numaNode NUMA node on which any newly-created arenas should allocate memory.
+        inline void ParallelInitializeArenas(const uint32_t numaNode)
+        {
+            if (hasEdgesByDestination)
+                edgesByDestination.ParallelInitializeArenas(numaNode);
+            
+            if (hasEdgesBySource)
+                edgesBySource.ParallelInitializeArenas(numaNode);
+        }
+        
         /// Refreshes graph metadata, such as degree information.
         /// Intended to be called from within a Spindle parallelized region.
         /// Required after invoking fast insertion methods, which do not update any counts.
         /// @param [in] buf Temporary array allocated with two locations per thread.
         inline void ParallelRefreshMetadata(uint64_t* buf)
         {
-            edgesByDestination.ParallelRefreshMetadata(buf);
-            edgesBySource.ParallelRefreshMetadata(buf);
+            if (hasEdgesByDestination)
+                edgesByDestination.ParallelRefreshMetadata(buf);
+            
+            if (hasEdgesBySource)
+                edgesBySource.ParallelRefreshMetadata(buf);
+        }
+        
+        /// Renumbers every vertex in all maintained vertex indices according to the specified permutation, which must be frozen.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// Edges keep their relative order within each vertex, so they are no longer sorted.
+        /// @param [in] newIDs New identifier of each vertex, indexed by its current identifier.
+        /// @param [in] oldIDs Current identifier of each vertex, indexed by its new identifier.
+        /// @param [in] buf Temporary array allocated with one location per thread in the region.
+        inline void ParallelRelabelVertices(const TVertexID* newIDs, const TVertexID* oldIDs, uint64_t* buf)
+        {
+            // Every identifier is less than the size of the larger index, so both indices are given that many top-level vertices.
+            const TVertexCount numVertices = ((edgesByDestination.GetNumVertices() > edgesBySource.GetNumVertices()) ? edgesByDestination.GetNumVertices() : edgesBySource.GetNumVertices());
+            
+            ParallelRelabelVertices(newIDs, oldIDs, numVertices, buf);
+        }
+        
+        /// Renumbers the vertices in all maintained vertex indices according to the specified permutation, which must be frozen, leaving the specified number of vertices in the graph.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// Vertices whose identifiers are not less than the specified number after renumbering must have no edges, in which case they are removed from the graph.
+        /// @param [in] newIDs New identifier of each vertex, indexed by its current identifier.
+        /// @param [in] oldIDs Current identifier of each vertex, indexed by its new identifier.
+        /// @param [in] numVertices Number of vertices that remain in the graph.
+        /// @param [in] buf Temporary array allocated with one location per thread in the region.
+        inline void ParallelRelabelVertices(const TVertexID* newIDs, const TVertexID* oldIDs, const TVertexCount numVertices, uint64_t* buf)
+        {
+            if (hasEdgesByDestination)
+                edgesByDestination.ParallelRelabelFrozen(newIDs, oldIDs, numVertices, buf);
+            
+            if (hasEdgesBySource)
+                edgesBySource.ParallelRelabelFrozen(newIDs, oldIDs, numVertices, buf);
         }
         
         /// Removes an edge from the graph.
@@ -199,8 +452,11 @@ namespace GraphTool
         /// @param [in] toVertex Identifies the destination vertex of the edge.
         inline void RemoveEdge(const TVertexID fromVertex, const TVertexID toVertex)
         {
-            edgesByDestination.RemoveEdge(toVertex, fromVertex);
-            edgesBySource.RemoveEdge(fromVertex, toVertex);
+            if (hasEdgesByDestination)
+                edgesByDestination.RemoveEdge(toVertex, fromVertex);
+            
+            if (hasEdgesBySource)
+                edgesBySource.RemoveEdge(fromVertex, toVertex);
         }
         
         /// Removes a vertex from the graph, including all edges that include it.
@@ -211,13 +467,54 @@ namespace GraphTool
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         template <typename TEdgeData> void SetEdgeDataType(void);
         
+        /// Specifies which groupings of edges the graph maintains, destroying the contents of any grouping that is no longer maintained.
+        /// Intended to be invoked before ingress, so that only the groupings actually needed are built; any other grouping can be built later using BuildEdgeGrouping.
+        /// If neither grouping is requested, edges are maintained grouped by source.
+        /// @param [in] byDestination Specifies that edges should be maintained grouped by destination.
+        /// @param [in] bySource Specifies that edges should be maintained grouped by source.
+        void SetEdgeGroupings(const bool byDestination, const bool bySource);
+        
         /// Sets the number of vertices in the graph.
         /// This operation causes a change in the underlying graph data structures.
         /// @param [in] numVertices Number of vertices.
         inline void SetNumVertices(const TVertexCount numVertices)
         {
-            edgesByDestination.SetNumVertices(numVertices);
-            edgesBySource.SetNumVertices(numVertices);
+            if (hasEdgesByDestination)
+                edgesByDestination.SetNumVertices(numVertices);
+            
+            if (hasEdgesBySource)
+                edgesBySource.SetNumVertices(numVertices);
+        }
+        
+        /// Reduces the number of vertices during the first pass of preallocated ingress, before the compact representations are allocated.
+        /// Every vertex removed must have no edges counted.
+        /// @param [in] numVertices New number of vertices.
+        inline void ShrinkPreallocatedIngress(const TVertexCount numVertices)
+        {
+            if (hasEdgesByDestination)
+                edgesByDestination.ShrinkPreallocatedIngress(numVertices);
+            
+            if (hasEdgesBySource)
+                edgesBySource.ShrinkPreallocatedIngress(numVertices);
+        }
+        
+        /// Converts all maintained vertex indices back to their mutable representations.
+        /// Has no effect if the graph is not frozen.
+        inline void Thaw(void)
+        {
+            edgesByDestination.Thaw();
+            edgesBySource.Thaw();
+        }
+        
+        /// Reverses the direction of every edge in the graph by exchanging the source-grouped and destination-grouped vertex indices.
+        /// Takes constant time regardless of the size of the graph, and all metadata remain correct.
+        inline void Transpose(void)
+        {
+            edgesByDestination.Swap(edgesBySource);
+            
+            const bool hadEdgesByDestination = hasEdgesByDestination;
+            hasEdgesByDestination = hasEdgesBySource;
+            hasEdgesBySource = hadEdgesByDestination;
         }
         
         /// Enables direct random read-only access to the destination-grouped vertex index.
@@ -227,6 +524,14 @@ namespace GraphTool
             return (const VertexIndex&)edgesByDestination;
         }
 
+        /// Enables direct random writable access to the destination-grouped vertex index.
+        /// Intended for use by transformation objects.
+        /// @return Writable reference to destination-grouped vertex index.
+        inline VertexIndex& VertexIndexDestinationWritable(void)
+        {
+            return edgesByDestination;
+        }
+
         /// Enables direct random read-only access to the source-grouped vertex index.
         /// @return Read-only reference to source-grouped vertex index.
         inline const VertexIndex& VertexIndexSource(void) const
@@ -234,6 +539,14 @@ namespace GraphTool
             return (const VertexIndex&)edgesBySource;
         }
         
+        /// Enables direct random writable access to the source-grouped vertex index.
+        /// Intended for use by transformation objects.
+        /// @return Writable reference to source-grouped vertex index.
+        inline VertexIndex& VertexIndexSourceWritable(void)
+        {
+            return edgesBySource;
+        }
+        
         /// Obtains a read-only random-access iterator to the specified vertex within the destination-grouped vertex index.
         /// @param [in] vertex Position within the vertex index.
         /// @return Read-only iterator to the specified vertex within the index.
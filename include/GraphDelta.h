@@ -0,0 +1,56 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GraphDelta.h
+ *   Declaration of the delta file format, which describes a batch of edge
+ *   insertions and deletions to apply to a graph.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Types.h"
+
+#include <cstddef>
+
+
+namespace GraphTool
+{
+    class Graph;
+
+
+    /// Reads delta files, which describe changes to a graph as a batch of edges to insert and edges to delete, and applies them to a graph.
+    /// Each line of a delta file holds one change: '+' followed by a source vertex, a destination vertex, and, if the graph is weighted, an edge weight inserts an edge, and '-' followed by a source vertex and a destination vertex deletes every edge between them.
+    /// Blank lines and lines beginning with '#' or '%' are ignored.
+    /// All deletions are applied before any insertions, regardless of their order within the file, so deleting and then inserting an edge replaces it.
+    /// Not intended to be instantiated.
+    class GraphDelta
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Maximum length of a line in a delta file, in characters.
+        static const size_t kMaxLineLength = 1024;
+
+
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor. Should never be invoked.
+        GraphDelta(void) = delete;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Reads a delta file and applies all of its changes to the specified graph as a single batch.
+        /// @param [in] filename File name of the delta file.
+        /// @param [in,out] graph Graph to change, which is frozen if it is not already. Not modified if the file cannot be read.
+        /// @param [out] numInsertions Number of edges inserted.
+        /// @param [out] numDeletions Number of deletions applied.
+        /// @return Result of the operation.
+        static EGraphResult ApplyDeltaFromFile(const char* const filename, Graph& graph, TEdgeCount& numInsertions, TEdgeCount& numDeletions);
+    };
+}
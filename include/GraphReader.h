@@ -15,18 +15,27 @@
 
 #include "IGraphReader.h"
 #include "Types.h"
+#include "VertexIDMap.h"
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <string>
+#include <vector>
 
 
 namespace GraphTool
 {
     class Graph;
+    class IGraphWriter;
+    template <typename TEdgeData> struct SGraphReadShard;
+    template <typename TEdgeData> struct SGraphReadSpec;
 
     
     /// Base class for all object types that are used to interpret graph files of various formats.
     /// Objects in this hierarchy load graph data from a file and produce one of the graph objects.
+    /// A graph may also be split across several files, called shards, each of which is a complete file in the same format and is read by its own copy of the reader.
     /// Some common functionality is implemented directly in the base class.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
     template <typename TEdgeData> class GraphReader : public IGraphReader
@@ -34,10 +43,35 @@ namespace GraphTool
     private:
         // -------- CONSTANTS ---------------------------------------------- //
         
-        /// Specifies the size in bytes of each read buffer to use when reading data from the file.
-        /// Two buffers are created, 64MB each by default.
+        /// Specifies the default size in bytes of each read buffer to use when reading data from the file.
         static const size_t kGraphReadBufferSize = (64ull * 1024ull * 1024ull);
         
+        /// Specifies the largest supported size in bytes of each read buffer.
+        static const size_t kGraphReadBufferSizeMax = (4096ull * 1024ull * 1024ull);
+        
+        /// Specifies the default number of read buffers, which is the number of buffers the edge producer can fill before the consumers finish with the first.
+        static const uint32_t kGraphReadBufferCount = 2;
+        
+        /// Specifies the default largest number of shards read concurrently, each by its own edge producer thread.
+        static const uint32_t kGraphReadShardThreads = 4;
+        
+        /// Specifies the largest supported number of shards read concurrently.
+        static const uint32_t kGraphReadShardThreadsMax = 64;
+        
+        /// Specifies the number of zero bytes that follow the contents of each raw chunk buffer, permitting parsers to load past the end of the chunk.
+        static const size_t kGraphReadChunkPadding = 64;
+        
+        
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+        
+        /// Enumerates the ways in which the estimated memory footprint of ingress is checked against the memory available before reading begins.
+        enum EMemoryCheck
+        {
+            MemoryCheckOff,                                                 ///< Do not check.
+            MemoryCheckAuto,                                                ///< Switch to two-pass ingress if only that fits, otherwise fail if the estimate does not fit.
+            MemoryCheckStrict,                                              ///< Fail if the estimate for the selected ingress strategy does not fit.
+        };
+        
         
     protected:
         // -------- INSTANCE VARIABLES ------------------------------------- //
@@ -49,6 +83,46 @@ namespace GraphTool
         TEdgeCount numEdgesInFile;
         
         
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+        
+        /// Specifies that the graph should be ingested in two passes over the file, first counting degrees and then placing edges directly into preallocated storage.
+        bool useTwoPassIngress;
+        
+        /// Specifies how the estimated memory footprint of ingress is checked before reading begins.
+        EMemoryCheck memoryCheck;
+        
+        /// Specifies that the graph file should be read using asynchronous direct I/O, if this reader supports it.
+        bool useDirectIO;
+        
+        /// Number of requests to keep in flight when reading using asynchronous direct I/O.
+        uint32_t directIOQueueDepth;
+        
+        /// Number of threads that decompress a compressed graph file whose parts can be decompressed independently.
+        uint32_t numDecompressionThreads;
+        
+        /// Number of read buffers shared by the edge producer and the consumers.
+        uint32_t numReadBuffers;
+        
+        /// Size in bytes of each read buffer.
+        size_t readBufferSize;
+        
+        /// Number of consumer threads, or 0 to use all of the threads available.
+        uint32_t numConsumerThreads;
+        
+        /// Largest number of shards read concurrently, which is the largest number of edge producer threads.
+        uint32_t numShardThreads;
+        
+        /// Specifies that vertex identifiers read from the file should be replaced by dense identifiers as edges are read.
+        bool remapVertexIDs;
+        
+        /// File to which the mapping from dense identifiers back to the identifiers read from the file is written, or empty if it is not written.
+        std::string vertexIDMapFile;
+        
+        /// Maps vertex identifiers read from the file to dense identifiers, allocated only while a graph is being read with remapping enabled.
+        VertexIDMap vertexIDMap;
+        
+        
     public:
         // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
         
@@ -59,19 +133,170 @@ namespace GraphTool
         virtual ~GraphReader(void);
         
         
+    protected:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+        
+        /// Copy constructor.
+        /// Copies the options of the other reader, but nothing it knows about any file it has read, so that the new reader can read a shard of the same graph.
+        /// Intended for use by subclasses as part of their implementation of CreateShardReader.
+        /// @param [in] other Reader whose options are to be copied.
+        GraphReader(const GraphReader<TEdgeData>& other);
+        
+        
     private:
         // -------- CLASS METHODS ------------------------------------------ //
+        
+        /// Determines whether the number of edges in the graph, as set when its shards were opened, is exact.
+        /// This is the case only if the edge count of every shard is exact.
+        /// @param [in] shards Shards of the graph, all of which are open.
+        /// @return `true` if the number of edges is exact, `false` otherwise.
+        static bool AreShardEdgeCountsExact(const std::vector<SGraphReadShard<TEdgeData>>& shards);
 
+        /// Controls the consumption of edges from a buffer to a graph object during the first pass of two-pass ingress, for use as a Spindle task function.
+        /// Counts the degree of each vertex and then allocates all storage needed to hold the graph.
+        /// @param [in] arg Pointer to an instance of SGraphReadSpec that defines the graph read operation.
+        static void DegreeCountConsumer(void* arg);
+        
         /// Controls the consumption of edges from a buffer to a graph object, for use as a Spindle task function.
+        /// With more than two threads, each buffer is first partitioned so that every thread visits only the edges whose top-level vertices fall within its own contiguous range.
         /// @param [in] arg Pointer to an instance of SGraphReadSpec that defines the graph read operation.
         static void EdgeConsumer(void* arg);
         
         /// Controls the production of edges from a graph file to a buffer, for use as a Spindle task function.
-        /// Should be called by a single thread.
+        /// May be called by several threads, each of which reads whole shards, claiming the next unread shard whenever it finishes one, and publishes an empty buffer once no shards remain.
+        /// Fills each buffer as soon as the consumers have released it, so reading can run up to a full ring of buffers ahead of consumption.
         /// @param [in] arg Pointer to an instance of SGraphReadSpec that defines the graph read operation.
         static void EdgeProducer(void* arg);
         
+        /// Controls the consumption of edges from a buffer to a graph object during the second pass of two-pass ingress, for use as a Spindle task function.
+        /// Places each edge directly into the storage allocated during the first pass.
+        /// @param [in] arg Pointer to an instance of SGraphReadSpec that defines the graph read operation.
+        static void EdgeScatterConsumer(void* arg);
+        
+        /// Frees the buffers allocated by AllocateReadBuffers.
+        /// @param [in,out] bufs Edge buffers, emptied on return.
+        /// @param [in,out] chunks Raw chunk buffers, emptied on return.
+        static void FreeReadBuffers(std::vector<SEdge<TEdgeData>*>& bufs, std::vector<char*>& chunks);
+        
+        /// Parses the raw chunk of file contents in the specified buffer into edges, using all threads in the Spindle parallelized region.
+        /// Each thread parses a separate byte range, and once all are done the edges are placed into the edge buffer in file order, replacing the buffer's byte count with its edge count.
+        /// Does nothing if the reader does not parse in parallel.
+        /// @param [in,out] readSpec Graph read operation specification.
+        /// @param [in] bufferIndex Index of the buffer to parse.
+        /// @param [in,out] parsedEdges Per-thread scratch space, grown as needed.
+        static void ParallelParseChunk(SGraphReadSpec<TEdgeData>* readSpec, const uint32_t bufferIndex, std::vector<SEdge<TEdgeData>>& parsedEdges);
+        
+        /// Releases the specified buffer back to the edge producer once all consumer threads are finished with it.
+        /// Invoked by all consumer threads at the end of each buffer.
+        /// @param [in,out] readSpec Graph read operation specification.
+        /// @param [in] sequence Sequence number of the buffer.
+        static void ParallelReleaseBuffer(SGraphReadSpec<TEdgeData>* readSpec, const uint64_t sequence);
+        
+        /// Replaces the vertex identifiers of the edges in the specified buffer with dense identifiers, using all threads in the Spindle parallelized region.
+        /// Each thread remaps a separate slice of the buffer, assigning new dense identifiers to identifiers not seen before, and all threads are done once this method returns.
+        /// Identifiers that cannot be mapped are replaced by 0, and the map records the failure so that reading can be failed once it completes.
+        /// Does nothing unless vertex identifiers are being remapped.
+        /// @param [in,out] readSpec Graph read operation specification.
+        /// @param [in] bufferIndex Index of the buffer to remap.
+        static void ParallelRemapEdgeBuffer(SGraphReadSpec<TEdgeData>* readSpec, const uint32_t bufferIndex);
+        
+        /// Waits for the next buffer that holds edges, releasing the empty buffers with which each edge producer thread but the last signals that it is done.
+        /// Invoked by all consumer threads, all of which reach the same outcome because it depends only on what the edge producer threads have published.
+        /// @param [in,out] readSpec Graph read operation specification.
+        /// @param [in,out] sequence Sequence number of the next buffer to consume, advanced past any empty buffers released.
+        /// @param [in,out] numFinishedProducers Number of edge producer threads known to be done, updated as empty buffers are encountered.
+        /// @param [in,out] stallTime Time spent waiting, increased by the time spent waiting for buffers.
+        /// @return `true` if the buffer identified by the sequence number holds edges, `false` once every edge producer thread is done.
+        static bool ParallelWaitForBuffer(SGraphReadSpec<TEdgeData>* readSpec, uint64_t& sequence, uint32_t& numFinishedProducers, uint64_t& stallTime);
         
+        /// Opens shards and reads their headers, one at a time, until none remain, for use as a thread function.
+        /// Several threads open different shards at once, each of which has its own reader object.
+        /// Shards that cannot be opened are left without a file handle.
+        /// @param [in,out] shards Shards of the graph.
+        /// @param [in,out] nextShard Index of the next shard to be opened by any thread.
+        static void ShardOpenWorker(std::vector<SGraphReadShard<TEdgeData>>* shards, std::atomic<size_t>* nextShard);
+        
+        /// Controls the consumption of edges from a buffer to one or more graph writers when streaming, for use as a Spindle task function.
+        /// Every buffer is passed to each writer in turn, after checking that its edges refer only to vertices within the count given in the file header.
+        /// @param [in] arg Pointer to an instance of SGraphReadSpec that defines the graph read operation.
+        static void StreamConsumer(void* arg);
+        
+        
+        // -------- HELPERS ------------------------------------------------ //
+        
+        /// Allocates the configured number of edge buffers, each of the configured size, and for readers that parse in parallel the same number of raw chunk buffers.
+        /// @param [out] bufs Edge buffers.
+        /// @param [out] chunks Raw chunk buffers, each followed by kGraphReadChunkPadding bytes, or all `NULL` if the reader does not parse in parallel.
+        /// @return `true` if all buffers were allocated, `false` otherwise, in which case none remain allocated.
+        bool AllocateReadBuffers(std::vector<SEdge<TEdgeData>*>& bufs, std::vector<char*>& chunks) const;
+        
+        /// Estimates the memory needed to read the open graph file into the specified graph, records the estimate, and compares it to the memory available, as configured by the memory check option.
+        /// Must be invoked once the file header has been read and the edge data type of the graph has been set, but before anything is allocated.
+        /// @param [in] graph Graph object to be filled, which determines the groupings to be built.
+        /// @param [in,out] twoPass Specifies whether two-pass ingress is to be used, which may be changed from `false` to `true` if only two-pass ingress fits.
+        /// @return `true` if reading should proceed, `false` if the estimate exceeds the memory available.
+        bool CheckMemoryFootprint(const Graph& graph, bool& twoPass) const;
+        
+        /// Closes the files of all of the specified shards that are open.
+        /// @param [in,out] shards Shards of the graph.
+        void CloseShards(std::vector<SGraphReadShard<TEdgeData>>& shards) const;
+        
+        /// Identifies the shards of the graph named by the specified input, creating a reader object for each unless the graph is held in a single file, in which case this reader reads it.
+        /// The input names a single file unless it names a directory, which stands for the regular files within it whose names do not begin with '.' or '_', contains wildcard characters, which stands for the files that match it, or begins with '@', which stands for the files listed one per line in the file named by the rest of it.
+        /// No shard is opened.
+        /// @param [in] filename Name of the graph input.
+        /// @param [out] shards Shards of the graph.
+        /// @return Indicator of the result of the operation, which fails if the input names no files or if the graph is split across several files and this reader cannot read shards.
+        EGraphResult CreateShards(const char* const filename, std::vector<SGraphReadShard<TEdgeData>>& shards);
+        
+        /// Closes the files of all of the specified shards and destroys the reader objects created for them.
+        /// @param [in,out] shards Shards of the graph, emptied on return.
+        void DestroyShards(std::vector<SGraphReadShard<TEdgeData>>& shards) const;
+        
+        /// Determines the number of vertices for which storage is set aside during ingress.
+        /// Without remapping, this is the number of vertices given by the file.
+        /// With remapping, dense identifiers are bounded by the number of distinct vertices, which is at most two per edge and, in a consistent file, at most the number given by the file.
+        /// @return Number of vertices, all of which have identifiers less than this value once any remapping is applied.
+        TVertexCount GetNumVerticesForIngress(void) const;
+        
+        /// Opens the files of all of the specified shards and reads their headers, several at a time, and then sets the numEdgesInFile and numVerticesInFile variables to cover all of them.
+        /// The edge count is the sum of those of all shards, and the vertex count is the largest of those of all shards, since every shard identifies vertices in the same way.
+        /// @param [in,out] shards Shards of the graph, none of which are open.
+        /// @return Indicator of the result of the operation, in which case on failure no shard is left open.
+        EGraphResult OpenShards(std::vector<SGraphReadShard<TEdgeData>>& shards);
+        
+        /// Reads all remaining edges from the specified shards into the specified graph using the specified consumer, with one edge producer thread per shard up to the configured limit.
+        /// @param [in] shards Shards of the graph, each open and already positioned at its first edge.
+        /// @param [out] graph Graph object to be filled.
+        /// @param [in] bufs Edge buffers allocated by AllocateReadBuffers.
+        /// @param [in] chunks Raw chunk buffers allocated by AllocateReadBuffers.
+        /// @param [in] consumer Spindle task function that consumes edges from the buffers.
+        /// @param [in] writers Graph writer objects to which the consumer passes edges when streaming, or `NULL` otherwise.
+        /// @param [in] numWriters Number of graph writer objects.
+        /// @return Result of the read pass.
+        EGraphResult RunReadPass(const std::vector<SGraphReadShard<TEdgeData>>& shards, Graph& graph, const std::vector<SEdge<TEdgeData>*>& bufs, const std::vector<char*>& chunks, void (*consumer)(void*), IGraphWriter* const* writers, const size_t numWriters);
+        
+        
+    protected:
+        // -------- HELPERS ------------------------------------------------ //
+        
+        /// Opens the specified graph file for reading in binary mode, using asynchronous direct I/O if so configured.
+        /// A file compressed using gzip or zstd, as identified by its first bytes, is instead decompressed while it is read, in which case direct I/O is not used.
+        /// Intended for use by subclasses as part of their implementation of OpenAndInitializeGraphFileForRead.
+        /// @param [in] filename File name of the file to be opened for reading.
+        /// @param [in] textMode Indicates that the file should be opened in text mode instead of binary mode, which does not support direct I/O.
+        /// @return File handle for the opened file, positioned at the beginning of its contents, or `NULL` in the event of an error.
+        FILE* OpenGraphFileForRead(const char* const filename, const bool textMode = false) const;
+        
+        /// Specifies whether or not vertex identifiers read from the file are replaced by dense identifiers, in which case they need not be less than the number of vertices given by the file.
+        /// @return `true` if vertex identifiers are remapped, `false` otherwise.
+        inline bool RemapsVertexIDs(void) const
+        {
+            return remapVertexIDs;
+        }
+        
+        
+    private:
         // -------- ABSTRACT INSTANCE METHODS ------------------------------ //
         
         /// Opens and performs any initial file reading tasks required to prepare the graph file for reading of edges.
@@ -89,11 +314,83 @@ namespace GraphTool
         /// @return Number of edges read to the buffer.
         virtual TEdgeCount ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count) = 0;
         
+        
+        // -------- INSTANCE METHODS --------------------------------------- //
+        
+        /// Creates a new reader object, configured in the same way as this one, for reading one shard of a graph that is split across several files.
+        /// Each shard is read concurrently with the others, so each needs its own object.
+        /// Invoked by only a single thread, before this reader has opened any file.
+        /// Subclasses that can read shards should override this method; the default implementation returns `NULL`, indicating that graphs in this format cannot be split across several files.
+        /// @return Pointer to the new reader object, which the caller is responsible for destroying, or `NULL` if shards are not supported.
+        virtual GraphReader<TEdgeData>* CreateShardReader(void) const;
+        
+        /// Specifies whether the number of edges set during OpenAndInitializeGraphFileForRead is exact, rather than an upper bound used only to estimate the memory footprint.
+        /// Graphs read from files whose edge count is not exact are not checked against it once read, and such files cannot be streamed, because writers record the edge count before any edges are seen.
+        /// Invoked only after the file has been opened.
+        /// The default implementation returns `true`.
+        /// @return `true` if the number of edges is exact, `false` otherwise.
+        virtual bool IsEdgeCountExact(void) const;
+        
+        /// Attempts to map the remainder of the specified graph file into memory so that edges can be consumed directly from the mapping.
+        /// If successful, ReadEdgesInPlace is used instead of ReadEdgesToBuffer until UnmapEdgesForRead is invoked.
+        /// Invoked by only a single thread, so it is safe to modify any needed state without synchronization.
+        /// The default implementation does not map the file.
+        /// @param [in] graphfile File handle for the open graph file, already positioned at the first edge.
+        /// @return `true` if the file was mapped, `false` otherwise.
+        virtual bool MapEdgesForRead(FILE* const graphfile);
+        
+        /// Parses all edges whose records begin within the specified byte range of a raw chunk of file contents.
+        /// Only invoked if this reader parses in parallel, in which case it is invoked concurrently by multiple threads, each with a different range.
+        /// Subclasses that parse in parallel must override this method; the default implementation produces no edges.
+        /// @param [in] chunk Raw chunk of file contents, followed by at least kGraphReadChunkPadding zero bytes.
+        /// @param [in] chunkSize Number of bytes in the chunk.
+        /// @param [in] rangeStart Offset of the first byte of the range.
+        /// @param [in] rangeEnd Offset one past the last byte of the range.
+        /// @param [in,out] edges Container to which to append parsed edges, in file order.
+        virtual void ParseEdgesFromChunk(const char* const chunk, const size_t chunkSize, const size_t rangeStart, const size_t rangeEnd, std::vector<SEdge<TEdgeData>>& edges) const;
+        
+        /// Reads the next raw chunk of file contents into the specified buffer, ending on a record boundary.
+        /// Only invoked if this reader parses in parallel, in which case it is used instead of ReadEdgesToBuffer.
+        /// Invoked by only a single thread, so it is safe to modify any needed state without synchronization.
+        /// Subclasses that parse in parallel must override this method; the default implementation reads nothing.
+        /// @param [in] graphfile File handle for the open graph file.
+        /// @param [in] buf Buffer to which to read file contents.
+        /// @param [in] size Number of bytes that the buffer can hold.
+        /// @param [in] maxEdges Maximum number of edges that the chunk may contain once parsed.
+        /// @return Number of bytes read to the buffer.
+        virtual size_t ReadChunkToBuffer(FILE* const graphfile, char* const buf, const size_t size, const TEdgeCount maxEdges);
+        
+        /// Provides the next set of edges directly from the mapping created by MapEdgesForRead, without copying them.
+        /// Only invoked if the file was successfully mapped.
+        /// Invoked by only a single thread, so it is safe to modify any needed state without synchronization.
+        /// The default implementation provides no edges.
+        /// @param [out] edges Pointer to the first of the edges provided, which remain valid until the mapping is removed.
+        /// @param [in] count Maximum number of edges to provide.
+        /// @return Number of edges provided.
+        virtual TEdgeCount ReadEdgesInPlace(const SEdge<TEdgeData>*& edges, const size_t count);
+        
+        /// Specifies whether this reader reads its files using only the standard C library functions for sequential binary reads, opening them using OpenGraphFileForRead, so that they can be read using asynchronous direct I/O.
+        /// The default implementation returns `false`.
+        /// @return `true` if this reader supports direct I/O, `false` otherwise.
+        virtual bool SupportsDirectIO(void) const;
+        
+        /// Removes the mapping created by MapEdgesForRead, if any.
+        /// Invoked by only a single thread, so it is safe to modify any needed state without synchronization.
+        /// The default implementation does nothing.
+        virtual void UnmapEdgesForRead(void);
+        
+        /// Specifies whether this reader parses in parallel, in which case raw chunks of file contents are read and then parsed by all consumer threads.
+        /// The default implementation returns `false`.
+        /// @return `true` if this reader parses in parallel, `false` otherwise.
+        virtual bool UsesParallelParsing(void) const;
+        
 
     public:
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "IGraphReader.h" for documentation.
         
         virtual EGraphResult ReadGraphFromFile(const char* const filename, Graph& graph);
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        virtual EGraphResult StreamGraphToWriters(const char* const filename, IGraphWriter* const* writers, const char* const* outputFilenames, const size_t numWriters);
     };
 }
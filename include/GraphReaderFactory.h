@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
 
 namespace GraphTool
@@ -30,6 +31,11 @@ namespace GraphTool
     {
         GraphReaderTypeBinaryEdgeList,                                      ///< BinaryEdgeListReader
         GraphReaderTypeTextEdgeList,                                        ///< TextEdgeListReader
+        GraphReaderTypeCompressedAdjacencyList,                             ///< CompressedAdjacencyListReader
+        GraphReaderTypeSynthetic,                                           ///< SyntheticGraphReader
+        GraphReaderTypeSnapshot,                                            ///< GraphSnapshotReader
+        GraphReaderTypeMatrixMarket,                                        ///< MatrixMarketReader
+        GraphReaderTypeSNAP,                                                ///< SNAPEdgeListReader
     };
     
     /// Factory for creating IGraphReader objects of various types.
@@ -52,6 +58,17 @@ namespace GraphTool
         /// @return Pointer to the IGraphReader object, or `NULL` in the event of an error.
         static IGraphReader* CreateGraphReader(EGraphReaderType type, EEdgeDataType edgedatatype);
 
+        /// Expands the name of a graph input into the names of the files, called shards, that hold the graph.
+        /// A name that begins with '@' stands for the files listed in the file named by the rest of it, one per line, ignoring empty lines and lines that begin with '#'.
+        /// A directory stands for every regular file within it whose name does not begin with '.' or '_', which excludes the checksum and completion marker files that distributed processing frameworks write alongside their output.
+        /// A name that contains wildcard characters stands for every file that matches it, unless none do.
+        /// Directories and wildcards are recognized only on platforms that support them, and the files they stand for are ordered by name.
+        /// Any other name stands for just the file it names.
+        /// @param [in] filename Name of the graph input.
+        /// @param [out] filenames Names of the files that hold the graph.
+        /// @return `true` if the input stands for at least one file, `false` otherwise.
+        static bool ExpandInputFilename(const char* const filename, std::vector<std::string>& filenames);
+
         /// Returns a pointer to a mapping from strings to EGraphReaderType enumerators.
         /// @return Pointer to the enumerator mapping.
         static const std::map<std::string, int64_t>* GetGraphReaderStrings(void);
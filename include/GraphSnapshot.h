@@ -0,0 +1,114 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GraphSnapshot.h
+ *   Declaration of the snapshot file format, which holds a frozen graph in
+ *   its internal layout so that it can be mapped back into memory.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    class Graph;
+
+
+    /// Describes one frozen vertex index within a snapshot file.
+    /// Positions of the arrays are relative to the start of the section that holds them.
+    struct SGraphSnapshotIndexHeader
+    {
+        uint64_t numVertices;                                               ///< Number of top-level vertices, which is one less than the number of elements in the offset array.
+        uint64_t numEdges;                                                  ///< Number of edges, which is the number of elements in the neighbor and edge data arrays.
+        uint64_t numVerticesPresent;                                        ///< Number of top-level vertices having at least one edge.
+        uint64_t numVectors;                                                ///< Number of Vector-Sparse vectors required to represent the edges.
+        uint64_t sectionOffset;                                             ///< Position of the section within the file, which is a multiple of GraphSnapshot::kSectionAlignment.
+        uint64_t sectionSize;                                               ///< Size of the section, in bytes.
+        uint64_t neighborsOffset;                                           ///< Position of the neighbor array within the section. The offset array is always at the start of the section.
+        uint64_t edgeDataOffset;                                            ///< Position of the edge data array within the section, or 0 if the index holds no edge data.
+        uint32_t flags;                                                     ///< Bitwise combination of flags that describe the index.
+        uint32_t reserved;                                                  ///< Unused, must be 0.
+    };
+
+    /// Header at the start of every snapshot file.
+    struct SGraphSnapshotFileHeader
+    {
+        uint64_t magic;                                                     ///< Identifies the file format, must be equal to GraphSnapshot::kFileMagic.
+        uint32_t version;                                                   ///< Version of the layout, must be equal to GraphSnapshot::kFileVersion.
+        uint32_t edgeDataType;                                              ///< Type of edge data held with each edge, as an EEdgeDataType enumerator.
+        uint32_t flags;                                                     ///< Bitwise combination of flags that identify the groupings present in the file.
+        uint32_t sectionAlignment;                                          ///< Alignment of every section, must be equal to GraphSnapshot::kSectionAlignment.
+        SGraphSnapshotIndexHeader indexBySource;                            ///< Describes the source-grouped vertex index, if present.
+        SGraphSnapshotIndexHeader indexByDestination;                       ///< Describes the destination-grouped vertex index, if present.
+    };
+
+    /// Reads and writes snapshot files, which hold a frozen graph exactly as it is laid out in memory so that reading one back only requires mapping it.
+    /// After the header, each grouping present in the snapshot occupies its own section, which holds the frozen offset, neighbor, and edge data arrays of that grouping's vertex index in that order.
+    /// Sections begin at multiples of kSectionAlignment, which is a multiple of every common page size, so each can be mapped directly, and arrays within a section begin at multiples of kArrayAlignment.
+    /// All values are stored in the byte order of the machine that wrote the snapshot, so the magic value does not match on a machine of the opposite byte order.
+    /// Not intended to be instantiated.
+    class GraphSnapshot
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Identifies snapshot files; the ASCII characters "GTSNAPSH" in file order.
+        static const uint64_t kFileMagic = 0x485350414e535447ull;
+
+        /// Version of the layout described by this class.
+        /// Must be incremented whenever the layout of the header or of any section changes.
+        static const uint32_t kFileVersion = 1;
+
+        /// Flag indicating that the snapshot holds edges grouped by source.
+        static const uint32_t kFileFlagHasEdgesBySource = 0x00000001;
+
+        /// Flag indicating that the snapshot holds edges grouped by destination.
+        static const uint32_t kFileFlagHasEdgesByDestination = 0x00000002;
+
+        /// Flag indicating that the neighbor array of a vertex index holds identifiers of type TCompactVertexID rather than TVertexID.
+        static const uint32_t kIndexFlagNeighborsCompact = 0x00000001;
+
+        /// Flag indicating that the edges of each top-level vertex of a vertex index are sorted by the vertex at the other end.
+        static const uint32_t kIndexFlagSorted = 0x00000002;
+
+        /// Alignment, in bytes, of the start of each section within the file.
+        static const uint64_t kSectionAlignment = 65536;
+
+        /// Alignment, in bytes, of the start of each array within a section.
+        static const uint64_t kArrayAlignment = 64;
+
+
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor. Should never be invoked.
+        GraphSnapshot(void) = delete;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Maps a snapshot file into memory and makes the specified graph use it as its frozen representation, without copying any edges.
+        /// Only the groupings that the graph maintains are mapped, unless the snapshot holds none of them, in which case the grouping it does hold is mapped instead and the graph maintains that grouping afterwards.
+        /// Mapped pages are private to this process, so transformations can modify the graph without modifying the file.
+        /// Currently supported only on Linux.
+        /// @param [in] filename File name of the snapshot file.
+        /// @param [in,out] graph Graph to fill, whose edge data type must already match that of the snapshot. Not modified if an error occurs.
+        /// @return Result of the operation.
+        static EGraphResult ReadGraphFromFile(const char* const filename, Graph& graph);
+
+        /// Writes every grouping that the specified graph maintains to a snapshot file.
+        /// @param [in] filename File name of the snapshot file.
+        /// @param [in] graph Graph to write, which must be frozen.
+        /// @return Result of the operation.
+        static EGraphResult WriteGraphToFile(const char* const filename, const Graph& graph);
+    };
+}
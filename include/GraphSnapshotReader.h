@@ -0,0 +1,41 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GraphSnapshotReader.h
+ *   Declaration of a graph reader that maps snapshot files into memory.
+ *****************************************************************************/
+
+#pragma once
+
+#include "IGraphReader.h"
+#include "Types.h"
+
+#include <cstddef>
+
+
+namespace GraphTool
+{
+    class Graph;
+    class IGraphWriter;
+
+
+    /// Reader object class that maps snapshot files, as written using the `savesnapshot` command-line option, directly into memory.
+    /// Edges are not parsed or inserted, so the graph is ready as soon as the file is mapped, already frozen, and its pages are read from the file as they are first touched.
+    /// Snapshots hold no individual edges to pass along, so they cannot be streamed.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class GraphSnapshotReader : public IGraphReader
+    {
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphReader.h" for documentation.
+
+        virtual EGraphResult ReadGraphFromFile(const char* const filename, Graph& graph);
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        virtual EGraphResult StreamGraphToWriters(const char* const filename, IGraphWriter* const* writers, const char* const* outputFilenames, const size_t numWriters);
+    };
+}
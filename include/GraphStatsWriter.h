@@ -0,0 +1,54 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GraphStatsWriter.h
+ *   Declaration of a graph writer that summarizes the degree distribution
+ *   and structure of a graph in JSON format instead of writing its edges.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphWriter.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdio>
+
+
+namespace GraphTool
+{
+    /// Writer object class that produces a JSON file describing the graph instead of a file holding its edges, to help choose formats and partition counts without writing a full output.
+    /// The file holds the number of vertices and edges, the number of self-loops, duplicate edges, and isolated vertices, and, for both out-degree and in-degree, the maximum and mean degree, selected percentiles, the number of vertices with no edges, a histogram with power-of-two buckets, and the number of Vector-Sparse vectors needed to pack the edges.
+    /// Everything is computed in parallel directly from the vertex indices of the graph, without a traversal of its edges through write buffers.
+    /// Degrees in the direction whose grouping is not present are counted by visiting the neighbors of the grouping that is, so only the grouping requested for the file is built.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class GraphStatsWriter : public GraphWriter<TEdgeData>
+    {
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        GraphStatsWriter(void);
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphWriter.h" for documentation.
+
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
+        virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
+        virtual EGraphResult WriteSummaryToFile(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool WritesSummary(void) const;
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphWriter.h" for documentation.
+
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+    };
+}
@@ -58,7 +58,8 @@ namespace GraphTool
         // -------- ABSTRACT INSTANCE METHODS ------------------------------ //
         
         /// Performs the actual transformation operation.
-        /// If it can be parallelized, this method is invoked by multiple threads in a Spindle parallel region.
+        /// If it can be parallelized, this method is invoked by multiple threads in a Spindle parallel region created by NUMASpawner, which consists of one task per NUMA node.
+        /// Threads coordinate using global thread identifiers and global barriers, and each task should work on the range of vertices given by NUMASpawner::GetCurrentTaskUnitRange, which is stored on its own node.
         /// Otherwise it is invoked by only a single thread.
         virtual EGraphResult TransformGraph(Graph& graph) = 0;
         
@@ -68,5 +69,11 @@ namespace GraphTool
         // See "IGraphTransform.h" for documentation.
         
         virtual EGraphResult ApplyTransformation(Graph& graph);
+        virtual void BeginFusedTransformation(Graph& graph);
+        virtual bool CanFuseTransformation(void) const;
+        virtual void EndFusedTransformation(Graph& graph);
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
     };
 }
@@ -31,6 +31,23 @@ namespace GraphTool
         GraphTransformTypeHashEdgeData,                                     ///< HashEdgeDataTransform
         GraphTransformTypeNullIntEdgeData,                                  ///< NullEdgeDataTransform<uint64_t>
         GraphTransformTypeNullFloatEdgeData,                                ///< NullEdgeDataTransform<double>
+        GraphTransformTypeRandomIntEdgeData,                                ///< RandomEdgeDataTransform<uint64_t>
+        GraphTransformTypeRandomFloatEdgeData,                              ///< RandomEdgeDataTransform<double>
+        GraphTransformTypeSortEdges,                                        ///< SortEdgesTransform, keeping duplicate edges
+        GraphTransformTypeDedupEdgesFirst,                                  ///< SortEdgesTransform, merging duplicate edges and keeping the first edge data value
+        GraphTransformTypeDedupEdgesMin,                                    ///< SortEdgesTransform, merging duplicate edges and keeping the minimum edge data value
+        GraphTransformTypeDedupEdgesMax,                                    ///< SortEdgesTransform, merging duplicate edges and keeping the maximum edge data value
+        GraphTransformTypeDedupEdgesSum,                                    ///< SortEdgesTransform, merging duplicate edges and summing their edge data values
+        GraphTransformTypeReorderDegree,                                    ///< ReorderVerticesTransform, numbering vertices in descending order of degree
+        GraphTransformTypeReorderRCM,                                       ///< ReorderVerticesTransform, numbering vertices in reverse Cuthill-McKee order
+        GraphTransformTypeReorderGorder,                                    ///< ReorderVerticesTransform, numbering vertices using a Gorder-style window ordering
+        GraphTransformTypeCompactVertices,                                  ///< ReorderVerticesTransform, removing isolated vertices and numbering the rest densely
+        GraphTransformTypeSymmetrize,                                       ///< SymmetrizeTransform
+        GraphTransformTypeTranspose,                                        ///< TransposeTransform
+        GraphTransformTypeRemoveSelfLoops,                                  ///< FilterTransform, removing edges from each vertex to itself
+        GraphTransformTypeFilterDegree,                                     ///< FilterTransform, removing vertices whose total degree lies outside a range
+        GraphTransformTypeFilterVertexRange,                                ///< FilterTransform, removing vertices whose identifiers lie outside a range
+        GraphTransformTypeLargestComponent,                                 ///< FilterTransform, removing vertices outside the largest weakly connected component
     };
     
     /// Factory for creating IGraphTransform objects of various types.
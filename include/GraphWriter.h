@@ -13,18 +13,73 @@
 
 #pragma once
 
+#include "CompressingFile.h"
 #include "IGraphWriter.h"
 #include "Types.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <vector>
 
 
 namespace GraphTool
 {
     class Graph;
+    class VertexIndex;
 
     
+    /// Describes the part of a graph that is written to one of the files of a partitioned output.
+    /// Partitions are formed by top-level vertex of the grouping being written, so all edges of a top-level vertex belong to the same partition.
+    struct SGraphPartition
+    {
+        uint32_t numPartitions;                                             ///< Total number of partitions, or 1 if the output is not partitioned.
+        uint32_t index;                                                     ///< Zero-based index of this partition.
+        bool hashed;                                                        ///< Indicates that top-level vertices are assigned to partitions by hash rather than by range.
+        TVertexID vertexStart;                                              ///< First top-level vertex of this partition, if assigned by range.
+        TVertexID vertexEnd;                                                ///< One past the last top-level vertex of this partition, if assigned by range.
+        TEdgeCount numEdges;                                                ///< Number of edges in this partition.
+        
+        /// Determines the partition to which a top-level vertex is assigned by hash, using a multiplicative hash so that consecutive vertices are spread evenly.
+        /// @param [in] vertex Top-level vertex identifier.
+        /// @param [in] numPartitions Total number of partitions.
+        /// @return Zero-based index of the partition.
+        static inline uint32_t HashVertex(const TVertexID vertex, const uint32_t numPartitions)
+        {
+            return (uint32_t)(((vertex * 11400714819323198485ull) >> 32) % (uint64_t)numPartitions);
+        }
+        
+        /// Determines if a top-level vertex belongs to this partition.
+        /// @param [in] vertex Top-level vertex identifier.
+        /// @return `true` if the vertex and all of its edges belong to this partition, `false` otherwise.
+        inline bool ContainsVertex(const TVertexID vertex) const
+        {
+            if (1 == numPartitions)
+                return true;
+            
+            if (hashed)
+                return (index == HashVertex(vertex, numPartitions));
+            
+            return ((vertex >= vertexStart) && (vertex < vertexEnd));
+        }
+    };
+    
+    /// Supplies the edges of a graph being written in place of the graph itself, which then holds only the degree of each top-level vertex in the grouping being written.
+    /// Used when the edges do not fit in memory, such as during an external-memory conversion, in which they are read back from temporary files.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> struct SGraphEdgeSource
+    {
+        /// Fills a buffer with the next edges, in order of top-level vertex and, within each top-level vertex, in the order in which they should be written.
+        /// Invoked repeatedly by a single thread, which stops at the first invocation that places no edges.
+        /// @param [in] arg Value of the `arg` member.
+        /// @param [out] buf Buffer to fill.
+        /// @param [in] capacity Number of edges that the buffer can hold.
+        /// @return Number of edges placed into the buffer, which is 0 once every edge has been supplied or an error has occurred.
+        size_t (*fillFunc)(void* arg, SEdge<TEdgeData>* const buf, const size_t capacity);
+        
+        void* arg;                                                          ///< Argument passed to every invocation of the fill function.
+    };
+    
     /// Base class for all object types that are used to produce graph files of various formats.
     /// Objects in this hierarchy consume graph objects and produce files.
     /// Some common functionality is implemented directly in the base class.
@@ -34,10 +89,89 @@ namespace GraphTool
     private:
         // -------- CONSTANTS ---------------------------------------------- //
         
-        /// Specifies the size in bytes of each write buffer to use when reading data from the file.
-        /// Two buffers are created, 64MB each by default.
+        /// Specifies the default size in bytes of each write buffer to use when reading data from the file.
         static const size_t kGraphWriteBufferSize = (64ull * 1024ull * 1024ull);
         
+        /// Specifies the largest supported size in bytes of each write buffer.
+        static const size_t kGraphWriteBufferSizeMax = (4096ull * 1024ull * 1024ull);
+        
+        /// Specifies the default number of write buffers, which is the number of buffers the edge producer can fill before the consumers finish with the first.
+        static const uint32_t kGraphWriteBufferCount = 2;
+        
+        /// Specifies the number of consecutive edges that are formatted at a time, which bounds the size of each formatted output buffer.
+        /// When formatting in parallel, this is the number of edges in each thread's shard.
+        static const size_t kGraphWriteFormatShardSize = 65536;
+        
+        
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+        
+        /// Specifies that edges should be formatted in parallel by all consumer threads, if this writer supports it.
+        bool useParallelFormatting;
+        
+        /// Number of partitions into which the output should be split, each written to its own file.
+        uint32_t numPartitions;
+        
+        /// Specifies that top-level vertices should be assigned to partitions by hash instead of by edge-balanced vertex range.
+        bool useHashPartitioning;
+        
+        /// Specifies that the graph file should be written using asynchronous direct I/O, if this writer supports it.
+        bool useDirectIO;
+        
+        /// Number of requests to keep in flight when writing using asynchronous direct I/O.
+        uint32_t directIOQueueDepth;
+        
+        /// Format in which to compress the graph file, if at all.
+        CompressingFile::ECompressionFormat compressionFormat;
+        
+        /// Compression level, or 0 for the default level of the compression format.
+        int compressionLevel;
+        
+        /// Number of threads that compress the graph file, if it is compressed.
+        uint32_t numCompressionThreads;
+        
+        /// Number of write buffers requested for traversals of the graph that produce this writer's file.
+        uint32_t numWriteBuffers;
+        
+        /// Size in bytes of each write buffer requested for traversals of the graph that produce this writer's file.
+        size_t writeBufferSize;
+        
+        /// Number of consumer threads that format edges for this writer's file in parallel, or 0 to divide the available threads among all files being written.
+        uint32_t numConsumerThreads;
+        
+        /// Part of the graph that this writer object writes, which is the whole graph unless this object was created to write one partition of a partitioned output.
+        SGraphPartition partition;
+        
+        /// Edges that belong to this writer's partition, selected from each buffer when top-level vertices are assigned to partitions by hash.
+        std::vector<SEdge<TEdgeData>> partitionEdges;
+        
+        /// File handle for the secondary file, if this writer uses one, while a graph is being written.
+        FILE* secondaryGraphFile;
+        
+        /// File handle for the graph file while edges are being streamed to this writer, `NULL` otherwise.
+        FILE* streamedGraphFile;
+        
+        /// Graph object supplied when streaming began, or `NULL` if edges are not being streamed to this writer.
+        const Graph* streamedGraph;
+        
+        /// Number of vertices to record in the file while edges are being streamed, in place of the number in the graph.
+        TVertexCount streamedNumVertices;
+        
+        /// Number of edges to record in the file while edges are being streamed, in place of the number in the graph.
+        TEdgeCount streamedNumEdges;
+        
+        /// Formatted output of each thread when streamed edges are formatted in parallel, allocated on first use.
+        std::vector<char>* streamedFormattedShards;
+        
+        /// Index of the set of formatted shards that each thread uses next when streamed edges are formatted in parallel, allocated alongside the shards.
+        /// Every thread flips its own index after each round, so that no two threads update the same index.
+        uint32_t* streamedFormattedShardsIndices;
+        
+        /// Indicates the result of the streamed write operation so far.
+        EGraphResult streamedWriteResult;
+        
+        /// Indicates that the subclass has reported that the graph cannot be represented in its file format, reset whenever a file is opened.
+        bool formatErrorDetected;
+        
         
     public:
         // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
@@ -49,21 +183,192 @@ namespace GraphTool
         virtual ~GraphWriter(void);
         
         
+        // -------- CLASS METHODS ------------------------------------------ //
+        
+        /// Writes a graph to several files at once, one per writer, taking its edges from the specified source instead of from the graph.
+        /// The graph need only hold the degree of each top-level vertex in the grouping being written, such as one built using Graph::AdoptDegrees, and every writer must support edge sources; writing fails with a format error for any writer that does not.
+        /// Otherwise, files are written as by WriteGraphToFiles, including any partitioned outputs.
+        /// @param [in] writers Graph writer objects.
+        /// @param [in] filenames File name of the file to be written by each writer.
+        /// @param [in] numWriters Number of writers and file names.
+        /// @param [in] graph Graph that describes the degrees of the graph to be written.
+        /// @param [in] groupedByDestination Indicates that graph edges are grouped by destination instead of by source.
+        /// @param [in] edgeSource Source of the edges, which supplies them in the specified grouping.
+        /// @param [out] results Result of writing each file.
+        static void WriteGraphFromEdgeSource(GraphWriter<TEdgeData>* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, const SGraphEdgeSource<TEdgeData>& edgeSource, EGraphResult* results);
+        
+        
     private:
         // -------- CLASS METHODS ------------------------------------------ //
         
         /// Controls the consumption of edges from a buffer to a file, for use as a Spindle task function.
         /// Should be called by a single thread.
-        /// @param [in] arg Pointer to an instance of SGraphWriteSpec that defines the graph write operation.
+        /// @param [in] arg Pointer to an instance of SGraphWriteTarget that defines the file to write.
         static void EdgeConsumer(void* arg);
 
+        /// Controls the consumption of edges from a buffer to a file by formatting them in parallel, for use as a Spindle task function.
+        /// Each buffer is split into equally-sized shards of consecutive edges, each thread formats its own shard, and the formatted shards are written to the file in order by the first thread.
+        /// Output is therefore identical to that produced by a single consumer.
+        /// @param [in] arg Pointer to an instance of SGraphWriteTarget that defines the file to write.
+        static void EdgeFormatConsumer(void* arg);
+
+        /// Divides a graph into partitions by top-level vertex, either into edge-balanced ranges of consecutive vertices or by hash.
+        /// @param [in] vertexIndex Vertex index of the grouping being written.
+        /// @param [in] numPartitions Number of partitions.
+        /// @param [in] hashed Indicates that top-level vertices should be assigned to partitions by hash instead of by range.
+        /// @param [out] partitions Description of each partition.
+        static void DividePartitions(const VertexIndex& vertexIndex, const uint32_t numPartitions, const bool hashed, std::vector<SGraphPartition>& partitions);
+        
         /// Controls the production of edges from a graph object to a buffer, for use as a Spindle task function.
         /// Should be called by a single thread.
+        /// Each buffer is produced once and consumed for all of the files being written, and is refilled as soon as the consumers of every file have released it.
         /// @param [in] arg Pointer to an instance of SGraphWriteSpec that defines the graph write operation.
         static void EdgeProducer(void* arg);
+        
+        /// Writes a graph to several files, one per writer, using a single traversal of the graph for each pass.
+        /// Each file is written by its own group of consumer threads, all of which consume each buffer concurrently, so the time taken approaches that of the slowest writer.
+        /// All files share one ring of buffers, which uses the largest number and size of buffers requested by any of the writers.
+        /// A writer whose output is partitioned writes one file per partition, each by a separate object created using CreatePartitionWriter, and its result is that of the first partition that failed, if any.
+        /// @param [in] writers Graph writer objects, which may require different numbers of passes.
+        /// @param [in] filenames File name of the file to be written by each writer.
+        /// @param [in] numWriters Number of writers and file names.
+        /// @param [in] graph Graph to be written.
+        /// @param [in] groupedByDestination Indicates that graph edges should be grouped by destination instead of by source.
+        /// @param [in] edgeSource Source of the edges to write in place of the graph, or `NULL` to write the edges held by the graph.
+        /// @param [out] results Result of writing each file.
+        static void WriteGraphWithWriters(GraphWriter<TEdgeData>* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, const SGraphEdgeSource<TEdgeData>* edgeSource, EGraphResult* results);
+        
+        
+        // -------- HELPERS ------------------------------------------------ //
+        
+        /// Closes the secondary file, if one is open.
+        /// @return `true` if no I/O errors occurred while writing to or closing the secondary file, `false` otherwise.
+        bool CloseSecondaryGraphFile(void);
+        
+        /// Selects the edges in the specified buffer that belong to this writer's partition.
+        /// Buffers hold edges in order of top-level vertex, so the edges of a range are consecutive and are used in place, whereas those of a hash partition are copied.
+        /// Invoked by only a single thread per buffer.
+        /// @param [in] buf Buffer from which to read edge data.
+        /// @param [in] count Number of edges in the buffer.
+        /// @param [in] groupedByDestination Indicates that graph edges should be grouped by destination instead of by source.
+        /// @param [out] selectedCount Number of selected edges.
+        /// @return Pointer to the selected edges, valid until the next invocation.
+        const SEdge<TEdgeData>* SelectPartitionEdges(const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, size_t& selectedCount);
+        
+        /// Formats the edges in the specified buffer using all threads in the Spindle parallelized region and writes them to the file in order using the first thread.
+        /// Each round, every thread formats one shard of consecutive edges into one of two alternating sets of shards, which are then written by the first thread.
+        /// Parameters are the same as for WriteEdgesToFile, with the addition of the shards and the shard set index.
+        /// @param [in,out] formattedShards Four shards per thread, holding two sets of graph file shards and secondary file shards.
+        /// @param [in,out] formattedShardsIndex Index of the set of shards to use first, updated to the index of the set to use next.
+        /// @return `true` if no I/O errors were detected, which is meaningful only for the first thread.
+        bool ParallelFormatEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass, std::vector<char>* const formattedShards, uint32_t& formattedShardsIndex) const;
 
         
+    protected:
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+        
+        /// Appends one vertex offset to a buffer, in the representation used by a file format, for use with WriteVertexOffsetsToFile.
+        /// @param [in,out] output Buffer to which the offset should be appended.
+        /// @param [in] offset Offset to append, which is the number of edges that precede the vertex.
+        /// @param [in] offsetSize Number of bytes that each offset occupies, or 0 if offsets vary in size.
+        typedef void (*TAppendOffsetFunc)(std::vector<char>& output, const TEdgeCount offset, const size_t offsetSize);
+        
+        
+        // -------- HELPERS ------------------------------------------------ //
+        
+        /// Appends a single value to a buffer using the specified number of bytes, in the byte order of this machine.
+        /// Intended for use by subclasses that write binary files, both when formatting edges and as the append function given to WriteVertexOffsetsToFile.
+        /// @param [in,out] output Buffer to which the value should be appended.
+        /// @param [in] value Value to append.
+        /// @param [in] valueSize Number of bytes to use, either 4 or 8.
+        static inline void AppendValueToBuffer(std::vector<char>& output, const uint64_t value, const size_t valueSize)
+        {
+            if (sizeof(uint32_t) == valueSize)
+            {
+                const uint32_t compactValue = (uint32_t)value;
+                output.insert(output.end(), (const char*)&compactValue, (const char*)&compactValue + sizeof(compactValue));
+            }
+            else
+            {
+                output.insert(output.end(), (const char*)&value, (const char*)&value + sizeof(value));
+            }
+        }
+        
+        /// Retrieves the number of edges to record in the file, which is the number in the input file while edges are being streamed, the number in the partition if the output is partitioned, and the number in the graph otherwise.
+        /// Intended for use by subclasses when writing file headers.
+        /// @param [in] graph Graph to be written.
+        /// @return Number of edges to record in the file.
+        TEdgeCount GetNumEdgesToWrite(const Graph& graph) const;
+        
+        /// Retrieves the number of vertices to record in the file, which is the number in the input file while edges are being streamed and the number in the graph otherwise.
+        /// Partitions keep the identifiers of the whole graph, so every partition records the number of vertices in the whole graph.
+        /// Intended for use by subclasses when writing file headers.
+        /// @param [in] graph Graph to be written.
+        /// @return Number of vertices to record in the file.
+        TVertexCount GetNumVerticesToWrite(const Graph& graph) const;
+        
+        /// Retrieves the part of the graph that this writer object writes.
+        /// Intended for use by subclasses whose files describe vertices individually, which must omit the edges of any top-level vertex that does not belong to the partition.
+        /// @return Description of the partition, which is the whole graph unless the output is partitioned.
+        const SGraphPartition& GetPartition(void) const;
+        
+        /// Retrieves the secondary file, which is open only while a graph is being written by a writer that uses one.
+        /// Intended for use by subclasses that produce secondary output in their own implementation of WriteEdgesToFile rather than using WriteFormattedEdgesToFile.
+        /// @return File handle for the secondary file, or `NULL` if it is not open.
+        FILE* GetSecondaryGraphFile(void) const;
+        
+        /// Specifies whether the graph file is compressed as it is written.
+        /// Intended for use by subclasses that write parts of the graph file through a secondary file, which cannot seek within a compressed file.
+        /// @return `true` if the graph file is compressed, `false` otherwise.
+        bool IsGraphFileCompressed(void) const;
+        
+        /// Opens a compressed stream for a later section of the graph file, whose contents are appended to the graph file once both have been closed.
+        /// Intended for use by subclasses that write parts of the graph file through a secondary file, as their implementation of OpenSecondaryGraphFileForWrite when the graph file is compressed.
+        /// @param [in] filename File name of the graph file.
+        /// @return File handle for the opened stream, or `NULL` in the event of an error.
+        FILE* OpenCompressedGraphFileSectionForWrite(const char* const filename) const;
+        
+        /// Creates or truncates the specified graph file and opens it for writing, using asynchronous direct I/O and compression if so configured.
+        /// Intended for use by subclasses as part of their implementation of OpenAndInitializeGraphFileForWrite.
+        /// Compressed files are always written in binary mode, and direct I/O is used only by subclasses that support it, which write in binary mode.
+        /// @param [in] filename File name of the file to be opened for writing.
+        /// @param [in] textMode Indicates that the file should be opened in text mode rather than binary mode, if it is not compressed.
+        /// @return File handle for the opened file, or `NULL` in the event of an error.
+        FILE* OpenGraphFileForWrite(const char* const filename, const bool textMode = false) const;
+        
+        /// Records that the graph being written cannot be represented in this writer's file format, such as when a value does not fit in the number of bits the format provides for it.
+        /// Writing the file then fails with a format error instead of producing a file with corrupted values.
+        /// Intended for use by subclasses from OpenAndInitializeGraphFileForWrite and WriteEdgesToFile, which cannot otherwise report errors other than I/O errors.
+        void ReportFormatError(void);
+        
+        /// Formats edge data from the specified buffer using FormatEdgesToBuffer and writes the result into the specified file, and any secondary output into the secondary file.
+        /// Intended for use by subclasses that support parallel formatting, as their implementation of WriteEdgesToFile.
+        /// Parameters are the same as for WriteEdgesToFile.
+        void WriteFormattedEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const;
+        
+        /// Writes the offset at which the edges of each vertex begin, in order of vertex, using threads on every NUMA node.
+        /// Each round, every thread takes a shard of consecutive vertices and sums their degrees, after which each thread knows the offset at which its shard begins.
+        /// Threads then format their own shards, and the first thread writes all of the shards in order.
+        /// Only the edges of top-level vertices that belong to this writer's partition are counted, so offsets begin at zero in every partition.
+        /// Intended for use by subclasses that write adjacency list formats, as part of their implementation of OpenAndInitializeGraphFileForWrite.
+        /// @param [in] file File handle, positioned where the offsets should be written.
+        /// @param [in] vertexIndex Vertex index whose degrees determine the offsets.
+        /// @param [in] numVertices Number of vertices to list, any beyond those in the vertex index having no edges.
+        /// @param [in] appendOffset Function that appends a single offset to a buffer.
+        /// @param [in] offsetSize Passed to the append function, and used to size the buffers if not 0.
+        /// @param [in] appendsEndOffset Indicates that the offset following the last vertex, which is the number of edges counted, should also be written.
+        /// @return `true` if the offsets were written successfully, `false` otherwise.
+        bool WriteVertexOffsetsToFile(FILE* const file, const VertexIndex& vertexIndex, const TVertexCount numVertices, const TAppendOffsetFunc appendOffset, const size_t offsetSize, const bool appendsEndOffset) const;
+        
+        
+    private:
         // -------- ABSTRACT INSTANCE METHODS ------------------------------ //
+        
+        /// Creates a new writer object of the same type and with the same options as this one, which is used to write one partition of a partitioned output.
+        /// Each partition is written concurrently with the others, so each needs its own object.
+        /// Invoked by only a single thread.
+        /// @return Pointer to the new writer object, which the caller is responsible for destroying.
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const = 0;
 
         /// Retrieves the number of passes over the graph required to generate the output file.
         /// Subclass implementation is optional; default implementation returns 1.
@@ -91,10 +396,90 @@ namespace GraphTool
         virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) = 0;
         
         
+        // -------- INSTANCE METHODS --------------------------------------- //
+        
+        /// Formats edge data from the specified buffer exactly as WriteEdgesToFile would write them, appending the result to the specified output buffers.
+        /// Only invoked if this writer supports parallel formatting, in which case it is invoked concurrently by multiple threads, each with a different set of edges.
+        /// Subclasses that support parallel formatting must override this method; the default implementation produces no output.
+        /// @param [in,out] output Buffer to which to append the formatted edges, destined for the graph file.
+        /// @param [in,out] secondaryOutput Buffer to which to append formatted edges destined for the secondary file, which must be left empty if this writer does not use one.
+        /// @param [in] graph Graph to be written.
+        /// @param [in] buf Buffer from which to read edge data.
+        /// @param [in] count Number of edges in the buffer.
+        /// @param [in] groupedByDestination Indicates that graph edges should be grouped by destination instead of by source.
+        /// @param [in] currentPass Zero-based index of the current writing pass.
+        virtual void FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const;
+        
+        /// Opens a secondary file, to which secondary output from FormatEdgesToBuffer is written in the same order as output is written to the graph file.
+        /// This allows formats that place different information about each edge into separate sections of the same file, or into separate files, to be written in a single pass over the edges.
+        /// Only invoked if this writer uses a secondary file, immediately after the graph file is opened.
+        /// Invoked by only a single thread, so it is safe to modify any needed state without synchronization.
+        /// The default implementation does not open a file.
+        /// @param [in] filename File name of the graph file.
+        /// @param [in] graph Graph to be written.
+        /// @param [in] groupedByDestination Indicates that graph edges should be grouped by destination instead of by source.
+        /// @return File handle for the opened file, positioned where secondary output should begin, or `NULL` in the event of an error.
+        virtual FILE* OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        
+        /// Specifies whether this writer needs edges grouped both by source and by destination, as described in "IGraphWriter.h".
+        /// Subclasses that require both groupings read the grouping opposite the one being written directly from the graph.
+        /// The default implementation returns `false`.
+        /// @return `true` if this writer requires both groupings, `false` otherwise.
+        virtual bool RequiresBothEdgeGroupings(void) const;
+        
+        /// Specifies whether this writer writes its graph file using only the standard C library functions for sequential binary writes, opening it using OpenGraphFileForWrite, so that it can be written using asynchronous direct I/O.
+        /// The default implementation returns `false`.
+        /// @return `true` if this writer supports direct I/O, `false` otherwise.
+        virtual bool SupportsDirectIO(void) const;
+        
+        /// Specifies whether this writer can write a graph whose edges are supplied by an edge source, as described in "IGraphWriter.h".
+        /// Subclasses that support edge sources may obtain from the graph only the numbers of vertices and edges and the degree of each top-level vertex.
+        /// The default implementation returns `false`.
+        /// @return `true` if this writer supports edge sources, `false` otherwise.
+        virtual bool SupportsEdgeSource(void) const;
+        
+        /// Specifies whether this writer is capable of formatting edges in parallel, in which case all consumer threads format edges using FormatEdgesToBuffer.
+        /// The default implementation returns `false`.
+        /// @return `true` if this writer supports parallel formatting, `false` otherwise.
+        virtual bool SupportsParallelFormatting(void) const;
+        
+        /// Specifies whether this writer can receive edges by streaming, as described in "IGraphWriter.h".
+        /// Subclasses that support streaming must write file headers using GetNumVerticesToWrite and GetNumEdgesToWrite, must not depend on edge order, and must require only a single pass.
+        /// The default implementation returns `false`.
+        /// @return `true` if this writer supports streaming, `false` otherwise.
+        virtual bool SupportsStreaming(void) const;
+        
+        /// Specifies whether this writer produces secondary output, which requires a secondary file and either parallel formatting support or an implementation of WriteEdgesToFile that writes to the file obtained using GetSecondaryGraphFile.
+        /// The default implementation returns `false`.
+        /// @return `true` if this writer uses a secondary file, `false` otherwise.
+        virtual bool UsesSecondaryGraphFile(void) const;
+        
+        /// Writes a summary of the graph computed directly from its vertex indices, instead of writing its edges.
+        /// Only invoked if this writer writes summaries, in which case it is invoked once per file in place of taking part in the traversal of the graph shared by the other writers.
+        /// The default implementation writes nothing.
+        /// @param [in] filename File name of the file to be written.
+        /// @param [in] graph Graph to be summarized.
+        /// @param [in] groupedByDestination Indicates the grouping requested for the file, which is present in the graph.
+        /// @return Result of the write operation.
+        virtual EGraphResult WriteSummaryToFile(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        
+        /// Specifies whether this writer writes a summary of the graph using WriteSummaryToFile instead of writing its edges, in which case none of the methods that open files or write edges are invoked.
+        /// The default implementation returns `false`.
+        /// @return `true` if this writer writes summaries, `false` otherwise.
+        virtual bool WritesSummary(void) const;
+        
+        
     public:
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "IGraphWriter.h" for documentation.
         
+        virtual EGraphResult BeginStreamedWrite(const char* const filename, const Graph& graph, const TVertexCount numVertices, const TEdgeCount numEdges);
+        virtual EGraphResult EndStreamedWrite(void);
+        virtual EEdgeDataType GetEdgeDataType(void) const;
+        virtual uint32_t GetNumPartitions(void) const;
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        virtual void WriteStreamedEdges(const void* const buf, const size_t count);
         virtual EGraphResult WriteGraphToFile(const char* const filename, const Graph& graph, const bool groupedByDestination = false);
+        virtual void WriteGraphToFiles(IGraphWriter* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, EGraphResult* results);
     };
 }
@@ -14,6 +14,7 @@
 
 #include "Types.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <string>
@@ -22,6 +23,7 @@
 namespace GraphTool
 {
     class IGraphWriter;
+    struct SExternalGraphOutput;
 
 
     /// Enumerates known graph writer object types.
@@ -32,7 +34,13 @@ namespace GraphTool
         GraphWriterTypeTextAdjacencyList,                                   ///< TextAdjacencyListWriter
         GraphWriterTypeTextEdgeList,                                        ///< TextEdgeListWriter
         GraphWriterMatrix32,                                                ///< Matrix32Writer
+        GraphWriterMatrix64,                                                ///< Matrix64Writer
         GraphWriterTypeXStream,                                             ///< XStreamWriter
+        GraphWriterTypeCompressedAdjacencyList,                             ///< CompressedAdjacencyListWriter
+        GraphWriterTypeBinaryAdjacencyList,                                 ///< BinaryAdjacencyListWriter
+        GraphWriterTypeGAP,                                                 ///< GAPWriter
+        GraphWriterTypeVectorSparse,                                        ///< VectorSparseWriter
+        GraphWriterTypeStats,                                               ///< GraphStatsWriter
     };
 
     /// Factory for creating IGraphWriter objects of various types.
@@ -49,6 +57,13 @@ namespace GraphTool
     public:
         // -------- CLASS METHODS ------------------------------------------ //
 
+        /// Creates and returns a pointer to an IGraphWriter object that converts a graph too large to fit in memory, by receiving its edges by streaming and writing them to several files by way of temporary files.
+        /// @param [in,out] outputs Files to be written, whose results are filled in once the conversion ends. All of the writers must write the same type of edge data.
+        /// @param [in] numOutputs Number of files to be written.
+        /// @param [in] memoryBudget Number of bytes of memory the conversion may use.
+        /// @return Pointer to the IGraphWriter object, or `NULL` in the event of an error.
+        static IGraphWriter* CreateExternalGraphWriter(SExternalGraphOutput* const outputs, const size_t numOutputs, const uint64_t memoryBudget);
+
         /// Creates and returns a pointer to an IGraphWriter object of the specified type.
         /// @param [in] type Type of IGraphWriter object to create.
         /// @param [in] edgedatatype Type of data that the IGraphWriter object should write for each edge.
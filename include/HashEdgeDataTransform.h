@@ -25,13 +25,31 @@ namespace GraphTool
     class Graph;
 
     
-    /// Transformation class for applying null values to edge data elements.
-    class HashEdgeDataTransform : public EdgeDataTransform<uint64_t>
+    /// Transformation class for applying hashed values to edge data elements.
+    /// Batches of edges are processed four at a time using AVX2 instructions.
+    class HashEdgeDataTransform : public EdgeDataTransform<uint64_t, HashEdgeDataTransform>
     {   
     public:
-        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // -------- CLASS METHODS ------------------------------------------ //
         // See "EdgeDataTransform.h" for documentation.
         
-        virtual uint64_t GenerateEdgeData(const TVertexID sourceVertex, const TVertexID destinationVertex, const uint64_t oldEdgeData);
+        static void GenerateEdgeDataBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
+        static void GenerateEdgeDataBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
+        
+        /// Generates an edge data value for a single edge.
+        /// Applies a variation of Knuth's multiplicative hash algorithm to the source and destination vertex.
+        /// @param [in] sourceVertex Source vertex identifier.
+        /// @param [in] destinationVertex Destination vertex identifier.
+        /// @param [in] oldEdgeData Existing edge data value, which is ignored.
+        /// @return Generated edge data value, between 1 and 32768.
+        static inline uint64_t GenerateEdgeData(const TVertexID sourceVertex, const TVertexID destinationVertex, const uint64_t oldEdgeData)
+        {
+            const uint64_t weightBase = (destinationVertex << 2ull) + destinationVertex + sourceVertex;
+            const uint64_t weightHashed = weightBase * 2654435761ull;
+            const uint64_t weightAdjusted = (weightHashed >> 25ull) & 32767ull;
+            const uint64_t weightFinal = weightAdjusted + 1ull;
+            
+            return weightFinal;
+        }
     };
 }
@@ -14,16 +14,29 @@
 
 #include "Types.h"
 
+#include <cstddef>
+
 
 namespace GraphTool
 {
     class Graph;
+    class IGraphWriter;
 
     
     /// Interface for objects that read graphs from files.
     class IGraphReader
     {   
     public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Destructor.
+        /// Virtual so that objects can be destroyed through this interface.
+        virtual ~IGraphReader(void)
+        {
+            // Nothing to do here.
+        }
+
+
         // -------- ABSTRACT INSTANCE METHODS ------------------------------ //
         
         /// Reads a graph from the specified file.
@@ -31,5 +44,22 @@ namespace GraphTool
         /// @param [out] graph Graph object to be filled. Not modified if an error occurs during reading.
         /// @return Result of the read operation.
         virtual EGraphResult ReadGraphFromFile(const char* const filename, Graph& graph) = 0;
+        
+        /// Submits an option that fine-tunes the behavior of graph reading functionality.
+        /// Must be invoked before reading a graph for the option to take effect.
+        /// @param [in] optionName Name of the option.
+        /// @param [in] optionValue Value of the option, which is empty if none was specified.
+        /// @return `true` if the option and its value are recognized, `false` otherwise.
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue) = 0;
+        
+        /// Reads edges from the specified file and passes them directly to the specified writers as they are read, without building a graph.
+        /// Edges are written in the order in which they appear in the file, and file headers record the vertex and edge counts given by the input file.
+        /// Every writer must support streaming and hold the same type of edge data as this reader.
+        /// @param [in] filename File name of the file to be read.
+        /// @param [in] writers Graph writer objects to which to pass edges.
+        /// @param [in] outputFilenames File name of the file to be written by each writer.
+        /// @param [in] numWriters Number of writers and output file names.
+        /// @return Result of the streaming operation, including any errors encountered by the writers.
+        virtual EGraphResult StreamGraphToWriters(const char* const filename, IGraphWriter* const* writers, const char* const* outputFilenames, const size_t numWriters) = 0;
     };
 }
@@ -14,6 +14,8 @@
 
 #include "Types.h"
 
+#include <cstddef>
+
 
 namespace GraphTool
 {
@@ -24,6 +26,16 @@ namespace GraphTool
     class IGraphTransform
     {
     public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Destructor.
+        /// Virtual so that objects can be destroyed through this interface.
+        virtual ~IGraphTransform(void)
+        {
+            // Nothing to do here.
+        }
+
+
         // -------- ABSTRACT INSTANCE METHODS ------------------------------ //
 
         /// Applies a transformation to the specified graph object.
@@ -31,5 +43,41 @@ namespace GraphTool
         /// @param [in] graph Graph object to be transformed.
         /// @return Result of the transformation operation.
         virtual EGraphResult ApplyTransformation(Graph& graph) = 0;
+        
+        /// Prepares the graph for a fusible transformation, such as by allocating storage the transformation needs.
+        /// Invoked by a single thread before any edges are transformed.
+        /// @param [in] graph Graph object to be transformed.
+        virtual void BeginFusedTransformation(Graph& graph) = 0;
+        
+        /// Specifies if the transformation operates independently on each edge, modifying its edge data or deciding whether to keep it, such that it can be fused with other such transformations into a single traversal of the graph.
+        /// Fusible transformations implement BeginFusedTransformation, EndFusedTransformation, and TransformEdgeBatch, which are otherwise never invoked.
+        /// @return `true` if the transformation can be fused, `false` otherwise.
+        virtual bool CanFuseTransformation(void) const = 0;
+        
+        /// Records the effects of a fusible transformation on the graph, such as the type of edge data it produces.
+        /// Invoked by a single thread after all edges are transformed.
+        /// @param [in] graph Graph object that was transformed.
+        virtual void EndFusedTransformation(Graph& graph) = 0;
+        
+        /// Submits an option that fine-tunes the behavior of the transformation.
+        /// Must be invoked before applying the transformation for the option to take effect.
+        /// @param [in] optionName Name of the option.
+        /// @param [in] optionValue Value of the option, which is empty if none was specified.
+        /// @return `true` if the option and its value are recognized, `false` otherwise.
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue) = 0;
+        
+        /// Applies a fusible transformation to a batch of edges that share a top-level vertex, such as all of the edges of one vertex in a frozen vertex index.
+        /// Edges that are kept are moved to the front of the batch, in their existing order, and the rest are discarded.
+        /// @param [in] topLevelVertex Vertex identifier shared by all edges in the batch.
+        /// @param [in] topLevelIsDestination Indicates that the top-level vertex is the destination of each edge rather than its source.
+        /// @param [in,out] neighbors Identifiers of the vertices at the other end of each edge.
+        /// @param [in,out] edgeData Edge data of each edge, replaced by the transformed values, or `NULL` if the graph holds no edge data.
+        /// @param [in] count Number of edges in the batch.
+        /// @return Number of edges kept.
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count) = 0;
+        
+        /// Applies a fusible transformation to a batch of edges that share a top-level vertex, whose neighbors are stored using full-width identifiers.
+        /// See the other overload for parameter documentation.
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count) = 0;
     };
 }
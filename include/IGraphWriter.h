@@ -14,6 +14,9 @@
 
 #include "Types.h"
 
+#include <cstddef>
+#include <cstdint>
+
 
 namespace GraphTool
 {
@@ -24,13 +27,84 @@ namespace GraphTool
     class IGraphWriter
     {
     public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Destructor.
+        /// Virtual so that objects can be destroyed through this interface.
+        virtual ~IGraphWriter(void)
+        {
+            // Nothing to do here.
+        }
+
+
         // -------- ABSTRACT INSTANCE METHODS ------------------------------ //
 
+        /// Opens the specified file for streaming, in which edges are passed directly to this writer as they are read instead of being taken from a graph.
+        /// Only valid if this writer supports streaming.
+        /// @param [in] filename File name of the file to be written.
+        /// @param [in] graph Graph object that holds no edges but specifies the type of edge data being streamed.
+        /// @param [in] numVertices Number of vertices to record in the file, as given by the input file.
+        /// @param [in] numEdges Number of edges to record in the file, as given by the input file.
+        /// @return Result of the open operation.
+        virtual EGraphResult BeginStreamedWrite(const char* const filename, const Graph& graph, const TVertexCount numVertices, const TEdgeCount numEdges) = 0;
+        
+        /// Finishes streaming and closes the file opened by BeginStreamedWrite.
+        /// @return Result of the entire streamed write operation.
+        virtual EGraphResult EndStreamedWrite(void) = 0;
+        
+        /// Retrieves the type of edge data that this writer writes for each edge.
+        /// @return Edge data type.
+        virtual EEdgeDataType GetEdgeDataType(void) const = 0;
+        
+        /// Retrieves the number of partitions into which this writer splits its output.
+        /// A partitioned output is written to one file per partition, named by appending a period and the zero-based index of the partition to the file name, and cannot be streamed.
+        /// @return Number of partitions, or 1 if the output is not partitioned.
+        virtual uint32_t GetNumPartitions(void) const = 0;
+        
+        /// Specifies whether this writer needs edges grouped both by source and by destination, regardless of the grouping with which it is asked to write.
+        /// Both groupings must be built before writing a graph with such a writer.
+        /// @return `true` if this writer requires both groupings, `false` otherwise.
+        virtual bool RequiresBothEdgeGroupings(void) const = 0;
+        
+        /// Specifies whether this writer can write a graph whose edges are supplied by an edge source instead of being held by the graph, as during an external-memory conversion.
+        /// Such a graph holds only the degree of each top-level vertex in the grouping being written, so this requires that the writer need nothing else from the graph and write its file in a single pass.
+        /// @return `true` if this writer supports edge sources, `false` otherwise.
+        virtual bool SupportsEdgeSource(void) const = 0;
+
+        /// Specifies whether this writer can receive edges by streaming, which requires that edges be written in the order received and in a single pass.
+        /// @return `true` if this writer supports streaming, `false` otherwise.
+        virtual bool SupportsStreaming(void) const = 0;
+        
+        /// Writes a buffer of streamed edges to the file opened by BeginStreamedWrite, in the order received.
+        /// Must be invoked by all threads in a Spindle parallelized region, each with the same buffer.
+        /// Any I/O errors are reported by EndStreamedWrite.
+        /// @param [in] buf Buffer from which to read edges, of the type specified when streaming began.
+        /// @param [in] count Number of edges in the buffer.
+        virtual void WriteStreamedEdges(const void* const buf, const size_t count) = 0;
+        
         /// Writes a graph to the specified file.
         /// @param [in] filename File name of the file to be written.
         /// @param [in] graph Graph object to be written to the file.
         /// @param [in] groupedByDestination Indicates that graph edges should be grouped by destination instead of by source.
         /// @return Result of the write operation.
         virtual EGraphResult WriteGraphToFile(const char* const filename, const Graph& graph, const bool groupedByDestination = false) = 0;
+        
+        /// Writes a graph to several files at once, one per writer, sharing a single traversal of the graph among all of the writers.
+        /// Each buffer of edges is produced once and then handed to all of the writers, which consume it concurrently.
+        /// Only writers that write the same type of edge data as this writer can share a traversal, and writing fails for any others.
+        /// @param [in] writers Graph writer objects to use, which may or may not include this writer.
+        /// @param [in] filenames File name of the file to be written by each writer.
+        /// @param [in] numWriters Number of writers and file names.
+        /// @param [in] graph Graph object to be written to the files.
+        /// @param [in] groupedByDestination Indicates that graph edges should be grouped by destination instead of by source.
+        /// @param [out] results Result of the write operation for each file.
+        virtual void WriteGraphToFiles(IGraphWriter* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, EGraphResult* results) = 0;
+        
+        /// Submits an option that fine-tunes the behavior of graph writing functionality.
+        /// Must be invoked before writing a graph for the option to take effect.
+        /// @param [in] optionName Name of the option.
+        /// @param [in] optionValue Value of the option, which is empty if none was specified.
+        /// @return `true` if the option and its value are recognized, `false` otherwise.
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue) = 0;
     };
 }
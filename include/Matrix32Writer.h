@@ -17,25 +17,49 @@
 #include "Types.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <vector>
 
 
 namespace GraphTool
 {
     /// Writer object class for graphs represented in binary matrix format with 32-bit integers for all values.
+    /// Graphs whose vertex count, edge count, or edge weights do not fit in 32-bit unsigned integers cannot be written in this format and are rejected with a format error; Matrix64Writer handles such graphs.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
     template <typename TEdgeData> class Matrix32Writer : public GraphWriter<TEdgeData>
     {
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Number of elements past the end of the packed edges that PackEdges may overwrite, because each vector store writes more elements than it produces.
+        static const size_t kPackSlack = 8;
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Staging buffer holding the packed form of the edges in the buffer being written, so that each buffer is written using a single write.
+        std::vector<uint32_t> packedEdges;
+
+
         // -------- CLASS METHODS ------------------------------------------ //
 
-        // Formats the edge weight from the specified edge as a 32-bit unsigned integer.
-        static uint32_t EdgeWeightFromEdge(const SEdge<TEdgeData>& edge);
+        /// Packs the specified edges into three 32-bit unsigned integers each, namely the 1-based source and destination vertex identifiers followed by the edge weight.
+        /// Values are narrowed several edges at a time using AVX2, and any value that does not fit in 32 bits is detected rather than truncated.
+        /// @param [out] packed Buffer to receive the packed edges, which must have room for 3 * count + kPackSlack elements.
+        /// @param [in] buf Buffer from which to read edge data.
+        /// @param [in] count Number of edges in the buffer.
+        /// @return `true` if every value fits in 32 bits, `false` otherwise, in which case the contents of the packed buffer are unspecified.
+        static bool PackEdges(uint32_t* const packed, const SEdge<TEdgeData>* buf, const size_t count);
 
         
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "GraphWriter.h" for documentation.
 
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
         virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool SupportsDirectIO(void) const;
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsStreaming(void) const;
         virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
     };
 }
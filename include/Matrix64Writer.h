@@ -0,0 +1,58 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file Matrix64Writer.h
+ *   Declaration of a graph writer for binary matrix files.
+ *   Edges and vertices are represented using 64-bit integers.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphWriter.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Writer object class for graphs represented in binary matrix format with 64-bit integers for all values.
+    /// Laid out identically to the format written by Matrix32Writer, but able to hold graphs whose vertex count, edge count, or edge weights do not fit in 32 bits.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class Matrix64Writer : public GraphWriter<TEdgeData>
+    {
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Staging buffer holding the packed form of the edges in the buffer being written, so that each buffer is written using a single write.
+        std::vector<uint64_t> packedEdges;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Packs the specified edges into three 64-bit unsigned integers each, namely the 1-based source and destination vertex identifiers followed by the edge weight.
+        /// @param [out] packed Buffer to receive the packed edges, which must have room for 3 * count elements.
+        /// @param [in] buf Buffer from which to read edge data.
+        /// @param [in] count Number of edges in the buffer.
+        /// @return `true` if every edge weight fits in a 64-bit unsigned integer, `false` otherwise, in which case the contents of the packed buffer are unspecified.
+        static bool PackEdges(uint64_t* const packed, const SEdge<TEdgeData>* buf, const size_t count);
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphWriter.h" for documentation.
+
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
+        virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool SupportsDirectIO(void) const;
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsStreaming(void) const;
+        virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
+    };
+}
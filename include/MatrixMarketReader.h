@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file MatrixMarketReader.h
+ *   Declaration of a graph reader for Matrix Market coordinate files.
+ *****************************************************************************/
+
+#pragma once
+
+#include "TextEdgeListReader.h"
+#include "Types.h"
+
+#include <cstdio>
+
+
+namespace GraphTool
+{
+    /// Reader object class for graphs represented as sparse matrices in Matrix Market coordinate format, commonly known as ".mtx".
+    /// Files begin with a banner line of the form "%%MatrixMarket matrix coordinate <field> <symmetry>", followed by any number of comment lines beginning with '%', followed by a line holding the number of rows, the number of columns, and the number of entries.
+    /// Each remaining line holds the 1-based row and column of an entry, which become the source and destination vertices of an edge, followed by its value unless the field is "pattern".
+    /// Supported fields are "real", "integer", and "pattern", and supported symmetries are "general" and "symmetric".
+    /// Symmetric files store each off-diagonal entry only once, so each such entry produces edges in both directions, and the number of edges is not known exactly until the file has been read.
+    /// Parsing is inherited from the text edge list reader, so the file is parsed in parallel by default.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class MatrixMarketReader : public TextEdgeListReader<TEdgeData>
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Specifies that the file holds a symmetric matrix, determined when the file header is read.
+        bool isSymmetric;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        MatrixMarketReader(void);
+
+
+    protected:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "TextEdgeListReader.h" for documentation.
+
+        virtual unsigned int MaxEdgesPerLine(void) const;
+        virtual unsigned int ParseEdgesFromLine(const char* const line, const char* const lineEnd, SEdge<TEdgeData>* const edges) const;
+        virtual bool ReadGraphFileHeader(FILE* const graphfile);
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphReader.h" for documentation.
+
+        virtual GraphReader<TEdgeData>* CreateShardReader(void) const;
+        virtual bool IsEdgeCountExact(void) const;
+    };
+}
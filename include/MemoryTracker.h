@@ -0,0 +1,104 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file MemoryTracker.h
+ *   Accounting of the large allocations that hold graphs and I/O buffers.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    /// Keeps track of the memory held by the large allocations that dominate the footprint of a conversion, namely the storage of graph edges and the buffers that carry edges to and from files.
+    /// Each allocation is recorded along with its size and category when it is made and removed when it is released, so the amount in use, and its peak, are known at all times.
+    /// Also records the estimate of the memory needed to read a graph, made before reading begins, so that it can be compared to what was actually used.
+    /// Safe to invoke from multiple threads concurrently. Not intended to be instantiated.
+    class MemoryTracker
+    {
+    public:
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Enumerates the categories of tracked allocations.
+        enum EMemoryCategory
+        {
+            MemoryCategoryEdgeLists,                                        ///< Arena chunks that hold the mutable edge lists of vertex indices.
+            MemoryCategoryVertexIndex,                                      ///< Compact arrays of frozen vertex indices, including snapshot files mapped into memory, and degree counts used during preallocated ingress.
+            MemoryCategoryReadBuffers,                                      ///< Buffers that carry edges from the file being read.
+            MemoryCategoryWriteBuffers,                                     ///< Buffers that carry edges to the files being written.
+            MemoryCategoryVertexIDMap,                                      ///< Hash table that maps vertex identifiers read from the file to dense vertex identifiers.
+            MemoryCategoryExternalSort,                                     ///< Degree counts and buffers used to partition and sort edges during an external-memory conversion.
+            MemoryCategoryCount,                                            ///< Number of categories. Not a valid category.
+        };
+
+
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor. Should never be invoked.
+        MemoryTracker(void) = delete;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Retrieves the amount of physical memory available to this process, which is the smaller of the memory the operating system reports as available and any limit imposed on this process' control group.
+        /// @return Available memory in bytes, or 0 if it cannot be determined on this platform.
+        static uint64_t GetAvailableMemory(void);
+
+        /// Retrieves the name of a category, suitable for reporting.
+        /// @param [in] category Category of interest.
+        /// @return Human-readable name of the category.
+        static const char* GetCategoryName(const EMemoryCategory category);
+
+        /// Retrieves the amount of memory held by all tracked allocations.
+        /// @return Number of bytes currently in use.
+        static uint64_t GetCurrentBytes(void);
+
+        /// Retrieves the amount of available memory recorded alongside the most recent estimate.
+        /// @return Available memory in bytes, or 0 if no estimate has been recorded or the amount could not be determined.
+        static uint64_t GetEstimateAvailableBytes(void);
+
+        /// Retrieves the most recent estimate of the memory needed to read a graph.
+        /// @return Estimated number of bytes, or 0 if no estimate has been recorded.
+        static uint64_t GetEstimatedBytes(void);
+
+        /// Retrieves the largest amount of memory held by all tracked allocations at once since the most recent invocation of ResetIntervalPeak.
+        /// @return Peak number of bytes in use during the current interval.
+        static uint64_t GetIntervalPeakBytes(void);
+
+        /// Retrieves the largest amount of memory held by all tracked allocations at once since the process started.
+        /// @return Peak number of bytes in use.
+        static uint64_t GetPeakBytes(void);
+
+        /// Retrieves the largest amount of memory held by the tracked allocations of a single category at once since the process started.
+        /// Peaks of different categories need not have occurred at the same time, so their sum can exceed the overall peak.
+        /// @param [in] category Category of interest.
+        /// @return Peak number of bytes in use by the category.
+        static uint64_t GetPeakBytes(const EMemoryCategory category);
+
+        /// Records a new allocation. Has no effect if the address is `NULL`.
+        /// @param [in] address Address of the allocation, which identifies it when it is released.
+        /// @param [in] size Size of the allocation, in bytes.
+        /// @param [in] category Category of the allocation.
+        static void RecordAllocation(const void* const address, const size_t size, const EMemoryCategory category);
+
+        /// Records an estimate of the memory needed to read a graph, along with the amount of memory available at the time.
+        /// @param [in] estimatedBytes Estimated number of bytes needed.
+        /// @param [in] availableBytes Available memory in bytes, or 0 if unknown.
+        static void RecordEstimate(const uint64_t estimatedBytes, const uint64_t availableBytes);
+
+        /// Records the release of an allocation previously recorded using RecordAllocation. Has no effect if the address does not identify a tracked allocation.
+        /// @param [in] address Address of the allocation.
+        static void RecordRelease(const void* const address);
+
+        /// Begins a new interval for the purpose of measuring peak use, such as a processing phase, starting from the amount currently in use.
+        static void ResetIntervalPeak(void);
+    };
+}
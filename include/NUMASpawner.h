@@ -0,0 +1,74 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file NUMASpawner.h
+ *   Declaration of functionality for creating Spindle parallelized regions
+ *   that span every NUMA node in the system.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Types.h"
+
+#include <cstdint>
+#include <spindle.h>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Creates Spindle parallelized regions consisting of one task per NUMA node, each with one thread per logical core on its node, and answers questions about such regions from within them.
+    /// Tasks are created in increasing order of NUMA node, skipping any nodes without logical cores, so global thread identifiers increase with the NUMA node.
+    /// Threads within such a region cooperate using global thread identifiers and global barriers.
+    /// Work divided by global thread identifier therefore gives each task a single contiguous range, which is how data structures are partitioned across NUMA nodes.
+    /// Such regions are run by a persistent team of threads, which is created and pinned the first time a region is needed and then reused by each subsequent region, so that consecutive phases do not each pay to create and pin their threads.
+    /// Spindle supports only one parallelized region at a time, so the team is released whenever a region with a different set of tasks is created, and created again when next needed.
+    class NUMASpawner
+    {
+    public:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Determines the range of work units for which the calling task is responsible, if units are divided evenly among all threads by global thread identifier.
+        /// Intended to be called from within a parallelized region created by this class.
+        /// @param [in] numUnits Total number of work units.
+        /// @param [out] rangeStart First work unit for which the calling task is responsible.
+        /// @param [out] rangeEnd One past the last work unit for which the calling task is responsible.
+        static void GetCurrentTaskUnitRange(const uint64_t numUnits, uint64_t& rangeStart, uint64_t& rangeEnd);
+
+        /// Computes the total number of threads in a parallelized region created by this class.
+        /// Useful for sizing buffers with one or more locations per thread.
+        /// @return Number of threads, or 0 if the system topology could not be determined.
+        static uint32_t GetThreadCount(void);
+
+        /// Determines how work units would be divided among NUMA nodes by a parallelized region created by this class, if units are divided evenly among all threads by global thread identifier.
+        /// Allows data structures to be placed ahead of time to match the way a later parallelized region will access them.
+        /// @param [in] numUnits Total number of work units.
+        /// @param [out] rangeStarts Filled with the first work unit of the range for which each task is responsible, in task order.
+        /// @param [out] numaNodes Filled with the NUMA node of each task, in task order.
+        static void GetUnitRangesByNUMANode(const uint64_t numUnits, std::vector<uint64_t>& rangeStarts, std::vector<uint32_t>& numaNodes);
+
+        /// Releases the persistent team of threads, if it exists, and waits for its threads to exit.
+        /// Intended to be called once no more parallelized regions are needed, before the program exits.
+        static void ReleaseThreads(void);
+
+        /// Runs a parallelized region spanning every NUMA node and waits for it to complete.
+        /// The region is run by the persistent team of threads, which is created first if it does not already exist, so the calling thread does not take part in the region.
+        /// Must not be called from within a parallelized region.
+        /// @param [in] func Function that every thread executes.
+        /// @param [in] arg Argument passed to every invocation of the function.
+        /// @return Indicator of the result of the operation.
+        static EGraphResult Spawn(TSpindleFunc func, void* arg);
+
+        /// Creates a parallelized region consisting of the specified tasks and waits for it to complete, for work whose tasks differ from one per NUMA node.
+        /// The persistent team of threads is released first, if it exists, and the calling thread takes part in the region.
+        /// @param [in] taskSpecs Specifications of the tasks that make up the region.
+        /// @param [in] taskCount Number of tasks.
+        /// @return Indicator of the result of the operation.
+        static EGraphResult SpawnTasks(SSpindleTaskSpec* const taskSpecs, const uint32_t taskCount);
+    };
+}
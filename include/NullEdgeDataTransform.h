@@ -26,12 +26,26 @@ namespace GraphTool
     
     /// Transformation class for applying null values to edge data elements.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
-    template <typename TEdgeData> class NullEdgeDataTransform : public EdgeDataTransform<TEdgeData>
+    template <typename TEdgeData> class NullEdgeDataTransform : public EdgeDataTransform<TEdgeData, NullEdgeDataTransform<TEdgeData>>
     {   
     public:
-        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // -------- CLASS METHODS ------------------------------------------ //
         // See "EdgeDataTransform.h" for documentation.
         
-        virtual TEdgeData GenerateEdgeData(const TVertexID sourceVertex, const TVertexID destinationVertex, const TEdgeData oldEdgeData);
+        /// Generates an edge data value for a single edge.
+        /// @param [in] sourceVertex Source vertex identifier, which is ignored.
+        /// @param [in] destinationVertex Destination vertex identifier, which is ignored.
+        /// @param [in] oldEdgeData Existing edge data value, which is ignored.
+        /// @return Null edge data value.
+        static inline TEdgeData GenerateEdgeData(const TVertexID sourceVertex, const TVertexID destinationVertex, const TEdgeData oldEdgeData)
+        {
+            return (TEdgeData)0;
+        }
+        
+        template <typename TNeighborID> static inline void GenerateEdgeDataBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TNeighborID* const neighbors, UEdgeData* const edgeData, const size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                edgeData[i] = (TEdgeData)0;
+        }
     };
 }
@@ -22,11 +22,16 @@
 #define strnicmp                                _strnicmp
 #define _mm256_extract_epi64(v256, idx)         v256.m256i_u64[idx]
 #define _mm256_insert_epi64(v256, val, idx)     v256.m256i_u64[idx] = val
+#define fseek64                                 _fseeki64
+#define ftell64                                 _ftelli64
+#define getpid                                  _getpid
 
 #endif
 
 #ifdef __PLATFORM_LINUX
 
 #define strnicmp                                strncasecmp
+#define fseek64                                 fseeko
+#define ftell64                                 ftello
 
 #endif
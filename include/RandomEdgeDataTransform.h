@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file RandomEdgeDataTransform.h
+ *   Declaration of an edge data generator that derives random values from
+ *   a seed and the source and destination vertex identifiers.
+ *****************************************************************************/
+
+#pragma once
+
+#include "EdgeDataTransform.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    /// Enumerates the distributions from which random edge data values can be drawn.
+    enum ERandomDistribution : int64_t
+    {
+        RandomDistributionUniform,                                          ///< Uniform distribution, between 1 and the scale for integers and between 0 and the scale for floating-point values.
+        RandomDistributionExponential,                                      ///< Exponential distribution whose mean is the scale, rounded down and increased by 1 for integers.
+    };
+
+
+    /// Transformation class for applying random values to edge data elements.
+    /// Each value is derived only from the seed and the source and destination vertex of its edge, using the Philox4x32-10 counter-based generator with the two vertex identifiers as the counter and the seed as the key.
+    /// Values are therefore the same regardless of the number of threads or the order in which edges are visited, and an edge receives the same value in both groupings without any coordination between them, although duplicate edges all receive the same value too.
+    /// Batches of edges are generated four at a time using AVX2 instructions.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class RandomEdgeDataTransform : public EdgeDataTransform<TEdgeData, RandomEdgeDataTransform<TEdgeData>>
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the default seed.
+        static const uint64_t kDefaultSeed = 1;
+
+        /// Specifies the default scale, which matches the range of values produced by other sources of generated edge data.
+        static const double kDefaultScale;
+
+
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Specifies the distribution from which values are drawn.
+        ERandomDistribution distribution;
+
+        /// Scale of the distribution, which is the largest value for the uniform distribution and the mean for the exponential distribution.
+        double scale;
+
+        /// Seed from which every value is derived.
+        uint64_t seed;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        RandomEdgeDataTransform(void);
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Determines if the specified scale can be used with the type of edge data being generated.
+        /// @param [in] value Scale to check.
+        /// @return `true` if the scale is valid, `false` otherwise.
+        static bool IsValidScale(const double value);
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Generates edge data for a batch of edges that share a top-level vertex, four at a time using AVX2 instructions.
+        /// @tparam TNeighborID Type used to store the identifiers of the vertices at the other end of each edge.
+        /// @param [in] topLevelVertex Vertex identifier shared by all edges in the batch.
+        /// @param [in] topLevelIsDestination Indicates that the top-level vertex is the destination of each edge rather than its source.
+        /// @param [in] neighbors Identifiers of the vertices at the other end of each edge.
+        /// @param [out] edgeData Edge data of each edge, replaced by the generated values.
+        /// @param [in] count Number of edges in the batch.
+        template <typename TNeighborID> void GenerateEdgeDataVectorized(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TNeighborID* const neighbors, UEdgeData* const edgeData, const size_t count) const;
+
+        /// Converts random bits into an edge data value drawn from the selected distribution.
+        /// @param [in] randomBits Random bits produced by the generator.
+        /// @return Edge data value.
+        TEdgeData RandomBitsToEdgeData(const uint64_t randomBits) const;
+
+
+    public:
+        // -------- INSTANCE METHODS --------------------------------------- //
+        // See "EdgeDataTransform.h" for documentation.
+
+        void GenerateEdgeDataBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count) const;
+        void GenerateEdgeDataBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count) const;
+
+        /// Generates an edge data value for a single edge.
+        /// @param [in] sourceVertex Source vertex identifier.
+        /// @param [in] destinationVertex Destination vertex identifier.
+        /// @param [in] oldEdgeData Existing edge data value, which is ignored.
+        /// @return Generated edge data value.
+        TEdgeData GenerateEdgeData(const TVertexID sourceVertex, const TVertexID destinationVertex, const TEdgeData oldEdgeData) const;
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphTransform.h" for documentation.
+
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+    };
+}
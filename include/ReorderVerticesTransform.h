@@ -0,0 +1,275 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file ReorderVerticesTransform.h
+ *   Declaration of a transformation that renumbers vertices to improve locality.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphTransform.h"
+#include "Types.h"
+#include "VertexIndex.h"
+#include "WorkScheduler.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace GraphTool
+{
+    class Graph;
+
+
+    /// Enumerates the orderings into which vertices can be renumbered.
+    enum EVertexOrder : int64_t
+    {
+        VertexOrderDegree,                                                  ///< Descending order of degree, so that the most frequently accessed vertices are packed together.
+        VertexOrderRCM,                                                     ///< Reverse Cuthill-McKee order, which places each vertex close to its neighbors by numbering vertices in breadth-first order.
+        VertexOrderGorder,                                                  ///< Gorder-style greedy order, which places next the vertex that shares the most neighbors with those placed just before it.
+        VertexOrderCompact,                                                 ///< Existing order, keeping only vertices that have at least one edge, so that isolated vertices are removed and the rest are numbered densely.
+    };
+
+
+    /// Transformation class for renumbering the vertices of a graph so that vertices that are accessed together have nearby identifiers.
+    /// Both vertex indices are renumbered consistently, and edges keep their relative order within each vertex, so they are no longer sorted.
+    /// Orderings other than by degree and compaction treat the graph as undirected and need edges grouped both ways, so any missing grouping is built for the duration of the transformation and then discarded.
+    /// Every ordering is deterministic and independent of the number of threads.
+    /// Compaction is the only renumbering that removes vertices, and because it keeps the existing order it also keeps edges sorted if they already were.
+    /// Optionally writes the permutation to a file, so that results computed on the renumbered graph can be mapped back to the original identifiers.
+    /// Operates on the frozen representation, freezing the graph first if needed.
+    class ReorderVerticesTransform : public GraphTransform
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the default number of previously-placed vertices with which the Gorder-style ordering compares each candidate vertex.
+        static const uint64_t kDefaultGorderWindow = 5;
+
+        /// Specifies the number of consecutive vertices in Cuthill-McKee order that the Gorder-style ordering rearranges as a unit.
+        /// Each unit is rearranged independently, by a single thread, which is what allows the greedy ordering to proceed in parallel.
+        static const TVertexCount kGorderBlockSize = 65536;
+
+        /// Specifies the number of vertices at and above which a level of the Cuthill-McKee breadth-first search is processed by all threads rather than by just one.
+        static const TVertexCount kParallelFrontierThreshold = 4096;
+
+        /// Placeholder used in place of a vertex identifier or position where there is none.
+        static const uint64_t kNoVertex = UINT64_MAX;
+
+
+    private:
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Holds the scores of the vertices in a block being ordered by the Gorder-style ordering, bucketed by score so that the highest-scoring vertex can be found quickly.
+        /// Vertices are identified by their position within the block, and each bucket is a doubly-linked list of the vertices with that score.
+        struct SGorderBlockState
+        {
+            std::vector<uint64_t> scores;                                   ///< Score of each vertex.
+            std::vector<uint64_t> previous;                                 ///< Previous vertex in the same bucket, or kNoVertex.
+            std::vector<uint64_t> next;                                     ///< Next vertex in the same bucket, or kNoVertex.
+            std::vector<uint64_t> bucketHeads;                              ///< First vertex in each bucket, or kNoVertex.
+            std::vector<uint8_t> placed;                                    ///< Specifies that a vertex has already been placed and no longer has a score.
+            uint64_t maxScore;                                              ///< Upper bound on the score of every vertex not yet placed.
+        };
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Specifies the ordering to produce.
+        const EVertexOrder vertexOrder;
+
+        /// Number of previously-placed vertices with which the Gorder-style ordering compares each candidate vertex.
+        uint64_t gorderWindow;
+
+        /// Name of the file to which the permutation is written, or empty if it should not be written.
+        std::string permutationFilename;
+
+        /// Source-grouped vertex index of the graph being transformed, or `NULL` if edges are not grouped by source.
+        const VertexIndex* outEdges;
+
+        /// Destination-grouped vertex index of the graph being transformed, or `NULL` if edges are not grouped by destination.
+        const VertexIndex* inEdges;
+
+        /// Number of vertices being renumbered.
+        TVertexCount numVertices;
+
+        /// Number of vertices that remain after renumbering, which is less than the number being renumbered only if isolated vertices are removed.
+        TVertexCount numVerticesKept;
+
+        /// Out-degree above which a vertex is too well-connected to make its neighbors meaningfully similar to one another, for the purpose of the Gorder-style ordering.
+        TEdgeCount gorderHubDegree;
+
+        /// Temporary buffer shared among all threads, holding one location per thread.
+        uint64_t* sharedBuf;
+
+        /// Degree of each vertex, counting both in-edges and out-edges if both groupings are present.
+        /// When ordering by degree, counts both even if only one grouping is present.
+        TEdgeCount* degrees;
+
+        /// New identifier of each vertex, indexed by its original identifier.
+        /// While the Cuthill-McKee ordering is being computed, holds each vertex's position in that ordering, or kNoVertex if the vertex has not yet been placed.
+        TVertexID* newIDs;
+
+        /// Original identifier of each vertex, indexed by its new identifier.
+        TVertexID* oldIDs;
+
+        /// Scratch array holding one vertex identifier per vertex.
+        TVertexID* scratchIDs;
+
+        /// Earliest position in the current level of the Cuthill-McKee search of a vertex adjacent to each vertex not yet placed.
+        /// While isolated vertices are being identified, instead holds a non-zero value for each vertex that is the neighbor of another.
+        /// While degrees are being computed for ordering by degree, instead holds the number of edges in the grouping that is present that lead to each vertex.
+        std::atomic<uint64_t>* claims;
+
+        /// Scratch space for each thread.
+        std::vector<TVertexID>* threadVertices;
+
+        /// Position within the vertices sorted by ascending degree from which to look for the vertex that starts the next connected component of the Cuthill-McKee search.
+        TVertexID nextStartCandidate;
+
+        /// Number of vertices placed so far by the Cuthill-McKee search.
+        TVertexCount numPlaced;
+
+        /// Position in the Cuthill-McKee ordering of the first vertex in the current level of the search.
+        TVertexID levelStart;
+
+        /// Position in the Cuthill-McKee ordering one past the last vertex in the current level of the search.
+        TVertexID levelEnd;
+
+        /// Specifies that the Cuthill-McKee search has placed every vertex.
+        bool searchComplete;
+
+        /// Divides the edges of the graph among threads when isolated vertices are being identified.
+        WorkScheduler workScheduler;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Initialization constructor.
+        /// @param [in] vertexOrder Specifies the ordering to produce.
+        ReorderVerticesTransform(const EVertexOrder vertexOrder);
+
+        /// Destructor.
+        virtual ~ReorderVerticesTransform(void);
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Invokes the specified function for the vertex at the other end of each edge of a top-level vertex in a frozen vertex index.
+        /// @tparam TVisit Type of the function, which accepts a vertex identifier.
+        /// @param [in] vertexIndex Vertex index to examine, or `NULL`, in which case there are no edges.
+        /// @param [in] vertex Top-level vertex whose edges are to be visited.
+        /// @param [in] visit Function to invoke.
+        template <typename TVisit> static inline void VisitFrozenNeighbors(const VertexIndex* const vertexIndex, const TVertexID vertex, TVisit visit)
+        {
+            if ((NULL == vertexIndex) || (vertex >= vertexIndex->GetNumVertices()))
+                return;
+
+            const TEdgeCount* const offsets = vertexIndex->GetFrozenOffsets();
+
+            for (TEdgeID edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+                visit(vertexIndex->GetFrozenNeighbor(edge));
+        }
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Computes the compacted ordering, which keeps the existing order of all vertices that have at least one edge in either direction and removes the rest.
+        /// Upon completion, holds the ordering in both permutation arrays and the number of vertices it keeps in numVerticesKept.
+        /// Invoked by all threads in the Spindle parallelized region.
+        void ComputeCompactOrder(void);
+
+        /// Computes the Cuthill-McKee ordering, which numbers the vertices of each connected component in breadth-first order, starting from a vertex of lowest degree and visiting the neighbors of each vertex in ascending order of degree.
+        /// Upon completion, holds the ordering in both permutation arrays.
+        /// Invoked by all threads in the Spindle parallelized region.
+        void ComputeCuthillMcKeeOrder(void);
+
+        /// Computes the ordering by descending degree, holding it in both permutation arrays upon completion.
+        /// Invoked by all threads in the Spindle parallelized region.
+        void ComputeDegreeOrder(void);
+
+        /// Computes the Gorder-style ordering by rearranging each block of the Cuthill-McKee ordering, which must already have been computed.
+        /// Upon completion, holds the ordering in both permutation arrays.
+        /// Invoked by all threads in the Spindle parallelized region.
+        void ComputeGorderOrder(void);
+
+        /// Places vertices into the Cuthill-McKee ordering, one level of the breadth-first search at a time, using all threads.
+        /// Each vertex is placed as a child of the earliest vertex in the current level to which it is adjacent, exactly as it would be by a single thread.
+        /// Invoked by all threads in the Spindle parallelized region.
+        void OrderCuthillMcKeeLevelParallel(void);
+
+        /// Places vertices into the Cuthill-McKee ordering on a single thread, starting new connected components as needed, until either a level is large enough to be processed in parallel or every vertex is placed.
+        void OrderCuthillMcKeeLevelsSerial(void);
+
+        /// Rearranges a single block of the Cuthill-McKee ordering using the Gorder-style greedy ordering, placing the result into the scratch array.
+        /// Each vertex placed next is the one that maximizes the number of edges to, plus the number of in-neighbors shared with, the vertices in the window of most recently placed vertices.
+        /// Only vertices within the block are candidates, but shared in-neighbors may lie anywhere in the graph.
+        /// @param [in] blockStart Position in the Cuthill-McKee ordering of the first vertex in the block.
+        /// @param [in] blockEnd Position in the Cuthill-McKee ordering one past the last vertex in the block.
+        /// @param [in,out] state Per-thread working space, reused across blocks.
+        void OrderGorderBlock(const TVertexID blockStart, const TVertexID blockEnd, SGorderBlockState& state) const;
+
+        /// Sorts all vertices by degree, with ties broken by ascending identifier, using all threads.
+        /// Invoked by all threads in the Spindle parallelized region.
+        /// @param [out] sortedVertices Array that receives the sorted vertex identifiers.
+        /// @param [in] scratch Scratch array holding one vertex identifier per vertex.
+        /// @param [in] descending Specifies that vertices should be sorted in descending order of degree, rather than ascending.
+        void ParallelSortVerticesByDegree(TVertexID* const sortedVertices, TVertexID* const scratch, const bool descending) const;
+
+        /// Determines if one vertex precedes another in ascending order of degree, with ties broken by ascending identifier.
+        /// @param [in] vertexA First vertex to compare.
+        /// @param [in] vertexB Second vertex to compare.
+        /// @return `true` if the first vertex precedes the second, `false` otherwise.
+        inline bool PrecedesByAscendingDegree(const TVertexID vertexA, const TVertexID vertexB) const
+        {
+            return ((degrees[vertexA] < degrees[vertexB]) || ((degrees[vertexA] == degrees[vertexB]) && (vertexA < vertexB)));
+        }
+
+        /// Determines if one vertex precedes another in descending order of degree, with ties broken by ascending identifier.
+        /// @param [in] vertexA First vertex to compare.
+        /// @param [in] vertexB Second vertex to compare.
+        /// @return `true` if the first vertex precedes the second, `false` otherwise.
+        inline bool PrecedesByDescendingDegree(const TVertexID vertexA, const TVertexID vertexB) const
+        {
+            return ((degrees[vertexA] > degrees[vertexB]) || ((degrees[vertexA] == degrees[vertexB]) && (vertexA < vertexB)));
+        }
+
+        /// Invokes the specified function for every neighbor of a vertex, treating the graph as undirected by visiting both out-neighbors and in-neighbors.
+        /// @tparam TVisit Type of the function, which accepts a vertex identifier.
+        /// @param [in] vertex Vertex whose neighbors are to be visited.
+        /// @param [in] visit Function to invoke.
+        template <typename TVisit> inline void VisitNeighbors(const TVertexID vertex, TVisit visit) const
+        {
+            VisitFrozenNeighbors(outEdges, vertex, visit);
+            VisitFrozenNeighbors(inEdges, vertex, visit);
+        }
+
+        /// Writes the permutation to the permutation file, one line per vertex kept in order of new identifier, each holding the vertex's original identifier.
+        /// @return `true` if the file was written successfully, `false` otherwise.
+        bool WritePermutationFile(void) const;
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphTransform.h" for documentation.
+
+        virtual EGraphResult ApplyTransformation(Graph& graph);
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphTransform.h" for documentation.
+
+        virtual EGraphResult TransformGraph(Graph& graph);
+    };
+}
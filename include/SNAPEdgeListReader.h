@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file SNAPEdgeListReader.h
+ *   Declaration of a graph reader for edge list files distributed by the
+ *   Stanford Network Analysis Project (SNAP).
+ *****************************************************************************/
+
+#pragma once
+
+#include "TextEdgeListReader.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdio>
+
+
+namespace GraphTool
+{
+    /// Reader object class for graphs represented in the text edge list format distributed by the Stanford Network Analysis Project (SNAP).
+    /// Files hold one edge per line as a source vertex and a destination vertex, optionally followed by edge data, and have no header apart from comment lines beginning with '#'.
+    /// Vertex and edge counts are taken from a comment of the form "Nodes: N Edges: M", which SNAP includes in most of its files, so the file is read only once.
+    /// Files without such a comment are first scanned to count their edges and find their largest vertex identifier, and then reopened to be read.
+    /// Parsing is inherited from the text edge list reader, so the file is parsed in parallel by default.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class SNAPEdgeListReader : public TextEdgeListReader<TEdgeData>
+    {
+    private:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the number of bytes read at a time when scanning the file for its counts.
+        static const size_t kScanBlockSize = 16ull * 1024ull * 1024ull;
+
+        /// Specifies the number of zero bytes that follow each block read when scanning, so that parsing a vertex identifier never reads beyond the block.
+        static const size_t kScanBlockPadding = 16;
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Specifies that counts should always be determined by scanning the file, even if its comments hold them.
+        bool useCountScan;
+
+        /// Indicates that the comments at the start of the file hold both counts, determined when the file header is read.
+        bool headerCountsFound;
+
+        /// Indicates that the file has already been scanned for its counts, so that reopening the file does not scan it again.
+        bool countsScanned;
+
+
+        // -------- INSTANCE METHODS --------------------------------------- //
+
+        /// Reads the rest of the file, counting the lines that hold edges and finding the largest vertex identifier, and sets the numEdgesInFile and numVerticesInFile variables accordingly.
+        /// @param [in] graphfile File handle for the open graph file, positioned at the first line that may hold an edge.
+        /// @return `true` if the file was scanned successfully, `false` in the event of an I/O error.
+        bool ScanForCounts(FILE* const graphfile);
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        SNAPEdgeListReader(void);
+
+
+    protected:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "TextEdgeListReader.h" for documentation.
+
+        virtual unsigned int ParseEdgesFromLine(const char* const line, const char* const lineEnd, SEdge<TEdgeData>* const edges) const;
+        virtual bool ReadGraphFileHeader(FILE* const graphfile);
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphReader.h" for documentation.
+
+        virtual GraphReader<TEdgeData>* CreateShardReader(void) const;
+        virtual FILE* OpenAndInitializeGraphFileForRead(const char* const filename);
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+    };
+}
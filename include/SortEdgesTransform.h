@@ -0,0 +1,130 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file SortEdgesTransform.h
+ *   Declaration of a transformation that sorts the edges of each vertex and
+ *   optionally merges duplicate edges.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphTransform.h"
+#include "Types.h"
+#include "WorkScheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace GraphTool
+{
+    class Graph;
+    class VertexIndex;
+
+
+    /// Enumerates the ways in which duplicate edges (i.e. multiple edges with the same source and destination) can be handled.
+    enum EDuplicateEdgePolicy : int64_t
+    {
+        DuplicateEdgePolicyKeep,                                            ///< Duplicate edges are kept as separate edges.
+        DuplicateEdgePolicyFirst,                                           ///< Duplicate edges are merged, keeping the edge data of whichever appeared first in the input.
+        DuplicateEdgePolicyMin,                                             ///< Duplicate edges are merged, keeping the minimum edge data value.
+        DuplicateEdgePolicyMax,                                             ///< Duplicate edges are merged, keeping the maximum edge data value.
+        DuplicateEdgePolicySum,                                             ///< Duplicate edges are merged, summing their edge data values.
+    };
+
+
+    /// Transformation class for sorting the edges of each vertex in ascending order of the vertex at the other end.
+    /// Duplicate edges can optionally be merged, in which case their edge data are combined by the selected policy.
+    /// Sorting is stable, so the resulting order depends only on the set of edges and the relative input order of duplicates.
+    /// Once sorted, both vertex indices locate edges by binary search.
+    /// Operates on the frozen representation, freezing the graph first if needed.
+    class SortEdgesTransform : public GraphTransform
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the number of edges at and above which the edges of a vertex are radix-sorted rather than insertion-sorted.
+        static const TEdgeCount kRadixSortThreshold = 64;
+
+
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Specifies how duplicate edges are handled.
+        const EDuplicateEdgePolicy duplicatePolicy;
+
+        /// Temporary buffer shared among all threads, holding four locations per thread.
+        uint64_t* sharedBuf;
+
+        /// Holds the number of edges each top-level vertex keeps after duplicates are merged.
+        /// Shared among all threads while a vertex index is being transformed.
+        TEdgeCount* keptDegrees;
+
+        /// Hands out the vertices of each vertex index to threads, in units balanced by the number of edges they hold.
+        /// Shared among all threads while a vertex index is being transformed.
+        WorkScheduler workScheduler;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Initialization constructor.
+        /// @param [in] duplicatePolicy Specifies how duplicate edges are handled.
+        SortEdgesTransform(const EDuplicateEdgePolicy duplicatePolicy);
+
+        /// Destructor.
+        virtual ~SortEdgesTransform(void);
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Merges the edge data of a duplicate edge into the edge data of the edge being kept.
+        /// @param [in,out] keptEdgeData Edge data of the edge being kept.
+        /// @param [in] duplicateEdgeData Edge data of the duplicate edge being discarded.
+        /// @param [in] duplicatePolicy Specifies how the edge data should be combined.
+        /// @param [in] edgeDataType Type of the edge data.
+        static void MergeEdgeData(UEdgeData& keptEdgeData, const UEdgeData& duplicateEdgeData, const EDuplicateEdgePolicy duplicatePolicy, const EEdgeDataType edgeDataType);
+
+        /// Stably sorts the edges of a single top-level vertex by other vertex.
+        /// @tparam TNeighbor Type used to store the other vertex of each edge, which depends on whether the frozen neighbors are compact.
+        /// @param [in,out] neighbors Other vertex of each edge.
+        /// @param [in,out] edgeData Data of each edge, reordered alongside the neighbors, or `NULL` if there are no edge data.
+        /// @param [in] count Number of edges.
+        /// @param [in,out] scratchNeighbors Per-thread scratch space, grown as needed.
+        /// @param [in,out] scratchEdgeData Per-thread scratch space, grown as needed.
+        template <typename TNeighbor> static void SortEdges(TNeighbor* const neighbors, UEdgeData* const edgeData, const TEdgeCount count, std::vector<TNeighbor>& scratchNeighbors, std::vector<UEdgeData>& scratchEdgeData);
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Merges adjacent duplicates among the sorted edges of a single top-level vertex, moving the edges that remain to the front.
+        /// @tparam TNeighbor Type used to store the other vertex of each edge, which depends on whether the frozen neighbors are compact.
+        /// @param [in,out] neighbors Other vertex of each edge, already sorted.
+        /// @param [in,out] edgeData Data of each edge, or `NULL` if there are no edge data.
+        /// @param [in] count Number of edges.
+        /// @param [in] edgeDataType Type of the edge data.
+        /// @return Number of edges that remain.
+        template <typename TNeighbor> TEdgeCount DeduplicateEdges(TNeighbor* const neighbors, UEdgeData* const edgeData, const TEdgeCount count, const EEdgeDataType edgeDataType) const;
+
+        /// Sorts, and optionally deduplicates, all of the edges in a frozen vertex index.
+        /// Invoked by all threads in the Spindle parallelized region.
+        /// @param [in,out] vertexIndex Vertex index to transform.
+        /// @param [in] edgeDataType Type of the edge data held in the graph.
+        /// @return Result of the operation.
+        EGraphResult TransformVertexIndex(VertexIndex& vertexIndex, const EEdgeDataType edgeDataType);
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphTransform.h" for documentation.
+
+        virtual EGraphResult TransformGraph(Graph& graph);
+    };
+}
@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file Statistics.h
+ *   Collection and reporting of per-phase timing and throughput statistics.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    /// Collects timing and throughput statistics for each phase of processing a graph, such as reading, transforming, and writing.
+    /// Each phase records its wall time, the number of bytes and edges it processed, the time spent in named activities within it, such as parsing or waiting at a barrier, and the peak memory held by the allocations that MemoryTracker accounts for.
+    /// Collection is disabled by default, in which case timestamps are all zero and nothing is recorded, so instrumented code adds practically no overhead.
+    /// Not intended to be instantiated.
+    class Statistics
+    {
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor. Should never be invoked.
+        Statistics(void) = delete;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Adds to the number of bytes and edges processed by the current phase.
+        /// Has no effect if collection is disabled or no phase is in progress.
+        /// @param [in] numBytes Number of bytes processed.
+        /// @param [in] numEdges Number of edges processed.
+        static void AddPhaseCounts(const uint64_t numBytes, const uint64_t numEdges);
+
+        /// Adds time spent in a named activity to the current phase.
+        /// Times added under the same name are summed, including those added by concurrent groups of threads, so the total can exceed the wall time of the phase.
+        /// Safe to invoke from multiple threads concurrently. Has no effect if collection is disabled or no phase is in progress.
+        /// @param [in] detailName Name of the activity.
+        /// @param [in] elapsedTime Time spent in the activity, in nanoseconds.
+        static void AddPhaseDetailTime(const char* const detailName, const uint64_t elapsedTime);
+
+        /// Starts timing a new phase, ending the current phase if there is one.
+        /// Has no effect if collection is disabled.
+        /// @param [in] phaseName Name of the phase.
+        static void BeginPhase(const char* const phaseName);
+
+        /// Enables collection of statistics. Must be invoked before any phase begins.
+        static void Enable(void);
+
+        /// Stops timing the current phase. Has no effect if collection is disabled or no phase is in progress.
+        static void EndPhase(void);
+
+        /// Retrieves the largest amount of physical memory that this process has occupied at any point since it started.
+        /// @return Peak resident set size in bytes, or 0 if it cannot be determined on this platform.
+        static uint64_t GetPeakResidentSetSize(void);
+
+        /// Retrieves a timestamp from a monotonic clock, suitable for measuring elapsed time.
+        /// @return Timestamp in nanoseconds, or 0 if collection is disabled.
+        static uint64_t GetTimestamp(void);
+
+        /// Specifies if statistics are being collected.
+        /// @return `true` if so, `false` if not.
+        static bool IsEnabled(void);
+
+        /// Prints a human-readable summary of all completed phases and of peak memory use to the standard output console.
+        /// Has no effect if collection is disabled.
+        static void PrintSummary(void);
+
+        /// Waits at a Spindle global barrier and measures the time spent waiting, which is the time this thread was stalled waiting for the other threads.
+        /// @return Time spent waiting, in nanoseconds, or 0 if collection is disabled.
+        static uint64_t TimedBarrierGlobal(void);
+
+        /// Writes all completed phases and peak memory use to a file in JSON format, for consumption by other tools.
+        /// @param [in] filename Name of the file to write.
+        /// @return `true` if the file was written successfully, `false` otherwise.
+        static bool WriteToJSONFile(const char* const filename);
+    };
+}
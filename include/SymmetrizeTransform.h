@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file SymmetrizeTransform.h
+ *   Declaration of a graph transformation that makes a graph undirected by
+ *   adding the reverse of every edge.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphTransform.h"
+#include "SortEdgesTransform.h"
+#include "Types.h"
+#include "VertexIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    class Graph;
+
+
+    /// Transformation class for making a graph undirected by adding, for every edge, the edge in the opposite direction.
+    /// Edges that end up duplicated, including those that were already present in both directions, are merged using a configurable policy for combining their edge data.
+    /// When edge data are merged by keeping the first value, an original edge takes precedence over the reverse of any other edge.
+    /// Afterwards both groupings hold the same edges, sorted by the vertex at the other end, and any grouping the graph maintains is built in parallel.
+    /// Operates on the frozen representation, freezing the graph first if needed.
+    class SymmetrizeTransform : public GraphTransform
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Specifies how duplicate edges are merged.
+        EDuplicateEdgePolicy duplicatePolicy;
+
+        /// Temporary buffer shared among all threads, large enough for transposing a vertex index.
+        uint64_t* sharedBuf;
+
+        /// Temporary buffer shared among all threads, holding two locations per edge, used only if the graph maintains a single grouping.
+        uint64_t* edgeBuf;
+
+        /// Transformation used to sort and merge the edges once the reverse edges have been added.
+        /// Shared among all threads while the graph is being transformed.
+        SortEdgesTransform* sortTransform;
+
+        /// Holds the transpose of the only grouping the graph maintains, if it does not maintain both.
+        VertexIndex transposedIndex;
+
+        /// Holds the symmetrized destination-grouped edges until they replace the graph's own.
+        VertexIndex symmetrizedDestination;
+
+        /// Holds the symmetrized source-grouped edges until they replace the graph's own.
+        VertexIndex symmetrizedSource;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        SymmetrizeTransform(void);
+
+        /// Destructor.
+        virtual ~SymmetrizeTransform(void);
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphTransform.h" for documentation.
+
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        virtual EGraphResult TransformGraph(Graph& graph);
+    };
+}
@@ -0,0 +1,121 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file SyntheticGraphReader.h
+ *   Declaration of a graph reader that generates synthetic graphs.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphReader.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Reader object class that generates synthetic graphs instead of reading them from a file.
+    /// Supports the R-MAT model with the Graph500 Kronecker parameters and a uniform random model, with size, seed, and model specified by reader options.
+    /// Edges are produced in chunks that all consumer threads generate in parallel. Each edge is derived only from the seed and its own position in the edge sequence, so the graph is identical regardless of the number of threads.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class SyntheticGraphReader : public GraphReader<TEdgeData>
+    {
+    private:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the number of bytes of each chunk that nominally belong to each edge.
+        /// Chunks hold only the position of their first edge, and consumer threads divide each chunk by byte range, so this determines how edges are divided among them.
+        static const size_t kBytesPerChunkEdge = 16;
+
+        /// Specifies the largest supported scale, which is the base-2 logarithm of the number of vertices.
+        static const uint64_t kMaxScale = 48;
+
+
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Enumerates the supported models for generating edges.
+        enum EGeneratorModel
+        {
+            GeneratorModelRMAT,                                             ///< Recursive matrix model with the Graph500 parameters (A = 0.57, B = 0.19, C = 0.19).
+            GeneratorModelUniform,                                          ///< Both endpoints of each edge chosen uniformly at random.
+        };
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Model used to generate edges.
+        EGeneratorModel model;
+
+        /// Base-2 logarithm of the number of vertices.
+        uint64_t scale;
+
+        /// Number of edges per vertex.
+        uint64_t edgeFactor;
+
+        /// Seed from which every edge is derived.
+        uint64_t seed;
+
+        /// Specifies that vertex identifiers should be permuted, as Graph500 does, so that high-degree vertices are not clustered at low identifiers.
+        bool scrambleVertices;
+
+        /// Position in the edge sequence of the next edge to be placed into a chunk.
+        TEdgeCount nextEdge;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        SyntheticGraphReader(void);
+
+
+    private:
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Generates edge data for an edge using the next random value from its random number sequence.
+        /// Actual generation is determined by the type of data of interest, which would need to be specialized for each supported type.
+        /// Integer edge data are uniformly distributed between 1 and 32768, matching the range produced by the hashedgedata transformation, and floating-point edge data between 0.0 and 1.0.
+        /// @param [in,out] randomState State of the edge's random number sequence.
+        /// @param [out] edge Edge into which to place the generated edge data.
+        static void GenerateEdgeData(uint64_t& randomState, SEdge<TEdgeData>& edge);
+
+        /// Advances a random number sequence and produces its next value, using the SplitMix64 algorithm.
+        /// @param [in,out] randomState State of the random number sequence.
+        /// @return Next random value.
+        static uint64_t NextRandom(uint64_t& randomState);
+
+
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Generates a single edge from its position in the edge sequence.
+        /// @param [in] edgeIndex Position of the edge in the edge sequence.
+        /// @param [out] edge Generated edge.
+        void GenerateEdge(const TEdgeCount edgeIndex, SEdge<TEdgeData>& edge) const;
+
+        /// Maps a vertex identifier to its scrambled identifier, using a bijection on the identifiers of the graph that depends on the seed.
+        /// @param [in] vertex Vertex identifier to scramble.
+        /// @return Scrambled vertex identifier.
+        TVertexID ScrambleVertex(const TVertexID vertex) const;
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphReader.h" for documentation.
+
+        virtual FILE* OpenAndInitializeGraphFileForRead(const char* const filename);
+        virtual void ParseEdgesFromChunk(const char* const chunk, const size_t chunkSize, const size_t rangeStart, const size_t rangeEnd, std::vector<SEdge<TEdgeData>>& edges) const;
+        virtual size_t ReadChunkToBuffer(FILE* const graphfile, char* const buf, const size_t size, const TEdgeCount maxEdges);
+        virtual TEdgeCount ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count);
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        virtual bool UsesParallelParsing(void) const;
+    };
+}
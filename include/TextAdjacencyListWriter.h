@@ -16,28 +16,49 @@
 #include "Types.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <vector>
 
 
 namespace GraphTool
 {
     /// Writer object class for graphs represented in text adjacency list format.
+    /// By default, edges are formatted by all consumer threads in parallel and written to the file in order.
+    /// The vertex offsets are likewise computed and formatted in parallel, and for weighted graphs the neighbor and weight sections are written together during a single pass over the edges.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
     template <typename TEdgeData> class TextAdjacencyListWriter : public GraphWriter<TEdgeData>
     {
     private:
         // -------- CLASS VARIABLES ---------------------------------------- //
-        
+
         /// Pointer to the string to place at the header line of an output file.
         static const char* const outputFileHeader;
-        
-    
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Position within the file at which the edge data section begins, determined when the file is opened.
+        int64_t edgeDataSectionPosition;
+
+
     public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        TextAdjacencyListWriter(void);
+
+
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "GraphWriter.h" for documentation.
 
-        virtual unsigned int NumberOfPassesRequired(void);
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
+        virtual void FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const;
         virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual FILE* OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsParallelFormatting(void) const;
+        virtual bool UsesSecondaryGraphFile(void) const;
         virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
     };
 }
@@ -17,30 +17,122 @@
 
 #include <cstddef>
 #include <cstdio>
+#include <vector>
 
 
 namespace GraphTool
 {
     /// Reader object class for graphs represented in text edge list format.
+    /// By default, the file is read in large chunks that are split at line boundaries and parsed by all consumer threads in parallel.
+    /// Serves as the base class for readers of other line-oriented text formats, which differ in their file headers and in how each line describes edges.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
     template <typename TEdgeData> class TextEdgeListReader : public GraphReader<TEdgeData>
     {
     private:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the minimum number of bytes occupied by a line that holds an edge, used to bound the number of edges in a chunk.
+        /// The shortest such line is two single-digit vertex identifiers separated by a single whitespace character.
+        static const size_t kMinBytesPerEdgeLine = 3;
+
+        /// Specifies the number of digits that can be parsed at once using vector instructions.
+        /// Vertex identifiers with more digits than this are parsed using the standard library.
+        static const size_t kVectorParseMaxDigits = 15;
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Holds the beginning of the line that was cut off at the end of the previous chunk.
+        std::vector<char> partialLine;
+
+        /// Specifies that the file should be parsed in parallel by all consumer threads, rather than line-by-line by the producer thread.
+        bool useParallelParser;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        TextEdgeListReader(void);
+
+
+    protected:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the largest number of edges that a single line can describe, such as in formats that store each undirected edge only once.
+        static const unsigned int kMaxEdgesPerLine = 2;
+
+        /// Specifies the size in bytes of the buffer used to read each line of a file header.
+        /// Longer header lines are truncated.
+        static const size_t kHeaderLineBufferSize = 1024;
+
+
         // -------- CLASS METHODS ------------------------------------------ //
-        
+
         /// Parses edge data from the given string.
         /// Actual expected string format is determined by the type of data of interest, which would need to be specialized for each supported type.
         /// @param [in] edgeDataString String from which to parse edge data.
         /// @param [out] edgeDataBuf Edge data buffer into which to place parsed edge data, if parsing succeeds.
         /// @return `true` if parsing was successful, `false` otherwise.
         static bool ParseEdgeData(const char* const edgeDataString, SEdge<TEdgeData>& edgeDataBuf);
-        
-        
+
+        /// Parses a single line of text into an edge.
+        /// Lines that do not begin with a digit, such as comments, do not hold edges.
+        /// @param [in] line Pointer to the first character of the line.
+        /// @param [in] lineEnd Pointer to the newline character that ends the line, or one past its last character if there is none.
+        /// @param [out] edgeBuf Edge into which to place the parsed result, if parsing succeeds.
+        /// @return `true` if the line holds a valid edge, `false` otherwise.
+        static bool ParseEdgeLine(const char* const line, const char* const lineEnd, SEdge<TEdgeData>& edgeBuf);
+
+        /// Parses a decimal vertex identifier, which must begin with a digit, and advances past it.
+        /// Uses vector instructions and so may read up to 16 bytes from the starting position.
+        /// @param [in,out] position Pointer to the first digit, updated to point to the first character after the identifier.
+        /// @return Parsed vertex identifier.
+        static TVertexID ParseVertexID(const char*& position);
+
+        /// Reads a single line of a file header, truncating it if it does not fit and discarding the rest.
+        /// @param [in] graphfile File handle for the open graph file.
+        /// @param [out] linebuf Buffer to receive the line, which must hold kHeaderLineBufferSize characters.
+        /// @return `true` if a line was read, `false` at the end of the file or in the event of an error.
+        static bool ReadHeaderLine(FILE* const graphfile, char* const linebuf);
+
+
+        // -------- INSTANCE METHODS --------------------------------------- //
+
+        /// Specifies the largest number of edges that any line of the file can describe, which bounds the number of edges in each chunk.
+        /// Must not exceed kMaxEdgesPerLine.
+        /// Invoked only after the file header has been read.
+        /// The default implementation returns 1.
+        /// @return Largest number of edges per line.
+        virtual unsigned int MaxEdgesPerLine(void) const;
+
+        /// Parses a single line of text into the edges it describes.
+        /// Invoked concurrently by multiple threads when parsing in parallel, each with different lines.
+        /// The default implementation parses the line using ParseEdgeLine.
+        /// @param [in] line Pointer to the first character of the line.
+        /// @param [in] lineEnd Pointer to the newline character that ends the line, or one past its last character if there is none.
+        /// @param [out] edges Edges into which to place the parsed result, with room for kMaxEdgesPerLine edges.
+        /// @return Number of edges described by the line, which is 0 if the line does not hold a valid edge.
+        virtual unsigned int ParseEdgesFromLine(const char* const line, const char* const lineEnd, SEdge<TEdgeData>* const edges) const;
+
+        /// Reads the header at the start of the file, leaving the file positioned at the first line that may hold an edge.
+        /// Subclasses must set the numEdgesInFile and numVerticesInFile variables during this invocation, as described in "GraphReader.h".
+        /// The default implementation reads a line holding the number of vertices followed by a line holding the number of edges.
+        /// @param [in] graphfile File handle for the open graph file.
+        /// @return `true` if the header is valid, `false` otherwise.
+        virtual bool ReadGraphFileHeader(FILE* const graphfile);
+
+
     public:
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "GraphReader.h" for documentation.
 
+        virtual GraphReader<TEdgeData>* CreateShardReader(void) const;
         virtual FILE* OpenAndInitializeGraphFileForRead(const char* const filename);
-        virtual TEdgeCount ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t size);
+        virtual void ParseEdgesFromChunk(const char* const chunk, const size_t chunkSize, const size_t rangeStart, const size_t rangeEnd, std::vector<SEdge<TEdgeData>>& edges) const;
+        virtual size_t ReadChunkToBuffer(FILE* const graphfile, char* const buf, const size_t size, const TEdgeCount maxEdges);
+        virtual TEdgeCount ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count);
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        virtual bool UsesParallelParsing(void) const;
     };
 }
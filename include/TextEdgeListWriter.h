@@ -17,11 +17,13 @@
 
 #include <cstddef>
 #include <cstdio>
+#include <vector>
 
 
 namespace GraphTool
 {
     /// Writer object class for graphs represented in text edge list format.
+    /// By default, edges are formatted by all consumer threads in parallel and written to the file in order.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
     template <typename TEdgeData> class TextEdgeListWriter : public GraphWriter<TEdgeData>
     {
@@ -30,18 +32,24 @@ namespace GraphTool
 
         /// Creates a string from the edge data in the specified edge.
         /// Formatting is type-dependent, so a specialized version must be provided for each supported type.
+        /// The string is not null-terminated, and any part of it that does not fit in the provided buffer, less one character, is truncated.
         /// @param [in] edgeBuf Edge buffer of interest.
         /// @param [out] edgeDataString String representation of the edge data.
         /// @param [in] edgeDataStringCount Size of the provided string buffer, in number of characters.
-        /// @return Number of characters written, which could be zero depending on the type, and where negative indicates an error.
-        static int StringFromEdgeData(const SEdge<TEdgeData>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount);
+        /// @return Number of characters written, which could be zero depending on the type.
+        static size_t StringFromEdgeData(const SEdge<TEdgeData>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount);
         
         
     public:
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "GraphWriter.h" for documentation.
 
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
+        virtual void FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const;
         virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsParallelFormatting(void) const;
+        virtual bool SupportsStreaming(void) const;
         virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
     };
 }
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file TextFormatter.h
+ *   Declaration of fast routines for converting numbers to text.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    /// Provides conversions of numbers to text that are much faster than the `printf` family but produce exactly the same output.
+    /// Output is placed directly into a caller-supplied buffer and is not null-terminated.
+    /// All methods are thread-safe.
+    class TextFormatter
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Specifies the maximum number of characters needed to represent an unsigned 64-bit integer.
+        static const size_t kMaxUnsignedIntegerLength = 20;
+
+        /// Specifies the maximum number of digits after the decimal point that can be produced without resorting to the standard library.
+        static const unsigned int kMaxFastFixedPointPrecision = 12;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Formats a double-precision floating-point value in fixed-point notation, identically to the `%.*lf` conversion.
+        /// Rounding is exact, based on the binary value, with ties going to even.
+        /// Values whose integer part does not fit in 64 bits, infinities, NaNs, and precisions above kMaxFastFixedPointPrecision are handed off to the standard library.
+        /// @param [out] buf Buffer to which to write the text.
+        /// @param [in] bufCount Size of the buffer, in number of characters, of which the last is reserved and not used for text. Text that does not fit is truncated.
+        /// @param [in] value Value to format.
+        /// @param [in] precision Number of digits to produce after the decimal point.
+        /// @return Number of characters placed into the buffer.
+        static size_t FormatFixedPoint(char* const buf, const size_t bufCount, const double value, const unsigned int precision);
+
+        /// Formats an unsigned integer in decimal, identically to the `%llu` conversion.
+        /// @param [out] buf Buffer to which to write the text, which must be able to hold at least kMaxUnsignedIntegerLength characters.
+        /// @param [in] value Value to format.
+        /// @return Number of characters placed into the buffer.
+        static size_t FormatUnsignedInteger(char* const buf, const uint64_t value);
+
+        /// Computes the number of characters that FormatUnsignedInteger would produce for the specified value, without producing them.
+        /// @param [in] value Value of interest.
+        /// @return Number of characters in the decimal representation of the value.
+        static size_t UnsignedIntegerLength(const uint64_t value);
+    };
+}
@@ -0,0 +1,105 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file TransformPipeline.h
+ *   Declaration of a graph transformation that fuses a sequence of other
+ *   transformations into a single traversal of the graph.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphTransform.h"
+#include "Types.h"
+#include "WorkScheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace GraphTool
+{
+    class Graph;
+    class IGraphTransform;
+    class VertexIndex;
+
+    
+    /// Transformation class that applies a sequence of fusible transformations in a single traversal of the graph.
+    /// Each batch of edges passes through every transformation in the sequence, in order, while it is still in cache, and all of them run in the same parallel region.
+    /// Operates on the frozen representation, freezing the graph first if needed, and removes any edges the transformations discard in a single compaction pass per grouping.
+    /// Transformations that are part of the pipeline are not owned by it and must outlive it.
+    class TransformPipeline : public GraphTransform
+    {
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+        
+        /// Transformations to apply, in order.
+        std::vector<IGraphTransform*> stages;
+        
+        /// Temporary buffer shared among all threads, holding four locations per thread.
+        uint64_t* sharedBuf;
+        
+        /// Holds the number of edges each top-level vertex keeps once every stage has been applied.
+        /// Shared among all threads while a vertex index is being transformed.
+        TEdgeCount* keptDegrees;
+        
+        /// Hands out the vertices of each vertex index to threads, in units balanced by the number of edges they hold.
+        /// Shared among all threads while a vertex index is being transformed.
+        WorkScheduler workScheduler;
+        
+        
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+        
+        /// Default constructor.
+        TransformPipeline(void);
+        
+        
+        // -------- INSTANCE METHODS --------------------------------------- //
+        
+        /// Appends a transformation to the end of the pipeline.
+        /// @param [in] transform Transformation to append.
+        /// @return `true` if the transformation is fusible and was appended, `false` otherwise.
+        bool AppendTransform(IGraphTransform* const transform);
+        
+        /// Retrieves the number of transformations in the pipeline.
+        /// @return Number of transformations in the pipeline.
+        inline size_t GetNumStages(void) const
+        {
+            return stages.size();
+        }
+        
+        
+    private:
+        // -------- HELPERS ------------------------------------------------ //
+        
+        /// Applies every stage to all of the edges in a frozen vertex index, removing any edges that a stage discards.
+        /// Invoked by all threads in the Spindle parallelized region.
+        /// @param [in,out] vertexIndex Vertex index to transform.
+        /// @param [in] topLevelIsDestination Indicates that the vertex index groups edges by destination rather than by source.
+        /// @return Result of the operation.
+        EGraphResult TransformVertexIndex(VertexIndex& vertexIndex, const bool topLevelIsDestination);
+        
+        
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphTransform.h" for documentation.
+        
+        virtual EGraphResult TransformGraph(Graph& graph);
+        
+        
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphTransform.h" for documentation.
+        
+        virtual void BeginFusedTransformation(Graph& graph);
+        virtual bool CanFuseTransformation(void) const;
+        virtual void EndFusedTransformation(Graph& graph);
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
+        virtual size_t TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count);
+    };
+}
@@ -0,0 +1,42 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file TransposeTransform.h
+ *   Declaration of a graph transformation that reverses the direction of
+ *   every edge.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphTransform.h"
+#include "Types.h"
+
+
+namespace GraphTool
+{
+    class Graph;
+
+
+    /// Transformation class for reversing the direction of every edge in a graph.
+    /// Exchanges the source-grouped and destination-grouped representations, so it takes constant time and does not touch any vertices or edges.
+    class TransposeTransform : public GraphTransform
+    {
+    private:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphTransform.h" for documentation.
+
+        virtual bool CanParallelizeTransformation(void);
+
+
+    public:
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphTransform.h" for documentation.
+
+        virtual EGraphResult TransformGraph(Graph& graph);
+    };
+}
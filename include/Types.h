@@ -20,6 +20,9 @@ namespace GraphTool
     /// Specifies the type to use for identifying vertices.
     typedef uint64_t TVertexID;
 
+    /// Specifies the narrower type used to store vertex identifiers in compact representations, whenever all of them fit.
+    typedef uint32_t TCompactVertexID;
+
     /// Specifies the type to use for identifying edges.
     typedef uint64_t TEdgeID;
 
@@ -44,11 +47,14 @@ namespace GraphTool
     enum EEdgeDataType : int64_t
     {
         EdgeDataTypeVoid,                                                   ///< No edge data (i.e. an unweighted graph).
-        EdgeDataTypeInteger,                                                ///< Edge data are integral. Currently this means 64-bit unsigned.
-        EdgeDataTypeFloatingPoint                                           ///< Edge data are floating-point. Currently this means double-precision.
+        EdgeDataTypeInteger,                                                ///< Edge data are 64-bit unsigned integers.
+        EdgeDataTypeFloatingPoint,                                          ///< Edge data are double-precision floating-point values.
+        EdgeDataTypeInteger32,                                              ///< Edge data are 32-bit unsigned integers, held in memory in the same way as 64-bit unsigned integers.
+        EdgeDataTypeFloatingPoint32,                                        ///< Edge data are single-precision floating-point values, held in memory in the same way as double-precision values.
     };
     
     /// Holds edge data, such as a weight, using multiple possible representations.
+    /// Narrower types are widened to the representation of the same kind, so 32-bit unsigned integers are held as 64-bit unsigned integers and single-precision values as double-precision values.
     union UEdgeData
     {
         /// Edge data as an unsigned 64-bit integer.
@@ -77,6 +83,26 @@ namespace GraphTool
             return *this;
         }
         
+        /// Allows direct assignment from a primitive type.
+        /// Facilitates use of this type in templated operations.
+        /// @param [in] nu New value to set, expressed as an unsigned 32-bit integer.
+        /// @return Reference to this instance to support assignment chaining.
+        inline UEdgeData& operator=(const uint32_t nu)
+        {
+            u = (uint64_t)nu;
+            return *this;
+        }
+        
+        /// Allows direct assignment from a primitive type.
+        /// Facilitates use of this type in templated operations.
+        /// @param [in] nd New value to set, expressed as single-precision floating-point value.
+        /// @return Reference to this instance to support assignment chaining.
+        inline UEdgeData& operator=(const float nd)
+        {
+            d = (double)nd;
+            return *this;
+        }
+        
         /// Allows direct value extraction to a primitive type.
         /// Facilitates the use of this type in templated operations.
         /// @return Edge data as an unsigned 64-bit integer.
@@ -93,6 +119,22 @@ namespace GraphTool
             return d;
         }
         
+        /// Allows direct value extraction to a primitive type.
+        /// Facilitates the use of this type in templated operations.
+        /// @return Edge data as an unsigned 32-bit integer.
+        inline operator uint32_t(void) const
+        {
+            return (uint32_t)u;
+        }
+        
+        /// Allows direct value extraction to a primitive type.
+        /// Facilitates the use of this type in templated operations.
+        /// @return Edge data as a single-precision floating-point value.
+        inline operator float(void) const
+        {
+            return (float)d;
+        }
+        
         /// Invalidates the value held in this instance, effectively removing the edge data from the associated edge.
         inline void Invalidate(void)
         {
@@ -108,10 +150,11 @@ namespace GraphTool
         }
     };
 
-    /// Represents an individual edge within an index.
-    /// Contains both the other end of the edge and the edge data, such as a weight.
-    struct SIndexedEdge
+    /// Represents an individual edge within a batch of changes to an index.
+    /// Identifies the top-level vertex as well as the other end of the edge, so that a batch can be sorted in the same order as the index it changes.
+    struct SBatchEdge
     {
+        TVertexID topLevelVertex;                                           ///< Vertex identifier for the top-level vertex of the edge.
         TVertexID otherVertex;                                              ///< Vertex identifier for the other end of the edge.
         UEdgeData edgeData;                                                 ///< Edge data, such as a weight.
     };
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file VectorSparseWriter.h
+ *   Declaration of a graph writer for Grazelle's pre-packed Vector-Sparse
+ *   edge files.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GraphWriter.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    /// Writer object class for graphs represented in Grazelle's Vector-Sparse format, packed exactly as Grazelle holds it in memory so that the file can be mapped rather than parsed.
+    /// Files begin with a 32-byte header holding the number of vertices, the number of edges, the number of vectors, and 1 if edges are grouped by destination or 0 otherwise, each as a 64-bit integer.
+    /// The header is followed by the vectors, each of which holds up to four edges that share a top-level vertex in four 64-bit lanes.
+    /// Bits 47:0 of each lane hold the vertex at the other end of an edge, bit 63 is set if the lane holds an edge, and bits 62:48 of lane i hold bits 15i+14:15i of the top-level vertex, which is encoded in every lane whether or not the lane holds an edge.
+    /// Every top-level vertex begins a new vector, so it occupies as many vectors as its degree divided by four, rounded up.
+    /// In weighted files, the vectors are followed by the edge data section, which holds four edge data values per vector in the same lanes as their edges, with unused lanes holding zero.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    template <typename TEdgeData> class VectorSparseWriter : public GraphWriter<TEdgeData>
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Number of edges that each vector can hold.
+        static const unsigned int kVectorLanes = 4;
+
+
+    private:
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Position within the file at which the edge data section begins, determined when the file is opened.
+        int64_t edgeDataSectionPosition;
+
+        /// Edges that have been received but not yet packed into a vector, because more edges of the same top-level vertex are still to come.
+        SEdge<TEdgeData> pendingEdges[kVectorLanes];
+
+        /// Number of edges in the pending edges array.
+        unsigned int numPendingEdges;
+
+        /// Number of edges of the current top-level vertex that have not yet been received.
+        TEdgeCount numRemainingEdges;
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Packs the specified edges, all of which share a top-level vertex, into a vector and appends it to a buffer.
+        /// Edge data, if any, is appended to a second buffer.
+        /// @param [in,out] output Buffer to which the vector should be appended.
+        /// @param [in,out] edgeDataOutput Buffer to which the edge data should be appended.
+        /// @param [in] edges Edges to pack.
+        /// @param [in] count Number of edges to pack, between 1 and kVectorLanes.
+        /// @param [in] groupedByDestination Indicates that graph edges are grouped by destination instead of by source.
+        static void PackVector(std::vector<char>& output, std::vector<char>& edgeDataOutput, const SEdge<TEdgeData>* edges, const unsigned int count, const bool groupedByDestination);
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        VectorSparseWriter(void);
+
+
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "GraphWriter.h" for documentation.
+
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
+        virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual FILE* OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
+        virtual bool SupportsDirectIO(void) const;
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool UsesSecondaryGraphFile(void) const;
+        virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
+    };
+}
@@ -0,0 +1,202 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file VertexIDMap.h
+ *   Declaration of a concurrent hash table that maps arbitrary vertex
+ *   identifiers to dense vertex identifiers.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Types.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    /// Maps arbitrary 64-bit vertex identifiers, such as hashes or user identifiers, to dense vertex identifiers that start at 0 and are assigned consecutively.
+    /// Implemented as an open-addressing hash table with linear probing whose capacity is fixed when it is allocated, so that any number of threads can look up and insert identifiers concurrently without locks.
+    /// Each identifier not seen before receives the next dense identifier, so the order of assignment follows the order in which the threads first encounter each identifier.
+    /// The identifier `UINT64_MAX` is reserved and cannot be mapped.
+    class VertexIDMap
+    {
+    public:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Returned in place of a dense identifier when an identifier cannot be mapped.
+        static const TVertexID kInvalidID = UINT64_MAX;
+
+
+    private:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Marks a slot that does not yet hold an identifier.
+        static const TVertexID kEmptySlot = UINT64_MAX;
+
+        /// Marks a slot whose identifier has been claimed but whose dense identifier has not yet been stored.
+        static const TVertexID kPendingID = UINT64_MAX - 1;
+
+
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Holds one entry of the hash table.
+        struct SSlot
+        {
+            std::atomic<TVertexID> originalID;                              ///< Identifier being mapped, or kEmptySlot.
+            std::atomic<TVertexID> denseID;                                 ///< Dense identifier assigned to it, or kPendingID while it is being assigned.
+        };
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Slots of the hash table, of which there is always a power of two.
+        SSlot* slots;
+
+        /// Number of slots minus one, used to wrap positions within the table.
+        size_t slotMask;
+
+        /// Maximum number of identifiers that can be mapped.
+        TVertexCount maxIDs;
+
+        /// Next dense identifier to be assigned, which is also the number of identifiers that have been assigned one or have failed to be.
+        std::atomic<TVertexCount> nextDenseID;
+
+        /// Indicates that at least one identifier could not be mapped.
+        std::atomic<bool> overflowed;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor. Creates an empty map that cannot hold any identifiers until it is allocated.
+        VertexIDMap(void);
+
+        /// Destructor.
+        ~VertexIDMap(void);
+
+
+        // -------- CLASS METHODS ------------------------------------------ //
+
+        /// Estimates the memory that a map able to hold the specified number of identifiers occupies.
+        /// @param [in] maxIDs Maximum number of identifiers.
+        /// @return Estimated number of bytes.
+        static uint64_t EstimateBytes(const TVertexCount maxIDs);
+
+
+    private:
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Computes the position of the first slot to probe for the specified identifier.
+        /// Identifiers are mixed thoroughly first, so that sequential identifiers and hashes alike spread evenly over the table.
+        /// @param [in] originalID Identifier to look up.
+        /// @return Position of the first slot.
+        inline size_t HomeSlot(const TVertexID originalID) const
+        {
+            uint64_t hash = originalID;
+
+            hash ^= (hash >> 33);
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= (hash >> 33);
+            hash *= 0xc4ceb9fe1a85ec53ull;
+            hash ^= (hash >> 33);
+
+            return (size_t)hash & slotMask;
+        }
+
+
+    public:
+        // -------- INSTANCE METHODS --------------------------------------- //
+
+        /// Allocates an empty map able to hold the specified number of identifiers, destroying any existing contents.
+        /// @param [in] maxIDs Maximum number of identifiers.
+        /// @return `true` if the map was allocated, `false` otherwise.
+        bool Allocate(const TVertexCount maxIDs);
+
+        /// Looks up the dense identifier of the specified identifier, assigning it the next dense identifier if it has not been seen before.
+        /// Can be invoked concurrently by any number of threads.
+        /// @param [in] originalID Identifier to look up.
+        /// @return Dense identifier, or kInvalidID if the identifier is reserved or the map is already full, in which case the map records that it overflowed.
+        inline TVertexID FindOrInsert(const TVertexID originalID)
+        {
+            if (kEmptySlot == originalID)
+            {
+                overflowed.store(true, std::memory_order_relaxed);
+                return kInvalidID;
+            }
+
+            // Identifiers that fail to be mapped still occupy a slot, so the table can fill up once it overflows, in which case every slot has been probed.
+            size_t position = HomeSlot(originalID);
+
+            for (size_t numProbes = 0; numProbes <= slotMask; ++numProbes, position = ((position + 1) & slotMask))
+            {
+                SSlot& slot = slots[position];
+                TVertexID slotID = slot.originalID.load(std::memory_order_acquire);
+
+                // Claim an empty slot, or find out which identifier another thread claimed it for.
+                if ((kEmptySlot == slotID) && slot.originalID.compare_exchange_strong(slotID, originalID, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    const TVertexCount denseID = nextDenseID.fetch_add(1, std::memory_order_relaxed);
+
+                    if (denseID >= maxIDs)
+                    {
+                        overflowed.store(true, std::memory_order_relaxed);
+                        slot.denseID.store(kInvalidID, std::memory_order_release);
+                        return kInvalidID;
+                    }
+
+                    slot.denseID.store((TVertexID)denseID, std::memory_order_release);
+                    return (TVertexID)denseID;
+                }
+
+                if (originalID == slotID)
+                {
+                    // The thread that claimed the slot may not have stored the dense identifier yet.
+                    TVertexID denseID;
+
+                    do
+                    {
+                        denseID = slot.denseID.load(std::memory_order_acquire);
+                    } while (kPendingID == denseID);
+
+                    return denseID;
+                }
+            }
+
+            overflowed.store(true, std::memory_order_relaxed);
+            return kInvalidID;
+        }
+
+        /// Retrieves the number of identifiers that have been mapped, which is also the number of dense identifiers assigned.
+        /// Not to be invoked concurrently with insertions.
+        /// @return Number of identifiers mapped.
+        inline TVertexCount GetNumIDs(void) const
+        {
+            const TVertexCount numAssigned = nextDenseID.load(std::memory_order_relaxed);
+            return ((numAssigned < maxIDs) ? numAssigned : maxIDs);
+        }
+
+        /// Specifies if any identifier could not be mapped, either because it is reserved or because the map was full.
+        /// @return `true` if so, `false` otherwise.
+        inline bool HasOverflowed(void) const
+        {
+            return overflowed.load(std::memory_order_relaxed);
+        }
+
+        /// Releases all memory held by the map, leaving it empty.
+        void Release(void);
+
+        /// Writes the mapping to a text file, one line per dense identifier in increasing order, each holding the dense identifier followed by the identifier it replaces.
+        /// Not to be invoked concurrently with insertions.
+        /// @param [in] filename File name of the file to write.
+        /// @return Result of the operation.
+        EGraphResult WriteToFile(const char* const filename) const;
+    };
+}
@@ -13,10 +13,14 @@
 
 #pragma once
 
+#include "Arena.h"
 #include "EdgeList.h"
 #include "Types.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <vector>
 
 
@@ -24,9 +28,20 @@ namespace GraphTool
 {
     /// Indexes top-level vertices in a way optimized for fast insertion; useful for ingress.
     /// Whether the index is by source or destination is not specified by this data structure but rather is inferred based on how it is used.
+    /// Once ingress is complete, the index can be frozen into a compact representation in which all edges are held in contiguous arrays ordered by top-level vertex.
+    /// While frozen, the per-vertex edge lists do not exist, so vertex iterators and direct edge list access are unavailable.
+    /// Any non-fast modification automatically thaws the index back into its mutable representation.
+    /// Edge lists are allocated from per-thread arenas, so destroying the mutable representation releases a handful of large chunks rather than visiting every vertex.
+    /// The compact representation is partitioned by top-level vertex range across NUMA nodes, matching the ranges processed by each task of a parallelized region created by NUMASpawner.
     class VertexIndex
     {
     public:
+        // -------- CONSTANTS ---------------------------------------------- //
+        
+        /// Specifies the largest number of vertices whose identifiers can all be stored using TCompactVertexID.
+        static const TVertexCount kMaxCompactVertexCount = 1ull << 32;
+        
+        
         // -------- TYPE DEFINITIONS --------------------------------------- //
         
         /// Alias for the read-only iterator type used by this class.
@@ -43,6 +58,10 @@ namespace GraphTool
         /// Key is the vertex identifier, value is the corresponding edge list for the vertex.
         std::vector<EdgeList*> vertexIndex;
         
+        /// Holds the arenas from which edge lists and their edges are allocated.
+        /// Serial insertions use the first arena, and fast insertions use the arena that corresponds to the calling thread.
+        std::vector<Arena*> arenas;
+        
         /// Holds the total number of edges present in this data structure.
         TEdgeCount numEdges;
 
@@ -52,6 +71,48 @@ namespace GraphTool
         /// Holds the total number of Vector-Sparse vectors required to represent the edges in this data structure.
         uint64_t numVectors;
         
+        /// Holds the number of top-level vertices while the index is frozen, at which point the mutable vertex index is empty.
+        TVertexCount numFrozenVertices;
+        
+        /// Holds the position of the first edge of each top-level vertex within the frozen arrays, plus one past-the-end element.
+        /// `NULL` unless the index is frozen.
+        TEdgeCount* frozenOffsets;
+        
+        /// Holds the vertex at the other end of each edge, grouped by top-level vertex.
+        /// Elements are of type TCompactVertexID if the frozen neighbors are compact and of type TVertexID otherwise.
+        /// `NULL` unless the index is frozen.
+        void* frozenNeighbors;
+        
+        /// Specifies that the frozen neighbor array holds identifiers of type TCompactVertexID, which is the case whenever every vertex identifier fits.
+        bool frozenNeighborsCompact;
+        
+        /// Holds the data for each edge, parallel to the frozen neighbor array.
+        /// `NULL` unless the index is frozen and edge data are being kept.
+        UEdgeData* frozenEdgeData;
+        
+        /// Holds the start of the region of a snapshot file mapped into memory, if the frozen arrays were adopted from one.
+        /// Frozen arrays that lie within this region are not released individually, and the region is unmapped once none of them remain within it.
+        /// `NULL` unless the frozen arrays were adopted from a snapshot file.
+        void* frozenMapping;
+        
+        /// Holds the size, in bytes, of the region of a snapshot file mapped into memory.
+        size_t frozenMappingSize;
+        
+        /// Holds, for each top-level vertex, either its degree or the position at which its next edge is to be placed, during preallocated ingress.
+        /// `NULL` unless preallocated ingress is in progress.
+        TEdgeCount* preallocatedCursors;
+        
+        /// Specifies that the edges of each top-level vertex in the frozen representation are sorted in ascending order of the other vertex.
+        /// Allows edge lookups to use binary search.
+        bool frozenSorted;
+        
+        /// Holds the first top-level vertex of each range whose portion of the frozen arrays is placed on a single NUMA node, in ascending order.
+        /// Ranges match those that a parallelized region spanning all NUMA nodes assigns to each of its tasks at the time of freezing.
+        std::vector<uint64_t> frozenPartitionStarts;
+        
+        /// Holds the NUMA node on which each range in the frozen partition is placed.
+        std::vector<uint32_t> frozenPartitionNUMANodes;
+        
         
     public:
         // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
@@ -60,13 +121,129 @@ namespace GraphTool
         VertexIndex(void);
 
         /// Destructor.
-        /// Destroys all edge lists.
+        /// Destroys all edge lists by releasing the arenas that hold them.
         ~VertexIndex(void);
 
 
+        // -------- CLASS METHODS ------------------------------------------ //
+        
+        /// Estimates the memory needed to hold the specified edges in the compact representation, including the offsets array.
+        /// @param [in] numVertices Number of top-level vertices.
+        /// @param [in] otherVertexLimit Exclusive upper bound on the identifiers of the vertices at the other end of each edge, which determines whether neighbors are stored compactly.
+        /// @param [in] numEdges Number of edges.
+        /// @param [in] keepEdgeData Specifies that edge data are held alongside each edge.
+        /// @return Estimated number of bytes.
+        static uint64_t EstimateFrozenBytes(const TVertexCount numVertices, const TVertexCount otherVertexLimit, const TEdgeCount numEdges, const bool keepEdgeData);
+        
+        /// Estimates the memory needed to hold the specified edges in the mutable representation, including the edge lists and the index that points to them.
+        /// Assumes each top-level vertex that has edges gets its own edge list, whose blocks of edges are allocated from arenas.
+        /// @param [in] numVertices Number of top-level vertices.
+        /// @param [in] numEdges Number of edges.
+        /// @param [in] keepEdgeData Specifies that edge data are held alongside each edge.
+        /// @return Estimated number of bytes.
+        static uint64_t EstimateMutableBytes(const TVertexCount numVertices, const TEdgeCount numEdges, const bool keepEdgeData);
+        
+        /// Estimates the memory needed, in addition to the compact representation, for the degree counts kept during preallocated ingress.
+        /// @param [in] numVertices Number of top-level vertices.
+        /// @return Estimated number of bytes.
+        static uint64_t EstimatePreallocatedIngressBytes(const TVertexCount numVertices);
+        
+
+
+    private:
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Allocates one of the frozen arrays, placing each partition's portion of it on that partition's NUMA node.
+        /// Memory is obtained from Silo and must be released using `siloFree`.
+        /// @param [in] elementSize Size, in bytes, of each array element.
+        /// @param [in] partitionStarts Position of the first array element belonging to each partition.
+        /// @param [in] numElements Total number of array elements.
+        /// @return Pointer to the allocated array, which holds at least one element even if the requested number is zero.
+        void* AllocateFrozenArray(const size_t elementSize, const std::vector<uint64_t>& partitionStarts, const uint64_t numElements) const;
+        
+        /// Allocates the frozen neighbor array, and optionally the edge data array, placed according to the frozen partition.
+        /// The neighbor array is made compact if every vertex identifier fits in TCompactVertexID.
+        /// The frozen offsets must already be allocated and completely filled in.
+        /// @param [in] numVertices Number of top-level vertices in the frozen offsets array.
+        /// @param [in] otherVertexLimit Exclusive upper bound on the identifiers of the vertices at the other end of each edge.
+        /// @param [in] keepEdgeData Specifies that the edge data array should also be allocated.
+        void AllocateFrozenEdges(const TVertexCount numVertices, const TVertexCount otherVertexLimit, const bool keepEdgeData);
+        
+        /// Partitions the specified number of top-level vertices across NUMA nodes and allocates the frozen offsets array accordingly.
+        /// @param [in] numVertices Number of top-level vertices.
+        void AllocateFrozenOffsets(const TVertexCount numVertices);
+        
+        /// Copies a block of edges from the frozen arrays of the specified index into the frozen arrays of this index, regardless of the element width of either neighbor array.
+        /// Edge data are invalidated if they are to be kept but the specified index holds none.
+        /// @param [in] destinationPosition Position in this index to which the first edge is copied.
+        /// @param [in] index Frozen index from which to copy, which must be different from this index.
+        /// @param [in] sourcePosition Position in the specified index from which the first edge is copied.
+        /// @param [in] count Number of edges to copy.
+        /// @param [in] keepEdgeData Specifies that edge data should also be copied.
+        void CopyFrozenEdges(const TEdgeID destinationPosition, const VertexIndex& index, const TEdgeID sourcePosition, const TEdgeCount count, const bool keepEdgeData);
+        
+        /// Retrieves the arena to be used for serial insertions, creating it if it does not already exist.
+        /// @return Arena for serial insertions.
+        Arena& GetSerialArena(void);
+
+        /// Releases all arenas, thus destroying every edge list in the mutable representation.
+        /// The mutable vertex index itself is not modified, so the caller is responsible for clearing any pointers it holds.
+        void ReleaseArenas(void);
+        
+        /// Releases a single frozen array, unless it lies within the mapped region of a snapshot file, which is instead released as a whole by ReleaseFrozenMapping.
+        /// @param [in] frozenArray Frozen array to release.
+        void ReleaseFrozenArray(const void* const frozenArray);
+        
+        /// Releases the frozen arrays, if they exist, but does not otherwise modify the frozen representation's metadata.
+        void ReleaseFrozenArrays(void);
+        
+        /// Unmaps the region of a snapshot file from which the frozen arrays were adopted, if it is mapped and none of the current frozen arrays lie within it.
+        void ReleaseFrozenMapping(void);
+        
+        /// Determines if the specified array lies within the mapped region of a snapshot file.
+        /// @param [in] frozenArray Array to check.
+        /// @return `true` if so, `false` otherwise.
+        inline bool IsWithinFrozenMapping(const void* const frozenArray) const
+        {
+            return ((NULL != frozenMapping) && ((const uint8_t*)frozenArray >= (const uint8_t*)frozenMapping) && ((const uint8_t*)frozenArray < ((const uint8_t*)frozenMapping + frozenMappingSize)));
+        }
+        
+        /// Moves a block of elements within the frozen neighbor array, which may overlap, regardless of its element width.
+        /// @param [in] destinationPosition Position to which the first element is moved.
+        /// @param [in] sourcePosition Position from which the first element is moved.
+        /// @param [in] count Number of elements to move.
+        inline void MoveFrozenNeighbors(const TEdgeID destinationPosition, const TEdgeID sourcePosition, const TEdgeCount count)
+        {
+            const size_t elementSize = (frozenNeighborsCompact ? sizeof(TCompactVertexID) : sizeof(TVertexID));
+            memmove((void*)((uint8_t*)frozenNeighbors + (elementSize * destinationPosition)), (void*)((uint8_t*)frozenNeighbors + (elementSize * sourcePosition)), elementSize * count);
+        }
+        
+        /// Stores the vertex at the other end of the edge at the specified position in the frozen neighbor array, narrowing it if the neighbors are compact.
+        /// @param [in] position Position of the edge within the frozen edge arrays.
+        /// @param [in] otherVertex Vertex to store.
+        inline void SetFrozenNeighbor(const TEdgeID position, const TVertexID otherVertex)
+        {
+            if (frozenNeighborsCompact)
+                ((TCompactVertexID*)frozenNeighbors)[position] = (TCompactVertexID)otherVertex;
+            else
+                ((TVertexID*)frozenNeighbors)[position] = otherVertex;
+        }
+        
+        /// Stores edge data from the specified edge into the frozen edge data array.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] position Position of the edge within the frozen edge arrays.
+        /// @param [in] edge Edge to use as the data source.
+        template <typename TEdgeData> inline void StoreFrozenEdgeData(const TEdgeID position, const SEdge<TEdgeData>& edge)
+        {
+            frozenEdgeData[position] = edge.edgeData;
+        }
+
+
+    public:
         // -------- OPERATORS ---------------------------------------------- //
         
         /// Faciliates read-only access to the vertex index.
+        /// Not available while the index is frozen.
         inline const EdgeList*& operator[](size_t n) const
         {
             return (const EdgeList*&)vertexIndex[n];
@@ -74,6 +251,26 @@ namespace GraphTool
         
         
         // -------- INSTANCE METHODS --------------------------------------- //
+        
+        /// Makes this index frozen using arrays that lie within a region of a snapshot file mapped into memory, without copying them.
+        /// Any existing contents are destroyed first. The index takes ownership of the mapped region, which must be writable but need not be shared with the file, so transformations can modify the frozen arrays in place.
+        /// The frozen partition is computed the same way as by ParallelFreeze, although the mapped arrays themselves are placed wherever the operating system places the pages of the file.
+        /// @param [in] mapping Start of the mapped region.
+        /// @param [in] mappingSize Size, in bytes, of the mapped region.
+        /// @param [in] numVertices Number of top-level vertices.
+        /// @param [in] numVerticesPresent Number of top-level vertices having at least one edge.
+        /// @param [in] numVectors Number of Vector-Sparse vectors required to represent the edges.
+        /// @param [in] offsets Frozen offset array, which must lie within the mapped region.
+        /// @param [in] neighbors Frozen neighbor array, which must lie within the mapped region.
+        /// @param [in] neighborsCompact Specifies that the neighbor array holds identifiers of type TCompactVertexID.
+        /// @param [in] edgeData Frozen edge data array, which must lie within the mapped region, or `NULL` if there are no edge data.
+        /// @param [in] sorted Specifies that the edges of each top-level vertex are sorted by the vertex at the other end.
+        void AdoptFrozenMapping(void* const mapping, const size_t mappingSize, const TVertexCount numVertices, const TVertexCount numVerticesPresent, const uint64_t numVectors, TEdgeCount* const offsets, void* const neighbors, const bool neighborsCompact, UEdgeData* const edgeData, const bool sorted);
+        
+        /// Allocates storage for edge data in whichever representation the index currently uses, if it does not already exist.
+        /// Intended for transformations that add edge data to a graph that was read without any.
+        /// Newly-allocated edge data are all invalid.
+        void AllocateEdgeData(void);
 
         /// Returns a read-only iterator for the beginning of the vertex index.
         /// @return Read-only iterator to the beginning of the vertex index.
@@ -90,6 +287,10 @@ namespace GraphTool
             return vertexIndex.begin();
         }
 
+        /// Destroys the entire contents of this index, whichever representation they are in, leaving it empty and mutable.
+        /// Unlike setting the number of vertices to zero, a frozen index is not thawed first.
+        void Clear(void);
+        
         /// Returns a read-only iterator for the end of the vertex index.
         /// @return Read-only iterator for the end of the vertex index.
         inline VertexIterator EndIterator(void) const
@@ -105,15 +306,35 @@ namespace GraphTool
             return vertexIndex.end();
         }
 
+        /// Counts the specified edge towards the degree of its destination vertex during the first pass of preallocated ingress.
+        /// Can be invoked from multiple threads, so long as each thread updates a different top-level vertex.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] edge Edge to count.
+        template <typename TEdgeData> inline void FastCountEdgeIndexedByDestination(const SEdge<TEdgeData>& edge)
+        {
+            preallocatedCursors[edge.destinationVertex] += 1;
+        }
+        
+        /// Counts the specified edge towards the degree of its source vertex during the first pass of preallocated ingress.
+        /// Can be invoked from multiple threads, so long as each thread updates a different top-level vertex.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] edge Edge to count.
+        template <typename TEdgeData> inline void FastCountEdgeIndexedBySource(const SEdge<TEdgeData>& edge)
+        {
+            preallocatedCursors[edge.sourceVertex] += 1;
+        }
+        
         /// Performs a simple and fast insertion of the specified edge into this data structure, using the destination as the top-level vertex.
         /// Does not update any internal counters for vectors or edges.
         /// Can be invoked from multiple threads, so long as each thread updates a different top-level vertex.
+        /// Requires that arenas first be initialized for all calling threads.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] edge Edge to insert.
-        template <typename TEdgeData> inline void FastInsertEdgeIndexedByDestination(const SEdge<TEdgeData>& edge)
+        /// @param [in] threadID Local thread identifier of the calling thread, used to select an arena.
+        template <typename TEdgeData> inline void FastInsertEdgeIndexedByDestination(const SEdge<TEdgeData>& edge, const uint32_t threadID)
         {
             if (NULL == vertexIndex[edge.destinationVertex])
-                vertexIndex[edge.destinationVertex] = new EdgeList();
+                vertexIndex[edge.destinationVertex] = EdgeList::CreateInArena(*arenas[threadID], !std::is_void<TEdgeData>::value);
             
             vertexIndex[edge.destinationVertex]->InsertEdgeUsingSource(edge);
         }
@@ -121,26 +342,143 @@ namespace GraphTool
         /// Performs a simple and fast insertion of the specified edge into this data structure, using the source as the top-level vertex.
         /// Does not update any internal counters for vectors or edges.
         /// Can be invoked from multiple threads, so long as each thread updates a different top-level vertex.
+        /// Requires that arenas first be initialized for all calling threads.
         /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
         /// @param [in] edge Edge to insert.
-        template <typename TEdgeData> inline void FastInsertEdgeIndexedBySource(const SEdge<TEdgeData>& edge)
+        /// @param [in] threadID Local thread identifier of the calling thread, used to select an arena.
+        template <typename TEdgeData> inline void FastInsertEdgeIndexedBySource(const SEdge<TEdgeData>& edge, const uint32_t threadID)
         {
             if (NULL == vertexIndex[edge.sourceVertex])
-                vertexIndex[edge.sourceVertex] = new EdgeList();
+                vertexIndex[edge.sourceVertex] = EdgeList::CreateInArena(*arenas[threadID], !std::is_void<TEdgeData>::value);
             
             vertexIndex[edge.sourceVertex]->InsertEdgeUsingDestination(edge);
         }
         
+        /// Places the specified edge directly into its preallocated slot during the second pass of preallocated ingress, using the destination as the top-level vertex.
+        /// Edges of each top-level vertex are placed in the order in which they are supplied.
+        /// Can be invoked from multiple threads, so long as each thread updates a different top-level vertex.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] edge Edge to place.
+        template <typename TEdgeData> inline void FastScatterEdgeIndexedByDestination(const SEdge<TEdgeData>& edge)
+        {
+            const TEdgeID position = preallocatedCursors[edge.destinationVertex]++;
+            
+            SetFrozenNeighbor(position, edge.sourceVertex);
+            StoreFrozenEdgeData(position, edge);
+        }
+        
+        /// Places the specified edge directly into its preallocated slot during the second pass of preallocated ingress, using the source as the top-level vertex.
+        /// Edges of each top-level vertex are placed in the order in which they are supplied.
+        /// Can be invoked from multiple threads, so long as each thread updates a different top-level vertex.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] edge Edge to place.
+        template <typename TEdgeData> inline void FastScatterEdgeIndexedBySource(const SEdge<TEdgeData>& edge)
+        {
+            const TEdgeID position = preallocatedCursors[edge.sourceVertex]++;
+            
+            SetFrozenNeighbor(position, edge.destinationVertex);
+            StoreFrozenEdgeData(position, edge);
+        }
+        
+        /// Fills in an edge structure with information exported from the specified position in the frozen edge arrays.
+        /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+        /// @param [in] position Position of the edge within the frozen edge arrays.
+        /// @param [out] edge Edge structure to fill.
+        /// @param [in] topLevelVertex Top-level vertex to place into the edge structure.
+        /// @param [in] topLevelIsDestination Specifies that the top-level vertex should be treated as the destination vertex, rather than the source vertex.
+        template <typename TEdgeData> inline void FillFrozenEdge(const TEdgeID position, SEdge<TEdgeData>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const
+        {
+            if (topLevelIsDestination)
+            {
+                edge.destinationVertex = topLevelVertex;
+                edge.sourceVertex = GetFrozenNeighbor(position);
+            }
+            else
+            {
+                edge.destinationVertex = GetFrozenNeighbor(position);
+                edge.sourceVertex = topLevelVertex;
+            }
+
+            edge.edgeData = frozenEdgeData[position];
+        }
+        
         /// Returns the degree of a specific vertex.
         /// @return Degree of the specified vertex.
         inline TEdgeCount GetDegree(TVertexID vertex) const
         {
+            if (IsFrozen())
+                return ((vertex < numFrozenVertices) ? (frozenOffsets[vertex + 1] - frozenOffsets[vertex]) : 0);
+            
             if (NULL != vertexIndex.at(vertex))
                 return vertexIndex.at(vertex)->GetDegree();
             else
                 return 0;
         }
         
+        /// Provides read-only access to the frozen per-edge data array.
+        /// @return Pointer to the edge data array, or `NULL` if the index is not frozen or holds no edge data.
+        inline const UEdgeData* GetFrozenEdgeData(void) const
+        {
+            return frozenEdgeData;
+        }
+        
+        /// Provides writable access to the frozen per-edge data array.
+        /// Intended for use by transformation objects.
+        /// @return Pointer to the edge data array, or `NULL` if the index is not frozen or holds no edge data.
+        inline UEdgeData* GetFrozenEdgeDataWritable(void)
+        {
+            return frozenEdgeData;
+        }
+        
+        /// Retrieves the vertex at the other end of the edge at the specified position in the frozen edge arrays, widening it if the neighbors are compact.
+        /// @param [in] position Position of the edge within the frozen edge arrays.
+        /// @return Vertex at the other end of the edge.
+        inline TVertexID GetFrozenNeighbor(const TEdgeID position) const
+        {
+            if (frozenNeighborsCompact)
+                return (TVertexID)((const TCompactVertexID*)frozenNeighbors)[position];
+            else
+                return ((const TVertexID*)frozenNeighbors)[position];
+        }
+        
+        /// Provides read-only access to the frozen neighbor array, for indices whose neighbors are not compact.
+        /// @return Pointer to the neighbor array, or `NULL` if the index is not frozen or its neighbors are compact.
+        inline const TVertexID* GetFrozenNeighbors(void) const
+        {
+            return (frozenNeighborsCompact ? NULL : (const TVertexID*)frozenNeighbors);
+        }
+        
+        /// Provides read-only access to the frozen neighbor array, for indices whose neighbors are compact.
+        /// @return Pointer to the neighbor array, or `NULL` if the index is not frozen or its neighbors are not compact.
+        inline const TCompactVertexID* GetFrozenNeighborsCompact(void) const
+        {
+            return (frozenNeighborsCompact ? (const TCompactVertexID*)frozenNeighbors : NULL);
+        }
+        
+        /// Provides writable access to the frozen neighbor array, for indices whose neighbors are compact.
+        /// Intended for use by transformation objects, which must keep the edge data array consistent with any reordering.
+        /// @return Pointer to the neighbor array, or `NULL` if the index is not frozen or its neighbors are not compact.
+        inline TCompactVertexID* GetFrozenNeighborsCompactWritable(void)
+        {
+            return (frozenNeighborsCompact ? (TCompactVertexID*)frozenNeighbors : NULL);
+        }
+        
+        /// Provides writable access to the frozen neighbor array, for indices whose neighbors are not compact.
+        /// Intended for use by transformation objects, which must keep the edge data array consistent with any reordering.
+        /// @return Pointer to the neighbor array, or `NULL` if the index is not frozen or its neighbors are compact.
+        inline TVertexID* GetFrozenNeighborsWritable(void)
+        {
+            return (frozenNeighborsCompact ? NULL : (TVertexID*)frozenNeighbors);
+        }
+        
+        /// Provides read-only access to the frozen offset array, which has one more element than there are top-level vertices.
+        /// The edges of top-level vertex `v` occupy positions `offsets[v]` up to, but not including, `offsets[v + 1]`.
+        /// @return Pointer to the offset array, or `NULL` if the index is not frozen.
+        inline const TEdgeCount* GetFrozenOffsets(void) const
+        {
+            return frozenOffsets;
+        }
+        
         /// Returns the total number of edges in the index.
         /// @return Total number of edges.
         inline TEdgeCount GetNumEdges(void) const
@@ -159,7 +497,7 @@ namespace GraphTool
         /// @return Number of indexed vertices.
         inline TVertexCount GetNumVertices(void) const
         {
-            return vertexIndex.size();
+            return (IsFrozen() ? numFrozenVertices : vertexIndex.size());
         }
 
         /// Returns the number of top-level vertices in the index having a valid edge list associated with them.
@@ -179,13 +517,133 @@ namespace GraphTool
         /// @param [in] edge Edge to insert.
         template <typename TEdgeData> void InsertEdgeIndexedBySource(const SEdge<TEdgeData>& edge);
 
+        /// Specifies if this index is currently frozen into its compact representation.
+        /// @return `true` if so, `false` otherwise.
+        inline bool IsFrozen(void) const
+        {
+            return (NULL != frozenOffsets);
+        }
+        
+        /// Specifies if this index is frozen with the edges of each top-level vertex sorted by other vertex.
+        /// @return `true` if so, `false` otherwise.
+        inline bool IsFrozenSorted(void) const
+        {
+            return (IsFrozen() && frozenSorted);
+        }
+        
+        /// Records that the edges of each top-level vertex in the frozen representation have been sorted by other vertex.
+        /// Intended for use by transformation objects that sort edges.
+        /// Has no effect if the index is not frozen.
+        inline void MarkFrozenSorted(void)
+        {
+            frozenSorted = IsFrozen();
+        }
+        
+        /// Replaces the contents of this index with a frozen representation that holds the specified degrees but no edges, so that it describes the shape of a graph whose edges are held elsewhere.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// Only the offsets are allocated, so the number of vertices, the number of edges, and the degree of each top-level vertex are available, but the edges themselves cannot be accessed, modified, or thawed.
+        /// Metadata are computed from the degrees along the way, so they need not be refreshed.
+        /// @param [in] degrees Degree of each top-level vertex.
+        /// @param [in] numVertices Number of top-level vertices.
+        /// @param [in] buf Temporary array allocated with four locations per thread in the region.
+        void ParallelAdoptDegrees(const TEdgeCount* degrees, const TVertexCount numVertices, uint64_t* buf);
+
+        /// Allocates the compact representation using the degrees counted during the first pass of preallocated ingress.
+        /// Intended to be called from within a Spindle parallelized region, by all threads of the calling task.
+        /// The compact representation is partitioned across NUMA nodes the same way as by ParallelFreeze, regardless of where the calling task runs.
+        /// Once this method returns, the index is frozen, and edges can be placed into it using the fast scatter methods.
+        /// @param [in] keepEdgeData Specifies that edge data should be kept in the compact representation.
+        /// @param [in] buf Temporary array allocated with one location per thread.
+        void ParallelAllocateFromDegrees(const bool keepEdgeData, uint64_t* buf);
+        
+        /// Replaces the contents of this index with the edges of the specified frozen index, less the specified deletions and plus the specified insertions.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// Each deletion removes every edge between its two vertices, including duplicates, and deletions are applied before insertions, so deleting and inserting the same edge replaces it.
+        /// Top-level vertices without changes have their edges copied as a block. If the specified index is sorted, insertions are merged into place so that the result is also sorted; otherwise they follow the remaining edges of their top-level vertex.
+        /// The result is frozen and partitioned across NUMA nodes the same way as by ParallelFreeze, and its metadata are up to date.
+        /// @param [in] index Frozen index to update, which must be different from this index.
+        /// @param [in] insertions Edges to insert, sorted by top-level vertex and then by other vertex.
+        /// @param [in] numInsertions Number of edges to insert.
+        /// @param [in] deletions Edges to delete, sorted the same way as the insertions. Edge data are ignored.
+        /// @param [in] numDeletions Number of edges to delete.
+        /// @param [in] numVertices Number of top-level vertices in the result, which must be at least the number in the specified index and greater than every vertex identifier in the insertions.
+        /// @param [in] keepEdgeData Specifies that edge data should be kept in the updated representation.
+        /// @param [in] buf Temporary array allocated with four locations per thread in the region.
+        void ParallelApplyBatchFrozen(const VertexIndex& index, const SBatchEdge* insertions, const TEdgeCount numInsertions, const SBatchEdge* deletions, const TEdgeCount numDeletions, const TVertexCount numVertices, const bool keepEdgeData, uint64_t* buf);
+        
+        /// Prepares this index for preallocated ingress, in which edges are placed directly into the compact representation.
+        /// Any existing contents of the index are destroyed.
+        /// Intended to be called from within a Spindle parallelized region.
+        /// Once this method returns, edges can be counted using the fast count methods.
+        /// @param [in] numVertices Number of top-level vertices, all of which must have identifiers less than this value.
+        void ParallelBeginPreallocatedIngress(const TVertexCount numVertices);
+        
+        /// Completes preallocated ingress once all edges have been placed.
+        /// Intended to be called from within a Spindle parallelized region.
+        /// Metadata must subsequently be refreshed.
+        void ParallelEndPreallocatedIngress(void);
+        
+        /// Shrinks the frozen representation so that each top-level vertex keeps only a prefix of its edges.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region, after edges have been reordered so that those to be kept come first.
+        /// Metadata are updated from the kept degrees along the way, so they need not be refreshed.
+        /// @param [in] keptDegrees Number of edges to keep for each top-level vertex, none of which may exceed that vertex's current degree.
+        /// @param [in] buf Temporary array allocated with four locations per thread in the region.
+        void ParallelCompactFrozen(const TEdgeCount* keptDegrees, uint64_t* buf);
+        
+        /// Freezes this index into its compact representation, destroying all edge lists in the process.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// The frozen arrays are partitioned by top-level vertex range across NUMA nodes, and each task fills in the partition on its own node.
+        /// Has no effect if the index is already frozen.
+        /// @param [in] keepEdgeData Specifies that edge data should be kept in the frozen representation.
+        /// @param [in] otherVertexLimit Exclusive upper bound on the identifiers of the vertices at the other end of each edge, which determines whether the frozen neighbors can be compact.
+        /// @param [in] buf Temporary array allocated with one location per thread in the region.
+        void ParallelFreeze(const bool keepEdgeData, const TVertexCount otherVertexLimit, uint64_t* buf);
+        
+        /// Ensures that an arena exists for each thread in the calling Spindle parallelized region.
+        /// Must be called before any fast insertion methods are invoked.
+        /// @param [in] numaNode NUMA node on which any newly-created arenas should allocate memory.
+        void ParallelInitializeArenas(const uint32_t numaNode);
+        
         /// Refreshes metadata, such as degree information.
         /// Intended to be called from within a Spindle parallelized region.
         /// Required after invoking fast insertion methods, which do not update any counts.
         /// @param [in] buf Temporary array allocated with four locations per thread.
         void ParallelRefreshMetadata(uint64_t* buf);
         
+        /// Renumbers every vertex in the frozen representation, moving the edges of each top-level vertex to its new position and renaming the vertex at the other end of each edge.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// The result is frozen and partitioned across NUMA nodes the same way as by ParallelFreeze. The edges of each top-level vertex keep their relative order, so they are no longer sorted, but metadata are otherwise unchanged.
+        /// Has no effect if the index is not frozen.
+        /// @param [in] newIDs New identifier of each vertex, indexed by its current identifier, forming a permutation of all identifiers less than the specified number of vertices.
+        /// @param [in] oldIDs Current identifier of each vertex, indexed by its new identifier, which is the inverse of the other permutation.
+        /// @param [in] numVertices Number of vertices in the permutation, which becomes the number of top-level vertices. It may be less than the current number only if the vertices left out have no edges and are not the neighbor of any edge.
+        /// @param [in] buf Temporary array allocated with one location per thread in the region.
+        void ParallelRelabelFrozen(const TVertexID* newIDs, const TVertexID* oldIDs, const TVertexCount numVertices, uint64_t* buf);
+        
+        /// Replaces the contents of this index with the edges of the specified frozen index plus, for each of its edges, the edge in the opposite direction.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// The edges of each top-level vertex are those of the specified index followed by those of its transpose, except for self-loops in the transpose, which already appear in the specified index.
+        /// Edges that appear in both directions in the specified index are therefore duplicated, with the original edge placed first.
+        /// The result is frozen and partitioned across NUMA nodes the same way as by ParallelFreeze, and its metadata are up to date.
+        /// @param [in] index Frozen index whose edges are to be symmetrized, which must be different from this index.
+        /// @param [in] transposeIndex Frozen transpose of the specified index, such as the other grouping of the same graph, which must be different from this index.
+        /// @param [in] keepEdgeData Specifies that edge data should be copied into the symmetrized representation.
+        /// @param [in] buf Temporary array allocated with four locations per thread in the region.
+        void ParallelSymmetrizeFrozen(const VertexIndex& index, const VertexIndex& transposeIndex, const bool keepEdgeData, uint64_t* buf);
+        
+        /// Replaces the contents of this index with the transpose of the specified frozen index, so that each of its edges is grouped by the vertex at the other end.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region.
+        /// The result is frozen and partitioned across NUMA nodes the same way as by ParallelFreeze, and its metadata are up to date.
+        /// Edges of each top-level vertex are placed in ascending order of the other vertex, with duplicates kept in their order within the specified index.
+        /// @param [in] otherIndex Frozen index to transpose, in which every vertex at the other end of an edge must have an identifier less than its number of top-level vertices.
+        /// @param [in] keepEdgeData Specifies that edge data should be copied into the transposed representation.
+        /// @param [in] edgeBuf Temporary array allocated with two locations per edge in the specified index.
+        /// @param [in] buf Temporary array allocated with four locations per thread in the region, plus one location per pair of threads.
+        void ParallelTransposeFrom(const VertexIndex& otherIndex, const bool keepEdgeData, uint64_t* edgeBuf, uint64_t* buf);
+        
         /// Removes the specified edge from this data structure.
+        /// All edges between the two vertices are removed, including any duplicates.
+        /// A frozen index remains frozen: the edge is located by binary search if the index is sorted, and later edges are shifted down to close the gap.
         /// @param [in] indexedVertex Top-level vertex to which the edge corresponds.
         /// @param [in] otherVertex Vertex at the other end of the edge to remove.
         void RemoveEdge(const TVertexID indexedVertex, const TVertexID otherVertex);
@@ -195,9 +653,57 @@ namespace GraphTool
         /// @param [in] indexedVertex Top-level vertex to remove.
         void RemoveVertex(const TVertexID indexedVertex);
         
+        /// Removes the specified top-level vertex, as well as every edge in which it appears as the other vertex, from the frozen representation.
+        /// Requires a single pass over the frozen arrays, regardless of the number of edges removed.
+        /// Has no effect if the index is not frozen.
+        /// @param [in] vertex Vertex to remove.
+        void RemoveVertexAndReferencesFrozen(const TVertexID vertex);
+        
         /// Sets the number of indexed vertices.
         /// Constructs new vertices or destroys existing ones as appropriate.
         /// @param [in] numVertices Number of vertices.
         void SetNumVertices(const TVertexCount numVertices);
+        
+        /// Reduces the number of top-level vertices during the first pass of preallocated ingress, before the compact representation is allocated.
+        /// Every vertex removed must have no edges counted. Has no effect if the index already has no more than the specified number of vertices.
+        /// @param [in] numVertices New number of top-level vertices.
+        inline void ShrinkPreallocatedIngress(const TVertexCount numVertices)
+        {
+            if (numVertices < numFrozenVertices)
+                numFrozenVertices = numVertices;
+        }
+        
+        /// Exchanges the contents of this index with those of the specified index, in either representation, without copying any vertices or edges.
+        /// Metadata are exchanged along with the contents, so they remain correct.
+        /// @param [in,out] other Index with which to exchange contents.
+        void Swap(VertexIndex& other);
+        
+        /// Converts this index from its frozen representation back to its mutable representation.
+        /// Has no effect if the index is not frozen.
+        void Thaw(void);
     };
+    
+    
+    // -------- EXPLICIT SPECIALIZATIONS ----------------------------------- //
+    
+    template <> inline void VertexIndex::StoreFrozenEdgeData(const TEdgeID position, const SEdge<void>& edge)
+    {
+        // Nothing to do here.
+    }
+    
+    // --------
+    
+    template <> inline void VertexIndex::FillFrozenEdge(const TEdgeID position, SEdge<void>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const
+    {
+        if (topLevelIsDestination)
+        {
+            edge.destinationVertex = topLevelVertex;
+            edge.sourceVertex = GetFrozenNeighbor(position);
+        }
+        else
+        {
+            edge.destinationVertex = GetFrozenNeighbor(position);
+            edge.sourceVertex = topLevelVertex;
+        }
+    }
 }
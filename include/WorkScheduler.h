@@ -0,0 +1,157 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file WorkScheduler.h
+ *   Declaration of a scheduler that divides the vertices of a frozen vertex
+ *   index among threads by the number of edges they hold.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Types.h"
+
+#include <atomic>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    /// Describes a unit of work handed out by a WorkScheduler, which is a range of consecutive top-level vertices and the part of their edges that belongs to the unit.
+    struct SWorkUnit
+    {
+        TVertexID vertexStart;                                              ///< First top-level vertex in the unit.
+        TVertexID vertexEnd;                                                ///< One past the last top-level vertex in the unit.
+        TEdgeID edgeStart;                                                  ///< Position of the first edge in the unit, within the frozen edge arrays.
+        TEdgeID edgeEnd;                                                    ///< Position one past the last edge in the unit, within the frozen edge arrays.
+
+        /// Determines the position of the first edge of the specified vertex that belongs to the unit.
+        /// @param [in] offsets Frozen offsets from which the unit was computed.
+        /// @param [in] vertex Top-level vertex within the unit.
+        /// @return Position of the first edge.
+        inline TEdgeID FirstEdge(const TEdgeCount* const offsets, const TVertexID vertex) const
+        {
+            return ((offsets[vertex] > edgeStart) ? offsets[vertex] : edgeStart);
+        }
+
+        /// Determines the position one past the last edge of the specified vertex that belongs to the unit.
+        /// @param [in] offsets Frozen offsets from which the unit was computed.
+        /// @param [in] vertex Top-level vertex within the unit.
+        /// @return Position one past the last edge.
+        inline TEdgeID LastEdge(const TEdgeCount* const offsets, const TVertexID vertex) const
+        {
+            return ((offsets[vertex + 1] < edgeEnd) ? offsets[vertex + 1] : edgeEnd);
+        }
+    };
+
+
+    /// Hands out the top-level vertices of a frozen vertex index to the threads of a Spindle parallelized region created by NUMASpawner, in units sized by the amount of work they hold rather than by their number of vertices.
+    /// Work is measured using the frozen offsets, which are already a prefix sum of the degrees, so units are found by binary search without visiting every vertex.
+    /// Each task is responsible for the vertices stored on its own NUMA node, which it divides into units that its threads initially own in equal contiguous shares.
+    /// A thread that runs out of its own units steals units from other threads, first within its own task and then from other tasks, by claiming them from the same lock-free counter their owner uses.
+    /// Units may either keep the edges of each vertex together, in which case each vertex counts as one edge's worth of work in addition to its edges and a unit that falls entirely within the edges of one vertex is empty, or split the edges of high-degree vertices across several units.
+    /// Splitting suits work that treats each edge independently, while keeping vertices together suits work that rearranges or counts the edges of each vertex, such as sorting or filtering.
+    class WorkScheduler
+    {
+    private:
+        // -------- CONSTANTS ---------------------------------------------- //
+
+        /// Number of units into which each thread's share of the work is divided, to leave enough units for stealing to even out whatever imbalance remains.
+        static const uint64_t kUnitsPerThread = 16;
+
+        /// Smallest amount of work in a unit, which keeps scheduling overhead negligible for small graphs.
+        static const uint64_t kMinUnitWork = 4096;
+
+
+        // -------- TYPE DEFINITIONS --------------------------------------- //
+
+        /// Holds the units owned by a single thread, sized to occupy its own cache line so that threads claiming units do not contend with one another unless stealing.
+        struct SThreadState
+        {
+            std::atomic<uint64_t> nextUnit;                                 ///< Next unit to be claimed, which is past the last unit once all of them are claimed.
+            uint64_t endUnit;                                               ///< One past the last unit owned by the thread.
+            uint64_t taskWorkStart;                                         ///< Amount of work that precedes the first unit of the owning task.
+            uint64_t taskWorkEnd;                                           ///< Amount of work that precedes the first unit of the next task.
+            uint64_t unitWork;                                              ///< Amount of work in each unit of the owning task, except possibly its last.
+            TVertexID taskVertexStart;                                      ///< First top-level vertex for which the owning task is responsible.
+            TVertexID taskVertexEnd;                                        ///< One past the last top-level vertex for which the owning task is responsible.
+        };
+
+
+        // -------- INSTANCE VARIABLES ------------------------------------- //
+
+        /// Frozen offsets of the vertex index whose work is being scheduled.
+        const TEdgeCount* offsets;
+
+        /// Specifies that the edges of a single vertex may be split across units.
+        bool splitsVertices;
+
+        /// State of each thread, indexed by global thread identifier.
+        SThreadState* threadStates;
+
+        /// Number of threads for which state is allocated.
+        uint32_t numThreadStates;
+
+
+    public:
+        // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
+
+        /// Default constructor.
+        WorkScheduler(void);
+
+        /// Destructor.
+        ~WorkScheduler(void);
+
+
+    private:
+        // -------- HELPERS ------------------------------------------------ //
+
+        /// Attempts to claim a unit of work owned by the specified thread.
+        /// @param [in] owner Global thread identifier of the owning thread.
+        /// @param [out] unit Filled with the unit of work, if one is claimed.
+        /// @return `true` if a unit was claimed, `false` if the thread has no units left.
+        bool ClaimUnit(const uint32_t owner, SWorkUnit& unit);
+
+        /// Fills in a unit of work from its position within the units of the task that owns it.
+        /// @param [in] threadState State of a thread in the owning task.
+        /// @param [in] unitIndex Index of the unit within the units of the owning task.
+        /// @param [out] unit Filled with the unit of work.
+        void DescribeUnit(const SThreadState& threadState, const uint64_t unitIndex, SWorkUnit& unit) const;
+
+        /// Finds the first vertex within a range that is preceded by at least the specified amount of work.
+        /// @param [in] vertexStart First vertex to consider.
+        /// @param [in] vertexEnd One past the last vertex to consider, which is returned if no vertex in the range qualifies.
+        /// @param [in] work Amount of work.
+        /// @return First vertex in the range that qualifies.
+        TVertexID FindVertexByWork(TVertexID vertexStart, TVertexID vertexEnd, const uint64_t work) const;
+
+        /// Determines the amount of work that precedes the specified vertex.
+        /// @param [in] vertex Top-level vertex, which may be one past the last.
+        /// @return Amount of work.
+        inline uint64_t WorkBeforeVertex(const TVertexID vertex) const
+        {
+            return (splitsVertices ? (uint64_t)offsets[vertex] : ((uint64_t)offsets[vertex] + (uint64_t)vertex));
+        }
+
+
+    public:
+        // -------- INSTANCE METHODS --------------------------------------- //
+
+        /// Claims the next unit of work for the calling thread, stealing from other threads once its own units are exhausted.
+        /// Intended to be called from within the same Spindle parallelized region as the initialization.
+        /// @param [out] unit Filled with the unit of work, if one is claimed.
+        /// @return `true` if a unit was claimed, `false` if no work remains, in which case no further units will be handed out until the scheduler is initialized again.
+        bool GetWork(SWorkUnit& unit);
+
+        /// Divides the top-level vertices of a frozen vertex index into units of work.
+        /// Intended to be called from within a Spindle parallelized region created by NUMASpawner, by all threads in the region, and waits for all of them to stop claiming any previous work from the same scheduler before replacing it.
+        /// @param [in] offsets Frozen offsets of the vertex index, which must remain valid until all of the work has been handed out.
+        /// @param [in] numVertices Number of top-level vertices in the vertex index.
+        /// @param [in] splitsVertices Specifies that the edges of a single vertex may be split across units, in which case a unit includes only those vertices that have edges in it.
+        void ParallelInitialize(const TEdgeCount* const offsets, const TVertexCount numVertices, const bool splitsVertices);
+    };
+}
@@ -16,22 +16,58 @@
 #include "Types.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <vector>
 
 
 namespace GraphTool
 {
     /// Writer object class for graphs represented in the format used by X-Stream.
+    /// Edges are written using X-Stream's own record types, namely 32-bit source and destination vertex identifiers followed, in weighted graphs, by a single-precision floating-point weight, so graphs with more than 2^32 vertices cannot be written in this format.
+    /// Optionally, edges are pre-partitioned into X-Stream's streaming partitions, each of which holds the edges of a range of consecutive top-level vertices, and the layout of the partitions is recorded in the metadata file.
     /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
     template <typename TEdgeData> class XStreamWriter : public BinaryEdgeListWriter<TEdgeData>
     {
     private:
+        // -------- CONSTANTS ---------------------------------------------- //
+        
+        /// Number of elements past the end of the packed edges that PackEdges may overwrite, because each vector store writes more elements than it produces.
+        static const size_t kPackSlack = 8;
+        
+        
         // -------- INSTANCE VARIABLES ------------------------------------- //
         
         // String that identifies the graph type being written.
         // See X-Stream documentation for possible values.
         const char* const graphTypeIdentifier;
         
+        /// Number of streaming partitions into which edges are pre-partitioned, or 0 if they are not pre-partitioned.
+        uint32_t numStreamingPartitions;
+        
+        /// Staging buffer holding the packed form of the edges in the buffer being written, so that each buffer is written using a single write.
+        std::vector<uint32_t> packedEdges;
+        
+        
+        // -------- CLASS METHODS ------------------------------------------ //
+        
+        /// Packs the specified edges into X-Stream's record type, narrowing vertex identifiers several edges at a time using AVX2 and converting weights to single precision.
+        /// @param [out] packed Buffer to receive the packed edges, which must have room for the packed edges plus kPackSlack elements.
+        /// @param [in] buf Buffer from which to read edge data.
+        /// @param [in] count Number of edges in the buffer.
+        /// @return `true` if every vertex identifier fits in 32 bits, `false` otherwise, in which case the contents of the packed buffer are unspecified.
+        static bool PackEdges(uint32_t* const packed, const SEdge<TEdgeData>* buf, const size_t count);
+        
+        
+        // -------- INSTANCE METHODS --------------------------------------- //
+        
+        /// Writes the layout of the streaming partitions to the metadata file.
+        /// Partitions hold equally-sized ranges of consecutive top-level vertices, so the number of edges in each is determined by the degrees of its vertices.
+        /// @param [in] metafile Metadata file, which must already hold the graph section.
+        /// @param [in] graph Graph to be written.
+        /// @param [in] groupedByDestination Indicates that graph edges are grouped by destination instead of by source.
+        void WriteStreamingPartitionsToMetadataFile(FILE* const metafile, const Graph& graph, const bool groupedByDestination) const;
+        
         
     public:
         // -------- CONSTRUCTION AND DESTRUCTION --------------------------- //
@@ -40,11 +76,20 @@ namespace GraphTool
         XStreamWriter(void);
         
         
+        // -------- CONCRETE INSTANCE METHODS ------------------------------ //
+        // See "IGraphWriter.h" for documentation.
+        
+        virtual bool SubmitOption(const char* const optionName, const char* const optionValue);
+        
+        
     private:
         // -------- CONCRETE INSTANCE METHODS ------------------------------ //
         // See "GraphWriter.h" for documentation.
         
+        virtual GraphWriter<TEdgeData>* CreatePartitionWriter(void) const;
         virtual FILE* OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination);
-        virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination);
+        virtual bool SupportsEdgeSource(void) const;
+        virtual bool SupportsStreaming(void) const;
+        virtual void WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass);
     };
 }
@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file Arena.cpp
+ *   Implementation of a simple NUMA-aware bump allocator used to hold large
+ *   numbers of small graph objects.
+ *****************************************************************************/
+
+#include "Arena.h"
+#include "MemoryTracker.h"
+#include "VersionInfo.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <silo.h>
+
+#ifdef __PLATFORM_LINUX
+#include <sys/mman.h>
+#endif
+
+
+namespace GraphTool
+{
+    // -------- CLASS VARIABLES -------------------------------------------- //
+    // See "Arena.h" for documentation.
+
+    volatile bool Arena::tryExplicitHugePages = true;
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "Arena.h" for documentation.
+
+    Arena::Arena(const uint32_t numaNode) : chunks(), nextFree(NULL), bytesRemaining(0), bytesAllocated(0), numaNode(numaNode)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    Arena::~Arena(void)
+    {
+        for (auto it = chunks.begin(); it != chunks.end(); ++it)
+        {
+            MemoryTracker::RecordRelease(it->base);
+
+#ifdef __PLATFORM_LINUX
+            if (it->isExplicitHugePage)
+            {
+                munmap(it->base, it->size);
+                continue;
+            }
+#endif
+
+            siloFree(it->base);
+        }
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "Arena.h" for documentation.
+
+    bool Arena::Refill(const size_t size)
+    {
+        // Oversized allocations get a chunk of their own, rounded up to a whole number of huge pages.
+        SChunk chunk;
+        chunk.size = ((size > kChunkSize) ? ((size + (kHugePageSize - 1)) & ~(kHugePageSize - 1)) : kChunkSize);
+        chunk.base = NULL;
+        chunk.isExplicitHugePage = false;
+
+#ifdef __PLATFORM_LINUX
+        // Explicit huge pages only exist if the administrator has reserved them, so fall back permanently the first time none are available.
+        // Chunks are only ever touched by the thread that allocates from them, so first-touch placement keeps them local to that thread's NUMA node.
+        if (tryExplicitHugePages)
+        {
+            void* const mapping = mmap(NULL, chunk.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+            if (MAP_FAILED != mapping)
+            {
+                chunk.base = mapping;
+                chunk.isExplicitHugePage = true;
+            }
+            else
+            {
+                tryExplicitHugePages = false;
+            }
+        }
+#endif
+
+        if (NULL == chunk.base)
+        {
+            chunk.base = siloSimpleBufferAlloc(chunk.size, numaNode);
+
+            if (NULL == chunk.base)
+                return false;
+
+#if defined(__PLATFORM_LINUX) && defined(MADV_HUGEPAGE)
+            // Ask for transparent huge pages; failure is harmless and simply leaves the chunk backed by regular pages.
+            madvise(chunk.base, chunk.size, MADV_HUGEPAGE);
+#endif
+        }
+
+        MemoryTracker::RecordAllocation(chunk.base, chunk.size, MemoryTracker::MemoryCategoryEdgeLists);
+
+        chunks.push_back(chunk);
+        nextFree = (uint8_t*)chunk.base;
+        bytesRemaining = chunk.size;
+
+        return true;
+    }
+}
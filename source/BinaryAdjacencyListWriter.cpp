@@ -0,0 +1,202 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file BinaryAdjacencyListWriter.cpp
+ *   Implementation of a graph writer for Ligra's binary adjacency list files.
+ *****************************************************************************/
+
+#include "BinaryAdjacencyListWriter.h"
+#include "Graph.h"
+#include "GraphWriter.h"
+#include "PlatformFunctions.h"
+#include "Types.h"
+#include "VertexIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Largest number of vertices whose identifiers can all be represented using 32 bits.
+    static const uint64_t kMaxVerticesForCompactNeighbors = 0x100000000ull;
+
+    /// Largest number of edges whose offsets can all be represented using 32 bits.
+    static const uint64_t kMaxEdgesForCompactOffsets = 0xffffffffull;
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "BinaryAdjacencyListWriter.h" for documentation.
+
+    template <typename TEdgeData> BinaryAdjacencyListWriter<TEdgeData>::BinaryAdjacencyListWriter(void) : GraphWriter<TEdgeData>(), neighborSize(sizeof(uint32_t)), edgeDataSectionPosition(0)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphWriter.h" for documentation.
+
+    template <typename TEdgeData> GraphWriter<TEdgeData>* BinaryAdjacencyListWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new BinaryAdjacencyListWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> void BinaryAdjacencyListWriter<TEdgeData>::FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
+    {
+        // Append each edge's neighbor to the neighbors section and its weight, truncated to an integer as Ligra expects, to the edge data section.
+        for (size_t i = 0; i < count; ++i)
+        {
+            this->AppendValueToBuffer(output, (uint64_t)(groupedByDestination ? buf[i].sourceVertex : buf[i].destinationVertex), neighborSize);
+            this->AppendValueToBuffer(secondaryOutput, (uint64_t)buf[i].edgeData, neighborSize);
+        }
+    }
+
+    // --------
+
+    template <> void BinaryAdjacencyListWriter<void>::FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<void>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
+    {
+        // Append each edge's neighbor, which is the source or destination vertex depending on the grouping.
+        for (size_t i = 0; i < count; ++i)
+            this->AppendValueToBuffer(output, (uint64_t)(groupedByDestination ? buf[i].sourceVertex : buf[i].destinationVertex), neighborSize);
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* BinaryAdjacencyListWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        const uint64_t numVertices = (uint64_t)this->GetNumVerticesToWrite(graph);
+        const uint64_t numEdges = (uint64_t)this->GetNumEdgesToWrite(graph);
+
+        neighborSize = ((numVertices <= kMaxVerticesForCompactNeighbors) ? sizeof(uint32_t) : sizeof(uint64_t));
+        edgeDataSectionPosition = (int64_t)(numEdges * (uint64_t)neighborSize);
+
+        // Obtain the filenames of all three files.
+        const std::string configfilename = std::string(filename) + ".config";
+        const std::string indexfilename = std::string(filename) + ".idx";
+        const std::string adjacencyfilename = std::string(filename) + ".adj";
+
+        // Write the configuration file, which holds only the number of vertices.
+        FILE* configfile = fopen(configfilename.c_str(), "w");
+
+        if (NULL == configfile)
+            return NULL;
+
+        fprintf(configfile, "%llu\n", (long long unsigned int)numVertices);
+
+        const bool configFailed = (0 != ferror(configfile));
+
+        if ((0 != fclose(configfile)) || configFailed)
+            return NULL;
+
+        // Write the vertex offsets in parallel, using threads on every NUMA node.
+        FILE* indexfile = this->OpenGraphFileForWrite(indexfilename.c_str());
+
+        if (NULL == indexfile)
+            return NULL;
+
+        const VertexIndex& vertexIndex = (groupedByDestination ? graph.VertexIndexDestination() : graph.VertexIndexSource());
+        const size_t offsetSize = ((numEdges <= kMaxEdgesForCompactOffsets) ? sizeof(uint32_t) : sizeof(uint64_t));
+        const bool indexFailed = !(this->WriteVertexOffsetsToFile(indexfile, vertexIndex, vertexIndex.GetNumVertices(), &GraphWriter<TEdgeData>::AppendValueToBuffer, offsetSize, false));
+
+        if ((0 != fclose(indexfile)) || indexFailed)
+            return NULL;
+
+        // Open the file that will receive the neighbors and, if present, the edge data.
+        return this->OpenGraphFileForWrite(adjacencyfilename.c_str());
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* BinaryAdjacencyListWriter<TEdgeData>::OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        const std::string adjacencyfilename = std::string(filename) + ".adj";
+
+        // Positions within a compressed file are unknown until it is written, so a compressed edge data section is produced separately and appended.
+        if (this->IsGraphFileCompressed())
+            return this->OpenCompressedGraphFileSectionForWrite(adjacencyfilename.c_str());
+
+        // The edge data section is written through a second handle to the same file, which the first handle has already created.
+        FILE* edgeDataFile = fopen(adjacencyfilename.c_str(), "r+b");
+
+        if ((NULL != edgeDataFile) && (0 != fseek64(edgeDataFile, edgeDataSectionPosition, SEEK_SET)))
+        {
+            fclose(edgeDataFile);
+            return NULL;
+        }
+
+        return edgeDataFile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool BinaryAdjacencyListWriter<TEdgeData>::SupportsDirectIO(void) const
+    {
+        // Direct I/O truncates the file to the size of the neighbors section when it is closed, which would race with the edge data section.
+        return false;
+    }
+
+    // --------
+
+    template <> bool BinaryAdjacencyListWriter<void>::SupportsDirectIO(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool BinaryAdjacencyListWriter<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool BinaryAdjacencyListWriter<TEdgeData>::SupportsParallelFormatting(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool BinaryAdjacencyListWriter<TEdgeData>::UsesSecondaryGraphFile(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <> bool BinaryAdjacencyListWriter<void>::UsesSecondaryGraphFile(void) const
+    {
+        return false;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void BinaryAdjacencyListWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        // Formatting is shared with the parallel path, so that output is identical regardless of how it is produced.
+        this->WriteFormattedEdgesToFile(graphfile, graph, buf, count, groupedByDestination, currentPass);
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class BinaryAdjacencyListWriter<void>;
+    template class BinaryAdjacencyListWriter<uint64_t>;
+    template class BinaryAdjacencyListWriter<double>;
+    template class BinaryAdjacencyListWriter<uint32_t>;
+    template class BinaryAdjacencyListWriter<float>;
+}
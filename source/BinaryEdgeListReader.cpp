@@ -13,22 +13,86 @@
 #include "BinaryEdgeListReader.h"
 #include "GraphReader.h"
 #include "Types.h"
+#include "VersionInfo.h"
 
 #include <cstddef>
 #include <cstdlib>
 #include <cstdint>
 #include <cstdio>
 
+#ifdef __PLATFORM_LINUX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 namespace GraphTool
 {
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "BinaryEdgeListReader.h" for documentation.
+
+    template <typename TEdgeData> BinaryEdgeListReader<TEdgeData>::BinaryEdgeListReader(void) : GraphReader<TEdgeData>(), mappingBase(NULL), mappingSize(0), mappedEdges(NULL), numMappedEdges(0), nextMappedEdge(0)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    template <typename TEdgeData> BinaryEdgeListReader<TEdgeData>::~BinaryEdgeListReader(void)
+    {
+        UnmapEdgesForRead();
+    }
+
+
     // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
     // See "GraphReader.h" for documentation.
 
+    template <typename TEdgeData> GraphReader<TEdgeData>* BinaryEdgeListReader<TEdgeData>::CreateShardReader(void) const
+    {
+        return new BinaryEdgeListReader<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool BinaryEdgeListReader<TEdgeData>::MapEdgesForRead(FILE* const graphfile)
+    {
+#ifdef __PLATFORM_LINUX
+        // Only regular files can be mapped, so anything else, such as a pipe, falls back to reading into buffers.
+        const int fd = fileno(graphfile);
+        const long firstEdgeOffset = ftell(graphfile);
+        struct stat fileInfo;
+        
+        if ((firstEdgeOffset < 0) || (0 != fstat(fd, &fileInfo)) || !S_ISREG(fileInfo.st_mode) || ((size_t)fileInfo.st_size <= (size_t)firstEdgeOffset))
+            return false;
+        
+        void* const mapping = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        
+        if (MAP_FAILED == mapping)
+            return false;
+        
+        // Edges are consumed front to back exactly once, so aggressive readahead helps and pages can be dropped soon after use.
+        madvise(mapping, (size_t)fileInfo.st_size, MADV_SEQUENTIAL);
+        
+        mappingBase = mapping;
+        mappingSize = (size_t)fileInfo.st_size;
+        mappedEdges = (const SEdge<TEdgeData>*)((const uint8_t*)mapping + firstEdgeOffset);
+        numMappedEdges = (TEdgeCount)((mappingSize - (size_t)firstEdgeOffset) / sizeof(SEdge<TEdgeData>));
+        nextMappedEdge = 0;
+        
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+
     template <typename TEdgeData> FILE* BinaryEdgeListReader<TEdgeData>::OpenAndInitializeGraphFileForRead(const char* const filename)
     {
         // This class reads files in binary mode.
-        FILE* graphfile = fopen(filename, "rb");
+        FILE* graphfile = this->OpenGraphFileForRead(filename);
 
         if (NULL != graphfile)
         {
@@ -58,15 +122,66 @@ namespace GraphTool
 
     // --------
 
+    template <typename TEdgeData> TEdgeCount BinaryEdgeListReader<TEdgeData>::ReadEdgesInPlace(const SEdge<TEdgeData>*& edges, const size_t count)
+    {
+        const TEdgeCount numEdges = (((numMappedEdges - nextMappedEdge) < (TEdgeCount)count) ? (numMappedEdges - nextMappedEdge) : (TEdgeCount)count);
+        
+        edges = &mappedEdges[nextMappedEdge];
+        nextMappedEdge += numEdges;
+        
+#ifdef __PLATFORM_LINUX
+        // While the consumers work on these edges, ask the kernel to start bringing in the next set.
+        const TEdgeCount numNextEdges = (((numMappedEdges - nextMappedEdge) < (TEdgeCount)count) ? (numMappedEdges - nextMappedEdge) : (TEdgeCount)count);
+        
+        if (0 != numNextEdges)
+        {
+            const uintptr_t pageMask = ~((uintptr_t)sysconf(_SC_PAGESIZE) - 1);
+            const uintptr_t nextStart = (uintptr_t)&mappedEdges[nextMappedEdge] & pageMask;
+            const uintptr_t nextEnd = (uintptr_t)&mappedEdges[nextMappedEdge + numNextEdges];
+            
+            madvise((void*)nextStart, (size_t)(nextEnd - nextStart), MADV_WILLNEED);
+        }
+#endif
+        
+        return numEdges;
+    }
+
+    // --------
+
     template <typename TEdgeData> TEdgeCount BinaryEdgeListReader<TEdgeData>::ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count)
     {
         return (TEdgeCount)fread(buf, sizeof(SEdge<TEdgeData>), count, graphfile);
     }
 
+    // --------
+
+    template <typename TEdgeData> bool BinaryEdgeListReader<TEdgeData>::SupportsDirectIO(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void BinaryEdgeListReader<TEdgeData>::UnmapEdgesForRead(void)
+    {
+#ifdef __PLATFORM_LINUX
+        if (NULL != mappingBase)
+            munmap(mappingBase, mappingSize);
+#endif
+        
+        mappingBase = NULL;
+        mappingSize = 0;
+        mappedEdges = NULL;
+        numMappedEdges = 0;
+        nextMappedEdge = 0;
+    }
+
 
     // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
 
     template class BinaryEdgeListReader<void>;
     template class BinaryEdgeListReader<uint64_t>;
     template class BinaryEdgeListReader<double>;
+    template class BinaryEdgeListReader<uint32_t>;
+    template class BinaryEdgeListReader<float>;
 }
@@ -18,22 +18,65 @@
 #include <cstdlib>
 #include <cstdint>
 #include <cstdio>
+#include <vector>
 
 
 namespace GraphTool
 {
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Number of edges copied at a time when edges are written with their padding cleared.
+    static const size_t kPaddedEdgeChunkCount = 4096;
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Writes edges whose structure includes padding after the edge data, which is the case for 32-bit edge data, clearing the padding so that file contents do not depend on whatever happened to be in memory.
+    /// Each edge occupies the same number of bytes in the file as in memory, so that the file can be read back in place.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    /// @param [in] graphfile File to which edges are written.
+    /// @param [in] buf Buffer holding the edges to write.
+    /// @param [in] count Number of edges to write.
+    template <typename TEdgeData> static void WriteEdgesWithClearedPadding(FILE* const graphfile, const SEdge<TEdgeData>* buf, const size_t count)
+    {
+        // Value-initialization clears the padding, and assigning individual members afterwards leaves it clear.
+        std::vector<SEdge<TEdgeData>> chunk(kPaddedEdgeChunkCount, SEdge<TEdgeData>());
+
+        for (size_t chunkStart = 0; chunkStart < count; chunkStart += kPaddedEdgeChunkCount)
+        {
+            const size_t chunkCount = (((count - chunkStart) < kPaddedEdgeChunkCount) ? (count - chunkStart) : kPaddedEdgeChunkCount);
+
+            for (size_t i = 0; i < chunkCount; ++i)
+            {
+                chunk[i].sourceVertex = buf[chunkStart + i].sourceVertex;
+                chunk[i].destinationVertex = buf[chunkStart + i].destinationVertex;
+                chunk[i].edgeData = buf[chunkStart + i].edgeData;
+            }
+
+            fwrite((void*)chunk.data(), sizeof(SEdge<TEdgeData>), chunkCount, graphfile);
+        }
+    }
+
+
     // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
     // See "GraphWriter.h" for documentation.
 
+    template <typename TEdgeData> GraphWriter<TEdgeData>* BinaryEdgeListWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new BinaryEdgeListWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
     template <typename TEdgeData> FILE* BinaryEdgeListWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
     {
         // This class writes files in binary mode.
-        FILE* graphfile = fopen(filename, "wb");
+        FILE* graphfile = this->OpenGraphFileForWrite(filename);
 
         if (NULL != graphfile)
         {
             // Write out the number of vertices and edges in the graph.
-            const TVertexCount metadata[2] = { graph.GetNumVertices(), graph.GetNumEdges() };
+            const TVertexCount metadata[2] = { this->GetNumVerticesToWrite(graph), this->GetNumEdgesToWrite(graph) };
             fwrite((const void*)metadata, sizeof(metadata[0]), sizeof(metadata) / sizeof(metadata[0]), graphfile);
         }
 
@@ -42,15 +85,52 @@ namespace GraphTool
 
     // --------
 
+    template <typename TEdgeData> bool BinaryEdgeListWriter<TEdgeData>::SupportsDirectIO(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool BinaryEdgeListWriter<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool BinaryEdgeListWriter<TEdgeData>::SupportsStreaming(void) const
+    {
+        return true;
+    }
+
+    // --------
+
     template <typename TEdgeData> void BinaryEdgeListWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
     {
         fwrite((void*)buf, sizeof(const SEdge<TEdgeData>), count, graphfile);
     }
 
+    // --------
+
+    template <> void BinaryEdgeListWriter<uint32_t>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<uint32_t>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        WriteEdgesWithClearedPadding(graphfile, buf, count);
+    }
+
+    // --------
+
+    template <> void BinaryEdgeListWriter<float>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<float>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        WriteEdgesWithClearedPadding(graphfile, buf, count);
+    }
+
 
     // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
 
     template class BinaryEdgeListWriter<void>;
     template class BinaryEdgeListWriter<uint64_t>;
     template class BinaryEdgeListWriter<double>;
+    template class BinaryEdgeListWriter<uint32_t>;
+    template class BinaryEdgeListWriter<float>;
 }
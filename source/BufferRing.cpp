@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file BufferRing.cpp
+ *   Implementation of a bounded queue of buffers that passes data from a
+ *   single producer to several groups of consumers without locks.
+ *****************************************************************************/
+
+#include "BufferRing.h"
+#include "Statistics.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+
+namespace GraphTool
+{
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "BufferRing.h" for documentation.
+
+    BufferRing::BufferRing(const uint32_t depth, const uint32_t numConsumers) : depth(depth), numConsumers(numConsumers), numPublished(0), consumers(new SConsumerState[numConsumers])
+    {
+        for (uint32_t i = 0; i < numConsumers; ++i)
+            consumers[i].numReleased.store(0, std::memory_order_relaxed);
+    }
+
+    // --------
+
+    BufferRing::~BufferRing(void)
+    {
+        delete[] consumers;
+    }
+
+
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "BufferRing.h" for documentation.
+
+    void BufferRing::Publish(const uint64_t sequence)
+    {
+        numPublished.store(sequence + 1, std::memory_order_release);
+    }
+
+    // --------
+
+    void BufferRing::Release(const uint32_t consumer, const uint64_t sequence)
+    {
+        consumers[consumer].numReleased.store(sequence + 1, std::memory_order_release);
+    }
+
+    // --------
+
+    uint64_t BufferRing::WaitForFreeBuffer(const uint64_t sequence) const
+    {
+        // The first full ring of buffers has never been filled, so nothing needs to be released.
+        if (sequence < (uint64_t)depth)
+            return 0;
+
+        const uint64_t numReleasedNeeded = sequence - (uint64_t)depth + 1;
+        const uint64_t waitStartTime = Statistics::GetTimestamp();
+
+        for (uint32_t i = 0; i < numConsumers; ++i)
+        {
+            while (consumers[i].numReleased.load(std::memory_order_acquire) < numReleasedNeeded)
+                std::this_thread::yield();
+        }
+
+        return Statistics::GetTimestamp() - waitStartTime;
+    }
+
+    // --------
+
+    uint64_t BufferRing::WaitForPublishedBuffer(const uint64_t sequence) const
+    {
+        const uint64_t waitStartTime = Statistics::GetTimestamp();
+
+        while (numPublished.load(std::memory_order_acquire) <= sequence)
+            std::this_thread::yield();
+
+        return Statistics::GetTimestamp() - waitStartTime;
+    }
+}
@@ -0,0 +1,239 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file CompressedAdjacencyListReader.cpp
+ *   Implementation of a graph reader for compressed adjacency list files.
+ *****************************************************************************/
+
+#include "CompressedAdjacencyListFormat.h"
+#include "CompressedAdjacencyListReader.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "CompressedAdjacencyListReader.h" for documentation.
+
+    template <typename TEdgeData> CompressedAdjacencyListReader<TEdgeData>::CompressedAdjacencyListReader(void) : GraphReader<TEdgeData>(), groupedByDestination(false), pendingBlockHeader(), hasPendingBlockHeader(false)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "CompressedAdjacencyListReader.h" for documentation.
+
+    template <> void CompressedAdjacencyListReader<void>::DecodeEdgeData(const uint8_t*& position, SEdge<void>& edge)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListReader<uint64_t>::DecodeEdgeData(const uint8_t*& position, SEdge<uint64_t>& edge)
+    {
+        edge.edgeData = CompressedAdjacencyListFormat::DecodeVarint(position);
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListReader<double>::DecodeEdgeData(const uint8_t*& position, SEdge<double>& edge)
+    {
+        memcpy((void*)&edge.edgeData, (void*)position, sizeof(edge.edgeData));
+        position += sizeof(edge.edgeData);
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListReader<uint32_t>::DecodeEdgeData(const uint8_t*& position, SEdge<uint32_t>& edge)
+    {
+        edge.edgeData = (uint32_t)CompressedAdjacencyListFormat::DecodeVarint(position);
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListReader<float>::DecodeEdgeData(const uint8_t*& position, SEdge<float>& edge)
+    {
+        memcpy((void*)&edge.edgeData, (void*)position, sizeof(edge.edgeData));
+        position += sizeof(edge.edgeData);
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "CompressedAdjacencyListReader.h" for documentation.
+
+    template <typename TEdgeData> void CompressedAdjacencyListReader<TEdgeData>::DecodeBlock(const uint8_t* blockData, const uint8_t* const blockDataEnd, const size_t numEdges, std::vector<SEdge<TEdgeData>>& edges) const
+    {
+        const size_t firstEdge = edges.size();
+
+        edges.resize(firstEdge + numEdges);
+
+        SEdge<TEdgeData>* const decodedEdges = &edges[firstEdge];
+        size_t numDecodedEdges = 0;
+        TVertexID topLevelVertex = 0;
+
+        while ((numDecodedEdges < numEdges) && (blockData < blockDataEnd))
+        {
+            topLevelVertex += CompressedAdjacencyListFormat::DecodeVarint(blockData);
+
+            const uint64_t runLength = CompressedAdjacencyListFormat::DecodeVarint(blockData);
+            const size_t runEnd = ((runLength < (uint64_t)(numEdges - numDecodedEdges)) ? (numDecodedEdges + (size_t)runLength) : numEdges);
+            TVertexID otherVertex = 0;
+
+            for (; (numDecodedEdges < runEnd) && (blockData < blockDataEnd); ++numDecodedEdges)
+            {
+                otherVertex += CompressedAdjacencyListFormat::DecodeVarint(blockData);
+
+                if (groupedByDestination)
+                {
+                    decodedEdges[numDecodedEdges].sourceVertex = otherVertex;
+                    decodedEdges[numDecodedEdges].destinationVertex = topLevelVertex;
+                }
+                else
+                {
+                    decodedEdges[numDecodedEdges].sourceVertex = topLevelVertex;
+                    decodedEdges[numDecodedEdges].destinationVertex = otherVertex;
+                }
+
+                DecodeEdgeData(blockData, decodedEdges[numDecodedEdges]);
+            }
+        }
+
+        // A malformed block yields fewer edges than its header claims, which the edge count check at the end of reading detects.
+        edges.resize(firstEdge + numDecodedEdges);
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphReader.h" for documentation.
+
+    template <typename TEdgeData> FILE* CompressedAdjacencyListReader<TEdgeData>::OpenAndInitializeGraphFileForRead(const char* const filename)
+    {
+        // This class reads files in binary mode.
+        FILE* graphfile = this->OpenGraphFileForRead(filename);
+
+        if (NULL != graphfile)
+        {
+            SCompressedAdjacencyListFileHeader fileHeader;
+
+            // Read the header and verify that it describes a compressed adjacency list holding the expected type of edge data.
+            if ((1 != fread((void*)&fileHeader, sizeof(fileHeader), 1, graphfile)) || (CompressedAdjacencyListFormat::kFileMagic != fileHeader.magic) || ((uint32_t)CompressedAdjacencyListFormat::GetEdgeDataType<TEdgeData>() != fileHeader.edgeDataType))
+            {
+                fclose(graphfile);
+                return NULL;
+            }
+
+            GraphReader<TEdgeData>::numVerticesInFile = (TVertexCount)fileHeader.numVertices;
+            GraphReader<TEdgeData>::numEdgesInFile = (TEdgeCount)fileHeader.numEdges;
+            groupedByDestination = (0 != (fileHeader.flags & CompressedAdjacencyListFormat::kFileFlagGroupedByDestination));
+        }
+
+        hasPendingBlockHeader = false;
+        return graphfile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void CompressedAdjacencyListReader<TEdgeData>::ParseEdgesFromChunk(const char* const chunk, const size_t chunkSize, const size_t rangeStart, const size_t rangeEnd, std::vector<SEdge<TEdgeData>>& edges) const
+    {
+        const uint8_t* const chunkBytes = (const uint8_t*)chunk;
+        size_t blockPosition = 0;
+
+        // Skipping from header to header is cheap compared to decoding, so every thread finds the blocks that begin within its range by walking from the start of the chunk.
+        while ((blockPosition < rangeEnd) && ((blockPosition + sizeof(SCompressedAdjacencyListBlockHeader)) <= chunkSize))
+        {
+            SCompressedAdjacencyListBlockHeader blockHeader;
+            memcpy((void*)&blockHeader, (void*)&chunkBytes[blockPosition], sizeof(blockHeader));
+
+            const size_t blockDataPosition = blockPosition + sizeof(blockHeader);
+            const size_t nextBlockPosition = blockDataPosition + (size_t)blockHeader.numBytes;
+
+            if (blockPosition >= rangeStart)
+                DecodeBlock(&chunkBytes[blockDataPosition], &chunkBytes[((nextBlockPosition < chunkSize) ? nextBlockPosition : chunkSize)], (size_t)blockHeader.numEdges, edges);
+
+            blockPosition = nextBlockPosition;
+        }
+    }
+
+    // --------
+
+    template <typename TEdgeData> size_t CompressedAdjacencyListReader<TEdgeData>::ReadChunkToBuffer(FILE* const graphfile, char* const buf, const size_t size, const TEdgeCount maxEdges)
+    {
+        size_t numBytes = 0;
+        TEdgeCount numEdges = 0;
+
+        // Fill the chunk with as many whole blocks as fit, both in bytes and in edges once decoded.
+        // The header of the first block that does not fit is held back for the next chunk, since the file may not support seeking.
+        while (true)
+        {
+            if (!hasPendingBlockHeader)
+            {
+                if (1 != fread((void*)&pendingBlockHeader, sizeof(pendingBlockHeader), 1, graphfile))
+                    break;
+
+                hasPendingBlockHeader = true;
+            }
+
+            const size_t blockSize = sizeof(pendingBlockHeader) + (size_t)pendingBlockHeader.numBytes;
+
+            if (((numBytes + blockSize) > size) || ((numEdges + (TEdgeCount)pendingBlockHeader.numEdges) > maxEdges))
+                break;
+
+            memcpy((void*)&buf[numBytes], (void*)&pendingBlockHeader, sizeof(pendingBlockHeader));
+            hasPendingBlockHeader = false;
+
+            const size_t numBlockDataBytes = fread((void*)&buf[numBytes + sizeof(pendingBlockHeader)], 1, (size_t)pendingBlockHeader.numBytes, graphfile);
+
+            numBytes += sizeof(pendingBlockHeader) + numBlockDataBytes;
+            numEdges += (TEdgeCount)pendingBlockHeader.numEdges;
+
+            if (numBlockDataBytes != (size_t)pendingBlockHeader.numBytes)
+                break;
+        }
+
+        return numBytes;
+    }
+
+    // --------
+
+    template <typename TEdgeData> TEdgeCount CompressedAdjacencyListReader<TEdgeData>::ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count)
+    {
+        // Blocks are always decoded in parallel by the consumers, so edges are never read directly.
+        return 0;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool CompressedAdjacencyListReader<TEdgeData>::SupportsDirectIO(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool CompressedAdjacencyListReader<TEdgeData>::UsesParallelParsing(void) const
+    {
+        return true;
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class CompressedAdjacencyListReader<void>;
+    template class CompressedAdjacencyListReader<uint64_t>;
+    template class CompressedAdjacencyListReader<double>;
+    template class CompressedAdjacencyListReader<uint32_t>;
+    template class CompressedAdjacencyListReader<float>;
+}
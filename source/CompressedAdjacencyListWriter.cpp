@@ -0,0 +1,211 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file CompressedAdjacencyListWriter.cpp
+ *   Implementation of a graph writer for compressed adjacency list files.
+ *****************************************************************************/
+
+#include "CompressedAdjacencyListFormat.h"
+#include "CompressedAdjacencyListWriter.h"
+#include "Graph.h"
+#include "Types.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "CompressedAdjacencyListWriter.h" for documentation.
+
+    template <typename TEdgeData> void CompressedAdjacencyListWriter<TEdgeData>::EncodeBlock(uint8_t*& position, const SEdge<TEdgeData>* edges, const size_t count, const bool groupedByDestination)
+    {
+        uint8_t* const headerPosition = position;
+        position += sizeof(SCompressedAdjacencyListBlockHeader);
+
+        TVertexID previousTopLevelVertex = 0;
+        size_t edgeIdx = 0;
+
+        while (edgeIdx < count)
+        {
+            // Find the extent of the run of edges that share this top-level vertex.
+            const TVertexID topLevelVertex = (groupedByDestination ? edges[edgeIdx].destinationVertex : edges[edgeIdx].sourceVertex);
+            size_t runEnd = edgeIdx + 1;
+
+            while ((runEnd < count) && (topLevelVertex == (groupedByDestination ? edges[runEnd].destinationVertex : edges[runEnd].sourceVertex)))
+                runEnd += 1;
+
+            CompressedAdjacencyListFormat::EncodeVarint(position, topLevelVertex - previousTopLevelVertex);
+            CompressedAdjacencyListFormat::EncodeVarint(position, (uint64_t)(runEnd - edgeIdx));
+
+            TVertexID previousOtherVertex = 0;
+
+            for (; edgeIdx < runEnd; ++edgeIdx)
+            {
+                const TVertexID otherVertex = (groupedByDestination ? edges[edgeIdx].sourceVertex : edges[edgeIdx].destinationVertex);
+
+                CompressedAdjacencyListFormat::EncodeVarint(position, otherVertex - previousOtherVertex);
+                EncodeEdgeData(position, edges[edgeIdx]);
+                previousOtherVertex = otherVertex;
+            }
+
+            previousTopLevelVertex = topLevelVertex;
+        }
+
+        const SCompressedAdjacencyListBlockHeader blockHeader = { (uint32_t)(position - headerPosition - sizeof(SCompressedAdjacencyListBlockHeader)), (uint32_t)count };
+        memcpy((void*)headerPosition, (void*)&blockHeader, sizeof(blockHeader));
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListWriter<void>::EncodeEdgeData(uint8_t*& position, const SEdge<void>& edge)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListWriter<uint64_t>::EncodeEdgeData(uint8_t*& position, const SEdge<uint64_t>& edge)
+    {
+        CompressedAdjacencyListFormat::EncodeVarint(position, edge.edgeData);
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListWriter<double>::EncodeEdgeData(uint8_t*& position, const SEdge<double>& edge)
+    {
+        memcpy((void*)position, (void*)&edge.edgeData, sizeof(edge.edgeData));
+        position += sizeof(edge.edgeData);
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListWriter<uint32_t>::EncodeEdgeData(uint8_t*& position, const SEdge<uint32_t>& edge)
+    {
+        CompressedAdjacencyListFormat::EncodeVarint(position, (uint64_t)edge.edgeData);
+    }
+
+    // --------
+
+    template <> void CompressedAdjacencyListWriter<float>::EncodeEdgeData(uint8_t*& position, const SEdge<float>& edge)
+    {
+        memcpy((void*)position, (void*)&edge.edgeData, sizeof(edge.edgeData));
+        position += sizeof(edge.edgeData);
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphWriter.h" for documentation.
+
+    template <typename TEdgeData> GraphWriter<TEdgeData>* CompressedAdjacencyListWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new CompressedAdjacencyListWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> void CompressedAdjacencyListWriter<TEdgeData>::FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
+    {
+        // Edges arrive grouped by top-level vertex in increasing order, so ordering by top-level vertex and then by the other vertex only rearranges edges within each run.
+        auto compareEdges = [groupedByDestination](const SEdge<TEdgeData>& a, const SEdge<TEdgeData>& b) -> bool
+        {
+            if (groupedByDestination)
+                return ((a.destinationVertex < b.destinationVertex) || ((a.destinationVertex == b.destinationVertex) && (a.sourceVertex < b.sourceVertex)));
+            else
+                return ((a.sourceVertex < b.sourceVertex) || ((a.sourceVertex == b.sourceVertex) && (a.destinationVertex < b.destinationVertex)));
+        };
+
+        // Each block is encoded into scratch space sized for the worst case and then appended to the output at its actual size.
+        std::vector<SEdge<TEdgeData>> sortedEdges;
+        std::vector<uint8_t> encodedBlock(sizeof(SCompressedAdjacencyListBlockHeader) + (CompressedAdjacencyListFormat::kMaxEdgesPerBlock * CompressedAdjacencyListFormat::kMaxBytesPerEdge));
+
+        for (size_t blockStart = 0; blockStart < count; blockStart += CompressedAdjacencyListFormat::kMaxEdgesPerBlock)
+        {
+            const size_t blockCount = (((count - blockStart) < CompressedAdjacencyListFormat::kMaxEdgesPerBlock) ? (count - blockStart) : CompressedAdjacencyListFormat::kMaxEdgesPerBlock);
+            const SEdge<TEdgeData>* blockEdges = &buf[blockStart];
+
+            // Sorted input, such as that produced by the sortedges transform, is encoded directly.
+            // Otherwise a stable sort keeps duplicate edges in their original order.
+            if (!(std::is_sorted(blockEdges, blockEdges + blockCount, compareEdges)))
+            {
+                sortedEdges.assign(blockEdges, blockEdges + blockCount);
+                std::stable_sort(sortedEdges.begin(), sortedEdges.end(), compareEdges);
+                blockEdges = sortedEdges.data();
+            }
+
+            uint8_t* position = encodedBlock.data();
+            EncodeBlock(position, blockEdges, blockCount, groupedByDestination);
+            output.insert(output.end(), (const char*)encodedBlock.data(), (const char*)position);
+        }
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* CompressedAdjacencyListWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        // This class writes files in binary mode.
+        FILE* graphfile = this->OpenGraphFileForWrite(filename);
+
+        if (NULL != graphfile)
+        {
+            SCompressedAdjacencyListFileHeader fileHeader;
+
+            fileHeader.magic = CompressedAdjacencyListFormat::kFileMagic;
+            fileHeader.numVertices = (uint64_t)this->GetNumVerticesToWrite(graph);
+            fileHeader.numEdges = (uint64_t)this->GetNumEdgesToWrite(graph);
+            fileHeader.edgeDataType = (uint32_t)CompressedAdjacencyListFormat::GetEdgeDataType<TEdgeData>();
+            fileHeader.flags = (groupedByDestination ? CompressedAdjacencyListFormat::kFileFlagGroupedByDestination : 0);
+
+            fwrite((const void*)&fileHeader, sizeof(fileHeader), 1, graphfile);
+        }
+
+        return graphfile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool CompressedAdjacencyListWriter<TEdgeData>::SupportsDirectIO(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool CompressedAdjacencyListWriter<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool CompressedAdjacencyListWriter<TEdgeData>::SupportsParallelFormatting(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void CompressedAdjacencyListWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        this->WriteFormattedEdgesToFile(graphfile, graph, buf, count, groupedByDestination, currentPass);
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class CompressedAdjacencyListWriter<void>;
+    template class CompressedAdjacencyListWriter<uint64_t>;
+    template class CompressedAdjacencyListWriter<double>;
+    template class CompressedAdjacencyListWriter<uint32_t>;
+    template class CompressedAdjacencyListWriter<float>;
+}
@@ -0,0 +1,489 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file CompressingFile.cpp
+ *   Implementation of a file backend that compresses everything written to
+ *   it using zstd or gzip, in parallel, before it reaches the underlying file.
+ *****************************************************************************/
+
+#include "CompressingFile.h"
+#include "VersionInfo.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __PLATFORM_LINUX
+#include <zlib.h>
+#include <zstd.h>
+#endif
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Largest gzip compression level supported by zlib.
+    static const int kGzipMaxLevel = 9;
+
+    /// Size of the buffer used to copy compressed data from the temporary file when appending to another file.
+    static const size_t kAppendBufferSize = (1ull * 1024ull * 1024ull);
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "CompressingFile.h" for documentation.
+
+    CompressingFile::CompressingFile(void) : format(CompressionFormatNone), level(0), output(NULL), appendFilename(), segments(), workers(), currentSegment(NULL), lock(), segmentQueued(), segmentWritten(), freeSegments(), queuedSegments(), nextSegment(0), numSegmentsWritten(0), failed(false), closing(false), position(0)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    CompressingFile::~CompressingFile(void)
+    {
+        // Anything still running at this point is abandoned, so the background threads are stopped without waiting for queued segments.
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            failed = (failed || !(workers.empty()));
+            closing = true;
+        }
+
+        segmentQueued.notify_all();
+        segmentWritten.notify_all();
+
+        for (auto it = workers.begin(); it != workers.end(); ++it)
+            it->join();
+
+        if (NULL != output)
+            fclose(output);
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "CompressingFile.h" for documentation.
+
+    bool CompressingFile::IsSupported(void)
+    {
+#ifdef __PLATFORM_LINUX
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    FILE* CompressingFile::OpenForWrite(FILE* const file, const ECompressionFormat format, const int level, const uint32_t numThreads)
+    {
+        if (NULL == file)
+            return NULL;
+
+        CompressingFile* const compressingFile = new CompressingFile();
+
+        if (!(compressingFile->Initialize(file, format, level, numThreads)))
+        {
+            delete compressingFile;
+            return NULL;
+        }
+
+        return compressingFile->OpenStream();
+    }
+
+    // --------
+
+    FILE* CompressingFile::OpenForAppendOnClose(const char* const filename, const ECompressionFormat format, const int level, const uint32_t numThreads)
+    {
+        FILE* const temporaryFile = tmpfile();
+
+        if (NULL == temporaryFile)
+            return NULL;
+
+        CompressingFile* const compressingFile = new CompressingFile();
+        compressingFile->appendFilename = filename;
+
+        if (!(compressingFile->Initialize(temporaryFile, format, level, numThreads)))
+        {
+            delete compressingFile;
+            return NULL;
+        }
+
+        return compressingFile->OpenStream();
+    }
+
+    // --------
+
+    int CompressingFile::CookieClose(void* cookie)
+    {
+        CompressingFile* const compressingFile = (CompressingFile*)cookie;
+        bool succeeded = compressingFile->Finish();
+
+        if (succeeded && !(compressingFile->appendFilename.empty()))
+            succeeded = compressingFile->AppendToNamedFile();
+
+        if (0 != fclose(compressingFile->output))
+            succeeded = false;
+
+        compressingFile->output = NULL;
+
+        delete compressingFile;
+        return (succeeded ? 0 : -1);
+    }
+
+    // --------
+
+    int CompressingFile::CookieSeek(void* cookie, int64_t* offset, int whence)
+    {
+        CompressingFile* const compressingFile = (CompressingFile*)cookie;
+
+        if (((SEEK_CUR == whence) && (0 == *offset)) || ((SEEK_SET == whence) && ((int64_t)compressingFile->position == *offset)))
+        {
+            *offset = (int64_t)compressingFile->position;
+            return 0;
+        }
+
+        return -1;
+    }
+
+    // --------
+
+    ptrdiff_t CompressingFile::CookieWrite(void* cookie, const char* buf, size_t size)
+    {
+        CompressingFile* const compressingFile = (CompressingFile*)cookie;
+        size_t numWritten = 0;
+
+        while (numWritten < size)
+        {
+            // Synchronization is needed only to acquire and hand over segments, since the writer has exclusive use of the segment it holds.
+            if (NULL == compressingFile->currentSegment)
+            {
+                std::unique_lock<std::mutex> guard(compressingFile->lock);
+
+                compressingFile->segmentWritten.wait(guard, [compressingFile]() -> bool
+                {
+                    return (!(compressingFile->freeSegments.empty()) || compressingFile->failed);
+                });
+
+                if (compressingFile->failed)
+                    return -1;
+
+                compressingFile->currentSegment = compressingFile->freeSegments.back();
+                compressingFile->freeSegments.pop_back();
+                compressingFile->currentSegment->size = 0;
+                compressingFile->currentSegment->sequenceNumber = compressingFile->nextSegment;
+                compressingFile->nextSegment += 1;
+            }
+
+            SSegment& segment = *(compressingFile->currentSegment);
+            const size_t numAvailable = kSegmentSize - segment.size;
+            const size_t numToCopy = (((size - numWritten) < numAvailable) ? (size - numWritten) : numAvailable);
+
+            memcpy((void*)&segment.data[segment.size], (const void*)&buf[numWritten], numToCopy);
+            numWritten += numToCopy;
+            segment.size += numToCopy;
+            compressingFile->position += numToCopy;
+
+            if (kSegmentSize == segment.size)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(compressingFile->lock);
+                    compressingFile->QueueCurrentSegment();
+                }
+
+                compressingFile->segmentQueued.notify_one();
+            }
+        }
+
+        return (ptrdiff_t)numWritten;
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "CompressingFile.h" for documentation.
+
+    bool CompressingFile::AppendToNamedFile(void)
+    {
+        if ((0 != fflush(output)) || (0 != fseek(output, 0, SEEK_SET)))
+            return false;
+
+        FILE* const appendFile = fopen(appendFilename.c_str(), "ab");
+
+        if (NULL == appendFile)
+            return false;
+
+        std::vector<uint8_t> appendBuffer(kAppendBufferSize);
+        bool succeeded = true;
+
+        while (succeeded)
+        {
+            const size_t numRead = fread((void*)appendBuffer.data(), sizeof(uint8_t), appendBuffer.size(), output);
+
+            if (numRead != fwrite((const void*)appendBuffer.data(), sizeof(uint8_t), numRead, appendFile))
+                succeeded = false;
+
+            if (numRead < appendBuffer.size())
+                break;
+        }
+
+        if (ferror(output))
+            succeeded = false;
+
+        if (0 != fclose(appendFile))
+            succeeded = false;
+
+        return succeeded;
+    }
+
+    // --------
+
+    bool CompressingFile::Finish(void)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            if (NULL != currentSegment)
+            {
+                if (0 != currentSegment->size)
+                {
+                    QueueCurrentSegment();
+                }
+                else
+                {
+                    // An empty segment would produce an empty frame, so it is given back and its sequence number reused.
+                    freeSegments.push_back(currentSegment);
+                    currentSegment = NULL;
+                    nextSegment -= 1;
+                }
+            }
+
+            closing = true;
+        }
+
+        segmentQueued.notify_all();
+
+        // Background threads exit only once every queued segment has been compressed and written.
+        for (auto it = workers.begin(); it != workers.end(); ++it)
+            it->join();
+
+        workers.clear();
+
+        if (0 != fflush(output))
+            failed = true;
+
+        return !failed;
+    }
+
+    // --------
+
+    bool CompressingFile::Initialize(FILE* const file, const ECompressionFormat format, const int level, const uint32_t numThreads)
+    {
+        output = file;
+        this->format = format;
+        this->level = level;
+
+#ifdef __PLATFORM_LINUX
+        if (CompressionFormatNone == format)
+            return false;
+
+        const uint32_t numWorkers = ((0 == numThreads) ? 1 : ((numThreads < kMaxNumThreads) ? numThreads : kMaxNumThreads));
+
+        // Each background thread needs a segment to compress while the writer fills another, and one more is queued so the writer never waits on the slowest thread.
+        segments.resize((numWorkers << 1) + 1);
+
+        for (auto it = segments.begin(); it != segments.end(); ++it)
+        {
+            it->data.resize(kSegmentSize);
+            it->size = 0;
+            it->sequenceNumber = 0;
+            freeSegments.push_back(&(*it));
+        }
+
+        // Background threads are independent of the Spindle threads that write the graph, since they run for as long as the file is open, including between write passes.
+        for (uint32_t i = 0; i < numWorkers; ++i)
+            workers.push_back(std::thread(&CompressingFile::Worker, this));
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    FILE* CompressingFile::OpenStream(void)
+    {
+#ifdef __PLATFORM_LINUX
+        cookie_io_functions_t functions;
+
+        functions.read = NULL;
+        functions.write = &CookieWrite;
+        functions.seek = &CookieSeek;
+        functions.close = &CookieClose;
+
+        FILE* const stream = fopencookie((void*)this, "wb", functions);
+
+        if (NULL == stream)
+            delete this;
+
+        return stream;
+#else
+        delete this;
+        return NULL;
+#endif
+    }
+
+    // --------
+
+    void CompressingFile::QueueCurrentSegment(void)
+    {
+        queuedSegments.push_back(currentSegment);
+        currentSegment = NULL;
+    }
+
+    // --------
+
+    void CompressingFile::Worker(void)
+    {
+#ifdef __PLATFORM_LINUX
+        z_stream gzipStream;
+        ZSTD_CCtx* zstdContext = NULL;
+        size_t compressedCapacity = 0;
+        bool initialized = false;
+
+        if (CompressionFormatGzip == format)
+        {
+            const int gzipLevel = ((0 == level) ? Z_DEFAULT_COMPRESSION : ((level < kGzipMaxLevel) ? level : kGzipMaxLevel));
+
+            memset((void*)&gzipStream, 0, sizeof(gzipStream));
+
+            // Adding 16 to the window size selects the gzip wrapper, so that every segment becomes a complete gzip member.
+            if (Z_OK == deflateInit2(&gzipStream, gzipLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY))
+            {
+                compressedCapacity = (size_t)deflateBound(&gzipStream, (uLong)kSegmentSize);
+                initialized = true;
+            }
+        }
+        else
+        {
+            zstdContext = ZSTD_createCCtx();
+
+            if (NULL != zstdContext)
+            {
+                compressedCapacity = ZSTD_compressBound(kSegmentSize);
+                initialized = true;
+            }
+        }
+
+        if (!initialized)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                failed = true;
+            }
+
+            segmentWritten.notify_all();
+            segmentQueued.notify_all();
+            return;
+        }
+
+        std::vector<uint8_t> compressed(compressedCapacity);
+
+        while (true)
+        {
+            SSegment* segment;
+
+            // Claim the next queued segment, which is always the earliest not yet claimed, so that the segment to be written next is never left waiting.
+            {
+                std::unique_lock<std::mutex> guard(lock);
+
+                segmentQueued.wait(guard, [this]() -> bool
+                {
+                    return (!(queuedSegments.empty()) || closing || failed);
+                });
+
+                if (failed || queuedSegments.empty())
+                    break;
+
+                segment = queuedSegments.front();
+                queuedSegments.pop_front();
+            }
+
+            size_t compressedSize = 0;
+            bool succeeded;
+
+            if (CompressionFormatGzip == format)
+            {
+                gzipStream.next_in = (Bytef*)segment->data.data();
+                gzipStream.avail_in = (uInt)segment->size;
+                gzipStream.next_out = (Bytef*)compressed.data();
+                gzipStream.avail_out = (uInt)compressed.size();
+
+                succeeded = (Z_STREAM_END == deflate(&gzipStream, Z_FINISH));
+                compressedSize = compressed.size() - (size_t)gzipStream.avail_out;
+
+                if (Z_OK != deflateReset(&gzipStream))
+                    succeeded = false;
+            }
+            else
+            {
+                // Single-shot compression records the decompressed size in the frame header, which allows frames to be decompressed independently.
+                const size_t result = ZSTD_compressCCtx(zstdContext, (void*)compressed.data(), compressed.size(), (const void*)segment->data.data(), segment->size, level);
+
+                succeeded = !ZSTD_isError(result);
+                compressedSize = (succeeded ? result : 0);
+            }
+
+            // Compressed segments are written in order, each by the thread that compressed it once all earlier segments have been written.
+            {
+                std::unique_lock<std::mutex> guard(lock);
+
+                segmentWritten.wait(guard, [this, segment]() -> bool
+                {
+                    return ((numSegmentsWritten == segment->sequenceNumber) || failed);
+                });
+
+                if (failed)
+                    break;
+            }
+
+            if (succeeded)
+                succeeded = (compressedSize == fwrite((const void*)compressed.data(), sizeof(uint8_t), compressedSize, output));
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                if (!succeeded)
+                    failed = true;
+
+                numSegmentsWritten += 1;
+                freeSegments.push_back(segment);
+            }
+
+            segmentWritten.notify_all();
+
+            if (!succeeded)
+            {
+                segmentQueued.notify_all();
+                break;
+            }
+        }
+
+        if (CompressionFormatGzip == format)
+            deflateEnd(&gzipStream);
+        else
+            ZSTD_freeCCtx(zstdContext);
+#endif
+    }
+}
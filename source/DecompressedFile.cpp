@@ -0,0 +1,590 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file DecompressedFile.cpp
+ *   Implementation of a file backend that transparently decompresses gzip
+ *   and zstd compressed files while they are being read.
+ *****************************************************************************/
+
+#include "DecompressedFile.h"
+#include "VersionInfo.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <zstd.h>
+#endif
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Magic bytes at the start of every gzip member.
+    static const uint8_t kGzipMagic[] = { 0x1f, 0x8b };
+
+    /// Magic bytes at the start of every zstd frame, other than skippable frames.
+    static const uint8_t kZstdMagic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+    /// Largest number of compressed bytes passed to zlib at once, since zlib counts available input using 32-bit integers.
+    static const size_t kGzipMaxInputSize = (1ull * 1024ull * 1024ull * 1024ull);
+
+
+    // -------- TYPE DEFINITIONS ------------------------------------------- //
+
+#ifdef __PLATFORM_LINUX
+    /// Holds the state of a decompression stream, which consumes the whole compressed file in order.
+    struct DecompressedFile::SStream
+    {
+        z_stream gzipStream;                                                ///< zlib stream state, used only for gzip files.
+        ZSTD_DStream* zstdStream;                                           ///< libzstd stream state, used only for zstd files.
+        size_t inputPosition;                                               ///< Offset within the compressed file of the next byte to be consumed.
+    };
+#endif
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "DecompressedFile.h" for documentation.
+
+    DecompressedFile::DecompressedFile(void) : format(CompressionFormatNone), fd(-1), input(NULL), inputSize(0), segments(), stream(NULL), slots(), workers(), lock(), segmentReady(), slotFreed(), nextSegment(0), numSegmentsRead(0), numSegments(UINT64_MAX), failed(false), closing(false), holdsSlot(false), currentSlotPosition(0), position(0)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    DecompressedFile::~DecompressedFile(void)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closing = true;
+        }
+
+        slotFreed.notify_all();
+
+        for (auto it = workers.begin(); it != workers.end(); ++it)
+            it->join();
+
+#ifdef __PLATFORM_LINUX
+        if (NULL != stream)
+        {
+            if (CompressionFormatGzip == format)
+                inflateEnd(&stream->gzipStream);
+            else
+                ZSTD_freeDStream(stream->zstdStream);
+
+            delete stream;
+        }
+
+        if (NULL != input)
+            munmap((void*)input, inputSize);
+
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "DecompressedFile.h" for documentation.
+
+    bool DecompressedFile::IsSupported(void)
+    {
+#ifdef __PLATFORM_LINUX
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    bool DecompressedFile::IsCompressed(const char* const filename)
+    {
+#ifdef __PLATFORM_LINUX
+        // Only regular files are checked, since reading the first bytes of anything else, such as a pipe, would consume them.
+        struct stat fileInfo;
+
+        if ((0 != stat(filename, &fileInfo)) || !S_ISREG(fileInfo.st_mode))
+            return false;
+#endif
+
+        FILE* const file = fopen(filename, "rb");
+
+        if (NULL == file)
+            return false;
+
+        uint8_t header[sizeof(kZstdMagic)];
+        const size_t headerSize = fread((void*)header, sizeof(uint8_t), sizeof(header), file);
+
+        fclose(file);
+        return (CompressionFormatNone != DetectFormat(header, headerSize));
+    }
+
+    // --------
+
+    FILE* DecompressedFile::OpenForRead(const char* const filename, const uint32_t numThreads)
+    {
+        DecompressedFile* const decompressedFile = new DecompressedFile();
+
+        if (!(decompressedFile->Initialize(filename, numThreads)))
+        {
+            delete decompressedFile;
+            return NULL;
+        }
+
+        return decompressedFile->OpenStream();
+    }
+
+    // --------
+
+    int DecompressedFile::CookieClose(void* cookie)
+    {
+        DecompressedFile* const decompressedFile = (DecompressedFile*)cookie;
+        bool succeeded;
+
+        {
+            std::lock_guard<std::mutex> guard(decompressedFile->lock);
+            succeeded = !(decompressedFile->failed);
+        }
+
+        delete decompressedFile;
+        return (succeeded ? 0 : -1);
+    }
+
+    // --------
+
+    ptrdiff_t DecompressedFile::CookieRead(void* cookie, char* buf, size_t size)
+    {
+        DecompressedFile* const decompressedFile = (DecompressedFile*)cookie;
+        size_t numRead = 0;
+
+        while (numRead < size)
+        {
+            const uint32_t slotIndex = (uint32_t)(decompressedFile->numSegmentsRead % (uint64_t)decompressedFile->slots.size());
+            SSlot& slot = decompressedFile->slots[slotIndex];
+
+            // Synchronization is needed only to acquire a slot, after which its contents do not change until it is freed.
+            if (!(decompressedFile->holdsSlot))
+            {
+                std::unique_lock<std::mutex> guard(decompressedFile->lock);
+
+                decompressedFile->segmentReady.wait(guard, [decompressedFile, &slot]() -> bool
+                {
+                    return (slot.ready || decompressedFile->failed || (decompressedFile->numSegmentsRead >= decompressedFile->numSegments));
+                });
+
+                // Anything decompressed before an error is still delivered, so that the error is reported at the position where it occurred.
+                if (!(slot.ready))
+                {
+                    if (decompressedFile->failed)
+                        return -1;
+
+                    break;
+                }
+
+                decompressedFile->holdsSlot = true;
+            }
+
+            const size_t numAvailable = slot.size - decompressedFile->currentSlotPosition;
+            const size_t numToCopy = (((size - numRead) < numAvailable) ? (size - numRead) : numAvailable);
+
+            memcpy((void*)&buf[numRead], (const void*)&slot.data[decompressedFile->currentSlotPosition], numToCopy);
+            numRead += numToCopy;
+            decompressedFile->currentSlotPosition += numToCopy;
+            decompressedFile->position += numToCopy;
+
+            // Once a segment is used up, its slot is handed back so that a background thread can decompress a later segment into it.
+            if (decompressedFile->currentSlotPosition == slot.size)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(decompressedFile->lock);
+
+                    slot.ready = false;
+                    decompressedFile->numSegmentsRead += 1;
+                }
+
+                decompressedFile->slotFreed.notify_all();
+                decompressedFile->holdsSlot = false;
+                decompressedFile->currentSlotPosition = 0;
+            }
+        }
+
+        return (ptrdiff_t)numRead;
+    }
+
+    // --------
+
+    int DecompressedFile::CookieSeek(void* cookie, int64_t* offset, int whence)
+    {
+        DecompressedFile* const decompressedFile = (DecompressedFile*)cookie;
+
+        if (((SEEK_CUR == whence) && (0 == *offset)) || ((SEEK_SET == whence) && ((int64_t)decompressedFile->position == *offset)))
+        {
+            *offset = (int64_t)decompressedFile->position;
+            return 0;
+        }
+
+        return -1;
+    }
+
+    // --------
+
+    DecompressedFile::ECompressionFormat DecompressedFile::DetectFormat(const uint8_t* const header, const size_t headerSize)
+    {
+        if ((headerSize >= sizeof(kGzipMagic)) && (0 == memcmp((const void*)header, (const void*)kGzipMagic, sizeof(kGzipMagic))))
+            return CompressionFormatGzip;
+
+        if ((headerSize >= sizeof(kZstdMagic)) && (0 == memcmp((const void*)header, (const void*)kZstdMagic, sizeof(kZstdMagic))))
+            return CompressionFormatZstd;
+
+        return CompressionFormatNone;
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "DecompressedFile.h" for documentation.
+
+    void DecompressedFile::DivideFrames(void)
+    {
+#ifdef __PLATFORM_LINUX
+        std::vector<SSegment> frameGroups;
+        size_t frameOffset = 0;
+        bool independent = true;
+
+        // Frame headers record the decompressed size, and block headers the compressed size, so frame boundaries are found without decompressing anything.
+        while (frameOffset < inputSize)
+        {
+            const size_t frameSize = ZSTD_findFrameCompressedSize((const void*)&input[frameOffset], inputSize - frameOffset);
+
+            // Invalid or truncated frames are left for the stream decoder to report, at the position where the error occurs.
+            if (ZSTD_isError(frameSize))
+                return;
+
+            // Skippable frames, such as the seek table of the seekable format, hold no content and report a decompressed size of 0.
+            const unsigned long long frameContentSize = ZSTD_getFrameContentSize((const void*)&input[frameOffset], inputSize - frameOffset);
+
+            if ((ZSTD_CONTENTSIZE_UNKNOWN == frameContentSize) || (ZSTD_CONTENTSIZE_ERROR == frameContentSize) || (frameContentSize > (unsigned long long)kMaxFrameSize))
+                independent = false;
+
+            // Consecutive small frames are grouped, so that each segment is large enough to amortize the cost of handing it over.
+            // Frames without content always join a group that has some, so that no segment is empty.
+            if (independent)
+            {
+                if (frameGroups.empty() || ((0 != frameGroups.back().outputSize) && ((frameGroups.back().outputSize + (size_t)frameContentSize) > kSegmentSize)))
+                {
+                    SSegment segment;
+
+                    segment.inputOffset = frameOffset;
+                    segment.inputSize = 0;
+                    segment.outputSize = 0;
+                    frameGroups.push_back(segment);
+                }
+
+                frameGroups.back().inputSize += frameSize;
+                frameGroups.back().outputSize += (size_t)frameContentSize;
+            }
+
+            frameOffset += frameSize;
+        }
+
+        if (independent && (frameGroups.size() > 1))
+            segments.swap(frameGroups);
+#endif
+    }
+
+    // --------
+
+    bool DecompressedFile::DecompressStream(SSlot& slot, bool& endOfStream)
+    {
+#ifdef __PLATFORM_LINUX
+        slot.size = 0;
+        endOfStream = false;
+
+        while ((slot.size < slot.data.size()) && !endOfStream)
+        {
+            if (CompressionFormatGzip == format)
+            {
+                z_stream& gzipStream = stream->gzipStream;
+                const size_t inputRemaining = inputSize - stream->inputPosition;
+
+                gzipStream.next_in = (Bytef*)&input[stream->inputPosition];
+                gzipStream.avail_in = (uInt)((inputRemaining < kGzipMaxInputSize) ? inputRemaining : kGzipMaxInputSize);
+                gzipStream.next_out = (Bytef*)&slot.data[slot.size];
+                gzipStream.avail_out = (uInt)(slot.data.size() - slot.size);
+
+                const int result = inflate(&gzipStream, Z_NO_FLUSH);
+                const size_t numConsumed = (size_t)((const uint8_t*)gzipStream.next_in - &input[stream->inputPosition]);
+
+                stream->inputPosition += numConsumed;
+                slot.size = slot.data.size() - (size_t)gzipStream.avail_out;
+
+                if (Z_STREAM_END == result)
+                {
+                    // A gzip file may hold several members, as produced by parallel compressors, whose contents are concatenated.
+                    if (stream->inputPosition < inputSize)
+                    {
+                        if (Z_OK != inflateReset(&gzipStream))
+                            return false;
+                    }
+                    else
+                    {
+                        endOfStream = true;
+                    }
+                }
+                else if (Z_OK != result)
+                {
+                    // Running out of input in the middle of a member means the file is truncated.
+                    return false;
+                }
+            }
+            else
+            {
+                ZSTD_inBuffer inputBuffer = { (const void*)input, inputSize, stream->inputPosition };
+                ZSTD_outBuffer outputBuffer = { (void*)slot.data.data(), slot.data.size(), slot.size };
+
+                const size_t result = ZSTD_decompressStream(stream->zstdStream, &outputBuffer, &inputBuffer);
+
+                if (ZSTD_isError(result))
+                    return false;
+
+                // No progress with input remaining would indicate a truncated frame.
+                if ((inputBuffer.pos == stream->inputPosition) && (outputBuffer.pos == slot.size))
+                    return false;
+
+                stream->inputPosition = inputBuffer.pos;
+                slot.size = outputBuffer.pos;
+
+                if ((0 == result) && (stream->inputPosition == inputSize))
+                    endOfStream = true;
+            }
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    bool DecompressedFile::Initialize(const char* const filename, const uint32_t numThreads)
+    {
+#ifdef __PLATFORM_LINUX
+        fd = open(filename, O_RDONLY);
+
+        if (fd < 0)
+            return false;
+
+        struct stat fileInfo;
+
+        if ((0 != fstat(fd, &fileInfo)) || !S_ISREG(fileInfo.st_mode) || (0 == fileInfo.st_size))
+            return false;
+
+        void* const mapping = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (MAP_FAILED == mapping)
+            return false;
+
+        // Compressed data are consumed front to back exactly once, at least within each segment.
+        madvise(mapping, (size_t)fileInfo.st_size, MADV_SEQUENTIAL);
+
+        input = (const uint8_t*)mapping;
+        inputSize = (size_t)fileInfo.st_size;
+        format = DetectFormat(input, inputSize);
+
+        if (CompressionFormatNone == format)
+            return false;
+
+        if ((CompressionFormatZstd == format) && (numThreads > 1))
+            DivideFrames();
+
+        // Independent segments are decompressed by several threads, each of which needs a slot to fill while the reader is busy with an earlier one.
+        // A single stream is decompressed one slot ahead of the reader.
+        const uint32_t numWorkers = (segments.empty() ? 1 : ((numThreads < (uint32_t)segments.size()) ? numThreads : (uint32_t)segments.size()));
+        size_t slotSize = kSegmentSize;
+
+        if (segments.empty())
+        {
+            stream = new SStream;
+            stream->zstdStream = NULL;
+            stream->inputPosition = 0;
+
+            if (CompressionFormatGzip == format)
+            {
+                memset((void*)&stream->gzipStream, 0, sizeof(stream->gzipStream));
+
+                // Adding 16 to the window size selects the gzip wrapper.
+                if (Z_OK != inflateInit2(&stream->gzipStream, 15 + 16))
+                {
+                    delete stream;
+                    stream = NULL;
+                    return false;
+                }
+            }
+            else
+            {
+                stream->zstdStream = ZSTD_createDStream();
+
+                if ((NULL == stream->zstdStream) || ZSTD_isError(ZSTD_initDStream(stream->zstdStream)))
+                {
+                    if (NULL != stream->zstdStream)
+                        ZSTD_freeDStream(stream->zstdStream);
+
+                    delete stream;
+                    stream = NULL;
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            numSegments = (uint64_t)segments.size();
+
+            for (auto it = segments.begin(); it != segments.end(); ++it)
+            {
+                if (it->outputSize > slotSize)
+                    slotSize = it->outputSize;
+            }
+        }
+
+        slots.resize(numWorkers << 1);
+
+        for (auto it = slots.begin(); it != slots.end(); ++it)
+        {
+            it->data.resize(slotSize);
+            it->size = 0;
+            it->ready = false;
+        }
+
+        // Background threads are independent of the Spindle threads that read the graph, since they run for as long as the file is open, including between read passes.
+        for (uint32_t i = 0; i < numWorkers; ++i)
+            workers.push_back(std::thread(&DecompressedFile::Worker, this));
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    FILE* DecompressedFile::OpenStream(void)
+    {
+#ifdef __PLATFORM_LINUX
+        cookie_io_functions_t functions;
+
+        functions.read = &CookieRead;
+        functions.write = NULL;
+        functions.seek = &CookieSeek;
+        functions.close = &CookieClose;
+
+        FILE* const stream = fopencookie((void*)this, "rb", functions);
+
+        if (NULL == stream)
+            delete this;
+
+        return stream;
+#else
+        delete this;
+        return NULL;
+#endif
+    }
+
+    // --------
+
+    void DecompressedFile::Worker(void)
+    {
+#ifdef __PLATFORM_LINUX
+        ZSTD_DCtx* const zstdContext = (segments.empty() ? NULL : ZSTD_createDCtx());
+
+        if (!(segments.empty()) && (NULL == zstdContext))
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            failed = true;
+            segmentReady.notify_all();
+            return;
+        }
+
+        while (true)
+        {
+            uint64_t segment;
+
+            // Claim the next segment and wait for the reader to free the slot into which it is to be decompressed.
+            {
+                std::unique_lock<std::mutex> guard(lock);
+
+                if (closing || failed || (nextSegment >= numSegments))
+                    break;
+
+                segment = nextSegment;
+                nextSegment += 1;
+
+                slotFreed.wait(guard, [this, segment]() -> bool
+                {
+                    return (closing || (segment < (numSegmentsRead + (uint64_t)slots.size())));
+                });
+
+                if (closing)
+                    break;
+            }
+
+            SSlot& slot = slots[segment % (uint64_t)slots.size()];
+            bool succeeded = true;
+            bool endOfStream = false;
+
+            if (segments.empty())
+            {
+                succeeded = DecompressStream(slot, endOfStream);
+            }
+            else
+            {
+                const SSegment& segmentInfo = segments[segment];
+                const size_t result = ZSTD_decompressDCtx(zstdContext, (void*)slot.data.data(), slot.data.size(), (const void*)&input[segmentInfo.inputOffset], segmentInfo.inputSize);
+
+                succeeded = (!ZSTD_isError(result) && (result == segmentInfo.outputSize));
+                slot.size = (succeeded ? result : 0);
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                if (!succeeded)
+                    failed = true;
+
+                if (0 != slot.size)
+                    slot.ready = true;
+
+                // The end of a single stream is known only once it is reached, and an empty final segment is not handed to the reader at all.
+                if (endOfStream)
+                    numSegments = ((0 != slot.size) ? (segment + 1) : segment);
+            }
+
+            segmentReady.notify_all();
+
+            if (!succeeded || endOfStream)
+                break;
+        }
+
+        if (NULL != zstdContext)
+            ZSTD_freeDCtx(zstdContext);
+#endif
+    }
+}
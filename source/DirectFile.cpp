@@ -0,0 +1,628 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file DirectFile.cpp
+ *   Implementation of a file backend that reads and writes sequentially using
+ *   asynchronous direct I/O.
+ *****************************************************************************/
+
+#include "DirectFile.h"
+#include "VersionInfo.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifdef __PLATFORM_LINUX
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+
+namespace GraphTool
+{
+#ifdef __PLATFORM_LINUX
+    // -------- TYPE DEFINITIONS ------------------------------------------- //
+    // See "DirectFile.h" for documentation.
+
+    struct DirectFile::SRing
+    {
+        int fd;                                                             ///< Descriptor of the io_uring instance.
+        void* submissionRing;                                               ///< Mapping of the submission queue ring.
+        size_t submissionRingSize;                                          ///< Size of the mapping of the submission queue ring, in bytes.
+        void* completionRing;                                               ///< Mapping of the completion queue ring, which may be the same as that of the submission queue ring.
+        size_t completionRingSize;                                          ///< Size of the mapping of the completion queue ring, in bytes.
+        struct io_uring_sqe* submissionEntries;                             ///< Mapping of the submission queue entries.
+        size_t submissionEntriesSize;                                       ///< Size of the mapping of the submission queue entries, in bytes.
+        uint32_t* submissionTail;                                           ///< Tail of the submission queue, advanced by this process.
+        uint32_t* submissionMask;                                           ///< Mask that converts a submission queue position into an index.
+        uint32_t* submissionArray;                                          ///< Indirection array that identifies the entry at each submission queue position.
+        uint32_t* completionHead;                                           ///< Head of the completion queue, advanced by this process.
+        uint32_t* completionTail;                                           ///< Tail of the completion queue, advanced by the kernel.
+        uint32_t* completionMask;                                           ///< Mask that converts a completion queue position into an index.
+        struct io_uring_cqe* completionEntries;                             ///< Completion queue entries.
+        std::vector<struct iovec> vectors;                                  ///< Vector that describes the memory of each block, which must remain valid while its request is in flight.
+    };
+#endif
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "DirectFile.h" for documentation.
+
+    DirectFile::DirectFile(void) : fd(-1), forWrite(false), usesDirectIO(false), failed(false), blocks(), currentBlock(0), currentBlockPosition(0), nextBlockOffset(0), fileSize(0), position(0), ring(NULL)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    DirectFile::~DirectFile(void)
+    {
+#ifdef __PLATFORM_LINUX
+        // The kernel may still be transferring to or from block memory, so it cannot be freed until every request completes.
+        for (uint32_t i = 0; i < (uint32_t)blocks.size(); ++i)
+            WaitForBlock(i);
+
+        for (auto it = blocks.begin(); it != blocks.end(); ++it)
+            free((void*)it->data);
+
+        if (NULL != ring)
+            DestroyRing(ring);
+
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "DirectFile.h" for documentation.
+
+    bool DirectFile::IsSupported(void)
+    {
+#ifdef __PLATFORM_LINUX
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    FILE* DirectFile::OpenForRead(const char* const filename, const uint32_t queueDepth)
+    {
+        DirectFile* const directFile = new DirectFile();
+
+        if (!(directFile->Initialize(filename, false, queueDepth)))
+        {
+            delete directFile;
+            return NULL;
+        }
+
+        return directFile->OpenStream();
+    }
+
+    // --------
+
+    FILE* DirectFile::OpenForWrite(const char* const filename, const uint32_t queueDepth)
+    {
+        DirectFile* const directFile = new DirectFile();
+
+        if (!(directFile->Initialize(filename, true, queueDepth)))
+        {
+            delete directFile;
+            return NULL;
+        }
+
+        return directFile->OpenStream();
+    }
+
+    // --------
+
+    int DirectFile::CookieClose(void* cookie)
+    {
+        DirectFile* const directFile = (DirectFile*)cookie;
+        bool succeeded = !(directFile->failed);
+
+#ifdef __PLATFORM_LINUX
+        if (directFile->forWrite && succeeded)
+        {
+            // The last block is usually only partially filled, but direct I/O can only write whole aligned units, so it is padded and the file is then truncated to its true size.
+            if (0 != directFile->currentBlockPosition)
+            {
+                SBlock& block = directFile->blocks[directFile->currentBlock];
+                size_t size = directFile->currentBlockPosition;
+
+                if (directFile->usesDirectIO)
+                {
+                    size = (size + (kBlockAlignment - 1)) & ~(kBlockAlignment - 1);
+                    memset((void*)&block.data[directFile->currentBlockPosition], 0, size - directFile->currentBlockPosition);
+                }
+
+                succeeded = directFile->SubmitBlock(directFile->currentBlock, directFile->nextBlockOffset, size);
+            }
+
+            for (uint32_t i = 0; i < (uint32_t)directFile->blocks.size(); ++i)
+            {
+                if (!(directFile->WaitForBlock(i)))
+                    succeeded = false;
+            }
+
+            if (succeeded && directFile->usesDirectIO && (0 != ftruncate(directFile->fd, (off_t)directFile->position)))
+                succeeded = false;
+        }
+#endif
+
+        delete directFile;
+        return (succeeded ? 0 : -1);
+    }
+
+    // --------
+
+    ptrdiff_t DirectFile::CookieRead(void* cookie, char* buf, size_t size)
+    {
+        DirectFile* const directFile = (DirectFile*)cookie;
+        size_t numRead = 0;
+
+        if (directFile->failed || directFile->forWrite)
+            return -1;
+
+#ifdef __PLATFORM_LINUX
+        while (numRead < size)
+        {
+            SBlock& block = directFile->blocks[directFile->currentBlock];
+
+            // A block for which no request was made lies past the end of the file.
+            if (0 == block.size)
+                break;
+
+            if (!(directFile->WaitForBlock(directFile->currentBlock)))
+            {
+                directFile->failed = true;
+                return -1;
+            }
+
+            const size_t numAvailable = (size_t)block.result - directFile->currentBlockPosition;
+            const size_t numToCopy = (((size - numRead) < numAvailable) ? (size - numRead) : numAvailable);
+
+            memcpy((void*)&buf[numRead], (const void*)&block.data[directFile->currentBlockPosition], numToCopy);
+            numRead += numToCopy;
+            directFile->currentBlockPosition += numToCopy;
+            directFile->position += numToCopy;
+
+            // Once a block is used up, it is immediately reused to request the next block that has not yet been requested, which keeps the ring full.
+            if (directFile->currentBlockPosition == (size_t)block.result)
+            {
+                directFile->ReleaseCachedBlock(block);
+
+                if (directFile->nextBlockOffset < directFile->fileSize)
+                {
+                    if (!(directFile->SubmitBlock(directFile->currentBlock, directFile->nextBlockOffset, kBlockSize)))
+                    {
+                        directFile->failed = true;
+                        return -1;
+                    }
+
+                    directFile->nextBlockOffset += kBlockSize;
+                }
+                else
+                {
+                    block.size = 0;
+                }
+
+                directFile->currentBlock = (directFile->currentBlock + 1) % (uint32_t)directFile->blocks.size();
+                directFile->currentBlockPosition = 0;
+            }
+        }
+#endif
+
+        return (ptrdiff_t)numRead;
+    }
+
+    // --------
+
+    int DirectFile::CookieSeek(void* cookie, int64_t* offset, int whence)
+    {
+        DirectFile* const directFile = (DirectFile*)cookie;
+
+        if (((SEEK_CUR == whence) && (0 == *offset)) || ((SEEK_SET == whence) && ((int64_t)directFile->position == *offset)))
+        {
+            *offset = (int64_t)directFile->position;
+            return 0;
+        }
+
+        return -1;
+    }
+
+    // --------
+
+    ptrdiff_t DirectFile::CookieWrite(void* cookie, const char* buf, size_t size)
+    {
+        DirectFile* const directFile = (DirectFile*)cookie;
+        size_t numWritten = 0;
+
+        if (directFile->failed || !(directFile->forWrite))
+            return 0;
+
+#ifdef __PLATFORM_LINUX
+        while (numWritten < size)
+        {
+            SBlock& block = directFile->blocks[directFile->currentBlock];
+            const size_t numAvailable = kBlockSize - directFile->currentBlockPosition;
+            const size_t numToCopy = (((size - numWritten) < numAvailable) ? (size - numWritten) : numAvailable);
+
+            memcpy((void*)&block.data[directFile->currentBlockPosition], (const void*)&buf[numWritten], numToCopy);
+            numWritten += numToCopy;
+            directFile->currentBlockPosition += numToCopy;
+            directFile->position += numToCopy;
+
+            // Full blocks are written in the background, and the next block can be filled only once its previous request has completed.
+            if (kBlockSize == directFile->currentBlockPosition)
+            {
+                if (!(directFile->SubmitBlock(directFile->currentBlock, directFile->nextBlockOffset, kBlockSize)))
+                {
+                    directFile->failed = true;
+                    return 0;
+                }
+
+                directFile->nextBlockOffset += kBlockSize;
+                directFile->currentBlock = (directFile->currentBlock + 1) % (uint32_t)directFile->blocks.size();
+                directFile->currentBlockPosition = 0;
+
+                if (!(directFile->WaitForBlock(directFile->currentBlock)))
+                {
+                    directFile->failed = true;
+                    return 0;
+                }
+            }
+        }
+#endif
+
+        return (ptrdiff_t)numWritten;
+    }
+
+
+    // --------
+
+#ifdef __PLATFORM_LINUX
+    DirectFile::SRing* DirectFile::CreateRing(const uint32_t numEntries)
+    {
+        struct io_uring_params params;
+        memset((void*)&params, 0, sizeof(params));
+
+        const int ringFD = (int)syscall(__NR_io_uring_setup, numEntries, &params);
+
+        if (ringFD < 0)
+            return NULL;
+
+        SRing* const ring = new SRing();
+
+        ring->fd = ringFD;
+        ring->submissionRingSize = params.sq_off.array + (params.sq_entries * sizeof(uint32_t));
+        ring->completionRingSize = params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+        ring->submissionEntriesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+        // Newer kernels map both rings together, in which case the mapping must be large enough for either.
+        if (0 != (params.features & IORING_FEAT_SINGLE_MMAP))
+        {
+            if (ring->completionRingSize > ring->submissionRingSize)
+                ring->submissionRingSize = ring->completionRingSize;
+
+            ring->completionRingSize = ring->submissionRingSize;
+        }
+
+        ring->submissionRing = mmap(NULL, ring->submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQ_RING);
+        ring->completionRing = MAP_FAILED;
+        ring->submissionEntries = (struct io_uring_sqe*)MAP_FAILED;
+
+        if (MAP_FAILED != ring->submissionRing)
+        {
+            if (0 != (params.features & IORING_FEAT_SINGLE_MMAP))
+                ring->completionRing = ring->submissionRing;
+            else
+                ring->completionRing = mmap(NULL, ring->completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_CQ_RING);
+
+            ring->submissionEntries = (struct io_uring_sqe*)mmap(NULL, ring->submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQES);
+        }
+
+        if ((MAP_FAILED == ring->submissionRing) || (MAP_FAILED == ring->completionRing) || (MAP_FAILED == (void*)ring->submissionEntries))
+        {
+            DestroyRing(ring);
+            return NULL;
+        }
+
+        ring->submissionTail = (uint32_t*)((uint8_t*)ring->submissionRing + params.sq_off.tail);
+        ring->submissionMask = (uint32_t*)((uint8_t*)ring->submissionRing + params.sq_off.ring_mask);
+        ring->submissionArray = (uint32_t*)((uint8_t*)ring->submissionRing + params.sq_off.array);
+        ring->completionHead = (uint32_t*)((uint8_t*)ring->completionRing + params.cq_off.head);
+        ring->completionTail = (uint32_t*)((uint8_t*)ring->completionRing + params.cq_off.tail);
+        ring->completionMask = (uint32_t*)((uint8_t*)ring->completionRing + params.cq_off.ring_mask);
+        ring->completionEntries = (struct io_uring_cqe*)((uint8_t*)ring->completionRing + params.cq_off.cqes);
+
+        return ring;
+    }
+
+    // --------
+
+    void DirectFile::DestroyRing(SRing* const ring)
+    {
+        if (MAP_FAILED != (void*)ring->submissionEntries)
+            munmap((void*)ring->submissionEntries, ring->submissionEntriesSize);
+
+        if ((MAP_FAILED != ring->completionRing) && (ring->completionRing != ring->submissionRing))
+            munmap(ring->completionRing, ring->completionRingSize);
+
+        if (MAP_FAILED != ring->submissionRing)
+            munmap(ring->submissionRing, ring->submissionRingSize);
+
+        close(ring->fd);
+        delete ring;
+    }
+#else
+    DirectFile::SRing* DirectFile::CreateRing(const uint32_t numEntries)
+    {
+        return NULL;
+    }
+
+    // --------
+
+    void DirectFile::DestroyRing(SRing* const ring)
+    {
+        // Nothing to do here.
+    }
+#endif
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "DirectFile.h" for documentation.
+
+    bool DirectFile::CollectCompletions(const bool wait)
+    {
+#ifdef __PLATFORM_LINUX
+        // Only this process advances the head, but the kernel advances the tail, so the tail must be read with acquire semantics before the entries it covers.
+        uint32_t head = *ring->completionHead;
+        const uint32_t tail = __atomic_load_n(ring->completionTail, __ATOMIC_ACQUIRE);
+
+        if ((head == tail) && wait)
+        {
+            while (syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0)
+            {
+                if (EINTR != errno)
+                    return false;
+            }
+        }
+
+        const uint32_t newTail = __atomic_load_n(ring->completionTail, __ATOMIC_ACQUIRE);
+
+        for (; head != newTail; ++head)
+        {
+            const struct io_uring_cqe& completion = ring->completionEntries[head & *ring->completionMask];
+            SBlock& block = blocks[(size_t)completion.user_data];
+
+            block.result = (int64_t)completion.res;
+            block.pending = false;
+        }
+
+        __atomic_store_n(ring->completionHead, head, __ATOMIC_RELEASE);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    bool DirectFile::Initialize(const char* const filename, const bool forWrite, const uint32_t queueDepth)
+    {
+#ifdef __PLATFORM_LINUX
+        const int flags = (forWrite ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY);
+
+        this->forWrite = forWrite;
+
+        // Not all file systems support direct I/O, in which case the page cache is used after all but released as soon as possible.
+        fd = open(filename, flags | O_DIRECT, 0644);
+        usesDirectIO = (fd >= 0);
+
+        if ((fd < 0) && (EINVAL == errno))
+            fd = open(filename, flags, 0644);
+
+        if (fd < 0)
+            return false;
+
+        if (!forWrite)
+        {
+            struct stat fileInfo;
+
+            if ((0 != fstat(fd, &fileInfo)) || !S_ISREG(fileInfo.st_mode))
+                return false;
+
+            fileSize = (uint64_t)fileInfo.st_size;
+        }
+
+        const uint32_t numBlocks = ((0 == queueDepth) ? 1 : ((queueDepth > kMaxQueueDepth) ? kMaxQueueDepth : queueDepth));
+        blocks.resize(numBlocks);
+
+        for (auto it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            it->data = NULL;
+            it->fileOffset = 0;
+            it->size = 0;
+            it->result = 0;
+            it->pending = false;
+        }
+
+        for (auto it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            if (0 != posix_memalign((void**)&it->data, kBlockAlignment, kBlockSize))
+            {
+                it->data = NULL;
+                return false;
+            }
+        }
+
+        ring = CreateRing(numBlocks);
+
+        if (NULL != ring)
+        {
+            ring->vectors.resize(numBlocks);
+
+            for (uint32_t i = 0; i < numBlocks; ++i)
+            {
+                ring->vectors[i].iov_base = (void*)blocks[i].data;
+                ring->vectors[i].iov_len = kBlockSize;
+            }
+        }
+
+        // Readers start by requesting as much of the file as the ring can hold.
+        if (!forWrite)
+        {
+            for (uint32_t i = 0; (i < numBlocks) && (nextBlockOffset < fileSize); ++i)
+            {
+                if (!SubmitBlock(i, nextBlockOffset, kBlockSize))
+                    return false;
+
+                nextBlockOffset += kBlockSize;
+            }
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    FILE* DirectFile::OpenStream(void)
+    {
+#ifdef __PLATFORM_LINUX
+        cookie_io_functions_t functions;
+
+        functions.read = &CookieRead;
+        functions.write = &CookieWrite;
+        functions.seek = &CookieSeek;
+        functions.close = &CookieClose;
+
+        FILE* const stream = fopencookie((void*)this, (forWrite ? "wb" : "rb"), functions);
+
+        if (NULL == stream)
+            delete this;
+
+        return stream;
+#else
+        delete this;
+        return NULL;
+#endif
+    }
+
+    // --------
+
+    void DirectFile::ReleaseCachedBlock(const SBlock& block) const
+    {
+#ifdef __PLATFORM_LINUX
+        if (!usesDirectIO && (block.result > 0))
+            posix_fadvise(fd, (off_t)block.fileOffset, (off_t)block.result, POSIX_FADV_DONTNEED);
+#endif
+    }
+
+    // --------
+
+    bool DirectFile::SubmitBlock(const uint32_t blockIndex, const uint64_t fileOffset, const size_t size)
+    {
+#ifdef __PLATFORM_LINUX
+        SBlock& block = blocks[blockIndex];
+
+        block.fileOffset = fileOffset;
+        block.size = size;
+        block.result = 0;
+
+        if (NULL == ring)
+        {
+            const ssize_t result = (forWrite ? pwrite(fd, (const void*)block.data, size, (off_t)fileOffset) : pread(fd, (void*)block.data, size, (off_t)fileOffset));
+
+            block.result = ((result < 0) ? (int64_t)(-errno) : (int64_t)result);
+            block.pending = false;
+            return true;
+        }
+
+        // Only this process touches the submission queue tail, so the entry can be filled in before the tail is published with release semantics.
+        const uint32_t tail = *ring->submissionTail;
+        const uint32_t index = tail & *ring->submissionMask;
+        struct io_uring_sqe& submission = ring->submissionEntries[index];
+
+        ring->vectors[blockIndex].iov_len = size;
+
+        memset((void*)&submission, 0, sizeof(submission));
+        submission.opcode = (uint8_t)(forWrite ? IORING_OP_WRITEV : IORING_OP_READV);
+        submission.fd = fd;
+        submission.addr = (uint64_t)(uintptr_t)&ring->vectors[blockIndex];
+        submission.len = 1;
+        submission.off = fileOffset;
+        submission.user_data = (uint64_t)blockIndex;
+
+        ring->submissionArray[index] = index;
+        block.pending = true;
+        __atomic_store_n(ring->submissionTail, tail + 1, __ATOMIC_RELEASE);
+
+        while (syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0) < 0)
+        {
+            if (EINTR != errno)
+            {
+                block.pending = false;
+                return false;
+            }
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // --------
+
+    bool DirectFile::WaitForBlock(const uint32_t blockIndex)
+    {
+        SBlock& block = blocks[blockIndex];
+
+        if (0 == block.size)
+            return true;
+
+        while (block.pending)
+        {
+            if (!CollectCompletions(true))
+            {
+                block.pending = false;
+                block.result = -1;
+                break;
+            }
+        }
+
+        if (block.result < 0)
+            return false;
+
+        if (forWrite)
+        {
+            ReleaseCachedBlock(block);
+            return ((size_t)block.result == block.size);
+        }
+
+        // Reads stop short only at the end of the file.
+        const uint64_t expectedSize = (((fileSize - block.fileOffset) < (uint64_t)block.size) ? (fileSize - block.fileOffset) : (uint64_t)block.size);
+        return ((uint64_t)block.result >= expectedSize);
+    }
+}
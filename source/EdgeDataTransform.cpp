@@ -14,8 +14,13 @@
 #include "EdgeList.h"
 #include "EdgeDataTransform.h"
 #include "Graph.h"
+#include "HashEdgeDataTransform.h"
+#include "NullEdgeDataTransform.h"
+#include "NUMASpawner.h"
+#include "RandomEdgeDataTransform.h"
 #include "Types.h"
 #include "VertexIndex.h"
+#include "WorkScheduler.h"
 
 #include <cstddef>
 #include <cstdint>
@@ -25,54 +30,153 @@
 
 namespace GraphTool
 {
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "EdgeDataTransform.h" for documentation.
+    
+    template <typename TEdgeData, typename TEdgeDataGenerator> void EdgeDataTransform<TEdgeData, TEdgeDataGenerator>::TransformVertexIndex(VertexIndex& vertexIndex, const bool topLevelIsDestination)
+    {
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+        const TCompactVertexID* const neighborsCompact = vertexIndex.GetFrozenNeighborsCompact();
+        const TVertexID* const neighbors = vertexIndex.GetFrozenNeighbors();
+        UEdgeData* const edgeData = vertexIndex.GetFrozenEdgeDataWritable();
+        
+        // Every edge is generated independently, so the edges of a single vertex can be split among several units of work.
+        workScheduler.ParallelInitialize(offsets, vertexIndex.GetNumVertices(), true);
+        
+        SWorkUnit unit;
+        
+        while (workScheduler.GetWork(unit))
+        {
+            for (TVertexID vertex = unit.vertexStart; vertex < unit.vertexEnd; ++vertex)
+            {
+                const TEdgeID firstEdge = unit.FirstEdge(offsets, vertex);
+                const size_t numEdges = (size_t)(unit.LastEdge(offsets, vertex) - firstEdge);
+                
+                if (NULL != neighborsCompact)
+                    static_cast<const TEdgeDataGenerator*>(this)->GenerateEdgeDataBatch(vertex, topLevelIsDestination, &neighborsCompact[firstEdge], &edgeData[firstEdge], numEdges);
+                else
+                    static_cast<const TEdgeDataGenerator*>(this)->GenerateEdgeDataBatch(vertex, topLevelIsDestination, &neighbors[firstEdge], &edgeData[firstEdge], numEdges);
+            }
+        }
+    }
+    
+    
     // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
     // See "GraphTransform.h" for documentation.
     
-    template <typename TEdgeData> EGraphResult EdgeDataTransform<TEdgeData>::TransformGraph(Graph& graph)
+    template <typename TEdgeData, typename TEdgeDataGenerator> EGraphResult EdgeDataTransform<TEdgeData, TEdgeDataGenerator>::TransformGraph(Graph& graph)
     {
-        // Dynamically schedule work on the basis of vertices.
-        void* scheduler = NULL;
-        const TVertexID numUnits = (TVertexID)graph.GetNumVertices();
-        const TVertexID firstUnit = (TVertexID)parutilSchedulerDynamicInit(numUnits, &scheduler);
+        if (0 == spindleGetGlobalThreadID())
+            BeginFusedTransformation(graph);
+        
+        spindleBarrierGlobal();
         
-        if (NULL == scheduler)
-            return EGraphResult::GraphResultErrorUnknown;
+        // Edge weight values are set in both the source-grouped and destination-grouped edge lists, skipping any grouping that the graph does not maintain.
+        const bool hasEdgesByDestination = graph.HasEdgesByDestination();
+        const bool hasEdgesBySource = graph.HasEdgesBySource();
         
-        // Each unit of work involves setting edge weight values for both the source-grouped and destination-grouped edge lists.
-        for (TVertexID vertex = firstUnit; vertex < numUnits; vertex = (TVertexID)parutilSchedulerDynamicGetWork(scheduler))
+        if (graph.IsFrozen())
+        {
+            if (hasEdgesByDestination)
+                TransformVertexIndex(graph.VertexIndexDestinationWritable(), true);
+            
+            if (hasEdgesBySource)
+                TransformVertexIndex(graph.VertexIndexSourceWritable(), false);
+        }
+        else
         {
-            if (0 != graph.GetVertexIndegree(vertex))
+            // Each task works on the vertices stored on its own NUMA node, dynamically scheduling work among its threads on the basis of vertices.
+            uint64_t taskRangeStart = 0;
+            uint64_t taskRangeEnd = 0;
+            NUMASpawner::GetCurrentTaskUnitRange(graph.GetNumVertices(), taskRangeStart, taskRangeEnd);
+            
+            void* scheduler = NULL;
+            const TVertexID numUnits = (TVertexID)(taskRangeEnd - taskRangeStart);
+            const TVertexID firstUnit = (TVertexID)parutilSchedulerDynamicInit(numUnits, &scheduler);
+            
+            if (NULL == scheduler)
+                return EGraphResult::GraphResultErrorUnknown;
+            
+            for (TVertexID unit = firstUnit; unit < numUnits; unit = (TVertexID)parutilSchedulerDynamicGetWork(scheduler))
             {
-                const Graph::WritableVertexIterator vertexIterator = graph.VertexIteratorDestinationAtWritable(vertex);
+                const TVertexID vertex = (TVertexID)taskRangeStart + unit;
                 
-                for (auto edgeIterator = (*vertexIterator)->BeginIteratorWritable(); edgeIterator != (*vertexIterator)->EndIteratorWritable(); ++edgeIterator)
+                if (hasEdgesByDestination && (0 != graph.GetVertexIndegree(vertex)))
                 {
-                    edgeIterator->edgeData = GenerateEdgeData(edgeIterator->otherVertex, vertex, edgeIterator->edgeData);
+                    const Graph::WritableVertexIterator vertexIterator = graph.VertexIteratorDestinationAtWritable(vertex);
+                    
+                    for (auto edgeIterator = (*vertexIterator)->BeginIteratorWritable(); edgeIterator != (*vertexIterator)->EndIteratorWritable(); ++edgeIterator)
+                    {
+                        edgeIterator.SetEdgeData(static_cast<const TEdgeDataGenerator*>(this)->GenerateEdgeData(edgeIterator.GetOtherVertex(), vertex, (TEdgeData)edgeIterator.GetEdgeData()));
+                    }
                 }
-            }
-            
-            if (0 != graph.GetVertexOutdegree(vertex))
-            {
-                const Graph::WritableVertexIterator vertexIterator = graph.VertexIteratorSourceAtWritable(vertex);
                 
-                for (auto edgeIterator = (*vertexIterator)->BeginIteratorWritable(); edgeIterator != (*vertexIterator)->EndIteratorWritable(); ++edgeIterator)
+                if (hasEdgesBySource && (0 != graph.GetVertexOutdegree(vertex)))
                 {
-                    edgeIterator->edgeData = GenerateEdgeData(vertex, edgeIterator->otherVertex, edgeIterator->edgeData);
+                    const Graph::WritableVertexIterator vertexIterator = graph.VertexIteratorSourceAtWritable(vertex);
+                    
+                    for (auto edgeIterator = (*vertexIterator)->BeginIteratorWritable(); edgeIterator != (*vertexIterator)->EndIteratorWritable(); ++edgeIterator)
+                    {
+                        edgeIterator.SetEdgeData(static_cast<const TEdgeDataGenerator*>(this)->GenerateEdgeData(vertex, edgeIterator.GetOtherVertex(), (TEdgeData)edgeIterator.GetEdgeData()));
+                    }
                 }
             }
+            
+            parutilSchedulerDynamicExit(scheduler);
         }
         
-        parutilSchedulerDynamicExit(scheduler);
-        
-        if (0 == spindleGetLocalThreadID())
-            graph.SetEdgeDataType<TEdgeData>();
+        if (0 == spindleGetGlobalThreadID())
+            EndFusedTransformation(graph);
         
         return EGraphResult::GraphResultSuccess;
     }
     
     
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphTransform.h" for documentation.
+    
+    template <typename TEdgeData, typename TEdgeDataGenerator> void EdgeDataTransform<TEdgeData, TEdgeDataGenerator>::BeginFusedTransformation(Graph& graph)
+    {
+        // A graph read without edge data needs somewhere to put the generated values.
+        graph.AllocateEdgeData();
+    }
+    
+    // --------
+    
+    template <typename TEdgeData, typename TEdgeDataGenerator> bool EdgeDataTransform<TEdgeData, TEdgeDataGenerator>::CanFuseTransformation(void) const
+    {
+        return true;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData, typename TEdgeDataGenerator> void EdgeDataTransform<TEdgeData, TEdgeDataGenerator>::EndFusedTransformation(Graph& graph)
+    {
+        graph.SetEdgeDataType<TEdgeData>();
+    }
+    
+    // --------
+    
+    template <typename TEdgeData, typename TEdgeDataGenerator> size_t EdgeDataTransform<TEdgeData, TEdgeDataGenerator>::TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count)
+    {
+        static_cast<const TEdgeDataGenerator*>(this)->GenerateEdgeDataBatch(topLevelVertex, topLevelIsDestination, neighbors, edgeData, count);
+        return count;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData, typename TEdgeDataGenerator> size_t EdgeDataTransform<TEdgeData, TEdgeDataGenerator>::TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count)
+    {
+        static_cast<const TEdgeDataGenerator*>(this)->GenerateEdgeDataBatch(topLevelVertex, topLevelIsDestination, neighbors, edgeData, count);
+        return count;
+    }
+    
+    
     // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
 
-    template class EdgeDataTransform<uint64_t>;
-    template class EdgeDataTransform<double>;
+    template class EdgeDataTransform<uint64_t, HashEdgeDataTransform>;
+    template class EdgeDataTransform<uint64_t, NullEdgeDataTransform<uint64_t>>;
+    template class EdgeDataTransform<double, NullEdgeDataTransform<double>>;
+    template class EdgeDataTransform<uint64_t, RandomEdgeDataTransform<uint64_t>>;
+    template class EdgeDataTransform<double, RandomEdgeDataTransform<double>>;
 }
@@ -11,56 +11,167 @@
  *   single top-level vertex, optimized for easy modification.
  *****************************************************************************/
 
+#include "Arena.h"
 #include "EdgeList.h"
 #include "Types.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
 
 namespace GraphTool
 {
     // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
     // See "EdgeList.h" for documentation.
     
-    EdgeList::EdgeList(void) : edgeList(), degree(0), numVectors(0)
+    EdgeList::EdgeList(Arena& arena, const bool hasEdgeData) : arena(&arena), firstBlock(NULL), appendBlock(NULL), degree(0), numVectors(0), hasEdgeData(hasEdgeData)
     {
         // Nothing to do here.
     }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "EdgeList.h" for documentation.
+
+    uint64_t EdgeList::EstimateBlockBytes(const TEdgeCount numEdges, const uint64_t numEdgeLists, const bool hasEdgeData)
+    {
+        // Only the last block of each list has unused capacity, and it can hold no more than the edges before it plus the initial capacity, nor more than the largest capacity.
+        const uint64_t edgeSize = (uint64_t)sizeof(TVertexID) + (hasEdgeData ? (uint64_t)sizeof(UEdgeData) : 0ull);
+        const uint64_t unusedCapacityLimit = numEdges + (kInitialBlockCapacity * numEdgeLists);
+        const uint64_t unusedCapacity = ((unusedCapacityLimit < (kMaxBlockCapacity * numEdgeLists)) ? unusedCapacityLimit : (kMaxBlockCapacity * numEdgeLists));
+        
+        // Every block other than the last in each list is full and holds at least as many edges as the first.
+        const uint64_t blockHeaderSize = ((uint64_t)sizeof(SEdgeBlock) + (Arena::kAllocationAlignment - 1)) & ~(uint64_t)(Arena::kAllocationAlignment - 1);
+        const uint64_t numBlocks = numEdgeLists + (numEdges / kInitialBlockCapacity);
+
+        return (edgeSize * (numEdges + unusedCapacity)) + (blockHeaderSize * numBlocks);
+    }
     
     
     // -------- HELPERS ---------------------------------------------------- //
     // See "EdgeList.h" for documentation.
 
-    template <typename TEdgeData> void EdgeList::FillEdgeInfoFromEdge(SIndexedEdge& edgeInfo, const SEdge<TEdgeData>& edge, bool useDestinationVertex)
+    template <typename TEdgeData> void EdgeList::AppendEdge(const TVertexID otherVertex, const SEdge<TEdgeData>& edge)
     {
-        edgeInfo.otherVertex = (useDestinationVertex ? edge.destinationVertex : edge.sourceVertex);
-        edgeInfo.edgeData = edge.edgeData;
+        SEdgeBlock* const block = ReserveAppendBlock();
+
+        BlockNeighbors(block)[block->count] = otherVertex;
+
+        if (hasEdgeData)
+            BlockEdgeData(block)[block->count] = edge.edgeData;
+
+        block->count += 1;
+        degree += 1;
+
+        if (1 == (degree & 3))
+            numVectors += 1;
     }
 
     // --------
 
-    template <> void EdgeList::FillEdgeInfoFromEdge(SIndexedEdge& edgeInfo, const SEdge<void>& edge, bool useDestinationVertex)
+    template <> void EdgeList::AppendEdge(const TVertexID otherVertex, const SEdge<void>& edge)
     {
-        edgeInfo.otherVertex = (useDestinationVertex ? edge.destinationVertex : edge.sourceVertex);
-        edgeInfo.edgeData.Invalidate();
+        SEdgeBlock* const block = ReserveAppendBlock();
+
+        BlockNeighbors(block)[block->count] = otherVertex;
+
+        // Lists of unweighted edges do not normally hold edge data, but those that do mark it as absent.
+        if (hasEdgeData)
+            BlockEdgeData(block)[block->count].Invalidate();
+
+        block->count += 1;
+        degree += 1;
+
+        if (1 == (degree & 3))
+            numVectors += 1;
+    }
+
+    // --------
+
+    EdgeList::SEdgeBlock* EdgeList::ReserveAppendBlock(void)
+    {
+        if ((NULL != appendBlock) && (appendBlock->count < appendBlock->capacity))
+            return appendBlock;
+
+        // Blocks emptied by an earlier removal are reused before any new storage is allocated.
+        if ((NULL != appendBlock) && (NULL != appendBlock->next))
+        {
+            appendBlock = appendBlock->next;
+            return appendBlock;
+        }
+
+        // Each block is twice the size of the one before it, up to a limit, so that short lists waste little space and long lists need few blocks.
+        const uint32_t capacity = ((NULL == appendBlock) ? kInitialBlockCapacity : (((2 * appendBlock->capacity) < kMaxBlockCapacity) ? (2 * appendBlock->capacity) : kMaxBlockCapacity));
+        const size_t edgeSize = sizeof(TVertexID) + (hasEdgeData ? sizeof(UEdgeData) : 0);
+        void* const storage = arena->Allocate(sizeof(SEdgeBlock) + (edgeSize * capacity));
+
+        if (NULL == storage)
+            throw std::bad_alloc();
+
+        SEdgeBlock* const block = (SEdgeBlock*)storage;
+        block->next = NULL;
+        block->count = 0;
+        block->capacity = capacity;
+
+        if (NULL == appendBlock)
+            firstBlock = block;
+        else
+            appendBlock->next = block;
+
+        appendBlock = block;
+        return block;
     }
 
     
     // -------- INSTANCE METHODS ------------------------------------------- //
     // See "EdgeList.h" for documentation.
     
+    void EdgeList::AllocateEdgeData(void)
+    {
+        if (hasEdgeData)
+            return;
+        
+        const uint32_t capacity = ((degree > kInitialBlockCapacity) ? (uint32_t)degree : kInitialBlockCapacity);
+        void* const storage = arena->Allocate(sizeof(SEdgeBlock) + ((sizeof(TVertexID) + sizeof(UEdgeData)) * capacity));
+        
+        if (NULL == storage)
+            throw std::bad_alloc();
+        
+        SEdgeBlock* const block = (SEdgeBlock*)storage;
+        block->next = NULL;
+        block->count = 0;
+        block->capacity = capacity;
+        
+        for (EdgeIterator it = BeginIterator(); it != EndIterator(); ++it)
+        {
+            BlockNeighbors(block)[block->count] = it.GetOtherVertex();
+            BlockEdgeData(block)[block->count].Invalidate();
+            block->count += 1;
+        }
+        
+        // The blocks previously used are not needed any longer, but their storage is only reclaimed along with the arena.
+        firstBlock = block;
+        appendBlock = block;
+        hasEdgeData = true;
+    }
+    
+    // --------
+    
     template <typename TEdgeData> void EdgeList::FillEdge(EdgeIterator& position, SEdge<TEdgeData>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const
     {
         if (topLevelIsDestination)
         {
             edge.destinationVertex = topLevelVertex;
-            edge.sourceVertex = position->otherVertex;
+            edge.sourceVertex = position.GetOtherVertex();
         }
         else
         {
-            edge.destinationVertex = position->otherVertex;
+            edge.destinationVertex = position.GetOtherVertex();
             edge.sourceVertex = topLevelVertex;
         }
 
-        edge.edgeData = position->edgeData;
+        edge.edgeData = (TEdgeData)position.GetEdgeData();
     }
 
     // --------
@@ -70,11 +181,11 @@ namespace GraphTool
         if (topLevelIsDestination)
         {
             edge.destinationVertex = topLevelVertex;
-            edge.sourceVertex = position->otherVertex;
+            edge.sourceVertex = position.GetOtherVertex();
         }
         else
         {
-            edge.destinationVertex = position->otherVertex;
+            edge.destinationVertex = position.GetOtherVertex();
             edge.sourceVertex = topLevelVertex;
         }
     }
@@ -83,61 +194,82 @@ namespace GraphTool
     
     template <typename TEdgeData> void EdgeList::InsertEdgeUsingDestination(const SEdge<TEdgeData>& edge)
     {
-        edgeList.emplace_back();
-        FillEdgeInfoFromEdge(edgeList.back(), edge, true);
-        
-        degree += 1;
-        
-        if (1 == (degree & 3))
-            numVectors += 1;
+        AppendEdge(edge.destinationVertex, edge);
     }
     
     // --------
     
     template <typename TEdgeData> void EdgeList::InsertEdgeUsingSource(const SEdge<TEdgeData>& edge)
     {
-        edgeList.emplace_back();
-        FillEdgeInfoFromEdge(edgeList.back(), edge, false);
-
-        degree += 1;
-
-        if (1 == (degree & 3))
-            numVectors += 1;
+        AppendEdge(edge.sourceVertex, edge);
     }
     
     // --------
     
     void EdgeList::RemoveEdge(const TVertexID otherVertex)
     {
-        for (auto it = edgeList.cbegin(); it != edgeList.cend(); ++it)
+        if (NULL == firstBlock)
+            return;
+        
+        // Edges that remain are copied towards the front, so the write position never passes the read position.
+        SEdgeBlock* writeBlock = firstBlock;
+        uint32_t writeIndex = 0;
+        
+        for (SEdgeBlock* readBlock = firstBlock; (NULL != readBlock) && (0 != readBlock->count); readBlock = readBlock->next)
         {
-            if (otherVertex == it->otherVertex)
+            for (uint32_t readIndex = 0; readIndex < readBlock->count; ++readIndex)
             {
-                auto prevIt = it;
-                --prevIt;
+                if (otherVertex == BlockNeighbors(readBlock)[readIndex])
+                    continue;
+                
+                if (writeIndex == writeBlock->capacity)
+                {
+                    writeBlock = writeBlock->next;
+                    writeIndex = 0;
+                }
                 
-                edgeList.erase(it);
-                it = prevIt;
+                BlockNeighbors(writeBlock)[writeIndex] = BlockNeighbors(readBlock)[readIndex];
+                
+                if (hasEdgeData)
+                    BlockEdgeData(writeBlock)[writeIndex] = BlockEdgeData(readBlock)[readIndex];
+                
+                writeIndex += 1;
             }
         }
+        
+        // Blocks before the write position are full, and those after it are now empty.
+        writeBlock->count = writeIndex;
+        appendBlock = writeBlock;
+        
+        for (SEdgeBlock* block = writeBlock->next; NULL != block; block = block->next)
+            block->count = 0;
+        
+        degree = 0;
+        
+        for (SEdgeBlock* block = firstBlock; block != writeBlock->next; block = block->next)
+            degree += block->count;
+        
+        numVectors = (degree + 3) >> 2;
     }
     
     
     // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
     
-    template void EdgeList::FillEdgeInfoFromEdge(SIndexedEdge& edgeInfo, const SEdge<void>& edge, bool useDestinationVertex);
-    template void EdgeList::FillEdgeInfoFromEdge(SIndexedEdge& edgeInfo, const SEdge<uint64_t>& edge, bool useDestinationVertex);
-    template void EdgeList::FillEdgeInfoFromEdge(SIndexedEdge& edgeInfo, const SEdge<double>& edge, bool useDestinationVertex);
-    
     template void EdgeList::FillEdge(EdgeIterator& position, SEdge<void>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const;
     template void EdgeList::FillEdge(EdgeIterator& position, SEdge<uint64_t>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const;
     template void EdgeList::FillEdge(EdgeIterator& position, SEdge<double>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const;
+    template void EdgeList::FillEdge(EdgeIterator& position, SEdge<uint32_t>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const;
+    template void EdgeList::FillEdge(EdgeIterator& position, SEdge<float>& edge, TVertexID topLevelVertex, bool topLevelIsDestination) const;
     
     template void EdgeList::InsertEdgeUsingDestination(const SEdge<void>& edge);
     template void EdgeList::InsertEdgeUsingDestination(const SEdge<uint64_t>& edge);
     template void EdgeList::InsertEdgeUsingDestination(const SEdge<double>& edge);
+    template void EdgeList::InsertEdgeUsingDestination(const SEdge<uint32_t>& edge);
+    template void EdgeList::InsertEdgeUsingDestination(const SEdge<float>& edge);
     
     template void EdgeList::InsertEdgeUsingSource(const SEdge<void>& edge);
     template void EdgeList::InsertEdgeUsingSource(const SEdge<uint64_t>& edge);
     template void EdgeList::InsertEdgeUsingSource(const SEdge<double>& edge);
+    template void EdgeList::InsertEdgeUsingSource(const SEdge<uint32_t>& edge);
+    template void EdgeList::InsertEdgeUsingSource(const SEdge<float>& edge);
 }
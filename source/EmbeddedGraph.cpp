@@ -0,0 +1,268 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file EmbeddedGraph.cpp
+ *   Implementation of the interface through which other programs load,
+ *   transform, and access graphs in their own process using the GraphTool
+ *   library.
+ *****************************************************************************/
+
+#include "EmbeddedGraph.h"
+#include "Graph.h"
+#include "GraphReaderFactory.h"
+#include "GraphTransformFactory.h"
+#include "IGraphReader.h"
+#include "IGraphTransform.h"
+#include "NUMASpawner.h"
+#include "Types.h"
+#include "VertexIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Looks up the enumerator that corresponds to a name in one of the factory mappings.
+    /// @param [in] strings Mapping from names to enumerators.
+    /// @param [in] name Name to look up, which may be `NULL`.
+    /// @param [out] value Filled with the enumerator, if the name is found.
+    /// @return `true` if the name was found, `false` otherwise.
+    static bool FindEnumValue(const std::map<std::string, int64_t>& strings, const char* const name, int64_t& value)
+    {
+        if (NULL == name)
+            return false;
+
+        auto it = strings.find(name);
+
+        if (strings.end() == it)
+            return false;
+
+        value = it->second;
+        return true;
+    }
+
+    // --------
+
+    /// Submits each option in a comma-separated list of `name=value` pairs to the specified object, in the same way as the command-line tool.
+    /// @tparam TOptionTarget Type of object to receive the options, which must have a `SubmitOption` method.
+    /// @param [in] optionsString String containing the options, or `NULL` if there are none.
+    /// @param [in] target Object to receive the options.
+    /// @return `true` if all options were accepted, `false` otherwise.
+    template <typename TOptionTarget> static bool SubmitOptionsString(const char* const optionsString, TOptionTarget* const target)
+    {
+        if (NULL == optionsString)
+            return true;
+
+        const std::string options = optionsString;
+        size_t position = 0;
+
+        while (position < options.length())
+        {
+            size_t optionEnd = options.find(',', position);
+            if (std::string::npos == optionEnd)
+                optionEnd = options.length();
+
+            const std::string option = options.substr(position, optionEnd - position);
+            position = optionEnd + 1;
+
+            if (option.empty())
+                continue;
+
+            const size_t separator = option.find('=');
+            const std::string optionName = option.substr(0, separator);
+            const std::string optionValue = ((std::string::npos == separator) ? "" : option.substr(separator + 1));
+
+            if (!(target->SubmitOption(optionName.c_str(), optionValue.c_str())))
+                return false;
+        }
+
+        return true;
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "EmbeddedGraph.h" for documentation.
+
+    EmbeddedGraph::EmbeddedGraph(void) : graph(new Graph())
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    EmbeddedGraph::~EmbeddedGraph(void)
+    {
+        delete graph;
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "EmbeddedGraph.h" for documentation.
+
+    void EmbeddedGraph::ReleaseThreads(void)
+    {
+        NUMASpawner::ReleaseThreads();
+    }
+
+
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "EmbeddedGraph.h" for documentation.
+
+    EGraphResult EmbeddedGraph::ApplyTransform(const char* const transformName, const char* const options)
+    {
+        int64_t transformType;
+
+        if (!FindEnumValue(*(GraphTransformFactory::GetGraphTransformStrings()), transformName, transformType))
+            return EGraphResult::GraphResultErrorUnknown;
+
+        IGraphTransform* const transform = GraphTransformFactory::CreateGraphTransform((EGraphTransformType)transformType);
+
+        if (NULL == transform)
+            return EGraphResult::GraphResultErrorUnknown;
+
+        EGraphResult result = EGraphResult::GraphResultErrorUnknown;
+
+        if (SubmitOptionsString(options, transform))
+            result = transform->ApplyTransformation(*graph);
+
+        delete transform;
+        return result;
+    }
+
+    // --------
+
+    EEdgeDataType EmbeddedGraph::GetEdgeDataType(void) const
+    {
+        return graph->GetEdgeDataType();
+    }
+
+    // --------
+
+    TEdgeCount EmbeddedGraph::GetNumEdges(void) const
+    {
+        return graph->GetNumEdges();
+    }
+
+    // --------
+
+    TVertexCount EmbeddedGraph::GetNumVertices(void) const
+    {
+        return graph->GetNumVertices();
+    }
+
+    // --------
+
+    EGraphResult EmbeddedGraph::GetView(const bool groupedByDestination, SCompressedSparseView& view)
+    {
+        // Transformations may leave the graph thawed, and building a grouping that is already present does not freeze it, so the graph is frozen explicitly.
+        EGraphResult result = graph->BuildEdgeGrouping(groupedByDestination);
+
+        if (EGraphResult::GraphResultSuccess == result)
+            result = graph->Freeze();
+
+        if (EGraphResult::GraphResultSuccess != result)
+            return result;
+
+        const VertexIndex& vertexIndex = (groupedByDestination ? graph->VertexIndexDestination() : graph->VertexIndexSource());
+
+        view.numVertices = vertexIndex.GetNumVertices();
+        view.numEdges = vertexIndex.GetNumEdges();
+        view.offsets = vertexIndex.GetFrozenOffsets();
+        view.neighbors = vertexIndex.GetFrozenNeighbors();
+        view.neighborsCompact = vertexIndex.GetFrozenNeighborsCompact();
+        view.edgeData = ((EEdgeDataType::EdgeDataTypeVoid == graph->GetEdgeDataType()) ? NULL : vertexIndex.GetFrozenEdgeData());
+        view.edgeDataType = graph->GetEdgeDataType();
+        view.sorted = vertexIndex.IsFrozenSorted();
+
+        return EGraphResult::GraphResultSuccess;
+    }
+
+    // --------
+
+    EGraphResult EmbeddedGraph::ReadGraphFromFile(const char* const filename, const char* const formatName, const EEdgeDataType edgeDataType, const char* const options)
+    {
+        int64_t readerType;
+
+        if (!FindEnumValue(*(GraphReaderFactory::GetGraphReaderStrings()), formatName, readerType))
+            return EGraphResult::GraphResultErrorUnknown;
+
+        IGraphReader* const reader = GraphReaderFactory::CreateGraphReader((EGraphReaderType)readerType, edgeDataType);
+
+        if (NULL == reader)
+            return EGraphResult::GraphResultErrorUnknown;
+
+        if (!SubmitOptionsString(options, reader))
+        {
+            delete reader;
+            return EGraphResult::GraphResultErrorUnknown;
+        }
+
+        // Start from an empty graph, so that nothing from any previous graph remains.
+        delete graph;
+        graph = new Graph();
+        graph->SetEdgeGroupings(false, true);
+
+        EGraphResult result = reader->ReadGraphFromFile(filename, *graph);
+        delete reader;
+
+        if (EGraphResult::GraphResultSuccess == result)
+            result = graph->Freeze();
+
+        return result;
+    }
+
+    // --------
+
+    EGraphResult EmbeddedGraph::StreamEdges(const bool groupedByDestination, TEdgeBatchCallback callback, void* context)
+    {
+        SCompressedSparseView view;
+        const EGraphResult viewResult = GetView(groupedByDestination, view);
+
+        if (EGraphResult::GraphResultSuccess != viewResult)
+            return viewResult;
+
+        // Compact neighbors are widened into a buffer before being delivered, but full-width neighbors are delivered directly from the graph.
+        std::vector<TVertexID> neighborBuf;
+
+        for (TVertexID vertex = 0; vertex < view.numVertices; ++vertex)
+        {
+            const TEdgeID edgeStart = view.offsets[vertex];
+            const size_t count = (size_t)(view.offsets[vertex + 1] - edgeStart);
+
+            if (0 == count)
+                continue;
+
+            const TVertexID* neighbors = NULL;
+
+            if (NULL != view.neighbors)
+            {
+                neighbors = &view.neighbors[edgeStart];
+            }
+            else
+            {
+                neighborBuf.resize(count);
+
+                for (size_t i = 0; i < count; ++i)
+                    neighborBuf[i] = (TVertexID)view.neighborsCompact[edgeStart + i];
+
+                neighbors = neighborBuf.data();
+            }
+
+            if (!callback(context, vertex, neighbors, ((NULL == view.edgeData) ? NULL : &view.edgeData[edgeStart]), count))
+                break;
+        }
+
+        return EGraphResult::GraphResultSuccess;
+    }
+}
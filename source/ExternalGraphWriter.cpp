@@ -0,0 +1,917 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file ExternalGraphWriter.cpp
+ *   Implementation of a graph writer that converts graphs too large to fit in
+ *   memory by way of temporary files.
+ *****************************************************************************/
+
+#include "ExternalGraphWriter.h"
+#include "Graph.h"
+#include "GraphWriter.h"
+#include "IGraphWriter.h"
+#include "MemoryTracker.h"
+#include "PlatformFunctions.h"
+#include "Statistics.h"
+#include "Types.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <spindle.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __PLATFORM_LINUX
+#include <unistd.h>
+#endif
+
+#ifdef __PLATFORM_WINDOWS
+#include <process.h>
+#endif
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Runs a function on several threads at once, passing each its own index, and waits for all of them to finish.
+    /// The calling thread acts as the first of them.
+    /// @param [in] numThreads Number of threads.
+    /// @param [in] func Function to run.
+    static void RunOnThreads(const uint32_t numThreads, const std::function<void(uint32_t)>& func)
+    {
+        std::vector<std::thread> threads;
+
+        for (uint32_t i = 1; i < numThreads; ++i)
+            threads.emplace_back(func, i);
+
+        func(0);
+
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "ExternalGraphWriter.h" for documentation.
+
+    template <typename TEdgeData> ExternalGraphWriter<TEdgeData>::ExternalGraphWriter(SExternalGraphOutput* const outputs, const size_t numOutputs, const uint64_t memoryBudget) : outputs(outputs), numOutputs(numOutputs), memoryBudget(memoryBudget), numVertices(0), numEdges(0), bucketShift(0), numBuckets(0), chunkCapacity(0), numSortThreads(1), tempDirectory(), bucketFiles(), bucketFilenames(), bucketBuffers(), stagedEdges(), bucketPositions(), bucketStarts(), numPartitionedEdges(0), externalWriteResult(EGraphResult::GraphResultSuccess), chunks(), currentGroupedByDestination(false), loader(), lock(), chunkReady(), slotFreed(), numChunksSupplied(0), loadFailed(false), closing(false), currentSlotPosition(0)
+    {
+        needsGrouping[0] = false;
+        needsGrouping[1] = false;
+        degrees[0] = NULL;
+        degrees[1] = NULL;
+
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            slots[i].edges = NULL;
+            slots[i].scratch = NULL;
+            slots[i].cursors = NULL;
+            slots[i].numEdges = 0;
+            slots[i].ready = false;
+        }
+    }
+
+    // --------
+
+    template <typename TEdgeData> ExternalGraphWriter<TEdgeData>::~ExternalGraphWriter(void)
+    {
+        CloseBucketFiles();
+        FreeMemory();
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "ExternalGraphWriter.h" for documentation.
+
+    template <typename TEdgeData> size_t ExternalGraphWriter<TEdgeData>::FillEdgesFunc(void* arg, SEdge<TEdgeData>* const buf, const size_t capacity)
+    {
+        return ((ExternalGraphWriter<TEdgeData>*)arg)->FillEdges(buf, capacity);
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "ExternalGraphWriter.h" for documentation.
+
+    template <typename TEdgeData> bool ExternalGraphWriter<TEdgeData>::AllocateSlots(void)
+    {
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            slots[i].edges = new SEdge<TEdgeData>[chunkCapacity];
+            slots[i].scratch = new SEdge<TEdgeData>[chunkCapacity];
+            slots[i].cursors = new TEdgeCount[chunkCapacity];
+            slots[i].numEdges = 0;
+            slots[i].ready = false;
+
+            if ((NULL == slots[i].edges) || (NULL == slots[i].scratch) || (NULL == slots[i].cursors))
+                return false;
+
+            MemoryTracker::RecordAllocation(slots[i].edges, sizeof(SEdge<TEdgeData>) * chunkCapacity, MemoryTracker::MemoryCategoryExternalSort);
+            MemoryTracker::RecordAllocation(slots[i].scratch, sizeof(SEdge<TEdgeData>) * chunkCapacity, MemoryTracker::MemoryCategoryExternalSort);
+            MemoryTracker::RecordAllocation(slots[i].cursors, sizeof(TEdgeCount) * chunkCapacity, MemoryTracker::MemoryCategoryExternalSort);
+        }
+
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void ExternalGraphWriter<TEdgeData>::CloseBucketFiles(void)
+    {
+        for (uint32_t grouping = 0; grouping < 2; ++grouping)
+        {
+            for (size_t i = 0; i < bucketFiles[grouping].size(); ++i)
+            {
+                fclose(bucketFiles[grouping][i]);
+                remove(bucketFilenames[grouping][i].c_str());
+            }
+
+            bucketFiles[grouping].clear();
+            bucketFilenames[grouping].clear();
+        }
+
+        // Buffers are released only once the files that use them are closed.
+        for (size_t i = 0; i < bucketBuffers.size(); ++i)
+        {
+            MemoryTracker::RecordRelease(bucketBuffers[i]);
+            delete[] bucketBuffers[i];
+        }
+
+        bucketBuffers.clear();
+    }
+
+    // --------
+
+    template <typename TEdgeData> size_t ExternalGraphWriter<TEdgeData>::FillEdges(SEdge<TEdgeData>* const buf, const size_t capacity)
+    {
+        size_t numFilled = 0;
+
+        while ((numFilled < capacity) && (numChunksSupplied < chunks.size()))
+        {
+            SSlot& slot = slots[numChunksSupplied & 1];
+
+            // Chunks are never empty, so a chunk has not yet been acquired if none of its edges have been supplied.
+            if (0 == currentSlotPosition)
+            {
+                const uint64_t stallStartTime = Statistics::GetTimestamp();
+                std::unique_lock<std::mutex> guard(lock);
+
+                chunkReady.wait(guard, [this, &slot]() -> bool
+                {
+                    return (slot.ready || loadFailed);
+                });
+
+                Statistics::AddPhaseDetailTime("sort stall", Statistics::GetTimestamp() - stallStartTime);
+
+                if (!(slot.ready))
+                    break;
+            }
+
+            const size_t numAvailable = slot.numEdges - currentSlotPosition;
+            const size_t numToCopy = (((capacity - numFilled) < numAvailable) ? (capacity - numFilled) : numAvailable);
+
+            memcpy((void*)&buf[numFilled], (const void*)&slot.edges[currentSlotPosition], sizeof(SEdge<TEdgeData>) * numToCopy);
+            numFilled += numToCopy;
+            currentSlotPosition += numToCopy;
+
+            // Once a chunk is used up, its slot is handed back so that the background thread can load a later chunk into it.
+            if (currentSlotPosition == slot.numEdges)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+
+                    slot.ready = false;
+                    numChunksSupplied += 1;
+                }
+
+                slotFreed.notify_all();
+                currentSlotPosition = 0;
+            }
+        }
+
+        return numFilled;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void ExternalGraphWriter<TEdgeData>::FreeMemory(void)
+    {
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            if (NULL != slots[i].edges)
+            {
+                MemoryTracker::RecordRelease(slots[i].edges);
+                delete[] slots[i].edges;
+                slots[i].edges = NULL;
+            }
+
+            if (NULL != slots[i].scratch)
+            {
+                MemoryTracker::RecordRelease(slots[i].scratch);
+                delete[] slots[i].scratch;
+                slots[i].scratch = NULL;
+            }
+
+            if (NULL != slots[i].cursors)
+            {
+                MemoryTracker::RecordRelease(slots[i].cursors);
+                delete[] slots[i].cursors;
+                slots[i].cursors = NULL;
+            }
+
+            if (NULL != degrees[i])
+            {
+                MemoryTracker::RecordRelease(degrees[i]);
+                delete[] degrees[i];
+                degrees[i] = NULL;
+            }
+        }
+
+        std::vector<SEdge<TEdgeData>>().swap(stagedEdges);
+        chunks.clear();
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool ExternalGraphWriter<TEdgeData>::LoadChunk(const SChunk& chunk, SSlot& slot)
+    {
+        const uint64_t loadStartTime = Statistics::GetTimestamp();
+        FILE* const bucketFile = bucketFiles[currentGroupedByDestination ? 1 : 0][chunk.bucket];
+        const size_t numChunkEdges = (size_t)chunk.numEdges;
+
+        // Reading starts over at the beginning of the bucket for every chunk, since the edges of a chunk are spread throughout its bucket.
+        if (0 != fseek64(bucketFile, 0, SEEK_SET))
+            return false;
+
+        if (chunk.wholeBucket)
+        {
+            if (numChunkEdges != fread((void*)slot.edges, sizeof(SEdge<TEdgeData>), numChunkEdges, bucketFile))
+                return false;
+        }
+        else
+        {
+            size_t numSelected = 0;
+            TEdgeCount numSkipped = 0;
+
+            while (numSelected < numChunkEdges)
+            {
+                const size_t numRead = fread((void*)slot.scratch, sizeof(SEdge<TEdgeData>), chunkCapacity, bucketFile);
+
+                if (0 == numRead)
+                    return false;
+
+                for (size_t i = 0; (i < numRead) && (numSelected < numChunkEdges); ++i)
+                {
+                    const TVertexID topLevelVertex = (currentGroupedByDestination ? slot.scratch[i].destinationVertex : slot.scratch[i].sourceVertex);
+
+                    if ((topLevelVertex < chunk.vertexStart) || (topLevelVertex >= chunk.vertexEnd))
+                        continue;
+
+                    if (numSkipped < chunk.edgeSkip)
+                        numSkipped += 1;
+                    else
+                        slot.edges[numSelected++] = slot.scratch[i];
+                }
+            }
+        }
+
+        slot.numEdges = numChunkEdges;
+        Statistics::AddPhaseDetailTime("load chunks", Statistics::GetTimestamp() - loadStartTime);
+
+        // A chunk that holds part of the edges of a single vertex is already in order.
+        if (1 < (chunk.vertexEnd - chunk.vertexStart))
+        {
+            const uint64_t sortStartTime = Statistics::GetTimestamp();
+            SortChunk(chunk, slot);
+            Statistics::AddPhaseDetailTime("sort chunks", Statistics::GetTimestamp() - sortStartTime);
+        }
+
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void ExternalGraphWriter<TEdgeData>::LoadChunks(void)
+    {
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            SSlot& slot = slots[i & 1];
+
+            {
+                std::unique_lock<std::mutex> guard(lock);
+
+                slotFreed.wait(guard, [this, &slot]() -> bool
+                {
+                    return (!(slot.ready) || closing);
+                });
+
+                if (closing)
+                    return;
+            }
+
+            const bool loaded = LoadChunk(chunks[i], slot);
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                if (loaded)
+                    slot.ready = true;
+                else
+                    loadFailed = true;
+            }
+
+            chunkReady.notify_all();
+
+            if (!loaded)
+                return;
+        }
+    }
+
+    // --------
+
+    template <typename TEdgeData> void ExternalGraphWriter<TEdgeData>::PlanChunks(const bool groupedByDestination)
+    {
+        const TEdgeCount* const groupDegrees = degrees[groupedByDestination ? 1 : 0];
+        const TEdgeCount capacity = (TEdgeCount)chunkCapacity;
+
+        chunks.clear();
+
+        for (uint32_t bucket = 0; bucket < numBuckets; ++bucket)
+        {
+            const TVertexID bucketStart = ((TVertexID)bucket << bucketShift);
+            const TVertexID bucketEnd = ((((TVertexID)bucket + 1) << bucketShift) < (TVertexID)numVertices ? (((TVertexID)bucket + 1) << bucketShift) : (TVertexID)numVertices);
+            const size_t firstChunk = chunks.size();
+            TVertexID vertex = bucketStart;
+
+            while (vertex < bucketEnd)
+            {
+                // A vertex with more edges than a chunk can hold is split into pieces, each of which skips the edges of the pieces before it.
+                if (groupDegrees[vertex] > capacity)
+                {
+                    for (TEdgeCount edgeSkip = 0; edgeSkip < groupDegrees[vertex]; edgeSkip += capacity)
+                        chunks.push_back({bucket, vertex, vertex + 1, edgeSkip, (((groupDegrees[vertex] - edgeSkip) < capacity) ? (groupDegrees[vertex] - edgeSkip) : capacity), false});
+
+                    vertex += 1;
+                    continue;
+                }
+
+                // Otherwise, as many consecutive vertices are grouped together as fit, bounded also by the number of sorting cursors.
+                const TVertexID chunkStart = vertex;
+                TEdgeCount chunkEdges = 0;
+
+                while ((vertex < bucketEnd) && ((vertex - chunkStart) < capacity) && (groupDegrees[vertex] <= (capacity - chunkEdges)))
+                {
+                    chunkEdges += groupDegrees[vertex];
+                    vertex += 1;
+                }
+
+                if (0 != chunkEdges)
+                    chunks.push_back({bucket, chunkStart, vertex, 0, chunkEdges, false});
+            }
+
+            if ((firstChunk + 1) == chunks.size())
+                chunks.back().wholeBucket = true;
+        }
+    }
+
+    // --------
+
+    template <typename TEdgeData> void ExternalGraphWriter<TEdgeData>::SortChunk(const SChunk& chunk, SSlot& slot)
+    {
+        const bool groupedByDestination = currentGroupedByDestination;
+        const TEdgeCount* const chunkDegrees = &degrees[groupedByDestination ? 1 : 0][chunk.vertexStart];
+        const TVertexCount numChunkVertices = (TVertexCount)(chunk.vertexEnd - chunk.vertexStart);
+        const size_t numChunkEdges = slot.numEdges;
+        const TVertexID vertexStart = chunk.vertexStart;
+        SEdge<TEdgeData>* const edges = slot.edges;
+        SEdge<TEdgeData>* const scratch = slot.scratch;
+        TEdgeCount* const cursors = slot.cursors;
+
+        // The degrees determine the position of the first edge of each top-level vertex.
+        TEdgeCount position = 0;
+
+        for (TVertexCount i = 0; i < numChunkVertices; ++i)
+        {
+            cursors[i] = position;
+            position += chunkDegrees[i];
+        }
+
+        const size_t numThreadsForEdges = numChunkEdges / kMinEdgesPerSortThread;
+        const uint32_t numThreads = ((numThreadsForEdges < (size_t)numSortThreads) ? ((0 == numThreadsForEdges) ? 1 : (uint32_t)numThreadsForEdges) : numSortThreads);
+
+        if (1 == numThreads)
+        {
+            for (size_t i = 0; i < numChunkEdges; ++i)
+            {
+                const TVertexID topLevelVertex = (groupedByDestination ? edges[i].destinationVertex : edges[i].sourceVertex);
+                scratch[cursors[topLevelVertex - vertexStart]++] = edges[i];
+            }
+
+            std::swap(slot.edges, slot.scratch);
+            return;
+        }
+
+        // Top-level vertices are divided into one range per thread, each holding roughly the same number of edges.
+        std::vector<TVertexCount> rangeVertexStart(numThreads + 1);
+        std::vector<uint64_t> rangeEdgeStart(numThreads + 1);
+        uint32_t range = 1;
+
+        rangeVertexStart[0] = 0;
+
+        for (TVertexCount i = 0; (i < numChunkVertices) && (range < numThreads); ++i)
+        {
+            while ((range < numThreads) && (cursors[i] >= ((numChunkEdges * range) / numThreads)))
+                rangeVertexStart[range++] = i;
+        }
+
+        while (range <= numThreads)
+            rangeVertexStart[range++] = numChunkVertices;
+
+        for (uint32_t i = 0; i <= numThreads; ++i)
+            rangeEdgeStart[i] = ((rangeVertexStart[i] < numChunkVertices) ? cursors[rangeVertexStart[i]] : numChunkEdges);
+
+        auto rangeOf = [&rangeVertexStart, numThreads](const TVertexCount chunkVertex) -> uint32_t
+        {
+            return (uint32_t)(std::upper_bound(rangeVertexStart.begin() + 1, rangeVertexStart.begin() + numThreads, chunkVertex) - (rangeVertexStart.begin() + 1));
+        };
+
+        // First, each thread counts the edges of its slice of the chunk that belong to each range, and the counts become the position of each slice within each range.
+        std::vector<uint64_t> rangePositions((size_t)numThreads * (size_t)numThreads, 0);
+
+        RunOnThreads(numThreads, [&](const uint32_t threadID) -> void
+        {
+            uint64_t* const threadRangePositions = &rangePositions[(size_t)threadID * (size_t)numThreads];
+
+            for (size_t i = ((numChunkEdges * threadID) / numThreads); i < ((numChunkEdges * (threadID + 1)) / numThreads); ++i)
+                threadRangePositions[rangeOf((TVertexCount)((groupedByDestination ? edges[i].destinationVertex : edges[i].sourceVertex) - vertexStart))] += 1;
+        });
+
+        for (uint32_t r = 0; r < numThreads; ++r)
+        {
+            uint64_t rangePosition = rangeEdgeStart[r];
+
+            for (uint32_t t = 0; t < numThreads; ++t)
+            {
+                const uint64_t count = rangePositions[((size_t)t * (size_t)numThreads) + r];
+                rangePositions[((size_t)t * (size_t)numThreads) + r] = rangePosition;
+                rangePosition += count;
+            }
+        }
+
+        // Next, each thread moves the edges of its slice into their ranges, which preserves their order since slices are placed in order within each range.
+        RunOnThreads(numThreads, [&](const uint32_t threadID) -> void
+        {
+            uint64_t* const threadRangePositions = &rangePositions[(size_t)threadID * (size_t)numThreads];
+
+            for (size_t i = ((numChunkEdges * threadID) / numThreads); i < ((numChunkEdges * (threadID + 1)) / numThreads); ++i)
+                scratch[threadRangePositions[rangeOf((TVertexCount)((groupedByDestination ? edges[i].destinationVertex : edges[i].sourceVertex) - vertexStart))]++] = edges[i];
+        });
+
+        // Finally, each thread places the edges of its range at their final positions, in the order in which they appear within the range.
+        RunOnThreads(numThreads, [&](const uint32_t threadID) -> void
+        {
+            for (uint64_t i = rangeEdgeStart[threadID]; i < rangeEdgeStart[threadID + 1]; ++i)
+            {
+                const TVertexID topLevelVertex = (groupedByDestination ? scratch[i].destinationVertex : scratch[i].sourceVertex);
+                edges[cursors[topLevelVertex - vertexStart]++] = scratch[i];
+            }
+        });
+    }
+
+    // --------
+
+    template <typename TEdgeData> void ExternalGraphWriter<TEdgeData>::WriteGrouping(const bool groupedByDestination)
+    {
+        std::vector<GraphWriter<TEdgeData>*> groupWriters;
+        std::vector<const char*> groupFilenames;
+        std::vector<size_t> groupOutputIndices;
+
+        // Writers were checked to write the same type of edge data as this object when streaming began.
+        for (size_t i = 0; i < numOutputs; ++i)
+        {
+            if (groupedByDestination == outputs[i].groupedByDestination)
+            {
+                groupWriters.push_back((GraphWriter<TEdgeData>*)outputs[i].writer);
+                groupFilenames.push_back(outputs[i].filename);
+                groupOutputIndices.push_back(i);
+            }
+        }
+
+        // The writers obtain the vertex offsets and every other quantity they need from a graph that holds only the degrees.
+        Graph graph;
+        graph.SetEdgeDataType<TEdgeData>();
+
+        const EGraphResult adoptResult = graph.AdoptDegrees(groupedByDestination, degrees[groupedByDestination ? 1 : 0], numVertices);
+
+        if (EGraphResult::GraphResultSuccess != adoptResult)
+        {
+            for (size_t i = 0; i < groupOutputIndices.size(); ++i)
+                outputs[groupOutputIndices[i]].result = adoptResult;
+
+            return;
+        }
+
+        // Start reading and sorting chunks in the background, then write all of the files at once from them.
+        PlanChunks(groupedByDestination);
+
+        currentGroupedByDestination = groupedByDestination;
+        numChunksSupplied = 0;
+        loadFailed = false;
+        closing = false;
+        currentSlotPosition = 0;
+        slots[0].ready = false;
+        slots[1].ready = false;
+
+        loader = std::thread(&ExternalGraphWriter<TEdgeData>::LoadChunks, this);
+
+        SGraphEdgeSource<TEdgeData> edgeSource;
+        edgeSource.fillFunc = &FillEdgesFunc;
+        edgeSource.arg = (void*)this;
+
+        std::vector<EGraphResult> groupResults(groupWriters.size());
+        GraphWriter<TEdgeData>::WriteGraphFromEdgeSource(groupWriters.data(), groupFilenames.data(), groupWriters.size(), graph, groupedByDestination, edgeSource, groupResults.data());
+
+        // Writing may stop before every chunk is supplied, such as if every file fails, so the background thread is told to stop rather than simply awaited.
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closing = true;
+        }
+
+        slotFreed.notify_all();
+        loader.join();
+
+        for (size_t i = 0; i < groupOutputIndices.size(); ++i)
+            outputs[groupOutputIndices[i]].result = ((loadFailed && (EGraphResult::GraphResultSuccess == groupResults[i])) ? EGraphResult::GraphResultErrorIO : groupResults[i]);
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphWriter.h" for documentation.
+
+    template <typename TEdgeData> EGraphResult ExternalGraphWriter<TEdgeData>::BeginStreamedWrite(const char* const filename, const Graph& graph, const TVertexCount numVertices, const TEdgeCount numEdges)
+    {
+        if ((0 == numOutputs) || (false == graph.DoesEdgeDataTypeMatch<TEdgeData>()))
+            return EGraphResult::GraphResultErrorFormat;
+
+        for (size_t i = 0; i < numOutputs; ++i)
+        {
+            if ((NULL == outputs[i].writer) || (GetEdgeDataType() != outputs[i].writer->GetEdgeDataType()) || !(outputs[i].writer->SupportsEdgeSource()))
+                return EGraphResult::GraphResultErrorFormat;
+
+            needsGrouping[outputs[i].groupedByDestination ? 1 : 0] = true;
+            outputs[i].result = EGraphResult::GraphResultErrorUnknown;
+        }
+
+        this->numVertices = numVertices;
+        this->numEdges = numEdges;
+        numPartitionedEdges = 0;
+        externalWriteResult = EGraphResult::GraphResultSuccess;
+        tempDirectory = ((NULL == filename) || ('\0' == filename[0]) ? "." : filename);
+
+        // The degree counts of each grouping and the vertex offsets built from them are held throughout, and what remains of the budget is divided between the buffers of the temporary files and two chunks, each with space to sort.
+        const uint64_t numGroupings = (needsGrouping[0] ? 1 : 0) + (needsGrouping[1] ? 1 : 0);
+        const uint64_t fixedBytes = ((numGroupings + 1) * (uint64_t)numVertices * sizeof(TEdgeCount)) + sizeof(TEdgeCount);
+
+        if (memoryBudget <= fixedBytes)
+            return EGraphResult::GraphResultErrorNoMemory;
+
+        const uint64_t availableBytes = memoryBudget - fixedBytes;
+        uint64_t bucketBufferSize = availableBytes / (8 * numGroupings * kMaxBuckets);
+
+        if (bucketBufferSize < kMinBucketBufferSize)
+            bucketBufferSize = kMinBucketBufferSize;
+        else if (bucketBufferSize > kMaxBucketBufferSize)
+            bucketBufferSize = kMaxBucketBufferSize;
+
+        const uint64_t bucketBufferBytes = numGroupings * kMaxBuckets * bucketBufferSize;
+
+        if (availableBytes <= bucketBufferBytes)
+            return EGraphResult::GraphResultErrorNoMemory;
+
+        chunkCapacity = (size_t)((availableBytes - bucketBufferBytes) / (2 * ((2 * sizeof(SEdge<TEdgeData>)) + sizeof(TEdgeCount))));
+
+        if (chunkCapacity < kMinChunkCapacity)
+            return EGraphResult::GraphResultErrorNoMemory;
+
+        // Buckets cover equal power-of-two ranges of vertices, and there are enough of them that each is expected to fit within a chunk with room to spare.
+        uint64_t targetBuckets = ((2 * (uint64_t)numEdges) + chunkCapacity - 1) / chunkCapacity;
+
+        if (targetBuckets < (((uint64_t)numVertices + chunkCapacity - 1) / chunkCapacity))
+            targetBuckets = (((uint64_t)numVertices + chunkCapacity - 1) / chunkCapacity);
+
+        if (targetBuckets < 1)
+            targetBuckets = 1;
+        else if (targetBuckets > kMaxBuckets)
+            targetBuckets = kMaxBuckets;
+
+        bucketShift = 0;
+
+        while ((0 != numVertices) && (((((uint64_t)numVertices - 1) >> bucketShift) + 1) > targetBuckets))
+            bucketShift += 1;
+
+        numBuckets = ((0 == numVertices) ? 1 : (uint32_t)((((uint64_t)numVertices - 1) >> bucketShift) + 1));
+
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        numSortThreads = ((0 == hardwareThreads) ? 1 : ((hardwareThreads > kMaxSortThreads) ? kMaxSortThreads : hardwareThreads));
+
+        // Create the degree counts and temporary files of each grouping.
+        for (uint32_t grouping = 0; grouping < 2; ++grouping)
+        {
+            if (!(needsGrouping[grouping]))
+                continue;
+
+            degrees[grouping] = new TEdgeCount[(0 == numVertices) ? 1 : numVertices]();
+
+            if (NULL == degrees[grouping])
+            {
+                FreeMemory();
+                return EGraphResult::GraphResultErrorNoMemory;
+            }
+
+            MemoryTracker::RecordAllocation(degrees[grouping], sizeof(TEdgeCount) * ((0 == numVertices) ? 1 : numVertices), MemoryTracker::MemoryCategoryExternalSort);
+
+            for (uint32_t bucket = 0; bucket < numBuckets; ++bucket)
+            {
+                const std::string bucketFilename = tempDirectory + "/graphtool-" + std::to_string((long long)getpid()) + ((0 == grouping) ? "-s-" : "-d-") + std::to_string((unsigned long long)bucket) + ".tmp";
+                FILE* const bucketFile = fopen(bucketFilename.c_str(), "w+b");
+
+                if (NULL == bucketFile)
+                {
+                    CloseBucketFiles();
+                    FreeMemory();
+                    return EGraphResult::GraphResultErrorCannotOpenFile;
+                }
+
+                bucketFiles[grouping].push_back(bucketFile);
+                bucketFilenames[grouping].push_back(bucketFilename);
+
+                char* const bucketBuffer = new char[bucketBufferSize];
+                MemoryTracker::RecordAllocation(bucketBuffer, bucketBufferSize, MemoryTracker::MemoryCategoryExternalSort);
+                bucketBuffers.push_back(bucketBuffer);
+                setvbuf(bucketFile, bucketBuffer, _IOFBF, (size_t)bucketBufferSize);
+            }
+        }
+
+        return EGraphResult::GraphResultSuccess;
+    }
+
+    // --------
+
+    template <typename TEdgeData> EGraphResult ExternalGraphWriter<TEdgeData>::EndStreamedWrite(void)
+    {
+        // Edges that refer to a vertex beyond the number given by the input file are never partitioned, and the reader reports them, so the outputs are not written.
+        if ((EGraphResult::GraphResultSuccess == externalWriteResult) && (numPartitionedEdges != numEdges))
+            externalWriteResult = EGraphResult::GraphResultErrorFormat;
+
+        for (uint32_t grouping = 0; grouping < 2; ++grouping)
+        {
+            for (size_t i = 0; i < bucketFiles[grouping].size(); ++i)
+            {
+                if ((EGraphResult::GraphResultSuccess == externalWriteResult) && ((0 != fflush(bucketFiles[grouping][i])) || ferror(bucketFiles[grouping][i])))
+                    externalWriteResult = EGraphResult::GraphResultErrorIO;
+            }
+        }
+
+        // The buffers used to partition edges are no longer needed, so their space is released before allocating space to sort.
+        std::vector<SEdge<TEdgeData>>().swap(stagedEdges);
+
+        if ((EGraphResult::GraphResultSuccess == externalWriteResult) && !AllocateSlots())
+            externalWriteResult = EGraphResult::GraphResultErrorNoMemory;
+
+        if (EGraphResult::GraphResultSuccess == externalWriteResult)
+        {
+            for (uint32_t grouping = 0; grouping < 2; ++grouping)
+            {
+                if (needsGrouping[grouping])
+                    WriteGrouping(0 != grouping);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < numOutputs; ++i)
+                outputs[i].result = externalWriteResult;
+        }
+
+        CloseBucketFiles();
+        FreeMemory();
+
+        return externalWriteResult;
+    }
+
+    // --------
+
+    template <> EEdgeDataType ExternalGraphWriter<void>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeVoid;
+    }
+
+    // --------
+
+    template <> EEdgeDataType ExternalGraphWriter<uint64_t>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeInteger;
+    }
+
+    // --------
+
+    template <> EEdgeDataType ExternalGraphWriter<double>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeFloatingPoint;
+    }
+
+    // --------
+
+    template <> EEdgeDataType ExternalGraphWriter<uint32_t>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeInteger32;
+    }
+
+    // --------
+
+    template <> EEdgeDataType ExternalGraphWriter<float>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeFloatingPoint32;
+    }
+
+    // --------
+
+    template <typename TEdgeData> uint32_t ExternalGraphWriter<TEdgeData>::GetNumPartitions(void) const
+    {
+        return 1;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool ExternalGraphWriter<TEdgeData>::RequiresBothEdgeGroupings(void) const
+    {
+        return false;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool ExternalGraphWriter<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return false;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool ExternalGraphWriter<TEdgeData>::SupportsStreaming(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void ExternalGraphWriter<TEdgeData>::WriteStreamedEdges(const void* const buf, const size_t count)
+    {
+        const uint64_t partitionStartTime = Statistics::GetTimestamp();
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        const SEdge<TEdgeData>* const edges = (const SEdge<TEdgeData>*)buf;
+
+        // Space to partition edges is allocated once the number of threads and the size of the buffers are known.
+        if (0 == localThreadID)
+        {
+            if (bucketPositions.size() != ((size_t)localThreadCount * (size_t)numBuckets))
+            {
+                bucketPositions.assign((size_t)localThreadCount * (size_t)numBuckets, 0);
+                bucketStarts.assign((size_t)numBuckets + 1, 0);
+            }
+
+            if (stagedEdges.size() < count)
+                stagedEdges.resize(count);
+        }
+
+        spindleBarrierLocal();
+
+        const size_t sliceStart = ((count * localThreadID) / localThreadCount);
+        const size_t sliceEnd = ((count * (localThreadID + 1)) / localThreadCount);
+        uint64_t* const threadBucketPositions = &bucketPositions[(size_t)localThreadID * (size_t)numBuckets];
+        bool isFirstGrouping = true;
+
+        for (uint32_t grouping = 0; grouping < 2; ++grouping)
+        {
+            if (!(needsGrouping[grouping]))
+                continue;
+
+            const bool groupedByDestination = (0 != grouping);
+            TEdgeCount* const groupDegrees = degrees[grouping];
+
+            // First, each thread counts the edges of its slice of the buffer that belong to each bucket, skipping any that refer to a vertex beyond the number given by the input file.
+            for (uint32_t i = 0; i < numBuckets; ++i)
+                threadBucketPositions[i] = 0;
+
+            for (size_t i = sliceStart; i < sliceEnd; ++i)
+            {
+                const TVertexID topLevelVertex = (groupedByDestination ? edges[i].destinationVertex : edges[i].sourceVertex);
+
+                if (topLevelVertex < numVertices)
+                    threadBucketPositions[topLevelVertex >> bucketShift] += 1;
+            }
+
+            spindleBarrierLocal();
+
+            // Next, the counts become the position of each slice within each bucket, with buckets placed in order and slices in order within each bucket.
+            if (0 == localThreadID)
+            {
+                uint64_t position = 0;
+
+                for (uint32_t bucket = 0; bucket < numBuckets; ++bucket)
+                {
+                    bucketStarts[bucket] = position;
+
+                    for (uint32_t t = 0; t < localThreadCount; ++t)
+                    {
+                        const uint64_t numBucketEdges = bucketPositions[((size_t)t * (size_t)numBuckets) + bucket];
+                        bucketPositions[((size_t)t * (size_t)numBuckets) + bucket] = position;
+                        position += numBucketEdges;
+                    }
+                }
+
+                bucketStarts[numBuckets] = position;
+
+                if (isFirstGrouping)
+                    numPartitionedEdges += (TEdgeCount)position;
+            }
+
+            spindleBarrierLocal();
+
+            for (size_t i = sliceStart; i < sliceEnd; ++i)
+            {
+                const TVertexID topLevelVertex = (groupedByDestination ? edges[i].destinationVertex : edges[i].sourceVertex);
+
+                if (topLevelVertex < numVertices)
+                    stagedEdges[threadBucketPositions[topLevelVertex >> bucketShift]++] = edges[i];
+            }
+
+            spindleBarrierLocal();
+
+            // Finally, each bucket is appended to its temporary file, and its edges counted, by a single thread, so no two threads count the same vertex.
+            for (uint32_t bucket = localThreadID; bucket < numBuckets; bucket += localThreadCount)
+            {
+                const size_t numBucketEdges = (size_t)(bucketStarts[bucket + 1] - bucketStarts[bucket]);
+
+                if (0 == numBucketEdges)
+                    continue;
+
+                const SEdge<TEdgeData>* const bucketEdges = &stagedEdges[bucketStarts[bucket]];
+                fwrite((const void*)bucketEdges, sizeof(SEdge<TEdgeData>), numBucketEdges, bucketFiles[grouping][bucket]);
+
+                for (size_t i = 0; i < numBucketEdges; ++i)
+                    groupDegrees[groupedByDestination ? bucketEdges[i].destinationVertex : bucketEdges[i].sourceVertex] += 1;
+            }
+
+            spindleBarrierLocal();
+            isFirstGrouping = false;
+        }
+
+        // The first thread reports on behalf of all of them, since they all proceed in lock-step.
+        if (0 == localThreadID)
+            Statistics::AddPhaseDetailTime("partition", Statistics::GetTimestamp() - partitionStartTime);
+    }
+
+    // --------
+
+    template <typename TEdgeData> EGraphResult ExternalGraphWriter<TEdgeData>::WriteGraphToFile(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        // Edges are only ever received by streaming.
+        return EGraphResult::GraphResultErrorFormat;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void ExternalGraphWriter<TEdgeData>::WriteGraphToFiles(IGraphWriter* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, EGraphResult* results)
+    {
+        for (size_t i = 0; i < numWriters; ++i)
+            results[i] = EGraphResult::GraphResultErrorFormat;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool ExternalGraphWriter<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        return false;
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class ExternalGraphWriter<void>;
+    template class ExternalGraphWriter<uint64_t>;
+    template class ExternalGraphWriter<double>;
+    template class ExternalGraphWriter<uint32_t>;
+    template class ExternalGraphWriter<float>;
+}
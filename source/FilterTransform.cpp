@@ -0,0 +1,545 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file FilterTransform.cpp
+ *   Implementation of a graph transformation that removes the edges and
+ *   vertices that do not satisfy a predicate.
+ *****************************************************************************/
+
+#include "FilterTransform.h"
+#include "Graph.h"
+#include "GraphTransform.h"
+#include "Types.h"
+#include "VertexIndex.h"
+#include "WorkScheduler.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <spindle.h>
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Transformation option that specifies the smallest total degree of a vertex that is kept.
+    static const char* const kTransformOptionMinDegree = "mindegree";
+
+    /// Transformation option that specifies the largest total degree of a vertex that is kept.
+    static const char* const kTransformOptionMaxDegree = "maxdegree";
+
+    /// Transformation option that specifies the first vertex identifier that is kept.
+    static const char* const kTransformOptionStart = "start";
+
+    /// Transformation option that specifies the vertex identifier one past the last that is kept.
+    static const char* const kTransformOptionEnd = "end";
+
+    /// Transformation option that specifies whether the vertices kept by the largest component filter are renumbered consecutively.
+    static const char* const kTransformOptionRelabel = "relabel";
+
+    /// Parses the value of a transformation option that holds a non-negative integer.
+    /// @param [in] optionValue Value of the option.
+    /// @param [out] value Parsed value, modified only if parsing succeeds.
+    /// @return `true` if the value is a valid non-negative integer, `false` otherwise.
+    static bool ParseNumericOptionValue(const char* const optionValue, uint64_t& value)
+    {
+        char* valueEnd = NULL;
+        const uint64_t parsedValue = (uint64_t)strtoull(optionValue, &valueEnd, 10);
+
+        if (('\0' == optionValue[0]) || ('-' == optionValue[0]) || ('\0' != *valueEnd))
+            return false;
+
+        value = parsedValue;
+        return true;
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "FilterTransform.h" for documentation.
+
+    FilterTransform::FilterTransform(const EFilterType filterType) : GraphTransform(), filterType(filterType), minDegree(0), maxDegree(UINT64_MAX), rangeStart(0), rangeEnd(UINT64_MAX), sharedBuf(NULL), keptDegrees(NULL), degrees(NULL), numDegrees(0), relabelVertices(false), componentParents(NULL), componentSizes(NULL), numComponentVertices(0), largestComponent(0), newVertexIDs(NULL), oldVertexIDs(NULL), workScheduler()
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    FilterTransform::~FilterTransform(void)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "FilterTransform.h" for documentation.
+
+    void FilterTransform::ComputeComponents(const Graph& graph)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        // Every edge is present in each grouping, so components are found from whichever one is maintained, preferring the grouping by source.
+        const VertexIndex& vertexIndex = (graph.HasEdgesBySource() ? graph.VertexIndexSource() : graph.VertexIndexDestination());
+
+        if (0 == globalThreadID)
+        {
+            const TVertexCount numVerticesSource = (graph.HasEdgesBySource() ? graph.VertexIndexSource().GetNumVertices() : 0);
+            const TVertexCount numVerticesDestination = (graph.HasEdgesByDestination() ? graph.VertexIndexDestination().GetNumVertices() : 0);
+
+            numComponentVertices = ((numVerticesDestination > numVerticesSource) ? numVerticesDestination : numVerticesSource);
+            componentParents = new std::atomic<TVertexID>[numComponentVertices];
+            componentSizes = new std::atomic<TVertexCount>[numComponentVertices];
+        }
+
+        spindleBarrierGlobal();
+
+        const TVertexID rangeStartThread = (TVertexID)((numComponentVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEndThread = (TVertexID)((numComponentVertices * (globalThreadID + 1)) / globalThreadCount);
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+        {
+            componentParents[i].store(i, std::memory_order_relaxed);
+            componentSizes[i].store(0, std::memory_order_relaxed);
+        }
+
+        spindleBarrierGlobal();
+
+        // Link the endpoints of every edge, which makes each tree hold exactly one weakly connected component once all threads are done.
+        // Edges are linked independently of one another, so the edges of a single vertex can be split among several units of work.
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+        SWorkUnit unit;
+
+        workScheduler.ParallelInitialize(offsets, vertexIndex.GetNumVertices(), true);
+
+        while (workScheduler.GetWork(unit))
+        {
+            for (TVertexID i = unit.vertexStart; i < unit.vertexEnd; ++i)
+            {
+                for (TEdgeID j = unit.FirstEdge(offsets, i); j < unit.LastEdge(offsets, i); ++j)
+                    LinkComponents(i, vertexIndex.GetFrozenNeighbor(j));
+            }
+        }
+
+        spindleBarrierGlobal();
+
+        // Point every vertex directly at its root, so that deciding whether a vertex is kept is a single comparison.
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+            componentParents[i].store(FindComponentRoot(i), std::memory_order_relaxed);
+
+        spindleBarrierGlobal();
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+            componentSizes[componentParents[i].load(std::memory_order_relaxed)].fetch_add(1, std::memory_order_relaxed);
+
+        spindleBarrierGlobal();
+
+        // Each thread finds the largest component whose root lies within its range, and the first thread picks the largest of those.
+        // Roots are visited in increasing order, so ties go to the smallest root both within and across ranges.
+        TVertexID threadLargestComponent = 0;
+        TVertexCount threadLargestComponentSize = 0;
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+        {
+            const TVertexCount componentSize = componentSizes[i].load(std::memory_order_relaxed);
+
+            if (componentSize > threadLargestComponentSize)
+            {
+                threadLargestComponent = i;
+                threadLargestComponentSize = componentSize;
+            }
+        }
+
+        sharedBuf[globalThreadID << 1] = (uint64_t)threadLargestComponent;
+        sharedBuf[(globalThreadID << 1) + 1] = (uint64_t)threadLargestComponentSize;
+
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            TVertexCount largestComponentSize = 0;
+            largestComponent = 0;
+
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                if ((TVertexCount)sharedBuf[(i << 1) + 1] > largestComponentSize)
+                {
+                    largestComponent = (TVertexID)sharedBuf[i << 1];
+                    largestComponentSize = (TVertexCount)sharedBuf[(i << 1) + 1];
+                }
+            }
+        }
+
+        spindleBarrierGlobal();
+    }
+
+    // --------
+
+    void FilterTransform::ComputeDegrees(const Graph& graph)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        const VertexIndex* const outEdges = (graph.HasEdgesBySource() ? &graph.VertexIndexSource() : NULL);
+        const VertexIndex* const inEdges = (graph.HasEdgesByDestination() ? &graph.VertexIndexDestination() : NULL);
+
+        if (0 == globalThreadID)
+        {
+            const TVertexCount numVerticesSource = ((NULL != outEdges) ? outEdges->GetNumVertices() : 0);
+            const TVertexCount numVerticesDestination = ((NULL != inEdges) ? inEdges->GetNumVertices() : 0);
+
+            numDegrees = ((numVerticesDestination > numVerticesSource) ? numVerticesDestination : numVerticesSource);
+            degrees = new std::atomic<TEdgeCount>[numDegrees];
+        }
+
+        spindleBarrierGlobal();
+
+        const TVertexID rangeStartThread = (TVertexID)((numDegrees * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEndThread = (TVertexID)((numDegrees * (globalThreadID + 1)) / globalThreadCount);
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+            degrees[i].store(((NULL != outEdges) ? outEdges->GetDegree(i) : 0) + ((NULL != inEdges) ? inEdges->GetDegree(i) : 0), std::memory_order_relaxed);
+
+        spindleBarrierGlobal();
+
+        // If only one grouping is maintained, the edges in the other direction are counted by visiting every edge and crediting the vertex at its other end.
+        // Only the edges themselves matter, so units of work are split by edges alone.
+        if ((NULL == outEdges) || (NULL == inEdges))
+        {
+            const VertexIndex& vertexIndex = ((NULL != outEdges) ? *outEdges : *inEdges);
+            SWorkUnit unit;
+
+            workScheduler.ParallelInitialize(vertexIndex.GetFrozenOffsets(), vertexIndex.GetNumVertices(), true);
+
+            while (workScheduler.GetWork(unit))
+            {
+                for (TEdgeID i = unit.edgeStart; i < unit.edgeEnd; ++i)
+                {
+                    const TVertexID neighbor = vertexIndex.GetFrozenNeighbor(i);
+
+                    if (neighbor < (TVertexID)numDegrees)
+                        degrees[neighbor].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            spindleBarrierGlobal();
+        }
+    }
+
+    // --------
+
+    template <typename TNeighborID> size_t FilterTransform::FilterEdgeBatch(const TVertexID topLevelVertex, TNeighborID* const neighbors, UEdgeData* const edgeData, const size_t count) const
+    {
+        if (!KeepsVertex(topLevelVertex))
+            return 0;
+
+        size_t numKept = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (KeepsEdge(topLevelVertex, (TVertexID)neighbors[i]))
+            {
+                neighbors[numKept] = neighbors[i];
+
+                if (NULL != edgeData)
+                    edgeData[numKept] = edgeData[i];
+
+                numKept += 1;
+            }
+        }
+
+        return numKept;
+    }
+
+    // --------
+
+    void FilterTransform::RelabelKeptVertices(Graph& graph)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        const TVertexID rangeStartThread = (TVertexID)((numComponentVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEndThread = (TVertexID)((numComponentVertices * (globalThreadID + 1)) / globalThreadCount);
+
+        // Each thread counts the kept vertices in its range, so that the first thread can determine where each range begins in the new numbering.
+        uint64_t numKeptThread = 0;
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+        {
+            if (KeepsVertex(i))
+                numKeptThread += 1;
+        }
+
+        sharedBuf[globalThreadID] = numKeptThread;
+
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            uint64_t numKept = 0;
+
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                const uint64_t rangeKept = sharedBuf[i];
+                sharedBuf[i] = numKept;
+                numKept += rangeKept;
+            }
+
+            sharedBuf[globalThreadCount] = numKept;
+            newVertexIDs = new TVertexID[numComponentVertices];
+            oldVertexIDs = new TVertexID[numKept];
+        }
+
+        spindleBarrierGlobal();
+
+        // Removed vertices have no edges left, so they are neither top-level vertices nor neighbors in the result and need no new identifier.
+        const TVertexCount numKept = (TVertexCount)sharedBuf[globalThreadCount];
+        TVertexID position = (TVertexID)sharedBuf[globalThreadID];
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+        {
+            if (KeepsVertex(i))
+            {
+                newVertexIDs[i] = position;
+                oldVertexIDs[position] = i;
+                position += 1;
+            }
+        }
+
+        graph.ParallelRelabelVertices(newVertexIDs, oldVertexIDs, numKept, sharedBuf);
+
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            delete[] newVertexIDs;
+            newVertexIDs = NULL;
+
+            delete[] oldVertexIDs;
+            oldVertexIDs = NULL;
+        }
+    }
+
+    // --------
+
+    void FilterTransform::TransformVertexIndex(VertexIndex& vertexIndex)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        if (0 == globalThreadID)
+            keptDegrees = new TEdgeCount[vertexIndex.GetNumVertices()];
+
+        spindleBarrierGlobal();
+
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+        TCompactVertexID* const neighborsCompact = vertexIndex.GetFrozenNeighborsCompactWritable();
+        TVertexID* const neighbors = vertexIndex.GetFrozenNeighborsWritable();
+        UEdgeData* const edgeData = vertexIndex.GetFrozenEdgeDataWritable();
+        bool removedEdges = false;
+
+        // Kept edges are packed towards the start of each vertex's edges, so the edges of a vertex are never split among several units of work.
+        SWorkUnit unit;
+
+        workScheduler.ParallelInitialize(offsets, vertexIndex.GetNumVertices(), false);
+
+        while (workScheduler.GetWork(unit))
+        {
+            for (TVertexID i = unit.vertexStart; i < unit.vertexEnd; ++i)
+            {
+                const TEdgeID firstEdge = offsets[i];
+                const size_t numEdges = (size_t)(offsets[i + 1] - firstEdge);
+                UEdgeData* const vertexEdgeData = ((NULL != edgeData) ? &edgeData[firstEdge] : NULL);
+                size_t numKept = 0;
+
+                if (NULL != neighborsCompact)
+                    numKept = FilterEdgeBatch(i, &neighborsCompact[firstEdge], vertexEdgeData, numEdges);
+                else
+                    numKept = FilterEdgeBatch(i, &neighbors[firstEdge], vertexEdgeData, numEdges);
+
+                keptDegrees[i] = (TEdgeCount)numKept;
+
+                if (numKept != numEdges)
+                    removedEdges = true;
+            }
+        }
+
+        sharedBuf[globalThreadID] = (removedEdges ? 1 : 0);
+
+        spindleBarrierGlobal();
+
+        // Compaction, and with it the refresh of the metadata, is skipped if no thread removed any edges.
+        bool anyRemovedEdges = false;
+
+        for (uint32_t i = 0; i < globalThreadCount; ++i)
+        {
+            if (0 != sharedBuf[i])
+                anyRemovedEdges = true;
+        }
+
+        if (anyRemovedEdges)
+            vertexIndex.ParallelCompactFrozen(keptDegrees, sharedBuf);
+
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            delete[] keptDegrees;
+            keptDegrees = NULL;
+        }
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphTransform.h" for documentation.
+
+    bool FilterTransform::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        uint64_t value = 0;
+
+        if (EFilterType::FilterTypeDegree == filterType)
+        {
+            if (0 == strcmp(optionName, kTransformOptionMinDegree))
+            {
+                if (!ParseNumericOptionValue(optionValue, value))
+                    return false;
+
+                minDegree = (TEdgeCount)value;
+                return true;
+            }
+
+            if (0 == strcmp(optionName, kTransformOptionMaxDegree))
+            {
+                if (!ParseNumericOptionValue(optionValue, value))
+                    return false;
+
+                maxDegree = (TEdgeCount)value;
+                return true;
+            }
+        }
+
+        if (EFilterType::FilterTypeVertexRange == filterType)
+        {
+            if (0 == strcmp(optionName, kTransformOptionStart))
+            {
+                if (!ParseNumericOptionValue(optionValue, value))
+                    return false;
+
+                rangeStart = (TVertexID)value;
+                return true;
+            }
+
+            if (0 == strcmp(optionName, kTransformOptionEnd))
+            {
+                if (!ParseNumericOptionValue(optionValue, value))
+                    return false;
+
+                rangeEnd = (TVertexID)value;
+                return true;
+            }
+        }
+
+        if (EFilterType::FilterTypeLargestComponent == filterType)
+        {
+            if (0 == strcmp(optionName, kTransformOptionRelabel))
+            {
+                if (0 == strcmp(optionValue, "true"))
+                    relabelVertices = true;
+                else if (0 == strcmp(optionValue, "false"))
+                    relabelVertices = false;
+                else
+                    return false;
+
+                return true;
+            }
+        }
+
+        return GraphTransform::SubmitOption(optionName, optionValue);
+    }
+
+    // --------
+
+    EGraphResult FilterTransform::TransformGraph(Graph& graph)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        if (0 == globalThreadID)
+            sharedBuf = new uint64_t[globalThreadCount << 2];
+
+        spindleBarrierGlobal();
+
+        // Edges are filtered in place within the compact representation.
+        graph.ParallelFreeze(sharedBuf);
+
+        // Degrees and components are computed up front so that both groupings agree on which vertices are removed.
+        if (EFilterType::FilterTypeDegree == filterType)
+            ComputeDegrees(graph);
+        else if (EFilterType::FilterTypeLargestComponent == filterType)
+            ComputeComponents(graph);
+
+        if (graph.HasEdgesByDestination())
+            TransformVertexIndex(graph.VertexIndexDestinationWritable());
+
+        if (graph.HasEdgesBySource())
+            TransformVertexIndex(graph.VertexIndexSourceWritable());
+
+        if ((EFilterType::FilterTypeLargestComponent == filterType) && relabelVertices)
+            RelabelKeptVertices(graph);
+
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            delete[] sharedBuf;
+            sharedBuf = NULL;
+
+            if (NULL != degrees)
+            {
+                delete[] degrees;
+                degrees = NULL;
+                numDegrees = 0;
+            }
+
+            if (NULL != componentParents)
+            {
+                delete[] componentParents;
+                componentParents = NULL;
+
+                delete[] componentSizes;
+                componentSizes = NULL;
+                numComponentVertices = 0;
+            }
+        }
+
+        return EGraphResult::GraphResultSuccess;
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphTransform.h" for documentation.
+
+    bool FilterTransform::CanFuseTransformation(void) const
+    {
+        return ((EFilterType::FilterTypeDegree != filterType) && (EFilterType::FilterTypeLargestComponent != filterType));
+    }
+
+    // --------
+
+    size_t FilterTransform::TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count)
+    {
+        return FilterEdgeBatch(topLevelVertex, neighbors, edgeData, count);
+    }
+
+    // --------
+
+    size_t FilterTransform::TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count)
+    {
+        return FilterEdgeBatch(topLevelVertex, neighbors, edgeData, count);
+    }
+}
@@ -0,0 +1,330 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GAPWriter.cpp
+ *   Implementation of a graph writer for the serialized graph files used by
+ *   the GAP Benchmark Suite.
+ *****************************************************************************/
+
+#include "EdgeList.h"
+#include "GAPWriter.h"
+#include "Graph.h"
+#include "GraphWriter.h"
+#include "NUMASpawner.h"
+#include "PlatformFunctions.h"
+#include "Types.h"
+#include "VertexIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <spindle.h>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Number of consecutive vertices whose neighbors each thread formats at a time.
+    static const TVertexCount kNeighborsShardSize = 65536;
+
+    /// Largest number of vertices whose identifiers can all be represented using the 32-bit signed integers of the format.
+    static const uint64_t kMaxVertices = 0x80000000ull;
+
+    /// Number of bytes occupied by the header at the start of the file, which holds the directed flag, the number of edges, and the number of vertices.
+    static const int64_t kHeaderSize = (int64_t)(sizeof(uint8_t) + sizeof(int64_t) + sizeof(int64_t));
+
+
+    // -------- TYPE DEFINITIONS ------------------------------------------- //
+
+    /// Provides all information needed to specify the parallel writing of the neighbors of one section of the file.
+    struct SGAPNeighborsWriteSpec
+    {
+        FILE* file;                                                         ///< File handle, positioned where the neighbors begin.
+        const VertexIndex* vertexIndex;                                     ///< Vertex index whose edges make up the section.
+        bool topLevelIsDestination;                                         ///< Indicates that the vertex index groups edges by destination.
+        std::vector<char>* formattedShards;                                 ///< Formatted neighbors of each thread.
+    };
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Retrieves the number of bytes that each neighbor occupies, including its weight if the graph is weighted.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, held for each edge.
+    /// @return Number of bytes per neighbor.
+    template <typename TEdgeData> static inline size_t NeighborSize(void)
+    {
+        return (sizeof(int32_t) + sizeof(int32_t));
+    }
+
+    template <> inline size_t NeighborSize<void>(void)
+    {
+        return sizeof(int32_t);
+    }
+
+    /// Appends the vertex at the other end of an edge, followed by its weight truncated to an integer if the graph is weighted.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, held for each edge.
+    /// @param [in,out] output Buffer to which the neighbor should be appended.
+    /// @param [in] edge Edge whose neighbor should be appended.
+    /// @param [in] groupedByDestination Indicates that the neighbor is the source vertex instead of the destination vertex.
+    template <typename TEdgeData> static inline void AppendNeighbor(std::vector<char>& output, const SEdge<TEdgeData>& edge, const bool groupedByDestination)
+    {
+        const int32_t neighbor[2] = {(int32_t)(groupedByDestination ? edge.sourceVertex : edge.destinationVertex), (int32_t)edge.edgeData};
+        output.insert(output.end(), (const char*)neighbor, (const char*)neighbor + sizeof(neighbor));
+    }
+
+    template <> inline void AppendNeighbor<void>(std::vector<char>& output, const SEdge<void>& edge, const bool groupedByDestination)
+    {
+        const int32_t neighbor = (int32_t)(groupedByDestination ? edge.sourceVertex : edge.destinationVertex);
+        output.insert(output.end(), (const char*)&neighbor, (const char*)&neighbor + sizeof(neighbor));
+    }
+
+    /// Spindle entry point for writing the neighbors of one section of the file.
+    /// Each round, every thread formats the neighbors of a shard of consecutive vertices, and the first thread writes all of the shards in order.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, held for each edge.
+    /// @param [in] arg Pointer to an SGAPNeighborsWriteSpec object that defines the operation.
+    template <typename TEdgeData> static void ParallelWriteNeighborsFunc(void* arg)
+    {
+        SGAPNeighborsWriteSpec* const writeSpec = (SGAPNeighborsWriteSpec*)arg;
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        const VertexIndex& vertexIndex = *writeSpec->vertexIndex;
+        const TVertexCount numIndexVertices = vertexIndex.GetNumVertices();
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+
+        if (0 == globalThreadID)
+            writeSpec->formattedShards = new std::vector<char>[globalThreadCount];
+
+        spindleBarrierGlobal();
+
+        std::vector<char>& shard = writeSpec->formattedShards[globalThreadID];
+
+        for (TVertexCount roundStart = 0; roundStart < numIndexVertices; roundStart += (kNeighborsShardSize * globalThreadCount))
+        {
+            const TVertexCount shardStart = roundStart + (kNeighborsShardSize * globalThreadID);
+            const TVertexCount shardEnd = (((shardStart + kNeighborsShardSize) < numIndexVertices) ? (shardStart + kNeighborsShardSize) : numIndexVertices);
+            SEdge<TEdgeData> edge;
+
+            shard.clear();
+
+            for (TVertexID vertex = shardStart; vertex < shardEnd; ++vertex)
+            {
+                if (NULL != offsets)
+                {
+                    for (TEdgeID position = offsets[vertex]; position < offsets[vertex + 1]; ++position)
+                    {
+                        vertexIndex.FillFrozenEdge(position, edge, vertex, writeSpec->topLevelIsDestination);
+                        AppendNeighbor(shard, edge, writeSpec->topLevelIsDestination);
+                    }
+
+                    continue;
+                }
+
+                const EdgeList* const edgeList = vertexIndex[vertex];
+
+                if (NULL == edgeList)
+                    continue;
+
+                for (EdgeList::EdgeIterator edgeIter = edgeList->BeginIterator(); edgeIter != edgeList->EndIterator(); ++edgeIter)
+                {
+                    edgeList->FillEdge(edgeIter, edge, vertex, writeSpec->topLevelIsDestination);
+                    AppendNeighbor(shard, edge, writeSpec->topLevelIsDestination);
+                }
+            }
+
+            spindleBarrierGlobal();
+
+            if (0 == globalThreadID)
+            {
+                for (uint32_t i = 0; i < globalThreadCount; ++i)
+                {
+                    if (!(writeSpec->formattedShards[i].empty()))
+                        fwrite((void*)writeSpec->formattedShards[i].data(), sizeof(char), writeSpec->formattedShards[i].size(), writeSpec->file);
+                }
+            }
+
+            spindleBarrierGlobal();
+        }
+
+        if (0 == globalThreadID)
+            delete[] writeSpec->formattedShards;
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "GAPWriter.h" for documentation.
+
+    template <typename TEdgeData> GAPWriter<TEdgeData>::GAPWriter(void) : GraphWriter<TEdgeData>(), writesInEdgeSectionSeparately(false), inEdgeSectionPosition(0)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphWriter.h" for documentation.
+
+    template <typename TEdgeData> GraphWriter<TEdgeData>* GAPWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new GAPWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> void GAPWriter<TEdgeData>::FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
+    {
+        // Traversed edges always fill the neighbor array of a single section, so no secondary output is produced.
+        for (size_t i = 0; i < count; ++i)
+            AppendNeighbor(output, buf[i], groupedByDestination);
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* GAPWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        const TVertexCount numVertices = this->GetNumVerticesToWrite(graph);
+        const TEdgeCount numEdges = this->GetNumEdgesToWrite(graph);
+
+        // The format has no notion of partitions, and vertex identifiers must fit in 32-bit signed integers.
+        if ((1 < this->GetPartition().numPartitions) || ((uint64_t)numVertices > kMaxVertices))
+            return NULL;
+
+        FILE* graphfile = this->OpenGraphFileForWrite(filename);
+
+        if (NULL == graphfile)
+            return NULL;
+
+        // Write out the header, which always marks the graph as directed so that both sections are read.
+        const uint8_t directed = 1;
+        const int64_t headerNumEdges = (int64_t)numEdges;
+        const int64_t headerNumVertices = (int64_t)numVertices;
+
+        fwrite((void*)&directed, sizeof(directed), 1, graphfile);
+        fwrite((void*)&headerNumEdges, sizeof(headerNumEdges), 1, graphfile);
+        fwrite((void*)&headerNumVertices, sizeof(headerNumVertices), 1, graphfile);
+
+        // Everything that precedes the neighbors being traversed is written now.
+        // When traversing by source, that is only the out-edge offsets, and the in-edge section is written separately once the file is open.
+        // When traversing by destination, that is the entire out-edge section followed by the in-edge offsets, so the traversal completes the file.
+        bool sectionsWritten = WriteSection(graphfile, graph, numVertices, false, groupedByDestination);
+
+        if (sectionsWritten && groupedByDestination)
+            sectionsWritten = WriteSection(graphfile, graph, numVertices, true, false);
+
+        if (!sectionsWritten || (0 != fflush(graphfile)) || ferror(graphfile))
+        {
+            fclose(graphfile);
+            return NULL;
+        }
+
+        writesInEdgeSectionSeparately = !groupedByDestination;
+        inEdgeSectionPosition = kHeaderSize + (int64_t)(((uint64_t)numVertices + 1) * sizeof(int64_t)) + (int64_t)((uint64_t)numEdges * NeighborSize<TEdgeData>());
+
+        return graphfile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* GAPWriter<TEdgeData>::OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        FILE* inEdgeFile = NULL;
+
+        // Positions within a compressed file are unknown until it is written, so a compressed in-edge section is produced separately and appended.
+        // Otherwise, the in-edge section is written through a second handle to the same file, which the first handle has already created.
+        if (this->IsGraphFileCompressed())
+        {
+            inEdgeFile = this->OpenCompressedGraphFileSectionForWrite(filename);
+        }
+        else
+        {
+            inEdgeFile = fopen(filename, "r+b");
+
+            if ((NULL != inEdgeFile) && (0 != fseek64(inEdgeFile, inEdgeSectionPosition, SEEK_SET)))
+            {
+                fclose(inEdgeFile);
+                return NULL;
+            }
+        }
+
+        if (NULL == inEdgeFile)
+            return NULL;
+
+        // The entire in-edge section is written now, leaving nothing for the traversal to add to the secondary file.
+        if (!(WriteSection(inEdgeFile, graph, this->GetNumVerticesToWrite(graph), true, true)) || (0 != fflush(inEdgeFile)))
+        {
+            fclose(inEdgeFile);
+            return NULL;
+        }
+
+        return inEdgeFile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool GAPWriter<TEdgeData>::RequiresBothEdgeGroupings(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool GAPWriter<TEdgeData>::SupportsParallelFormatting(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool GAPWriter<TEdgeData>::UsesSecondaryGraphFile(void) const
+    {
+        return writesInEdgeSectionSeparately;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void GAPWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        // Formatting is shared with the parallel path, so that output is identical regardless of how it is produced.
+        this->WriteFormattedEdgesToFile(graphfile, graph, buf, count, groupedByDestination, currentPass);
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "GAPWriter.h" for documentation.
+
+    template <typename TEdgeData> bool GAPWriter<TEdgeData>::WriteSection(FILE* const file, const Graph& graph, const TVertexCount numVertices, const bool inEdges, const bool writesNeighbors) const
+    {
+        const VertexIndex& vertexIndex = (inEdges ? graph.VertexIndexDestination() : graph.VertexIndexSource());
+
+        // The offset array lists every vertex and ends with one more offset, which is the number of edges.
+        if (!(this->WriteVertexOffsetsToFile(file, vertexIndex, numVertices, &GraphWriter<TEdgeData>::AppendValueToBuffer, sizeof(int64_t), true)))
+            return false;
+
+        if (!writesNeighbors)
+            return true;
+
+        SGAPNeighborsWriteSpec neighborsWriteSpec;
+        neighborsWriteSpec.file = file;
+        neighborsWriteSpec.vertexIndex = &vertexIndex;
+        neighborsWriteSpec.topLevelIsDestination = inEdges;
+        neighborsWriteSpec.formattedShards = NULL;
+
+        const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelWriteNeighborsFunc<TEdgeData>, (void*)&neighborsWriteSpec);
+        return ((EGraphResult::GraphResultSuccess == spawnResult) && (0 == ferror(file)));
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class GAPWriter<void>;
+    template class GAPWriter<uint64_t>;
+    template class GAPWriter<double>;
+    template class GAPWriter<uint32_t>;
+    template class GAPWriter<float>;
+}
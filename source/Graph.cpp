@@ -12,19 +12,133 @@
  *****************************************************************************/
 
 #include "Graph.h"
+#include "NUMASpawner.h"
 #include "Types.h"
 #include "VertexIndex.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 
 namespace GraphTool
 {
+    // -------- TYPE DEFINITIONS ------------------------------------------- //
+
+    /// Provides all information needed to specify a graph freeze operation.
+    struct SGraphFreezeSpec
+    {
+        Graph* graph;                                                       ///< Graph object to be frozen.
+        uint64_t* freezeBuf;                                                ///< Temporary buffer with one location per thread.
+    };
+    
+    /// Provides all information needed to specify an operation that replaces a vertex index with one that holds only degrees.
+    struct SGraphAdoptDegreesSpec
+    {
+        VertexIndex* vertexIndex;                                           ///< Vertex index whose contents are replaced.
+        const TEdgeCount* degrees;                                          ///< Degree of each top-level vertex.
+        TVertexCount numVertices;                                           ///< Number of top-level vertices.
+        uint64_t* adoptBuf;                                                 ///< Temporary buffer with four locations per thread.
+    };
+    
+    /// Provides all information needed to specify an operation that applies a batch of changes to a graph.
+    struct SGraphApplyBatchSpec
+    {
+        Graph* graph;                                                       ///< Graph object to which the batch is applied.
+        TVertexCount numVertices;                                           ///< Number of top-level vertices in each updated index.
+        std::vector<SBatchEdge> insertionsByDestination;                    ///< Insertions sorted to match the destination-grouped index.
+        std::vector<SBatchEdge> insertionsBySource;                         ///< Insertions sorted to match the source-grouped index.
+        std::vector<SBatchEdge> deletionsByDestination;                     ///< Deletions sorted to match the destination-grouped index.
+        std::vector<SBatchEdge> deletionsBySource;                          ///< Deletions sorted to match the source-grouped index.
+        VertexIndex updatedByDestination;                                   ///< Updated destination-grouped index, built by the operation.
+        VertexIndex updatedBySource;                                        ///< Updated source-grouped index, built by the operation.
+        uint64_t* applyBuf;                                                 ///< Temporary buffer with four locations per thread.
+    };
+    
+    /// Provides all information needed to specify an operation that builds one grouping of edges from the other.
+    struct SGraphBuildGroupingSpec
+    {
+        Graph* graph;                                                       ///< Graph object whose edges are to be regrouped.
+        bool groupedByDestination;                                          ///< Specifies that the destination-grouped edges are to be built from the source-grouped edges, rather than the other way around.
+        uint64_t* edgeBuf;                                                  ///< Temporary buffer with two locations per edge.
+        uint64_t* buildBuf;                                                 ///< Temporary buffer with four locations per thread plus one location per pair of threads.
+    };
+    
+    
+    // -------- HELPERS ---------------------------------------------------- //
+    
+    /// Orders edges in a batch by top-level vertex and then by the vertex at the other end, which is the order expected when applying the batch to a vertex index.
+    /// @param [in] a First edge to compare.
+    /// @param [in] b Second edge to compare.
+    /// @return `true` if the first edge comes before the second, `false` otherwise.
+    static inline bool IsBatchEdgeLess(const SBatchEdge& a, const SBatchEdge& b)
+    {
+        return ((a.topLevelVertex < b.topLevelVertex) || ((a.topLevelVertex == b.topLevelVertex) && (a.otherVertex < b.otherVertex)));
+    }
+    
+    /// Produces a copy of a batch of edges sorted to match one grouping of edges.
+    /// Edges that compare equal keep their order within the batch, so that both groupings agree on the order of duplicate insertions.
+    /// @param [in] batch Batch of edges, each holding its source vertex as the top-level vertex.
+    /// @param [in] groupedByDestination Specifies that the copy should match the destination-grouped index, so the two ends of each edge are exchanged.
+    /// @param [out] sortedBatch Sorted copy of the batch.
+    static void SortBatchForGrouping(const std::vector<SBatchEdge>& batch, const bool groupedByDestination, std::vector<SBatchEdge>& sortedBatch)
+    {
+        sortedBatch = batch;
+        
+        if (groupedByDestination)
+        {
+            for (size_t i = 0; i < sortedBatch.size(); ++i)
+                std::swap(sortedBatch[i].topLevelVertex, sortedBatch[i].otherVertex);
+        }
+        
+        std::stable_sort(sortedBatch.begin(), sortedBatch.end(), &IsBatchEdgeLess);
+    }
+    
+    /// Spindle entry point for replacing a vertex index with one that holds only degrees.
+    /// @param [in] arg Pointer to an SGraphAdoptDegreesSpec object that defines the operation.
+    static void ParallelAdoptDegreesFunc(void* arg)
+    {
+        SGraphAdoptDegreesSpec* const adoptSpec = (SGraphAdoptDegreesSpec*)arg;
+        adoptSpec->vertexIndex->ParallelAdoptDegrees(adoptSpec->degrees, adoptSpec->numVertices, adoptSpec->adoptBuf);
+    }
+    
+    /// Spindle entry point for applying a batch of changes to a graph.
+    /// @param [in] arg Pointer to an SGraphApplyBatchSpec object that defines the operation.
+    static void ParallelApplyBatchFunc(void* arg)
+    {
+        SGraphApplyBatchSpec* const batchSpec = (SGraphApplyBatchSpec*)arg;
+        const bool keepEdgeData = (EEdgeDataType::EdgeDataTypeVoid != batchSpec->graph->GetEdgeDataType());
+        
+        if (batchSpec->graph->HasEdgesByDestination())
+            batchSpec->updatedByDestination.ParallelApplyBatchFrozen(batchSpec->graph->VertexIndexDestination(), batchSpec->insertionsByDestination.data(), batchSpec->insertionsByDestination.size(), batchSpec->deletionsByDestination.data(), batchSpec->deletionsByDestination.size(), batchSpec->numVertices, keepEdgeData, batchSpec->applyBuf);
+        
+        if (batchSpec->graph->HasEdgesBySource())
+            batchSpec->updatedBySource.ParallelApplyBatchFrozen(batchSpec->graph->VertexIndexSource(), batchSpec->insertionsBySource.data(), batchSpec->insertionsBySource.size(), batchSpec->deletionsBySource.data(), batchSpec->deletionsBySource.size(), batchSpec->numVertices, keepEdgeData, batchSpec->applyBuf);
+    }
+    
+    /// Spindle entry point for building one grouping of edges from the other.
+    /// @param [in] arg Pointer to an SGraphBuildGroupingSpec object that defines the operation.
+    static void ParallelBuildGroupingFunc(void* arg)
+    {
+        SGraphBuildGroupingSpec* const buildSpec = (SGraphBuildGroupingSpec*)arg;
+        buildSpec->graph->ParallelBuildEdgeGrouping(buildSpec->groupedByDestination, buildSpec->edgeBuf, buildSpec->buildBuf);
+    }
+    
+    /// Spindle entry point for freezing a graph.
+    /// @param [in] arg Pointer to an SGraphFreezeSpec object that defines the freeze operation.
+    static void ParallelFreezeFunc(void* arg)
+    {
+        SGraphFreezeSpec* const freezeSpec = (SGraphFreezeSpec*)arg;
+        freezeSpec->graph->ParallelFreeze(freezeSpec->freezeBuf);
+    }
+    
+    
     // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
     // See "Graph.h" for documentation.
 
-    Graph::Graph(void) : edgeDataType(EEdgeDataType::EdgeDataTypeVoid), edgesByDestination(), edgesBySource()
+    Graph::Graph(void) : edgeDataType(EEdgeDataType::EdgeDataTypeVoid), edgesByDestination(), edgesBySource(), hasEdgesByDestination(true), hasEdgesBySource(true)
     {
         // Nothing to do here.
     }
@@ -33,23 +147,250 @@ namespace GraphTool
     // -------- INSTANCE METHODS ------------------------------------------- //
     // See "Graph.h" for documentation.
 
+    EGraphResult Graph::AdoptDegrees(const bool groupedByDestination, const TEdgeCount* degrees, const TVertexCount numVertices)
+    {
+        const uint32_t numThreads = NUMASpawner::GetThreadCount();
+        
+        if (0 == numThreads)
+            return EGraphResult::GraphResultErrorUnknown;
+        
+        // Only the grouping described by the degrees is maintained.
+        SetEdgeGroupings(groupedByDestination, !groupedByDestination);
+        
+        // Define the adoption task.
+        SGraphAdoptDegreesSpec adoptSpec;
+        adoptSpec.vertexIndex = (groupedByDestination ? &edgesByDestination : &edgesBySource);
+        adoptSpec.degrees = degrees;
+        adoptSpec.numVertices = numVertices;
+        adoptSpec.adoptBuf = new uint64_t[numThreads << 2];
+        
+        if (NULL == adoptSpec.adoptBuf)
+            return EGraphResult::GraphResultErrorNoMemory;
+        
+        // Launch the adoption task on every NUMA node, each of which fills in its own partition of the offsets.
+        const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelAdoptDegreesFunc, (void*)&adoptSpec);
+        
+        // Clean up.
+        delete[] adoptSpec.adoptBuf;
+        
+        return spawnResult;
+    }
+    
+    // --------
+    
+    EGraphResult Graph::ApplyEdgeBatch(const std::vector<SBatchEdge>& insertions, const std::vector<SBatchEdge>& deletions)
+    {
+        // Batches are applied to the compact representation, which is rebuilt in a single pass rather than modified one edge at a time.
+        const EGraphResult freezeResult = Freeze();
+        
+        if (EGraphResult::GraphResultSuccess != freezeResult)
+            return freezeResult;
+        
+        const uint32_t numThreads = NUMASpawner::GetThreadCount();
+        
+        if (0 == numThreads)
+            return EGraphResult::GraphResultErrorUnknown;
+        
+        // Both updated indices cover every existing vertex and every vertex named by an insertion.
+        TVertexCount numVertices = ((edgesByDestination.GetNumVertices() > edgesBySource.GetNumVertices()) ? edgesByDestination.GetNumVertices() : edgesBySource.GetNumVertices());
+        
+        for (size_t i = 0; i < insertions.size(); ++i)
+        {
+            if (insertions[i].topLevelVertex >= numVertices)
+                numVertices = insertions[i].topLevelVertex + 1;
+            
+            if (insertions[i].otherVertex >= numVertices)
+                numVertices = insertions[i].otherVertex + 1;
+        }
+        
+        // Define the batch application task.
+        SGraphApplyBatchSpec batchSpec;
+        batchSpec.graph = this;
+        batchSpec.numVertices = numVertices;
+        
+        if (hasEdgesByDestination)
+        {
+            SortBatchForGrouping(insertions, true, batchSpec.insertionsByDestination);
+            SortBatchForGrouping(deletions, true, batchSpec.deletionsByDestination);
+        }
+        
+        if (hasEdgesBySource)
+        {
+            SortBatchForGrouping(insertions, false, batchSpec.insertionsBySource);
+            SortBatchForGrouping(deletions, false, batchSpec.deletionsBySource);
+        }
+        
+        batchSpec.applyBuf = new uint64_t[numThreads << 2];
+        
+        if (NULL == batchSpec.applyBuf)
+            return EGraphResult::GraphResultErrorNoMemory;
+        
+        // Launch the batch application task on every NUMA node, each of which fills in its own partition of the updated frozen representations.
+        const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelApplyBatchFunc, (void*)&batchSpec);
+        
+        // Clean up.
+        delete[] batchSpec.applyBuf;
+        
+        // The previous representations are released along with the task definition.
+        if (EGraphResult::GraphResultSuccess == spawnResult)
+        {
+            if (hasEdgesByDestination)
+                edgesByDestination.Swap(batchSpec.updatedByDestination);
+            
+            if (hasEdgesBySource)
+                edgesBySource.Swap(batchSpec.updatedBySource);
+        }
+        
+        return spawnResult;
+    }
+    
+    // --------
+    
+    EGraphResult Graph::BuildEdgeGrouping(const bool groupedByDestination)
+    {
+        if (groupedByDestination ? hasEdgesByDestination : hasEdgesBySource)
+            return EGraphResult::GraphResultSuccess;
+        
+        // Transposition works on the compact representation of the grouping that is already maintained.
+        const EGraphResult freezeResult = Freeze();
+        
+        if (EGraphResult::GraphResultSuccess != freezeResult)
+            return freezeResult;
+        
+        const uint32_t numThreads = NUMASpawner::GetThreadCount();
+        
+        if (0 == numThreads)
+            return EGraphResult::GraphResultErrorUnknown;
+        
+        // Define the grouping build task.
+        SGraphBuildGroupingSpec buildSpec;
+        buildSpec.graph = this;
+        buildSpec.groupedByDestination = groupedByDestination;
+        buildSpec.edgeBuf = new uint64_t[(GetNumEdges() << 1) + 1];
+        buildSpec.buildBuf = new uint64_t[(numThreads * numThreads) + (numThreads << 2)];
+        
+        if ((NULL == buildSpec.edgeBuf) || (NULL == buildSpec.buildBuf))
+            return EGraphResult::GraphResultErrorNoMemory;
+        
+        // Launch the grouping build task on every NUMA node, each of which fills in its own partition of the new frozen representation.
+        const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelBuildGroupingFunc, (void*)&buildSpec);
+        
+        // Clean up.
+        delete[] buildSpec.edgeBuf;
+        delete[] buildSpec.buildBuf;
+        
+        if (EGraphResult::GraphResultSuccess == spawnResult)
+        {
+            if (groupedByDestination)
+                hasEdgesByDestination = true;
+            else
+                hasEdgesBySource = true;
+        }
+        
+        return spawnResult;
+    }
+    
+    // --------
+    
+    uint64_t Graph::EstimateIngressFootprint(const TVertexCount numVertices, const TEdgeCount numEdges, const bool preallocated) const
+    {
+        const bool keepEdgeData = (EEdgeDataType::EdgeDataTypeVoid != edgeDataType);
+        const uint64_t numGroupings = (hasEdgesByDestination ? 1 : 0) + (hasEdgesBySource ? 1 : 0);
+        const uint64_t frozenBytes = VertexIndex::EstimateFrozenBytes(numVertices, numVertices, numEdges, keepEdgeData);
+        
+        if (preallocated)
+            return numGroupings * (frozenBytes + VertexIndex::EstimatePreallocatedIngressBytes(numVertices));
+        
+        // Groupings are frozen one at a time, and each one's mutable representation is released only once its compact representation is complete.
+        const uint64_t mutableBytes = VertexIndex::EstimateMutableBytes(numVertices, numEdges, keepEdgeData);
+        uint64_t peakBytes = 0;
+        
+        for (uint64_t i = 0; i < numGroupings; ++i)
+        {
+            const uint64_t freezeBytes = ((i + 1) * frozenBytes) + ((numGroupings - i) * mutableBytes);
+            
+            if (freezeBytes > peakBytes)
+                peakBytes = freezeBytes;
+        }
+        
+        return peakBytes;
+    }
+    
+    // --------
+    
+    EGraphResult Graph::Freeze(void)
+    {
+        if (IsFrozen())
+            return EGraphResult::GraphResultSuccess;
+        
+        const uint32_t numThreads = NUMASpawner::GetThreadCount();
+        
+        if (0 == numThreads)
+            return EGraphResult::GraphResultErrorUnknown;
+        
+        // Define the graph freeze task.
+        SGraphFreezeSpec freezeSpec;
+        freezeSpec.graph = this;
+        freezeSpec.freezeBuf = new uint64_t[numThreads];
+        
+        if (NULL == freezeSpec.freezeBuf)
+            return EGraphResult::GraphResultErrorNoMemory;
+        
+        // Launch the graph freeze task on every NUMA node, each of which fills in its own partition of the frozen representation.
+        const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelFreezeFunc, (void*)&freezeSpec);
+        
+        // Clean up.
+        delete[] freezeSpec.freezeBuf;
+        
+        return spawnResult;
+    }
+    
+    // --------
+    
     void Graph::RemoveVertex(const TVertexID vertex)
     {
         if (vertex >= GetNumVertices())
             return;
         
+        // A frozen graph can drop the vertex and every reference to it with a single pass over each index.
+        if (IsFrozen())
+        {
+            if (hasEdgesByDestination)
+                edgesByDestination.RemoveVertexAndReferencesFrozen(vertex);
+            
+            if (hasEdgesBySource)
+                edgesBySource.RemoveVertexAndReferencesFrozen(vertex);
+            
+            return;
+        }
+        
+        // Otherwise, individual edge lists are required below, so the mutable representation is needed.
+        Thaw();
+        
+        // With only one grouping maintained, references to the vertex can only be found by visiting every edge list.
+        if (!(hasEdgesByDestination && hasEdgesBySource))
+        {
+            VertexIndex& vertexIndex = (hasEdgesBySource ? edgesBySource : edgesByDestination);
+            
+            for (TVertexID i = 0; i < vertexIndex.GetNumVertices(); ++i)
+                vertexIndex.RemoveEdge(i, vertex);
+            
+            vertexIndex.RemoveVertex(vertex);
+            return;
+        }
+        
         // Remove all instances of the vertex as a source from the destination-grouped vertex index.
         if (NULL != edgesBySource[vertex])
         {
             for (auto destIt = edgesBySource[vertex]->BeginIterator(); destIt != edgesBySource[vertex]->EndIterator(); ++destIt)
-                edgesByDestination.RemoveEdge(destIt->otherVertex, vertex);
+                edgesByDestination.RemoveEdge(destIt.GetOtherVertex(), vertex);
         }
 
         // Remove all instances of the vertex as a destination from the source-grouped vertex index.
         if (NULL != edgesByDestination[vertex])
         {
             for (auto sourceIt = edgesByDestination[vertex]->BeginIterator(); sourceIt != edgesByDestination[vertex]->EndIterator(); ++sourceIt)
-                edgesBySource.RemoveEdge(sourceIt->otherVertex, vertex);
+                edgesBySource.RemoveEdge(sourceIt.GetOtherVertex(), vertex);
         }
 
         // Remove the top-level vertices.
@@ -82,6 +423,20 @@ namespace GraphTool
     
     // --------
     
+    template <> bool Graph::DoesEdgeDataTypeMatch<uint32_t>(void) const
+    {
+        return (EEdgeDataType::EdgeDataTypeInteger32 == edgeDataType);
+    }
+    
+    // --------
+    
+    template <> bool Graph::DoesEdgeDataTypeMatch<float>(void) const
+    {
+        return (EEdgeDataType::EdgeDataTypeFloatingPoint32 == edgeDataType);
+    }
+    
+    // --------
+    
     template <> void Graph::SetEdgeDataType<void>(void)
     {
         edgeDataType = EEdgeDataType::EdgeDataTypeVoid;
@@ -100,4 +455,33 @@ namespace GraphTool
     {
         edgeDataType = EEdgeDataType::EdgeDataTypeFloatingPoint;
     }
+    
+    // --------
+    
+    template <> void Graph::SetEdgeDataType<uint32_t>(void)
+    {
+        edgeDataType = EEdgeDataType::EdgeDataTypeInteger32;
+    }
+    
+    // --------
+    
+    template <> void Graph::SetEdgeDataType<float>(void)
+    {
+        edgeDataType = EEdgeDataType::EdgeDataTypeFloatingPoint32;
+    }
+    
+    // --------
+    
+    void Graph::SetEdgeGroupings(const bool byDestination, const bool bySource)
+    {
+        hasEdgesByDestination = byDestination;
+        hasEdgesBySource = (bySource || !byDestination);
+        
+        // Groupings that are no longer maintained are left empty.
+        if (!hasEdgesByDestination)
+            edgesByDestination.Clear();
+        
+        if (!hasEdgesBySource)
+            edgesBySource.Clear();
+    }
 }
@@ -0,0 +1,165 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GraphDelta.cpp
+ *   Implementation of the delta file format, which describes a batch of edge
+ *   insertions and deletions to apply to a graph.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "GraphDelta.h"
+#include "Types.h"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Parses an unsigned decimal integer and advances past it.
+    /// @param [in,out] position Pointer to the first character to parse, updated to point to the first character after the integer.
+    /// @param [out] value Parsed integer.
+    /// @return `true` if an integer was present, `false` otherwise.
+    static inline bool ParseUnsignedValue(const char*& position, uint64_t& value)
+    {
+        char* endPos;
+
+        while (isspace((int)*position)) position += 1;
+        if (!isdigit((int)*position))
+            return false;
+
+        value = strtoull(position, &endPos, 10);
+        position = endPos;
+        return true;
+    }
+
+    /// Parses the weight of an inserted edge according to the edge data type of the graph, and advances past it.
+    /// @param [in,out] position Pointer to the first character to parse, updated to point to the first character after the weight.
+    /// @param [in] edgeDataType Edge data type of the graph.
+    /// @param [out] edgeData Parsed weight, which is invalid if the graph holds no edge data.
+    /// @return `true` if a weight was present or none was needed, `false` otherwise.
+    static inline bool ParseEdgeWeight(const char*& position, const EEdgeDataType edgeDataType, UEdgeData& edgeData)
+    {
+        edgeData.Invalidate();
+
+        switch (edgeDataType)
+        {
+        case EEdgeDataType::EdgeDataTypeInteger:
+            return ParseUnsignedValue(position, edgeData.u);
+
+        case EEdgeDataType::EdgeDataTypeFloatingPoint:
+            {
+                char* endPos;
+
+                edgeData.d = strtod(position, &endPos);
+                if (position == endPos)
+                    return false;
+
+                position = endPos;
+                return true;
+            }
+
+        case EEdgeDataType::EdgeDataTypeInteger32:
+            return (ParseUnsignedValue(position, edgeData.u) && (edgeData.u <= (uint64_t)UINT32_MAX));
+
+        case EEdgeDataType::EdgeDataTypeFloatingPoint32:
+            {
+                char* endPos;
+
+                edgeData.d = (double)strtof(position, &endPos);
+                if (position == endPos)
+                    return false;
+
+                position = endPos;
+                return true;
+            }
+
+        default:
+            return true;
+        }
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "GraphDelta.h" for documentation.
+
+    EGraphResult GraphDelta::ApplyDeltaFromFile(const char* const filename, Graph& graph, TEdgeCount& numInsertions, TEdgeCount& numDeletions)
+    {
+        FILE* const deltafile = fopen(filename, "r");
+
+        if (NULL == deltafile)
+            return EGraphResult::GraphResultErrorCannotOpenFile;
+
+        // Gather the whole file into one batch of insertions and one batch of deletions, so that the graph is rebuilt only once.
+        std::vector<SBatchEdge> insertions;
+        std::vector<SBatchEdge> deletions;
+        char linebuf[kMaxLineLength];
+        bool parseSucceeded = true;
+
+        while (NULL != fgets(linebuf, sizeof(linebuf), deltafile))
+        {
+            const char* position = linebuf;
+
+            while (isspace((int)*position)) position += 1;
+            if (('\0' == *position) || ('#' == *position) || ('%' == *position))
+                continue;
+
+            const char operation = *position;
+            SBatchEdge change;
+
+            position += 1;
+
+            if ((('+' != operation) && ('-' != operation)) || !ParseUnsignedValue(position, change.topLevelVertex) || !ParseUnsignedValue(position, change.otherVertex))
+            {
+                parseSucceeded = false;
+                break;
+            }
+
+            if ('-' == operation)
+            {
+                change.edgeData.Invalidate();
+                deletions.push_back(change);
+                continue;
+            }
+
+            if (!ParseEdgeWeight(position, graph.GetEdgeDataType(), change.edgeData))
+            {
+                parseSucceeded = false;
+                break;
+            }
+
+            insertions.push_back(change);
+        }
+
+        const bool readSucceeded = (0 == ferror(deltafile));
+        fclose(deltafile);
+
+        if (!readSucceeded)
+            return EGraphResult::GraphResultErrorIO;
+
+        if (!parseSucceeded)
+            return EGraphResult::GraphResultErrorFormat;
+
+        const EGraphResult applyResult = graph.ApplyEdgeBatch(insertions, deletions);
+
+        if (EGraphResult::GraphResultSuccess == applyResult)
+        {
+            numInsertions = (TEdgeCount)insertions.size();
+            numDeletions = (TEdgeCount)deletions.size();
+        }
+
+        return applyResult;
+    }
+}
@@ -11,38 +11,295 @@
  *   files of various formats.
  *****************************************************************************/
 
+#include "BufferRing.h"
+#include "DecompressedFile.h"
+#include "DirectFile.h"
 #include "Graph.h"
 #include "GraphReader.h"
+#include "GraphReaderFactory.h"
+#include "IGraphWriter.h"
+#include "MemoryTracker.h"
+#include "NUMASpawner.h"
+#include "Statistics.h"
 #include "Types.h"
+#include "VertexIDMap.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <silo.h>
 #include <spindle.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 
 namespace GraphTool
 {
+    // -------- CONSTANTS -------------------------------------------------- //
+    
+    /// Reader option that selects the ingress strategy.
+    static const char* const kReaderOptionIngress = "ingress";
+    
+    /// Value of the ingress option that grows the mutable graph representation one edge at a time. This is the default.
+    static const char* const kReaderOptionIngressIncremental = "incremental";
+    
+    /// Value of the ingress option that counts degrees in a first pass and places edges directly into preallocated storage in a second pass.
+    static const char* const kReaderOptionIngressTwoPass = "twopass";
+    
+    /// Reader option that selects how the estimated memory footprint of ingress is checked before reading begins.
+    static const char* const kReaderOptionMemoryCheck = "memorycheck";
+    
+    /// Value of the memorycheck option that switches to two-pass ingress if only that fits in available memory, and otherwise fails if the estimate does not fit. This is the default.
+    static const char* const kReaderOptionMemoryCheckAuto = "auto";
+    
+    /// Value of the memorycheck option that fails if the estimate for the selected ingress strategy does not fit in available memory.
+    static const char* const kReaderOptionMemoryCheckStrict = "strict";
+    
+    /// Value of the memorycheck option that skips the check.
+    static const char* const kReaderOptionMemoryCheckOff = "off";
+    
+    /// Reader option that selects how the graph file is read.
+    static const char* const kReaderOptionIO = "io";
+    
+    /// Value of the io option that reads using the standard C library and the operating system's page cache. This is the default.
+    static const char* const kReaderOptionIOBuffered = "buffered";
+    
+    /// Value of the io option that reads using asynchronous direct I/O, bypassing the page cache.
+    static const char* const kReaderOptionIODirect = "direct";
+    
+    /// Reader option that specifies the number of requests to keep in flight when reading using asynchronous direct I/O.
+    static const char* const kReaderOptionIODepth = "iodepth";
+    
+    /// Reader option that specifies the number of threads that decompress a compressed graph file.
+    static const char* const kReaderOptionDecompressThreads = "decompressthreads";
+    
+    /// Reader option that specifies the number of read buffers.
+    static const char* const kReaderOptionBuffers = "buffers";
+    
+    /// Reader option that specifies the size of each read buffer, in megabytes.
+    static const char* const kReaderOptionBufferSize = "buffersize";
+    
+    /// Reader option that specifies the number of consumer threads.
+    static const char* const kReaderOptionThreads = "threads";
+    
+    /// Reader option that specifies the largest number of shards read concurrently, when the graph is split across several files.
+    static const char* const kReaderOptionShardThreads = "shardthreads";
+    
+    /// Reader option that selects how vertex identifiers read from the file are used.
+    static const char* const kReaderOptionIDs = "ids";
+    
+    /// Value of the ids option that uses vertex identifiers exactly as they appear in the file. This is the default.
+    static const char* const kReaderOptionIDsKeep = "keep";
+    
+    /// Value of the ids option that replaces vertex identifiers with dense identifiers assigned as each vertex is first seen, for files whose identifiers are sparse.
+    static const char* const kReaderOptionIDsRemap = "remap";
+    
+    /// Reader option that specifies a file to which the mapping from dense identifiers back to the identifiers read from the file is written, which also enables remapping.
+    static const char* const kReaderOptionIDMap = "idmap";
+    
+    
     // -------- TYPE DEFINITIONS ------------------------------------------- //
 
+    /// Identifies one of the files that hold a graph, along with the reader object that reads it.
+    template <typename TEdgeData> struct SGraphReadShard
+    {
+        std::string filename;                                               ///< File name.
+        GraphReader<TEdgeData>* reader;                                     ///< Graph reader object, which is the reader reading the graph if the graph is held in a single file and a reader created for the shard otherwise.
+        FILE* file;                                                         ///< File handle, or `NULL` if the file is not open.
+    };
+    
     /// Provides all information needed to specify a graph read operation.
     template <typename TEdgeData> struct SGraphReadSpec
     {
-        FILE* file;                                                         ///< File handle.
+        const std::vector<SGraphReadShard<TEdgeData>>* shards;              ///< Shards of the graph, each of which is open.
+        std::atomic<size_t> nextShard;                                      ///< Index of the next shard to be claimed by an edge producer thread.
+        std::atomic<uint64_t> nextSequence;                                 ///< Sequence number of the next buffer to be claimed by an edge producer thread.
+        uint32_t numProducers;                                              ///< Number of edge producer threads, each of which publishes one empty buffer once it is done.
         Graph* graph;                                                       ///< Graph object to be filled.
-        GraphReader<TEdgeData>* reader;                                     ///< Graph reader object.
-        SEdge<TEdgeData>* bufs[2];                                          ///< Edge data buffers.
-        TEdgeCount counts[2];                                               ///< Edge data buffer counts.
+        GraphReader<TEdgeData>* reader;                                     ///< Graph reader object, which holds the options and the vertex identifier map that apply to all shards.
+        BufferRing* ring;                                                   ///< Coordinates the use of the buffers by the edge producer and the consumers.
+        std::vector<SEdge<TEdgeData>*> bufs;                                ///< Edge data buffers, one per position in the ring.
+        std::vector<char*> chunks;                                          ///< Raw chunk buffers, one per position in the ring, used only by readers that parse in parallel and `NULL` otherwise.
+        std::vector<const GraphReader<TEdgeData>*> chunkReaders;            ///< Reader object of the shard from which each raw chunk was read, which parses it.
+        std::vector<TEdgeCount> counts;                                     ///< Edge data buffer counts. For readers that parse in parallel, holds the number of bytes in each raw chunk until it is parsed.
+        size_t bufSize;                                                     ///< Size in bytes of each edge data buffer and of each raw chunk buffer, excluding padding.
+        TEdgeCount bufCapacity;                                             ///< Number of edges that each edge data buffer can hold.
+        TVertexCount numVertices;                                           ///< Number of vertices for which storage is set aside, which bounds every vertex identifier once any remapping is applied.
+        uint32_t* partitionedEdges[2];                                      ///< Positions of the edges in the current buffer, grouped by the thread that owns the destination and source vertex, respectively.
+        TEdgeCount* partitionOffsets[2];                                    ///< Starting position within each of the partitioned edge arrays for each pair of owning thread and partitioning thread.
+        TEdgeCount* parseOffsets;                                           ///< Starting position within the edge buffer of the edges parsed by each thread.
         uint64_t* refreshDegreeBuf;                                         ///< Buffer for refreshing degree information.
+        IGraphWriter* const* writers;                                       ///< Graph writer objects to which edges are passed when streaming, or `NULL` otherwise.
+        size_t numWriters;                                                  ///< Number of graph writer objects.
+        TEdgeCount numStreamedEdges;                                        ///< Number of edges passed to the graph writer objects so far.
+        bool readsInPlace;                                                  ///< Specifies that every shard is mapped into memory and edge buffers point directly into the mappings.
+        uint32_t numaNode;                                                  ///< NUMA node on which the consumer threads run.
         EGraphResult readResult;                                            ///< Indicates the result of the read operation.
     };
 
 
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Parses the value of a reader option that holds an integer within the specified range.
+    /// @param [in] optionValue Value of the option.
+    /// @param [in] minValue Smallest valid value.
+    /// @param [in] maxValue Largest valid value.
+    /// @param [out] value Parsed value, modified only if parsing succeeds.
+    /// @return `true` if the value is a valid integer within range, `false` otherwise.
+    static bool ParseNumericOptionValue(const char* const optionValue, const uint64_t minValue, const uint64_t maxValue, uint64_t& value)
+    {
+        char* valueEnd = NULL;
+        const uint64_t parsedValue = (uint64_t)strtoull(optionValue, &valueEnd, 10);
+        
+        if (('\0' == optionValue[0]) || ('-' == optionValue[0]) || ('\0' != *valueEnd) || (parsedValue < minValue) || (parsedValue > maxValue))
+            return false;
+        
+        value = parsedValue;
+        return true;
+    }
+    
+    /// Determines which consumer thread owns the specified top-level vertex.
+    /// Each thread owns a contiguous range of vertices, with any vertex beyond the expected count assigned to the last thread.
+    /// @param [in] vertex Top-level vertex identifier.
+    /// @param [in] verticesPerThread Number of vertices in each thread's range.
+    /// @param [in] localThreadCount Number of consumer threads.
+    /// @return Local thread identifier of the owning thread.
+    static inline uint32_t OwnerOfVertex(const TVertexID vertex, const TVertexCount verticesPerThread, const uint32_t localThreadCount)
+    {
+        const TVertexID owner = vertex / verticesPerThread;
+        return ((owner < localThreadCount) ? (uint32_t)owner : (localThreadCount - 1));
+    }
+    
+    /// Allocates the buffers needed to partition edge buffers among consumer threads, for each grouping of edges that the graph maintains.
+    /// Invoked by all consumer threads.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    /// @param [in,out] readSpec Graph read operation specification.
+    template <typename TEdgeData> static void ParallelBeginPartitioning(SGraphReadSpec<TEdgeData>* readSpec)
+    {
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        if (0 == spindleGetLocalThreadID())
+        {
+            const bool partitionDirections[2] = { readSpec->graph->HasEdgesByDestination(), readSpec->graph->HasEdgesBySource() };
+            
+            for (uint32_t direction = 0; direction < 2; ++direction)
+            {
+                if (!partitionDirections[direction])
+                    continue;
+                
+                readSpec->partitionedEdges[direction] = new uint32_t[readSpec->bufCapacity];
+                readSpec->partitionOffsets[direction] = new TEdgeCount[(localThreadCount * localThreadCount) + 1];
+            }
+        }
+        
+        spindleBarrierLocal();
+    }
+    
+    /// Partitions the edges in the specified buffer by owning thread, once by destination vertex and once by source vertex.
+    /// Only the groupings of edges that the graph maintains are partitioned.
+    /// Each thread scans a contiguous slice of the buffer, so every edge is examined once no matter how many threads there are.
+    /// Within each thread's partition, edges remain in the order in which they appear in the buffer.
+    /// Invoked by all consumer threads, and on return each can find its edges in the ranges identified by the partition offsets.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    /// @param [in,out] readSpec Graph read operation specification.
+    /// @param [in] bufferIndex Index of the edge buffer to partition.
+    /// @param [in] numVertices Number of vertices expected in the graph, used to divide vertices among threads.
+    template <typename TEdgeData> static void ParallelPartitionEdgeBuffer(SGraphReadSpec<TEdgeData>* readSpec, const uint32_t bufferIndex, const TVertexCount numVertices)
+    {
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        const SEdge<TEdgeData>* const buf = readSpec->bufs[bufferIndex];
+        const TEdgeCount count = readSpec->counts[bufferIndex];
+        const TEdgeCount sliceStart = (count * localThreadID) / localThreadCount;
+        const TEdgeCount sliceEnd = (count * (localThreadID + 1)) / localThreadCount;
+        const TVertexCount verticesPerThread = ((numVertices > localThreadCount) ? ((numVertices + localThreadCount - 1) / localThreadCount) : 1);
+        const bool partitionDirections[2] = { readSpec->graph->HasEdgesByDestination(), readSpec->graph->HasEdgesBySource() };
+        
+        // Count the edges in this thread's slice that belong to each owner.
+        std::vector<TEdgeCount> positions[2] = { std::vector<TEdgeCount>(localThreadCount, 0), std::vector<TEdgeCount>(localThreadCount, 0) };
+        
+        for (TEdgeCount i = sliceStart; i < sliceEnd; ++i)
+        {
+            if (partitionDirections[0])
+                positions[0][OwnerOfVertex(buf[i].destinationVertex, verticesPerThread, localThreadCount)] += 1;
+            
+            if (partitionDirections[1])
+                positions[1][OwnerOfVertex(buf[i].sourceVertex, verticesPerThread, localThreadCount)] += 1;
+        }
+        
+        for (uint32_t direction = 0; direction < 2; ++direction)
+        {
+            if (!partitionDirections[direction])
+                continue;
+            
+            for (uint32_t owner = 0; owner < localThreadCount; ++owner)
+                readSpec->partitionOffsets[direction][(owner * localThreadCount) + localThreadID] = positions[direction][owner];
+        }
+        
+        spindleBarrierLocal();
+        
+        // Lay out each owner's edges contiguously, ordered by the slice from which they came.
+        if (0 == localThreadID)
+        {
+            for (uint32_t direction = 0; direction < 2; ++direction)
+            {
+                if (!partitionDirections[direction])
+                    continue;
+                
+                TEdgeCount position = 0;
+                
+                for (uint32_t i = 0; i < (localThreadCount * localThreadCount); ++i)
+                {
+                    const TEdgeCount numEdges = readSpec->partitionOffsets[direction][i];
+                    readSpec->partitionOffsets[direction][i] = position;
+                    position += numEdges;
+                }
+                
+                readSpec->partitionOffsets[direction][localThreadCount * localThreadCount] = position;
+            }
+        }
+        
+        spindleBarrierLocal();
+        
+        // Place the position of each edge in this thread's slice into its owners' partitions.
+        for (uint32_t direction = 0; direction < 2; ++direction)
+        {
+            if (!partitionDirections[direction])
+                continue;
+            
+            for (uint32_t owner = 0; owner < localThreadCount; ++owner)
+                positions[direction][owner] = readSpec->partitionOffsets[direction][(owner * localThreadCount) + localThreadID];
+        }
+        
+        for (TEdgeCount i = sliceStart; i < sliceEnd; ++i)
+        {
+            if (partitionDirections[0])
+                readSpec->partitionedEdges[0][positions[0][OwnerOfVertex(buf[i].destinationVertex, verticesPerThread, localThreadCount)]++] = (uint32_t)i;
+            
+            if (partitionDirections[1])
+                readSpec->partitionedEdges[1][positions[1][OwnerOfVertex(buf[i].sourceVertex, verticesPerThread, localThreadCount)]++] = (uint32_t)i;
+        }
+        
+        spindleBarrierLocal();
+    }
+
+
     // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
     // See "GraphReader.h" for documentation.
 
-    template <typename TEdgeData> GraphReader<TEdgeData>::GraphReader(void)
+    template <typename TEdgeData> GraphReader<TEdgeData>::GraphReader(void) : numVerticesInFile(0), numEdgesInFile(0), useTwoPassIngress(false), memoryCheck(MemoryCheckAuto), useDirectIO(false), directIOQueueDepth(DirectFile::kDefaultQueueDepth), numDecompressionThreads(DecompressedFile::kDefaultNumThreads), numReadBuffers(kGraphReadBufferCount), readBufferSize(kGraphReadBufferSize), numConsumerThreads(0), numShardThreads(kGraphReadShardThreads), remapVertexIDs(false), vertexIDMapFile(), vertexIDMap()
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    template <typename TEdgeData> GraphReader<TEdgeData>::GraphReader(const GraphReader<TEdgeData>& other) : IGraphReader(), numVerticesInFile(0), numEdgesInFile(0), useTwoPassIngress(other.useTwoPassIngress), memoryCheck(other.memoryCheck), useDirectIO(other.useDirectIO), directIOQueueDepth(other.directIOQueueDepth), numDecompressionThreads(other.numDecompressionThreads), numReadBuffers(other.numReadBuffers), readBufferSize(other.readBufferSize), numConsumerThreads(other.numConsumerThreads), numShardThreads(other.numShardThreads), remapVertexIDs(other.remapVertexIDs), vertexIDMapFile(other.vertexIDMapFile), vertexIDMap()
     {
         // Nothing to do here.
     }
@@ -58,27 +315,181 @@ namespace GraphTool
     // -------- CLASS METHODS ---------------------------------------------- //
     // See "GraphReader.h" for documentation.
 
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::AreShardEdgeCountsExact(const std::vector<SGraphReadShard<TEdgeData>>& shards)
+    {
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            if (!(shards[i].reader->IsEdgeCountExact()))
+                return false;
+        }
+        
+        return true;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::DegreeCountConsumer(void* arg)
+    {
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        SGraphReadSpec<TEdgeData>* readSpec = (SGraphReadSpec<TEdgeData>*)arg;
+        const TVertexCount numVertices = readSpec->numVertices;
+        TEdgeCount numInvalidEdges = 0;
+        std::vector<SEdge<TEdgeData>> parsedEdges;
+        uint64_t sequence = 0;
+        uint32_t numFinishedProducers = 0;
+        uint64_t stallTime = 0;
+        uint64_t parseTime = 0;
+        uint64_t remapTime = 0;
+        uint64_t countTime = 0;
+        
+        if (0 == localThreadID)
+            readSpec->refreshDegreeBuf = new uint64_t[localThreadCount << 2];
+        
+        ParallelBeginPartitioning(readSpec);
+        readSpec->graph->ParallelBeginPreallocatedIngress(numVertices);
+        
+        // Iteratively count the edges that the edge producer loads into the edge buffers.
+        while (true)
+        {
+            // Wait for the next buffer to be filled with edges, stopping once every edge producer thread is done, including after an I/O error.
+            if (!ParallelWaitForBuffer(readSpec, sequence, numFinishedProducers, stallTime))
+                break;
+            
+            const uint32_t currentIndex = readSpec->ring->BufferIndex(sequence);
+            
+            // Turn raw file contents into edges, if the reader leaves that to the consumers, and then replace their vertex identifiers, if requested.
+            const uint64_t parseStartTime = Statistics::GetTimestamp();
+            ParallelParseChunk(readSpec, currentIndex, parsedEdges);
+            const uint64_t remapStartTime = Statistics::GetTimestamp();
+            ParallelRemapEdgeBuffer(readSpec, currentIndex);
+            const uint64_t countStartTime = Statistics::GetTimestamp();
+            parseTime += remapStartTime - parseStartTime;
+            remapTime += countStartTime - remapStartTime;
+            
+            // Each thread counts only the edges whose top-level vertices fall within its own range.
+            // Storage is sized by the vertex count in the file header, so any edge that refers to a vertex beyond it is invalid.
+            // Both ends are checked because a grouping that is not maintained now may later be built from the one that is.
+            ParallelPartitionEdgeBuffer(readSpec, currentIndex, numVertices);
+            
+            if (readSpec->graph->HasEdgesByDestination())
+            {
+                for (TEdgeCount i = readSpec->partitionOffsets[0][localThreadID * localThreadCount]; i < readSpec->partitionOffsets[0][(localThreadID + 1) * localThreadCount]; ++i)
+                {
+                    const SEdge<TEdgeData>& edge = readSpec->bufs[currentIndex][readSpec->partitionedEdges[0][i]];
+                    
+                    if ((edge.destinationVertex < numVertices) && (edge.sourceVertex < numVertices))
+                        readSpec->graph->FastCountEdgeByDestination(edge);
+                    else
+                        numInvalidEdges += 1;
+                }
+            }
+            
+            if (readSpec->graph->HasEdgesBySource())
+            {
+                for (TEdgeCount i = readSpec->partitionOffsets[1][localThreadID * localThreadCount]; i < readSpec->partitionOffsets[1][(localThreadID + 1) * localThreadCount]; ++i)
+                {
+                    const SEdge<TEdgeData>& edge = readSpec->bufs[currentIndex][readSpec->partitionedEdges[1][i]];
+                    
+                    if ((edge.sourceVertex < numVertices) && (edge.destinationVertex < numVertices))
+                        readSpec->graph->FastCountEdgeBySource(edge);
+                    else
+                        numInvalidEdges += 1;
+                }
+            }
+            
+            countTime += Statistics::GetTimestamp() - countStartTime;
+            
+            // Hand the buffer back to the edge producer and move on to the next one, which may already be filled.
+            ParallelReleaseBuffer(readSpec, sequence);
+            sequence += 1;
+        }
+        
+        // Storage can only be allocated if every edge is valid and every vertex identifier could be remapped.
+        readSpec->refreshDegreeBuf[localThreadID] = numInvalidEdges;
+        spindleBarrierLocal();
+        
+        if (0 == localThreadID)
+        {
+            for (uint32_t i = 0; i < localThreadCount; ++i)
+            {
+                if (0 != readSpec->refreshDegreeBuf[i])
+                    readSpec->readResult = EGraphResult::GraphResultErrorFormat;
+            }
+            
+            if (readSpec->reader->remapVertexIDs && readSpec->reader->vertexIDMap.HasOverflowed())
+                readSpec->readResult = EGraphResult::GraphResultErrorFormat;
+            
+            // Dense identifiers cover only the distinct vertices actually seen, which may be fewer than the number for which degrees were counted.
+            if ((EGraphResult::GraphResultSuccess == readSpec->readResult) && readSpec->reader->remapVertexIDs)
+                readSpec->graph->ShrinkPreallocatedIngress(readSpec->reader->vertexIDMap.GetNumIDs());
+        }
+        
+        spindleBarrierLocal();
+        
+        if (EGraphResult::GraphResultSuccess != readSpec->readResult)
+            return;
+        
+        const uint64_t allocateStartTime = Statistics::GetTimestamp();
+        readSpec->graph->ParallelAllocateFromDegrees(readSpec->refreshDegreeBuf);
+        
+        // The first consumer thread reports on behalf of all of them, since they all proceed in lock-step.
+        if (0 == localThreadID)
+        {
+            Statistics::AddPhaseDetailTime("consumer stall", stallTime);
+            
+            if (NULL != readSpec->chunks[0])
+                Statistics::AddPhaseDetailTime("parse", parseTime);
+            
+            if (readSpec->reader->remapVertexIDs)
+                Statistics::AddPhaseDetailTime("remap ids", remapTime);
+            
+            Statistics::AddPhaseDetailTime("count degrees", countTime);
+            Statistics::AddPhaseDetailTime("allocate", Statistics::GetTimestamp() - allocateStartTime);
+        }
+    }
+    
+    // --------
+    
     template <typename TEdgeData> void GraphReader<TEdgeData>::EdgeConsumer(void* arg)
     {
         const uint32_t localThreadID = spindleGetLocalThreadID();
         const uint32_t localThreadCount = spindleGetLocalThreadCount();
         
         SGraphReadSpec<TEdgeData>* readSpec = (SGraphReadSpec<TEdgeData>*)arg;
-        uint32_t currentIndex = 0;
+        std::vector<SEdge<TEdgeData>> parsedEdges;
+        uint64_t sequence = 0;
+        uint32_t numFinishedProducers = 0;
+        uint64_t stallTime = 0;
+        uint64_t parseTime = 0;
+        uint64_t remapTime = 0;
+        uint64_t insertTime = 0;
+        
+        // Fast insertion, used with higher numbers of threads, requires each thread to have its own arena and a partitioning of each buffer.
+        if (localThreadCount > 2)
+        {
+            readSpec->graph->ParallelInitializeArenas(readSpec->numaNode);
+            ParallelBeginPartitioning(readSpec);
+        }
 
         // Iteratively consume edges that the edge producer loads into the edge buffers.
         while (true)
         {
-            // Wait for the buffer to be filled with edges.
-            spindleBarrierGlobal();
-
-            // Check for termination.
-            if (0 == readSpec->counts[currentIndex])
+            // Wait for the next buffer to be filled with edges, stopping once every edge producer thread is done, including after an I/O error.
+            if (!ParallelWaitForBuffer(readSpec, sequence, numFinishedProducers, stallTime))
                 break;
-
-            // Check for I/O errors.
-            if (EGraphResult::GraphResultSuccess != readSpec->readResult)
-                return;
+            
+            const uint32_t currentIndex = readSpec->ring->BufferIndex(sequence);
+            
+            // Turn raw file contents into edges, if the reader leaves that to the consumers, and then replace their vertex identifiers, if requested.
+            const uint64_t parseStartTime = Statistics::GetTimestamp();
+            ParallelParseChunk(readSpec, currentIndex, parsedEdges);
+            const uint64_t remapStartTime = Statistics::GetTimestamp();
+            ParallelRemapEdgeBuffer(readSpec, currentIndex);
+            const uint64_t insertStartTime = Statistics::GetTimestamp();
+            parseTime += remapStartTime - parseStartTime;
+            remapTime += insertStartTime - remapStartTime;
 
             // Read the buffer into the graph.
             // Use different parallelization strategies based on the number of threads created.
@@ -86,10 +497,7 @@ namespace GraphTool
             {
             case 1:
                 for (TEdgeCount i = 0; i < readSpec->counts[currentIndex]; ++i)
-                {
-                    readSpec->graph->InsertEdgeByDestination(readSpec->bufs[currentIndex][i]);
-                    readSpec->graph->InsertEdgeBySource(readSpec->bufs[currentIndex][i]);
-                }
+                    readSpec->graph->InsertEdge(readSpec->bufs[currentIndex][i]);
                 break;
 
             case 2:
@@ -98,11 +506,13 @@ namespace GraphTool
                     switch (localThreadID)
                     {
                     case 0:
-                        readSpec->graph->InsertEdgeByDestination(readSpec->bufs[currentIndex][i]);
+                        if (readSpec->graph->HasEdgesByDestination())
+                            readSpec->graph->InsertEdgeByDestination(readSpec->bufs[currentIndex][i]);
                         break;
 
                     case 1:
-                        readSpec->graph->InsertEdgeBySource(readSpec->bufs[currentIndex][i]);
+                        if (readSpec->graph->HasEdgesBySource())
+                            readSpec->graph->InsertEdgeBySource(readSpec->bufs[currentIndex][i]);
                         break;
 
                     default:
@@ -112,23 +522,34 @@ namespace GraphTool
                 break;
 
             default:
-                for (TEdgeCount i = 0; i < readSpec->counts[currentIndex]; ++i)
+                // Each thread inserts only the edges whose top-level vertices fall within its own range.
+                ParallelPartitionEdgeBuffer(readSpec, currentIndex, readSpec->numVertices);
+                
+                if (readSpec->graph->HasEdgesByDestination())
                 {
-                    if (localThreadID == (readSpec->bufs[currentIndex][i].destinationVertex % localThreadCount))
-                        readSpec->graph->FastInsertEdgeByDestination(readSpec->bufs[currentIndex][i]);
-                    
-                    if (localThreadID == (readSpec->bufs[currentIndex][i].sourceVertex % localThreadCount))
-                        readSpec->graph->FastInsertEdgeBySource(readSpec->bufs[currentIndex][i]);
+                    for (TEdgeCount i = readSpec->partitionOffsets[0][localThreadID * localThreadCount]; i < readSpec->partitionOffsets[0][(localThreadID + 1) * localThreadCount]; ++i)
+                        readSpec->graph->FastInsertEdgeByDestination(readSpec->bufs[currentIndex][readSpec->partitionedEdges[0][i]], localThreadID);
+                }
+                
+                if (readSpec->graph->HasEdgesBySource())
+                {
+                    for (TEdgeCount i = readSpec->partitionOffsets[1][localThreadID * localThreadCount]; i < readSpec->partitionOffsets[1][(localThreadID + 1) * localThreadCount]; ++i)
+                        readSpec->graph->FastInsertEdgeBySource(readSpec->bufs[currentIndex][readSpec->partitionedEdges[1][i]], localThreadID);
                 }
                 break;
             }
+            
+            insertTime += Statistics::GetTimestamp() - insertStartTime;
 
-            // Switch to the other buffer to consume in parallel with edge production.
-            currentIndex = (~currentIndex) & 1;
+            // Hand the buffer back to the edge producer and move on to the next one, which may already be filled.
+            ParallelReleaseBuffer(readSpec, sequence);
+            sequence += 1;
         }
         
         // The fast insertion methods did not update the degree and vector counts, so do that here.
         // These were only used with higher numbers of threads, so this is only needed in that case.
+        const uint64_t refreshStartTime = Statistics::GetTimestamp();
+        
         if (localThreadCount > 2)
         {
             if (0 == localThreadID)
@@ -137,9 +558,22 @@ namespace GraphTool
             spindleBarrierLocal();
             readSpec->graph->ParallelRefreshMetadata(readSpec->refreshDegreeBuf);
             spindleBarrierLocal();
+        }
+        
+        // The first consumer thread reports on behalf of all of them.
+        // With two threads, each inserts into a different grouping, so the first thread's time may understate the insertion time.
+        if (0 == localThreadID)
+        {
+            Statistics::AddPhaseDetailTime("consumer stall", stallTime);
             
-            if (0 == localThreadID)
-                delete[] readSpec->refreshDegreeBuf;
+            if (NULL != readSpec->chunks[0])
+                Statistics::AddPhaseDetailTime("parse", parseTime);
+            
+            if (readSpec->reader->remapVertexIDs)
+                Statistics::AddPhaseDetailTime("remap ids", remapTime);
+            
+            Statistics::AddPhaseDetailTime("insert", insertTime);
+            Statistics::AddPhaseDetailTime("refresh metadata", Statistics::GetTimestamp() - refreshStartTime);
         }
     }
 
@@ -148,98 +582,1057 @@ namespace GraphTool
     template <typename TEdgeData> void GraphReader<TEdgeData>::EdgeProducer(void* arg)
     {
         SGraphReadSpec<TEdgeData>* readSpec = (SGraphReadSpec<TEdgeData>*)arg;
-        uint32_t currentBufferIndex = 0;
+        const std::vector<SGraphReadShard<TEdgeData>>& shards = *(readSpec->shards);
+        size_t shardIndex = readSpec->nextShard.fetch_add(1);
+        uint64_t stallTime = 0;
+        uint64_t readTime = 0;
 
         while (true)
         {
-            // Fill the buffer with edges.
-            readSpec->counts[currentBufferIndex] = readSpec->reader->ReadEdgesToBuffer(readSpec->file, readSpec->bufs[currentBufferIndex], (kGraphReadBufferSize / sizeof(SEdge<TEdgeData>)));
-
-            // Check for any I/O errors.
-            if (ferror(readSpec->file))
-                readSpec->readResult = EGraphResult::GraphResultErrorIO;
+            // Claim the next buffer in the sequence, which is simply the one after the last with a single edge producer thread, and wait for the consumers to finish with whatever it previously held.
+            const uint64_t sequence = readSpec->nextSequence.fetch_add(1);
+            const uint32_t currentBufferIndex = readSpec->ring->BufferIndex(sequence);
+            stallTime += readSpec->ring->WaitForFreeBuffer(sequence);
+            
+            const uint64_t readStartTime = Statistics::GetTimestamp();
+            
+            // Fill the buffer with edges, point it at the next edges in a mapped file, or fill it with raw file contents if the consumers are to parse them.
+            // Whenever a shard is exhausted, move on to the next unclaimed shard, so the buffer is left empty only once none remain or another thread has encountered an I/O error.
+            // The count is kept locally because consumers replace a raw chunk's byte count with its edge count once parsed.
+            TEdgeCount numRead = 0;
+            
+            while ((shardIndex < shards.size()) && (EGraphResult::GraphResultSuccess == readSpec->readResult))
+            {
+                const SGraphReadShard<TEdgeData>& shard = shards[shardIndex];
+                
+                if (readSpec->readsInPlace)
+                {
+                    // Consumers only ever read from edge buffers, so pointing them directly into a read-only mapping is safe.
+                    const SEdge<TEdgeData>* edges = NULL;
+                    numRead = shard.reader->ReadEdgesInPlace(edges, readSpec->bufCapacity);
+                    readSpec->bufs[currentBufferIndex] = (SEdge<TEdgeData>*)edges;
+                }
+                else if (NULL != readSpec->chunks[currentBufferIndex])
+                {
+                    numRead = (TEdgeCount)shard.reader->ReadChunkToBuffer(shard.file, readSpec->chunks[currentBufferIndex], readSpec->bufSize, readSpec->bufCapacity);
+                    memset((void*)&readSpec->chunks[currentBufferIndex][numRead], 0, kGraphReadChunkPadding);
+                    readSpec->chunkReaders[currentBufferIndex] = shard.reader;
+                }
+                else
+                {
+                    numRead = shard.reader->ReadEdgesToBuffer(shard.file, readSpec->bufs[currentBufferIndex], readSpec->bufCapacity);
+                }
+                
+                // Check for any I/O errors, in which case the buffer is left empty so that this thread stops at it and the others stop at their next buffer.
+                if (ferror(shard.file))
+                {
+                    readSpec->readResult = EGraphResult::GraphResultErrorIO;
+                    numRead = 0;
+                    break;
+                }
+                
+                if (0 != numRead)
+                    break;
+                
+                shardIndex = readSpec->nextShard.fetch_add(1);
+            }
+            
+            readTime += Statistics::GetTimestamp() - readStartTime;
+            readSpec->counts[currentBufferIndex] = numRead;
 
-            // Synchronize with consumers.
-            spindleBarrierGlobal();
+            // Make the buffer available to the consumers, including when it signals that this thread is done.
+            // Buffers are published in sequence order, so wait for the previous one, which another edge producer thread may still be filling.
+            if (0 != sequence)
+                stallTime += readSpec->ring->WaitForPublishedBuffer(sequence - 1);
+            
+            readSpec->ring->Publish(sequence);
 
-            // Check for termination or I/O errors detected previously.
-            if (0 == readSpec->counts[currentBufferIndex] || EGraphResult::GraphResultSuccess != readSpec->readResult)
+            if (0 == numRead)
                 break;
-
-            // Switch to the other buffer to read from file during a consumption operation.
-            currentBufferIndex = (~currentBufferIndex) & 1;
         }
+        
+        Statistics::AddPhaseDetailTime("read file", readTime);
+        Statistics::AddPhaseDetailTime("producer stall", stallTime);
     }
 
 
-    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
-    // See "GraphReader.h" for documentation.
-
-    template <typename TEdgeData> EGraphResult GraphReader<TEdgeData>::ReadGraphFromFile(const char* const filename, Graph& graph)
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::EdgeScatterConsumer(void* arg)
     {
-        // First, open the file.
-        FILE* graphfile = this->OpenAndInitializeGraphFileForRead(filename);
-        if (NULL == graphfile)
-            return EGraphResult::GraphResultErrorCannotOpenFile;
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
         
-        // Initialize some graph metadata fields.
-        graph.SetEdgeDataType<TEdgeData>();
-        graph.SetNumVertices(numVerticesInFile);
+        SGraphReadSpec<TEdgeData>* readSpec = (SGraphReadSpec<TEdgeData>*)arg;
+        std::vector<SEdge<TEdgeData>> parsedEdges;
+        uint64_t sequence = 0;
+        uint32_t numFinishedProducers = 0;
+        uint64_t stallTime = 0;
+        uint64_t parseTime = 0;
+        uint64_t remapTime = 0;
+        uint64_t insertTime = 0;
         
-        // Allocate some buffers for read data.
-        SEdge<TEdgeData>* bufs[] = { (SEdge<TEdgeData>*)(new uint8_t[kGraphReadBufferSize]), (SEdge<TEdgeData>*)(new uint8_t[kGraphReadBufferSize]) };
-        if (NULL == bufs[0] || NULL == bufs[1])
-            return EGraphResult::GraphResultErrorNoMemory;
-
-        // Define the graph read task.
-        SGraphReadSpec<TEdgeData> readSpec;
-
-        readSpec.file = graphfile;
-        readSpec.graph = &graph;
-        readSpec.reader = this;
-        readSpec.bufs[0] = bufs[0];
-        readSpec.bufs[1] = bufs[1];
-        readSpec.counts[0] = 0;
-        readSpec.counts[1] = 0;
-        readSpec.refreshDegreeBuf = NULL;
-        readSpec.readResult = EGraphResult::GraphResultSuccess;
-
-        // Define the parallelization strategy.
-        SSpindleTaskSpec taskSpec[2];
-
-        taskSpec[0].func = &EdgeProducer;
-        taskSpec[0].arg = (void*)&readSpec;
-        taskSpec[0].numaNode = siloGetNUMANodeForVirtualAddress(bufs[0]);
-        taskSpec[0].numThreads = 1;
-        taskSpec[0].smtPolicy = SpindleSMTPolicyPreferLogical;
-
-        taskSpec[1].func = &EdgeConsumer;
-        taskSpec[1].arg = (void*)&readSpec;
-        taskSpec[1].numaNode = siloGetNUMANodeForVirtualAddress(bufs[0]);
-        taskSpec[1].numThreads = 0;
-        taskSpec[1].smtPolicy = SpindleSMTPolicyPreferLogical;
-
-        // Launch the graph read task.
-        const uint32_t spawnResult = spindleThreadsSpawn(taskSpec, sizeof(taskSpec) / sizeof(taskSpec[0]), true);
-
-        // Clean up.
-        fclose(graphfile);
-        delete[] bufs[0];
-        delete[] bufs[1];
+        if (0 == localThreadID)
+            readSpec->refreshDegreeBuf = new uint64_t[localThreadCount << 2];
         
-        if (0 != spawnResult)
-            return EGraphResult::GraphResultErrorUnknown;
+        ParallelBeginPartitioning(readSpec);
         
-        // Consistency checks.
-        if (EGraphResult::GraphResultSuccess == readSpec.readResult)
+        // Iteratively place the edges that the edge producer loads into the edge buffers.
+        // The first pass already validated every edge and sized each vertex's storage exactly.
+        while (true)
         {
-            if (numEdgesInFile != graph.GetNumEdges())
-                return EGraphResult::GraphResultErrorFormat;
-            else
-                return EGraphResult::GraphResultSuccess;
+            // Wait for the next buffer to be filled with edges, stopping once every edge producer thread is done, including after an I/O error.
+            if (!ParallelWaitForBuffer(readSpec, sequence, numFinishedProducers, stallTime))
+                break;
+            
+            const uint32_t currentIndex = readSpec->ring->BufferIndex(sequence);
+            
+            // Turn raw file contents into edges, if the reader leaves that to the consumers, and then replace their vertex identifiers, if requested.
+            const uint64_t parseStartTime = Statistics::GetTimestamp();
+            ParallelParseChunk(readSpec, currentIndex, parsedEdges);
+            const uint64_t remapStartTime = Statistics::GetTimestamp();
+            ParallelRemapEdgeBuffer(readSpec, currentIndex);
+            const uint64_t insertStartTime = Statistics::GetTimestamp();
+            parseTime += remapStartTime - parseStartTime;
+            remapTime += insertStartTime - remapStartTime;
+            
+            // Ownership matches the first pass, so each thread places exactly the edges it counted.
+            ParallelPartitionEdgeBuffer(readSpec, currentIndex, readSpec->numVertices);
+            
+            if (readSpec->graph->HasEdgesByDestination())
+            {
+                for (TEdgeCount i = readSpec->partitionOffsets[0][localThreadID * localThreadCount]; i < readSpec->partitionOffsets[0][(localThreadID + 1) * localThreadCount]; ++i)
+                    readSpec->graph->FastScatterEdgeByDestination(readSpec->bufs[currentIndex][readSpec->partitionedEdges[0][i]]);
+            }
+            
+            if (readSpec->graph->HasEdgesBySource())
+            {
+                for (TEdgeCount i = readSpec->partitionOffsets[1][localThreadID * localThreadCount]; i < readSpec->partitionOffsets[1][(localThreadID + 1) * localThreadCount]; ++i)
+                    readSpec->graph->FastScatterEdgeBySource(readSpec->bufs[currentIndex][readSpec->partitionedEdges[1][i]]);
+            }
+            
+            insertTime += Statistics::GetTimestamp() - insertStartTime;
+            
+            // Hand the buffer back to the edge producer and move on to the next one, which may already be filled.
+            ParallelReleaseBuffer(readSpec, sequence);
+            sequence += 1;
         }
-        else
-            return readSpec.readResult;
+        
+        const uint64_t refreshStartTime = Statistics::GetTimestamp();
+        readSpec->graph->ParallelEndPreallocatedIngress();
+        readSpec->graph->ParallelRefreshMetadata(readSpec->refreshDegreeBuf);
+        spindleBarrierLocal();
+        
+        // The first consumer thread reports on behalf of all of them, since they all proceed in lock-step.
+        if (0 == localThreadID)
+        {
+            Statistics::AddPhaseDetailTime("consumer stall", stallTime);
+            
+            if (NULL != readSpec->chunks[0])
+                Statistics::AddPhaseDetailTime("parse", parseTime);
+            
+            if (readSpec->reader->remapVertexIDs)
+                Statistics::AddPhaseDetailTime("remap ids", remapTime);
+            
+            Statistics::AddPhaseDetailTime("insert", insertTime);
+            Statistics::AddPhaseDetailTime("refresh metadata", Statistics::GetTimestamp() - refreshStartTime);
+        }
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::FreeReadBuffers(std::vector<SEdge<TEdgeData>*>& bufs, std::vector<char*>& chunks)
+    {
+        for (size_t i = 0; i < bufs.size(); ++i)
+        {
+            if (NULL != bufs[i])
+            {
+                MemoryTracker::RecordRelease(bufs[i]);
+                delete[] (uint8_t*)bufs[i];
+            }
+        }
+        
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            if (NULL != chunks[i])
+            {
+                MemoryTracker::RecordRelease(chunks[i]);
+                delete[] chunks[i];
+            }
+        }
+        
+        bufs.clear();
+        chunks.clear();
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::ParallelParseChunk(SGraphReadSpec<TEdgeData>* readSpec, const uint32_t bufferIndex, std::vector<SEdge<TEdgeData>>& parsedEdges)
+    {
+        if (NULL == readSpec->chunks[bufferIndex])
+            return;
+        
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        const size_t chunkSize = (size_t)readSpec->counts[bufferIndex];
+        const size_t rangeStart = (chunkSize * localThreadID) / localThreadCount;
+        const size_t rangeEnd = (chunkSize * (localThreadID + 1)) / localThreadCount;
+        
+        if ((0 == localThreadID) && (NULL == readSpec->parseOffsets))
+            readSpec->parseOffsets = new TEdgeCount[localThreadCount];
+        
+        // Parse this thread's byte range into its own scratch space.
+        parsedEdges.clear();
+        readSpec->chunkReaders[bufferIndex]->ParseEdgesFromChunk(readSpec->chunks[bufferIndex], chunkSize, rangeStart, rangeEnd, parsedEdges);
+        
+        spindleBarrierLocal();
+        readSpec->parseOffsets[localThreadID] = (TEdgeCount)parsedEdges.size();
+        spindleBarrierLocal();
+        
+        // Ranges are ordered by position in the file, so laying out each thread's edges in thread order preserves file order.
+        if (0 == localThreadID)
+        {
+            TEdgeCount numParsedEdges = 0;
+            
+            for (uint32_t i = 0; i < localThreadCount; ++i)
+            {
+                const TEdgeCount threadEdges = readSpec->parseOffsets[i];
+                readSpec->parseOffsets[i] = numParsedEdges;
+                numParsedEdges += threadEdges;
+            }
+            
+            readSpec->counts[bufferIndex] = numParsedEdges;
+        }
+        
+        spindleBarrierLocal();
+        
+        if (0 != parsedEdges.size())
+            memcpy((void*)&readSpec->bufs[bufferIndex][readSpec->parseOffsets[localThreadID]], (void*)parsedEdges.data(), sizeof(SEdge<TEdgeData>) * parsedEdges.size());
+        
+        spindleBarrierLocal();
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::ParallelReleaseBuffer(SGraphReadSpec<TEdgeData>* readSpec, const uint64_t sequence)
+    {
+        // The edge producer may refill the buffer as soon as it is released, so every consumer thread must be done with it first.
+        spindleBarrierLocal();
+        
+        if (0 == spindleGetLocalThreadID())
+            readSpec->ring->Release(0, sequence);
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::ParallelRemapEdgeBuffer(SGraphReadSpec<TEdgeData>* readSpec, const uint32_t bufferIndex)
+    {
+        if (!(readSpec->reader->remapVertexIDs))
+            return;
+        
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        SEdge<TEdgeData>* const buf = readSpec->bufs[bufferIndex];
+        const TEdgeCount count = readSpec->counts[bufferIndex];
+        VertexIDMap& vertexIDMap = readSpec->reader->vertexIDMap;
+        
+        // A failed lookup leaves a valid identifier in place, so that consumers can proceed safely until the failure is reported.
+        for (TEdgeCount i = ((count * localThreadID) / localThreadCount); i < ((count * (localThreadID + 1)) / localThreadCount); ++i)
+        {
+            const TVertexID sourceVertex = vertexIDMap.FindOrInsert(buf[i].sourceVertex);
+            const TVertexID destinationVertex = vertexIDMap.FindOrInsert(buf[i].destinationVertex);
+            
+            buf[i].sourceVertex = ((VertexIDMap::kInvalidID == sourceVertex) ? 0 : sourceVertex);
+            buf[i].destinationVertex = ((VertexIDMap::kInvalidID == destinationVertex) ? 0 : destinationVertex);
+        }
+        
+        spindleBarrierLocal();
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::ParallelWaitForBuffer(SGraphReadSpec<TEdgeData>* readSpec, uint64_t& sequence, uint32_t& numFinishedProducers, uint64_t& stallTime)
+    {
+        while (true)
+        {
+            stallTime += readSpec->ring->WaitForPublishedBuffer(sequence);
+            
+            if (0 != readSpec->counts[readSpec->ring->BufferIndex(sequence)])
+                return true;
+            
+            // Each edge producer thread publishes exactly one empty buffer, after which it publishes nothing more, so the last of them signals termination.
+            numFinishedProducers += 1;
+            
+            if (numFinishedProducers == readSpec->numProducers)
+                return false;
+            
+            // The remaining edge producer threads may need this buffer to make progress.
+            ParallelReleaseBuffer(readSpec, sequence);
+            sequence += 1;
+        }
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::ShardOpenWorker(std::vector<SGraphReadShard<TEdgeData>>* shards, std::atomic<size_t>* nextShard)
+    {
+        for (size_t i = nextShard->fetch_add(1); i < shards->size(); i = nextShard->fetch_add(1))
+        {
+            SGraphReadShard<TEdgeData>& shard = (*shards)[i];
+            shard.file = shard.reader->OpenAndInitializeGraphFileForRead(shard.filename.c_str());
+        }
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::StreamConsumer(void* arg)
+    {
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        SGraphReadSpec<TEdgeData>* readSpec = (SGraphReadSpec<TEdgeData>*)arg;
+        const TVertexCount numVertices = readSpec->reader->numVerticesInFile;
+        TEdgeCount numInvalidEdges = 0;
+        std::vector<SEdge<TEdgeData>> parsedEdges;
+        uint64_t sequence = 0;
+        uint32_t numFinishedProducers = 0;
+        uint64_t stallTime = 0;
+        uint64_t parseTime = 0;
+        uint64_t writeTime = 0;
+        
+        if (0 == localThreadID)
+            readSpec->refreshDegreeBuf = new uint64_t[localThreadCount];
+        
+        // Iteratively pass the edges that the edge producer loads into the edge buffers to each of the writers.
+        while (true)
+        {
+            // Wait for the next buffer to be filled with edges, stopping once every edge producer thread is done, including after an I/O error.
+            if (!ParallelWaitForBuffer(readSpec, sequence, numFinishedProducers, stallTime))
+                break;
+            
+            const uint32_t currentIndex = readSpec->ring->BufferIndex(sequence);
+            
+            // Turn raw file contents into edges, if the reader leaves that to the consumers.
+            const uint64_t parseStartTime = Statistics::GetTimestamp();
+            ParallelParseChunk(readSpec, currentIndex, parsedEdges);
+            parseTime += Statistics::GetTimestamp() - parseStartTime;
+            
+            const SEdge<TEdgeData>* const buf = readSpec->bufs[currentIndex];
+            const TEdgeCount count = readSpec->counts[currentIndex];
+            
+            // Writers record the vertex count in the file header before any edges are seen, so any edge that refers to a vertex beyond it is invalid.
+            // Each thread checks a separate part of the buffer.
+            for (TEdgeCount i = ((count * localThreadID) / localThreadCount); i < ((count * (localThreadID + 1)) / localThreadCount); ++i)
+            {
+                if ((buf[i].sourceVertex >= numVertices) || (buf[i].destinationVertex >= numVertices))
+                    numInvalidEdges += 1;
+            }
+            
+            const uint64_t writeStartTime = Statistics::GetTimestamp();
+            
+            for (size_t i = 0; i < readSpec->numWriters; ++i)
+                readSpec->writers[i]->WriteStreamedEdges((const void*)buf, (size_t)count);
+            
+            writeTime += Statistics::GetTimestamp() - writeStartTime;
+            
+            if (0 == localThreadID)
+                readSpec->numStreamedEdges += count;
+            
+            // Hand the buffer back to the edge producer and move on to the next one, which may already be filled.
+            ParallelReleaseBuffer(readSpec, sequence);
+            sequence += 1;
+        }
+        
+        // Writers have already recorded the counts in the file header, so the result is only valid if every edge is valid and the edge count matches.
+        readSpec->refreshDegreeBuf[localThreadID] = numInvalidEdges;
+        spindleBarrierLocal();
+        
+        if (0 == localThreadID)
+        {
+            for (uint32_t i = 0; i < localThreadCount; ++i)
+            {
+                if (0 != readSpec->refreshDegreeBuf[i])
+                    readSpec->readResult = EGraphResult::GraphResultErrorFormat;
+            }
+            
+            if (readSpec->reader->numEdgesInFile != readSpec->numStreamedEdges)
+                readSpec->readResult = EGraphResult::GraphResultErrorFormat;
+            
+            Statistics::AddPhaseCounts(0, (uint64_t)readSpec->numStreamedEdges);
+            Statistics::AddPhaseDetailTime("consumer stall", stallTime);
+            
+            if (NULL != readSpec->chunks[0])
+                Statistics::AddPhaseDetailTime("parse", parseTime);
+            
+            Statistics::AddPhaseDetailTime("write", writeTime);
+        }
+    }
+    
+    
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "GraphReader.h" for documentation.
+    
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::AllocateReadBuffers(std::vector<SEdge<TEdgeData>*>& bufs, std::vector<char*>& chunks) const
+    {
+        const bool allocateChunks = UsesParallelParsing();
+        
+        bufs.assign(numReadBuffers, NULL);
+        chunks.assign(numReadBuffers, NULL);
+        
+        for (uint32_t i = 0; i < numReadBuffers; ++i)
+        {
+            bufs[i] = (SEdge<TEdgeData>*)(new uint8_t[readBufferSize]);
+            
+            // Readers that parse in parallel also need buffers for raw file contents.
+            if (allocateChunks)
+                chunks[i] = new char[readBufferSize + kGraphReadChunkPadding];
+            
+            if ((NULL == bufs[i]) || (allocateChunks && (NULL == chunks[i])))
+            {
+                FreeReadBuffers(bufs, chunks);
+                return false;
+            }
+            
+            MemoryTracker::RecordAllocation(bufs[i], readBufferSize, MemoryTracker::MemoryCategoryReadBuffers);
+            MemoryTracker::RecordAllocation(chunks[i], readBufferSize + kGraphReadChunkPadding, MemoryTracker::MemoryCategoryReadBuffers);
+        }
+        
+        return true;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::CheckMemoryFootprint(const Graph& graph, bool& twoPass) const
+    {
+        const TVertexCount numVertices = GetNumVerticesForIngress();
+        const uint64_t bufferBytes = (uint64_t)numReadBuffers * (readBufferSize + (UsesParallelParsing() ? (readBufferSize + kGraphReadChunkPadding) : 0)) + (remapVertexIDs ? VertexIDMap::EstimateBytes(numVertices) : 0);
+        uint64_t estimatedBytes = bufferBytes + graph.EstimateIngressFootprint(numVertices, numEdgesInFile, twoPass);
+        
+        if (MemoryCheckOff == memoryCheck)
+        {
+            MemoryTracker::RecordEstimate(estimatedBytes, 0);
+            return true;
+        }
+        
+        // Available memory cannot be determined on every platform, in which case there is nothing to compare against.
+        const uint64_t availableBytes = MemoryTracker::GetAvailableMemory();
+        
+        if ((0 != availableBytes) && (estimatedBytes > availableBytes) && !twoPass && (MemoryCheckAuto == memoryCheck))
+        {
+            // Two-pass ingress never builds the mutable representation, which is several times larger than the compact one.
+            const uint64_t twoPassBytes = bufferBytes + graph.EstimateIngressFootprint(numVertices, numEdgesInFile, true);
+            
+            if (twoPassBytes <= availableBytes)
+            {
+                estimatedBytes = twoPassBytes;
+                twoPass = true;
+            }
+        }
+        
+        MemoryTracker::RecordEstimate(estimatedBytes, availableBytes);
+        return ((0 == availableBytes) || (estimatedBytes <= availableBytes));
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::CloseShards(std::vector<SGraphReadShard<TEdgeData>>& shards) const
+    {
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            if (NULL != shards[i].file)
+            {
+                fclose(shards[i].file);
+                shards[i].file = NULL;
+            }
+        }
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> EGraphResult GraphReader<TEdgeData>::CreateShards(const char* const filename, std::vector<SGraphReadShard<TEdgeData>>& shards)
+    {
+        std::vector<std::string> shardFilenames;
+        
+        if (!GraphReaderFactory::ExpandInputFilename(filename, shardFilenames))
+            return EGraphResult::GraphResultErrorCannotOpenFile;
+        
+        shards.assign(shardFilenames.size(), SGraphReadShard<TEdgeData>());
+        
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            shards[i].filename = shardFilenames[i];
+            shards[i].reader = ((1 == shards.size()) ? this : CreateShardReader());
+            shards[i].file = NULL;
+            
+            if (NULL == shards[i].reader)
+            {
+                shards.resize(i);
+                DestroyShards(shards);
+                return EGraphResult::GraphResultErrorUnknown;
+            }
+        }
+        
+        return EGraphResult::GraphResultSuccess;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::DestroyShards(std::vector<SGraphReadShard<TEdgeData>>& shards) const
+    {
+        CloseShards(shards);
+        
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            if (this != shards[i].reader)
+                delete shards[i].reader;
+        }
+        
+        shards.clear();
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> TVertexCount GraphReader<TEdgeData>::GetNumVerticesForIngress(void) const
+    {
+        if (!remapVertexIDs)
+            return numVerticesInFile;
+        
+        const TVertexCount maxDistinctVertices = (TVertexCount)(numEdgesInFile << 1);
+        return ((numVerticesInFile < maxDistinctVertices) ? numVerticesInFile : maxDistinctVertices);
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> EGraphResult GraphReader<TEdgeData>::OpenShards(std::vector<SGraphReadShard<TEdgeData>>& shards)
+    {
+        // A graph held in a single file is opened by this thread, exactly as if it were not split at all.
+        if (1 == shards.size())
+        {
+            shards[0].file = shards[0].reader->OpenAndInitializeGraphFileForRead(shards[0].filename.c_str());
+            return ((NULL == shards[0].file) ? EGraphResult::GraphResultErrorCannotOpenFile : EGraphResult::GraphResultSuccess);
+        }
+        
+        // Reading the header of a shard can involve scanning all of it, so shards are opened concurrently, up to the same limit as when they are read.
+        const uint32_t numOpenThreads = ((shards.size() < (size_t)numShardThreads) ? (uint32_t)shards.size() : numShardThreads);
+        std::atomic<size_t> nextShard(0);
+        std::vector<std::thread> openThreads;
+        
+        for (uint32_t i = 0; i < numOpenThreads; ++i)
+            openThreads.push_back(std::thread(&ShardOpenWorker, &shards, &nextShard));
+        
+        for (size_t i = 0; i < openThreads.size(); ++i)
+            openThreads[i].join();
+        
+        numVerticesInFile = 0;
+        numEdgesInFile = 0;
+        
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            if (NULL == shards[i].file)
+            {
+                CloseShards(shards);
+                return EGraphResult::GraphResultErrorCannotOpenFile;
+            }
+            
+            if (shards[i].reader->numVerticesInFile > numVerticesInFile)
+                numVerticesInFile = shards[i].reader->numVerticesInFile;
+            
+            numEdgesInFile += shards[i].reader->numEdgesInFile;
+        }
+        
+        return EGraphResult::GraphResultSuccess;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> EGraphResult GraphReader<TEdgeData>::RunReadPass(const std::vector<SGraphReadShard<TEdgeData>>& shards, Graph& graph, const std::vector<SEdge<TEdgeData>*>& bufs, const std::vector<char*>& chunks, void (*consumer)(void*), IGraphWriter* const* writers, const size_t numWriters)
+    {
+        // Define the graph read task.
+        // The edge producer threads share the ring, each filling different buffers, and the consumer threads form a single consumer of it, since they work through each buffer together.
+        BufferRing ring((uint32_t)bufs.size(), 1);
+        SGraphReadSpec<TEdgeData> readSpec;
+
+        readSpec.shards = &shards;
+        readSpec.nextShard.store(0);
+        readSpec.nextSequence.store(0);
+        readSpec.numProducers = ((shards.size() < (size_t)numShardThreads) ? (uint32_t)shards.size() : numShardThreads);
+        readSpec.graph = &graph;
+        readSpec.reader = this;
+        readSpec.ring = &ring;
+        readSpec.bufs = bufs;
+        readSpec.chunks = chunks;
+        readSpec.chunkReaders.assign(bufs.size(), this);
+        readSpec.counts.assign(bufs.size(), 0);
+        readSpec.bufSize = readBufferSize;
+        readSpec.bufCapacity = (TEdgeCount)(readBufferSize / sizeof(SEdge<TEdgeData>));
+        readSpec.numVertices = GetNumVerticesForIngress();
+        readSpec.partitionedEdges[0] = NULL;
+        readSpec.partitionedEdges[1] = NULL;
+        readSpec.partitionOffsets[0] = NULL;
+        readSpec.partitionOffsets[1] = NULL;
+        readSpec.parseOffsets = NULL;
+        readSpec.refreshDegreeBuf = NULL;
+        readSpec.writers = writers;
+        readSpec.numWriters = numWriters;
+        readSpec.numStreamedEdges = 0;
+        // Remapping rewrites the vertex identifiers in each edge buffer, so edges cannot be consumed directly from a read-only mapping of the file.
+        // Edge buffers that point into a mapping cannot later be filled by reading, so edges are consumed in place only if every shard can be mapped.
+        size_t numMappedShards = 0;
+        
+        if ((NULL == chunks[0]) && !remapVertexIDs)
+        {
+            while ((numMappedShards < shards.size()) && shards[numMappedShards].reader->MapEdgesForRead(shards[numMappedShards].file))
+                numMappedShards += 1;
+        }
+        
+        readSpec.readsInPlace = ((0 != numMappedShards) && (shards.size() == numMappedShards));
+        readSpec.numaNode = siloGetNUMANodeForVirtualAddress(bufs[0]);
+        readSpec.readResult = EGraphResult::GraphResultSuccess;
+
+        // Define the parallelization strategy.
+        SSpindleTaskSpec taskSpec[2];
+
+        taskSpec[0].func = &EdgeProducer;
+        taskSpec[0].arg = (void*)&readSpec;
+        taskSpec[0].numaNode = readSpec.numaNode;
+        taskSpec[0].numThreads = readSpec.numProducers;
+        taskSpec[0].smtPolicy = SpindleSMTPolicyPreferLogical;
+
+        taskSpec[1].func = consumer;
+        taskSpec[1].arg = (void*)&readSpec;
+        taskSpec[1].numaNode = readSpec.numaNode;
+        taskSpec[1].numThreads = numConsumerThreads;
+        taskSpec[1].smtPolicy = SpindleSMTPolicyPreferLogical;
+
+        // Launch the graph read task.
+        const EGraphResult spawnResult = NUMASpawner::SpawnTasks(taskSpec, sizeof(taskSpec) / sizeof(taskSpec[0]));
+        
+        // Clean up.
+        for (uint32_t direction = 0; direction < 2; ++direction)
+        {
+            if (NULL != readSpec.partitionedEdges[direction])
+                delete[] readSpec.partitionedEdges[direction];
+            
+            if (NULL != readSpec.partitionOffsets[direction])
+                delete[] readSpec.partitionOffsets[direction];
+        }
+        
+        for (size_t i = 0; i < numMappedShards; ++i)
+            shards[i].reader->UnmapEdgesForRead();
+        
+        if (NULL != readSpec.parseOffsets)
+            delete[] readSpec.parseOffsets;
+        
+        if (NULL != readSpec.refreshDegreeBuf)
+            delete[] readSpec.refreshDegreeBuf;
+        
+        if (EGraphResult::GraphResultSuccess != spawnResult)
+            return spawnResult;
+        
+        return readSpec.readResult;
+    }
+    
+    
+    // --------
+    
+    template <typename TEdgeData> FILE* GraphReader<TEdgeData>::OpenGraphFileForRead(const char* const filename, const bool textMode) const
+    {
+        if (DecompressedFile::IsSupported() && DecompressedFile::IsCompressed(filename))
+            return DecompressedFile::OpenForRead(filename, numDecompressionThreads);
+        
+        if (textMode)
+            return fopen(filename, "r");
+        
+        if (useDirectIO)
+            return DirectFile::OpenForRead(filename, directIOQueueDepth);
+        
+        return fopen(filename, "rb");
+    }
+    
+    
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "GraphReader.h" for documentation.
+    
+    template <typename TEdgeData> GraphReader<TEdgeData>* GraphReader<TEdgeData>::CreateShardReader(void) const
+    {
+        return NULL;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::IsEdgeCountExact(void) const
+    {
+        return true;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::MapEdgesForRead(FILE* const graphfile)
+    {
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::ParseEdgesFromChunk(const char* const chunk, const size_t chunkSize, const size_t rangeStart, const size_t rangeEnd, std::vector<SEdge<TEdgeData>>& edges) const
+    {
+        // Nothing to do here.
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> size_t GraphReader<TEdgeData>::ReadChunkToBuffer(FILE* const graphfile, char* const buf, const size_t size, const TEdgeCount maxEdges)
+    {
+        return 0;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> TEdgeCount GraphReader<TEdgeData>::ReadEdgesInPlace(const SEdge<TEdgeData>*& edges, const size_t count)
+    {
+        return 0;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::SupportsDirectIO(void) const
+    {
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphReader<TEdgeData>::UnmapEdgesForRead(void)
+    {
+        // Nothing to do here.
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::UsesParallelParsing(void) const
+    {
+        return false;
+    }
+    
+    
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphReader.h" for documentation.
+
+    template <typename TEdgeData> EGraphResult GraphReader<TEdgeData>::ReadGraphFromFile(const char* const filename, Graph& graph)
+    {
+        // First, open the file, or all of the files if the graph is split across several.
+        std::vector<SGraphReadShard<TEdgeData>> shards;
+        EGraphResult shardResult = CreateShards(filename, shards);
+        
+        if (EGraphResult::GraphResultSuccess == shardResult)
+            shardResult = OpenShards(shards);
+        
+        if (EGraphResult::GraphResultSuccess != shardResult)
+        {
+            DestroyShards(shards);
+            return shardResult;
+        }
+        
+        // Make sure the graph is expected to fit in memory before allocating anything, possibly switching to the more compact ingress strategy.
+        graph.SetEdgeDataType<TEdgeData>();
+        bool twoPass = useTwoPassIngress;
+        
+        if (!CheckMemoryFootprint(graph, twoPass))
+        {
+            DestroyShards(shards);
+            return EGraphResult::GraphResultErrorNoMemory;
+        }
+        
+        // Initialize some graph metadata fields.
+        // Two-pass ingress sizes the graph itself once degrees are known.
+        if (!twoPass)
+            graph.SetNumVertices(GetNumVerticesForIngress());
+        
+        // Allocate some buffers for read data, along with the map that assigns dense vertex identifiers if requested.
+        // The map is kept across both passes of two-pass ingress, so that each vertex receives the same dense identifier in both.
+        std::vector<SEdge<TEdgeData>*> bufs;
+        std::vector<char*> chunks;
+        
+        if (remapVertexIDs && !vertexIDMap.Allocate(GetNumVerticesForIngress()))
+        {
+            DestroyShards(shards);
+            return EGraphResult::GraphResultErrorNoMemory;
+        }
+        
+        if (!AllocateReadBuffers(bufs, chunks))
+        {
+            vertexIDMap.Release();
+            DestroyShards(shards);
+            return EGraphResult::GraphResultErrorNoMemory;
+        }
+        
+        // Read the graph, either incrementally in a single pass or in two passes with the files reopened for the second.
+        EGraphResult readResult;
+        
+        if (twoPass)
+        {
+            readResult = RunReadPass(shards, graph, bufs, chunks, &DegreeCountConsumer, NULL, 0);
+            CloseShards(shards);
+            
+            if (EGraphResult::GraphResultSuccess == readResult)
+            {
+                readResult = OpenShards(shards);
+                
+                if (EGraphResult::GraphResultSuccess == readResult)
+                {
+                    readResult = RunReadPass(shards, graph, bufs, chunks, &EdgeScatterConsumer, NULL, 0);
+                    CloseShards(shards);
+                }
+            }
+        }
+        else
+        {
+            readResult = RunReadPass(shards, graph, bufs, chunks, &EdgeConsumer, NULL, 0);
+            CloseShards(shards);
+        }
+        
+        // Clean up.
+        FreeReadBuffers(bufs, chunks);
+        
+        // Incremental ingress set aside storage for as many vertices as there could be, so trim the graph to the dense identifiers actually assigned, and record the mapping if requested.
+        if (remapVertexIDs)
+        {
+            if ((EGraphResult::GraphResultSuccess == readResult) && vertexIDMap.HasOverflowed())
+                readResult = EGraphResult::GraphResultErrorFormat;
+            
+            if ((EGraphResult::GraphResultSuccess == readResult) && !twoPass)
+                graph.SetNumVertices(vertexIDMap.GetNumIDs());
+            
+            if ((EGraphResult::GraphResultSuccess == readResult) && !(vertexIDMapFile.empty()))
+                readResult = vertexIDMap.WriteToFile(vertexIDMapFile.c_str());
+            
+            vertexIDMap.Release();
+        }
+        
+        // Consistency checks.
+        const bool edgeCountExact = AreShardEdgeCountsExact(shards);
+        DestroyShards(shards);
+        
+        if (EGraphResult::GraphResultSuccess == readResult)
+        {
+            if (edgeCountExact && (numEdgesInFile != graph.GetNumEdges()))
+                return EGraphResult::GraphResultErrorFormat;
+            else
+                return EGraphResult::GraphResultSuccess;
+        }
+        else
+            return readResult;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphReader<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if (0 == strcmp(optionName, kReaderOptionIngress))
+        {
+            if (0 == strcmp(optionValue, kReaderOptionIngressIncremental))
+                useTwoPassIngress = false;
+            else if (0 == strcmp(optionValue, kReaderOptionIngressTwoPass))
+                useTwoPassIngress = true;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kReaderOptionMemoryCheck))
+        {
+            if (0 == strcmp(optionValue, kReaderOptionMemoryCheckAuto))
+                memoryCheck = MemoryCheckAuto;
+            else if (0 == strcmp(optionValue, kReaderOptionMemoryCheckStrict))
+                memoryCheck = MemoryCheckStrict;
+            else if (0 == strcmp(optionValue, kReaderOptionMemoryCheckOff))
+                memoryCheck = MemoryCheckOff;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        if ((0 == strcmp(optionName, kReaderOptionIO)) && SupportsDirectIO() && DirectFile::IsSupported())
+        {
+            if (0 == strcmp(optionValue, kReaderOptionIOBuffered))
+                useDirectIO = false;
+            else if (0 == strcmp(optionValue, kReaderOptionIODirect))
+                useDirectIO = true;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        if ((0 == strcmp(optionName, kReaderOptionIODepth)) && SupportsDirectIO() && DirectFile::IsSupported())
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, DirectFile::kMaxQueueDepth, value))
+                return false;
+            
+            directIOQueueDepth = (uint32_t)value;
+            return true;
+        }
+        
+        if ((0 == strcmp(optionName, kReaderOptionDecompressThreads)) && DecompressedFile::IsSupported())
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, DecompressedFile::kMaxNumThreads, value))
+                return false;
+            
+            numDecompressionThreads = (uint32_t)value;
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kReaderOptionBuffers))
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, BufferRing::kMaxDepth, value))
+                return false;
+            
+            numReadBuffers = (uint32_t)value;
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kReaderOptionBufferSize))
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, (kGraphReadBufferSizeMax >> 20), value))
+                return false;
+            
+            readBufferSize = (size_t)(value << 20);
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kReaderOptionThreads))
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, UINT32_MAX, value))
+                return false;
+            
+            numConsumerThreads = (uint32_t)value;
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kReaderOptionShardThreads))
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, kGraphReadShardThreadsMax, value))
+                return false;
+            
+            numShardThreads = (uint32_t)value;
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kReaderOptionIDs))
+        {
+            if (0 == strcmp(optionValue, kReaderOptionIDsKeep))
+                remapVertexIDs = false;
+            else if (0 == strcmp(optionValue, kReaderOptionIDsRemap))
+                remapVertexIDs = true;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kReaderOptionIDMap))
+        {
+            if ('\0' == optionValue[0])
+                return false;
+            
+            vertexIDMapFile = optionValue;
+            remapVertexIDs = true;
+            return true;
+        }
+        
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> EGraphResult GraphReader<TEdgeData>::StreamGraphToWriters(const char* const filename, IGraphWriter* const* writers, const char* const* outputFilenames, const size_t numWriters)
+    {
+        // First, open the file, or all of the files if the graph is split across several.
+        std::vector<SGraphReadShard<TEdgeData>> shards;
+        EGraphResult shardResult = CreateShards(filename, shards);
+        
+        if (EGraphResult::GraphResultSuccess == shardResult)
+            shardResult = OpenShards(shards);
+        
+        if (EGraphResult::GraphResultSuccess != shardResult)
+        {
+            DestroyShards(shards);
+            return shardResult;
+        }
+        
+        // Writers record the edge count before any edges are seen, so it must be exact.
+        // They likewise record the vertex count, which is unknown until every edge has been seen if vertex identifiers are remapped.
+        if (!AreShardEdgeCountsExact(shards) || remapVertexIDs)
+        {
+            DestroyShards(shards);
+            return EGraphResult::GraphResultErrorFormat;
+        }
+        
+        // Edges are never placed into this graph, which only tells the writers what type of edge data is being streamed.
+        Graph graph;
+        graph.SetEdgeDataType<TEdgeData>();
+        
+        // Open all of the output files, which record the counts given by the input file.
+        for (size_t i = 0; i < numWriters; ++i)
+        {
+            const EGraphResult beginResult = writers[i]->BeginStreamedWrite(outputFilenames[i], graph, numVerticesInFile, numEdgesInFile);
+            
+            if (EGraphResult::GraphResultSuccess != beginResult)
+            {
+                for (size_t j = 0; j < i; ++j)
+                    writers[j]->EndStreamedWrite();
+                
+                DestroyShards(shards);
+                return beginResult;
+            }
+        }
+        
+        // Allocate some buffers for read data.
+        std::vector<SEdge<TEdgeData>*> bufs;
+        std::vector<char*> chunks;
+        
+        if (!AllocateReadBuffers(bufs, chunks))
+        {
+            for (size_t i = 0; i < numWriters; ++i)
+                writers[i]->EndStreamedWrite();
+            
+            DestroyShards(shards);
+            return EGraphResult::GraphResultErrorNoMemory;
+        }
+        
+        // Stream the edges in a single pass, regardless of the ingress strategy, since no storage is allocated for them.
+        EGraphResult streamResult = RunReadPass(shards, graph, bufs, chunks, &StreamConsumer, writers, numWriters);
+        DestroyShards(shards);
+        
+        // Read buffers are released before the writers finish, since some writers do most of their work then.
+        FreeReadBuffers(bufs, chunks);
+        
+        // Close all of the output files, reporting the first writer error if reading succeeded.
+        for (size_t i = 0; i < numWriters; ++i)
+        {
+            const EGraphResult endResult = writers[i]->EndStreamedWrite();
+            
+            if (EGraphResult::GraphResultSuccess == streamResult)
+                streamResult = endResult;
+        }
+        
+        return streamResult;
     }
 
 
@@ -248,4 +1641,6 @@ namespace GraphTool
     template class GraphReader<void>;
     template class GraphReader<uint64_t>;
     template class GraphReader<double>;
+    template class GraphReader<uint32_t>;
+    template class GraphReader<float>;
 }
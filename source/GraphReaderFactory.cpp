@@ -11,15 +11,32 @@
  *****************************************************************************/
 
 #include "BinaryEdgeListReader.h"
+#include "CompressedAdjacencyListReader.h"
 #include "GraphReaderFactory.h"
+#include "GraphSnapshotReader.h"
 #include "IGraphReader.h"
+#include "MatrixMarketReader.h"
+#include "SNAPEdgeListReader.h"
+#include "SyntheticGraphReader.h"
 #include "TextEdgeListReader.h"
 #include "Types.h"
+#include "VersionInfo.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <map>
 #include <string>
+#include <vector>
+
+#ifdef __PLATFORM_LINUX
+#include <dirent.h>
+#include <glob.h>
+#include <sys/stat.h>
+#endif
 
 
 namespace GraphTool
@@ -35,6 +52,28 @@ namespace GraphTool
         { "grazelle",                                                       EGraphReaderType::GraphReaderTypeBinaryEdgeList },
         { "Grazelle",                                                       EGraphReaderType::GraphReaderTypeBinaryEdgeList },
 
+        { "compressedadjacencylist",                                        EGraphReaderType::GraphReaderTypeCompressedAdjacencyList },
+        { "compressedAdjacencyList",                                        EGraphReaderType::GraphReaderTypeCompressedAdjacencyList },
+        { "CompressedAdjacencyList",                                        EGraphReaderType::GraphReaderTypeCompressedAdjacencyList },
+
+        { "compressed",                                                     EGraphReaderType::GraphReaderTypeCompressedAdjacencyList },
+        { "Compressed",                                                     EGraphReaderType::GraphReaderTypeCompressedAdjacencyList },
+
+        { "matrixmarket",                                                   EGraphReaderType::GraphReaderTypeMatrixMarket },
+        { "matrixMarket",                                                   EGraphReaderType::GraphReaderTypeMatrixMarket },
+        { "MatrixMarket",                                                   EGraphReaderType::GraphReaderTypeMatrixMarket },
+
+        { "mtx",                                                            EGraphReaderType::GraphReaderTypeMatrixMarket },
+
+        { "snap",                                                           EGraphReaderType::GraphReaderTypeSNAP },
+        { "SNAP",                                                           EGraphReaderType::GraphReaderTypeSNAP },
+
+        { "snapshot",                                                       EGraphReaderType::GraphReaderTypeSnapshot },
+        { "Snapshot",                                                       EGraphReaderType::GraphReaderTypeSnapshot },
+
+        { "synthetic",                                                      EGraphReaderType::GraphReaderTypeSynthetic },
+        { "Synthetic",                                                      EGraphReaderType::GraphReaderTypeSynthetic },
+
         { "textedgelist",                                                   EGraphReaderType::GraphReaderTypeTextEdgeList },
         { "textEdgeList",                                                   EGraphReaderType::GraphReaderTypeTextEdgeList },
         { "TextEdgeList",                                                   EGraphReaderType::GraphReaderTypeTextEdgeList },
@@ -61,6 +100,26 @@ namespace GraphTool
             result = new TextEdgeListReader<TEdgeData>;
             break;
 
+        case EGraphReaderType::GraphReaderTypeCompressedAdjacencyList:
+            result = new CompressedAdjacencyListReader<TEdgeData>;
+            break;
+
+        case EGraphReaderType::GraphReaderTypeSynthetic:
+            result = new SyntheticGraphReader<TEdgeData>;
+            break;
+
+        case EGraphReaderType::GraphReaderTypeSnapshot:
+            result = new GraphSnapshotReader<TEdgeData>;
+            break;
+
+        case EGraphReaderType::GraphReaderTypeMatrixMarket:
+            result = new MatrixMarketReader<TEdgeData>;
+            break;
+
+        case EGraphReaderType::GraphReaderTypeSNAP:
+            result = new SNAPEdgeListReader<TEdgeData>;
+            break;
+
         default:
             break;
         }
@@ -89,6 +148,14 @@ namespace GraphTool
             result = CreateGraphReaderInternal<double>(type);
             break;
             
+        case EEdgeDataType::EdgeDataTypeInteger32:
+            result = CreateGraphReaderInternal<uint32_t>(type);
+            break;
+            
+        case EEdgeDataType::EdgeDataTypeFloatingPoint32:
+            result = CreateGraphReaderInternal<float>(type);
+            break;
+            
         default:
             break;
         }
@@ -98,6 +165,90 @@ namespace GraphTool
 
     // --------
 
+    bool GraphReaderFactory::ExpandInputFilename(const char* const filename, std::vector<std::string>& filenames)
+    {
+        filenames.clear();
+        
+        if ('@' == filename[0])
+        {
+            FILE* const listfile = fopen(&filename[1], "r");
+            if (NULL == listfile)
+                return false;
+            
+            std::string line;
+            int nextChar;
+            
+            do
+            {
+                nextChar = getc(listfile);
+                
+                if (('\n' == nextChar) || (EOF == nextChar))
+                {
+                    while (!(line.empty()) && isspace((unsigned char)line.back()))
+                        line.pop_back();
+                    
+                    if (!(line.empty()) && ('#' != line[0]))
+                        filenames.push_back(line);
+                    
+                    line.clear();
+                }
+                else
+                {
+                    line.push_back((char)nextChar);
+                }
+            } while (EOF != nextChar);
+            
+            const bool listReadFailed = (0 != ferror(listfile));
+            fclose(listfile);
+            return (!listReadFailed && !(filenames.empty()));
+        }
+        
+#ifdef __PLATFORM_LINUX
+        struct stat fileInfo;
+        
+        if ((0 == stat(filename, &fileInfo)) && S_ISDIR(fileInfo.st_mode))
+        {
+            DIR* const directory = opendir(filename);
+            if (NULL == directory)
+                return false;
+            
+            for (struct dirent* entry = readdir(directory); NULL != entry; entry = readdir(directory))
+            {
+                if (('.' == entry->d_name[0]) || ('_' == entry->d_name[0]))
+                    continue;
+                
+                const std::string entryFilename = std::string(filename) + "/" + entry->d_name;
+                
+                if ((0 == stat(entryFilename.c_str(), &fileInfo)) && S_ISREG(fileInfo.st_mode))
+                    filenames.push_back(entryFilename);
+            }
+            
+            closedir(directory);
+            std::sort(filenames.begin(), filenames.end());
+            return !(filenames.empty());
+        }
+        
+        if (NULL != strpbrk(filename, "*?["))
+        {
+            glob_t globResult;
+            
+            if (0 == glob(filename, 0, NULL, &globResult))
+            {
+                for (size_t i = 0; i < globResult.gl_pathc; ++i)
+                    filenames.push_back(globResult.gl_pathv[i]);
+                
+                globfree(&globResult);
+                return true;
+            }
+        }
+#endif
+        
+        filenames.push_back(filename);
+        return true;
+    }
+
+    // --------
+
     const std::map<std::string, int64_t>* GraphReaderFactory::GetGraphReaderStrings(void)
     {
         return &graphReaderStrings;
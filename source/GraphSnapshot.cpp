@@ -0,0 +1,343 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GraphSnapshot.cpp
+ *   Implementation of reading and writing snapshot files, which hold a
+ *   frozen graph in its internal layout.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "GraphSnapshot.h"
+#include "Types.h"
+#include "VersionInfo.h"
+#include "VertexIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Source of the zero bytes written to pad each array to its aligned position.
+    static const uint8_t kPaddingBytes[4096] = {};
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Rounds a position up to the specified alignment.
+    /// @param [in] position Position to round.
+    /// @param [in] alignment Alignment, which must be a power of two.
+    /// @return Aligned position.
+    static inline uint64_t AlignPosition(const uint64_t position, const uint64_t alignment)
+    {
+        return (position + (alignment - 1)) & ~(alignment - 1);
+    }
+
+    /// Fills in the description of a frozen vertex index and determines where its section is placed in the file.
+    /// @param [in] index Vertex index to describe, which must be frozen.
+    /// @param [in] sectionOffset Position of the section within the file.
+    /// @param [out] indexHeader Description of the vertex index.
+    static void DescribeIndex(const VertexIndex& index, const uint64_t sectionOffset, SGraphSnapshotIndexHeader& indexHeader)
+    {
+        const bool neighborsCompact = (NULL != index.GetFrozenNeighborsCompact());
+        const uint64_t neighborSize = (neighborsCompact ? sizeof(TCompactVertexID) : sizeof(TVertexID));
+
+        memset((void*)&indexHeader, 0, sizeof(indexHeader));
+        indexHeader.numVertices = (uint64_t)index.GetNumVertices();
+        indexHeader.numEdges = (uint64_t)index.GetFrozenOffsets()[index.GetNumVertices()];
+        indexHeader.numVerticesPresent = (uint64_t)index.GetNumVerticesPresent();
+        indexHeader.numVectors = index.GetNumVectors();
+        indexHeader.sectionOffset = sectionOffset;
+        indexHeader.neighborsOffset = AlignPosition(sizeof(TEdgeCount) * (indexHeader.numVertices + 1), GraphSnapshot::kArrayAlignment);
+        indexHeader.sectionSize = indexHeader.neighborsOffset + (neighborSize * indexHeader.numEdges);
+
+        if (NULL != index.GetFrozenEdgeData())
+        {
+            indexHeader.edgeDataOffset = AlignPosition(indexHeader.sectionSize, GraphSnapshot::kArrayAlignment);
+            indexHeader.sectionSize = indexHeader.edgeDataOffset + (sizeof(UEdgeData) * indexHeader.numEdges);
+        }
+
+        indexHeader.flags = (neighborsCompact ? GraphSnapshot::kIndexFlagNeighborsCompact : 0) | (index.IsFrozenSorted() ? GraphSnapshot::kIndexFlagSorted : 0);
+    }
+
+    /// Writes zero bytes to a file until it reaches the specified position.
+    /// @param [in] file File to which to write.
+    /// @param [in,out] position Current position within the file, updated to the target position.
+    /// @param [in] targetPosition Position to reach, which must not be less than the current position.
+    /// @return `true` if successful, `false` otherwise.
+    static bool WritePadding(FILE* const file, uint64_t& position, const uint64_t targetPosition)
+    {
+        while (position < targetPosition)
+        {
+            const size_t paddingSize = (size_t)(((targetPosition - position) < sizeof(kPaddingBytes)) ? (targetPosition - position) : sizeof(kPaddingBytes));
+
+            if (paddingSize != fwrite((const void*)kPaddingBytes, 1, paddingSize, file))
+                return false;
+
+            position += paddingSize;
+        }
+
+        return true;
+    }
+
+    /// Writes an array to a file at the specified position, first padding the file up to that position.
+    /// @param [in] file File to which to write.
+    /// @param [in,out] position Current position within the file, updated to the position just past the array.
+    /// @param [in] targetPosition Position at which the array begins.
+    /// @param [in] data Array to write.
+    /// @param [in] size Size of the array, in bytes.
+    /// @return `true` if successful, `false` otherwise.
+    static bool WriteArray(FILE* const file, uint64_t& position, const uint64_t targetPosition, const void* const data, const uint64_t size)
+    {
+        if (!WritePadding(file, position, targetPosition))
+            return false;
+
+        if ((0 != size) && (1 != fwrite(data, (size_t)size, 1, file)))
+            return false;
+
+        position += size;
+        return true;
+    }
+
+    /// Writes the section that holds a frozen vertex index, first padding the file up to the start of the section.
+    /// @param [in] file File to which to write.
+    /// @param [in,out] position Current position within the file, updated to the position just past the section.
+    /// @param [in] index Vertex index to write.
+    /// @param [in] indexHeader Description of the vertex index, as filled in by DescribeIndex.
+    /// @return `true` if successful, `false` otherwise.
+    static bool WriteIndexSection(FILE* const file, uint64_t& position, const VertexIndex& index, const SGraphSnapshotIndexHeader& indexHeader)
+    {
+        const bool neighborsCompact = (0 != (indexHeader.flags & GraphSnapshot::kIndexFlagNeighborsCompact));
+        const void* const neighbors = (neighborsCompact ? (const void*)index.GetFrozenNeighborsCompact() : (const void*)index.GetFrozenNeighbors());
+        const uint64_t neighborSize = (neighborsCompact ? sizeof(TCompactVertexID) : sizeof(TVertexID));
+
+        if (!WriteArray(file, position, indexHeader.sectionOffset, (const void*)index.GetFrozenOffsets(), sizeof(TEdgeCount) * (indexHeader.numVertices + 1)))
+            return false;
+
+        if (!WriteArray(file, position, indexHeader.sectionOffset + indexHeader.neighborsOffset, neighbors, neighborSize * indexHeader.numEdges))
+            return false;
+
+        if ((0 != indexHeader.edgeDataOffset) && !WriteArray(file, position, indexHeader.sectionOffset + indexHeader.edgeDataOffset, (const void*)index.GetFrozenEdgeData(), sizeof(UEdgeData) * indexHeader.numEdges))
+            return false;
+
+        return true;
+    }
+
+#ifdef __PLATFORM_LINUX
+    /// Holds the frozen arrays of one vertex index mapped from a snapshot file.
+    struct SMappedIndex
+    {
+        void* mapping;                                                      ///< Start of the mapped section.
+        size_t mappingSize;                                                 ///< Size of the mapped section, in bytes.
+        TEdgeCount* offsets;                                                ///< Frozen offset array, within the mapped section.
+        void* neighbors;                                                    ///< Frozen neighbor array, within the mapped section.
+        UEdgeData* edgeData;                                                ///< Frozen edge data array, within the mapped section, or `NULL` if there are no edge data.
+    };
+
+    /// Verifies that the description of a vertex index is consistent with itself and with the file that holds it, and then maps its section.
+    /// Only the layout is verified, along with the offsets of the first and last vertices, so that mapping takes constant time regardless of the size of the graph.
+    /// @param [in] fd File descriptor of the snapshot file.
+    /// @param [in] fileSize Size of the snapshot file, in bytes.
+    /// @param [in] indexHeader Description of the vertex index.
+    /// @param [in] keepEdgeData Specifies that the vertex index must hold edge data.
+    /// @param [out] mappedIndex Frozen arrays of the mapped vertex index.
+    /// @return Result of the operation.
+    static EGraphResult MapIndexSection(const int fd, const uint64_t fileSize, const SGraphSnapshotIndexHeader& indexHeader, const bool keepEdgeData, SMappedIndex& mappedIndex)
+    {
+        const bool neighborsCompact = (0 != (indexHeader.flags & GraphSnapshot::kIndexFlagNeighborsCompact));
+        const uint64_t neighborSize = (neighborsCompact ? sizeof(TCompactVertexID) : sizeof(TVertexID));
+
+        // Sizes are compared by division where a product could overflow.
+        if ((0 != (indexHeader.sectionOffset % GraphSnapshot::kSectionAlignment)) || (indexHeader.sectionOffset > fileSize) || (indexHeader.sectionSize > (fileSize - indexHeader.sectionOffset)))
+            return EGraphResult::GraphResultErrorFormat;
+
+        if ((0 != indexHeader.reserved) || (indexHeader.numVertices >= (indexHeader.sectionSize / sizeof(TEdgeCount))) || (indexHeader.neighborsOffset < (sizeof(TEdgeCount) * (indexHeader.numVertices + 1))))
+            return EGraphResult::GraphResultErrorFormat;
+
+        const uint64_t neighborsEnd = ((0 != indexHeader.edgeDataOffset) ? indexHeader.edgeDataOffset : indexHeader.sectionSize);
+
+        if ((0 != (indexHeader.neighborsOffset % GraphSnapshot::kArrayAlignment)) || (indexHeader.neighborsOffset > neighborsEnd) || (indexHeader.numEdges > ((neighborsEnd - indexHeader.neighborsOffset) / neighborSize)))
+            return EGraphResult::GraphResultErrorFormat;
+
+        if (keepEdgeData != (0 != indexHeader.edgeDataOffset))
+            return EGraphResult::GraphResultErrorFormat;
+
+        if (keepEdgeData && ((0 != (indexHeader.edgeDataOffset % GraphSnapshot::kArrayAlignment)) || (indexHeader.edgeDataOffset > indexHeader.sectionSize) || (indexHeader.numEdges > ((indexHeader.sectionSize - indexHeader.edgeDataOffset) / sizeof(UEdgeData)))))
+            return EGraphResult::GraphResultErrorFormat;
+
+        // Private pages are copied only when written, so transformations that modify the graph in place leave the file untouched.
+        void* const mapping = mmap(NULL, (size_t)indexHeader.sectionSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t)indexHeader.sectionOffset);
+
+        if (MAP_FAILED == mapping)
+            return EGraphResult::GraphResultErrorNoMemory;
+
+        mappedIndex.mapping = mapping;
+        mappedIndex.mappingSize = (size_t)indexHeader.sectionSize;
+        mappedIndex.offsets = (TEdgeCount*)mapping;
+        mappedIndex.neighbors = (void*)((uint8_t*)mapping + indexHeader.neighborsOffset);
+        mappedIndex.edgeData = (keepEdgeData ? (UEdgeData*)((uint8_t*)mapping + indexHeader.edgeDataOffset) : NULL);
+
+        if ((0 != mappedIndex.offsets[0]) || ((TEdgeCount)indexHeader.numEdges != mappedIndex.offsets[indexHeader.numVertices]))
+        {
+            munmap(mapping, mappedIndex.mappingSize);
+            return EGraphResult::GraphResultErrorFormat;
+        }
+
+        return EGraphResult::GraphResultSuccess;
+    }
+#endif
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "GraphSnapshot.h" for documentation.
+
+    EGraphResult GraphSnapshot::ReadGraphFromFile(const char* const filename, Graph& graph)
+    {
+#ifdef __PLATFORM_LINUX
+        const int fd = open(filename, O_RDONLY);
+
+        if (fd < 0)
+            return EGraphResult::GraphResultErrorCannotOpenFile;
+
+        struct stat fileStat;
+        SGraphSnapshotFileHeader fileHeader;
+
+        if ((0 != fstat(fd, &fileStat)) || (sizeof(fileHeader) != pread(fd, (void*)&fileHeader, sizeof(fileHeader), 0)))
+        {
+            close(fd);
+            return EGraphResult::GraphResultErrorIO;
+        }
+
+        if ((kFileMagic != fileHeader.magic) || (kFileVersion != fileHeader.version) || (kSectionAlignment != fileHeader.sectionAlignment) || ((uint32_t)graph.GetEdgeDataType() != fileHeader.edgeDataType))
+        {
+            close(fd);
+            return EGraphResult::GraphResultErrorFormat;
+        }
+
+        // Map only the groupings the graph maintains, or else whichever grouping the snapshot holds, from which any other grouping can be built later.
+        const bool hasEdgesBySource = (0 != (fileHeader.flags & kFileFlagHasEdgesBySource));
+        const bool hasEdgesByDestination = (0 != (fileHeader.flags & kFileFlagHasEdgesByDestination));
+        bool mapEdgesBySource = (graph.HasEdgesBySource() && hasEdgesBySource);
+        bool mapEdgesByDestination = (graph.HasEdgesByDestination() && hasEdgesByDestination);
+
+        if (!mapEdgesBySource && !mapEdgesByDestination)
+        {
+            mapEdgesBySource = hasEdgesBySource;
+            mapEdgesByDestination = (!hasEdgesBySource && hasEdgesByDestination);
+        }
+
+        if (!mapEdgesBySource && !mapEdgesByDestination)
+        {
+            close(fd);
+            return EGraphResult::GraphResultErrorFormat;
+        }
+
+        const bool keepEdgeData = (EEdgeDataType::EdgeDataTypeVoid != graph.GetEdgeDataType());
+        SMappedIndex mappedBySource = {};
+        SMappedIndex mappedByDestination = {};
+        EGraphResult result = EGraphResult::GraphResultSuccess;
+
+        if (mapEdgesBySource)
+            result = MapIndexSection(fd, (uint64_t)fileStat.st_size, fileHeader.indexBySource, keepEdgeData, mappedBySource);
+
+        if (mapEdgesByDestination && (EGraphResult::GraphResultSuccess == result))
+            result = MapIndexSection(fd, (uint64_t)fileStat.st_size, fileHeader.indexByDestination, keepEdgeData, mappedByDestination);
+
+        // Mappings remain valid once the file is closed.
+        close(fd);
+
+        if (EGraphResult::GraphResultSuccess != result)
+        {
+            if (NULL != mappedBySource.mapping)
+                munmap(mappedBySource.mapping, mappedBySource.mappingSize);
+
+            return result;
+        }
+
+        graph.SetEdgeGroupings(mapEdgesByDestination, mapEdgesBySource);
+
+        if (mapEdgesBySource)
+        {
+            const SGraphSnapshotIndexHeader& indexHeader = fileHeader.indexBySource;
+            graph.VertexIndexSourceWritable().AdoptFrozenMapping(mappedBySource.mapping, mappedBySource.mappingSize, (TVertexCount)indexHeader.numVertices, (TVertexCount)indexHeader.numVerticesPresent, indexHeader.numVectors, mappedBySource.offsets, mappedBySource.neighbors, (0 != (indexHeader.flags & kIndexFlagNeighborsCompact)), mappedBySource.edgeData, (0 != (indexHeader.flags & kIndexFlagSorted)));
+        }
+
+        if (mapEdgesByDestination)
+        {
+            const SGraphSnapshotIndexHeader& indexHeader = fileHeader.indexByDestination;
+            graph.VertexIndexDestinationWritable().AdoptFrozenMapping(mappedByDestination.mapping, mappedByDestination.mappingSize, (TVertexCount)indexHeader.numVertices, (TVertexCount)indexHeader.numVerticesPresent, indexHeader.numVectors, mappedByDestination.offsets, mappedByDestination.neighbors, (0 != (indexHeader.flags & kIndexFlagNeighborsCompact)), mappedByDestination.edgeData, (0 != (indexHeader.flags & kIndexFlagSorted)));
+        }
+
+        return EGraphResult::GraphResultSuccess;
+#else
+        return EGraphResult::GraphResultErrorUnknown;
+#endif
+    }
+
+    // --------
+
+    EGraphResult GraphSnapshot::WriteGraphToFile(const char* const filename, const Graph& graph)
+    {
+        if (!graph.IsFrozen())
+            return EGraphResult::GraphResultErrorUnknown;
+
+        // Lay out the file, placing each grouping in its own aligned section.
+        SGraphSnapshotFileHeader fileHeader;
+        memset((void*)&fileHeader, 0, sizeof(fileHeader));
+        fileHeader.magic = kFileMagic;
+        fileHeader.version = kFileVersion;
+        fileHeader.edgeDataType = (uint32_t)graph.GetEdgeDataType();
+        fileHeader.sectionAlignment = (uint32_t)kSectionAlignment;
+
+        uint64_t sectionOffset = AlignPosition(sizeof(fileHeader), kSectionAlignment);
+
+        if (graph.HasEdgesBySource())
+        {
+            fileHeader.flags |= kFileFlagHasEdgesBySource;
+            DescribeIndex(graph.VertexIndexSource(), sectionOffset, fileHeader.indexBySource);
+            sectionOffset = AlignPosition(sectionOffset + fileHeader.indexBySource.sectionSize, kSectionAlignment);
+        }
+
+        if (graph.HasEdgesByDestination())
+        {
+            fileHeader.flags |= kFileFlagHasEdgesByDestination;
+            DescribeIndex(graph.VertexIndexDestination(), sectionOffset, fileHeader.indexByDestination);
+        }
+
+        // Write the header and then each section in turn.
+        FILE* const file = fopen(filename, "wb");
+
+        if (NULL == file)
+            return EGraphResult::GraphResultErrorCannotOpenFile;
+
+        uint64_t position = 0;
+        bool writeSucceeded = WriteArray(file, position, 0, (const void*)&fileHeader, sizeof(fileHeader));
+
+        if (writeSucceeded && graph.HasEdgesBySource())
+            writeSucceeded = WriteIndexSection(file, position, graph.VertexIndexSource(), fileHeader.indexBySource);
+
+        if (writeSucceeded && graph.HasEdgesByDestination())
+            writeSucceeded = WriteIndexSection(file, position, graph.VertexIndexDestination(), fileHeader.indexByDestination);
+
+        if (0 != fclose(file))
+            writeSucceeded = false;
+
+        return (writeSucceeded ? EGraphResult::GraphResultSuccess : EGraphResult::GraphResultErrorIO);
+    }
+}
@@ -0,0 +1,56 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GraphSnapshotReader.cpp
+ *   Implementation of a graph reader that maps snapshot files into memory.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "GraphSnapshot.h"
+#include "GraphSnapshotReader.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace GraphTool
+{
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphReader.h" for documentation.
+
+    template <typename TEdgeData> EGraphResult GraphSnapshotReader<TEdgeData>::ReadGraphFromFile(const char* const filename, Graph& graph)
+    {
+        // The snapshot must hold the same type of edge data as this reader.
+        graph.SetEdgeDataType<TEdgeData>();
+        return GraphSnapshot::ReadGraphFromFile(filename, graph);
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool GraphSnapshotReader<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        return false;
+    }
+
+    // --------
+
+    template <typename TEdgeData> EGraphResult GraphSnapshotReader<TEdgeData>::StreamGraphToWriters(const char* const filename, IGraphWriter* const* writers, const char* const* outputFilenames, const size_t numWriters)
+    {
+        return EGraphResult::GraphResultErrorFormat;
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class GraphSnapshotReader<void>;
+    template class GraphSnapshotReader<uint64_t>;
+    template class GraphSnapshotReader<double>;
+    template class GraphSnapshotReader<uint32_t>;
+    template class GraphSnapshotReader<float>;
+}
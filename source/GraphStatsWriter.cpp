@@ -0,0 +1,501 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file GraphStatsWriter.cpp
+ *   Implementation of a graph writer that summarizes the degree distribution
+ *   and structure of a graph in JSON format instead of writing its edges.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "GraphStatsWriter.h"
+#include "GraphWriter.h"
+#include "NUMASpawner.h"
+#include "Types.h"
+#include "VertexIndex.h"
+#include "WorkScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <spindle.h>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Number of buckets in each degree histogram. Bucket 0 holds vertices with no edges, and bucket `b` holds vertices whose degree is at least `2^(b-1)` and less than `2^b`.
+    static const unsigned int kNumHistogramBuckets = 65;
+
+    /// Number of edges that each Vector-Sparse vector can hold, all of which share the same top-level vertex.
+    static const TEdgeCount kEdgesPerVector = 4;
+
+    /// Percentiles of each degree distribution that are reported, in increasing order.
+    static const double kPercentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+    /// Labels under which the percentiles are reported, in the same order.
+    static const char* const kPercentileLabels[] = { "50", "90", "99", "99.9" };
+
+    /// Number of percentiles that are reported.
+    static const unsigned int kNumPercentiles = sizeof(kPercentiles) / sizeof(kPercentiles[0]);
+
+    /// Index of the out-degree distribution, which is that of the grouping by source.
+    static const unsigned int kDirectionOut = 0;
+
+    /// Index of the in-degree distribution, which is that of the grouping by destination.
+    static const unsigned int kDirectionIn = 1;
+
+    /// Number of degree distributions.
+    static const unsigned int kNumDirections = 2;
+
+
+    // -------- TYPE DEFINITIONS ------------------------------------------- //
+
+    /// Summarizes the degrees of a range of vertices in one direction.
+    struct SDegreeSummary
+    {
+        TEdgeCount maxDegree;                                               ///< Largest degree.
+        TVertexCount numWithoutEdges;                                       ///< Number of vertices whose degree is 0.
+        uint64_t numVectors;                                                ///< Number of Vector-Sparse vectors needed to pack the edges of the vertices.
+        TVertexCount histogram[kNumHistogramBuckets];                       ///< Number of vertices in each histogram bucket.
+    };
+
+    /// Holds everything that one thread computes about its own range of vertices.
+    struct SGraphStatsThreadSummary
+    {
+        SDegreeSummary degrees[kNumDirections];                             ///< Summary of the out-degrees and in-degrees.
+        TVertexCount numIsolated;                                           ///< Number of vertices with neither in-edges nor out-edges.
+        TEdgeCount numSelfLoops;                                            ///< Number of edges whose source and destination are the same vertex.
+        TEdgeCount numDuplicates;                                           ///< Number of edges that repeat an earlier edge between the same two vertices.
+    };
+
+    /// Provides all information needed to specify the parallel computation of the statistics of a graph.
+    struct SGraphStatsSpec
+    {
+        const Graph* graph;                                                 ///< Graph being summarized.
+        TVertexCount numVertices;                                           ///< Number of vertices in the graph.
+        TEdgeCount* degrees[kNumDirections];                                ///< Out-degree and in-degree of every vertex.
+        std::atomic<TEdgeCount>* counts;                                    ///< Degree of every vertex in the direction whose grouping is not present, counted by visiting neighbors, or `NULL` if both groupings are present.
+        SGraphStatsThreadSummary* threadSummaries;                          ///< Summary computed by each thread.
+        WorkScheduler workScheduler;                                        ///< Hands out the edges of the vertex index being visited, in units balanced by the number of edges they hold.
+    };
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Determines the histogram bucket that holds vertices of the specified degree.
+    /// @param [in] degree Degree of interest.
+    /// @return Index of the histogram bucket.
+    static inline unsigned int HistogramBucket(TEdgeCount degree)
+    {
+        unsigned int bucket = 0;
+
+        while (0 != degree)
+        {
+            bucket += 1;
+            degree >>= 1;
+        }
+
+        return bucket;
+    }
+
+    /// Retrieves the vertex index that groups edges in the specified direction, if the graph holds that grouping.
+    /// @param [in] graph Graph of interest.
+    /// @param [in] direction kDirectionOut for the grouping by source, kDirectionIn for the grouping by destination.
+    /// @return Vertex index, or `NULL` if the graph does not hold that grouping.
+    static inline const VertexIndex* VertexIndexForDirection(const Graph& graph, const unsigned int direction)
+    {
+        if (kDirectionOut == direction)
+            return (graph.HasEdgesBySource() ? &graph.VertexIndexSource() : NULL);
+        else
+            return (graph.HasEdgesByDestination() ? &graph.VertexIndexDestination() : NULL);
+    }
+
+    /// Fills in the degree of every vertex in the specified direction, using all threads in the Spindle parallelized region.
+    /// If the graph holds the grouping for that direction, degrees are read from it, and otherwise they are counted by visiting the neighbors of the opposite grouping.
+    /// @param [in,out] statsSpec Statistics computation specification.
+    /// @param [in] direction Direction whose degrees are filled in.
+    static void ParallelComputeDegrees(SGraphStatsSpec* statsSpec, const unsigned int direction)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        const TVertexCount numVertices = statsSpec->numVertices;
+        const TVertexID rangeStartThread = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEndThread = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+        const VertexIndex* const vertexIndex = VertexIndexForDirection(*(statsSpec->graph), direction);
+        TEdgeCount* const degrees = statsSpec->degrees[direction];
+
+        if (NULL != vertexIndex)
+        {
+            for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+                degrees[i] = vertexIndex->GetDegree(i);
+
+            return;
+        }
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+            statsSpec->counts[i].store(0, std::memory_order_relaxed);
+
+        spindleBarrierGlobal();
+
+        // Every edge of the opposite grouping credits the vertex at its other end.
+        const VertexIndex& otherIndex = *(VertexIndexForDirection(*(statsSpec->graph), (kDirectionOut == direction) ? kDirectionIn : kDirectionOut));
+        SWorkUnit unit;
+
+        statsSpec->workScheduler.ParallelInitialize(otherIndex.GetFrozenOffsets(), otherIndex.GetNumVertices(), true);
+
+        while (statsSpec->workScheduler.GetWork(unit))
+        {
+            for (TEdgeID i = unit.edgeStart; i < unit.edgeEnd; ++i)
+            {
+                const TVertexID neighbor = otherIndex.GetFrozenNeighbor(i);
+
+                if (neighbor < (TVertexID)numVertices)
+                    statsSpec->counts[neighbor].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        spindleBarrierGlobal();
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+            degrees[i] = statsSpec->counts[i].load(std::memory_order_relaxed);
+    }
+
+    /// Counts the self-loops and duplicate edges among the edges of the top-level vertices of the specified vertex index that are handed to the calling thread.
+    /// Neighbors are compared after sorting them, unless the vertex index already holds them sorted, so the edges of each vertex are handed to a single thread.
+    /// @param [in] vertexIndex Vertex index whose edges are visited.
+    /// @param [in,out] workScheduler Scheduler that hands out the vertices, shared by all threads.
+    /// @param [in,out] threadSummary Summary of the calling thread, whose self-loop and duplicate counts are filled in.
+    static void CountSelfLoopsAndDuplicates(const VertexIndex& vertexIndex, WorkScheduler& workScheduler, SGraphStatsThreadSummary& threadSummary)
+    {
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+        const bool neighborsSorted = vertexIndex.IsFrozenSorted();
+        std::vector<TVertexID> neighbors;
+
+        SWorkUnit unit;
+
+        threadSummary.numSelfLoops = 0;
+        threadSummary.numDuplicates = 0;
+
+        workScheduler.ParallelInitialize(offsets, vertexIndex.GetNumVertices(), false);
+
+        while (workScheduler.GetWork(unit))
+        {
+            for (TVertexID i = unit.vertexStart; i < unit.vertexEnd; ++i)
+            {
+                const TEdgeID firstEdge = offsets[i];
+                const TEdgeID lastEdge = offsets[i + 1];
+
+                if (neighborsSorted)
+                {
+                    for (TEdgeID j = firstEdge; j < lastEdge; ++j)
+                    {
+                        const TVertexID neighbor = vertexIndex.GetFrozenNeighbor(j);
+
+                        if (i == neighbor)
+                            threadSummary.numSelfLoops += 1;
+
+                        if ((j != firstEdge) && (neighbor == vertexIndex.GetFrozenNeighbor(j - 1)))
+                            threadSummary.numDuplicates += 1;
+                    }
+
+                    continue;
+                }
+
+                neighbors.clear();
+
+                for (TEdgeID j = firstEdge; j < lastEdge; ++j)
+                {
+                    const TVertexID neighbor = vertexIndex.GetFrozenNeighbor(j);
+
+                    if (i == neighbor)
+                        threadSummary.numSelfLoops += 1;
+
+                    neighbors.push_back(neighbor);
+                }
+
+                std::sort(neighbors.begin(), neighbors.end());
+
+                for (size_t j = 1; j < neighbors.size(); ++j)
+                {
+                    if (neighbors[j] == neighbors[j - 1])
+                        threadSummary.numDuplicates += 1;
+                }
+            }
+        }
+    }
+
+    /// Computes the statistics of a graph, for use as a Spindle task function.
+    /// Each thread summarizes its own range of vertices, and the summaries are combined once the parallelized region completes.
+    /// @param [in] arg Pointer to an SGraphStatsSpec object that defines the operation.
+    static void ParallelComputeStatsFunc(void* arg)
+    {
+        SGraphStatsSpec* const statsSpec = (SGraphStatsSpec*)arg;
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        const TVertexCount numVertices = statsSpec->numVertices;
+        const TVertexID rangeStartThread = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEndThread = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+        SGraphStatsThreadSummary& threadSummary = statsSpec->threadSummaries[globalThreadID];
+
+        for (unsigned int direction = 0; direction < kNumDirections; ++direction)
+            ParallelComputeDegrees(statsSpec, direction);
+
+        spindleBarrierGlobal();
+
+        // Summarize the degrees of this thread's range of vertices.
+        threadSummary.numIsolated = 0;
+
+        for (unsigned int direction = 0; direction < kNumDirections; ++direction)
+        {
+            SDegreeSummary& degreeSummary = threadSummary.degrees[direction];
+
+            degreeSummary.maxDegree = 0;
+            degreeSummary.numWithoutEdges = 0;
+            degreeSummary.numVectors = 0;
+
+            for (unsigned int i = 0; i < kNumHistogramBuckets; ++i)
+                degreeSummary.histogram[i] = 0;
+        }
+
+        for (TVertexID i = rangeStartThread; i < rangeEndThread; ++i)
+        {
+            const TEdgeCount outDegree = statsSpec->degrees[kDirectionOut][i];
+            const TEdgeCount inDegree = statsSpec->degrees[kDirectionIn][i];
+
+            for (unsigned int direction = 0; direction < kNumDirections; ++direction)
+            {
+                SDegreeSummary& degreeSummary = threadSummary.degrees[direction];
+                const TEdgeCount degree = ((kDirectionOut == direction) ? outDegree : inDegree);
+
+                if (degree > degreeSummary.maxDegree)
+                    degreeSummary.maxDegree = degree;
+
+                if (0 == degree)
+                    degreeSummary.numWithoutEdges += 1;
+
+                degreeSummary.numVectors += (uint64_t)((degree + kEdgesPerVector - 1) / kEdgesPerVector);
+                degreeSummary.histogram[HistogramBucket(degree)] += 1;
+            }
+
+            if ((0 == outDegree) && (0 == inDegree))
+                threadSummary.numIsolated += 1;
+        }
+
+        // Self-loops and duplicates appear in both groupings alike, so they are counted using whichever is present.
+        const VertexIndex* const vertexIndex = VertexIndexForDirection(*(statsSpec->graph), kDirectionOut);
+        CountSelfLoopsAndDuplicates(((NULL != vertexIndex) ? *vertexIndex : *VertexIndexForDirection(*(statsSpec->graph), kDirectionIn)), statsSpec->workScheduler, threadSummary);
+    }
+
+    /// Writes the summary of the degrees in one direction as a JSON object, finding the percentiles by partially sorting the degrees.
+    /// @param [in] jsonfile File to which to write.
+    /// @param [in] name Name of the JSON object.
+    /// @param [in] degreeSummary Combined summary of the degrees of all vertices.
+    /// @param [in,out] degrees Degree of every vertex, reordered while finding the percentiles.
+    /// @param [in] numVertices Number of vertices.
+    /// @param [in] numEdges Number of edges.
+    static void WriteDegreeSummary(FILE* const jsonfile, const char* const name, const SDegreeSummary& degreeSummary, TEdgeCount* const degrees, const TVertexCount numVertices, const TEdgeCount numEdges)
+    {
+        fprintf(jsonfile, "  \"%s\": {\n", name);
+        fprintf(jsonfile, "    \"max\": %llu,\n", (long long unsigned int)degreeSummary.maxDegree);
+        fprintf(jsonfile, "    \"mean\": %.6f,\n", ((0 == numVertices) ? 0.0 : ((double)numEdges / (double)numVertices)));
+        fprintf(jsonfile, "    \"verticesWithoutEdges\": %llu,\n", (long long unsigned int)degreeSummary.numWithoutEdges);
+        fprintf(jsonfile, "    \"percentiles\": {");
+
+        // Percentiles use the nearest-rank definition, and each is found among the degrees at least as large as the previous one.
+        TVertexCount searchStart = 0;
+
+        for (unsigned int i = 0; i < kNumPercentiles; ++i)
+        {
+            TEdgeCount percentileDegree = 0;
+
+            if (0 != numVertices)
+            {
+                TVertexCount rank = (TVertexCount)((kPercentiles[i] * (double)numVertices) / 100.0);
+
+                if ((double)rank < ((kPercentiles[i] * (double)numVertices) / 100.0))
+                    rank += 1;
+
+                const TVertexCount position = ((0 == rank) ? 0 : (rank - 1));
+
+                std::nth_element(&degrees[searchStart], &degrees[position], &degrees[numVertices]);
+                percentileDegree = degrees[position];
+                searchStart = position;
+            }
+
+            fprintf(jsonfile, "%s\n      \"%s\": %llu", ((0 == i) ? "" : ","), kPercentileLabels[i], (long long unsigned int)percentileDegree);
+        }
+
+        fprintf(jsonfile, "\n    },\n");
+        fprintf(jsonfile, "    \"vectors\": %llu,\n", (long long unsigned int)degreeSummary.numVectors);
+        fprintf(jsonfile, "    \"vectorEfficiency\": %.6f,\n", ((0 == degreeSummary.numVectors) ? 0.0 : ((double)numEdges / (double)(degreeSummary.numVectors * kEdgesPerVector))));
+        fprintf(jsonfile, "    \"histogram\": [");
+
+        // Buckets are listed up to the last that holds any vertices.
+        unsigned int numBuckets = kNumHistogramBuckets;
+
+        while ((numBuckets > 1) && (0 == degreeSummary.histogram[numBuckets - 1]))
+            numBuckets -= 1;
+
+        for (unsigned int i = 0; i < numBuckets; ++i)
+        {
+            const TEdgeCount bucketMin = ((0 == i) ? 0 : (1ull << (i - 1)));
+            const TEdgeCount bucketMax = ((0 == i) ? 0 : ((i < 64) ? ((1ull << i) - 1) : UINT64_MAX));
+
+            fprintf(jsonfile, "%s\n      { \"min\": %llu, \"max\": %llu, \"vertices\": %llu }", ((0 == i) ? "" : ","), (long long unsigned int)bucketMin, (long long unsigned int)bucketMax, (long long unsigned int)degreeSummary.histogram[i]);
+        }
+
+        fprintf(jsonfile, "\n    ]\n  }");
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "GraphStatsWriter.h" for documentation.
+
+    template <typename TEdgeData> GraphStatsWriter<TEdgeData>::GraphStatsWriter(void) : GraphWriter<TEdgeData>()
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphWriter.h" for documentation.
+
+    template <typename TEdgeData> GraphWriter<TEdgeData>* GraphStatsWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new GraphStatsWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* GraphStatsWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        // Summaries are written by WriteSummaryToFile, so no file is ever opened to receive edges.
+        return NULL;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void GraphStatsWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    template <typename TEdgeData> EGraphResult GraphStatsWriter<TEdgeData>::WriteSummaryToFile(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        const uint32_t numThreads = NUMASpawner::GetThreadCount();
+
+        if (0 == numThreads)
+            return EGraphResult::GraphResultErrorUnknown;
+
+        if (!(graph.IsFrozen()) || !(graph.HasEdgesBySource() || graph.HasEdgesByDestination()))
+            return EGraphResult::GraphResultErrorUnknown;
+
+        // Compute the degrees of every vertex and summarize them in parallel.
+        const TVertexCount numVertices = graph.GetNumVertices();
+        const TEdgeCount numEdges = graph.GetNumEdges();
+        std::vector<TEdgeCount> outDegrees(numVertices);
+        std::vector<TEdgeCount> inDegrees(numVertices);
+        std::vector<SGraphStatsThreadSummary> threadSummaries(numThreads);
+        SGraphStatsSpec statsSpec;
+
+        statsSpec.graph = &graph;
+        statsSpec.numVertices = numVertices;
+        statsSpec.degrees[kDirectionOut] = outDegrees.data();
+        statsSpec.degrees[kDirectionIn] = inDegrees.data();
+        statsSpec.counts = ((graph.HasEdgesBySource() && graph.HasEdgesByDestination()) ? NULL : new std::atomic<TEdgeCount>[numVertices]);
+        statsSpec.threadSummaries = threadSummaries.data();
+
+        const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelComputeStatsFunc, (void*)&statsSpec);
+
+        if (NULL != statsSpec.counts)
+            delete[] statsSpec.counts;
+
+        if (EGraphResult::GraphResultSuccess != spawnResult)
+            return spawnResult;
+
+        // Combine the summaries of all threads.
+        SGraphStatsThreadSummary summary = threadSummaries[0];
+
+        for (uint32_t i = 1; i < numThreads; ++i)
+        {
+            for (unsigned int direction = 0; direction < kNumDirections; ++direction)
+            {
+                SDegreeSummary& degreeSummary = summary.degrees[direction];
+                const SDegreeSummary& threadDegreeSummary = threadSummaries[i].degrees[direction];
+
+                degreeSummary.maxDegree = std::max(degreeSummary.maxDegree, threadDegreeSummary.maxDegree);
+                degreeSummary.numWithoutEdges += threadDegreeSummary.numWithoutEdges;
+                degreeSummary.numVectors += threadDegreeSummary.numVectors;
+
+                for (unsigned int j = 0; j < kNumHistogramBuckets; ++j)
+                    degreeSummary.histogram[j] += threadDegreeSummary.histogram[j];
+            }
+
+            summary.numIsolated += threadSummaries[i].numIsolated;
+            summary.numSelfLoops += threadSummaries[i].numSelfLoops;
+            summary.numDuplicates += threadSummaries[i].numDuplicates;
+        }
+
+        // Write the statistics.
+        FILE* const jsonfile = fopen(filename, "w");
+
+        if (NULL == jsonfile)
+            return EGraphResult::GraphResultErrorCannotOpenFile;
+
+        fprintf(jsonfile, "{\n");
+        fprintf(jsonfile, "  \"vertices\": %llu,\n", (long long unsigned int)numVertices);
+        fprintf(jsonfile, "  \"edges\": %llu,\n", (long long unsigned int)numEdges);
+        fprintf(jsonfile, "  \"selfLoops\": %llu,\n", (long long unsigned int)summary.numSelfLoops);
+        fprintf(jsonfile, "  \"duplicateEdges\": %llu,\n", (long long unsigned int)summary.numDuplicates);
+        fprintf(jsonfile, "  \"isolatedVertices\": %llu,\n", (long long unsigned int)summary.numIsolated);
+
+        WriteDegreeSummary(jsonfile, "outDegree", summary.degrees[kDirectionOut], outDegrees.data(), numVertices, numEdges);
+        fprintf(jsonfile, ",\n");
+        WriteDegreeSummary(jsonfile, "inDegree", summary.degrees[kDirectionIn], inDegrees.data(), numVertices, numEdges);
+        fprintf(jsonfile, "\n}\n");
+
+        const bool writeSucceeded = !(ferror(jsonfile));
+
+        if ((0 != fclose(jsonfile)) || !writeSucceeded)
+            return EGraphResult::GraphResultErrorIO;
+
+        return EGraphResult::GraphResultSuccess;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool GraphStatsWriter<TEdgeData>::WritesSummary(void) const
+    {
+        return true;
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphWriter.h" for documentation.
+
+    template <typename TEdgeData> bool GraphStatsWriter<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        // None of the options that control how edges are traversed, formatted, or written apply to a summary.
+        return false;
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class GraphStatsWriter<void>;
+    template class GraphStatsWriter<uint64_t>;
+    template class GraphStatsWriter<double>;
+    template class GraphStatsWriter<uint32_t>;
+    template class GraphStatsWriter<float>;
+}
@@ -12,14 +12,13 @@
 
 #include "Graph.h"
 #include "GraphTransform.h"
+#include "NUMASpawner.h"
 #include "Types.h"
 
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
-#include <silo.h>
 #include <spindle.h>
-#include <topo.h>
 
 
 namespace GraphTool
@@ -57,7 +56,7 @@ namespace GraphTool
     void GraphTransform::ParallelTransformFunc(void* arg)
     {
         SGraphTransformSpec* const transformSpec = (SGraphTransformSpec*)arg;
-        transformSpec->transformResult[spindleGetLocalThreadID()] = transformSpec->transform->TransformGraph(*(transformSpec->graph));
+        transformSpec->transformResult[spindleGetGlobalThreadID()] = transformSpec->transform->TransformGraph(*(transformSpec->graph));
     }
 
 
@@ -77,10 +76,9 @@ namespace GraphTool
     {
         if (CanParallelizeTransformation())
         {
-            const uint32_t numaNode = (uint32_t)siloGetNUMANodeForVirtualAddress((void*)&graph);
-            const uint32_t numThreads = topoGetNUMANodeLogicalCoreCount(numaNode);
+            const uint32_t numThreads = NUMASpawner::GetThreadCount();
             
-            if ((numaNode > topoGetSystemNUMANodeCount()) || (0 == numThreads))
+            if (0 == numThreads)
                 return EGraphResult::GraphResultErrorUnknown;
             
             // Define the graph transformation task.
@@ -95,16 +93,8 @@ namespace GraphTool
             for (uint32_t i = 0; i < numThreads; ++i)
                 transformSpec.transformResult[i] = EGraphResult::GraphResultSuccess;
             
-            // Define the parallelization strategy.
-            SSpindleTaskSpec taskSpec;
-            taskSpec.func = &ParallelTransformFunc;
-            taskSpec.arg = (void*)&transformSpec;
-            taskSpec.numaNode = numaNode;
-            taskSpec.numThreads = numThreads;
-            taskSpec.smtPolicy = SpindleSMTPolicyPreferLogical;
-            
-            // Launch the graph transformation task.
-            const uint32_t spawnResult = spindleThreadsSpawn(&taskSpec, 1, true);
+            // Launch the graph transformation task on every NUMA node, each of which works on its own partition of the graph.
+            const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelTransformFunc, (void*)&transformSpec);
             
             // Collect the results.
             EGraphResult result = EGraphResult::GraphResultSuccess;
@@ -121,8 +111,8 @@ namespace GraphTool
             // Clean up.
             delete[] transformSpec.transformResult;
             
-            if (0 != spawnResult)
-                return EGraphResult::GraphResultErrorUnknown;
+            if (EGraphResult::GraphResultSuccess != spawnResult)
+                return spawnResult;
             else
                 return result;
         }
@@ -131,4 +121,50 @@ namespace GraphTool
             return TransformGraph(graph);
         }
     }
+    
+    // --------
+    
+    void GraphTransform::BeginFusedTransformation(Graph& graph)
+    {
+        // Only invoked on fusible transformations, which must override this method.
+    }
+    
+    // --------
+    
+    bool GraphTransform::CanFuseTransformation(void) const
+    {
+        // Transformations are not fusible by default.
+        return false;
+    }
+    
+    // --------
+    
+    void GraphTransform::EndFusedTransformation(Graph& graph)
+    {
+        // Only invoked on fusible transformations, which must override this method.
+    }
+    
+    // --------
+    
+    bool GraphTransform::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        // No options are supported by default.
+        return false;
+    }
+    
+    // --------
+    
+    size_t GraphTransform::TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count)
+    {
+        // Only invoked on fusible transformations, which must override this method.
+        return count;
+    }
+    
+    // --------
+    
+    size_t GraphTransform::TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count)
+    {
+        // Only invoked on fusible transformations, which must override this method.
+        return count;
+    }
 }
@@ -10,10 +10,16 @@
  *   Factory for creating IGraphTransform objects of various types.
  *****************************************************************************/
 
+#include "FilterTransform.h"
 #include "GraphTransformFactory.h"
 #include "HashEdgeDataTransform.h"
 #include "IGraphTransform.h"
 #include "NullEdgeDataTransform.h"
+#include "RandomEdgeDataTransform.h"
+#include "ReorderVerticesTransform.h"
+#include "SortEdgesTransform.h"
+#include "SymmetrizeTransform.h"
+#include "TransposeTransform.h"
 #include "Types.h"
 
 #include <cstddef>
@@ -39,6 +45,76 @@ namespace GraphTool
         { "nullfloatedgedata",                                              EGraphTransformType::GraphTransformTypeNullFloatEdgeData },
         { "nullFloatEdgeData",                                              EGraphTransformType::GraphTransformTypeNullFloatEdgeData },
         { "NullFloatEdgeData",                                              EGraphTransformType::GraphTransformTypeNullFloatEdgeData },
+
+        { "randomintedgedata",                                              EGraphTransformType::GraphTransformTypeRandomIntEdgeData },
+        { "randomIntEdgeData",                                              EGraphTransformType::GraphTransformTypeRandomIntEdgeData },
+        { "RandomIntEdgeData",                                              EGraphTransformType::GraphTransformTypeRandomIntEdgeData },
+
+        { "randomfloatedgedata",                                            EGraphTransformType::GraphTransformTypeRandomFloatEdgeData },
+        { "randomFloatEdgeData",                                            EGraphTransformType::GraphTransformTypeRandomFloatEdgeData },
+        { "RandomFloatEdgeData",                                            EGraphTransformType::GraphTransformTypeRandomFloatEdgeData },
+
+        { "sortedges",                                                      EGraphTransformType::GraphTransformTypeSortEdges },
+        { "sortEdges",                                                      EGraphTransformType::GraphTransformTypeSortEdges },
+        { "SortEdges",                                                      EGraphTransformType::GraphTransformTypeSortEdges },
+
+        { "dedupedges",                                                     EGraphTransformType::GraphTransformTypeDedupEdgesFirst },
+        { "dedupEdges",                                                     EGraphTransformType::GraphTransformTypeDedupEdgesFirst },
+        { "DedupEdges",                                                     EGraphTransformType::GraphTransformTypeDedupEdgesFirst },
+
+        { "dedupedgesfirst",                                                EGraphTransformType::GraphTransformTypeDedupEdgesFirst },
+        { "dedupEdgesFirst",                                                EGraphTransformType::GraphTransformTypeDedupEdgesFirst },
+        { "DedupEdgesFirst",                                                EGraphTransformType::GraphTransformTypeDedupEdgesFirst },
+
+        { "dedupedgesmin",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesMin },
+        { "dedupEdgesMin",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesMin },
+        { "DedupEdgesMin",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesMin },
+
+        { "dedupedgesmax",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesMax },
+        { "dedupEdgesMax",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesMax },
+        { "DedupEdgesMax",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesMax },
+
+        { "dedupedgessum",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesSum },
+        { "dedupEdgesSum",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesSum },
+        { "DedupEdgesSum",                                                  EGraphTransformType::GraphTransformTypeDedupEdgesSum },
+
+        { "reorderdegree",                                                  EGraphTransformType::GraphTransformTypeReorderDegree },
+        { "reorderDegree",                                                  EGraphTransformType::GraphTransformTypeReorderDegree },
+        { "ReorderDegree",                                                  EGraphTransformType::GraphTransformTypeReorderDegree },
+
+        { "reorderrcm",                                                     EGraphTransformType::GraphTransformTypeReorderRCM },
+        { "reorderRCM",                                                     EGraphTransformType::GraphTransformTypeReorderRCM },
+        { "ReorderRCM",                                                     EGraphTransformType::GraphTransformTypeReorderRCM },
+
+        { "reordergorder",                                                  EGraphTransformType::GraphTransformTypeReorderGorder },
+        { "reorderGorder",                                                  EGraphTransformType::GraphTransformTypeReorderGorder },
+        { "ReorderGorder",                                                  EGraphTransformType::GraphTransformTypeReorderGorder },
+
+        { "compactvertices",                                                EGraphTransformType::GraphTransformTypeCompactVertices },
+        { "compactVertices",                                                EGraphTransformType::GraphTransformTypeCompactVertices },
+        { "CompactVertices",                                                EGraphTransformType::GraphTransformTypeCompactVertices },
+
+        { "symmetrize",                                                     EGraphTransformType::GraphTransformTypeSymmetrize },
+        { "Symmetrize",                                                     EGraphTransformType::GraphTransformTypeSymmetrize },
+
+        { "transpose",                                                      EGraphTransformType::GraphTransformTypeTranspose },
+        { "Transpose",                                                      EGraphTransformType::GraphTransformTypeTranspose },
+
+        { "removeselfloops",                                                EGraphTransformType::GraphTransformTypeRemoveSelfLoops },
+        { "removeSelfLoops",                                                EGraphTransformType::GraphTransformTypeRemoveSelfLoops },
+        { "RemoveSelfLoops",                                                EGraphTransformType::GraphTransformTypeRemoveSelfLoops },
+
+        { "filterdegree",                                                   EGraphTransformType::GraphTransformTypeFilterDegree },
+        { "filterDegree",                                                   EGraphTransformType::GraphTransformTypeFilterDegree },
+        { "FilterDegree",                                                   EGraphTransformType::GraphTransformTypeFilterDegree },
+
+        { "filtervertexrange",                                              EGraphTransformType::GraphTransformTypeFilterVertexRange },
+        { "filterVertexRange",                                              EGraphTransformType::GraphTransformTypeFilterVertexRange },
+        { "FilterVertexRange",                                              EGraphTransformType::GraphTransformTypeFilterVertexRange },
+
+        { "largestcomponent",                                               EGraphTransformType::GraphTransformTypeLargestComponent },
+        { "largestComponent",                                               EGraphTransformType::GraphTransformTypeLargestComponent },
+        { "LargestComponent",                                               EGraphTransformType::GraphTransformTypeLargestComponent },
     };
 
     
@@ -63,6 +139,74 @@ namespace GraphTool
             result = new NullEdgeDataTransform<double>;
             break;
 
+        case EGraphTransformType::GraphTransformTypeRandomIntEdgeData:
+            result = new RandomEdgeDataTransform<uint64_t>;
+            break;
+
+        case EGraphTransformType::GraphTransformTypeRandomFloatEdgeData:
+            result = new RandomEdgeDataTransform<double>;
+            break;
+
+        case EGraphTransformType::GraphTransformTypeSortEdges:
+            result = new SortEdgesTransform(EDuplicateEdgePolicy::DuplicateEdgePolicyKeep);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeDedupEdgesFirst:
+            result = new SortEdgesTransform(EDuplicateEdgePolicy::DuplicateEdgePolicyFirst);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeDedupEdgesMin:
+            result = new SortEdgesTransform(EDuplicateEdgePolicy::DuplicateEdgePolicyMin);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeDedupEdgesMax:
+            result = new SortEdgesTransform(EDuplicateEdgePolicy::DuplicateEdgePolicyMax);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeDedupEdgesSum:
+            result = new SortEdgesTransform(EDuplicateEdgePolicy::DuplicateEdgePolicySum);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeReorderDegree:
+            result = new ReorderVerticesTransform(EVertexOrder::VertexOrderDegree);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeReorderRCM:
+            result = new ReorderVerticesTransform(EVertexOrder::VertexOrderRCM);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeReorderGorder:
+            result = new ReorderVerticesTransform(EVertexOrder::VertexOrderGorder);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeCompactVertices:
+            result = new ReorderVerticesTransform(EVertexOrder::VertexOrderCompact);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeSymmetrize:
+            result = new SymmetrizeTransform();
+            break;
+
+        case EGraphTransformType::GraphTransformTypeTranspose:
+            result = new TransposeTransform();
+            break;
+
+        case EGraphTransformType::GraphTransformTypeRemoveSelfLoops:
+            result = new FilterTransform(EFilterType::FilterTypeSelfLoops);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeFilterDegree:
+            result = new FilterTransform(EFilterType::FilterTypeDegree);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeFilterVertexRange:
+            result = new FilterTransform(EFilterType::FilterTypeVertexRange);
+            break;
+
+        case EGraphTransformType::GraphTransformTypeLargestComponent:
+            result = new FilterTransform(EFilterType::FilterTypeLargestComponent);
+            break;
+
         default:
             break;
         }
@@ -11,43 +11,311 @@
  *   various formats.
  *****************************************************************************/
 
+#include "BufferRing.h"
+#include "CompressingFile.h"
+#include "DirectFile.h"
 #include "EdgeList.h"
 #include "VertexIndex.h"
 #include "Graph.h"
 #include "GraphWriter.h"
+#include "MemoryTracker.h"
+#include "NUMASpawner.h"
+#include "Statistics.h"
 #include "Types.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <silo.h>
 #include <spindle.h>
+#include <string>
+#include <topo.h>
+#include <vector>
 
 
 namespace GraphTool
 {
+    // -------- LOCALS ----------------------------------------------------- //
+    
+    /// Name of the writer option that selects how edges are formatted.
+    static const char* const kWriterOptionFormatter = "formatter";
+    
+    /// Value of the formatter option that causes edges to be formatted by all consumer threads in parallel.
+    static const char* const kWriterOptionFormatterParallel = "parallel";
+    
+    /// Value of the formatter option that causes edges to be formatted and written by a single consumer thread.
+    static const char* const kWriterOptionFormatterSerial = "serial";
+    
+    /// Name of the writer option that specifies the number of partitions into which the output is split.
+    static const char* const kWriterOptionPartitions = "partitions";
+    
+    /// Name of the writer option that selects how top-level vertices are assigned to partitions.
+    static const char* const kWriterOptionPartitioner = "partitioner";
+    
+    /// Value of the partitioner option that assigns edge-balanced ranges of consecutive top-level vertices to partitions.
+    static const char* const kWriterOptionPartitionerRange = "range";
+    
+    /// Value of the partitioner option that assigns top-level vertices to partitions by hash.
+    static const char* const kWriterOptionPartitionerHash = "hash";
+    
+    /// Writer option that selects how the graph file is written.
+    static const char* const kWriterOptionIO = "io";
+    
+    /// Value of the io option that writes using the standard C library and the operating system's page cache. This is the default.
+    static const char* const kWriterOptionIOBuffered = "buffered";
+    
+    /// Value of the io option that writes using asynchronous direct I/O, bypassing the page cache.
+    static const char* const kWriterOptionIODirect = "direct";
+    
+    /// Writer option that specifies the number of requests to keep in flight when writing using asynchronous direct I/O.
+    static const char* const kWriterOptionIODepth = "iodepth";
+    
+    /// Writer option that selects whether and how the graph file is compressed.
+    static const char* const kWriterOptionCompression = "compression";
+    
+    /// Value of the compression option that writes the graph file without compression. This is the default.
+    static const char* const kWriterOptionCompressionNone = "none";
+    
+    /// Value of the compression option that compresses the graph file using gzip.
+    static const char* const kWriterOptionCompressionGzip = "gzip";
+    
+    /// Value of the compression option that compresses the graph file using zstd.
+    static const char* const kWriterOptionCompressionZstd = "zstd";
+    
+    /// Writer option that specifies the compression level.
+    static const char* const kWriterOptionCompressLevel = "compresslevel";
+    
+    /// Writer option that specifies the number of threads that compress the graph file.
+    static const char* const kWriterOptionCompressThreads = "compressthreads";
+    
+    /// Writer option that specifies the number of write buffers.
+    static const char* const kWriterOptionBuffers = "buffers";
+    
+    /// Writer option that specifies the size of each write buffer, in megabytes.
+    static const char* const kWriterOptionBufferSize = "buffersize";
+    
+    /// Writer option that specifies the number of consumer threads that format edges in parallel.
+    static const char* const kWriterOptionThreads = "threads";
+    
+    /// Number of consecutive vertices whose offsets each thread formats at a time.
+    static const TVertexCount kVertexOffsetsShardSize = 65536;
+    
+    
     // -------- TYPE DEFINITIONS ------------------------------------------- //
 
-    /// Provides all information needed to specify a graph write operation.
+    template <typename TEdgeData> struct SGraphWriteTarget;
+    
+    /// Provides all information needed to specify a graph write operation, in which a single traversal of the graph produces any number of files.
     template <typename TEdgeData> struct SGraphWriteSpec
     {
-        FILE* file;                                                         ///< File handle.
         unsigned int currentPass;                                           ///< Zero-based index of the current pass of the graph write process.
         const Graph* graph;                                                 ///< Graph object being exported.
-        GraphWriter<TEdgeData>* writer;                                     ///< Graph write object.
-        SEdge<TEdgeData>* bufs[2];                                          ///< Edge data buffers.
-        TEdgeCount counts[2];                                               ///< Edge data buffer counts.
+        const SGraphEdgeSource<TEdgeData>* edgeSource;                      ///< Source of the edges to write in place of those held by the graph, or `NULL` if the graph holds them.
+        BufferRing* ring;                                                   ///< Coordinates the use of the buffers by the edge producer and the consumers of each file.
+        std::vector<SEdge<TEdgeData>*> bufs;                                ///< Edge data buffers, one per position in the ring, shared by all of the files being written.
+        std::vector<TEdgeCount> counts;                                     ///< Edge data buffer counts.
+        TEdgeCount bufCapacity;                                             ///< Number of edges that each edge data buffer can hold.
+        std::atomic<size_t> numActiveTargets;                               ///< Number of files that need the current pass and have not yet failed to be written.
         bool groupedByDestination;                                          ///< Indicates that graph edges should be grouped by destination instead of by source.
-        EGraphResult writeResult;                                           ///< Indicates the result of the write operation.
+        SGraphWriteTarget<TEdgeData>* targets;                              ///< Files being written, one per graph writer object.
+        size_t numTargets;                                                  ///< Number of files being written.
+    };
+    
+    /// Provides all information needed to write one of the files produced by a graph write operation.
+    template <typename TEdgeData> struct SGraphWriteTarget
+    {
+        SGraphWriteSpec<TEdgeData>* writeSpec;                              ///< Graph write operation that produces this file.
+        FILE* file;                                                         ///< File handle.
+        GraphWriter<TEdgeData>* writer;                                     ///< Graph write object.
+        uint32_t consumerIndex;                                             ///< Index of this file's consumer within the ring of buffers during the current pass.
+        unsigned int numPasses;                                             ///< Number of passes over the graph required by the graph write object.
+        std::vector<char>* formattedShards;                                 ///< Formatted output and secondary output of each consumer thread, double-buffered so that writing one round overlaps formatting the next.
+        const SEdge<TEdgeData>* partitionBuf;                               ///< Edges of the current buffer that belong to the partition written to this file, if the output is partitioned.
+        size_t partitionCount;                                              ///< Number of edges of the current buffer that belong to the partition written to this file.
+        EGraphResult writeResult;                                           ///< Indicates the result of writing this file.
+    };
+    
+    /// Provides all information needed to specify the parallel writing of the offset at which the edges of each vertex begin.
+    struct SVertexOffsetsWriteSpec
+    {
+        FILE* file;                                                         ///< File handle, positioned where the offsets should be written.
+        const VertexIndex* vertexIndex;                                     ///< Vertex index whose degrees determine the offsets.
+        const SGraphPartition* partition;                                   ///< Part of the graph being written, outside of which top-level vertices have no edges.
+        TVertexCount numVertices;                                           ///< Number of vertices to list, which may exceed the number in the vertex index.
+        void (*appendOffset)(std::vector<char>&, const TEdgeCount, const size_t); ///< Appends a single offset to a buffer.
+        size_t offsetSize;                                                  ///< Number of bytes that each offset occupies, or 0 if offsets vary in size.
+        bool appendsEndOffset;                                              ///< Indicates that the offset following the last vertex should also be written.
+        std::vector<char>* formattedShards;                                 ///< Formatted offsets of each thread.
+        TEdgeCount* shardEdgeCounts;                                        ///< Number of edges belonging to the vertices in each thread's shard.
     };
+    
+    
+    // -------- HELPERS ---------------------------------------------------- //
+    
+    /// Parses the value of a writer option that holds an integer within the specified range.
+    /// @param [in] optionValue Value of the option.
+    /// @param [in] minValue Smallest valid value.
+    /// @param [in] maxValue Largest valid value.
+    /// @param [out] value Parsed value, modified only if parsing succeeds.
+    /// @return `true` if the value is a valid integer within range, `false` otherwise.
+    static bool ParseNumericOptionValue(const char* const optionValue, const uint64_t minValue, const uint64_t maxValue, uint64_t& value)
+    {
+        char* valueEnd = NULL;
+        const uint64_t parsedValue = (uint64_t)strtoull(optionValue, &valueEnd, 10);
+        
+        if (('\0' == optionValue[0]) || ('-' == optionValue[0]) || ('\0' != *valueEnd) || (parsedValue < minValue) || (parsedValue > maxValue))
+            return false;
+        
+        value = parsedValue;
+        return true;
+    }
+    
+    /// Records that writing one of the files of a graph write operation has failed, so that the edge producer can stop early once every file that needs the current pass has failed.
+    /// Invoked once per failed file, by a single thread.
+    /// @param [in,out] writeTarget File that failed to be written.
+    /// @param [in] writeResult Result to report for the file.
+    template <typename TEdgeData> static void FailGraphWriteTarget(SGraphWriteTarget<TEdgeData>* writeTarget, const EGraphResult writeResult)
+    {
+        writeTarget->writeResult = writeResult;
+        writeTarget->writeSpec->numActiveTargets.fetch_sub(1, std::memory_order_release);
+    }
+    
+    /// Determines if the current pass of a graph write operation should continue, which is the case until writing has failed for every file that needs it.
+    /// Invoked by the edge producer before filling each buffer, which it leaves empty to signal termination to the consumers if this returns `false`.
+    /// @param [in] writeSpec Graph write operation specification.
+    /// @return `true` if the edge producer should keep filling buffers, `false` otherwise.
+    template <typename TEdgeData> static inline bool IsGraphWritePassActive(const SGraphWriteSpec<TEdgeData>* writeSpec)
+    {
+        return (0 != writeSpec->numActiveTargets.load(std::memory_order_acquire));
+    }
+    
+    /// Spindle entry point for writing the offset at which the edges of each vertex begin.
+    /// See the documentation of GraphWriter::WriteVertexOffsetsToFile for a description of the algorithm.
+    /// @param [in] arg Pointer to an SVertexOffsetsWriteSpec object that defines the operation.
+    static void ParallelWriteVertexOffsetsFunc(void* arg)
+    {
+        SVertexOffsetsWriteSpec* const writeSpec = (SVertexOffsetsWriteSpec*)arg;
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        const VertexIndex& vertexIndex = *writeSpec->vertexIndex;
+        const TVertexCount numVertices = writeSpec->numVertices;
+        const TVertexCount numIndexVertices = vertexIndex.GetNumVertices();
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+        const SGraphPartition& partition = *writeSpec->partition;
+        const bool isWholeGraph = (1 == partition.numPartitions);
+        
+        auto partitionDegree = [&vertexIndex, offsets, &partition](const TVertexID vertex) -> TEdgeCount
+        {
+            if (!(partition.ContainsVertex(vertex)))
+                return 0;
+            
+            return ((NULL != offsets) ? (offsets[vertex + 1] - offsets[vertex]) : vertexIndex.GetDegree(vertex));
+        };
+        
+        if (0 == globalThreadID)
+        {
+            writeSpec->formattedShards = new std::vector<char>[globalThreadCount];
+            writeSpec->shardEdgeCounts = new TEdgeCount[globalThreadCount];
+        }
+        
+        spindleBarrierGlobal();
+        
+        std::vector<char>& shard = writeSpec->formattedShards[globalThreadID];
+        TEdgeCount roundOffset = 0;
+        
+        for (TVertexCount roundStart = 0; roundStart < numVertices; roundStart += (kVertexOffsetsShardSize * globalThreadCount))
+        {
+            const TVertexCount shardStart = roundStart + (kVertexOffsetsShardSize * globalThreadID);
+            const TVertexCount shardEnd = (((shardStart + kVertexOffsetsShardSize) < numVertices) ? (shardStart + kVertexOffsetsShardSize) : numVertices);
+            const TVertexCount shardIndexStart = ((shardStart < numIndexVertices) ? shardStart : numIndexVertices);
+            const TVertexCount shardIndexEnd = ((shardEnd < numIndexVertices) ? shardEnd : numIndexVertices);
+            
+            // First, count the edges in the shard, which a frozen vertex index already holds as a prefix sum.
+            TEdgeCount shardEdgeCount = 0;
+            
+            if (shardIndexStart < shardIndexEnd)
+            {
+                if ((NULL != offsets) && isWholeGraph)
+                {
+                    shardEdgeCount = offsets[shardIndexEnd] - offsets[shardIndexStart];
+                }
+                else
+                {
+                    for (TVertexID vertex = shardIndexStart; vertex < shardIndexEnd; ++vertex)
+                        shardEdgeCount += partitionDegree(vertex);
+                }
+            }
+            
+            writeSpec->shardEdgeCounts[globalThreadID] = shardEdgeCount;
+            spindleBarrierGlobal();
+            
+            // Next, determine the offsets at which this thread's shard and the next round begin.
+            TEdgeCount currentOffset = roundOffset;
+            
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                if (i < globalThreadID)
+                    currentOffset += writeSpec->shardEdgeCounts[i];
+                
+                roundOffset += writeSpec->shardEdgeCounts[i];
+            }
+            
+            // Format the offset of each vertex in the shard.
+            shard.clear();
+            
+            if (shardStart < shardEnd)
+                shard.reserve((size_t)(shardEnd - shardStart) * writeSpec->offsetSize);
+            
+            for (TVertexID vertex = shardStart; vertex < shardEnd; ++vertex)
+            {
+                writeSpec->appendOffset(shard, currentOffset, writeSpec->offsetSize);
+                
+                if (vertex < shardIndexEnd)
+                    currentOffset += partitionDegree(vertex);
+            }
+            
+            spindleBarrierGlobal();
+            
+            if (0 == globalThreadID)
+            {
+                for (uint32_t i = 0; i < globalThreadCount; ++i)
+                {
+                    if (!(writeSpec->formattedShards[i].empty()))
+                        fwrite((void*)writeSpec->formattedShards[i].data(), sizeof(char), writeSpec->formattedShards[i].size(), writeSpec->file);
+                }
+            }
+        }
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            // The offset following the last vertex is the number of edges counted.
+            if (writeSpec->appendsEndOffset)
+            {
+                shard.clear();
+                writeSpec->appendOffset(shard, roundOffset, writeSpec->offsetSize);
+                fwrite((void*)shard.data(), sizeof(char), shard.size(), writeSpec->file);
+            }
+            
+            delete[] writeSpec->formattedShards;
+            delete[] writeSpec->shardEdgeCounts;
+        }
+    }
 
 
     // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
     // See "GraphWriter.h" for documentation.
 
-    template <typename TEdgeData> GraphWriter<TEdgeData>::GraphWriter(void)
+    template <typename TEdgeData> GraphWriter<TEdgeData>::GraphWriter(void) : useParallelFormatting(true), numPartitions(1), useHashPartitioning(false), useDirectIO(false), directIOQueueDepth(DirectFile::kDefaultQueueDepth), compressionFormat(CompressingFile::CompressionFormatNone), compressionLevel(0), numCompressionThreads(CompressingFile::kDefaultNumThreads), numWriteBuffers(kGraphWriteBufferCount), writeBufferSize(kGraphWriteBufferSize), numConsumerThreads(0), partition(), partitionEdges(), secondaryGraphFile(NULL), streamedGraphFile(NULL), streamedGraph(NULL), streamedNumVertices(0), streamedNumEdges(0), streamedFormattedShards(NULL), streamedFormattedShardsIndices(NULL), streamedWriteResult(EGraphResult::GraphResultSuccess), formatErrorDetected(false)
     {
-        // Nothing to do here.
+        // Until told otherwise, each writer object writes the whole graph.
+        partition.numPartitions = 1;
     }
 
     // --------
@@ -61,30 +329,188 @@ namespace GraphTool
     // -------- CLASS METHODS ---------------------------------------------- //
     // See "GraphWriter.h" for documentation.
 
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::DividePartitions(const VertexIndex& vertexIndex, const uint32_t numPartitions, const bool hashed, std::vector<SGraphPartition>& partitions)
+    {
+        const TVertexCount numVertices = vertexIndex.GetNumVertices();
+        
+        partitions.assign(numPartitions, SGraphPartition());
+        
+        for (uint32_t i = 0; i < numPartitions; ++i)
+        {
+            partitions[i].numPartitions = numPartitions;
+            partitions[i].index = i;
+            partitions[i].hashed = hashed;
+            partitions[i].vertexStart = 0;
+            partitions[i].vertexEnd = numVertices;
+            partitions[i].numEdges = 0;
+        }
+        
+        if (hashed)
+        {
+            for (TVertexID vertex = 0; vertex < numVertices; ++vertex)
+                partitions[SGraphPartition::HashVertex(vertex, numPartitions)].numEdges += vertexIndex.GetDegree(vertex);
+            
+            return;
+        }
+        
+        // Each range ends at the vertex boundary closest to its share of the edges, and the last range also includes any remaining vertices.
+        TEdgeCount numEdges = 0;
+        
+        for (TVertexID vertex = 0; vertex < numVertices; ++vertex)
+            numEdges += vertexIndex.GetDegree(vertex);
+        
+        TVertexID vertex = 0;
+        TEdgeCount edgesBeforeVertex = 0;
+        
+        for (uint32_t i = 0; i < numPartitions; ++i)
+        {
+            const TEdgeCount edgesBeforePartition = edgesBeforeVertex;
+            const TEdgeCount edgesBeforeNextPartition = (TEdgeCount)(((uint64_t)numEdges * (uint64_t)(i + 1)) / (uint64_t)numPartitions);
+            
+            while (vertex < numVertices)
+            {
+                const TEdgeCount degree = vertexIndex.GetDegree(vertex);
+                
+                if (((i + 1) < numPartitions) && (((edgesBeforeVertex << 1) + degree) > (edgesBeforeNextPartition << 1)))
+                    break;
+                
+                edgesBeforeVertex += degree;
+                vertex += 1;
+            }
+            
+            partitions[i].vertexStart = ((0 == i) ? 0 : partitions[i - 1].vertexEnd);
+            partitions[i].vertexEnd = vertex;
+            partitions[i].numEdges = edgesBeforeVertex - edgesBeforePartition;
+        }
+    }
+    
+    // --------
+
     template <typename TEdgeData> void GraphWriter<TEdgeData>::EdgeConsumer(void* arg)
     {
-        SGraphWriteSpec<TEdgeData>* writeSpec = (SGraphWriteSpec<TEdgeData>*)arg;
-        uint32_t currentBufferIndex = 0;
+        SGraphWriteTarget<TEdgeData>* writeTarget = (SGraphWriteTarget<TEdgeData>*)arg;
+        SGraphWriteSpec<TEdgeData>* writeSpec = writeTarget->writeSpec;
+        uint64_t sequence = 0;
+        uint64_t stallTime = 0;
+        uint64_t writeTime = 0;
 
         // Iteratively consume edges that the edge producer loads into the edge buffers.
         while (true)
         {
             // Wait for the buffer to be filled with edges.
-            spindleBarrierGlobal();
+            const uint32_t currentBufferIndex = writeSpec->ring->BufferIndex(sequence);
+            stallTime += writeSpec->ring->WaitForPublishedBuffer(sequence);
 
-            // Check for termination or I/O errors detected previously.
-            if (0 == writeSpec->counts[currentBufferIndex] || EGraphResult::GraphResultSuccess != writeSpec->writeResult)
+            // Check for termination.
+            if (0 == writeSpec->counts[currentBufferIndex])
                 break;
 
-            // Consume the buffer and write edges to the file.
-            writeSpec->writer->WriteEdgesToFile(writeSpec->file, *writeSpec->graph, writeSpec->bufs[currentBufferIndex], writeSpec->counts[currentBufferIndex], writeSpec->groupedByDestination, writeSpec->currentPass);
+            // Consume the buffer and write edges to the file, unless I/O errors were detected previously.
+            // Consumers of other files may still be writing, so this consumer must keep releasing buffers to the edge producer either way.
+            if (EGraphResult::GraphResultSuccess == writeTarget->writeResult)
+            {
+                const uint64_t writeStartTime = Statistics::GetTimestamp();
+                const SEdge<TEdgeData>* edges = writeSpec->bufs[currentBufferIndex];
+                size_t edgeCount = (size_t)writeSpec->counts[currentBufferIndex];
+                
+                if (1 < writeTarget->writer->partition.numPartitions)
+                    edges = writeTarget->writer->SelectPartitionEdges(edges, edgeCount, writeSpec->groupedByDestination, edgeCount);
+                
+                if (0 != edgeCount)
+                    writeTarget->writer->WriteEdgesToFile(writeTarget->file, *writeSpec->graph, edges, edgeCount, writeSpec->groupedByDestination, writeSpec->currentPass);
+                
+                writeTime += Statistics::GetTimestamp() - writeStartTime;
+
+                // Check for any errors, either in the data or during I/O.
+                if (writeTarget->writer->formatErrorDetected)
+                    FailGraphWriteTarget(writeTarget, EGraphResult::GraphResultErrorFormat);
+                else if (ferror(writeTarget->file) || ((NULL != writeTarget->writer->secondaryGraphFile) && ferror(writeTarget->writer->secondaryGraphFile)))
+                    FailGraphWriteTarget(writeTarget, EGraphResult::GraphResultErrorIO);
+            }
+
+            // Hand the buffer back to the edge producer and move on to the next one, which may already be filled.
+            writeSpec->ring->Release(writeTarget->consumerIndex, sequence);
+            sequence += 1;
+        }
+        
+        Statistics::AddPhaseDetailTime("consumer stall", stallTime);
+        Statistics::AddPhaseDetailTime("format and write", writeTime);
+    }
 
-            // Check for any I/O errors.
-            if (ferror(writeSpec->file))
-                writeSpec->writeResult = EGraphResult::GraphResultErrorIO;
+    // --------
 
-            // Switch to the other buffer to consume in parallel with edge production.
-            currentBufferIndex = (~currentBufferIndex) & 1;
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::EdgeFormatConsumer(void* arg)
+    {
+        SGraphWriteTarget<TEdgeData>* writeTarget = (SGraphWriteTarget<TEdgeData>*)arg;
+        SGraphWriteSpec<TEdgeData>* writeSpec = writeTarget->writeSpec;
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        uint64_t sequence = 0;
+        uint32_t currentShardsIndex = 0;
+        uint64_t stallTime = 0;
+        uint64_t writeTime = 0;
+        
+        if (0 == localThreadID)
+            writeTarget->formattedShards = new std::vector<char>[localThreadCount << 2];
+        
+        spindleBarrierLocal();
+        
+        // Iteratively consume edges that the edge producer loads into the edge buffers.
+        while (true)
+        {
+            // Wait for the buffer to be filled with edges.
+            const uint32_t currentBufferIndex = writeSpec->ring->BufferIndex(sequence);
+            stallTime += writeSpec->ring->WaitForPublishedBuffer(sequence);
+            
+            // Check for termination.
+            if (0 == writeSpec->counts[currentBufferIndex])
+                break;
+            
+            // Format and write the buffer, checking for any I/O errors, unless I/O errors were detected previously.
+            // Consumers of other files may still be writing, so this consumer must keep releasing buffers to the edge producer either way.
+            if (EGraphResult::GraphResultSuccess == writeTarget->writeResult)
+            {
+                const uint64_t writeStartTime = Statistics::GetTimestamp();
+                const SEdge<TEdgeData>* edges = writeSpec->bufs[currentBufferIndex];
+                size_t edgeCount = (size_t)writeSpec->counts[currentBufferIndex];
+                
+                // The first thread selects the edges of the partition on behalf of all of them.
+                if (1 < writeTarget->writer->partition.numPartitions)
+                {
+                    if (0 == localThreadID)
+                        writeTarget->partitionBuf = writeTarget->writer->SelectPartitionEdges(edges, edgeCount, writeSpec->groupedByDestination, writeTarget->partitionCount);
+                    
+                    spindleBarrierLocal();
+                    
+                    edges = writeTarget->partitionBuf;
+                    edgeCount = writeTarget->partitionCount;
+                }
+                
+                if (!(writeTarget->writer->ParallelFormatEdgesToFile(writeTarget->file, *writeSpec->graph, edges, edgeCount, writeSpec->groupedByDestination, writeSpec->currentPass, writeTarget->formattedShards, currentShardsIndex)))
+                    FailGraphWriteTarget(writeTarget, EGraphResult::GraphResultErrorIO);
+                
+                writeTime += Statistics::GetTimestamp() - writeStartTime;
+            }
+            
+            // Hand the buffer back to the edge producer once every consumer thread is done with it, which also ensures all of them see the same result before the next buffer.
+            spindleBarrierLocal();
+            
+            if (0 == localThreadID)
+                writeSpec->ring->Release(writeTarget->consumerIndex, sequence);
+            
+            sequence += 1;
+        }
+        
+        spindleBarrierLocal();
+        
+        if (0 == localThreadID)
+        {
+            delete[] writeTarget->formattedShards;
+            writeTarget->formattedShards = NULL;
+            
+            // The first consumer thread reports on behalf of all of them, since they all proceed in lock-step.
+            Statistics::AddPhaseDetailTime("consumer stall", stallTime);
+            Statistics::AddPhaseDetailTime("format and write", writeTime);
         }
     }
 
@@ -93,11 +519,95 @@ namespace GraphTool
     template <typename TEdgeData> void GraphWriter<TEdgeData>::EdgeProducer(void* arg)
     {
         SGraphWriteSpec<TEdgeData>* writeSpec = (SGraphWriteSpec<TEdgeData>*)arg;
-        uint32_t currentBufferIndex = 0;
+        uint64_t sequence = 0;
+        uint64_t stallTime = 0;
+        uint64_t fillTime = 0;
         
-        const size_t writeBufferCount = (kGraphWriteBufferSize / sizeof(SEdge<TEdgeData>));
+        const size_t writeBufferCount = (size_t)writeSpec->bufCapacity;
         const VertexIndex& vertexIndex = (writeSpec->groupedByDestination ? writeSpec->graph->VertexIndexDestination() : writeSpec->graph->VertexIndexSource());
         
+        // An edge source supplies edges already in order, so each buffer is filled by the source without consulting the vertex index.
+        if (NULL != writeSpec->edgeSource)
+        {
+            while (true)
+            {
+                // Wait for the consumers of every file to finish with whatever the buffer previously held.
+                const uint32_t currentBufferIndex = writeSpec->ring->BufferIndex(sequence);
+                stallTime += writeSpec->ring->WaitForFreeBuffer(sequence);
+                
+                // Fill the buffer with edges, leaving it empty to signal termination if no file still needs them.
+                const uint64_t fillStartTime = Statistics::GetTimestamp();
+                const TEdgeCount edgeIdx = (IsGraphWritePassActive(writeSpec) ? (TEdgeCount)writeSpec->edgeSource->fillFunc(writeSpec->edgeSource->arg, writeSpec->bufs[currentBufferIndex], writeBufferCount) : 0);
+                
+                writeSpec->counts[currentBufferIndex] = edgeIdx;
+                fillTime += Statistics::GetTimestamp() - fillStartTime;
+                
+                // Make the buffer available to the consumers.
+                writeSpec->ring->Publish(sequence);
+                
+                // Check for termination.
+                if (0 == edgeIdx)
+                    break;
+                
+                sequence += 1;
+            }
+            
+            Statistics::AddPhaseDetailTime("fill buffers", fillTime);
+            Statistics::AddPhaseDetailTime("producer stall", stallTime);
+            return;
+        }
+        
+        // A frozen vertex index holds its edges in contiguous arrays, which can be traversed directly.
+        if (vertexIndex.IsFrozen())
+        {
+            const TVertexCount numVertices = vertexIndex.GetNumVertices();
+            const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+            const TEdgeCount numEdges = offsets[numVertices];
+            
+            TVertexID topLevelVertex = 0;
+            TEdgeID edge = 0;
+            
+            while (true)
+            {
+                // Wait for the consumers of every file to finish with whatever the buffer previously held.
+                const uint32_t currentBufferIndex = writeSpec->ring->BufferIndex(sequence);
+                stallTime += writeSpec->ring->WaitForFreeBuffer(sequence);
+                
+                // Fill the buffer with edges, leaving it empty to signal termination if no file still needs them.
+                const uint64_t fillStartTime = Statistics::GetTimestamp();
+                const bool passActive = IsGraphWritePassActive(writeSpec);
+                TEdgeCount edgeIdx = 0;
+                
+                while (passActive && (edgeIdx < writeBufferCount) && (edge < numEdges))
+                {
+                    while (offsets[topLevelVertex + 1] <= edge)
+                        topLevelVertex += 1;
+                    
+                    const TEdgeID bufferEdgesEnd = edge + (writeBufferCount - edgeIdx);
+                    const TEdgeID vertexEdgesEnd = ((offsets[topLevelVertex + 1] < bufferEdgesEnd) ? offsets[topLevelVertex + 1] : bufferEdgesEnd);
+                    
+                    for (; edge < vertexEdgesEnd; ++edge, ++edgeIdx)
+                        vertexIndex.FillFrozenEdge(edge, writeSpec->bufs[currentBufferIndex][edgeIdx], topLevelVertex, writeSpec->groupedByDestination);
+                }
+                
+                writeSpec->counts[currentBufferIndex] = edgeIdx;
+                fillTime += Statistics::GetTimestamp() - fillStartTime;
+                
+                // Make the buffer available to the consumers.
+                writeSpec->ring->Publish(sequence);
+                
+                // Check for termination.
+                if (0 == edgeIdx)
+                    break;
+                
+                sequence += 1;
+            }
+            
+            Statistics::AddPhaseDetailTime("fill buffers", fillTime);
+            Statistics::AddPhaseDetailTime("producer stall", stallTime);
+            return;
+        }
+        
         TVertexID topLevelVertex = 0;
         
         while ((topLevelVertex < writeSpec->graph->GetNumVertices()) && (NULL == vertexIndex[topLevelVertex]))
@@ -107,10 +617,16 @@ namespace GraphTool
         
         while (true)
         {
-            // Fill the buffer with edges.
+            // Wait for the consumers of every file to finish with whatever the buffer previously held.
+            const uint32_t currentBufferIndex = writeSpec->ring->BufferIndex(sequence);
+            stallTime += writeSpec->ring->WaitForFreeBuffer(sequence);
+            
+            // Fill the buffer with edges, leaving it empty to signal termination if no file still needs them.
+            const uint64_t fillStartTime = Statistics::GetTimestamp();
+            const bool passActive = IsGraphWritePassActive(writeSpec);
             TEdgeCount edgeIdx = 0;
         
-            while ((edgeIdx < writeBufferCount) && (topLevelVertex < writeSpec->graph->GetNumVertices()))
+            while (passActive && (edgeIdx < writeBufferCount) && (topLevelVertex < writeSpec->graph->GetNumVertices()))
             {
                 // Write out the edge.
                 vertexIndex[topLevelVertex]->FillEdge(edgeIter, writeSpec->bufs[currentBufferIndex][edgeIdx], topLevelVertex, writeSpec->groupedByDestination);
@@ -132,103 +648,918 @@ namespace GraphTool
             }
             
             writeSpec->counts[currentBufferIndex] = edgeIdx;
+            fillTime += Statistics::GetTimestamp() - fillStartTime;
         
-            // Synchronize with the consumer.
-            spindleBarrierGlobal();
+            // Make the buffer available to the consumers.
+            writeSpec->ring->Publish(sequence);
         
-            // Check for termination or I/O errors.
-            if (0 == writeSpec->counts[currentBufferIndex] || EGraphResult::GraphResultSuccess != writeSpec->writeResult)
+            // Check for termination.
+            if (0 == edgeIdx)
                 break;
         
-            // Switch to the other buffer to read from file during a consumption operation.
-            currentBufferIndex = (~currentBufferIndex) & 1;
+            sequence += 1;
         }
+        
+        Statistics::AddPhaseDetailTime("fill buffers", fillTime);
+        Statistics::AddPhaseDetailTime("producer stall", stallTime);
     }
 
-    // -------- ABSTRACT INSTANCE METHODS ---------------------------------- //
-    // See "GraphWriter.h" for documentation.
+    // --------
     
-    template <typename TEdgeData> unsigned int GraphWriter<TEdgeData>::NumberOfPassesRequired(void)
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::WriteGraphFromEdgeSource(GraphWriter<TEdgeData>* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, const SGraphEdgeSource<TEdgeData>& edgeSource, EGraphResult* results)
     {
-        return 1;
+        WriteGraphWithWriters(writers, filenames, numWriters, graph, groupedByDestination, &edgeSource, results);
     }
     
+    // --------
     
-    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
-    // See "GraphWriter.h" for documentation.
-
-    template <typename TEdgeData> EGraphResult GraphWriter<TEdgeData>::WriteGraphToFile(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::WriteGraphWithWriters(GraphWriter<TEdgeData>* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, const SGraphEdgeSource<TEdgeData>* edgeSource, EGraphResult* results)
     {
         // First, verify edge data type compatibility.
         if (false == graph.DoesEdgeDataTypeMatch<TEdgeData>())
-            return EGraphResult::GraphResultErrorFormat;
+        {
+            for (size_t i = 0; i < numWriters; ++i)
+                results[i] = EGraphResult::GraphResultErrorFormat;
+            
+            return;
+        }
         
-        // Second, open the file.
-        FILE* graphfile = this->OpenAndInitializeGraphFileForWrite(filename, graph, groupedByDestination);
-        if (NULL == graphfile)
-            return EGraphResult::GraphResultErrorCannotOpenFile;
-
-        // Allocate some buffers for read data.
-        SEdge<TEdgeData>* bufs[] = { (SEdge<TEdgeData>*)(new uint8_t[kGraphWriteBufferSize]), (SEdge<TEdgeData>*)(new uint8_t[kGraphWriteBufferSize]) };
-        if (NULL == bufs[0] || NULL == bufs[1])
-            return EGraphResult::GraphResultErrorNoMemory;
-
-        // Define the graph write task.
+        // Second, expand each partitioned output into one writer object and one file per partition, all of which are written concurrently with the other files.
+        std::vector<GraphWriter<TEdgeData>*> targetWriters;
+        std::vector<std::string> targetFilenames;
+        std::vector<size_t> targetWriterIndices;
+        std::vector<GraphWriter<TEdgeData>*> partitionWriters;
+        
+        for (size_t i = 0; i < numWriters; ++i)
+        {
+            results[i] = EGraphResult::GraphResultSuccess;
+            
+            // A graph whose edges come from a source holds only degrees, which not every writer can work with.
+            if ((NULL != edgeSource) && !(writers[i]->SupportsEdgeSource()))
+            {
+                results[i] = EGraphResult::GraphResultErrorFormat;
+                continue;
+            }
+            
+            // Summaries are computed directly from the graph, so they take no part in the traversal.
+            if (writers[i]->WritesSummary())
+            {
+                results[i] = writers[i]->WriteSummaryToFile(filenames[i], graph, groupedByDestination);
+                continue;
+            }
+            
+            if (1 == writers[i]->numPartitions)
+            {
+                targetWriters.push_back(writers[i]);
+                targetFilenames.push_back(filenames[i]);
+                targetWriterIndices.push_back(i);
+                continue;
+            }
+            
+            std::vector<SGraphPartition> partitions;
+            DividePartitions((groupedByDestination ? graph.VertexIndexDestination() : graph.VertexIndexSource()), writers[i]->numPartitions, writers[i]->useHashPartitioning, partitions);
+            
+            for (uint32_t j = 0; j < writers[i]->numPartitions; ++j)
+            {
+                char partitionSuffix[16];
+                snprintf(partitionSuffix, sizeof(partitionSuffix) / sizeof(partitionSuffix[0]), ".%u", (unsigned int)j);
+                
+                GraphWriter<TEdgeData>* const partitionWriter = writers[i]->CreatePartitionWriter();
+                partitionWriter->numPartitions = 1;
+                partitionWriter->partition = partitions[j];
+                partitionWriters.push_back(partitionWriter);
+                
+                targetWriters.push_back(partitionWriter);
+                targetFilenames.push_back(std::string(filenames[i]) + partitionSuffix);
+                targetWriterIndices.push_back(i);
+            }
+        }
+        
+        const size_t numTargets = targetWriters.size();
+        
+        if (0 == numTargets)
+            return;
+        
+        // Third, open the files.
+        // A file that cannot be opened is reported as such, without preventing any of the others from being written.
         SGraphWriteSpec<TEdgeData> writeSpec;
-
-        writeSpec.file = graphfile;
+        std::vector<SGraphWriteTarget<TEdgeData>> writeTargets(numTargets);
+        unsigned int numPasses = 0;
+        
+        for (size_t i = 0; i < numTargets; ++i)
+        {
+            SGraphWriteTarget<TEdgeData>& writeTarget = writeTargets[i];
+            
+            targetWriters[i]->formatErrorDetected = false;
+            
+            writeTarget.writeSpec = &writeSpec;
+            writeTarget.file = targetWriters[i]->OpenAndInitializeGraphFileForWrite(targetFilenames[i].c_str(), graph, groupedByDestination);
+            writeTarget.writer = targetWriters[i];
+            writeTarget.consumerIndex = 0;
+            writeTarget.numPasses = targetWriters[i]->NumberOfPassesRequired();
+            writeTarget.formattedShards = NULL;
+            writeTarget.partitionBuf = NULL;
+            writeTarget.partitionCount = 0;
+            writeTarget.writeResult = EGraphResult::GraphResultSuccess;
+            
+            if (NULL == writeTarget.file)
+            {
+                writeTarget.writeResult = EGraphResult::GraphResultErrorCannotOpenFile;
+                continue;
+            }
+            
+            if (targetWriters[i]->formatErrorDetected)
+            {
+                fclose(writeTarget.file);
+                writeTarget.file = NULL;
+                writeTarget.writeResult = EGraphResult::GraphResultErrorFormat;
+                continue;
+            }
+            
+            if (targetWriters[i]->UsesSecondaryGraphFile())
+            {
+                targetWriters[i]->secondaryGraphFile = targetWriters[i]->OpenSecondaryGraphFileForWrite(targetFilenames[i].c_str(), graph, groupedByDestination);
+                
+                if (NULL == targetWriters[i]->secondaryGraphFile)
+                {
+                    fclose(writeTarget.file);
+                    writeTarget.file = NULL;
+                    writeTarget.writeResult = EGraphResult::GraphResultErrorCannotOpenFile;
+                    continue;
+                }
+            }
+            
+            if (writeTarget.numPasses > numPasses)
+                numPasses = writeTarget.numPasses;
+        }
+        
+        // Allocate some buffers for edge data, which are shared by the consumers of all of the files.
+        // Every file is produced from the same buffers, so they are as numerous and as large as any of the writers requested.
+        uint32_t numBufs = kGraphWriteBufferCount;
+        size_t bufSize = kGraphWriteBufferSize;
+        
+        if (0 != numTargets)
+        {
+            numBufs = 1;
+            bufSize = sizeof(SEdge<TEdgeData>);
+            
+            for (size_t i = 0; i < numTargets; ++i)
+            {
+                numBufs = std::max(numBufs, targetWriters[i]->numWriteBuffers);
+                bufSize = std::max(bufSize, targetWriters[i]->writeBufferSize);
+            }
+        }
+        
+        for (uint32_t i = 0; i < numBufs; ++i)
+        {
+            writeSpec.bufs.push_back((SEdge<TEdgeData>*)(new uint8_t[bufSize]));
+            MemoryTracker::RecordAllocation(writeSpec.bufs.back(), bufSize, MemoryTracker::MemoryCategoryWriteBuffers);
+        }
+        
+        // Define the graph write task.
         writeSpec.graph = &graph;
-        writeSpec.writer = this;
-        writeSpec.bufs[0] = bufs[0];
-        writeSpec.bufs[1] = bufs[1];
-        writeSpec.counts[0] = 0;
-        writeSpec.counts[1] = 0;
+        writeSpec.edgeSource = edgeSource;
+        writeSpec.ring = NULL;
+        writeSpec.counts.assign(numBufs, 0);
+        writeSpec.bufCapacity = (TEdgeCount)(bufSize / sizeof(SEdge<TEdgeData>));
         writeSpec.groupedByDestination = groupedByDestination;
-        writeSpec.writeResult = EGraphResult::GraphResultSuccess;
-
-        // Define the parallelization strategy.
-        SSpindleTaskSpec taskSpec[2];
-
-        taskSpec[0].func = &EdgeProducer;
-        taskSpec[0].arg = (void*)&writeSpec;
-        taskSpec[0].numaNode = siloGetNUMANodeForVirtualAddress(bufs[0]);
-        taskSpec[0].numThreads = 1;
-        taskSpec[0].smtPolicy = SpindleSMTPolicyPreferPhysical;
-
-        taskSpec[1].func = &EdgeConsumer;
-        taskSpec[1].arg = (void*)&writeSpec;
-        taskSpec[1].numaNode = siloGetNUMANodeForVirtualAddress(bufs[0]);
-        taskSpec[1].numThreads = 1;
-        taskSpec[1].smtPolicy = SpindleSMTPolicyPreferPhysical;
-
-        // Launch the graph write task.
-        const unsigned int numPasses = NumberOfPassesRequired();
+        writeSpec.targets = writeTargets.data();
+        writeSpec.numTargets = numTargets;
+        
+        // Launch the graph write task once per pass, with a single edge producer and a separate group of consumer threads for each file that needs the pass.
+        // Every buffer is therefore produced once and then consumed for all of the files concurrently.
+        const uint32_t numaNode = (uint32_t)siloGetNUMANodeForVirtualAddress(writeSpec.bufs[0]);
+        std::vector<SSpindleTaskSpec> taskSpecs;
         
         for (unsigned int i = 0; i < numPasses; ++i)
         {
             writeSpec.currentPass = i;
+            taskSpecs.clear();
             
-            const uint32_t spawnResult = spindleThreadsSpawn(taskSpec, sizeof(taskSpec) / sizeof(taskSpec[0]), true);
+            SSpindleTaskSpec producerTaskSpec;
             
-            if ((0 != spawnResult) || (EGraphResult::GraphResultSuccess != writeSpec.writeResult))
+            producerTaskSpec.func = &EdgeProducer;
+            producerTaskSpec.arg = (void*)&writeSpec;
+            producerTaskSpec.numaNode = numaNode;
+            producerTaskSpec.numThreads = 1;
+            producerTaskSpec.smtPolicy = SpindleSMTPolicyPreferPhysical;
+            taskSpecs.push_back(producerTaskSpec);
+            
+            // Writers that support it format edges using multiple threads, since formatting text is much slower than writing it.
+            // A single consumer uses all remaining threads, whereas several consumers share them, with one thread for each writer that does not format in parallel.
+            uint32_t numSerialConsumers = 0;
+            uint32_t numParallelConsumers = 0;
+            
+            for (size_t j = 0; j < numTargets; ++j)
             {
-                fclose(graphfile);
-                delete[] bufs[0];
-                delete[] bufs[1];
-                return (0 == spawnResult) ? writeSpec.writeResult : EGraphResult::GraphResultErrorUnknown;
+                if ((EGraphResult::GraphResultSuccess != writeTargets[j].writeResult) || (writeTargets[j].numPasses <= i))
+                    continue;
+                
+                if (writeTargets[j].writer->useParallelFormatting && writeTargets[j].writer->SupportsParallelFormatting())
+                    numParallelConsumers += 1;
+                else
+                    numSerialConsumers += 1;
             }
-        }
-
-        fclose(graphfile);
-        delete[] bufs[0];
-        delete[] bufs[1];
-        return writeSpec.writeResult;
-    }
-
+            
+            if (0 == (numSerialConsumers + numParallelConsumers))
+                break;
+            
+            // Each file that needs the pass consumes every buffer, so the ring is sized for this pass's consumers and restarts at the first buffer.
+            BufferRing ring(numBufs, numSerialConsumers + numParallelConsumers);
+            
+            writeSpec.ring = &ring;
+            writeSpec.numActiveTargets.store((size_t)(numSerialConsumers + numParallelConsumers), std::memory_order_relaxed);
+            
+            uint32_t numParallelConsumerThreads = 0;
+            
+            if ((numSerialConsumers + numParallelConsumers) > 1)
+            {
+                const uint32_t numThreadsAvailable = topoGetNUMANodeLogicalCoreCount(numaNode);
+                const uint32_t numThreadsRemaining = ((numThreadsAvailable > (numSerialConsumers + 1)) ? (numThreadsAvailable - numSerialConsumers - 1) : 0);
+                
+                if (0 != numParallelConsumers)
+                    numParallelConsumerThreads = ((numThreadsRemaining > numParallelConsumers) ? (numThreadsRemaining / numParallelConsumers) : 1);
+            }
+            
+            for (size_t j = 0; j < numTargets; ++j)
+            {
+                if ((EGraphResult::GraphResultSuccess != writeTargets[j].writeResult) || (writeTargets[j].numPasses <= i))
+                    continue;
+                
+                const bool formatsInParallel = (writeTargets[j].writer->useParallelFormatting && writeTargets[j].writer->SupportsParallelFormatting());
+                const uint32_t numRequestedThreads = writeTargets[j].writer->numConsumerThreads;
+                SSpindleTaskSpec consumerTaskSpec;
+                
+                writeTargets[j].consumerIndex = (uint32_t)(taskSpecs.size() - 1);
+                
+                consumerTaskSpec.func = (formatsInParallel ? &EdgeFormatConsumer : &EdgeConsumer);
+                consumerTaskSpec.arg = (void*)&writeTargets[j];
+                consumerTaskSpec.numaNode = numaNode;
+                consumerTaskSpec.numThreads = (formatsInParallel ? ((0 != numRequestedThreads) ? numRequestedThreads : numParallelConsumerThreads) : 1);
+                consumerTaskSpec.smtPolicy = (formatsInParallel ? SpindleSMTPolicyPreferLogical : SpindleSMTPolicyPreferPhysical);
+                taskSpecs.push_back(consumerTaskSpec);
+            }
+            
+            const EGraphResult spawnResult = NUMASpawner::SpawnTasks(taskSpecs.data(), (uint32_t)taskSpecs.size());
+            
+            if (EGraphResult::GraphResultSuccess != spawnResult)
+            {
+                for (size_t j = 0; j < numTargets; ++j)
+                {
+                    if ((EGraphResult::GraphResultSuccess == writeTargets[j].writeResult) && (writeTargets[j].numPasses > i))
+                        writeTargets[j].writeResult = EGraphResult::GraphResultErrorUnknown;
+                }
+            }
+            
+            writeSpec.ring = NULL;
+        }
+        
+        // Close the files and report the result of writing each of them, or of the first partition that failed to be written.
+        for (size_t i = 0; i < numTargets; ++i)
+        {
+            if (NULL != writeTargets[i].file)
+            {
+                // Buffered data, including anything still being written in the background, only reach the file when it is closed.
+                if ((0 != fclose(writeTargets[i].file)) && (EGraphResult::GraphResultSuccess == writeTargets[i].writeResult))
+                    writeTargets[i].writeResult = EGraphResult::GraphResultErrorIO;
+                
+                // A compressed secondary file is appended to the graph file when closed, so it must be closed last.
+                if (!(writeTargets[i].writer->CloseSecondaryGraphFile()) && (EGraphResult::GraphResultSuccess == writeTargets[i].writeResult))
+                    writeTargets[i].writeResult = EGraphResult::GraphResultErrorIO;
+            }
+            
+            if (EGraphResult::GraphResultSuccess == results[targetWriterIndices[i]])
+                results[targetWriterIndices[i]] = writeTargets[i].writeResult;
+        }
+        
+        for (size_t i = 0; i < partitionWriters.size(); ++i)
+            delete partitionWriters[i];
+        
+        for (size_t i = 0; i < writeSpec.bufs.size(); ++i)
+        {
+            MemoryTracker::RecordRelease(writeSpec.bufs[i]);
+            delete[] (uint8_t*)writeSpec.bufs[i];
+        }
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "GraphWriter.h" for documentation.
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::CloseSecondaryGraphFile(void)
+    {
+        if (NULL == secondaryGraphFile)
+            return true;
+        
+        const bool hadErrors = (0 != ferror(secondaryGraphFile));
+        const bool closeFailed = (0 != fclose(secondaryGraphFile));
+        
+        secondaryGraphFile = NULL;
+        return !(hadErrors || closeFailed);
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> const SEdge<TEdgeData>* GraphWriter<TEdgeData>::SelectPartitionEdges(const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, size_t& selectedCount)
+    {
+        auto topLevelVertex = [groupedByDestination](const SEdge<TEdgeData>& edge) -> TVertexID
+        {
+            return (groupedByDestination ? edge.destinationVertex : edge.sourceVertex);
+        };
+        
+        // The edges of a range are found by binary search, since edges arrive in order of top-level vertex.
+        if (!(partition.hashed))
+        {
+            const SEdge<TEdgeData>* const rangeStart = std::partition_point(buf, &buf[count], [this, &topLevelVertex](const SEdge<TEdgeData>& edge) -> bool
+            {
+                return (topLevelVertex(edge) < partition.vertexStart);
+            });
+            
+            const SEdge<TEdgeData>* const rangeEnd = std::partition_point(rangeStart, &buf[count], [this, &topLevelVertex](const SEdge<TEdgeData>& edge) -> bool
+            {
+                return (topLevelVertex(edge) < partition.vertexEnd);
+            });
+            
+            selectedCount = (size_t)(rangeEnd - rangeStart);
+            return rangeStart;
+        }
+        
+        partitionEdges.clear();
+        
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (partition.ContainsVertex(topLevelVertex(buf[i])))
+                partitionEdges.push_back(buf[i]);
+        }
+        
+        selectedCount = partitionEdges.size();
+        return partitionEdges.data();
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::ParallelFormatEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass, std::vector<char>* const formattedShards, uint32_t& formattedShardsIndex) const
+    {
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        bool writeSucceeded = true;
+        
+        // Each round, every thread formats one shard, after which the first thread writes all of the shards in order.
+        // Shards alternate between two sets so that the other threads can format the next round while the first thread is writing.
+        // The barrier at the end of the next round guarantees that writing is complete before a set is reused.
+        // Each set holds one shard per thread for the graph file followed by one shard per thread for the secondary file.
+        for (size_t roundStart = 0; roundStart < count; roundStart += (kGraphWriteFormatShardSize * localThreadCount))
+        {
+            std::vector<char>* const shards = &formattedShards[(formattedShardsIndex * localThreadCount) << 1];
+            std::vector<char>* const secondaryShards = &shards[localThreadCount];
+            const size_t shardStart = roundStart + (kGraphWriteFormatShardSize * localThreadID);
+            const size_t shardEnd = (((shardStart + kGraphWriteFormatShardSize) < count) ? (shardStart + kGraphWriteFormatShardSize) : count);
+            
+            shards[localThreadID].clear();
+            secondaryShards[localThreadID].clear();
+            
+            if (shardStart < shardEnd)
+                FormatEdgesToBuffer(shards[localThreadID], secondaryShards[localThreadID], graph, &buf[shardStart], shardEnd - shardStart, groupedByDestination, currentPass);
+            
+            spindleBarrierLocal();
+            
+            if (0 == localThreadID)
+            {
+                for (uint32_t i = 0; i < localThreadCount; ++i)
+                {
+                    if (!(shards[i].empty()))
+                        fwrite((void*)shards[i].data(), sizeof(char), shards[i].size(), graphfile);
+                }
+                
+                for (uint32_t i = 0; (i < localThreadCount) && (NULL != secondaryGraphFile); ++i)
+                {
+                    if (!(secondaryShards[i].empty()))
+                        fwrite((void*)secondaryShards[i].data(), sizeof(char), secondaryShards[i].size(), secondaryGraphFile);
+                }
+                
+                if (ferror(graphfile) || ((NULL != secondaryGraphFile) && ferror(secondaryGraphFile)))
+                    writeSucceeded = false;
+            }
+            
+            formattedShardsIndex = (~formattedShardsIndex) & 1;
+        }
+        
+        return writeSucceeded;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> TEdgeCount GraphWriter<TEdgeData>::GetNumEdgesToWrite(const Graph& graph) const
+    {
+        if (NULL != streamedGraph)
+            return streamedNumEdges;
+        
+        return ((1 < partition.numPartitions) ? partition.numEdges : graph.GetNumEdges());
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> TVertexCount GraphWriter<TEdgeData>::GetNumVerticesToWrite(const Graph& graph) const
+    {
+        return ((NULL != streamedGraph) ? streamedNumVertices : graph.GetNumVertices());
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> const SGraphPartition& GraphWriter<TEdgeData>::GetPartition(void) const
+    {
+        return partition;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> FILE* GraphWriter<TEdgeData>::GetSecondaryGraphFile(void) const
+    {
+        return secondaryGraphFile;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::IsGraphFileCompressed(void) const
+    {
+        return (CompressingFile::CompressionFormatNone != compressionFormat);
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> FILE* GraphWriter<TEdgeData>::OpenCompressedGraphFileSectionForWrite(const char* const filename) const
+    {
+        return CompressingFile::OpenForAppendOnClose(filename, compressionFormat, compressionLevel, numCompressionThreads);
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> FILE* GraphWriter<TEdgeData>::OpenGraphFileForWrite(const char* const filename, const bool textMode) const
+    {
+        if (IsGraphFileCompressed())
+            return CompressingFile::OpenForWrite((useDirectIO ? DirectFile::OpenForWrite(filename, directIOQueueDepth) : fopen(filename, "wb")), compressionFormat, compressionLevel, numCompressionThreads);
+        
+        if (textMode)
+            return fopen(filename, "w");
+        
+        if (useDirectIO)
+            return DirectFile::OpenForWrite(filename, directIOQueueDepth);
+        
+        return fopen(filename, "wb");
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::ReportFormatError(void)
+    {
+        formatErrorDetected = true;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::WriteFormattedEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
+    {
+        std::vector<char> output;
+        std::vector<char> secondaryOutput;
+        
+        for (size_t shardStart = 0; shardStart < count; shardStart += kGraphWriteFormatShardSize)
+        {
+            const size_t shardEnd = (((shardStart + kGraphWriteFormatShardSize) < count) ? (shardStart + kGraphWriteFormatShardSize) : count);
+            
+            output.clear();
+            secondaryOutput.clear();
+            FormatEdgesToBuffer(output, secondaryOutput, graph, &buf[shardStart], shardEnd - shardStart, groupedByDestination, currentPass);
+            fwrite((void*)output.data(), sizeof(char), output.size(), graphfile);
+            
+            if ((NULL != secondaryGraphFile) && !(secondaryOutput.empty()))
+                fwrite((void*)secondaryOutput.data(), sizeof(char), secondaryOutput.size(), secondaryGraphFile);
+        }
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::WriteVertexOffsetsToFile(FILE* const file, const VertexIndex& vertexIndex, const TVertexCount numVertices, const TAppendOffsetFunc appendOffset, const size_t offsetSize, const bool appendsEndOffset) const
+    {
+        SVertexOffsetsWriteSpec offsetsWriteSpec;
+        offsetsWriteSpec.file = file;
+        offsetsWriteSpec.vertexIndex = &vertexIndex;
+        offsetsWriteSpec.partition = &partition;
+        offsetsWriteSpec.numVertices = numVertices;
+        offsetsWriteSpec.appendOffset = appendOffset;
+        offsetsWriteSpec.offsetSize = offsetSize;
+        offsetsWriteSpec.appendsEndOffset = appendsEndOffset;
+        offsetsWriteSpec.formattedShards = NULL;
+        offsetsWriteSpec.shardEdgeCounts = NULL;
+        
+        const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelWriteVertexOffsetsFunc, (void*)&offsetsWriteSpec);
+        return ((EGraphResult::GraphResultSuccess == spawnResult) && (0 == ferror(file)));
+    }
+    
+    
+    // -------- ABSTRACT INSTANCE METHODS ---------------------------------- //
+    // See "GraphWriter.h" for documentation.
+    
+    template <typename TEdgeData> unsigned int GraphWriter<TEdgeData>::NumberOfPassesRequired(void)
+    {
+        return 1;
+    }
+    
+    
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "GraphWriter.h" for documentation.
+    
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
+    {
+        // Nothing to do here.
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> FILE* GraphWriter<TEdgeData>::OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        return NULL;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::RequiresBothEdgeGroupings(void) const
+    {
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::SupportsDirectIO(void) const
+    {
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::SupportsParallelFormatting(void) const
+    {
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::SupportsStreaming(void) const
+    {
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::UsesSecondaryGraphFile(void) const
+    {
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> EGraphResult GraphWriter<TEdgeData>::WriteSummaryToFile(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        return EGraphResult::GraphResultErrorUnknown;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::WritesSummary(void) const
+    {
+        return false;
+    }
+    
+    
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphWriter.h" for documentation.
+
+    template <typename TEdgeData> EGraphResult GraphWriter<TEdgeData>::BeginStreamedWrite(const char* const filename, const Graph& graph, const TVertexCount numVertices, const TEdgeCount numEdges)
+    {
+        // First, verify that streaming is possible and that the edges being streamed hold the right type of edge data.
+        if (!(SupportsStreaming()) || (1 < numPartitions) || (false == graph.DoesEdgeDataTypeMatch<TEdgeData>()))
+            return EGraphResult::GraphResultErrorFormat;
+        
+        // Second, open the file, which records the counts supplied here instead of those of the graph.
+        streamedGraph = &graph;
+        streamedNumVertices = numVertices;
+        streamedNumEdges = numEdges;
+        streamedFormattedShards = NULL;
+        streamedFormattedShardsIndices = NULL;
+        streamedWriteResult = EGraphResult::GraphResultSuccess;
+        formatErrorDetected = false;
+        
+        streamedGraphFile = this->OpenAndInitializeGraphFileForWrite(filename, graph, false);
+        
+        if (NULL == streamedGraphFile)
+        {
+            streamedGraph = NULL;
+            return EGraphResult::GraphResultErrorCannotOpenFile;
+        }
+        
+        if (formatErrorDetected)
+        {
+            fclose(streamedGraphFile);
+            streamedGraphFile = NULL;
+            streamedGraph = NULL;
+            return EGraphResult::GraphResultErrorFormat;
+        }
+        
+        return EGraphResult::GraphResultSuccess;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> EGraphResult GraphWriter<TEdgeData>::EndStreamedWrite(void)
+    {
+        if (NULL == streamedGraphFile)
+            return EGraphResult::GraphResultErrorUnknown;
+        
+        if (ferror(streamedGraphFile))
+            streamedWriteResult = EGraphResult::GraphResultErrorIO;
+        
+        if ((0 != fclose(streamedGraphFile)) && (EGraphResult::GraphResultSuccess == streamedWriteResult))
+            streamedWriteResult = EGraphResult::GraphResultErrorIO;
+        
+        if (NULL != streamedFormattedShards)
+            delete[] streamedFormattedShards;
+        
+        if (NULL != streamedFormattedShardsIndices)
+            delete[] streamedFormattedShardsIndices;
+        
+        streamedGraphFile = NULL;
+        streamedGraph = NULL;
+        streamedFormattedShards = NULL;
+        streamedFormattedShardsIndices = NULL;
+        return streamedWriteResult;
+    }
+    
+    // --------
+    
+    template <> EEdgeDataType GraphWriter<void>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeVoid;
+    }
+    
+    // --------
+    
+    template <> EEdgeDataType GraphWriter<uint64_t>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeInteger;
+    }
+    
+    // --------
+    
+    template <> EEdgeDataType GraphWriter<double>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeFloatingPoint;
+    }
+    
+    // --------
+    
+    template <> EEdgeDataType GraphWriter<uint32_t>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeInteger32;
+    }
+    
+    // --------
+    
+    template <> EEdgeDataType GraphWriter<float>::GetEdgeDataType(void) const
+    {
+        return EEdgeDataType::EdgeDataTypeFloatingPoint32;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> uint32_t GraphWriter<TEdgeData>::GetNumPartitions(void) const
+    {
+        return numPartitions;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool GraphWriter<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if ((0 == strcmp(optionName, kWriterOptionFormatter)) && SupportsParallelFormatting())
+        {
+            if (0 == strcmp(optionValue, kWriterOptionFormatterParallel))
+                useParallelFormatting = true;
+            else if (0 == strcmp(optionValue, kWriterOptionFormatterSerial))
+                useParallelFormatting = false;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kWriterOptionPartitions))
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, UINT32_MAX, value))
+                return false;
+            
+            numPartitions = (uint32_t)value;
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kWriterOptionPartitioner))
+        {
+            if (0 == strcmp(optionValue, kWriterOptionPartitionerRange))
+                useHashPartitioning = false;
+            else if (0 == strcmp(optionValue, kWriterOptionPartitionerHash))
+                useHashPartitioning = true;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        if ((0 == strcmp(optionName, kWriterOptionIO)) && SupportsDirectIO() && DirectFile::IsSupported())
+        {
+            if (0 == strcmp(optionValue, kWriterOptionIOBuffered))
+                useDirectIO = false;
+            else if (0 == strcmp(optionValue, kWriterOptionIODirect))
+                useDirectIO = true;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        if ((0 == strcmp(optionName, kWriterOptionIODepth)) && SupportsDirectIO() && DirectFile::IsSupported())
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, DirectFile::kMaxQueueDepth, value))
+                return false;
+            
+            directIOQueueDepth = (uint32_t)value;
+            return true;
+        }
+        
+        if ((0 == strcmp(optionName, kWriterOptionCompression)) && CompressingFile::IsSupported())
+        {
+            if (0 == strcmp(optionValue, kWriterOptionCompressionNone))
+                compressionFormat = CompressingFile::CompressionFormatNone;
+            else if (0 == strcmp(optionValue, kWriterOptionCompressionGzip))
+                compressionFormat = CompressingFile::CompressionFormatGzip;
+            else if (0 == strcmp(optionValue, kWriterOptionCompressionZstd))
+                compressionFormat = CompressingFile::CompressionFormatZstd;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        if ((0 == strcmp(optionName, kWriterOptionCompressLevel)) && CompressingFile::IsSupported())
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, (uint64_t)CompressingFile::kMaxLevel, value))
+                return false;
+            
+            compressionLevel = (int)value;
+            return true;
+        }
+        
+        if ((0 == strcmp(optionName, kWriterOptionCompressThreads)) && CompressingFile::IsSupported())
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, CompressingFile::kMaxNumThreads, value))
+                return false;
+            
+            numCompressionThreads = (uint32_t)value;
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kWriterOptionBuffers))
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, BufferRing::kMaxDepth, value))
+                return false;
+            
+            numWriteBuffers = (uint32_t)value;
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kWriterOptionBufferSize))
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, (kGraphWriteBufferSizeMax >> 20), value))
+                return false;
+            
+            writeBufferSize = (size_t)(value << 20);
+            return true;
+        }
+        
+        if (0 == strcmp(optionName, kWriterOptionThreads))
+        {
+            uint64_t value = 0;
+            
+            if (!ParseNumericOptionValue(optionValue, 1, UINT32_MAX, value))
+                return false;
+            
+            numConsumerThreads = (uint32_t)value;
+            return true;
+        }
+        
+        return false;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::WriteStreamedEdges(const void* const buf, const size_t count)
+    {
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const SEdge<TEdgeData>* const edges = (const SEdge<TEdgeData>*)buf;
+        
+        // Streamed edges are written in the order received, so there is no grouping, and streaming writers require only one pass.
+        if (useParallelFormatting && SupportsParallelFormatting())
+        {
+            if ((0 == localThreadID) && (NULL == streamedFormattedShards))
+            {
+                streamedFormattedShards = new std::vector<char>[spindleGetLocalThreadCount() << 2];
+                streamedFormattedShardsIndices = new uint32_t[spindleGetLocalThreadCount()]();
+            }
+            
+            spindleBarrierLocal();
+            
+            // Each thread keeps its own shard set index, just as when writing a graph, since all threads flip it after every round.
+            if (!(ParallelFormatEdgesToFile(streamedGraphFile, *streamedGraph, edges, count, false, 0, streamedFormattedShards, streamedFormattedShardsIndices[localThreadID])))
+                streamedWriteResult = EGraphResult::GraphResultErrorIO;
+        }
+        else if (0 == localThreadID)
+        {
+            if (EGraphResult::GraphResultSuccess == streamedWriteResult)
+                WriteEdgesToFile(streamedGraphFile, *streamedGraph, edges, count, false, 0);
+            
+            if (formatErrorDetected)
+                streamedWriteResult = EGraphResult::GraphResultErrorFormat;
+            else if (ferror(streamedGraphFile))
+                streamedWriteResult = EGraphResult::GraphResultErrorIO;
+        }
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> EGraphResult GraphWriter<TEdgeData>::WriteGraphToFile(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        GraphWriter<TEdgeData>* const writer = this;
+        EGraphResult writeResult;
+        
+        WriteGraphWithWriters(&writer, &filename, 1, graph, groupedByDestination, NULL, &writeResult);
+        return writeResult;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void GraphWriter<TEdgeData>::WriteGraphToFiles(IGraphWriter* const* writers, const char* const* filenames, const size_t numWriters, const Graph& graph, const bool groupedByDestination, EGraphResult* results)
+    {
+        std::vector<GraphWriter<TEdgeData>*> typedWriters;
+        std::vector<const char*> typedFilenames;
+        std::vector<size_t> typedWriterIndices;
+        
+        // Only writers that hold the same type of edge data as this one can share its edge buffers.
+        for (size_t i = 0; i < numWriters; ++i)
+        {
+            if (GetEdgeDataType() == writers[i]->GetEdgeDataType())
+            {
+                typedWriters.push_back((GraphWriter<TEdgeData>*)writers[i]);
+                typedFilenames.push_back(filenames[i]);
+                typedWriterIndices.push_back(i);
+            }
+            else
+            {
+                results[i] = EGraphResult::GraphResultErrorFormat;
+            }
+        }
+        
+        if (typedWriters.empty())
+            return;
+        
+        std::vector<EGraphResult> typedResults(typedWriters.size());
+        WriteGraphWithWriters(typedWriters.data(), typedFilenames.data(), typedWriters.size(), graph, groupedByDestination, NULL, typedResults.data());
+        
+        for (size_t i = 0; i < typedWriters.size(); ++i)
+            results[typedWriterIndices[i]] = typedResults[i];
+    }
 
     // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
 
     template class GraphWriter<void>;
     template class GraphWriter<uint64_t>;
     template class GraphWriter<double>;
+    template class GraphWriter<uint32_t>;
+    template class GraphWriter<float>;
 }
@@ -10,13 +10,20 @@
  *   Factory for creating IGraphWriter objects of various types.
  *****************************************************************************/
 
+#include "BinaryAdjacencyListWriter.h"
 #include "BinaryEdgeListWriter.h"
+#include "CompressedAdjacencyListWriter.h"
+#include "ExternalGraphWriter.h"
+#include "GAPWriter.h"
+#include "GraphStatsWriter.h"
 #include "GraphWriterFactory.h"
 #include "IGraphWriter.h"
 #include "Matrix32Writer.h"
+#include "Matrix64Writer.h"
 #include "TextAdjacencyListWriter.h"
 #include "TextEdgeListWriter.h"
 #include "Types.h"
+#include "VectorSparseWriter.h"
 #include "XStreamWriter.h"
 
 #include <cstddef>
@@ -31,6 +38,14 @@ namespace GraphTool
 
     /// Maps strings to the internal edge list type.
     static const std::map<std::string, int64_t> graphWriterStrings = {
+        { "binaryadjacencylist",                                            EGraphWriterType::GraphWriterTypeBinaryAdjacencyList },
+        { "binaryAdjacencyList",                                            EGraphWriterType::GraphWriterTypeBinaryAdjacencyList },
+        { "BinaryAdjacencyList",                                            EGraphWriterType::GraphWriterTypeBinaryAdjacencyList },
+
+        { "ligrabinary",                                                    EGraphWriterType::GraphWriterTypeBinaryAdjacencyList },
+        { "ligraBinary",                                                    EGraphWriterType::GraphWriterTypeBinaryAdjacencyList },
+        { "LigraBinary",                                                    EGraphWriterType::GraphWriterTypeBinaryAdjacencyList },
+
         { "binaryedgelist",                                                 EGraphWriterType::GraphWriterTypeBinaryEdgeList },
         { "binaryEdgeList",                                                 EGraphWriterType::GraphWriterTypeBinaryEdgeList },
         { "BinaryEdgeList",                                                 EGraphWriterType::GraphWriterTypeBinaryEdgeList },
@@ -38,6 +53,16 @@ namespace GraphTool
         { "grazelle",                                                       EGraphWriterType::GraphWriterTypeBinaryEdgeList },
         { "Grazelle",                                                       EGraphWriterType::GraphWriterTypeBinaryEdgeList },
 
+        { "compressedadjacencylist",                                        EGraphWriterType::GraphWriterTypeCompressedAdjacencyList },
+        { "compressedAdjacencyList",                                        EGraphWriterType::GraphWriterTypeCompressedAdjacencyList },
+        { "CompressedAdjacencyList",                                        EGraphWriterType::GraphWriterTypeCompressedAdjacencyList },
+
+        { "compressed",                                                     EGraphWriterType::GraphWriterTypeCompressedAdjacencyList },
+        { "Compressed",                                                     EGraphWriterType::GraphWriterTypeCompressedAdjacencyList },
+
+        { "gap",                                                            EGraphWriterType::GraphWriterTypeGAP },
+        { "GAP",                                                            EGraphWriterType::GraphWriterTypeGAP },
+
         { "adjacencygraph",                                                 EGraphWriterType::GraphWriterTypeTextAdjacencyList },
         { "AdjacencyGraph",                                                 EGraphWriterType::GraphWriterTypeTextAdjacencyList },
         { "textadjacencylist",                                              EGraphWriterType::GraphWriterTypeTextAdjacencyList },
@@ -49,6 +74,9 @@ namespace GraphTool
         { "polymer",                                                        EGraphWriterType::GraphWriterTypeTextAdjacencyList },
         { "Polymer",                                                        EGraphWriterType::GraphWriterTypeTextAdjacencyList },
 
+        { "stats",                                                          EGraphWriterType::GraphWriterTypeStats },
+        { "Stats",                                                          EGraphWriterType::GraphWriterTypeStats },
+
         { "textedgelist",                                                   EGraphWriterType::GraphWriterTypeTextEdgeList },
         { "textEdgeList",                                                   EGraphWriterType::GraphWriterTypeTextEdgeList },
         { "TextEdgeList",                                                   EGraphWriterType::GraphWriterTypeTextEdgeList },
@@ -56,10 +84,17 @@ namespace GraphTool
         { "matrix32",                                                       EGraphWriterType::GraphWriterMatrix32 },
         { "Matrix32",                                                       EGraphWriterType::GraphWriterMatrix32 },
 
+        { "matrix64",                                                       EGraphWriterType::GraphWriterMatrix64 },
+        { "Matrix64",                                                       EGraphWriterType::GraphWriterMatrix64 },
+
         { "graphmat",                                                       EGraphWriterType::GraphWriterMatrix32 },
         { "Graphmat",                                                       EGraphWriterType::GraphWriterMatrix32 },
         { "GraphMat",                                                       EGraphWriterType::GraphWriterMatrix32 },
 
+        { "vectorsparse",                                                   EGraphWriterType::GraphWriterTypeVectorSparse },
+        { "vectorSparse",                                                   EGraphWriterType::GraphWriterTypeVectorSparse },
+        { "VectorSparse",                                                   EGraphWriterType::GraphWriterTypeVectorSparse },
+
         { "XStream",                                                        EGraphWriterType::GraphWriterTypeXStream },
         { "Xstream",                                                        EGraphWriterType::GraphWriterTypeXStream },
         { "xstream",                                                        EGraphWriterType::GraphWriterTypeXStream },
@@ -96,11 +131,35 @@ namespace GraphTool
         case EGraphWriterType::GraphWriterMatrix32:
             result = new Matrix32Writer<TEdgeData>;
             break;
+
+        case EGraphWriterType::GraphWriterMatrix64:
+            result = new Matrix64Writer<TEdgeData>;
+            break;
         
         case EGraphWriterType::GraphWriterTypeXStream:
             result = new XStreamWriter<TEdgeData>;
             break;
 
+        case EGraphWriterType::GraphWriterTypeCompressedAdjacencyList:
+            result = new CompressedAdjacencyListWriter<TEdgeData>;
+            break;
+
+        case EGraphWriterType::GraphWriterTypeBinaryAdjacencyList:
+            result = new BinaryAdjacencyListWriter<TEdgeData>;
+            break;
+
+        case EGraphWriterType::GraphWriterTypeGAP:
+            result = new GAPWriter<TEdgeData>;
+            break;
+
+        case EGraphWriterType::GraphWriterTypeVectorSparse:
+            result = new VectorSparseWriter<TEdgeData>;
+            break;
+
+        case EGraphWriterType::GraphWriterTypeStats:
+            result = new GraphStatsWriter<TEdgeData>;
+            break;
+
         default:
             break;
         }
@@ -112,6 +171,52 @@ namespace GraphTool
     // -------- CLASS METHODS ---------------------------------------------- //
     // See "GraphWriterFactory.h" for documentation.
 
+    IGraphWriter* GraphWriterFactory::CreateExternalGraphWriter(SExternalGraphOutput* const outputs, const size_t numOutputs, const uint64_t memoryBudget)
+    {
+        if ((NULL == outputs) || (0 == numOutputs))
+            return NULL;
+        
+        const EEdgeDataType edgedatatype = outputs[0].writer->GetEdgeDataType();
+        
+        for (size_t i = 1; i < numOutputs; ++i)
+        {
+            if (edgedatatype != outputs[i].writer->GetEdgeDataType())
+                return NULL;
+        }
+        
+        IGraphWriter* result = NULL;
+        
+        switch (edgedatatype)
+        {
+        case EEdgeDataType::EdgeDataTypeVoid:
+            result = new ExternalGraphWriter<void>(outputs, numOutputs, memoryBudget);
+            break;
+        
+        case EEdgeDataType::EdgeDataTypeInteger:
+            result = new ExternalGraphWriter<uint64_t>(outputs, numOutputs, memoryBudget);
+            break;
+            
+        case EEdgeDataType::EdgeDataTypeFloatingPoint:
+            result = new ExternalGraphWriter<double>(outputs, numOutputs, memoryBudget);
+            break;
+            
+        case EEdgeDataType::EdgeDataTypeInteger32:
+            result = new ExternalGraphWriter<uint32_t>(outputs, numOutputs, memoryBudget);
+            break;
+            
+        case EEdgeDataType::EdgeDataTypeFloatingPoint32:
+            result = new ExternalGraphWriter<float>(outputs, numOutputs, memoryBudget);
+            break;
+            
+        default:
+            break;
+        }
+        
+        return result;
+    }
+
+    // --------
+
     IGraphWriter* GraphWriterFactory::CreateGraphWriter(EGraphWriterType type, EEdgeDataType edgedatatype)
     {
         IGraphWriter* result = NULL;
@@ -130,6 +235,14 @@ namespace GraphTool
             result = CreateGraphWriterInternal<double>(type);
             break;
             
+        case EEdgeDataType::EdgeDataTypeInteger32:
+            result = CreateGraphWriterInternal<uint32_t>(type);
+            break;
+            
+        case EEdgeDataType::EdgeDataTypeFloatingPoint32:
+            result = CreateGraphWriterInternal<float>(type);
+            break;
+            
         default:
             break;
         }
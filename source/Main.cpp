@@ -10,15 +10,23 @@
 *   Program entry point and primary control flow.
 *****************************************************************************/
 
+#include "ExternalGraphWriter.h"
 #include "Graph.h"
+#include "GraphDelta.h"
 #include "GraphReaderFactory.h"
+#include "GraphSnapshot.h"
 #include "GraphTransformFactory.h"
 #include "GraphWriterFactory.h"
 #include "IGraphReader.h"
 #include "IGraphTransform.h"
 #include "IGraphWriter.h"
+#include "MemoryTracker.h"
+#include "NUMASpawner.h"
 #include "OptionContainer.h"
 #include "Options.h"
+#include "PlatformFunctions.h"
+#include "Statistics.h"
+#include "TransformPipeline.h"
 #include "VersionInfo.h"
 
 #include <cstddef>
@@ -60,8 +68,32 @@ namespace GraphTool
     /// Command-line option that specifies output processing options.
     static const std::string kOptionOutputOptions = "outputoptions";
     
+    /// Command-line option that specifies a delta file of edge insertions and deletions to apply to the graph once it is read.
+    static const std::string kOptionApplyDelta = "applydelta";
+    
+    /// Command-line option that specifies a file to which the graph should be saved as a snapshot, which can later be read back in place of the input file.
+    static const std::string kOptionSaveSnapshot = "savesnapshot";
+    
+    /// Command-line option that specifies that timing and throughput statistics should be collected and printed.
+    static const std::string kOptionStats = "stats";
+    
+    /// Command-line option that specifies a file to which timing and throughput statistics should be written in JSON format.
+    static const std::string kOptionStatsFile = "statsfile";
+    
+    /// Command-line option that specifies that edges should be streamed directly from the input file to the output files.
+    static const std::string kOptionStream = "stream";
+    
+    /// Command-line option that specifies a directory for temporary files, in which case the graph is converted without being built in memory.
+    static const std::string kOptionExternal = "external";
+    
+    /// Command-line option that specifies the amount of memory, in megabytes, that a conversion by way of temporary files may use.
+    static const std::string kOptionMemoryBudget = "memorybudget";
+    
     /// Command-line option that specifies a graph transformation operation.
     static const std::string kOptionTransform = "transform";
+    
+    /// Command-line option that specifies graph transformation options.
+    static const std::string kOptionTransformOptions = "transformoptions";
 
 
     // -------- LOCALS ----------------------------------------------------- //
@@ -74,6 +106,8 @@ namespace GraphTool
         { EEdgeDataType::EdgeDataTypeVoid,                                  "unweighted" },
         { EEdgeDataType::EdgeDataTypeInteger,                               "integer-weighted" },
         { EEdgeDataType::EdgeDataTypeFloatingPoint,                         "floating-point-weighted" },
+        { EEdgeDataType::EdgeDataTypeInteger32,                             "32-bit-integer-weighted" },
+        { EEdgeDataType::EdgeDataTypeFloatingPoint32,                       "single-precision-weighted" },
     };
     
     /// Holds a mapping from graph file result code to error string.
@@ -131,6 +165,17 @@ namespace GraphTool
         { "Floatingpoint",                                                  EEdgeDataType::EdgeDataTypeFloatingPoint },
         { "FloatingPoint",                                                  EEdgeDataType::EdgeDataTypeFloatingPoint },
         { "Double",                                                         EEdgeDataType::EdgeDataTypeFloatingPoint },
+
+        { "int32",                                                          EEdgeDataType::EdgeDataTypeInteger32 },
+        { "uint32",                                                         EEdgeDataType::EdgeDataTypeInteger32 },
+        { "Int32",                                                          EEdgeDataType::EdgeDataTypeInteger32 },
+        { "Uint32",                                                         EEdgeDataType::EdgeDataTypeInteger32 },
+        { "UInt32",                                                         EEdgeDataType::EdgeDataTypeInteger32 },
+
+        { "float32",                                                        EEdgeDataType::EdgeDataTypeFloatingPoint32 },
+        { "single",                                                         EEdgeDataType::EdgeDataTypeFloatingPoint32 },
+        { "Float32",                                                        EEdgeDataType::EdgeDataTypeFloatingPoint32 },
+        { "Single",                                                         EEdgeDataType::EdgeDataTypeFloatingPoint32 },
     };
     
     /// Holds a mapping from command-line option string to output edge grouping value.
@@ -169,7 +214,15 @@ namespace GraphTool
         { kOptionOutputWeights,                                             new EnumOptionContainer(cmdlineEdgeDataTypeStrings, EEdgeDataType::EdgeDataTypeVoid, OptionContainer::kUnlimitedValueCount) },
         { kOptionOutputGrouping,                                            new EnumOptionContainer(cmdlineOutputGroupingEnum, 0ll, OptionContainer::kUnlimitedValueCount) },
         { kOptionOutputOptions,                                             new OptionContainer("", OptionContainer::kUnlimitedValueCount) },
+        { kOptionApplyDelta,                                                new OptionContainer("") },
+        { kOptionSaveSnapshot,                                              new OptionContainer("") },
+        { kOptionStats,                                                     new OptionContainer(false) },
+        { kOptionStatsFile,                                                 new OptionContainer("") },
+        { kOptionStream,                                                    new OptionContainer(false) },
+        { kOptionExternal,                                                  new OptionContainer("") },
+        { kOptionMemoryBudget,                                              new OptionContainer((int64_t)1024) },
         { kOptionTransform,                                                 new EnumOptionContainer(*(GraphTransformFactory::GetGraphTransformStrings()), INT64_MAX, OptionContainer::kUnlimitedValueCount) },
+        { kOptionTransformOptions,                                          new OptionContainer("", OptionContainer::kUnlimitedValueCount) },
     };
     
     /// Dynamically builds the documentation string to use to display help to the user.
@@ -261,6 +314,23 @@ namespace GraphTool
             docstring += "        Prints version information and exits.\n";
         }
         
+        docstring += "  ";
+        docstring += cmdlinePrefixStrings[0];
+        docstring += kOptionApplyDelta;
+        docstring += "=<delta-file>\n";
+        docstring += "        Path of a file of edge insertions and deletions to apply to the graph once it is read.\n";
+        docstring += "        Changes are applied before the graph is saved as a snapshot or transformed.\n";
+        docstring += "        Optional; may be specified at most once.\n";
+        
+        docstring += "  ";
+        docstring += cmdlinePrefixStrings[0];
+        docstring += kOptionExternal;
+        docstring += "=<temp-directory>\n";
+        docstring += "        Directory in which to place temporary files while converting the graph.\n";
+        docstring += "        The graph is never built in memory, so it can be larger than memory.\n";
+        docstring += "        Optional; may be specified at most once.\n";
+        docstring += "        See documentation for supported output formats.\n";
+        
         docstring += "  ";
         docstring += cmdlinePrefixStrings[0];
         docstring += kOptionInputOptions;
@@ -278,6 +348,13 @@ namespace GraphTool
         docstring += "        Optional; may be specified at most once.\n";
         docstring += "        See documentation for supported values and defaults.\n";
         
+        docstring += "  ";
+        docstring += cmdlinePrefixStrings[0];
+        docstring += kOptionMemoryBudget;
+        docstring += "=<megabytes>\n";
+        docstring += "        Amount of memory that a conversion using temporary files may use.\n";
+        docstring += "        Optional; may be specified at most once. Defaults to 1024.\n";
+        
         docstring += "  ";
         docstring += cmdlinePrefixStrings[0];
         docstring += kOptionOutputGrouping;
@@ -304,6 +381,39 @@ namespace GraphTool
         docstring += "        Optional; may be specified at most once per output file.\n";
         docstring += "        See documentation for supported values and defaults.\n";
         
+        docstring += "  ";
+        docstring += cmdlinePrefixStrings[0];
+        docstring += kOptionSaveSnapshot;
+        docstring += "=<snapshot-file>\n";
+        docstring += "        Path of a file to which the graph should be saved as a snapshot once it is read.\n";
+        docstring += "        Snapshots can be read back much faster using the snapshot input format.\n";
+        docstring += "        Optional; may be specified at most once.\n";
+        
+        docstring += "  ";
+        docstring += cmdlinePrefixStrings[0];
+        docstring += kOptionStats;
+        docstring += "=<stats-boolean>\n";
+        docstring += "        Prints timing and throughput statistics for each phase of processing.\n";
+        docstring += "        Optional; may be specified at most once.\n";
+        docstring += "        See documentation for supported values and defaults.\n";
+        
+        docstring += "  ";
+        docstring += cmdlinePrefixStrings[0];
+        docstring += kOptionStatsFile;
+        docstring += "=<stats-file>\n";
+        docstring += "        Path of a file to which timing and throughput statistics should be written.\n";
+        docstring += "        Statistics are written in JSON format, whether or not they are also printed.\n";
+        docstring += "        Optional; may be specified at most once.\n";
+        
+        docstring += "  ";
+        docstring += cmdlinePrefixStrings[0];
+        docstring += kOptionStream;
+        docstring += "=<stream-boolean>\n";
+        docstring += "        Streams edges directly from the input file to the output files.\n";
+        docstring += "        No graph is built, so edges are written in input order.\n";
+        docstring += "        Optional; may be specified at most once.\n";
+        docstring += "        See documentation for supported values and defaults.\n";
+        
         docstring += "  ";
         docstring += cmdlinePrefixStrings[0];
         docstring += kOptionTransform;
@@ -313,9 +423,94 @@ namespace GraphTool
         docstring += "        Optional; may be specified as many times as needed.\n";
         docstring += "        See documentation for supported values and defaults.\n";
         
+        docstring += "  ";
+        docstring += cmdlinePrefixStrings[0];
+        docstring += kOptionTransformOptions;
+        docstring += "=<transform-options-string>\n";
+        docstring += "        Comma-delimited list of transformation options and values.\n";
+        docstring += "        Fine-tunes the behavior of graph transformation operations.\n";
+        docstring += "        Optional; may be specified at most once per transformation operation.\n";
+        docstring += "        See documentation for supported values and defaults.\n";
+        
         return docstring;
     }
     
+    /// Searches a mapping from strings to enumeration values for the first string that maps to a particular value.
+    /// @param [in] enumStrings Mapping to search.
+    /// @param [in] value Enumeration value of interest.
+    /// @return String that maps to the value, or an empty string if there is none.
+    std::string FindEnumString(const std::map<std::string, int64_t>& enumStrings, const int64_t value)
+    {
+        for (auto it = enumStrings.begin(); it != enumStrings.end(); ++it)
+        {
+            if (value == it->second)
+                return it->first;
+        }
+        
+        return "";
+    }
+    
+    /// Determines the size of a file, for the purpose of reporting throughput statistics.
+    /// @param [in] filename Name of the file of interest.
+    /// @return Size of the file in bytes, or 0 if it cannot be determined or statistics are not being collected.
+    uint64_t GetFileSize(const char* const filename)
+    {
+        if (!(Statistics::IsEnabled()))
+            return 0;
+        
+        FILE* file = fopen(filename, "rb");
+        if (NULL == file)
+            return 0;
+        
+        int64_t fileSize = -1;
+        
+        if (0 == fseek64(file, 0, SEEK_END))
+            fileSize = (int64_t)ftell64(file);
+        
+        fclose(file);
+        return ((fileSize > 0) ? (uint64_t)fileSize : 0);
+    }
+    
+    /// Determines the total size of the files that hold the input graph, for the purpose of reporting throughput statistics.
+    /// An input split across several files is named by a directory, a wildcard pattern, or a list file, as expanded by the graph readers.
+    /// @param [in] filename Name of the graph input.
+    /// @return Total size of the files in bytes, excluding any that cannot be determined.
+    uint64_t GetInputSize(const char* const filename)
+    {
+        std::vector<std::string> inputFilenames;
+        uint64_t totalSize = 0;
+        
+        if (!(Statistics::IsEnabled()) || !GraphReaderFactory::ExpandInputFilename(filename, inputFilenames))
+            return 0;
+        
+        for (size_t i = 0; i < inputFilenames.size(); ++i)
+            totalSize += GetFileSize(inputFilenames[i].c_str());
+        
+        return totalSize;
+    }
+    
+    /// Determines the total size of the files produced by a graph writer, for the purpose of reporting throughput statistics.
+    /// A partitioned output is made up of one file per partition, each named by appending a period and the index of the partition.
+    /// @param [in] filename Name of the output file of interest.
+    /// @param [in] writer Graph writer object that produced the output.
+    /// @return Total size of the files in bytes, excluding any that cannot be determined.
+    uint64_t GetOutputFileSize(const char* const filename, const IGraphWriter* const writer)
+    {
+        if (1 == writer->GetNumPartitions())
+            return GetFileSize(filename);
+        
+        uint64_t totalSize = 0;
+        
+        for (uint32_t i = 0; i < writer->GetNumPartitions(); ++i)
+        {
+            char partitionSuffix[16];
+            snprintf(partitionSuffix, sizeof(partitionSuffix) / sizeof(partitionSuffix[0]), ".%u", (unsigned int)i);
+            totalSize += GetFileSize((std::string(filename) + partitionSuffix).c_str());
+        }
+        
+        return totalSize;
+    }
+    
     /// Prints an error message about a graph file operation to the standard error console.
     /// @param [in] cmdline Command-line path to display in the string.
     /// @param [in] filename Filename to display in the string.
@@ -325,6 +520,60 @@ namespace GraphTool
     {
         fprintf(stderr, "%s: Error %s %s: %s.\n", cmdline, (operationIsRead ? "reading" : "writing"), filename, graphErrorStrings.at(code).c_str());
     }
+    
+    /// Splits a comma-delimited options string into individual options and submits each of them to a graph reader or writer.
+    /// Each option is of the form `name=value`, or just `name` if no value is needed.
+    /// Prints an error message to the standard error console if an option is rejected.
+    /// @tparam TOptionTarget Type of object to which options are submitted, which must provide a `SubmitOption` method.
+    /// @param [in] cmdline Command-line path to display in the string.
+    /// @param [in] optionsString Comma-delimited options string to parse.
+    /// @param [in] target Object to which each option should be submitted.
+    /// @return `true` if all options were accepted, `false` otherwise.
+    template <typename TOptionTarget> bool SubmitOptionsString(const char* const cmdline, const std::string& optionsString, TOptionTarget* const target)
+    {
+        size_t position = 0;
+        
+        while (position < optionsString.length())
+        {
+            size_t optionEnd = optionsString.find(',', position);
+            if (std::string::npos == optionEnd)
+                optionEnd = optionsString.length();
+            
+            const std::string option = optionsString.substr(position, optionEnd - position);
+            position = optionEnd + 1;
+            
+            if (option.empty())
+                continue;
+            
+            const size_t separator = option.find('=');
+            const std::string optionName = option.substr(0, separator);
+            const std::string optionValue = ((std::string::npos == separator) ? "" : option.substr(separator + 1));
+            
+            if (!(target->SubmitOption(optionName.c_str(), optionValue.c_str())))
+            {
+                fprintf(stderr, "%s: Unsupported option or value: %s.\n", cmdline, option.c_str());
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    /// Reports all collected timing and throughput statistics, printing a summary to the standard output console, writing them to a file, or both.
+    /// Prints an error message to the standard error console if the file cannot be written.
+    /// @param [in] cmdline Command-line path to display in the string.
+    /// @param [in] printStatistics `true` to print a summary, `false` otherwise.
+    /// @param [in] statisticsFile Name of the file to which to write statistics in JSON format, or an empty string if they should not be written.
+    void ReportStatistics(const char* const cmdline, const bool printStatistics, const std::string& statisticsFile)
+    {
+        Statistics::EndPhase();
+        
+        if (printStatistics)
+            Statistics::PrintSummary();
+        
+        if (!(statisticsFile.empty()) && !(Statistics::WriteToJSONFile(statisticsFile.c_str())))
+            fprintf(stderr, "%s: Error writing statistics file %s.\n", cmdline, statisticsFile.c_str());
+    }
 }
 
 
@@ -455,6 +704,8 @@ int main(const int argc, const char* const argv[])
         return __LINE__;
     
     std::vector<IGraphTransform*> transforms(optionValues->GetValueCount());
+    std::vector<std::string> transformNames(optionValues->GetValueCount());
+    bool transformsReverseEdges = false;
     
     for (size_t i = 0; i < optionValues->GetValueCount(); ++i)
     {
@@ -464,6 +715,10 @@ int main(const int argc, const char* const argv[])
             return __LINE__;
         
         transforms[i] = GraphTransformFactory::CreateGraphTransform((EGraphTransformType)transformTypeEnum);
+        transformNames[i] = FindEnumString(*(GraphTransformFactory::GetGraphTransformStrings()), transformTypeEnum);
+        
+        if (EGraphTransformType::GraphTransformTypeTranspose == (EGraphTransformType)transformTypeEnum)
+            transformsReverseEdges = !transformsReverseEdges;
     }
     
     // Submit input and output options to all of the readers and writers, respectively.
@@ -476,30 +731,322 @@ int main(const int argc, const char* const argv[])
         if (!(optionValues->QueryValue(inputOptions)))
             return __LINE__;
     
-        // TODO: submit reader options
+        if (!(SubmitOptionsString(argv[0], inputOptions, reader)))
+            return __LINE__;
     }
     
     optionValues = commandLineOptions.GetOptionValues(kOptionOutputOptions);
     if (NULL == optionValues)
         return __LINE__;
     
-    for (size_t i = 0; i < optionValues->GetValueCount(); ++i)
+    for (size_t i = 0; i < writers.size(); ++i)
     {
         std::string outputOptions;
         
         if (!(optionValues->QueryValueAt(i, outputOptions)))
             return __LINE__;
         
-        // TODO: submit writer options
+        if (!(SubmitOptionsString(argv[0], outputOptions, writers[i])))
+            return __LINE__;
+    }
+    
+    optionValues = commandLineOptions.GetOptionValues(kOptionTransformOptions);
+    if (NULL == optionValues)
+        return __LINE__;
+    
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+        std::string transformOptions;
+        
+        if (NULL == transforms[i])
+            continue;
+        
+        if (!(optionValues->QueryValueAt(i, transformOptions)))
+            return __LINE__;
+        
+        if (!(SubmitOptionsString(argv[0], transformOptions, transforms[i])))
+            return __LINE__;
+    }
+    
+    // Combine consecutive transformations that operate independently on each edge into pipelines, so that each pipeline traverses the graph only once.
+    // Any other transformation breaks the pipeline and is applied on its own.
+    std::vector<IGraphTransform*> transformStages;
+    std::vector<std::string> transformStageNames;
+    TransformPipeline* transformPipeline = NULL;
+    
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+        if (NULL == transforms[i])
+            continue;
+        
+        if (transforms[i]->CanFuseTransformation() && !(transformStages.empty()) && transformStages.back()->CanFuseTransformation())
+        {
+            if (NULL == transformPipeline)
+            {
+                transformPipeline = new TransformPipeline();
+                transformPipeline->AppendTransform(transformStages.back());
+                transformStages.back() = transformPipeline;
+            }
+            
+            transformPipeline->AppendTransform(transforms[i]);
+            transformStageNames.back() += "+" + transformNames[i];
+        }
+        else
+        {
+            transformStages.push_back(transforms[i]);
+            transformStageNames.push_back(transformNames[i]);
+            transformPipeline = NULL;
+        }
+    }
+    
+    // Enable collection of statistics if they are to be printed or written to a file.
+    optionValues = commandLineOptions.GetOptionValues(kOptionStats);
+    if (NULL == optionValues)
+        return __LINE__;
+    
+    bool printStatistics;
+    if (!(optionValues->QueryValue(printStatistics)))
+        return __LINE__;
+    
+    optionValues = commandLineOptions.GetOptionValues(kOptionStatsFile);
+    if (NULL == optionValues)
+        return __LINE__;
+    
+    std::string statisticsFile;
+    if (!(optionValues->QueryValue(statisticsFile)))
+        return __LINE__;
+    
+    if (printStatistics || !(statisticsFile.empty()))
+        Statistics::Enable();
+    
+    // Get the snapshot file name, if the graph is to be saved as a snapshot.
+    optionValues = commandLineOptions.GetOptionValues(kOptionSaveSnapshot);
+    if (NULL == optionValues)
+        return __LINE__;
+    
+    std::string snapshotFile;
+    if (!(optionValues->QueryValue(snapshotFile)))
+        return __LINE__;
+    
+    // Get the delta file name, if changes are to be applied to the graph.
+    optionValues = commandLineOptions.GetOptionValues(kOptionApplyDelta);
+    if (NULL == optionValues)
+        return __LINE__;
+    
+    std::string deltaFile;
+    if (!(optionValues->QueryValue(deltaFile)))
+        return __LINE__;
+    
+    // Stream edges directly from the input file to the output files, if requested.
+    // This is only possible if edges need not be grouped or transformed and the edge data type does not change.
+    optionValues = commandLineOptions.GetOptionValues(kOptionStream);
+    if (NULL == optionValues)
+        return __LINE__;
+    
+    bool streamEdges;
+    if (!(optionValues->QueryValue(streamEdges)))
+        return __LINE__;
+    
+    // Convert the graph by way of temporary files instead of building it in memory, if requested.
+    // Like streaming, this is only possible if edges need not be transformed and the edge data type does not change, but edges can be grouped either way.
+    optionValues = commandLineOptions.GetOptionValues(kOptionExternal);
+    if (NULL == optionValues)
+        return __LINE__;
+    
+    std::string externalDirectory;
+    if (!(optionValues->QueryValue(externalDirectory)))
+        return __LINE__;
+    
+    if (!(externalDirectory.empty()))
+    {
+        optionValues = commandLineOptions.GetOptionValues(kOptionMemoryBudget);
+        if (NULL == optionValues)
+            return __LINE__;
+        
+        int64_t memoryBudgetMegabytes;
+        if (!(optionValues->QueryValue(memoryBudgetMegabytes)))
+            return __LINE__;
+        
+        if (0 >= memoryBudgetMegabytes)
+        {
+            fprintf(stderr, "%s: Memory budget must be positive.\n", argv[0]);
+            return __LINE__;
+        }
+        
+        if (streamEdges)
+        {
+            fprintf(stderr, "%s: External conversion cannot be combined with streaming.\n", argv[0]);
+            return __LINE__;
+        }
+        
+        for (size_t i = 0; i < transforms.size(); ++i)
+        {
+            if (NULL != transforms[i])
+            {
+                fprintf(stderr, "%s: External conversion does not support transformations.\n", argv[0]);
+                return __LINE__;
+            }
+        }
+        
+        if (!(snapshotFile.empty()))
+        {
+            fprintf(stderr, "%s: External conversion does not support saving a snapshot.\n", argv[0]);
+            return __LINE__;
+        }
+        
+        if (!(deltaFile.empty()))
+        {
+            fprintf(stderr, "%s: External conversion does not support applying a delta.\n", argv[0]);
+            return __LINE__;
+        }
+        
+        std::vector<SExternalGraphOutput> externalOutputs(writers.size());
+        
+        for (size_t i = 0; i < writers.size(); ++i)
+        {
+            if (!(writers[i]->SupportsEdgeSource()) || ((EEdgeDataType)readerEdgeDataTypeEnum != writersEdgeDataType[i]))
+            {
+                fprintf(stderr, "%s: External conversion is not supported for output file %s.\n", argv[0], outputGraphFiles[i].c_str());
+                return __LINE__;
+            }
+            
+            externalOutputs[i].writer = writers[i];
+            externalOutputs[i].filename = outputGraphFiles[i].c_str();
+            externalOutputs[i].groupedByDestination = writerGroupByDestination[i];
+            externalOutputs[i].result = EGraphResult::GraphResultErrorUnknown;
+        }
+        
+        IGraphWriter* const externalWriter = GraphWriterFactory::CreateExternalGraphWriter(externalOutputs.data(), externalOutputs.size(), (uint64_t)memoryBudgetMegabytes * 1048576ull);
+        if (NULL == externalWriter)
+            return __LINE__;
+        
+        // The external writer receives the streamed edges on behalf of all of the output files, and its file name is the directory for temporary files.
+        const char* const externalDirectoryName = externalDirectory.c_str();
+        
+        Statistics::BeginPhase("external");
+        const EGraphResult externalResult = reader->StreamGraphToWriters(inputGraphFile.c_str(), &externalWriter, &externalDirectoryName, 1);
+        Statistics::AddPhaseCounts(GetInputSize(inputGraphFile.c_str()), 0);
+        Statistics::EndPhase();
+        
+        delete externalWriter;
+        
+        if (EGraphResult::GraphResultSuccess != externalResult)
+        {
+            PrintGraphFileError(argv[0], inputGraphFile.c_str(), externalResult, true);
+            return __LINE__;
+        }
+        
+        printf("Converted graph %s using temporary files in %s.\n", inputGraphFile.c_str(), externalDirectory.c_str());
+        
+        for (size_t i = 0; i < writers.size(); ++i)
+        {
+            if (EGraphResult::GraphResultSuccess != externalOutputs[i].result)
+                PrintGraphFileError(argv[0], outputGraphFiles[i].c_str(), externalOutputs[i].result, false);
+            else if (1 < writers[i]->GetNumPartitions())
+                printf("Wrote %s-grouped %s graph %s in %u partitions.\n", (writerGroupByDestination[i] ? "destination" : "source"), edgeDataTypeStrings.at(writersEdgeDataType[i]).c_str(), outputGraphFiles[i].c_str(), (unsigned int)writers[i]->GetNumPartitions());
+            else
+                printf("Wrote %s-grouped %s graph %s.\n", (writerGroupByDestination[i] ? "destination" : "source"), edgeDataTypeStrings.at(writersEdgeDataType[i]).c_str(), outputGraphFiles[i].c_str());
+        }
+        
+        NUMASpawner::ReleaseThreads();
+        ReportStatistics(argv[0], printStatistics, statisticsFile);
+        printf("Exiting.\n");
+        exit(0);
+    }
+    
+    if (streamEdges)
+    {
+        std::vector<const char*> outputGraphFilenames(writers.size());
+        
+        for (size_t i = 0; i < transforms.size(); ++i)
+        {
+            if (NULL != transforms[i])
+            {
+                fprintf(stderr, "%s: Streaming does not support transformations.\n", argv[0]);
+                return __LINE__;
+            }
+        }
+        
+        if (!(snapshotFile.empty()))
+        {
+            fprintf(stderr, "%s: Streaming does not support saving a snapshot.\n", argv[0]);
+            return __LINE__;
+        }
+        
+        if (!(deltaFile.empty()))
+        {
+            fprintf(stderr, "%s: Streaming does not support applying a delta.\n", argv[0]);
+            return __LINE__;
+        }
+        
+        for (size_t i = 0; i < writers.size(); ++i)
+        {
+            if (!(writers[i]->SupportsStreaming()) || (1 < writers[i]->GetNumPartitions()) || writerGroupByDestination[i] || ((EEdgeDataType)readerEdgeDataTypeEnum != writersEdgeDataType[i]))
+            {
+                fprintf(stderr, "%s: Streaming is not supported for output file %s.\n", argv[0], outputGraphFiles[i].c_str());
+                return __LINE__;
+            }
+            
+            outputGraphFilenames[i] = outputGraphFiles[i].c_str();
+        }
+        
+        Statistics::BeginPhase("stream");
+        const EGraphResult streamResult = reader->StreamGraphToWriters(inputGraphFile.c_str(), writers.data(), outputGraphFilenames.data(), writers.size());
+        Statistics::AddPhaseCounts(GetInputSize(inputGraphFile.c_str()), 0);
+        Statistics::EndPhase();
+        
+        if (EGraphResult::GraphResultSuccess != streamResult)
+        {
+            PrintGraphFileError(argv[0], inputGraphFile.c_str(), streamResult, true);
+            return __LINE__;
+        }
+        
+        printf("Streamed graph %s.\n", inputGraphFile.c_str());
+        
+        for (size_t i = 0; i < writers.size(); ++i)
+            printf("Wrote %s graph %s in input order.\n", edgeDataTypeStrings.at(writersEdgeDataType[i]).c_str(), outputGraphFiles[i].c_str());
+        
+        NUMASpawner::ReleaseThreads();
+        ReportStatistics(argv[0], printStatistics, statisticsFile);
+        printf("Exiting.\n");
+        exit(0);
     }
     
-    // Read the input graph.
+    // Read the input graph, building only the groupings of edges that the output graphs need.
+    // Transformations work on whichever groupings are present, and writers build any missing grouping on demand.
+    // Transposing exchanges the two groupings, so if the transformations reverse every edge, the opposite groupings are built instead.
+    // Snapshots hold both groupings, so that they can be read back for any combination of outputs, and some output formats likewise contain both.
     Graph graph;
+    bool needsEdgesByDestination = !(snapshotFile.empty());
+    bool needsEdgesBySource = !(snapshotFile.empty());
+    
+    for (size_t i = 0; i < writers.size(); ++i)
+    {
+        if (writers[i]->RequiresBothEdgeGroupings())
+        {
+            needsEdgesByDestination = true;
+            needsEdgesBySource = true;
+        }
+        else if (writerGroupByDestination[i] != transformsReverseEdges)
+            needsEdgesByDestination = true;
+        else
+            needsEdgesBySource = true;
+    }
+    
+    graph.SetEdgeGroupings(needsEdgesByDestination, needsEdgesBySource);
+    Statistics::BeginPhase("read");
     EGraphResult fileResult = reader->ReadGraphFromFile(inputGraphFile.c_str(), graph);
+    Statistics::AddPhaseCounts(GetInputSize(inputGraphFile.c_str()), (uint64_t)graph.GetNumEdges());
+    Statistics::EndPhase();
     
     if (EGraphResult::GraphResultSuccess != fileResult)
     {
         PrintGraphFileError(argv[0], inputGraphFile.c_str(), fileResult, true);
+        
+        // The reader refuses up front to read a graph that is not expected to fit, in which case streaming may still work because it holds no edges in memory.
+        if ((EGraphResult::GraphResultErrorNoMemory == fileResult) && (0 != MemoryTracker::GetEstimateAvailableBytes()) && (MemoryTracker::GetEstimatedBytes() > MemoryTracker::GetEstimateAvailableBytes()))
+            fprintf(stderr, "%s: Reading is estimated to need %.0f MB but only %.0f MB is available. Consider --%s=true, or the input option memorycheck=off to proceed anyway.\n", argv[0], (double)MemoryTracker::GetEstimatedBytes() / 1048576.0, (double)MemoryTracker::GetEstimateAvailableBytes() / 1048576.0, kOptionStream.c_str());
+        
         return __LINE__;
     }
     else
@@ -507,13 +1054,75 @@ int main(const int argc, const char* const argv[])
         printf("Read graph %s.\n", inputGraphFile.c_str());
         printf("Graph contains %llu vertices and %llu edges.\n", (long long unsigned int)graph.GetNumVertices(), (long long unsigned int)graph.GetNumEdges());
     }
+    
+    // Freeze the graph into its compact representation, which transformations and writers can traverse much more efficiently.
+    Statistics::BeginPhase("freeze");
+    
+    if (EGraphResult::GraphResultSuccess != graph.Freeze())
+    {
+        puts("Failed to freeze graph.");
+        return __LINE__;
+    }
+    
+    Statistics::AddPhaseCounts(0, (uint64_t)graph.GetNumEdges());
+    Statistics::EndPhase();
+    
+    // Apply any changes to the graph, so that the snapshot and the outputs both reflect them.
+    if (!(deltaFile.empty()))
+    {
+        Statistics::BeginPhase(("delta " + deltaFile).c_str());
+        
+        TEdgeCount numInsertions = 0;
+        TEdgeCount numDeletions = 0;
+        fileResult = GraphDelta::ApplyDeltaFromFile(deltaFile.c_str(), graph, numInsertions, numDeletions);
+        
+        Statistics::AddPhaseCounts(GetFileSize(deltaFile.c_str()), (uint64_t)(numInsertions + numDeletions));
+        Statistics::EndPhase();
+        
+        if (EGraphResult::GraphResultSuccess != fileResult)
+        {
+            PrintGraphFileError(argv[0], deltaFile.c_str(), fileResult, true);
+            return __LINE__;
+        }
+        
+        printf("Applied delta %s with %llu insertions and %llu deletions.\n", deltaFile.c_str(), (long long unsigned int)numInsertions, (long long unsigned int)numDeletions);
+        printf("Graph contains %llu vertices and %llu edges.\n", (long long unsigned int)graph.GetNumVertices(), (long long unsigned int)graph.GetNumEdges());
+    }
+    
+    // Save the graph as a snapshot before it is transformed, building any grouping that a snapshot being read did not hold.
+    if (!(snapshotFile.empty()))
+    {
+        Statistics::BeginPhase(("snapshot " + snapshotFile).c_str());
+        
+        fileResult = graph.BuildEdgeGrouping(true);
+        
+        if (EGraphResult::GraphResultSuccess == fileResult)
+            fileResult = graph.BuildEdgeGrouping(false);
+        
+        if (EGraphResult::GraphResultSuccess == fileResult)
+            fileResult = GraphSnapshot::WriteGraphToFile(snapshotFile.c_str(), graph);
+        
+        Statistics::AddPhaseCounts(GetFileSize(snapshotFile.c_str()), (uint64_t)graph.GetNumEdges());
+        Statistics::EndPhase();
+        
+        if (EGraphResult::GraphResultSuccess != fileResult)
+        {
+            PrintGraphFileError(argv[0], snapshotFile.c_str(), fileResult, false);
+            return __LINE__;
+        }
+        
+        printf("Saved snapshot %s.\n", snapshotFile.c_str());
+    }
 
     // Perform transformations.
-    for (size_t i = 0; i < transforms.size(); ++i)
+    for (size_t i = 0; i < transformStages.size(); ++i)
     {
-        if (NULL != transforms[i])
+        if (NULL != transformStages[i])
         {
-            const EGraphResult transformResult = transforms[i]->ApplyTransformation(graph);
+            Statistics::BeginPhase(("transform " + transformStageNames[i]).c_str());
+            const EGraphResult transformResult = transformStages[i]->ApplyTransformation(graph);
+            Statistics::AddPhaseCounts(0, (uint64_t)graph.GetNumEdges());
+            Statistics::EndPhase();
             
             if (EGraphResult::GraphResultSuccess == transformResult)
                 puts("Applied transform.");
@@ -526,20 +1135,128 @@ int main(const int argc, const char* const argv[])
     }
 
     // Write the output graphs.
-    for (size_t i = 0; i < writers.size(); ++i)
+    // Outputs that share the same grouping and type of edge data are written together, sharing a single traversal of the graph.
+    std::vector<EGraphResult> writerResults(writers.size());
+    
+    for (uint32_t grouping = 0; grouping < 2; ++grouping)
     {
-        fileResult = writers[i]->WriteGraphToFile(outputGraphFiles[i].c_str(), graph, writerGroupByDestination[i]);
+        const bool groupedByDestination = (0 != grouping);
+        bool groupingIsNeeded = false;
+        bool oppositeGroupingIsNeeded = false;
+        
+        for (size_t i = 0; i < writers.size(); ++i)
+        {
+            if (groupedByDestination == writerGroupByDestination[i])
+            {
+                groupingIsNeeded = true;
+                
+                if (writers[i]->RequiresBothEdgeGroupings())
+                    oppositeGroupingIsNeeded = true;
+            }
+        }
+        
+        if (!groupingIsNeeded)
+            continue;
+        
+        // Building a grouping is only a separate phase if the grouping was not already present.
+        // Writers that require both groupings read the opposite grouping directly, so it is built as part of the same phase.
+        const bool groupingIsBuilt = !(groupedByDestination ? graph.HasEdgesByDestination() : graph.HasEdgesBySource()) || (oppositeGroupingIsNeeded && !(groupedByDestination ? graph.HasEdgesBySource() : graph.HasEdgesByDestination()));
+        
+        if (groupingIsBuilt)
+            Statistics::BeginPhase(groupedByDestination ? "group by destination" : "group by source");
+        
+        fileResult = graph.BuildEdgeGrouping(groupedByDestination);
+        
+        if ((EGraphResult::GraphResultSuccess == fileResult) && oppositeGroupingIsNeeded)
+            fileResult = graph.BuildEdgeGrouping(!groupedByDestination);
+        
+        if (groupingIsBuilt)
+        {
+            Statistics::AddPhaseCounts(0, (uint64_t)graph.GetNumEdges());
+            Statistics::EndPhase();
+        }
+        
+        for (size_t i = 0; i < writers.size(); ++i)
+        {
+            if ((groupedByDestination == writerGroupByDestination[i]) && (EGraphResult::GraphResultSuccess != fileResult))
+                writerResults[i] = fileResult;
+        }
+        
         if (EGraphResult::GraphResultSuccess != fileResult)
+            continue;
+        
+        for (size_t i = 0; i < writers.size(); ++i)
+        {
+            // Each set of outputs is identified by the first of its writers, and every other writer in the set is skipped once it has been written.
+            bool isFirstInSet = (groupedByDestination == writerGroupByDestination[i]);
+            
+            for (size_t j = 0; (j < i) && isFirstInSet; ++j)
+            {
+                if ((groupedByDestination == writerGroupByDestination[j]) && (writersEdgeDataType[i] == writersEdgeDataType[j]))
+                    isFirstInSet = false;
+            }
+            
+            if (!isFirstInSet)
+                continue;
+            
+            std::vector<IGraphWriter*> setWriters;
+            std::vector<const char*> setOutputGraphFiles;
+            std::vector<size_t> setWriterIndices;
+            
+            for (size_t j = i; j < writers.size(); ++j)
+            {
+                if ((groupedByDestination == writerGroupByDestination[j]) && (writersEdgeDataType[i] == writersEdgeDataType[j]))
+                {
+                    setWriters.push_back(writers[j]);
+                    setOutputGraphFiles.push_back(outputGraphFiles[j].c_str());
+                    setWriterIndices.push_back(j);
+                }
+            }
+            
+            std::string setPhaseName = "write";
+            
+            for (size_t j = 0; j < setOutputGraphFiles.size(); ++j)
+            {
+                setPhaseName += ((0 == j) ? " " : ", ");
+                setPhaseName += setOutputGraphFiles[j];
+            }
+            
+            Statistics::BeginPhase(setPhaseName.c_str());
+            
+            std::vector<EGraphResult> setResults(setWriters.size());
+            writers[i]->WriteGraphToFiles(setWriters.data(), setOutputGraphFiles.data(), setWriters.size(), graph, groupedByDestination, setResults.data());
+            
+            for (size_t j = 0; j < setWriters.size(); ++j)
+            {
+                writerResults[setWriterIndices[j]] = setResults[j];
+                
+                // Throughput counts every file written successfully, since the outputs in a set are produced concurrently.
+                if (EGraphResult::GraphResultSuccess == setResults[j])
+                    Statistics::AddPhaseCounts(GetOutputFileSize(setOutputGraphFiles[j], setWriters[j]), (uint64_t)graph.GetNumEdges());
+            }
+            
+            Statistics::EndPhase();
+        }
+    }
+    
+    for (size_t i = 0; i < writers.size(); ++i)
+    {
+        if (EGraphResult::GraphResultSuccess != writerResults[i])
         {
-            PrintGraphFileError(argv[0], outputGraphFiles[i].c_str(), fileResult, false);
+            PrintGraphFileError(argv[0], outputGraphFiles[i].c_str(), writerResults[i], false);
         }
         else
         {
-            printf("Wrote %s-grouped %s graph %s.\n", (writerGroupByDestination[i] ? "destination" : "source"), edgeDataTypeStrings.at(writersEdgeDataType[i]).c_str(), outputGraphFiles[i].c_str());
+            if (1 < writers[i]->GetNumPartitions())
+                printf("Wrote %s-grouped %s graph %s in %u partitions.\n", (writerGroupByDestination[i] ? "destination" : "source"), edgeDataTypeStrings.at(writersEdgeDataType[i]).c_str(), outputGraphFiles[i].c_str(), (unsigned int)writers[i]->GetNumPartitions());
+            else
+                printf("Wrote %s-grouped %s graph %s.\n", (writerGroupByDestination[i] ? "destination" : "source"), edgeDataTypeStrings.at(writersEdgeDataType[i]).c_str(), outputGraphFiles[i].c_str());
         }
     }
     
     // Print final messages and exit.
+    NUMASpawner::ReleaseThreads();
+    ReportStatistics(argv[0], printStatistics, statisticsFile);
     printf("Exiting.\n");
     exit(0);
 }
@@ -19,38 +19,181 @@
 #include <cstdlib>
 #include <cstdint>
 #include <cstdio>
+#include <immintrin.h>
 
 
 namespace GraphTool
 {
-    // -------- CLASS METHODS ------------------------------------------ //
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Mask that selects the upper 32 bits of a 64-bit value, which must all be zero for the value to fit in 32 bits.
+    static const uint64_t kUpper32BitsMask = 0xffffffff00000000ull;
+
+    /// Smallest floating-point edge weight that does not fit in a 32-bit unsigned integer.
+    static const double kFloatingPointWeightLimit = 4294967296.0;
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Packs a single edge into three 32-bit unsigned integers, for edges that remain once all complete vectors have been packed.
+    /// Matrix format is 1-based, not 0-based, hence the need to add 1 to all vertex identifiers.
+    /// @param [out] packed Location to receive the packed edge.
+    /// @param [in] sourceVertex Zero-based source vertex identifier.
+    /// @param [in] destinationVertex Zero-based destination vertex identifier.
+    /// @param [in] weight Edge weight.
+    /// @return Bitwise OR of all values before narrowing, whose upper 32 bits are zero only if every value fits.
+    static inline uint64_t PackEdge(uint32_t* const packed, const uint64_t sourceVertex, const uint64_t destinationVertex, const uint64_t weight)
+    {
+        packed[0] = (uint32_t)(sourceVertex + 1);
+        packed[1] = (uint32_t)(destinationVertex + 1);
+        packed[2] = (uint32_t)weight;
+
+        return ((sourceVertex + 1) | (destinationVertex + 1) | weight);
+    }
+
+    /// Determines if every 64-bit value that has been bitwise ORed into the specified vector fits in 32 bits.
+    /// @param [in] values Bitwise OR of the values to check.
+    /// @return `true` if the upper 32 bits of every lane are zero, `false` otherwise.
+    static inline bool VectorFitsIn32Bits(const __m256i values)
+    {
+        return (0 != _mm256_testz_si256(values, _mm256_set1_epi64x((long long)kUpper32BitsMask)));
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
     // See "Matrix32Writer.h" for documentation.
-    
-    template <typename TEdgeData> uint32_t Matrix32Writer<TEdgeData>::EdgeWeightFromEdge(const SEdge<TEdgeData>& edge)
+
+    template <> bool Matrix32Writer<void>::PackEdges(uint32_t* const packed, const SEdge<void>* buf, const size_t count)
+    {
+        // Each vector holds two edges, whose vertex identifiers are narrowed into 32-bit lanes 0, 1, 3, and 4 and interleaved with a weight of 1 in lanes 2 and 5.
+        const __m256i vertexOffsets = _mm256_set1_epi64x(1ll);
+        const __m256i packIndices = _mm256_setr_epi32(0, 2, 0, 4, 6, 0, 0, 0);
+        const __m256i weights = _mm256_set1_epi32(1);
+        __m256i overflow = _mm256_setzero_si256();
+        uint64_t remainingOverflow = 0ull;
+        size_t i = 0;
+
+        for (; (i + 2) <= count; i += 2)
+        {
+            const __m256i vertices = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)&buf[i]), vertexOffsets);
+
+            overflow = _mm256_or_si256(overflow, vertices);
+            _mm256_storeu_si256((__m256i*)&packed[3 * i], _mm256_blend_epi32(_mm256_permutevar8x32_epi32(vertices, packIndices), weights, 0x24));
+        }
+
+        for (; i < count; ++i)
+            remainingOverflow |= PackEdge(&packed[3 * i], (uint64_t)buf[i].sourceVertex, (uint64_t)buf[i].destinationVertex, 1ull);
+
+        return (VectorFitsIn32Bits(overflow) && (0ull == (remainingOverflow & kUpper32BitsMask)));
+    }
+
+    // --------
+
+    template <> bool Matrix32Writer<uint64_t>::PackEdges(uint32_t* const packed, const SEdge<uint64_t>* buf, const size_t count)
+    {
+        // Each pair of edges spans 48 bytes, which are loaded as two overlapping vectors that hold the first edge in their lower three lanes and the second edge in their upper three lanes, respectively.
+        // Each edge is narrowed into three 32-bit lanes of its own, and the two are blended together.
+        const __m256i firstOffsets = _mm256_setr_epi64x(1ll, 1ll, 0ll, 0ll);
+        const __m256i secondOffsets = _mm256_setr_epi64x(0ll, 1ll, 1ll, 0ll);
+        const __m256i firstIndices = _mm256_setr_epi32(0, 2, 4, 0, 0, 0, 0, 0);
+        const __m256i secondIndices = _mm256_setr_epi32(0, 0, 0, 2, 4, 6, 0, 0);
+        __m256i overflow = _mm256_setzero_si256();
+        uint64_t remainingOverflow = 0ull;
+        size_t i = 0;
+
+        for (; (i + 2) <= count; i += 2)
+        {
+            const __m256i first = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)&buf[i]), firstOffsets);
+            const __m256i second = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)&buf[i].edgeData), secondOffsets);
+
+            overflow = _mm256_or_si256(overflow, _mm256_or_si256(first, second));
+            _mm256_storeu_si256((__m256i*)&packed[3 * i], _mm256_blend_epi32(_mm256_permutevar8x32_epi32(first, firstIndices), _mm256_permutevar8x32_epi32(second, secondIndices), 0x38));
+        }
+
+        for (; i < count; ++i)
+            remainingOverflow |= PackEdge(&packed[3 * i], (uint64_t)buf[i].sourceVertex, (uint64_t)buf[i].destinationVertex, buf[i].edgeData);
+
+        return (VectorFitsIn32Bits(overflow) && (0ull == (remainingOverflow & kUpper32BitsMask)));
+    }
+
+    // --------
+
+    template <> bool Matrix32Writer<double>::PackEdges(uint32_t* const packed, const SEdge<double>* buf, const size_t count)
+    {
+        // Floating-point weights are truncated to integers, which must be checked individually because negative weights and NaN do not fit either.
+        uint64_t overflow = 0ull;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!((buf[i].edgeData >= 0.0) && (buf[i].edgeData < kFloatingPointWeightLimit)))
+                return false;
+
+            overflow |= PackEdge(&packed[3 * i], (uint64_t)buf[i].sourceVertex, (uint64_t)buf[i].destinationVertex, (uint64_t)buf[i].edgeData);
+        }
+
+        return (0ull == (overflow & kUpper32BitsMask));
+    }
+
+    // --------
+
+    template <> bool Matrix32Writer<uint32_t>::PackEdges(uint32_t* const packed, const SEdge<uint32_t>* buf, const size_t count)
     {
-        return (uint32_t)edge.edgeData;
+        // Weights always fit, so only the vertex identifiers need to be checked.
+        uint64_t overflow = 0ull;
+
+        for (size_t i = 0; i < count; ++i)
+            overflow |= PackEdge(&packed[3 * i], (uint64_t)buf[i].sourceVertex, (uint64_t)buf[i].destinationVertex, (uint64_t)buf[i].edgeData);
+
+        return (0ull == (overflow & kUpper32BitsMask));
     }
 
     // --------
 
-    template <> uint32_t Matrix32Writer<void>::EdgeWeightFromEdge(const SEdge<void>& edge)
+    template <> bool Matrix32Writer<float>::PackEdges(uint32_t* const packed, const SEdge<float>* buf, const size_t count)
     {
-        return 1;
+        uint64_t overflow = 0ull;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!((buf[i].edgeData >= 0.0f) && ((double)buf[i].edgeData < kFloatingPointWeightLimit)))
+                return false;
+
+            overflow |= PackEdge(&packed[3 * i], (uint64_t)buf[i].sourceVertex, (uint64_t)buf[i].destinationVertex, (uint64_t)buf[i].edgeData);
+        }
+
+        return (0ull == (overflow & kUpper32BitsMask));
     }
 
 
     // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
     // See "GraphWriter.h" for documentation.
 
+    template <typename TEdgeData> GraphWriter<TEdgeData>* Matrix32Writer<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new Matrix32Writer<TEdgeData>(*this);
+    }
+
+    // --------
+
     template <typename TEdgeData> FILE* Matrix32Writer<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
     {
+        const TVertexCount numVertices = this->GetNumVerticesToWrite(graph);
+        const TEdgeCount numEdges = this->GetNumEdgesToWrite(graph);
+
         // This class writes files in binary mode.
-        FILE* graphfile = fopen(filename, "wb");
+        FILE* graphfile = this->OpenGraphFileForWrite(filename);
 
         if (NULL != graphfile)
         {
+            // Vertex identifiers are 1-based, so the number of vertices is also the largest identifier written.
+            if ((0ull != ((uint64_t)numVertices & kUpper32BitsMask)) || (0ull != ((uint64_t)numEdges & kUpper32BitsMask)))
+            {
+                this->ReportFormatError();
+                return graphfile;
+            }
+            
             // Write out the number of rows and columns (vertices) and non-zero elements (edges) in the matrix (graph).
-            const uint32_t metadata[3] = { (uint32_t)graph.GetNumVertices(), (uint32_t)graph.GetNumVertices(), (uint32_t)graph.GetNumEdges() };
+            const uint32_t metadata[3] = { (uint32_t)numVertices, (uint32_t)numVertices, (uint32_t)numEdges };
             fwrite((const void*)metadata, sizeof(metadata[0]), sizeof(metadata) / sizeof(metadata[0]), graphfile);
         }
 
@@ -59,15 +202,40 @@ namespace GraphTool
 
     // --------
 
+    template <typename TEdgeData> bool Matrix32Writer<TEdgeData>::SupportsDirectIO(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool Matrix32Writer<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool Matrix32Writer<TEdgeData>::SupportsStreaming(void) const
+    {
+        return true;
+    }
+
+    // --------
+
     template <typename TEdgeData> void Matrix32Writer<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
     {
-        // Write out each edge.
-        // Note that matrix format is 1-based, not 0-based, hence the need to add 1 to all vertex identifiers.
-        for (size_t i = 0; i < count; ++i)
+        // Pack the whole buffer and write it out at once, unless any value would be truncated.
+        if (packedEdges.size() < ((3 * count) + kPackSlack))
+            packedEdges.resize((3 * count) + kPackSlack);
+
+        if (!(PackEdges(packedEdges.data(), buf, count)))
         {
-            const uint32_t edge[3] = { (uint32_t)buf[i].sourceVertex + 1, (uint32_t)buf[i].destinationVertex + 1, EdgeWeightFromEdge(buf[i]) };
-            fwrite((const void*)edge, sizeof(edge[0]), sizeof(edge) / sizeof(edge[0]), graphfile);
+            this->ReportFormatError();
+            return;
         }
+
+        fwrite((const void*)packedEdges.data(), sizeof(packedEdges[0]), 3 * count, graphfile);
     }
 
 
@@ -76,4 +244,6 @@ namespace GraphTool
     template class Matrix32Writer<void>;
     template class Matrix32Writer<uint64_t>;
     template class Matrix32Writer<double>;
+    template class Matrix32Writer<uint32_t>;
+    template class Matrix32Writer<float>;
 }
@@ -0,0 +1,183 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file Matrix64Writer.cpp
+ *   Implementation of a graph writer for binary matrix files.
+ *   Edges and vertices are represented using 64-bit integers.
+ *****************************************************************************/
+
+#include "Matrix64Writer.h"
+#include "Graph.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Smallest floating-point edge weight that does not fit in a 64-bit unsigned integer.
+    static const double kFloatingPointWeightLimit = 18446744073709551616.0;
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "Matrix64Writer.h" for documentation.
+
+    template <> bool Matrix64Writer<void>::PackEdges(uint64_t* const packed, const SEdge<void>* buf, const size_t count)
+    {
+        // Matrix format is 1-based, not 0-based, hence the need to add 1 to all vertex identifiers.
+        for (size_t i = 0; i < count; ++i)
+        {
+            packed[(3 * i) + 0] = (uint64_t)buf[i].sourceVertex + 1;
+            packed[(3 * i) + 1] = (uint64_t)buf[i].destinationVertex + 1;
+            packed[(3 * i) + 2] = 1ull;
+        }
+
+        return true;
+    }
+
+    // --------
+
+    template <> bool Matrix64Writer<uint64_t>::PackEdges(uint64_t* const packed, const SEdge<uint64_t>* buf, const size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            packed[(3 * i) + 0] = (uint64_t)buf[i].sourceVertex + 1;
+            packed[(3 * i) + 1] = (uint64_t)buf[i].destinationVertex + 1;
+            packed[(3 * i) + 2] = buf[i].edgeData;
+        }
+
+        return true;
+    }
+
+    // --------
+
+    template <> bool Matrix64Writer<double>::PackEdges(uint64_t* const packed, const SEdge<double>* buf, const size_t count)
+    {
+        // Floating-point weights are truncated to integers, so negative weights and NaN cannot be represented.
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!((buf[i].edgeData >= 0.0) && (buf[i].edgeData < kFloatingPointWeightLimit)))
+                return false;
+
+            packed[(3 * i) + 0] = (uint64_t)buf[i].sourceVertex + 1;
+            packed[(3 * i) + 1] = (uint64_t)buf[i].destinationVertex + 1;
+            packed[(3 * i) + 2] = (uint64_t)buf[i].edgeData;
+        }
+
+        return true;
+    }
+
+    // --------
+
+    template <> bool Matrix64Writer<uint32_t>::PackEdges(uint64_t* const packed, const SEdge<uint32_t>* buf, const size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            packed[(3 * i) + 0] = (uint64_t)buf[i].sourceVertex + 1;
+            packed[(3 * i) + 1] = (uint64_t)buf[i].destinationVertex + 1;
+            packed[(3 * i) + 2] = (uint64_t)buf[i].edgeData;
+        }
+
+        return true;
+    }
+
+    // --------
+
+    template <> bool Matrix64Writer<float>::PackEdges(uint64_t* const packed, const SEdge<float>* buf, const size_t count)
+    {
+        // Floating-point weights are truncated to integers, so negative weights and NaN cannot be represented.
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!((buf[i].edgeData >= 0.0f) && ((double)buf[i].edgeData < kFloatingPointWeightLimit)))
+                return false;
+
+            packed[(3 * i) + 0] = (uint64_t)buf[i].sourceVertex + 1;
+            packed[(3 * i) + 1] = (uint64_t)buf[i].destinationVertex + 1;
+            packed[(3 * i) + 2] = (uint64_t)buf[i].edgeData;
+        }
+
+        return true;
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphWriter.h" for documentation.
+
+    template <typename TEdgeData> GraphWriter<TEdgeData>* Matrix64Writer<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new Matrix64Writer<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* Matrix64Writer<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        // This class writes files in binary mode.
+        FILE* graphfile = this->OpenGraphFileForWrite(filename);
+
+        if (NULL != graphfile)
+        {
+            // Write out the number of rows and columns (vertices) and non-zero elements (edges) in the matrix (graph).
+            const uint64_t metadata[3] = { (uint64_t)this->GetNumVerticesToWrite(graph), (uint64_t)this->GetNumVerticesToWrite(graph), (uint64_t)this->GetNumEdgesToWrite(graph) };
+            fwrite((const void*)metadata, sizeof(metadata[0]), sizeof(metadata) / sizeof(metadata[0]), graphfile);
+        }
+
+        return graphfile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool Matrix64Writer<TEdgeData>::SupportsDirectIO(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool Matrix64Writer<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool Matrix64Writer<TEdgeData>::SupportsStreaming(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void Matrix64Writer<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        // Pack the whole buffer and write it out at once, unless any edge weight cannot be represented.
+        if (packedEdges.size() < (3 * count))
+            packedEdges.resize(3 * count);
+
+        if (!(PackEdges(packedEdges.data(), buf, count)))
+        {
+            this->ReportFormatError();
+            return;
+        }
+
+        fwrite((const void*)packedEdges.data(), sizeof(packedEdges[0]), 3 * count, graphfile);
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class Matrix64Writer<void>;
+    template class Matrix64Writer<uint64_t>;
+    template class Matrix64Writer<double>;
+    template class Matrix64Writer<uint32_t>;
+    template class Matrix64Writer<float>;
+}
@@ -0,0 +1,211 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file MatrixMarketReader.cpp
+ *   Implementation of a graph reader for Matrix Market coordinate files.
+ *****************************************************************************/
+
+#include "GraphReader.h"
+#include "MatrixMarketReader.h"
+#include "TextEdgeListReader.h"
+#include "Types.h"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace GraphTool
+{
+    // -------- CONSTANTS -------------------------------------------------- //
+
+    /// Banner that begins every Matrix Market file.
+    static const char* const kMatrixMarketBanner = "%%MatrixMarket";
+
+    /// Maximum length of each word of the banner that follows the banner itself.
+    static const size_t kMaxBannerWordLength = 31;
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Converts a string to lowercase in place, since the words of the banner are case-insensitive.
+    /// @param [in,out] str String to convert.
+    static inline void ConvertToLowercase(char* const str)
+    {
+        for (char* c = str; '\0' != *c; ++c)
+            *c = (char)tolower((int)*c);
+    }
+
+    /// Specifies whether or not edge data is read from the file, which is impossible if the file holds only the pattern of the matrix.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, held for each edge.
+    /// @return `true` if edge data is read, `false` otherwise.
+    template <typename TEdgeData> static inline bool ReadsEdgeData(void)
+    {
+        return true;
+    }
+
+    template <> inline bool ReadsEdgeData<void>(void)
+    {
+        return false;
+    }
+
+    /// Parses an unsigned decimal integer and advances past it.
+    /// @param [in,out] position Pointer to the first character to parse, updated to point to the first character after the integer.
+    /// @param [out] value Parsed integer.
+    /// @return `true` if an integer was present, `false` otherwise.
+    static inline bool ParseSizeValue(const char*& position, uint64_t& value)
+    {
+        char* endPos;
+
+        while (isspace((int)*position)) position += 1;
+        if (!isdigit((int)*position))
+            return false;
+
+        value = strtoull(position, &endPos, 10);
+        position = endPos;
+        return true;
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "MatrixMarketReader.h" for documentation.
+
+    template <typename TEdgeData> MatrixMarketReader<TEdgeData>::MatrixMarketReader(void) : TextEdgeListReader<TEdgeData>(), isSymmetric(false)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "TextEdgeListReader.h" for documentation.
+
+    template <typename TEdgeData> unsigned int MatrixMarketReader<TEdgeData>::MaxEdgesPerLine(void) const
+    {
+        return (isSymmetric ? 2 : 1);
+    }
+
+    // --------
+
+    template <typename TEdgeData> unsigned int MatrixMarketReader<TEdgeData>::ParseEdgesFromLine(const char* const line, const char* const lineEnd, SEdge<TEdgeData>* const edges) const
+    {
+        if (!(this->ParseEdgeLine(line, lineEnd, edges[0])))
+            return 0;
+
+        // Entries are 1-based and must lie within the matrix, so that every vertex identifier is less than the number of vertices.
+        // Entries that do not are skipped, which is detected as an edge count mismatch unless the matrix is symmetric.
+        const TVertexCount numVertices = GraphReader<TEdgeData>::numVerticesInFile;
+
+        if ((0 == edges[0].sourceVertex) || (0 == edges[0].destinationVertex) || (edges[0].sourceVertex > numVertices) || (edges[0].destinationVertex > numVertices))
+            return 0;
+
+        edges[0].sourceVertex -= 1;
+        edges[0].destinationVertex -= 1;
+
+        // Off-diagonal entries of a symmetric matrix also describe the mirrored entry.
+        if (!isSymmetric || (edges[0].sourceVertex == edges[0].destinationVertex))
+            return 1;
+
+        edges[1] = edges[0];
+        edges[1].sourceVertex = edges[0].destinationVertex;
+        edges[1].destinationVertex = edges[0].sourceVertex;
+
+        return 2;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool MatrixMarketReader<TEdgeData>::ReadGraphFileHeader(FILE* const graphfile)
+    {
+        char linebuf[TextEdgeListReader<TEdgeData>::kHeaderLineBufferSize];
+
+        // Parse the banner, which identifies the kind of matrix held in the file.
+        if (!(this->ReadHeaderLine(graphfile, linebuf)) || (0 != strncmp(linebuf, kMatrixMarketBanner, strlen(kMatrixMarketBanner))))
+            return false;
+
+        char object[kMaxBannerWordLength + 1];
+        char format[kMaxBannerWordLength + 1];
+        char field[kMaxBannerWordLength + 1];
+        char symmetry[kMaxBannerWordLength + 1];
+
+        if (4 != sscanf(&linebuf[strlen(kMatrixMarketBanner)], "%31s %31s %31s %31s", object, format, field, symmetry))
+            return false;
+
+        ConvertToLowercase(object);
+        ConvertToLowercase(format);
+        ConvertToLowercase(field);
+        ConvertToLowercase(symmetry);
+
+        // Only sparse matrices of real numbers or integers, or of just the pattern of nonzero entries, describe edges.
+        if ((0 != strcmp(object, "matrix")) || (0 != strcmp(format, "coordinate")))
+            return false;
+
+        if (0 == strcmp(field, "pattern"))
+        {
+            if (ReadsEdgeData<TEdgeData>())
+                return false;
+        }
+        else if ((0 != strcmp(field, "real")) && (0 != strcmp(field, "integer")))
+            return false;
+
+        if (0 == strcmp(symmetry, "general"))
+            isSymmetric = false;
+        else if (0 == strcmp(symmetry, "symmetric"))
+            isSymmetric = true;
+        else
+            return false;
+
+        // Skip comments and blank lines, then parse the size line.
+        do
+        {
+            if (!(this->ReadHeaderLine(graphfile, linebuf)))
+                return false;
+        } while (('%' == linebuf[0]) || ('\0' == linebuf[strspn(linebuf, " \t\r\n")]));
+
+        const char* position = linebuf;
+        uint64_t numRows;
+        uint64_t numColumns;
+        uint64_t numEntries;
+
+        if (!ParseSizeValue(position, numRows) || !ParseSizeValue(position, numColumns) || !ParseSizeValue(position, numEntries))
+            return false;
+
+        // Each entry of a symmetric matrix describes at most two edges, which is the count used to estimate how much memory is needed.
+        GraphReader<TEdgeData>::numVerticesInFile = (TVertexCount)((numRows > numColumns) ? numRows : numColumns);
+        GraphReader<TEdgeData>::numEdgesInFile = (TEdgeCount)(isSymmetric ? (numEntries * 2) : numEntries);
+
+        return true;
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphReader.h" for documentation.
+
+    template <typename TEdgeData> GraphReader<TEdgeData>* MatrixMarketReader<TEdgeData>::CreateShardReader(void) const
+    {
+        return new MatrixMarketReader<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool MatrixMarketReader<TEdgeData>::IsEdgeCountExact(void) const
+    {
+        return !isSymmetric;
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class MatrixMarketReader<void>;
+    template class MatrixMarketReader<uint64_t>;
+    template class MatrixMarketReader<double>;
+    template class MatrixMarketReader<uint32_t>;
+    template class MatrixMarketReader<float>;
+}
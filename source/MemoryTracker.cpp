@@ -0,0 +1,258 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file MemoryTracker.cpp
+ *   Accounting of the large allocations that hold graphs and I/O buffers.
+ *****************************************************************************/
+
+#include "MemoryTracker.h"
+#include "VersionInfo.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#ifdef __PLATFORM_WINDOWS
+#include <windows.h>
+#endif
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Names of the categories, in the order of their enumeration values.
+    static const char* const kMemoryCategoryNames[] = {
+        "edge lists",
+        "vertex index",
+        "read buffers",
+        "write buffers",
+        "vertex id map",
+        "external sort",
+    };
+
+    /// Holds the size and category of each tracked allocation, keyed by address.
+    static std::unordered_map<const void*, std::pair<size_t, MemoryTracker::EMemoryCategory>> trackedAllocations;
+
+    /// Number of bytes currently held by each category.
+    static uint64_t trackedCurrentBytes[MemoryTracker::MemoryCategoryCount] = {};
+
+    /// Largest number of bytes held by each category at once.
+    static uint64_t trackedPeakBytes[MemoryTracker::MemoryCategoryCount] = {};
+
+    /// Number of bytes currently held by all categories.
+    static uint64_t trackedTotalBytes = 0;
+
+    /// Largest number of bytes held by all categories at once.
+    static uint64_t trackedTotalPeakBytes = 0;
+
+    /// Largest number of bytes held by all categories at once during the current interval.
+    static uint64_t trackedIntervalPeakBytes = 0;
+
+    /// Most recent estimate of the memory needed to read a graph.
+    static uint64_t estimatedBytes = 0;
+
+    /// Available memory recorded alongside the most recent estimate.
+    static uint64_t estimateAvailableBytes = 0;
+
+    /// Serializes all updates, which may come from multiple threads.
+    static std::mutex trackerMutex;
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+#ifdef __PLATFORM_LINUX
+    /// Reads a single unsigned integer from the start of a file, such as those exposed by the kernel to describe control groups.
+    /// @param [in] filename Name of the file to read.
+    /// @param [out] value Value read from the file.
+    /// @return `true` if a value was read, `false` if the file does not exist or does not begin with a number, as is the case for a limit of "max".
+    static bool ReadValueFromFile(const char* const filename, uint64_t& value)
+    {
+        FILE* const file = fopen(filename, "r");
+
+        if (NULL == file)
+            return false;
+
+        unsigned long long fileValue = 0;
+        const bool valueRead = (1 == fscanf(file, "%llu", &fileValue));
+
+        fclose(file);
+        value = (uint64_t)fileValue;
+        return valueRead;
+    }
+#endif
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "MemoryTracker.h" for documentation.
+
+    uint64_t MemoryTracker::GetAvailableMemory(void)
+    {
+        uint64_t availableBytes = 0;
+
+#ifdef __PLATFORM_LINUX
+        // Available memory accounts for reclaimable page cache, unlike free memory.
+        FILE* const meminfo = fopen("/proc/meminfo", "r");
+
+        if (NULL != meminfo)
+        {
+            char line[256];
+
+            while (NULL != fgets(line, sizeof(line), meminfo))
+            {
+                unsigned long long availableKilobytes = 0;
+
+                if (1 == sscanf(line, "MemAvailable: %llu kB", &availableKilobytes))
+                {
+                    availableBytes = (uint64_t)availableKilobytes * 1024ull;
+                    break;
+                }
+            }
+
+            fclose(meminfo);
+        }
+
+        // A control group limit, as imposed by container runtimes and job schedulers, is what actually triggers the out-of-memory killer.
+        uint64_t groupLimit = 0;
+        uint64_t groupUsage = 0;
+
+        if (ReadValueFromFile("/sys/fs/cgroup/memory.max", groupLimit) && ReadValueFromFile("/sys/fs/cgroup/memory.current", groupUsage))
+        {
+            const uint64_t groupAvailableBytes = ((groupLimit > groupUsage) ? (groupLimit - groupUsage) : 0);
+
+            if ((0 == availableBytes) || (groupAvailableBytes < availableBytes))
+                availableBytes = groupAvailableBytes;
+        }
+#endif
+
+#ifdef __PLATFORM_WINDOWS
+        MEMORYSTATUSEX memoryStatus;
+        memoryStatus.dwLength = sizeof(memoryStatus);
+
+        if (0 != GlobalMemoryStatusEx(&memoryStatus))
+            availableBytes = (uint64_t)memoryStatus.ullAvailPhys;
+#endif
+
+        return availableBytes;
+    }
+
+    // --------
+
+    const char* MemoryTracker::GetCategoryName(const EMemoryCategory category)
+    {
+        return kMemoryCategoryNames[category];
+    }
+
+    // --------
+
+    uint64_t MemoryTracker::GetCurrentBytes(void)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        return trackedTotalBytes;
+    }
+
+    // --------
+
+    uint64_t MemoryTracker::GetEstimateAvailableBytes(void)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        return estimateAvailableBytes;
+    }
+
+    // --------
+
+    uint64_t MemoryTracker::GetEstimatedBytes(void)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        return estimatedBytes;
+    }
+
+    // --------
+
+    uint64_t MemoryTracker::GetIntervalPeakBytes(void)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        return trackedIntervalPeakBytes;
+    }
+
+    // --------
+
+    uint64_t MemoryTracker::GetPeakBytes(void)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        return trackedTotalPeakBytes;
+    }
+
+    // --------
+
+    uint64_t MemoryTracker::GetPeakBytes(const EMemoryCategory category)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        return trackedPeakBytes[category];
+    }
+
+    // --------
+
+    void MemoryTracker::RecordAllocation(const void* const address, const size_t size, const EMemoryCategory category)
+    {
+        if (NULL == address)
+            return;
+
+        std::lock_guard<std::mutex> lock(trackerMutex);
+
+        trackedAllocations[address] = std::make_pair(size, category);
+        trackedCurrentBytes[category] += (uint64_t)size;
+        trackedTotalBytes += (uint64_t)size;
+
+        if (trackedCurrentBytes[category] > trackedPeakBytes[category])
+            trackedPeakBytes[category] = trackedCurrentBytes[category];
+
+        if (trackedTotalBytes > trackedTotalPeakBytes)
+            trackedTotalPeakBytes = trackedTotalBytes;
+
+        if (trackedTotalBytes > trackedIntervalPeakBytes)
+            trackedIntervalPeakBytes = trackedTotalBytes;
+    }
+
+    // --------
+
+    void MemoryTracker::RecordEstimate(const uint64_t estimatedBytes, const uint64_t availableBytes)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+
+        GraphTool::estimatedBytes = estimatedBytes;
+        estimateAvailableBytes = availableBytes;
+    }
+
+    // --------
+
+    void MemoryTracker::RecordRelease(const void* const address)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        auto allocation = trackedAllocations.find(address);
+
+        if (trackedAllocations.end() == allocation)
+            return;
+
+        trackedCurrentBytes[allocation->second.second] -= (uint64_t)allocation->second.first;
+        trackedTotalBytes -= (uint64_t)allocation->second.first;
+        trackedAllocations.erase(allocation);
+    }
+
+    // --------
+
+    void MemoryTracker::ResetIntervalPeak(void)
+    {
+        std::lock_guard<std::mutex> lock(trackerMutex);
+        trackedIntervalPeakBytes = trackedTotalBytes;
+    }
+}
@@ -0,0 +1,322 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file NUMASpawner.cpp
+ *   Implementation of functionality for creating Spindle parallelized regions
+ *   that span every NUMA node in the system.
+ *****************************************************************************/
+
+#include "NUMASpawner.h"
+#include "Types.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <spindle.h>
+#include <thread>
+#include <topo.h>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- TYPE DEFINITIONS ------------------------------------------- //
+
+    /// Holds the state of the persistent team of threads, which stays inside a single Spindle parallelized region and runs each function handed to it.
+    struct SPersistentTeam
+    {
+        std::thread hostThread;                                             ///< Thread that creates the parallelized region and takes part in it, on behalf of the thread that created the team.
+        std::vector<SSpindleTaskSpec> taskSpecs;                            ///< Specifications of the tasks that make up the parallelized region.
+        std::mutex lock;                                                    ///< Serializes access to the remaining members.
+        std::condition_variable workPosted;                                 ///< Signalled when a function is handed to the team.
+        std::condition_variable workCompleted;                              ///< Signalled when all threads are ready or have finished running a function.
+        TSpindleFunc func;                                                  ///< Function to be run by every thread, or `NULL` to tell the threads to exit.
+        void* arg;                                                          ///< Argument passed to every invocation of the function.
+        uint64_t generation;                                                ///< Number of functions handed to the team so far, by which threads recognize new work.
+        uint32_t numThreads;                                                ///< Number of threads in the team.
+        uint32_t numThreadsIdle;                                            ///< Number of threads that are waiting for work.
+        bool spawnFailed;                                                   ///< Indicates that the parallelized region could not be created.
+    };
+
+
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Persistent team of threads, or `NULL` if it does not currently exist.
+    /// Allocated dynamically so that it is never destroyed while its threads may still be running, such as when the program exits without releasing it.
+    static SPersistentTeam* persistentTeam = NULL;
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Identifies the NUMA nodes on which tasks are created, in the order in which they are created.
+    /// @param [out] numaNodes Filled with the NUMA nodes that have at least one logical core.
+    static void GetNUMANodesWithCores(std::vector<uint32_t>& numaNodes)
+    {
+        const uint32_t numNUMANodes = topoGetSystemNUMANodeCount();
+
+        numaNodes.clear();
+
+        for (uint32_t i = 0; i < numNUMANodes; ++i)
+        {
+            if (0 != topoGetNUMANodeLogicalCoreCount(i))
+                numaNodes.push_back(i);
+        }
+    }
+
+    // --------
+
+    /// Fills in the specifications of tasks that span every NUMA node, one task per NUMA node with one thread per logical core.
+    /// @param [in] func Function that every thread executes.
+    /// @param [in] arg Argument passed to every invocation of the function.
+    /// @param [out] taskSpecs Filled with the task specifications, which is empty if the system topology could not be determined.
+    static void GetTaskSpecsForAllNUMANodes(TSpindleFunc func, void* arg, std::vector<SSpindleTaskSpec>& taskSpecs)
+    {
+        std::vector<uint32_t> numaNodes;
+        GetNUMANodesWithCores(numaNodes);
+
+        taskSpecs.resize(numaNodes.size());
+
+        for (size_t i = 0; i < numaNodes.size(); ++i)
+        {
+            taskSpecs[i].func = func;
+            taskSpecs[i].arg = arg;
+            taskSpecs[i].numaNode = numaNodes[i];
+            taskSpecs[i].numThreads = topoGetNUMANodeLogicalCoreCount(numaNodes[i]);
+            taskSpecs[i].smtPolicy = SpindleSMTPolicyPreferLogical;
+        }
+    }
+
+    // --------
+
+    /// Creates the parallelized region that holds the persistent team of threads and takes part in it, returning once the team is told to exit.
+    /// Runs in the host thread of the team.
+    /// @param [in] team Persistent team.
+    static void PersistentTeamHostFunc(SPersistentTeam* team)
+    {
+        if (0 != spindleThreadsSpawn(team->taskSpecs.data(), (uint32_t)team->taskSpecs.size(), true))
+        {
+            {
+                std::lock_guard<std::mutex> guard(team->lock);
+                team->spawnFailed = true;
+            }
+
+            team->workCompleted.notify_one();
+        }
+    }
+
+    // --------
+
+    /// Runs in every thread of the persistent team, waiting for functions to be handed to the team and running each of them until told to exit.
+    /// @param [in] arg Address of the persistent team.
+    static void PersistentTeamFunc(void* arg)
+    {
+        SPersistentTeam* const team = (SPersistentTeam*)arg;
+        uint64_t lastGeneration = 0;
+
+        while (true)
+        {
+            TSpindleFunc func = NULL;
+            void* funcArg = NULL;
+
+            {
+                std::unique_lock<std::mutex> guard(team->lock);
+
+                team->numThreadsIdle += 1;
+
+                if (team->numThreadsIdle == team->numThreads)
+                    team->workCompleted.notify_one();
+
+                team->workPosted.wait(guard, [team, lastGeneration]() -> bool
+                {
+                    return (team->generation != lastGeneration);
+                });
+
+                lastGeneration = team->generation;
+                func = team->func;
+                funcArg = team->arg;
+            }
+
+            if (NULL == func)
+                break;
+
+            func(funcArg);
+        }
+    }
+
+    // --------
+
+    /// Creates the persistent team of threads, if it does not already exist, and waits for all of its threads to be ready for work.
+    /// @return `true` if the team exists, `false` if it could not be created.
+    static bool StartPersistentTeam(void)
+    {
+        if (NULL != persistentTeam)
+            return true;
+
+        SPersistentTeam* const team = new SPersistentTeam();
+
+        team->func = NULL;
+        team->arg = NULL;
+        team->generation = 0;
+        team->numThreads = NUMASpawner::GetThreadCount();
+        team->numThreadsIdle = 0;
+        team->spawnFailed = false;
+
+        GetTaskSpecsForAllNUMANodes(&PersistentTeamFunc, (void*)team, team->taskSpecs);
+
+        if (team->taskSpecs.empty() || (0 == team->numThreads))
+        {
+            delete team;
+            return false;
+        }
+
+        // The parallelized region lasts as long as the team, so it is created by a separate thread that waits inside it on behalf of the calling thread.
+        team->hostThread = std::thread(&PersistentTeamHostFunc, team);
+
+        bool spawnFailed = false;
+
+        {
+            std::unique_lock<std::mutex> guard(team->lock);
+
+            team->workCompleted.wait(guard, [team]() -> bool
+            {
+                return ((team->numThreadsIdle == team->numThreads) || team->spawnFailed);
+            });
+
+            spawnFailed = team->spawnFailed;
+        }
+
+        if (spawnFailed)
+        {
+            team->hostThread.join();
+            delete team;
+            return false;
+        }
+
+        persistentTeam = team;
+        return true;
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "NUMASpawner.h" for documentation.
+
+    void NUMASpawner::GetCurrentTaskUnitRange(const uint64_t numUnits, uint64_t& rangeStart, uint64_t& rangeEnd)
+    {
+        const uint64_t globalThreadCount = (uint64_t)spindleGetGlobalThreadCount();
+        const uint64_t firstGlobalThreadID = (uint64_t)(spindleGetGlobalThreadID() - spindleGetLocalThreadID());
+        const uint64_t lastGlobalThreadID = firstGlobalThreadID + (uint64_t)spindleGetLocalThreadCount();
+
+        rangeStart = (numUnits * firstGlobalThreadID) / globalThreadCount;
+        rangeEnd = (numUnits * lastGlobalThreadID) / globalThreadCount;
+    }
+
+    // --------
+
+    uint32_t NUMASpawner::GetThreadCount(void)
+    {
+        std::vector<uint32_t> numaNodes;
+        GetNUMANodesWithCores(numaNodes);
+
+        uint32_t numThreads = 0;
+
+        for (auto it = numaNodes.begin(); it != numaNodes.end(); ++it)
+            numThreads += topoGetNUMANodeLogicalCoreCount(*it);
+
+        return numThreads;
+    }
+
+    // --------
+
+    void NUMASpawner::GetUnitRangesByNUMANode(const uint64_t numUnits, std::vector<uint64_t>& rangeStarts, std::vector<uint32_t>& numaNodes)
+    {
+        GetNUMANodesWithCores(numaNodes);
+        rangeStarts.clear();
+
+        const uint64_t globalThreadCount = (uint64_t)GetThreadCount();
+        uint64_t firstGlobalThreadID = 0;
+
+        // Ranges are computed exactly as GetCurrentTaskUnitRange would compute them from within each task.
+        for (auto it = numaNodes.begin(); it != numaNodes.end(); ++it)
+        {
+            rangeStarts.push_back((0 == globalThreadCount) ? 0 : ((numUnits * firstGlobalThreadID) / globalThreadCount));
+            firstGlobalThreadID += (uint64_t)topoGetNUMANodeLogicalCoreCount(*it);
+        }
+    }
+
+    // --------
+
+    void NUMASpawner::ReleaseThreads(void)
+    {
+        if (NULL == persistentTeam)
+            return;
+
+        SPersistentTeam* const team = persistentTeam;
+        persistentTeam = NULL;
+
+        {
+            std::lock_guard<std::mutex> guard(team->lock);
+
+            team->func = NULL;
+            team->arg = NULL;
+            team->generation += 1;
+        }
+
+        team->workPosted.notify_all();
+        team->hostThread.join();
+        delete team;
+    }
+
+    // --------
+
+    EGraphResult NUMASpawner::Spawn(TSpindleFunc func, void* arg)
+    {
+        if (!StartPersistentTeam())
+            return EGraphResult::GraphResultErrorUnknown;
+
+        SPersistentTeam* const team = persistentTeam;
+
+        // Hand the function to the team and wait for every thread to finish running it and go back to waiting.
+        {
+            std::lock_guard<std::mutex> guard(team->lock);
+
+            team->func = func;
+            team->arg = arg;
+            team->generation += 1;
+            team->numThreadsIdle = 0;
+        }
+
+        team->workPosted.notify_all();
+
+        {
+            std::unique_lock<std::mutex> guard(team->lock);
+
+            team->workCompleted.wait(guard, [team]() -> bool
+            {
+                return (team->numThreadsIdle == team->numThreads);
+            });
+        }
+
+        return EGraphResult::GraphResultSuccess;
+    }
+
+    // --------
+
+    EGraphResult NUMASpawner::SpawnTasks(SSpindleTaskSpec* const taskSpecs, const uint32_t taskCount)
+    {
+        // Spindle supports only one parallelized region at a time, so the region that holds the persistent team must end first.
+        ReleaseThreads();
+
+        const uint32_t spawnResult = spindleThreadsSpawn(taskSpecs, taskCount, true);
+
+        if (0 != spawnResult)
+            return EGraphResult::GraphResultErrorUnknown;
+        else
+            return EGraphResult::GraphResultSuccess;
+    }
+}
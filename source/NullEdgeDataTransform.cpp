@@ -16,15 +16,6 @@
 
 namespace GraphTool
 {
-    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
-    // See "EdgeDataTransform.h" for documentation.
-    
-    template <typename TEdgeData> TEdgeData NullEdgeDataTransform<TEdgeData>::GenerateEdgeData(const TVertexID sourceVertex, const TVertexID destinationVertex, const TEdgeData oldEdgeData)
-    {
-        return (TEdgeData)0;
-    }
-    
-    
     // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
 
     template class NullEdgeDataTransform<uint64_t>;
@@ -0,0 +1,346 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file RandomEdgeDataTransform.cpp
+ *   Implementation of an edge data generator that derives random values from
+ *   a seed and the source and destination vertex identifiers.
+ *****************************************************************************/
+
+#include "EdgeDataTransform.h"
+#include "RandomEdgeDataTransform.h"
+#include "Types.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+
+
+namespace GraphTool
+{
+    // -------- CONSTANTS -------------------------------------------------- //
+
+    /// Transformation option that selects the distribution from which values are drawn.
+    static const char* const kTransformOptionDistribution = "distribution";
+
+    /// Value of the distribution option that selects the uniform distribution. This is the default.
+    static const char* const kTransformOptionDistributionUniform = "uniform";
+
+    /// Value of the distribution option that selects the exponential distribution.
+    static const char* const kTransformOptionDistributionExponential = "exponential";
+
+    /// Transformation option that specifies the scale of the distribution.
+    static const char* const kTransformOptionScale = "scale";
+
+    /// Transformation option that specifies the seed from which every value is derived.
+    static const char* const kTransformOptionSeed = "seed";
+
+    /// Multipliers applied to the first and third words of the Philox counter in each round.
+    static const uint32_t kPhiloxMultiplier0 = 0xd2511f53u;
+    static const uint32_t kPhiloxMultiplier1 = 0xcd9e8d57u;
+
+    /// Amounts added to the first and second words of the Philox key after each round.
+    static const uint32_t kPhiloxKeyIncrement0 = 0x9e3779b9u;
+    static const uint32_t kPhiloxKeyIncrement1 = 0xbb67ae85u;
+
+    /// Number of Philox rounds.
+    static const unsigned int kPhiloxRounds = 10;
+
+    /// Bits of a double-precision floating-point value between 1 and 2 whose mantissa is zero.
+    static const uint64_t kUnitIntervalExponent = 0x3ff0000000000000ull;
+
+    /// Largest scale that can be used with integer edge data, which allows integer values to be computed using a single 32-bit multiplication.
+    static const double kMaxIntegerScale = 4294967295.0;
+
+    // Defined for each type of edge data, since integer values are whole numbers drawn from a range that starts at 1.
+    template <> const double RandomEdgeDataTransform<uint64_t>::kDefaultScale = 32768.0;
+    template <> const double RandomEdgeDataTransform<double>::kDefaultScale = 1.0;
+
+
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Applies the Philox4x32-10 generator to a single edge.
+    /// @param [in] seed Seed, which is used as the key.
+    /// @param [in] sourceVertex Source vertex identifier, which makes up the first two words of the counter.
+    /// @param [in] destinationVertex Destination vertex identifier, which makes up the last two words of the counter.
+    /// @return First two words of the output.
+    static inline uint64_t PhiloxRandomBits(const uint64_t seed, const TVertexID sourceVertex, const TVertexID destinationVertex)
+    {
+        uint32_t counter0 = (uint32_t)sourceVertex;
+        uint32_t counter1 = (uint32_t)(sourceVertex >> 32ull);
+        uint32_t counter2 = (uint32_t)destinationVertex;
+        uint32_t counter3 = (uint32_t)(destinationVertex >> 32ull);
+        uint32_t key0 = (uint32_t)seed;
+        uint32_t key1 = (uint32_t)(seed >> 32ull);
+
+        for (unsigned int round = 0; round < kPhiloxRounds; ++round)
+        {
+            const uint64_t product0 = (uint64_t)kPhiloxMultiplier0 * (uint64_t)counter0;
+            const uint64_t product1 = (uint64_t)kPhiloxMultiplier1 * (uint64_t)counter2;
+
+            counter0 = (uint32_t)(product1 >> 32ull) ^ counter1 ^ key0;
+            counter1 = (uint32_t)product1;
+            counter2 = (uint32_t)(product0 >> 32ull) ^ counter3 ^ key1;
+            counter3 = (uint32_t)product0;
+
+            key0 += kPhiloxKeyIncrement0;
+            key1 += kPhiloxKeyIncrement1;
+        }
+
+        return (((uint64_t)counter1 << 32ull) | (uint64_t)counter0);
+    }
+
+    /// Applies the Philox4x32-10 generator to four edges at once.
+    /// Each word of the counter occupies the lower half of a 64-bit element, which is exactly what the AVX2 32-bit multiplication consumes to produce a full 64-bit product.
+    /// @param [in] seed Seed, which is used as the key.
+    /// @param [in] sourceVertices Source vertex identifiers of the four edges.
+    /// @param [in] destinationVertices Destination vertex identifiers of the four edges.
+    /// @return First two words of each output, matching PhiloxRandomBits.
+    static inline __m256i PhiloxRandomBitsVector(const uint64_t seed, const __m256i sourceVertices, const __m256i destinationVertices)
+    {
+        const __m256i lowerHalves = _mm256_set1_epi64x(0xffffffffll);
+        const __m256i multiplier0 = _mm256_set1_epi64x((long long)kPhiloxMultiplier0);
+        const __m256i multiplier1 = _mm256_set1_epi64x((long long)kPhiloxMultiplier1);
+
+        __m256i counter0 = _mm256_and_si256(sourceVertices, lowerHalves);
+        __m256i counter1 = _mm256_srli_epi64(sourceVertices, 32);
+        __m256i counter2 = _mm256_and_si256(destinationVertices, lowerHalves);
+        __m256i counter3 = _mm256_srli_epi64(destinationVertices, 32);
+        uint32_t key0 = (uint32_t)seed;
+        uint32_t key1 = (uint32_t)(seed >> 32ull);
+
+        for (unsigned int round = 0; round < kPhiloxRounds; ++round)
+        {
+            const __m256i product0 = _mm256_mul_epu32(counter0, multiplier0);
+            const __m256i product1 = _mm256_mul_epu32(counter2, multiplier1);
+
+            counter0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product1, 32), counter1), _mm256_set1_epi64x((long long)key0));
+            counter1 = _mm256_and_si256(product1, lowerHalves);
+            counter2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product0, 32), counter3), _mm256_set1_epi64x((long long)key1));
+            counter3 = _mm256_and_si256(product0, lowerHalves);
+
+            key0 += kPhiloxKeyIncrement0;
+            key1 += kPhiloxKeyIncrement1;
+        }
+
+        return _mm256_or_si256(_mm256_slli_epi64(counter1, 32), counter0);
+    }
+
+    /// Converts random bits into a value uniformly distributed between 0, inclusive, and 1, exclusive.
+    /// The upper 52 bits become the mantissa of a value between 1 and 2, from which 1 is subtracted, so that no integer conversion is needed and vector instructions produce exactly the same value.
+    /// @param [in] randomBits Random bits produced by the generator.
+    /// @return Uniformly-distributed value.
+    static inline double RandomBitsToUnitInterval(const uint64_t randomBits)
+    {
+        const uint64_t valueBits = (randomBits >> 12ull) | kUnitIntervalExponent;
+        double value;
+
+        memcpy((void*)&value, (const void*)&valueBits, sizeof(value));
+        return value - 1.0;
+    }
+
+    /// Converts random bits for four edges into values uniformly distributed between 0, inclusive, and 1, exclusive.
+    /// @param [in] randomBits Random bits produced by the generator.
+    /// @return Uniformly-distributed values, matching RandomBitsToUnitInterval.
+    static inline __m256d RandomBitsToUnitIntervalVector(const __m256i randomBits)
+    {
+        return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(randomBits, 12), _mm256_set1_epi64x((long long)kUnitIntervalExponent))), _mm256_set1_pd(1.0));
+    }
+
+    /// Converts random bits for four edges into edge data values drawn from the uniform distribution.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    /// @param [in] randomBits Random bits produced by the generator.
+    /// @param [in] scale Scale of the distribution.
+    /// @return Edge data values, in the representation in which they are stored, matching RandomEdgeDataTransform::RandomBitsToEdgeData.
+    template <typename TEdgeData> static inline __m256i RandomBitsToUniformEdgeDataVector(const __m256i randomBits, const double scale);
+
+    template <> inline __m256i RandomBitsToUniformEdgeDataVector<uint64_t>(const __m256i randomBits, const double scale)
+    {
+        const __m256i scaled = _mm256_mul_epu32(_mm256_srli_epi64(randomBits, 32), _mm256_set1_epi64x((long long)scale));
+        return _mm256_add_epi64(_mm256_srli_epi64(scaled, 32), _mm256_set1_epi64x(1ll));
+    }
+
+    template <> inline __m256i RandomBitsToUniformEdgeDataVector<double>(const __m256i randomBits, const double scale)
+    {
+        return _mm256_castpd_si256(_mm256_mul_pd(RandomBitsToUnitIntervalVector(randomBits), _mm256_set1_pd(scale)));
+    }
+
+    /// Loads four neighbor identifiers stored in compact form, widening each to 64 bits.
+    /// @param [in] neighbors Neighbor identifiers.
+    /// @return Neighbor identifiers.
+    static inline __m256i LoadNeighborVector(const TCompactVertexID* const neighbors)
+    {
+        return _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)neighbors));
+    }
+
+    /// Loads four neighbor identifiers.
+    /// @param [in] neighbors Neighbor identifiers.
+    /// @return Neighbor identifiers.
+    static inline __m256i LoadNeighborVector(const TVertexID* const neighbors)
+    {
+        return _mm256_loadu_si256((const __m256i*)neighbors);
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "RandomEdgeDataTransform.h" for documentation.
+
+    template <typename TEdgeData> RandomEdgeDataTransform<TEdgeData>::RandomEdgeDataTransform(void) : EdgeDataTransform<TEdgeData, RandomEdgeDataTransform<TEdgeData>>(), distribution(ERandomDistribution::RandomDistributionUniform), scale(kDefaultScale), seed(kDefaultSeed)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "RandomEdgeDataTransform.h" for documentation.
+
+    template <> bool RandomEdgeDataTransform<uint64_t>::IsValidScale(const double value)
+    {
+        return ((value >= 1.0) && (value <= kMaxIntegerScale) && (value == floor(value)));
+    }
+
+    // --------
+
+    template <> bool RandomEdgeDataTransform<double>::IsValidScale(const double value)
+    {
+        return ((value > 0.0) && std::isfinite(value));
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "RandomEdgeDataTransform.h" for documentation.
+
+    template <> uint64_t RandomEdgeDataTransform<uint64_t>::RandomBitsToEdgeData(const uint64_t randomBits) const
+    {
+        // Uniform values are computed from the upper 32 bits entirely in integer arithmetic, so that every value in the range is equally likely.
+        if (ERandomDistribution::RandomDistributionUniform == distribution)
+            return ((((randomBits >> 32ull) * (uint64_t)scale) >> 32ull) + 1ull);
+
+        return (uint64_t)(-log(1.0 - RandomBitsToUnitInterval(randomBits)) * scale) + 1ull;
+    }
+
+    // --------
+
+    template <> double RandomEdgeDataTransform<double>::RandomBitsToEdgeData(const uint64_t randomBits) const
+    {
+        if (ERandomDistribution::RandomDistributionUniform == distribution)
+            return RandomBitsToUnitInterval(randomBits) * scale;
+
+        return -log(1.0 - RandomBitsToUnitInterval(randomBits)) * scale;
+    }
+
+    // --------
+
+    template <typename TEdgeData> template <typename TNeighborID> void RandomEdgeDataTransform<TEdgeData>::GenerateEdgeDataVectorized(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TNeighborID* const neighbors, UEdgeData* const edgeData, const size_t count) const
+    {
+        const __m256i topLevelVertices = _mm256_set1_epi64x((long long)topLevelVertex);
+        size_t i = 0;
+
+        auto randomBitsVector = [this, topLevelVertices, topLevelIsDestination, neighbors](const size_t position) -> __m256i
+        {
+            const __m256i neighborVertices = LoadNeighborVector(&neighbors[position]);
+            return (topLevelIsDestination ? PhiloxRandomBitsVector(seed, neighborVertices, topLevelVertices) : PhiloxRandomBitsVector(seed, topLevelVertices, neighborVertices));
+        };
+
+        // Only the uniform distribution can be computed entirely using vector instructions, since AVX2 has no logarithm.
+        if (ERandomDistribution::RandomDistributionUniform == distribution)
+        {
+            for (; (i + 4) <= count; i += 4)
+                _mm256_storeu_si256((__m256i*)&edgeData[i], RandomBitsToUniformEdgeDataVector<TEdgeData>(randomBitsVector(i), scale));
+        }
+        else
+        {
+            for (; (i + 4) <= count; i += 4)
+            {
+                _mm256_storeu_si256((__m256i*)&edgeData[i], randomBitsVector(i));
+
+                for (size_t j = i; j < (i + 4); ++j)
+                    edgeData[j] = RandomBitsToEdgeData(edgeData[j].u);
+            }
+        }
+
+        for (; i < count; ++i)
+            edgeData[i] = (topLevelIsDestination ? GenerateEdgeData((TVertexID)neighbors[i], topLevelVertex, (TEdgeData)edgeData[i]) : GenerateEdgeData(topLevelVertex, (TVertexID)neighbors[i], (TEdgeData)edgeData[i]));
+    }
+
+
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "EdgeDataTransform.h" for documentation.
+
+    template <typename TEdgeData> void RandomEdgeDataTransform<TEdgeData>::GenerateEdgeDataBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count) const
+    {
+        GenerateEdgeDataVectorized(topLevelVertex, topLevelIsDestination, neighbors, edgeData, count);
+    }
+
+    // --------
+
+    template <typename TEdgeData> void RandomEdgeDataTransform<TEdgeData>::GenerateEdgeDataBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, const TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count) const
+    {
+        GenerateEdgeDataVectorized(topLevelVertex, topLevelIsDestination, neighbors, edgeData, count);
+    }
+
+    // --------
+
+    template <typename TEdgeData> TEdgeData RandomEdgeDataTransform<TEdgeData>::GenerateEdgeData(const TVertexID sourceVertex, const TVertexID destinationVertex, const TEdgeData oldEdgeData) const
+    {
+        return RandomBitsToEdgeData(PhiloxRandomBits(seed, sourceVertex, destinationVertex));
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphTransform.h" for documentation.
+
+    template <typename TEdgeData> bool RandomEdgeDataTransform<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if (0 == strcmp(optionName, kTransformOptionDistribution))
+        {
+            if (0 == strcmp(optionValue, kTransformOptionDistributionUniform))
+                distribution = ERandomDistribution::RandomDistributionUniform;
+            else if (0 == strcmp(optionValue, kTransformOptionDistributionExponential))
+                distribution = ERandomDistribution::RandomDistributionExponential;
+            else
+                return false;
+
+            return true;
+        }
+
+        if (0 == strcmp(optionName, kTransformOptionScale))
+        {
+            char* valueEnd = NULL;
+            const double value = strtod(optionValue, &valueEnd);
+
+            if (('\0' == optionValue[0]) || ('\0' != *valueEnd) || !IsValidScale(value))
+                return false;
+
+            scale = value;
+            return true;
+        }
+
+        if (0 == strcmp(optionName, kTransformOptionSeed))
+        {
+            char* valueEnd = NULL;
+            const uint64_t value = (uint64_t)strtoull(optionValue, &valueEnd, 10);
+
+            if (('\0' == optionValue[0]) || ('-' == optionValue[0]) || ('\0' != *valueEnd))
+                return false;
+
+            seed = value;
+            return true;
+        }
+
+        return EdgeDataTransform<TEdgeData, RandomEdgeDataTransform<TEdgeData>>::SubmitOption(optionName, optionValue);
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class RandomEdgeDataTransform<uint64_t>;
+    template class RandomEdgeDataTransform<double>;
+}
@@ -0,0 +1,809 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file ReorderVerticesTransform.cpp
+ *   Implementation of a transformation that renumbers vertices to improve locality.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "GraphTransform.h"
+#include "NUMASpawner.h"
+#include "ReorderVerticesTransform.h"
+#include "TextFormatter.h"
+#include "Types.h"
+#include "VertexIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <parutil.h>
+#include <spindle.h>
+#include <string>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- CONSTANTS -------------------------------------------------- //
+
+    // Defined here because they are passed by reference.
+    const TVertexCount ReorderVerticesTransform::kGorderBlockSize;
+    const uint64_t ReorderVerticesTransform::kNoVertex;
+
+    /// Transformation option that specifies the name of the file to which the permutation should be written.
+    static const char* const kTransformOptionPermutationFile = "permutationfile";
+
+    /// Transformation option that specifies the window size of the Gorder-style ordering.
+    static const char* const kTransformOptionWindow = "window";
+
+    /// Value held in the claim of a vertex that has been collected as the child of the vertex that claimed it.
+    static const uint64_t kClaimCollected = ReorderVerticesTransform::kNoVertex - 1;
+
+    /// Size, in bytes, of the buffer used to format the permutation file.
+    static const size_t kPermutationFileBufferSize = 1ull << 20;
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "ReorderVerticesTransform.h" for documentation.
+
+    ReorderVerticesTransform::ReorderVerticesTransform(const EVertexOrder vertexOrder) : GraphTransform(), vertexOrder(vertexOrder), gorderWindow(kDefaultGorderWindow), permutationFilename(), outEdges(NULL), inEdges(NULL), numVertices(0), numVerticesKept(0), gorderHubDegree(0), sharedBuf(NULL), degrees(NULL), newIDs(NULL), oldIDs(NULL), scratchIDs(NULL), claims(NULL), threadVertices(NULL), nextStartCandidate(0), numPlaced(0), levelStart(0), levelEnd(0), searchComplete(false), workScheduler()
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    ReorderVerticesTransform::~ReorderVerticesTransform(void)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "ReorderVerticesTransform.h" for documentation.
+
+    void ReorderVerticesTransform::ComputeCompactOrder(void)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        const TVertexID rangeStart = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+
+        // With only one grouping present, a vertex whose edges all lead towards it has no degree of its own, so every neighbor is marked instead.
+        // Marking follows the edges rather than the vertices, so that a few high-degree vertices do not leave most threads idle.
+        const VertexIndex* const onlyEdges = ((NULL == inEdges) ? outEdges : ((NULL == outEdges) ? inEdges : NULL));
+
+        if (NULL != onlyEdges)
+        {
+            for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+                claims[i].store(0, std::memory_order_relaxed);
+
+            workScheduler.ParallelInitialize(onlyEdges->GetFrozenOffsets(), onlyEdges->GetNumVertices(), true);
+
+            SWorkUnit unit;
+
+            while (workScheduler.GetWork(unit))
+            {
+                for (TEdgeID edge = unit.edgeStart; edge < unit.edgeEnd; ++edge)
+                    claims[onlyEdges->GetFrozenNeighbor(edge)].store(1, std::memory_order_relaxed);
+            }
+
+            spindleBarrierGlobal();
+        }
+
+        auto isPresent = [this, onlyEdges](const TVertexID vertex) -> bool
+        {
+            return ((0 != degrees[vertex]) || ((NULL != onlyEdges) && (0 != claims[vertex].load(std::memory_order_relaxed))));
+        };
+
+        // Each thread counts the vertices it keeps, so that the first thread can determine where each range begins in the new numbering.
+        uint64_t numKeptThread = 0;
+
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            if (isPresent(i))
+                numKeptThread += 1;
+        }
+
+        sharedBuf[globalThreadID] = numKeptThread;
+
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            numVerticesKept = 0;
+
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                const uint64_t rangeKept = sharedBuf[i];
+                sharedBuf[i] = numVerticesKept;
+                numVerticesKept += (TVertexCount)rangeKept;
+            }
+        }
+
+        spindleBarrierGlobal();
+
+        TVertexID position = (TVertexID)sharedBuf[globalThreadID];
+
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            if (isPresent(i))
+            {
+                newIDs[i] = position;
+                oldIDs[position] = i;
+                position += 1;
+            }
+            else
+            {
+                newIDs[i] = kNoVertex;
+            }
+        }
+
+        spindleBarrierGlobal();
+    }
+
+    // --------
+
+    void ReorderVerticesTransform::ComputeCuthillMcKeeOrder(void)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        // Each connected component starts from its unplaced vertex of lowest degree, so the vertices are first sorted in that order.
+        ParallelSortVerticesByDegree(scratchIDs, oldIDs, false);
+
+        for (TVertexID i = (TVertexID)((numVertices * globalThreadID) / globalThreadCount); i < (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount); ++i)
+        {
+            newIDs[i] = kNoVertex;
+            claims[i].store(kNoVertex, std::memory_order_relaxed);
+        }
+
+        if (0 == globalThreadID)
+        {
+            nextStartCandidate = 0;
+            numPlaced = 0;
+            levelStart = 0;
+            levelEnd = 0;
+            searchComplete = false;
+        }
+
+        spindleBarrierGlobal();
+
+        // Small levels, which are common near the start and end of each component and make up all of a small component, are not worth coordinating multiple threads.
+        while (true)
+        {
+            if (0 == globalThreadID)
+                OrderCuthillMcKeeLevelsSerial();
+
+            spindleBarrierGlobal();
+
+            if (searchComplete)
+                break;
+
+            OrderCuthillMcKeeLevelParallel();
+        }
+    }
+
+    // --------
+
+    void ReorderVerticesTransform::ComputeDegreeOrder(void)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        ParallelSortVerticesByDegree(oldIDs, scratchIDs, true);
+
+        for (TVertexID i = (TVertexID)((numVertices * globalThreadID) / globalThreadCount); i < (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount); ++i)
+            newIDs[oldIDs[i]] = i;
+
+        spindleBarrierGlobal();
+    }
+
+    // --------
+
+    void ReorderVerticesTransform::ComputeGorderOrder(void)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        // Blocks are of fixed size, regardless of the number of threads, so that the ordering is too.
+        // Each task rearranges its own range of blocks, dynamically scheduling them among its threads.
+        const uint64_t numBlocks = (numVertices + kGorderBlockSize - 1) / kGorderBlockSize;
+        SGorderBlockState state;
+
+        uint64_t taskRangeStart = 0;
+        uint64_t taskRangeEnd = 0;
+        NUMASpawner::GetCurrentTaskUnitRange(numBlocks, taskRangeStart, taskRangeEnd);
+
+        void* scheduler = NULL;
+        const uint64_t numUnits = taskRangeEnd - taskRangeStart;
+        const uint64_t firstUnit = (uint64_t)parutilSchedulerDynamicInit(numUnits, &scheduler);
+
+        if (NULL != scheduler)
+        {
+            for (uint64_t unit = firstUnit; unit < numUnits; unit = (uint64_t)parutilSchedulerDynamicGetWork(scheduler))
+            {
+                const TVertexID blockStart = (TVertexID)((taskRangeStart + unit) * kGorderBlockSize);
+                const TVertexID blockEnd = (((blockStart + kGorderBlockSize) < numVertices) ? (blockStart + kGorderBlockSize) : (TVertexID)numVertices);
+
+                OrderGorderBlock(blockStart, blockEnd, state);
+            }
+
+            parutilSchedulerDynamicExit(scheduler);
+        }
+
+        spindleBarrierGlobal();
+
+        for (TVertexID i = (TVertexID)((numVertices * globalThreadID) / globalThreadCount); i < (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount); ++i)
+        {
+            oldIDs[i] = scratchIDs[i];
+            newIDs[scratchIDs[i]] = i;
+        }
+
+        spindleBarrierGlobal();
+    }
+
+    // --------
+
+    void ReorderVerticesTransform::OrderCuthillMcKeeLevelParallel(void)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        // Each thread is responsible for a contiguous range of the current level, and children are placed in the order of the ranges.
+        const TVertexID firstChild = (TVertexID)numPlaced;
+        const TVertexCount levelSize = levelEnd - levelStart;
+        const TVertexID rangeStart = levelStart + (TVertexID)((levelSize * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = levelStart + (TVertexID)((levelSize * (globalThreadID + 1)) / globalThreadCount);
+
+        // Every unplaced neighbor is claimed by the earliest vertex in the level that is adjacent to it.
+        for (TVertexID position = rangeStart; position < rangeEnd; ++position)
+        {
+            VisitNeighbors(oldIDs[position], [this, position](const TVertexID neighbor)
+            {
+                if (kNoVertex != newIDs[neighbor])
+                    return;
+
+                uint64_t claim = claims[neighbor].load(std::memory_order_relaxed);
+
+                while ((position < claim) && !(claims[neighbor].compare_exchange_weak(claim, position, std::memory_order_relaxed)))
+                {
+                    // Nothing to do here.
+                }
+            });
+        }
+
+        spindleBarrierGlobal();
+
+        // Each vertex in the level collects the neighbors it claimed, in ascending order of degree.
+        // Collecting a neighbor changes its claim, so neighbors connected by multiple edges are only collected once.
+        std::vector<TVertexID>& children = threadVertices[globalThreadID];
+        children.clear();
+
+        for (TVertexID position = rangeStart; position < rangeEnd; ++position)
+        {
+            const size_t firstVertexChild = children.size();
+
+            VisitNeighbors(oldIDs[position], [this, position, &children](const TVertexID neighbor)
+            {
+                if (position == claims[neighbor].load(std::memory_order_relaxed))
+                {
+                    claims[neighbor].store(kClaimCollected, std::memory_order_relaxed);
+                    children.push_back(neighbor);
+                }
+            });
+
+            std::sort(children.begin() + firstVertexChild, children.end(), [this](const TVertexID vertexA, const TVertexID vertexB) -> bool
+            {
+                return PrecedesByAscendingDegree(vertexA, vertexB);
+            });
+        }
+
+        sharedBuf[globalThreadID] = (uint64_t)children.size();
+
+        spindleBarrierGlobal();
+
+        // Place the children of each range after those of all earlier ranges.
+        TVertexID position = firstChild;
+        TVertexCount numChildren = 0;
+
+        for (uint32_t i = 0; i < globalThreadCount; ++i)
+        {
+            if (i < globalThreadID)
+                position += (TVertexID)sharedBuf[i];
+
+            numChildren += (TVertexCount)sharedBuf[i];
+        }
+
+        for (size_t i = 0; i < children.size(); ++i, ++position)
+        {
+            oldIDs[position] = children[i];
+            newIDs[children[i]] = position;
+        }
+
+        spindleBarrierGlobal();
+
+        // The children make up the next level.
+        if (0 == globalThreadID)
+        {
+            levelStart = levelEnd;
+            levelEnd = firstChild + (TVertexID)numChildren;
+            numPlaced = levelEnd;
+        }
+    }
+
+    // --------
+
+    void ReorderVerticesTransform::OrderCuthillMcKeeLevelsSerial(void)
+    {
+        auto placeVertex = [this](const TVertexID vertex)
+        {
+            oldIDs[numPlaced] = vertex;
+            newIDs[vertex] = (TVertexID)numPlaced;
+            numPlaced += 1;
+        };
+
+        while (true)
+        {
+            // Once the current component is exhausted, the next one starts from the unplaced vertex of lowest degree.
+            if (levelStart == levelEnd)
+            {
+                while ((nextStartCandidate < numVertices) && (kNoVertex != newIDs[scratchIDs[nextStartCandidate]]))
+                    nextStartCandidate += 1;
+
+                if (nextStartCandidate == numVertices)
+                {
+                    searchComplete = true;
+                    return;
+                }
+
+                levelStart = (TVertexID)numPlaced;
+                placeVertex(scratchIDs[nextStartCandidate]);
+                levelEnd = (TVertexID)numPlaced;
+            }
+
+            if ((levelEnd - levelStart) >= kParallelFrontierThreshold)
+                return;
+
+            for (TVertexID position = levelStart; position < levelEnd; ++position)
+            {
+                const TVertexID firstVertexChild = (TVertexID)numPlaced;
+
+                VisitNeighbors(oldIDs[position], [this, &placeVertex](const TVertexID neighbor)
+                {
+                    if (kNoVertex == newIDs[neighbor])
+                        placeVertex(neighbor);
+                });
+
+                std::sort(&oldIDs[firstVertexChild], &oldIDs[numPlaced], [this](const TVertexID vertexA, const TVertexID vertexB) -> bool
+                {
+                    return PrecedesByAscendingDegree(vertexA, vertexB);
+                });
+
+                for (TVertexID i = firstVertexChild; i < (TVertexID)numPlaced; ++i)
+                    newIDs[oldIDs[i]] = i;
+            }
+
+            levelStart = levelEnd;
+            levelEnd = (TVertexID)numPlaced;
+        }
+    }
+
+    // --------
+
+    void ReorderVerticesTransform::OrderGorderBlock(const TVertexID blockStart, const TVertexID blockEnd, SGorderBlockState& state) const
+    {
+        const uint64_t blockSize = (uint64_t)(blockEnd - blockStart);
+
+        state.scores.assign(blockSize, 0);
+        state.previous.resize(blockSize);
+        state.next.resize(blockSize);
+        state.bucketHeads.assign(1, kNoVertex);
+        state.placed.assign(blockSize, 0);
+        state.maxScore = 0;
+
+        auto removeFromBucket = [&state](const uint64_t member)
+        {
+            if (kNoVertex != state.previous[member])
+                state.next[state.previous[member]] = state.next[member];
+            else
+                state.bucketHeads[state.scores[member]] = state.next[member];
+
+            if (kNoVertex != state.next[member])
+                state.previous[state.next[member]] = state.previous[member];
+        };
+
+        auto insertIntoBucket = [&state](const uint64_t member)
+        {
+            const uint64_t score = state.scores[member];
+
+            if (score >= state.bucketHeads.size())
+                state.bucketHeads.resize(score + 1, kNoVertex);
+
+            state.previous[member] = kNoVertex;
+            state.next[member] = state.bucketHeads[score];
+
+            if (kNoVertex != state.next[member])
+                state.previous[state.next[member]] = member;
+
+            state.bucketHeads[score] = member;
+
+            if (score > state.maxScore)
+                state.maxScore = score;
+        };
+
+        // Vertices are identified by their position in the block, which is also their position in Cuthill-McKee order relative to the start of the block.
+        // Changes to the scores of vertices outside the block, or already placed, are ignored.
+        auto adjustScore = [this, &state, blockStart, blockSize, &removeFromBucket, &insertIntoBucket](const TVertexID vertex, const bool increase)
+        {
+            const uint64_t member = (uint64_t)(newIDs[vertex] - blockStart);
+
+            if ((member >= blockSize) || (0 != state.placed[member]))
+                return;
+
+            removeFromBucket(member);
+            state.scores[member] = (increase ? (state.scores[member] + 1) : (state.scores[member] - 1));
+            insertIntoBucket(member);
+        };
+
+        // Entering the window raises the scores of a vertex's neighbors and of the other out-neighbors of its in-neighbors, and leaving it undoes exactly the same changes.
+        auto updateWindowScores = [this, &adjustScore](const TVertexID vertex, const bool increase)
+        {
+            VisitFrozenNeighbors(outEdges, vertex, [&adjustScore, increase](const TVertexID neighbor)
+            {
+                adjustScore(neighbor, increase);
+            });
+
+            VisitFrozenNeighbors(inEdges, vertex, [this, &adjustScore, vertex, increase](const TVertexID inNeighbor)
+            {
+                adjustScore(inNeighbor, increase);
+
+                if (outEdges->GetDegree(inNeighbor) > gorderHubDegree)
+                    return;
+
+                VisitFrozenNeighbors(outEdges, inNeighbor, [&adjustScore, vertex, increase](const TVertexID sibling)
+                {
+                    if (sibling != vertex)
+                        adjustScore(sibling, increase);
+                });
+            });
+        };
+
+        // Vertices are inserted in reverse so that ties are broken in favor of Cuthill-McKee order.
+        for (uint64_t member = blockSize; member > 0; --member)
+            insertIntoBucket(member - 1);
+
+        for (uint64_t i = 0; i < blockSize; ++i)
+        {
+            while (kNoVertex == state.bucketHeads[state.maxScore])
+                state.maxScore -= 1;
+
+            const uint64_t member = state.bucketHeads[state.maxScore];
+            const TVertexID vertex = oldIDs[blockStart + member];
+
+            removeFromBucket(member);
+            state.placed[member] = 1;
+            scratchIDs[blockStart + i] = vertex;
+
+            updateWindowScores(vertex, true);
+
+            if (i >= gorderWindow)
+                updateWindowScores(scratchIDs[blockStart + i - gorderWindow], false);
+        }
+    }
+
+    // --------
+
+    void ReorderVerticesTransform::ParallelSortVerticesByDegree(TVertexID* const sortedVertices, TVertexID* const scratch, const bool descending) const
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        auto compareVertices = [this, descending](const TVertexID vertexA, const TVertexID vertexB) -> bool
+        {
+            return (descending ? PrecedesByDescendingDegree(vertexA, vertexB) : PrecedesByAscendingDegree(vertexA, vertexB));
+        };
+
+        auto threadRangeStart = [this, globalThreadCount](const uint32_t threadID) -> TVertexID
+        {
+            return (TVertexID)((numVertices * ((threadID < globalThreadCount) ? threadID : globalThreadCount)) / globalThreadCount);
+        };
+
+        // Each thread sorts its own contiguous range of vertices.
+        const TVertexID rangeStart = threadRangeStart(globalThreadID);
+        const TVertexID rangeEnd = threadRangeStart(globalThreadID + 1);
+
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+            sortedVertices[i] = i;
+
+        std::sort(&sortedVertices[rangeStart], &sortedVertices[rangeEnd], compareVertices);
+
+        spindleBarrierGlobal();
+
+        // Sorted ranges are then merged pairwise, doubling in size each round, alternating between the two arrays.
+        TVertexID* source = sortedVertices;
+        TVertexID* destination = scratch;
+
+        for (uint32_t width = 1; width < globalThreadCount; width <<= 1)
+        {
+            if (0 == (globalThreadID % (width << 1)))
+            {
+                const TVertexID mergeStart = threadRangeStart(globalThreadID);
+                const TVertexID mergeMiddle = threadRangeStart(globalThreadID + width);
+                const TVertexID mergeEnd = threadRangeStart(globalThreadID + (width << 1));
+
+                std::merge(&source[mergeStart], &source[mergeMiddle], &source[mergeMiddle], &source[mergeEnd], &destination[mergeStart], compareVertices);
+            }
+
+            spindleBarrierGlobal();
+
+            TVertexID* const swapIDs = source;
+            source = destination;
+            destination = swapIDs;
+        }
+
+        if (source != sortedVertices)
+        {
+            memcpy((void*)&sortedVertices[rangeStart], (void*)&source[rangeStart], sizeof(TVertexID) * (size_t)(rangeEnd - rangeStart));
+            spindleBarrierGlobal();
+        }
+    }
+
+    // --------
+
+    bool ReorderVerticesTransform::WritePermutationFile(void) const
+    {
+        FILE* const permutationFile = fopen(permutationFilename.c_str(), "w");
+
+        if (NULL == permutationFile)
+            return false;
+
+        std::vector<char> formatBuf(kPermutationFileBufferSize);
+        size_t formatBufCount = 0;
+        bool writeSucceeded = true;
+
+        for (TVertexID i = 0; (i < numVerticesKept) && writeSucceeded; ++i)
+        {
+            formatBufCount += TextFormatter::FormatUnsignedInteger(&formatBuf[formatBufCount], (uint64_t)oldIDs[i]);
+            formatBuf[formatBufCount++] = '\n';
+
+            if ((formatBufCount + TextFormatter::kMaxUnsignedIntegerLength + 1) > formatBuf.size())
+            {
+                writeSucceeded = (formatBufCount == fwrite((void*)formatBuf.data(), 1, formatBufCount, permutationFile));
+                formatBufCount = 0;
+            }
+        }
+
+        if (writeSucceeded && (0 != formatBufCount))
+            writeSucceeded = (formatBufCount == fwrite((void*)formatBuf.data(), 1, formatBufCount, permutationFile));
+
+        return ((0 == fclose(permutationFile)) && writeSucceeded);
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphTransform.h" for documentation.
+
+    EGraphResult ReorderVerticesTransform::ApplyTransformation(Graph& graph)
+    {
+        const bool hadEdgesByDestination = graph.HasEdgesByDestination();
+        const bool hadEdgesBySource = graph.HasEdgesBySource();
+
+        // Orderings other than by degree follow edges in both directions, so both groupings are needed, but only for as long as the transformation takes.
+        // Ordering by degree and compaction can determine the degree of each vertex in both directions from either grouping, by following its edges to their other ends.
+        if ((EVertexOrder::VertexOrderDegree != vertexOrder) && (EVertexOrder::VertexOrderCompact != vertexOrder))
+        {
+            EGraphResult groupingResult = graph.BuildEdgeGrouping(true);
+
+            if (EGraphResult::GraphResultSuccess == groupingResult)
+                groupingResult = graph.BuildEdgeGrouping(false);
+
+            if (EGraphResult::GraphResultSuccess != groupingResult)
+                return groupingResult;
+        }
+
+        const EGraphResult result = GraphTransform::ApplyTransformation(graph);
+
+        if ((graph.HasEdgesByDestination() != hadEdgesByDestination) || (graph.HasEdgesBySource() != hadEdgesBySource))
+            graph.SetEdgeGroupings(hadEdgesByDestination, hadEdgesBySource);
+
+        return result;
+    }
+
+    // --------
+
+    bool ReorderVerticesTransform::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if (0 == strcmp(optionName, kTransformOptionPermutationFile))
+        {
+            if ('\0' == optionValue[0])
+                return false;
+
+            permutationFilename = optionValue;
+            return true;
+        }
+
+        if ((0 == strcmp(optionName, kTransformOptionWindow)) && (EVertexOrder::VertexOrderGorder == vertexOrder))
+        {
+            char* valueEnd = NULL;
+            const uint64_t value = (uint64_t)strtoull(optionValue, &valueEnd, 10);
+
+            if (('\0' == optionValue[0]) || ('-' == optionValue[0]) || ('\0' != *valueEnd) || (0 == value))
+                return false;
+
+            gorderWindow = value;
+            return true;
+        }
+
+        return GraphTransform::SubmitOption(optionName, optionValue);
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphTransform.h" for documentation.
+
+    EGraphResult ReorderVerticesTransform::TransformGraph(Graph& graph)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        if (0 == globalThreadID)
+            sharedBuf = new uint64_t[globalThreadCount];
+
+        spindleBarrierGlobal();
+
+        // Renumbering works on the compact representation.
+        graph.ParallelFreeze(sharedBuf);
+
+        if (0 == globalThreadID)
+        {
+            const TVertexCount numVerticesDestination = graph.VertexIndexDestination().GetNumVertices();
+            const TVertexCount numVerticesSource = graph.VertexIndexSource().GetNumVertices();
+
+            outEdges = (graph.HasEdgesBySource() ? &graph.VertexIndexSource() : NULL);
+            inEdges = (graph.HasEdgesByDestination() ? &graph.VertexIndexDestination() : NULL);
+            numVertices = ((numVerticesDestination > numVerticesSource) ? numVerticesDestination : numVerticesSource);
+            numVerticesKept = numVertices;
+
+            // As in the original Gorder, siblings are not considered through vertices whose out-degree exceeds the square root of the number of vertices.
+            gorderHubDegree = (TEdgeCount)sqrt((double)numVertices);
+
+            degrees = new TEdgeCount[numVertices];
+            newIDs = new TVertexID[numVertices];
+            oldIDs = new TVertexID[numVertices];
+            scratchIDs = new TVertexID[numVertices];
+
+            // Ordering by degree uses the claims only to count the edges of the grouping that is not present.
+            if ((EVertexOrder::VertexOrderDegree != vertexOrder) || (NULL == outEdges) || (NULL == inEdges))
+                claims = new std::atomic<uint64_t>[numVertices];
+
+            if ((EVertexOrder::VertexOrderRCM == vertexOrder) || (EVertexOrder::VertexOrderGorder == vertexOrder))
+                threadVertices = new std::vector<TVertexID>[globalThreadCount];
+        }
+
+        spindleBarrierGlobal();
+
+        for (TVertexID i = (TVertexID)((numVertices * globalThreadID) / globalThreadCount); i < (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount); ++i)
+            degrees[i] = ((NULL != outEdges) ? outEdges->GetDegree(i) : 0) + ((NULL != inEdges) ? inEdges->GetDegree(i) : 0);
+
+        spindleBarrierGlobal();
+
+        // Ordering by degree uses the total degree, but only one grouping is built for it, so the edges in the other direction are counted by crediting the vertex at the other end of every edge.
+        // Compaction instead marks those vertices itself, and the other orderings have both groupings.
+        if ((EVertexOrder::VertexOrderDegree == vertexOrder) && ((NULL == outEdges) || (NULL == inEdges)))
+        {
+            const VertexIndex& vertexIndex = ((NULL != outEdges) ? *outEdges : *inEdges);
+
+            for (TVertexID i = (TVertexID)((numVertices * globalThreadID) / globalThreadCount); i < (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount); ++i)
+                claims[i].store(0, std::memory_order_relaxed);
+
+            workScheduler.ParallelInitialize(vertexIndex.GetFrozenOffsets(), vertexIndex.GetNumVertices(), true);
+
+            SWorkUnit unit;
+
+            while (workScheduler.GetWork(unit))
+            {
+                for (TEdgeID edge = unit.edgeStart; edge < unit.edgeEnd; ++edge)
+                {
+                    const TVertexID neighbor = vertexIndex.GetFrozenNeighbor(edge);
+
+                    if (neighbor < (TVertexID)numVertices)
+                        claims[neighbor].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            spindleBarrierGlobal();
+
+            for (TVertexID i = (TVertexID)((numVertices * globalThreadID) / globalThreadCount); i < (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount); ++i)
+                degrees[i] += (TEdgeCount)claims[i].load(std::memory_order_relaxed);
+
+            spindleBarrierGlobal();
+        }
+
+        switch (vertexOrder)
+        {
+        case EVertexOrder::VertexOrderDegree:
+            ComputeDegreeOrder();
+            break;
+
+        case EVertexOrder::VertexOrderRCM:
+            ComputeCuthillMcKeeOrder();
+
+            // Reversing the Cuthill-McKee ordering is what reduces the bandwidth of the adjacency matrix.
+            for (TVertexID i = (TVertexID)((numVertices * globalThreadID) / globalThreadCount); i < (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount); ++i)
+            {
+                newIDs[i] = (TVertexID)(numVertices - 1) - newIDs[i];
+                oldIDs[newIDs[i]] = i;
+            }
+
+            spindleBarrierGlobal();
+            break;
+
+        case EVertexOrder::VertexOrderGorder:
+            ComputeCuthillMcKeeOrder();
+            ComputeGorderOrder();
+            break;
+
+        case EVertexOrder::VertexOrderCompact:
+            ComputeCompactOrder();
+            break;
+        }
+
+        EGraphResult result = EGraphResult::GraphResultSuccess;
+
+        if ((0 == globalThreadID) && !(permutationFilename.empty()))
+        {
+            if (!(WritePermutationFile()))
+                result = EGraphResult::GraphResultErrorIO;
+        }
+
+        // Compaction keeps vertices in their existing order, so edges that were sorted before renumbering remain sorted afterwards.
+        const bool sortedByDestination = ((EVertexOrder::VertexOrderCompact == vertexOrder) && graph.VertexIndexDestination().IsFrozenSorted());
+        const bool sortedBySource = ((EVertexOrder::VertexOrderCompact == vertexOrder) && graph.VertexIndexSource().IsFrozenSorted());
+
+        graph.ParallelRelabelVertices(newIDs, oldIDs, numVerticesKept, sharedBuf);
+
+        if (0 == globalThreadID)
+        {
+            if (sortedByDestination)
+                graph.VertexIndexDestinationWritable().MarkFrozenSorted();
+
+            if (sortedBySource)
+                graph.VertexIndexSourceWritable().MarkFrozenSorted();
+
+            delete[] sharedBuf;
+            delete[] degrees;
+            delete[] newIDs;
+            delete[] oldIDs;
+            delete[] scratchIDs;
+
+            if (NULL != claims)
+                delete[] claims;
+
+            if (NULL != threadVertices)
+                delete[] threadVertices;
+
+            sharedBuf = NULL;
+            degrees = NULL;
+            newIDs = NULL;
+            oldIDs = NULL;
+            scratchIDs = NULL;
+            claims = NULL;
+            threadVertices = NULL;
+            outEdges = NULL;
+            inEdges = NULL;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,265 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file SNAPEdgeListReader.cpp
+ *   Implementation of a graph reader for edge list files distributed by the
+ *   Stanford Network Analysis Project (SNAP).
+ *****************************************************************************/
+
+#include "GraphReader.h"
+#include "SNAPEdgeListReader.h"
+#include "TextEdgeListReader.h"
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- CONSTANTS -------------------------------------------------- //
+
+    /// Reader option that selects how the vertex and edge counts are determined.
+    static const char* const kReaderOptionCounts = "counts";
+
+    /// Value of the counts option that takes the counts from the comments at the start of the file if they hold them, and scans the file otherwise. This is the default.
+    static const char* const kReaderOptionCountsHeader = "header";
+
+    /// Value of the counts option that always scans the file, which is needed if vertex identifiers are not all less than the number of vertices given in the comments.
+    static const char* const kReaderOptionCountsScan = "scan";
+
+    /// Label that precedes the number of vertices in the comments at the start of the file.
+    static const char* const kHeaderLabelNodes = "Nodes:";
+
+    /// Label that precedes the number of edges in the comments at the start of the file.
+    static const char* const kHeaderLabelEdges = "Edges:";
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Searches a comment line for a count that follows the specified label.
+    /// @param [in] line Comment line to search.
+    /// @param [in] label Label that precedes the count.
+    /// @param [out] count Count that follows the label, if found.
+    /// @return `true` if the label and a count were found, `false` otherwise.
+    static inline bool FindHeaderCount(const char* const line, const char* const label, uint64_t& count)
+    {
+        const char* labelPosition = strstr(line, label);
+        if (NULL == labelPosition)
+            return false;
+
+        const char* countPosition = &labelPosition[strlen(label)];
+        char* endPos;
+
+        count = strtoull(countPosition, &endPos, 10);
+        return (countPosition != endPos);
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "SNAPEdgeListReader.h" for documentation.
+
+    template <typename TEdgeData> SNAPEdgeListReader<TEdgeData>::SNAPEdgeListReader(void) : TextEdgeListReader<TEdgeData>(), useCountScan(false), headerCountsFound(false), countsScanned(false)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "SNAPEdgeListReader.h" for documentation.
+
+    template <typename TEdgeData> bool SNAPEdgeListReader<TEdgeData>::ScanForCounts(FILE* const graphfile)
+    {
+        std::vector<char> block(kScanBlockSize + kScanBlockPadding);
+        size_t numCarriedBytes = 0;
+        TEdgeCount numEdges = 0;
+        TVertexCount numVertices = 0;
+
+        while (true)
+        {
+            // Read the next block after whatever incomplete line was carried over from the previous one.
+            const size_t numBytesRead = fread((void*)&block[numCarriedBytes], sizeof(char), kScanBlockSize - numCarriedBytes, graphfile);
+            const bool atEnd = (0 == numBytesRead);
+            char* const blockEnd = &block[numCarriedBytes + numBytesRead];
+            const char* currpos = &block[0];
+
+            memset((void*)blockEnd, 0, kScanBlockPadding);
+
+            while (currpos < blockEnd)
+            {
+                const char* lineEnd = (const char*)memchr(currpos, '\n', blockEnd - currpos);
+
+                // An incomplete line is carried over to the next block, unless it is the last line of the file or fills the entire block.
+                if (NULL == lineEnd)
+                {
+                    if (!atEnd && (currpos != &block[0]))
+                        break;
+
+                    lineEnd = blockEnd;
+                }
+
+                SEdge<TEdgeData> edge;
+
+                if (this->ParseEdgeLine(currpos, lineEnd, edge))
+                {
+                    numEdges += 1;
+
+                    if (edge.sourceVertex >= numVertices)
+                        numVertices = edge.sourceVertex + 1;
+
+                    if (edge.destinationVertex >= numVertices)
+                        numVertices = edge.destinationVertex + 1;
+                }
+
+                currpos = lineEnd + 1;
+            }
+
+            if (atEnd)
+                break;
+
+            numCarriedBytes = ((currpos < blockEnd) ? (size_t)(blockEnd - currpos) : 0);
+
+            if (0 != numCarriedBytes)
+                memmove((void*)&block[0], (const void*)currpos, numCarriedBytes);
+        }
+
+        if (ferror(graphfile))
+            return false;
+
+        GraphReader<TEdgeData>::numVerticesInFile = numVertices;
+        GraphReader<TEdgeData>::numEdgesInFile = numEdges;
+
+        return true;
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "TextEdgeListReader.h" for documentation.
+
+    template <typename TEdgeData> unsigned int SNAPEdgeListReader<TEdgeData>::ParseEdgesFromLine(const char* const line, const char* const lineEnd, SEdge<TEdgeData>* const edges) const
+    {
+        if (!(this->ParseEdgeLine(line, lineEnd, edges[0])))
+            return 0;
+
+        // Edges whose vertex identifiers are not less than the number of vertices are skipped, which is detected as an edge count mismatch.
+        // Identifiers that are remapped may take any value, since only the number of distinct identifiers matters.
+        const TVertexCount numVertices = GraphReader<TEdgeData>::numVerticesInFile;
+
+        if (!(this->RemapsVertexIDs()) && ((edges[0].sourceVertex >= numVertices) || (edges[0].destinationVertex >= numVertices)))
+            return 0;
+
+        return 1;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool SNAPEdgeListReader<TEdgeData>::ReadGraphFileHeader(FILE* const graphfile)
+    {
+        char linebuf[TextEdgeListReader<TEdgeData>::kHeaderLineBufferSize];
+        uint64_t numNodes = 0;
+        uint64_t numEdges = 0;
+        bool nodesFound = false;
+        bool edgesFound = false;
+
+        // Search the comments at the start of the file for the counts, stopping at the first line that is not a comment.
+        while (true)
+        {
+            const int character = getc(graphfile);
+
+            if (EOF == character)
+                break;
+
+            if ('#' != character)
+            {
+                ungetc(character, graphfile);
+                break;
+            }
+
+            if (!(this->ReadHeaderLine(graphfile, linebuf)))
+                break;
+
+            nodesFound = FindHeaderCount(linebuf, kHeaderLabelNodes, numNodes) || nodesFound;
+            edgesFound = FindHeaderCount(linebuf, kHeaderLabelEdges, numEdges) || edgesFound;
+        }
+
+        if (ferror(graphfile))
+            return false;
+
+        headerCountsFound = (nodesFound && edgesFound);
+
+        // Counts obtained by scanning the file take precedence when the file is reopened.
+        if (!countsScanned)
+        {
+            GraphReader<TEdgeData>::numVerticesInFile = (TVertexCount)numNodes;
+            GraphReader<TEdgeData>::numEdgesInFile = (TEdgeCount)numEdges;
+        }
+
+        return true;
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphReader.h" for documentation.
+
+    template <typename TEdgeData> GraphReader<TEdgeData>* SNAPEdgeListReader<TEdgeData>::CreateShardReader(void) const
+    {
+        return new SNAPEdgeListReader<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* SNAPEdgeListReader<TEdgeData>::OpenAndInitializeGraphFileForRead(const char* const filename)
+    {
+        FILE* graphfile = TextEdgeListReader<TEdgeData>::OpenAndInitializeGraphFileForRead(filename);
+
+        if ((NULL == graphfile) || countsScanned || (headerCountsFound && !useCountScan))
+            return graphfile;
+
+        // The counts are unknown, so scan the file for them and then reopen it to be read.
+        const bool scanSucceeded = ScanForCounts(graphfile);
+        fclose(graphfile);
+
+        if (!scanSucceeded)
+            return NULL;
+
+        countsScanned = true;
+        return TextEdgeListReader<TEdgeData>::OpenAndInitializeGraphFileForRead(filename);
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool SNAPEdgeListReader<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if (0 == strcmp(optionName, kReaderOptionCounts))
+        {
+            if (0 == strcmp(optionValue, kReaderOptionCountsHeader))
+                useCountScan = false;
+            else if (0 == strcmp(optionValue, kReaderOptionCountsScan))
+                useCountScan = true;
+            else
+                return false;
+
+            return true;
+        }
+
+        return TextEdgeListReader<TEdgeData>::SubmitOption(optionName, optionValue);
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class SNAPEdgeListReader<void>;
+    template class SNAPEdgeListReader<uint64_t>;
+    template class SNAPEdgeListReader<double>;
+    template class SNAPEdgeListReader<uint32_t>;
+    template class SNAPEdgeListReader<float>;
+}
@@ -0,0 +1,397 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file SortEdgesTransform.cpp
+ *   Implementation of a transformation that sorts the edges of each vertex
+ *   and optionally merges duplicate edges.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "SortEdgesTransform.h"
+#include "Types.h"
+#include "VertexIndex.h"
+#include "WorkScheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <spindle.h>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "SortEdgesTransform.h" for documentation.
+
+    SortEdgesTransform::SortEdgesTransform(const EDuplicateEdgePolicy duplicatePolicy) : GraphTransform(), duplicatePolicy(duplicatePolicy), sharedBuf(NULL), keptDegrees(NULL), workScheduler()
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    SortEdgesTransform::~SortEdgesTransform(void)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "SortEdgesTransform.h" for documentation.
+
+    void SortEdgesTransform::MergeEdgeData(UEdgeData& keptEdgeData, const UEdgeData& duplicateEdgeData, const EDuplicateEdgePolicy duplicatePolicy, const EEdgeDataType edgeDataType)
+    {
+        switch (edgeDataType)
+        {
+        case EEdgeDataType::EdgeDataTypeInteger:
+            switch (duplicatePolicy)
+            {
+            case EDuplicateEdgePolicy::DuplicateEdgePolicyMin:
+                if (duplicateEdgeData.u < keptEdgeData.u)
+                    keptEdgeData.u = duplicateEdgeData.u;
+                break;
+
+            case EDuplicateEdgePolicy::DuplicateEdgePolicyMax:
+                if (duplicateEdgeData.u > keptEdgeData.u)
+                    keptEdgeData.u = duplicateEdgeData.u;
+                break;
+
+            case EDuplicateEdgePolicy::DuplicateEdgePolicySum:
+                keptEdgeData.u += duplicateEdgeData.u;
+                break;
+
+            default:
+                break;
+            }
+            break;
+
+        case EEdgeDataType::EdgeDataTypeFloatingPoint:
+            switch (duplicatePolicy)
+            {
+            case EDuplicateEdgePolicy::DuplicateEdgePolicyMin:
+                if (duplicateEdgeData.d < keptEdgeData.d)
+                    keptEdgeData.d = duplicateEdgeData.d;
+                break;
+
+            case EDuplicateEdgePolicy::DuplicateEdgePolicyMax:
+                if (duplicateEdgeData.d > keptEdgeData.d)
+                    keptEdgeData.d = duplicateEdgeData.d;
+                break;
+
+            case EDuplicateEdgePolicy::DuplicateEdgePolicySum:
+                keptEdgeData.d += duplicateEdgeData.d;
+                break;
+
+            default:
+                break;
+            }
+            break;
+
+        case EEdgeDataType::EdgeDataTypeInteger32:
+            switch (duplicatePolicy)
+            {
+            case EDuplicateEdgePolicy::DuplicateEdgePolicyMin:
+                if (duplicateEdgeData.u < keptEdgeData.u)
+                    keptEdgeData.u = duplicateEdgeData.u;
+                break;
+
+            case EDuplicateEdgePolicy::DuplicateEdgePolicyMax:
+                if (duplicateEdgeData.u > keptEdgeData.u)
+                    keptEdgeData.u = duplicateEdgeData.u;
+                break;
+
+            case EDuplicateEdgePolicy::DuplicateEdgePolicySum:
+                // Sums saturate rather than exceeding what the narrower type can represent.
+                keptEdgeData.u += duplicateEdgeData.u;
+                if (keptEdgeData.u > (uint64_t)UINT32_MAX)
+                    keptEdgeData.u = (uint64_t)UINT32_MAX;
+                break;
+
+            default:
+                break;
+            }
+            break;
+
+        case EEdgeDataType::EdgeDataTypeFloatingPoint32:
+            switch (duplicatePolicy)
+            {
+            case EDuplicateEdgePolicy::DuplicateEdgePolicyMin:
+                if (duplicateEdgeData.d < keptEdgeData.d)
+                    keptEdgeData.d = duplicateEdgeData.d;
+                break;
+
+            case EDuplicateEdgePolicy::DuplicateEdgePolicyMax:
+                if (duplicateEdgeData.d > keptEdgeData.d)
+                    keptEdgeData.d = duplicateEdgeData.d;
+                break;
+
+            case EDuplicateEdgePolicy::DuplicateEdgePolicySum:
+                // Sums are rounded to single precision, so that the result is the same as if the narrower type had been held in memory.
+                keptEdgeData.d = (double)(float)(keptEdgeData.d + duplicateEdgeData.d);
+                break;
+
+            default:
+                break;
+            }
+            break;
+
+        default:
+            // Unweighted graphs have nothing to merge, so the first edge is kept as-is.
+            break;
+        }
+    }
+
+    // --------
+
+    template <typename TNeighbor> void SortEdgesTransform::SortEdges(TNeighbor* const neighbors, UEdgeData* const edgeData, const TEdgeCount count, std::vector<TNeighbor>& scratchNeighbors, std::vector<UEdgeData>& scratchEdgeData)
+    {
+        if (count < 2)
+            return;
+
+        // Small sets of edges are insertion-sorted in place.
+        if (count < kRadixSortThreshold)
+        {
+            for (TEdgeCount i = 1; i < count; ++i)
+            {
+                const TNeighbor neighbor = neighbors[i];
+                const UEdgeData neighborEdgeData = ((NULL != edgeData) ? edgeData[i] : UEdgeData());
+                TEdgeCount j = i;
+
+                for (; (j > 0) && (neighbors[j - 1] > neighbor); --j)
+                {
+                    neighbors[j] = neighbors[j - 1];
+
+                    if (NULL != edgeData)
+                        edgeData[j] = edgeData[j - 1];
+                }
+
+                neighbors[j] = neighbor;
+
+                if (NULL != edgeData)
+                    edgeData[j] = neighborEdgeData;
+            }
+
+            return;
+        }
+
+        // Larger sets of edges are sorted using a least-significant-digit radix sort, one byte at a time.
+        // Only as many bytes as are needed to represent the largest neighbor are considered.
+        TNeighbor maxNeighbor = 0;
+
+        for (TEdgeCount i = 0; i < count; ++i)
+        {
+            if (neighbors[i] > maxNeighbor)
+                maxNeighbor = neighbors[i];
+        }
+
+        if (scratchNeighbors.size() < count)
+            scratchNeighbors.resize(count);
+
+        if ((NULL != edgeData) && (scratchEdgeData.size() < count))
+            scratchEdgeData.resize(count);
+
+        TNeighbor* sourceNeighbors = neighbors;
+        UEdgeData* sourceEdgeData = edgeData;
+        TNeighbor* destinationNeighbors = scratchNeighbors.data();
+        UEdgeData* destinationEdgeData = ((NULL != edgeData) ? scratchEdgeData.data() : NULL);
+
+        for (uint32_t shift = 0; (shift < (8 * sizeof(TNeighbor))) && (0 != (maxNeighbor >> shift)); shift += 8)
+        {
+            TEdgeCount bucketPositions[256];
+            memset((void*)bucketPositions, 0, sizeof(bucketPositions));
+
+            for (TEdgeCount i = 0; i < count; ++i)
+                bucketPositions[(sourceNeighbors[i] >> shift) & 255ull] += 1;
+
+            // If every edge falls into the same bucket, this digit does not affect the order.
+            if (count == bucketPositions[(sourceNeighbors[0] >> shift) & 255ull])
+                continue;
+
+            TEdgeCount bucketStart = 0;
+
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                const TEdgeCount bucketSize = bucketPositions[i];
+                bucketPositions[i] = bucketStart;
+                bucketStart += bucketSize;
+            }
+
+            for (TEdgeCount i = 0; i < count; ++i)
+            {
+                const TEdgeCount position = bucketPositions[(sourceNeighbors[i] >> shift) & 255ull]++;
+                destinationNeighbors[position] = sourceNeighbors[i];
+
+                if (NULL != edgeData)
+                    destinationEdgeData[position] = sourceEdgeData[i];
+            }
+
+            TNeighbor* const swapNeighbors = sourceNeighbors;
+            sourceNeighbors = destinationNeighbors;
+            destinationNeighbors = swapNeighbors;
+
+            UEdgeData* const swapEdgeData = sourceEdgeData;
+            sourceEdgeData = destinationEdgeData;
+            destinationEdgeData = swapEdgeData;
+        }
+
+        // An odd number of passes leaves the sorted edges in scratch space.
+        if (sourceNeighbors != neighbors)
+        {
+            memcpy((void*)neighbors, (void*)sourceNeighbors, sizeof(TNeighbor) * count);
+
+            if (NULL != edgeData)
+                memcpy((void*)edgeData, (void*)sourceEdgeData, sizeof(UEdgeData) * count);
+        }
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "SortEdgesTransform.h" for documentation.
+
+    template <typename TNeighbor> TEdgeCount SortEdgesTransform::DeduplicateEdges(TNeighbor* const neighbors, UEdgeData* const edgeData, const TEdgeCount count, const EEdgeDataType edgeDataType) const
+    {
+        if (count < 2)
+            return count;
+
+        TEdgeCount numKept = 1;
+
+        for (TEdgeCount i = 1; i < count; ++i)
+        {
+            if (neighbors[i] == neighbors[numKept - 1])
+            {
+                if (NULL != edgeData)
+                    MergeEdgeData(edgeData[numKept - 1], edgeData[i], duplicatePolicy, edgeDataType);
+            }
+            else
+            {
+                neighbors[numKept] = neighbors[i];
+
+                if (NULL != edgeData)
+                    edgeData[numKept] = edgeData[i];
+
+                numKept += 1;
+            }
+        }
+
+        return numKept;
+    }
+
+    // --------
+
+    EGraphResult SortEdgesTransform::TransformVertexIndex(VertexIndex& vertexIndex, const EEdgeDataType edgeDataType)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const bool shouldDeduplicate = (EDuplicateEdgePolicy::DuplicateEdgePolicyKeep != duplicatePolicy);
+
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+        TVertexID* const neighbors = vertexIndex.GetFrozenNeighborsWritable();
+        TCompactVertexID* const compactNeighbors = vertexIndex.GetFrozenNeighborsCompactWritable();
+        UEdgeData* const edgeData = vertexIndex.GetFrozenEdgeDataWritable();
+
+        if (shouldDeduplicate)
+        {
+            if (0 == globalThreadID)
+                keptDegrees = new TEdgeCount[vertexIndex.GetNumVertices()];
+
+            spindleBarrierGlobal();
+        }
+
+        // Degrees can vary widely, so work is scheduled in units balanced by the number of edges they hold, but each vertex's edges are sorted by a single thread.
+        std::vector<TVertexID> scratchNeighbors;
+        std::vector<TCompactVertexID> scratchCompactNeighbors;
+        std::vector<UEdgeData> scratchEdgeData;
+
+        workScheduler.ParallelInitialize(offsets, vertexIndex.GetNumVertices(), false);
+
+        SWorkUnit unit;
+
+        while (workScheduler.GetWork(unit))
+        {
+            for (TVertexID vertex = unit.vertexStart; vertex < unit.vertexEnd; ++vertex)
+            {
+                UEdgeData* const vertexEdgeData = ((NULL != edgeData) ? &edgeData[offsets[vertex]] : NULL);
+                const TEdgeCount degree = offsets[vertex + 1] - offsets[vertex];
+
+                if (NULL != compactNeighbors)
+                {
+                    TCompactVertexID* const vertexNeighbors = &compactNeighbors[offsets[vertex]];
+                    SortEdges(vertexNeighbors, vertexEdgeData, degree, scratchCompactNeighbors, scratchEdgeData);
+
+                    if (shouldDeduplicate)
+                        keptDegrees[vertex] = DeduplicateEdges(vertexNeighbors, vertexEdgeData, degree, edgeDataType);
+                }
+                else
+                {
+                    TVertexID* const vertexNeighbors = &neighbors[offsets[vertex]];
+                    SortEdges(vertexNeighbors, vertexEdgeData, degree, scratchNeighbors, scratchEdgeData);
+
+                    if (shouldDeduplicate)
+                        keptDegrees[vertex] = DeduplicateEdges(vertexNeighbors, vertexEdgeData, degree, edgeDataType);
+                }
+            }
+        }
+
+        spindleBarrierGlobal();
+
+        // Merging duplicates leaves gaps at the end of each vertex's edges, which are closed up here.
+        if (shouldDeduplicate)
+        {
+            vertexIndex.ParallelCompactFrozen(keptDegrees, sharedBuf);
+
+            if (0 == globalThreadID)
+            {
+                delete[] keptDegrees;
+                keptDegrees = NULL;
+            }
+        }
+
+        if (0 == globalThreadID)
+            vertexIndex.MarkFrozenSorted();
+
+        spindleBarrierGlobal();
+
+        return EGraphResult::GraphResultSuccess;
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphTransform.h" for documentation.
+
+    EGraphResult SortEdgesTransform::TransformGraph(Graph& graph)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        if (0 == globalThreadID)
+            sharedBuf = new uint64_t[globalThreadCount << 2];
+
+        spindleBarrierGlobal();
+
+        // Sorting happens in place within the compact representation.
+        graph.ParallelFreeze(sharedBuf);
+
+        // All threads must take part in transforming each maintained vertex index, even if an error occurs, so that the barriers within match up.
+        const EGraphResult destinationResult = (graph.HasEdgesByDestination() ? TransformVertexIndex(graph.VertexIndexDestinationWritable(), graph.GetEdgeDataType()) : EGraphResult::GraphResultSuccess);
+        const EGraphResult sourceResult = (graph.HasEdgesBySource() ? TransformVertexIndex(graph.VertexIndexSourceWritable(), graph.GetEdgeDataType()) : EGraphResult::GraphResultSuccess);
+
+        // Merging duplicates changes edge counts, but compaction keeps metadata up to date, so no separate refresh is needed.
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            delete[] sharedBuf;
+            sharedBuf = NULL;
+        }
+
+        if (EGraphResult::GraphResultSuccess != destinationResult)
+            return destinationResult;
+        else
+            return sourceResult;
+    }
+}
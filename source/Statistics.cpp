@@ -0,0 +1,359 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file Statistics.cpp
+ *   Collection and reporting of per-phase timing and throughput statistics.
+ *****************************************************************************/
+
+#include "Statistics.h"
+#include "MemoryTracker.h"
+#include "VersionInfo.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <spindle.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __PLATFORM_LINUX
+#include <sys/resource.h>
+#endif
+
+#ifdef __PLATFORM_WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+
+namespace GraphTool
+{
+    // -------- CONSTANTS -------------------------------------------------- //
+
+    /// Number of bytes in a megabyte, for the purpose of reporting throughput.
+    static const double kBytesPerMegabyte = 1048576.0;
+
+    /// Number of nanoseconds in a second.
+    static const double kNanosecondsPerSecond = 1000000000.0;
+
+
+    // -------- TYPE DEFINITIONS ------------------------------------------- //
+
+    /// Holds the statistics collected for a single phase.
+    struct SStatisticsPhase
+    {
+        std::string name;                                                   ///< Name of the phase.
+        uint64_t startTime;                                                 ///< Timestamp at which the phase began, in nanoseconds.
+        uint64_t elapsedTime;                                               ///< Wall time of the phase, in nanoseconds. Valid only once the phase has ended.
+        uint64_t numBytes;                                                  ///< Number of bytes processed.
+        uint64_t numEdges;                                                  ///< Number of edges processed.
+        uint64_t peakTrackedBytes;                                          ///< Largest amount of memory held by tracked allocations at once during the phase. Valid only once the phase has ended.
+        std::vector<std::pair<std::string, uint64_t>> detailTimes;          ///< Time spent in each named activity within the phase, in nanoseconds, in the order first recorded.
+    };
+
+
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Indicates that statistics are being collected.
+    static bool statisticsEnabled = false;
+
+    /// Indicates that the last phase in the list of phases is still in progress.
+    static bool statisticsPhaseInProgress = false;
+
+    /// Holds all phases recorded so far, in the order in which they began.
+    static std::vector<SStatisticsPhase> statisticsPhases;
+
+    /// Serializes updates to the current phase, which may come from multiple threads.
+    static std::mutex statisticsMutex;
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Computes a rate from a quantity and a time period, avoiding division by zero.
+    /// @param [in] quantity Quantity processed.
+    /// @param [in] elapsedTime Time taken to process it, in nanoseconds.
+    /// @return Quantity processed per second, or 0 if no time elapsed.
+    static double ComputeRatePerSecond(const double quantity, const uint64_t elapsedTime)
+    {
+        if (0 == elapsedTime)
+            return 0.0;
+
+        return quantity / ((double)elapsedTime / kNanosecondsPerSecond);
+    }
+
+    /// Writes a string to a file as a quoted JSON string, escaping any characters that JSON does not allow to appear directly.
+    /// @param [in] jsonfile File to which to write.
+    /// @param [in] value String to write.
+    static void WriteJSONString(FILE* const jsonfile, const std::string& value)
+    {
+        fputc('"', jsonfile);
+
+        for (size_t i = 0; i < value.length(); ++i)
+        {
+            const unsigned char c = (unsigned char)value[i];
+
+            if (('"' == c) || ('\\' == c))
+                fprintf(jsonfile, "\\%c", c);
+            else if (c < 0x20)
+                fprintf(jsonfile, "\\u%04x", (unsigned int)c);
+            else
+                fputc(c, jsonfile);
+        }
+
+        fputc('"', jsonfile);
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "Statistics.h" for documentation.
+
+    void Statistics::AddPhaseCounts(const uint64_t numBytes, const uint64_t numEdges)
+    {
+        if (!statisticsEnabled)
+            return;
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+
+        if (!statisticsPhaseInProgress)
+            return;
+
+        statisticsPhases.back().numBytes += numBytes;
+        statisticsPhases.back().numEdges += numEdges;
+    }
+
+    // --------
+
+    void Statistics::AddPhaseDetailTime(const char* const detailName, const uint64_t elapsedTime)
+    {
+        if (!statisticsEnabled)
+            return;
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+
+        if (!statisticsPhaseInProgress)
+            return;
+
+        std::vector<std::pair<std::string, uint64_t>>& detailTimes = statisticsPhases.back().detailTimes;
+
+        for (size_t i = 0; i < detailTimes.size(); ++i)
+        {
+            if (detailTimes[i].first == detailName)
+            {
+                detailTimes[i].second += elapsedTime;
+                return;
+            }
+        }
+
+        detailTimes.push_back(std::make_pair(std::string(detailName), elapsedTime));
+    }
+
+    // --------
+
+    void Statistics::BeginPhase(const char* const phaseName)
+    {
+        if (!statisticsEnabled)
+            return;
+
+        EndPhase();
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        SStatisticsPhase phase;
+
+        phase.name = phaseName;
+        phase.elapsedTime = 0;
+        phase.numBytes = 0;
+        phase.numEdges = 0;
+        phase.peakTrackedBytes = 0;
+        phase.startTime = GetTimestamp();
+
+        MemoryTracker::ResetIntervalPeak();
+
+        statisticsPhases.push_back(phase);
+        statisticsPhaseInProgress = true;
+    }
+
+    // --------
+
+    void Statistics::Enable(void)
+    {
+        statisticsEnabled = true;
+    }
+
+    // --------
+
+    void Statistics::EndPhase(void)
+    {
+        if (!statisticsEnabled)
+            return;
+
+        const uint64_t endTime = GetTimestamp();
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+
+        if (!statisticsPhaseInProgress)
+            return;
+
+        statisticsPhases.back().elapsedTime = endTime - statisticsPhases.back().startTime;
+        statisticsPhases.back().peakTrackedBytes = MemoryTracker::GetIntervalPeakBytes();
+        statisticsPhaseInProgress = false;
+    }
+
+    // --------
+
+    uint64_t Statistics::GetPeakResidentSetSize(void)
+    {
+#ifdef __PLATFORM_LINUX
+        struct rusage resourceUsage;
+
+        // Linux reports the maximum resident set size in kilobytes.
+        if (0 == getrusage(RUSAGE_SELF, &resourceUsage))
+            return (uint64_t)resourceUsage.ru_maxrss * 1024ull;
+#endif
+
+#ifdef __PLATFORM_WINDOWS
+        PROCESS_MEMORY_COUNTERS memoryCounters;
+
+        if (0 != GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+            return (uint64_t)memoryCounters.PeakWorkingSetSize;
+#endif
+
+        return 0;
+    }
+
+    // --------
+
+    uint64_t Statistics::GetTimestamp(void)
+    {
+        if (!statisticsEnabled)
+            return 0;
+
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // --------
+
+    bool Statistics::IsEnabled(void)
+    {
+        return statisticsEnabled;
+    }
+
+    // --------
+
+    void Statistics::PrintSummary(void)
+    {
+        if (!statisticsEnabled)
+            return;
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+
+        printf("Statistics:\n");
+        printf("  %-32s %12s %12s %14s %12s %14s %12s\n", "Phase", "Time (s)", "Data (MB)", "Edges", "MB/s", "Edges/s", "Memory (MB)");
+
+        for (size_t i = 0; i < statisticsPhases.size(); ++i)
+        {
+            const SStatisticsPhase& phase = statisticsPhases[i];
+
+            if (statisticsPhaseInProgress && (i == (statisticsPhases.size() - 1)))
+                break;
+
+            printf("  %-32s %12.4f %12.2f %14llu %12.2f %14.0f %12.2f\n", phase.name.c_str(), (double)phase.elapsedTime / kNanosecondsPerSecond, (double)phase.numBytes / kBytesPerMegabyte, (long long unsigned int)phase.numEdges, ComputeRatePerSecond((double)phase.numBytes / kBytesPerMegabyte, phase.elapsedTime), ComputeRatePerSecond((double)phase.numEdges, phase.elapsedTime), (double)phase.peakTrackedBytes / kBytesPerMegabyte);
+
+            for (size_t j = 0; j < phase.detailTimes.size(); ++j)
+                printf("      %-28s %12.4f\n", phase.detailTimes[j].first.c_str(), (double)phase.detailTimes[j].second / kNanosecondsPerSecond);
+        }
+
+        // Category peaks need not coincide, so they are reported alongside the overall peak rather than as a breakdown of it.
+        printf("  Peak tracked memory: %.2f MB (", (double)MemoryTracker::GetPeakBytes() / kBytesPerMegabyte);
+
+        for (int i = 0; i < (int)MemoryTracker::MemoryCategoryCount; ++i)
+            printf("%s%s %.2f MB", ((0 == i) ? "" : ", "), MemoryTracker::GetCategoryName((MemoryTracker::EMemoryCategory)i), (double)MemoryTracker::GetPeakBytes((MemoryTracker::EMemoryCategory)i) / kBytesPerMegabyte);
+
+        printf(")\n");
+
+        if (0 != MemoryTracker::GetEstimatedBytes())
+        {
+            if (0 != MemoryTracker::GetEstimateAvailableBytes())
+                printf("  Estimated ingress memory: %.2f MB of %.2f MB available\n", (double)MemoryTracker::GetEstimatedBytes() / kBytesPerMegabyte, (double)MemoryTracker::GetEstimateAvailableBytes() / kBytesPerMegabyte);
+            else
+                printf("  Estimated ingress memory: %.2f MB\n", (double)MemoryTracker::GetEstimatedBytes() / kBytesPerMegabyte);
+        }
+
+        printf("  Peak resident memory: %.2f MB\n", (double)GetPeakResidentSetSize() / kBytesPerMegabyte);
+    }
+
+    // --------
+
+    uint64_t Statistics::TimedBarrierGlobal(void)
+    {
+        const uint64_t waitStartTime = GetTimestamp();
+        spindleBarrierGlobal();
+
+        return GetTimestamp() - waitStartTime;
+    }
+
+    // --------
+
+    bool Statistics::WriteToJSONFile(const char* const filename)
+    {
+        FILE* jsonfile = fopen(filename, "w");
+        if (NULL == jsonfile)
+            return false;
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+
+        fprintf(jsonfile, "{\n  \"peakResidentBytes\": %llu,\n", (long long unsigned int)GetPeakResidentSetSize());
+        fprintf(jsonfile, "  \"peakTrackedBytes\": %llu,\n", (long long unsigned int)MemoryTracker::GetPeakBytes());
+        fprintf(jsonfile, "  \"peakTrackedBytesByCategory\": {");
+
+        for (int i = 0; i < (int)MemoryTracker::MemoryCategoryCount; ++i)
+        {
+            fprintf(jsonfile, "%s\n    ", ((0 == i) ? "" : ","));
+            WriteJSONString(jsonfile, MemoryTracker::GetCategoryName((MemoryTracker::EMemoryCategory)i));
+            fprintf(jsonfile, ": %llu", (long long unsigned int)MemoryTracker::GetPeakBytes((MemoryTracker::EMemoryCategory)i));
+        }
+
+        fprintf(jsonfile, "\n  },\n");
+        fprintf(jsonfile, "  \"estimatedIngressBytes\": %llu,\n", (long long unsigned int)MemoryTracker::GetEstimatedBytes());
+        fprintf(jsonfile, "  \"availableBytes\": %llu,\n", (long long unsigned int)MemoryTracker::GetEstimateAvailableBytes());
+        fprintf(jsonfile, "  \"phases\": [");
+
+        for (size_t i = 0; i < statisticsPhases.size(); ++i)
+        {
+            const SStatisticsPhase& phase = statisticsPhases[i];
+
+            if (statisticsPhaseInProgress && (i == (statisticsPhases.size() - 1)))
+                break;
+
+            fprintf(jsonfile, "%s\n    {\n      \"name\": ", ((0 == i) ? "" : ","));
+            WriteJSONString(jsonfile, phase.name);
+            fprintf(jsonfile, ",\n      \"seconds\": %.9f,\n", (double)phase.elapsedTime / kNanosecondsPerSecond);
+            fprintf(jsonfile, "      \"bytes\": %llu,\n", (long long unsigned int)phase.numBytes);
+            fprintf(jsonfile, "      \"edges\": %llu,\n", (long long unsigned int)phase.numEdges);
+            fprintf(jsonfile, "      \"megabytesPerSecond\": %.6f,\n", ComputeRatePerSecond((double)phase.numBytes / kBytesPerMegabyte, phase.elapsedTime));
+            fprintf(jsonfile, "      \"edgesPerSecond\": %.3f,\n", ComputeRatePerSecond((double)phase.numEdges, phase.elapsedTime));
+            fprintf(jsonfile, "      \"peakTrackedBytes\": %llu,\n", (long long unsigned int)phase.peakTrackedBytes);
+            fprintf(jsonfile, "      \"details\": {");
+
+            for (size_t j = 0; j < phase.detailTimes.size(); ++j)
+            {
+                fprintf(jsonfile, "%s\n        ", ((0 == j) ? "" : ","));
+                WriteJSONString(jsonfile, phase.detailTimes[j].first);
+                fprintf(jsonfile, ": %.9f", (double)phase.detailTimes[j].second / kNanosecondsPerSecond);
+            }
+
+            fprintf(jsonfile, "%s}\n    }", ((0 == phase.detailTimes.size()) ? "" : "\n      "));
+        }
+
+        fprintf(jsonfile, "%s]\n}\n", ((0 == statisticsPhases.size()) ? "" : "\n  "));
+
+        const bool writeSucceeded = !(ferror(jsonfile));
+        return ((0 == fclose(jsonfile)) && writeSucceeded);
+    }
+}
@@ -0,0 +1,164 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file SymmetrizeTransform.cpp
+ *   Implementation of a graph transformation that makes a graph undirected by
+ *   adding the reverse of every edge.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "GraphTransform.h"
+#include "SortEdgesTransform.h"
+#include "SymmetrizeTransform.h"
+#include "Types.h"
+#include "VertexIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <spindle.h>
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Transformation option that specifies how duplicate edges are merged.
+    static const char* const kTransformOptionMerge = "merge";
+
+    /// Maps values of the merge option to the corresponding policies for merging duplicate edges.
+    static const struct
+    {
+        const char* name;
+        EDuplicateEdgePolicy policy;
+    } kMergePolicies[] = {
+        { "first",                                                          EDuplicateEdgePolicy::DuplicateEdgePolicyFirst },
+        { "min",                                                            EDuplicateEdgePolicy::DuplicateEdgePolicyMin },
+        { "max",                                                            EDuplicateEdgePolicy::DuplicateEdgePolicyMax },
+        { "sum",                                                            EDuplicateEdgePolicy::DuplicateEdgePolicySum },
+    };
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "SymmetrizeTransform.h" for documentation.
+
+    SymmetrizeTransform::SymmetrizeTransform(void) : GraphTransform(), duplicatePolicy(EDuplicateEdgePolicy::DuplicateEdgePolicyFirst), sharedBuf(NULL), edgeBuf(NULL), sortTransform(NULL), transposedIndex(), symmetrizedDestination(), symmetrizedSource()
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    SymmetrizeTransform::~SymmetrizeTransform(void)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphTransform.h" for documentation.
+
+    bool SymmetrizeTransform::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if (0 == strcmp(optionName, kTransformOptionMerge))
+        {
+            for (size_t i = 0; i < (sizeof(kMergePolicies) / sizeof(kMergePolicies[0])); ++i)
+            {
+                if (0 == strcmp(optionValue, kMergePolicies[i].name))
+                {
+                    duplicatePolicy = kMergePolicies[i].policy;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        return GraphTransform::SubmitOption(optionName, optionValue);
+    }
+
+    // --------
+
+    EGraphResult SymmetrizeTransform::TransformGraph(Graph& graph)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        const bool keepEdgeData = (EEdgeDataType::EdgeDataTypeVoid != graph.GetEdgeDataType());
+
+        if (0 == globalThreadID)
+        {
+            sharedBuf = new uint64_t[(globalThreadCount * globalThreadCount) + (globalThreadCount << 2) + 1];
+            sortTransform = new SortEdgesTransform(duplicatePolicy);
+        }
+
+        spindleBarrierGlobal();
+
+        // Reverse edges are gathered from the frozen representation of the other grouping.
+        graph.ParallelFreeze(sharedBuf);
+
+        VertexIndex& vertexIndexDestination = graph.VertexIndexDestinationWritable();
+        VertexIndex& vertexIndexSource = graph.VertexIndexSourceWritable();
+
+        if (graph.HasEdgesByDestination() && graph.HasEdgesBySource())
+        {
+            // Each grouping already holds the transpose of the other, so both can be symmetrized directly.
+            // Taking the original edges first from each grouping means that both agree on which duplicate comes first.
+            symmetrizedSource.ParallelSymmetrizeFrozen(vertexIndexSource, vertexIndexDestination, keepEdgeData, sharedBuf);
+            symmetrizedDestination.ParallelSymmetrizeFrozen(vertexIndexDestination, vertexIndexSource, keepEdgeData, sharedBuf);
+
+            if (0 == globalThreadID)
+            {
+                vertexIndexSource.Swap(symmetrizedSource);
+                vertexIndexDestination.Swap(symmetrizedDestination);
+                symmetrizedSource.Clear();
+                symmetrizedDestination.Clear();
+            }
+        }
+        else
+        {
+            // Only one grouping is maintained, so its transpose is built temporarily to supply the reverse edges.
+            VertexIndex& vertexIndex = (graph.HasEdgesBySource() ? vertexIndexSource : vertexIndexDestination);
+
+            if (0 == globalThreadID)
+                edgeBuf = new uint64_t[(vertexIndex.GetFrozenOffsets()[vertexIndex.GetNumVertices()] << 1) + 1];
+
+            spindleBarrierGlobal();
+
+            transposedIndex.ParallelTransposeFrom(vertexIndex, keepEdgeData, edgeBuf, sharedBuf);
+            symmetrizedSource.ParallelSymmetrizeFrozen(vertexIndex, transposedIndex, keepEdgeData, sharedBuf);
+
+            if (0 == globalThreadID)
+            {
+                delete[] edgeBuf;
+                edgeBuf = NULL;
+
+                vertexIndex.Swap(symmetrizedSource);
+                symmetrizedSource.Clear();
+                transposedIndex.Clear();
+            }
+        }
+
+        spindleBarrierGlobal();
+
+        // Sorting brings duplicates together so that they can be merged, which also keeps metadata up to date.
+        const EGraphResult sortResult = sortTransform->TransformGraph(graph);
+
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            delete sortTransform;
+            sortTransform = NULL;
+
+            delete[] sharedBuf;
+            sharedBuf = NULL;
+        }
+
+        return sortResult;
+    }
+}
@@ -0,0 +1,375 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file SyntheticGraphReader.cpp
+ *   Implementation of a graph reader that generates synthetic graphs.
+ *****************************************************************************/
+
+#include "GraphReader.h"
+#include "SyntheticGraphReader.h"
+#include "Types.h"
+#include "VersionInfo.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- CONSTANTS -------------------------------------------------- //
+
+    /// Reader option that selects the model used to generate edges.
+    static const char* const kReaderOptionGenerator = "generator";
+
+    /// Value of the generator option that selects the R-MAT model with the Graph500 parameters. This is the default.
+    static const char* const kReaderOptionGeneratorRMAT = "rmat";
+
+    /// Value of the generator option that is equivalent to the R-MAT model, named after the Graph500 Kronecker generator.
+    static const char* const kReaderOptionGeneratorKronecker = "kronecker";
+
+    /// Value of the generator option that selects the uniform random model.
+    static const char* const kReaderOptionGeneratorUniform = "uniform";
+
+    /// Reader option that specifies the base-2 logarithm of the number of vertices.
+    static const char* const kReaderOptionScale = "scale";
+
+    /// Reader option that specifies the number of edges per vertex.
+    static const char* const kReaderOptionEdgeFactor = "edgefactor";
+
+    /// Reader option that specifies the seed from which every edge is derived.
+    static const char* const kReaderOptionSeed = "seed";
+
+    /// Reader option that specifies whether vertex identifiers are scrambled.
+    static const char* const kReaderOptionScramble = "scramble";
+
+    /// Name of the device that yields no data, opened in place of an input file.
+#ifdef __PLATFORM_WINDOWS
+    static const char* const kNullDeviceName = "NUL";
+#endif
+#ifdef __PLATFORM_LINUX
+    static const char* const kNullDeviceName = "/dev/null";
+#endif
+
+    /// Cumulative R-MAT quadrant probabilities, scaled to 16 bits. Quadrants A, B, C, and D have probabilities 0.57, 0.19, 0.19, and 0.05, respectively.
+    static const uint64_t kRMATThresholdA = 37356;
+    static const uint64_t kRMATThresholdAB = 49807;
+    static const uint64_t kRMATThresholdABC = 62259;
+
+    /// Multiplier used to derive the starting state of each edge's random number sequence from the seed.
+    static const uint64_t kSeedMultiplier = 0xd1b54a32d192ed03ull;
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Parses an unsigned decimal integer option value, rejecting anything that is not entirely a number.
+    /// @param [in] optionValue Option value string.
+    /// @param [out] value Parsed value, if parsing succeeds.
+    /// @return `true` if parsing was successful, `false` otherwise.
+    static bool ParseUnsignedOptionValue(const char* const optionValue, uint64_t& value)
+    {
+        char* valueEnd = NULL;
+
+        if (('\0' == optionValue[0]) || ('-' == optionValue[0]))
+            return false;
+
+        value = (uint64_t)strtoull(optionValue, &valueEnd, 10);
+        return ('\0' == *valueEnd);
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "SyntheticGraphReader.h" for documentation.
+
+    template <typename TEdgeData> SyntheticGraphReader<TEdgeData>::SyntheticGraphReader(void) : GraphReader<TEdgeData>(), model(GeneratorModelRMAT), scale(16), edgeFactor(16), seed(1), scrambleVertices(true), nextEdge(0)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "SyntheticGraphReader.h" for documentation.
+
+    template <> void SyntheticGraphReader<void>::GenerateEdgeData(uint64_t& randomState, SEdge<void>& edge)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    template <> void SyntheticGraphReader<uint64_t>::GenerateEdgeData(uint64_t& randomState, SEdge<uint64_t>& edge)
+    {
+        edge.edgeData = (NextRandom(randomState) >> 49ull) + 1ull;
+    }
+
+    // --------
+
+    template <> void SyntheticGraphReader<double>::GenerateEdgeData(uint64_t& randomState, SEdge<double>& edge)
+    {
+        // The upper 53 bits fill the mantissa of a double exactly.
+        edge.edgeData = (double)(NextRandom(randomState) >> 11ull) * (1.0 / 9007199254740992.0);
+    }
+
+    // --------
+
+    template <> void SyntheticGraphReader<uint32_t>::GenerateEdgeData(uint64_t& randomState, SEdge<uint32_t>& edge)
+    {
+        edge.edgeData = (uint32_t)(NextRandom(randomState) >> 49ull) + 1u;
+    }
+
+    // --------
+
+    template <> void SyntheticGraphReader<float>::GenerateEdgeData(uint64_t& randomState, SEdge<float>& edge)
+    {
+        // The upper 24 bits fill the mantissa of a float exactly.
+        edge.edgeData = (float)(NextRandom(randomState) >> 40ull) * (1.0f / 16777216.0f);
+    }
+
+    // --------
+
+    template <typename TEdgeData> uint64_t SyntheticGraphReader<TEdgeData>::NextRandom(uint64_t& randomState)
+    {
+        randomState += 0x9e3779b97f4a7c15ull;
+
+        uint64_t result = randomState;
+        result = (result ^ (result >> 30ull)) * 0xbf58476d1ce4e5b9ull;
+        result = (result ^ (result >> 27ull)) * 0x94d049bb133111ebull;
+
+        return result ^ (result >> 31ull);
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "SyntheticGraphReader.h" for documentation.
+
+    template <typename TEdgeData> void SyntheticGraphReader<TEdgeData>::GenerateEdge(const TEdgeCount edgeIndex, SEdge<TEdgeData>& edge) const
+    {
+        // Every edge has its own random number sequence, which depends only on the seed and the position of the edge.
+        uint64_t randomState = (uint64_t)edgeIndex ^ (seed * kSeedMultiplier);
+        TVertexID sourceVertex = 0;
+        TVertexID destinationVertex = 0;
+
+        switch (model)
+        {
+        case GeneratorModelRMAT:
+            {
+                // Each level of the recursion picks a quadrant of the adjacency matrix, consuming 16 random bits, and thereby fixes one bit of each endpoint.
+                uint64_t randomBits = 0;
+                uint64_t numRandomBitsAvailable = 0;
+
+                for (uint64_t level = 0; level < scale; ++level)
+                {
+                    if (0 == numRandomBitsAvailable)
+                    {
+                        randomBits = NextRandom(randomState);
+                        numRandomBitsAvailable = 64;
+                    }
+
+                    const uint64_t quadrant = randomBits & 0xffffull;
+                    randomBits >>= 16ull;
+                    numRandomBitsAvailable -= 16;
+
+                    sourceVertex <<= 1ull;
+                    destinationVertex <<= 1ull;
+
+                    if (quadrant >= kRMATThresholdABC)
+                    {
+                        sourceVertex |= 1ull;
+                        destinationVertex |= 1ull;
+                    }
+                    else if (quadrant >= kRMATThresholdAB)
+                    {
+                        sourceVertex |= 1ull;
+                    }
+                    else if (quadrant >= kRMATThresholdA)
+                    {
+                        destinationVertex |= 1ull;
+                    }
+                }
+            }
+            break;
+
+        case GeneratorModelUniform:
+            sourceVertex = NextRandom(randomState) >> (64ull - scale);
+            destinationVertex = NextRandom(randomState) >> (64ull - scale);
+            break;
+        }
+
+        if (scrambleVertices)
+        {
+            sourceVertex = ScrambleVertex(sourceVertex);
+            destinationVertex = ScrambleVertex(destinationVertex);
+        }
+
+        edge.sourceVertex = sourceVertex;
+        edge.destinationVertex = destinationVertex;
+        GenerateEdgeData(randomState, edge);
+    }
+
+    // --------
+
+    template <typename TEdgeData> TVertexID SyntheticGraphReader<TEdgeData>::ScrambleVertex(const TVertexID vertex) const
+    {
+        // Exclusive-or with a constant, multiplication by an odd constant, and exclusive-or with a right shift of itself are each invertible modulo a power of two, and so is any composition of them.
+        const uint64_t mask = (1ull << scale) - 1ull;
+        const uint64_t shift = (scale + 1ull) >> 1ull;
+        uint64_t result = (uint64_t)vertex ^ ((seed * kSeedMultiplier) & mask);
+
+        result = (result * 0x9e3779b97f4a7c15ull) & mask;
+        result ^= (result >> shift);
+        result = (result * 0xbf58476d1ce4e5b9ull) & mask;
+        result ^= (result >> shift);
+
+        return (TVertexID)result;
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphReader.h" for documentation.
+
+    template <typename TEdgeData> FILE* SyntheticGraphReader<TEdgeData>::OpenAndInitializeGraphFileForRead(const char* const filename)
+    {
+        // The specified filename only names the graph, since edges are generated rather than read.
+        // The base class still needs a file, so the null device is used in its place.
+        if ((edgeFactor >> (63ull - scale)) != 0ull)
+            return NULL;
+
+        FILE* graphfile = fopen(kNullDeviceName, "rb");
+
+        if (NULL != graphfile)
+        {
+            GraphReader<TEdgeData>::numVerticesInFile = (TVertexCount)(1ull << scale);
+            GraphReader<TEdgeData>::numEdgesInFile = (TEdgeCount)(edgeFactor << scale);
+        }
+
+        nextEdge = 0;
+        return graphfile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void SyntheticGraphReader<TEdgeData>::ParseEdgesFromChunk(const char* const chunk, const size_t chunkSize, const size_t rangeStart, const size_t rangeEnd, std::vector<SEdge<TEdgeData>>& edges) const
+    {
+        // The chunk holds the position of its first edge, and each thread generates the edges whose nominal bytes begin within its range.
+        TEdgeCount firstEdge;
+        memcpy((void*)&firstEdge, (void*)chunk, sizeof(firstEdge));
+
+        const size_t rangeFirstEdge = (rangeStart + kBytesPerChunkEdge - 1) / kBytesPerChunkEdge;
+        const size_t rangeEndEdge = (rangeEnd + kBytesPerChunkEdge - 1) / kBytesPerChunkEdge;
+        const size_t firstGeneratedEdge = edges.size();
+
+        edges.resize(firstGeneratedEdge + (rangeEndEdge - rangeFirstEdge));
+
+        for (size_t i = rangeFirstEdge; i < rangeEndEdge; ++i)
+            GenerateEdge(firstEdge + (TEdgeCount)i, edges[firstGeneratedEdge + (i - rangeFirstEdge)]);
+    }
+
+    // --------
+
+    template <typename TEdgeData> size_t SyntheticGraphReader<TEdgeData>::ReadChunkToBuffer(FILE* const graphfile, char* const buf, const size_t size, const TEdgeCount maxEdges)
+    {
+        TEdgeCount numEdges = (TEdgeCount)(size / kBytesPerChunkEdge);
+
+        if (maxEdges < numEdges)
+            numEdges = maxEdges;
+
+        if ((GraphReader<TEdgeData>::numEdgesInFile - nextEdge) < numEdges)
+            numEdges = GraphReader<TEdgeData>::numEdgesInFile - nextEdge;
+
+        if (0 == numEdges)
+            return 0;
+
+        memcpy((void*)buf, (void*)&nextEdge, sizeof(nextEdge));
+        nextEdge += numEdges;
+
+        return (size_t)numEdges * kBytesPerChunkEdge;
+    }
+
+    // --------
+
+    template <typename TEdgeData> TEdgeCount SyntheticGraphReader<TEdgeData>::ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count)
+    {
+        // Edges are always generated in parallel by the consumers, so edges are never read directly.
+        return 0;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool SyntheticGraphReader<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if (0 == strcmp(optionName, kReaderOptionGenerator))
+        {
+            if ((0 == strcmp(optionValue, kReaderOptionGeneratorRMAT)) || (0 == strcmp(optionValue, kReaderOptionGeneratorKronecker)))
+                model = GeneratorModelRMAT;
+            else if (0 == strcmp(optionValue, kReaderOptionGeneratorUniform))
+                model = GeneratorModelUniform;
+            else
+                return false;
+
+            return true;
+        }
+
+        if (0 == strcmp(optionName, kReaderOptionScale))
+        {
+            uint64_t value;
+
+            if (!(ParseUnsignedOptionValue(optionValue, value)) || (value < 1) || (value > kMaxScale))
+                return false;
+
+            scale = value;
+            return true;
+        }
+
+        if (0 == strcmp(optionName, kReaderOptionEdgeFactor))
+        {
+            uint64_t value;
+
+            if (!(ParseUnsignedOptionValue(optionValue, value)) || (value < 1))
+                return false;
+
+            edgeFactor = value;
+            return true;
+        }
+
+        if (0 == strcmp(optionName, kReaderOptionSeed))
+            return ParseUnsignedOptionValue(optionValue, seed);
+
+        if (0 == strcmp(optionName, kReaderOptionScramble))
+        {
+            if (0 == strcmp(optionValue, "true"))
+                scrambleVertices = true;
+            else if (0 == strcmp(optionValue, "false"))
+                scrambleVertices = false;
+            else
+                return false;
+
+            return true;
+        }
+
+        return GraphReader<TEdgeData>::SubmitOption(optionName, optionValue);
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool SyntheticGraphReader<TEdgeData>::UsesParallelParsing(void) const
+    {
+        return true;
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class SyntheticGraphReader<void>;
+    template class SyntheticGraphReader<uint64_t>;
+    template class SyntheticGraphReader<double>;
+    template class SyntheticGraphReader<uint32_t>;
+    template class SyntheticGraphReader<float>;
+}
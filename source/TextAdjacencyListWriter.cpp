@@ -10,72 +10,249 @@
  *   Implementation of a graph writer for text adjacency list files.
  *****************************************************************************/
 
+#include "EdgeList.h"
 #include "Graph.h"
 #include "GraphWriter.h"
+#include "NUMASpawner.h"
+#include "PlatformFunctions.h"
 #include "TextAdjacencyListWriter.h"
+#include "TextFormatter.h"
 #include "Types.h"
 #include "VertexIndex.h"
+#include "WorkScheduler.h"
 
 #include <cstddef>
 #include <cstdlib>
 #include <cstdint>
 #include <cstdio>
+#include <spindle.h>
+#include <vector>
 
 
 namespace GraphTool
 {
     // -------- LOCALS ----------------------------------------------------- //
-    
+
     // File header for unweighted graphs.
     static const char unweightedHeader[] = "AdjacencyGraph";
-    
+
     // File header for weighted graphs.
     static const char weightedHeader[] = "WeightedAdjacencyGraph";
-    
-    
+
+#ifdef __PLATFORM_WINDOWS
+    /// Number of bytes that each newline occupies in a file written in text mode, which on this platform expands it to a carriage return and a line feed.
+    static const uint64_t kNewlineSize = 2;
+#else
+    /// Number of bytes that each newline occupies in a file written in text mode.
+    static const uint64_t kNewlineSize = 1;
+#endif
+
+
+    // -------- TYPE DEFINITIONS ------------------------------------------- //
+
+    /// Provides all information needed to specify the parallel measurement of the neighbors section.
+    struct SNeighborsSectionMeasureSpec
+    {
+        const VertexIndex* vertexIndex;                                     ///< Vertex index whose edges make up the neighbors section.
+        const SGraphPartition* partition;                                   ///< Part of the graph being written, outside of which top-level vertices have no edges.
+        uint64_t* neighborsSectionSizes;                                    ///< Size of each thread's portion of the neighbors section.
+        uint64_t neighborsSectionSize;                                      ///< Total size of the neighbors section, in bytes.
+        WorkScheduler workScheduler;                                        ///< Hands out the edges of a frozen vertex index, in units balanced by the number of edges they hold.
+    };
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Appends a vertex offset as a line of text, for use with GraphWriter::WriteVertexOffsetsToFile.
+    /// @param [in,out] output Buffer to which the offset should be appended.
+    /// @param [in] offset Offset to append.
+    /// @param [in] offsetSize Unused, because the length of each line depends on the offset.
+    static void AppendTextOffset(std::vector<char>& output, const TEdgeCount offset, const size_t offsetSize)
+    {
+        char lineString[TextFormatter::kMaxUnsignedIntegerLength + 1];
+
+        const size_t lineStringLength = TextFormatter::FormatUnsignedInteger(lineString, (uint64_t)offset);
+        lineString[lineStringLength] = '\n';
+        output.insert(output.end(), lineString, &lineString[lineStringLength + 1]);
+    }
+
+    /// Spindle entry point for measuring the neighbors section, whose lines each hold the vertex at the other end of one edge.
+    /// Only the edges of top-level vertices that belong to the partition being written are measured.
+    /// @param [in] arg Pointer to an SNeighborsSectionMeasureSpec object that defines the operation.
+    static void ParallelMeasureNeighborsSectionFunc(void* arg)
+    {
+        SNeighborsSectionMeasureSpec* const measureSpec = (SNeighborsSectionMeasureSpec*)arg;
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        const VertexIndex& vertexIndex = *measureSpec->vertexIndex;
+        const TVertexCount numVertices = vertexIndex.GetNumVertices();
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+        const SGraphPartition& partition = *measureSpec->partition;
+
+        if (0 == globalThreadID)
+            measureSpec->neighborsSectionSizes = new uint64_t[globalThreadCount];
+
+        spindleBarrierGlobal();
+
+        uint64_t neighborsSectionSize = 0;
+
+        if (NULL != offsets)
+        {
+            // Frozen neighbors are contiguous, so the edges can be divided evenly, even those of a single vertex.
+            SWorkUnit unit;
+
+            measureSpec->workScheduler.ParallelInitialize(offsets, numVertices, true);
+
+            while (measureSpec->workScheduler.GetWork(unit))
+            {
+                for (TVertexID vertex = unit.vertexStart; vertex < unit.vertexEnd; ++vertex)
+                {
+                    if (!(partition.ContainsVertex(vertex)))
+                        continue;
+
+                    for (TEdgeCount edge = unit.FirstEdge(offsets, vertex); edge < unit.LastEdge(offsets, vertex); ++edge)
+                        neighborsSectionSize += TextFormatter::UnsignedIntegerLength((uint64_t)vertexIndex.GetFrozenNeighbor(edge)) + kNewlineSize;
+                }
+            }
+        }
+        else
+        {
+            const TVertexID verticesStart = (TVertexID)(((uint64_t)numVertices * (uint64_t)globalThreadID) / (uint64_t)globalThreadCount);
+            const TVertexID verticesEnd = (TVertexID)(((uint64_t)numVertices * (uint64_t)(globalThreadID + 1)) / (uint64_t)globalThreadCount);
+
+            for (TVertexID vertex = verticesStart; vertex < verticesEnd; ++vertex)
+            {
+                if (!(partition.ContainsVertex(vertex)))
+                    continue;
+
+                const EdgeList* const edgeList = vertexIndex[vertex];
+
+                if (NULL == edgeList)
+                    continue;
+
+                for (EdgeList::EdgeIterator edgeIter = edgeList->BeginIterator(); edgeIter != edgeList->EndIterator(); ++edgeIter)
+                    neighborsSectionSize += TextFormatter::UnsignedIntegerLength((uint64_t)edgeIter.GetOtherVertex()) + kNewlineSize;
+            }
+        }
+
+        measureSpec->neighborsSectionSizes[globalThreadID] = neighborsSectionSize;
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            measureSpec->neighborsSectionSize = 0;
+
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+                measureSpec->neighborsSectionSize += measureSpec->neighborsSectionSizes[i];
+
+            delete[] measureSpec->neighborsSectionSizes;
+        }
+    }
+
+
     // -------- CLASS VARIABLES -------------------------------------------- //
     // See "TextAdjacencyListWriter.h" for documentation.
-    
+
     template <typename TEdgeData> const char* const TextAdjacencyListWriter<TEdgeData>::outputFileHeader = weightedHeader;
     template <> const char* const TextAdjacencyListWriter<void>::outputFileHeader = unweightedHeader;
-    
-    
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "TextAdjacencyListWriter.h" for documentation.
+
+    template <typename TEdgeData> TextAdjacencyListWriter<TEdgeData>::TextAdjacencyListWriter(void) : GraphWriter<TEdgeData>(), edgeDataSectionPosition(0)
+    {
+        // Nothing to do here.
+    }
+
+
     // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
     // See "GraphWriter.h" for documentation.
 
-    template <typename TEdgeData> unsigned int TextAdjacencyListWriter<TEdgeData>::NumberOfPassesRequired(void)
+    template <typename TEdgeData> GraphWriter<TEdgeData>* TextAdjacencyListWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new TextAdjacencyListWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> void TextAdjacencyListWriter<TEdgeData>::FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
     {
-        return 2;
+        char lineString[TextFormatter::kMaxUnsignedIntegerLength + 1];
+
+        // Format each edge's topology information into the neighbors section and its data into the edge data section.
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Format the source or destination vertex, depending on the grouping.
+            const size_t neighborLineLength = TextFormatter::FormatUnsignedInteger(lineString, (uint64_t)(groupedByDestination ? buf[i].sourceVertex : buf[i].destinationVertex));
+            lineString[neighborLineLength] = '\n';
+            output.insert(output.end(), lineString, &lineString[neighborLineLength + 1]);
+
+            const size_t edgeDataLineLength = TextFormatter::FormatUnsignedInteger(lineString, (uint64_t)buf[i].edgeData);
+            lineString[edgeDataLineLength] = '\n';
+            secondaryOutput.insert(secondaryOutput.end(), lineString, &lineString[edgeDataLineLength + 1]);
+        }
     }
-    
+
     // --------
-    
-    template <> unsigned int TextAdjacencyListWriter<void>::NumberOfPassesRequired(void)
+
+    template <> void TextAdjacencyListWriter<void>::FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<void>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
     {
-        return 1;
+        char lineString[TextFormatter::kMaxUnsignedIntegerLength + 1];
+
+        // Format each edge.
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Format the source or destination vertex, depending on the grouping.
+            const size_t lineStringLength = TextFormatter::FormatUnsignedInteger(lineString, (uint64_t)(groupedByDestination ? buf[i].sourceVertex : buf[i].destinationVertex));
+            lineString[lineStringLength] = '\n';
+            output.insert(output.end(), lineString, &lineString[lineStringLength + 1]);
+        }
     }
-    
+
     // --------
-    
+
     template <typename TEdgeData> FILE* TextAdjacencyListWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
     {
         // This class writes files in text mode.
-        FILE* graphfile = fopen(filename, "w");
+        FILE* graphfile = this->OpenGraphFileForWrite(filename, true);
 
         if (NULL != graphfile)
         {
             // Write out the number of vertices and edges in the graph.
-            fprintf(graphfile, "%s\n%llu\n%llu\n", outputFileHeader, (long long unsigned int)graph.GetNumVertices(), (long long unsigned int)graph.GetNumEdges());
-            
-            // Write out the vertex index.
+            fprintf(graphfile, "%s\n%llu\n%llu\n", outputFileHeader, (long long unsigned int)this->GetNumVerticesToWrite(graph), (long long unsigned int)this->GetNumEdgesToWrite(graph));
+
+            // Write out the vertex index in parallel, using threads on every NUMA node.
             const VertexIndex& vertexIndex = (groupedByDestination ? graph.VertexIndexDestination() : graph.VertexIndexSource());
-            const TVertexCount numVertices = vertexIndex.GetNumVertices();
-            TVertexCount currentDegree = 0;
-            
-            for (TVertexCount i = 0; i < numVertices; ++i)
+
+            if (!(this->WriteVertexOffsetsToFile(graphfile, vertexIndex, vertexIndex.GetNumVertices(), &AppendTextOffset, 0, false)) || (0 != fflush(graphfile)) || ferror(graphfile))
             {
-                fprintf(graphfile, "%llu\n", (long long unsigned int)currentDegree);
-                currentDegree += vertexIndex.GetDegree(i);
+                fclose(graphfile);
+                return NULL;
+            }
+
+            // If the edge data section is to be written alongside the neighbors section, the latter must also be measured to know where the former begins.
+            // A compressed edge data section is instead appended once the rest of the file is complete, so no measurement is needed.
+            if (UsesSecondaryGraphFile() && !(this->IsGraphFileCompressed()))
+            {
+                SNeighborsSectionMeasureSpec measureSpec;
+                measureSpec.vertexIndex = &vertexIndex;
+                measureSpec.partition = &this->GetPartition();
+                measureSpec.neighborsSectionSizes = NULL;
+                measureSpec.neighborsSectionSize = 0;
+
+                const EGraphResult spawnResult = NUMASpawner::Spawn(&ParallelMeasureNeighborsSectionFunc, (void*)&measureSpec);
+                const int64_t neighborsSectionPosition = (int64_t)ftell64(graphfile);
+
+                // The edge data section immediately follows the neighbors section.
+                if ((EGraphResult::GraphResultSuccess != spawnResult) || (neighborsSectionPosition < 0))
+                {
+                    fclose(graphfile);
+                    return NULL;
+                }
+
+                edgeDataSectionPosition = neighborsSectionPosition + (int64_t)measureSpec.neighborsSectionSize;
             }
         }
 
@@ -84,48 +261,59 @@ namespace GraphTool
 
     // --------
 
-    template <typename TEdgeData> void TextAdjacencyListWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    template <typename TEdgeData> FILE* TextAdjacencyListWriter<TEdgeData>::OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
     {
-        switch (currentPass)
+        // Positions within a compressed file are unknown until it is written, so a compressed edge data section is produced separately and appended.
+        if (this->IsGraphFileCompressed())
+            return this->OpenCompressedGraphFileSectionForWrite(filename);
+        
+        // The edge data section is written through a second handle to the same file, which the first handle has already created.
+        FILE* edgeDataFile = fopen(filename, "r+");
+
+        if ((NULL != edgeDataFile) && (0 != fseek64(edgeDataFile, edgeDataSectionPosition, SEEK_SET)))
         {
-        case 0:
-            // Write out each edge's topology information.
-            for (size_t i = 0; i < count; ++i)
-            {
-                // Write the source or destination vertex, depending on the grouping.
-                if (groupedByDestination)
-                    fprintf(graphfile, "%llu\n", (long long unsigned int)buf[i].sourceVertex);
-                else
-                    fprintf(graphfile, "%llu\n", (long long unsigned int)buf[i].destinationVertex);
-            }
-            break;
-            
-        case 1:
-            // Write out each edge's data.
-            for (size_t i = 0; i < count; ++i)
-            {
-                fprintf(graphfile, "%llu\n", (long long unsigned int)buf[i].edgeData);
-            }
-            break;
-            
-        default:
-            break;
+            fclose(edgeDataFile);
+            return NULL;
         }
+
+        return edgeDataFile;
     }
-    
+
     // --------
-    
-    template <> void TextAdjacencyListWriter<void>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<void>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+
+    template <typename TEdgeData> bool TextAdjacencyListWriter<TEdgeData>::SupportsEdgeSource(void) const
     {
-        // Write out each edge.
-        for (size_t i = 0; i < count; ++i)
-        {
-            // Write the source or destination vertex, depending on the grouping.
-            if (groupedByDestination)
-                fprintf(graphfile, "%llu\n", (long long unsigned int)buf[i].sourceVertex);
-            else
-                fprintf(graphfile, "%llu\n", (long long unsigned int)buf[i].destinationVertex);
-        }
+        // Measuring the neighbors section requires the neighbors themselves, which is only needed when the edge data section follows it in an uncompressed file.
+        return !(UsesSecondaryGraphFile() && !(this->IsGraphFileCompressed()));
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool TextAdjacencyListWriter<TEdgeData>::SupportsParallelFormatting(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool TextAdjacencyListWriter<TEdgeData>::UsesSecondaryGraphFile(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <> bool TextAdjacencyListWriter<void>::UsesSecondaryGraphFile(void) const
+    {
+        return false;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void TextAdjacencyListWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        // Formatting is shared with the parallel path, so that output is identical regardless of how it is produced.
+        this->WriteFormattedEdgesToFile(graphfile, graph, buf, count, groupedByDestination, currentPass);
     }
 
 
@@ -134,4 +322,6 @@ namespace GraphTool
     template class TextAdjacencyListWriter<void>;
     template class TextAdjacencyListWriter<uint64_t>;
     template class TextAdjacencyListWriter<double>;
+    template class TextAdjacencyListWriter<uint32_t>;
+    template class TextAdjacencyListWriter<float>;
 }
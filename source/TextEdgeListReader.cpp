@@ -19,10 +19,34 @@
 #include <cstdlib>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <immintrin.h>
+#include <vector>
 
 
 namespace GraphTool
 {
+    // -------- CONSTANTS -------------------------------------------------- //
+    
+    /// Reader option that selects the parsing strategy.
+    static const char* const kReaderOptionParser = "parser";
+    
+    /// Value of the parser option that splits the file into chunks parsed by all consumer threads. This is the default.
+    static const char* const kReaderOptionParserParallel = "parallel";
+    
+    /// Value of the parser option that parses the file line-by-line on the producer thread.
+    static const char* const kReaderOptionParserSerial = "serial";
+    
+    
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "TextEdgeListReader.h" for documentation.
+    
+    template <typename TEdgeData> TextEdgeListReader<TEdgeData>::TextEdgeListReader(void) : GraphReader<TEdgeData>(), partialLine(), useParallelParser(true)
+    {
+        // Nothing to do here.
+    }
+    
+    
     // -------- CLASS METHODS ---------------------------------------------- //
     // See "TextEdgeListReader.h" for documentation.
 
@@ -51,82 +75,283 @@ namespace GraphTool
         return (edgeDataString != endPos);
     }
 
+    // --------
+
+    template <> bool TextEdgeListReader<uint32_t>::ParseEdgeData(const char* const edgeDataString, SEdge<uint32_t>& edgeDataBuf)
+    {
+        // Values that do not fit are treated in the same way as values that cannot be parsed at all.
+        char* endPos;
+        const unsigned long long value = strtoull(edgeDataString, &endPos, 0);
+        edgeDataBuf.edgeData = (uint32_t)value;
+
+        return ((edgeDataString != endPos) && (value <= (unsigned long long)UINT32_MAX));
+    }
+
+    // --------
+
+    template <> bool TextEdgeListReader<float>::ParseEdgeData(const char* const edgeDataString, SEdge<float>& edgeDataBuf)
+    {
+        char* endPos;
+        edgeDataBuf.edgeData = strtof(edgeDataString, &endPos);
+
+        return (edgeDataString != endPos);
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool TextEdgeListReader<TEdgeData>::ParseEdgeLine(const char* const line, const char* const lineEnd, SEdge<TEdgeData>& edgeBuf)
+    {
+        const char* currpos = line;
+        
+        // Verify that the line begins with a number, which excludes comments and blank lines.
+        if ((currpos >= lineEnd) || !isdigit((int)*currpos))
+            return false;
+        
+        // Extract out the source vertex ID, then skip over whitespace and verify that another number is present.
+        edgeBuf.sourceVertex = ParseVertexID(currpos);
+        while ((currpos < lineEnd) && isspace((int)*currpos)) currpos += 1;
+        if ((currpos >= lineEnd) || !isdigit((int)*currpos))
+            return false;
+        
+        // Extract out the destination vertex ID, then skip over whitespace.
+        edgeBuf.destinationVertex = ParseVertexID(currpos);
+        while ((currpos < lineEnd) && isspace((int)*currpos)) currpos += 1;
+        
+        // Parse the edge data, making sure not to look past the end of the line.
+        return ParseEdgeData(((currpos < lineEnd) ? currpos : ""), edgeBuf);
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> TVertexID TextEdgeListReader<TEdgeData>::ParseVertexID(const char*& position)
+    {
+        // Find the length of the run of digits at the current position.
+        const __m128i characters = _mm_loadu_si128((const __m128i*)position);
+        const __m128i digits = _mm_sub_epi8(characters, _mm_set1_epi8('0'));
+        const uint32_t digitMask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits));
+        const uint32_t numDigits = _tzcnt_u32(~digitMask);
+        
+        if (numDigits > kVectorParseMaxDigits)
+        {
+            char* endPos;
+            const TVertexID vertexID = (TVertexID)strtoull(position, &endPos, 10);
+            
+            position = endPos;
+            return vertexID;
+        }
+        
+        // Shift the digits so that the least-significant one occupies the last byte, filling with leading zeroes.
+        // Shuffle indices that come out negative select zero.
+        const __m128i alignedDigits = _mm_shuffle_epi8(digits, _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm_set1_epi8((char)numDigits - 16)));
+        
+        // Combine adjacent groups of digits: 2 digits per 16-bit lane, then 4 digits per 32-bit lane, then 8 digits per 32-bit lane.
+        const __m128i pairs = _mm_maddubs_epi16(alignedDigits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+        const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+        const __m128i octets = _mm_madd_epi16(_mm_packus_epi32(quads, quads), _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+        
+        position += numDigits;
+        return ((TVertexID)(uint32_t)_mm_cvtsi128_si32(octets) * 100000000ull) + (TVertexID)(uint32_t)_mm_extract_epi32(octets, 1);
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool TextEdgeListReader<TEdgeData>::ReadHeaderLine(FILE* const graphfile, char* const linebuf)
+    {
+        if (NULL == fgets(linebuf, kHeaderLineBufferSize, graphfile))
+            return false;
+
+        // Discard the rest of a line that did not fit.
+        if ('\n' != linebuf[strlen(linebuf) - 1])
+        {
+            int character;
+            while ((EOF != (character = fgetc(graphfile))) && ('\n' != character));
+        }
+
+        return true;
+    }
+
+
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "TextEdgeListReader.h" for documentation.
+
+    template <typename TEdgeData> unsigned int TextEdgeListReader<TEdgeData>::MaxEdgesPerLine(void) const
+    {
+        return 1;
+    }
+
+    // --------
+
+    template <typename TEdgeData> unsigned int TextEdgeListReader<TEdgeData>::ParseEdgesFromLine(const char* const line, const char* const lineEnd, SEdge<TEdgeData>* const edges) const
+    {
+        return (ParseEdgeLine(line, lineEnd, edges[0]) ? 1 : 0);
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool TextEdgeListReader<TEdgeData>::ReadGraphFileHeader(FILE* const graphfile)
+    {
+        char linebuf[kHeaderLineBufferSize];
+        
+        // Read in the number of vertices.
+        if (!ReadHeaderLine(graphfile, linebuf))
+            return false;
+        
+        GraphReader<TEdgeData>::numVerticesInFile = strtoull(linebuf, NULL, 10);
+        
+        // Read in the number of edges.
+        if (!ReadHeaderLine(graphfile, linebuf))
+            return false;
+        
+        GraphReader<TEdgeData>::numEdgesInFile = strtoull(linebuf, NULL, 10);
+        return true;
+    }
+
 
     // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
     // See "GraphReader.h" for documentation.
 
+    template <typename TEdgeData> GraphReader<TEdgeData>* TextEdgeListReader<TEdgeData>::CreateShardReader(void) const
+    {
+        return new TextEdgeListReader<TEdgeData>(*this);
+    }
+
+    // --------
+
     template <typename TEdgeData> FILE* TextEdgeListReader<TEdgeData>::OpenAndInitializeGraphFileForRead(const char* const filename)
     {
         // This class reads files in text mode.
-        FILE* graphfile = fopen(filename, "r");
+        FILE* graphfile = this->OpenGraphFileForRead(filename, true);
 
-        if (NULL != graphfile)
+        if ((NULL != graphfile) && !ReadGraphFileHeader(graphfile))
         {
-            char linebuf[1024];
+            fclose(graphfile);
+            return NULL;
+        }
+        
+        partialLine.clear();
+        return graphfile;
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> void TextEdgeListReader<TEdgeData>::ParseEdgesFromChunk(const char* const chunk, const size_t chunkSize, const size_t rangeStart, const size_t rangeEnd, std::vector<SEdge<TEdgeData>>& edges) const
+    {
+        const char* const chunkEnd = &chunk[chunkSize];
+        const char* const rangeEndPos = &chunk[rangeEnd];
+        const char* currpos = &chunk[rangeStart];
+        
+        // A line that straddles the start of the range belongs to the previous range.
+        if ((0 != rangeStart) && ('\n' != chunk[rangeStart - 1]))
+        {
+            currpos = (const char*)memchr(currpos, '\n', chunkEnd - currpos);
+            currpos = ((NULL == currpos) ? chunkEnd : (currpos + 1));
+        }
+        
+        // Parse each line that begins within the range, including the one that straddles its end.
+        while (currpos < rangeEndPos)
+        {
+            const char* lineEnd = (const char*)memchr(currpos, '\n', chunkEnd - currpos);
+            if (NULL == lineEnd) lineEnd = chunkEnd;
             
-            // Read in the number of vertices.
-            if (NULL == fgets(linebuf, sizeof(linebuf) / sizeof(linebuf[0]), graphfile))
-            {
-                fclose(graphfile);
-                return NULL;
-            }
+            SEdge<TEdgeData> lineEdges[kMaxEdgesPerLine];
+            const unsigned int numLineEdges = ParseEdgesFromLine(currpos, lineEnd, lineEdges);
             
-            GraphReader<TEdgeData>::numVerticesInFile = strtoull(linebuf, NULL, 10);
+            for (unsigned int i = 0; i < numLineEdges; ++i)
+                edges.push_back(lineEdges[i]);
             
-            // Read in the number of edges.
-            if (NULL == fgets(linebuf, sizeof(linebuf) / sizeof(linebuf[0]), graphfile))
+            currpos = lineEnd + 1;
+        }
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> size_t TextEdgeListReader<TEdgeData>::ReadChunkToBuffer(FILE* const graphfile, char* const buf, const size_t size, const TEdgeCount maxEdges)
+    {
+        // Limit the chunk so that even a chunk made entirely of the shortest possible edge lines, each describing as many edges as possible, fits in the edge buffer.
+        const size_t maxChunkBytes = (size_t)((maxEdges / MaxEdgesPerLine()) * kMinBytesPerEdgeLine);
+        const size_t maxBytes = ((size < maxChunkBytes) ? size : maxChunkBytes);
+        
+        // Start with whatever was left over from the previous chunk.
+        size_t numBytes = ((partialLine.size() < maxBytes) ? partialLine.size() : maxBytes);
+        
+        if (0 != numBytes)
+        {
+            memcpy((void*)buf, (void*)partialLine.data(), numBytes);
+            partialLine.erase(partialLine.begin(), partialLine.begin() + numBytes);
+        }
+        
+        if (partialLine.empty())
+            numBytes += fread((void*)&buf[numBytes], 1, maxBytes - numBytes, graphfile);
+        
+        // Hold back the line cut off at the end of the chunk, unless this is the end of the file.
+        // A line that fills the entire chunk by itself is passed along as-is.
+        if ((0 != numBytes) && !feof(graphfile) && !ferror(graphfile))
+        {
+            size_t chunkSize = numBytes;
+            
+            while ((0 != chunkSize) && ('\n' != buf[chunkSize - 1]))
+                chunkSize -= 1;
+            
+            if (0 != chunkSize)
             {
-                fclose(graphfile);
-                return NULL;
+                partialLine.insert(partialLine.begin(), &buf[chunkSize], &buf[numBytes]);
+                numBytes = chunkSize;
             }
-            
-            GraphReader<TEdgeData>::numEdgesInFile = strtoull(linebuf, NULL, 10);
         }
-
-        return graphfile;
+        
+        return numBytes;
     }
 
     // --------
 
-    template <typename TEdgeData> TEdgeCount TextEdgeListReader<TEdgeData>::ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t size)
+    template <typename TEdgeData> TEdgeCount TextEdgeListReader<TEdgeData>::ReadEdgesToBuffer(FILE* const graphfile, SEdge<TEdgeData>* buf, const size_t count)
     {
-        const size_t edgeSize = sizeof(SEdge<TEdgeData>);
-        const size_t edgeCount = (size / edgeSize);
+        // The line buffer is padded so that vertex identifiers near its end can be parsed using vector instructions.
+        char linebuf[1024 + 16];
         TEdgeCount numEdgesRead = 0;
+        
+        memset((void*)linebuf, 0, sizeof(linebuf));
 
-        while ((numEdgesRead < edgeCount) && !(feof(graphfile)) && !(ferror(graphfile)))
+        while (((numEdgesRead + MaxEdgesPerLine()) <= count) && !(feof(graphfile)) && !(ferror(graphfile)))
         {
-            char linebuf[1024];
-            char* currpos = &linebuf[0];
-            TVertexID sourceVertex;
-            TVertexID destinationVertex;
-
-            // Read the line into the line buffer and verify that it is a valid edge.
-            if (NULL == fgets(currpos, sizeof(linebuf) / sizeof(linebuf[0]), graphfile)) break;
-            if (!isdigit((int)*currpos)) continue;
-            if (feof(graphfile) || ferror(graphfile)) break;
-
-            // Extract out the source vertex ID, then skip over whitespace and verify that another number is present.
-            sourceVertex = strtoull(currpos, &currpos, 10);
-            while (isspace((int)*currpos)) currpos += 1;
-            if (!isdigit((int)*currpos)) continue;
-            if (feof(graphfile) || ferror(graphfile)) break;
-
-            // Extract out the destination vertex ID, then skip over whitespace.
-            destinationVertex = strtoull(currpos, &currpos, 10);
-            while (isspace((int)*currpos)) currpos += 1;
-
-            // Parse the edge data out of the input file.
-            if (true != this->ParseEdgeData(currpos, buf[numEdgesRead])) continue;
-
-            // Write the edge to the buffer and increment the number of edges that have been read.
-            buf[numEdgesRead].sourceVertex = sourceVertex;
-            buf[numEdgesRead].destinationVertex = destinationVertex;
-            numEdgesRead += 1;
+            // Read the line into the line buffer and locate its end.
+            if (NULL == fgets(linebuf, 1024, graphfile)) break;
+            
+            const char* lineEnd = &linebuf[strlen(linebuf)];
+            if ((lineEnd != linebuf) && ('\n' == lineEnd[-1])) lineEnd -= 1;
+            
+            // Write the edges described by the line to the buffer and increment the number of edges that have been read.
+            numEdgesRead += ParseEdgesFromLine(linebuf, lineEnd, &buf[numEdgesRead]);
         }
 
         return numEdgesRead;
     }
+    
+    // --------
+    
+    template <typename TEdgeData> bool TextEdgeListReader<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if (0 == strcmp(optionName, kReaderOptionParser))
+        {
+            if (0 == strcmp(optionValue, kReaderOptionParserParallel))
+                useParallelParser = true;
+            else if (0 == strcmp(optionValue, kReaderOptionParserSerial))
+                useParallelParser = false;
+            else
+                return false;
+            
+            return true;
+        }
+        
+        return GraphReader<TEdgeData>::SubmitOption(optionName, optionValue);
+    }
+    
+    // --------
+    
+    template <typename TEdgeData> bool TextEdgeListReader<TEdgeData>::UsesParallelParsing(void) const
+    {
+        return useParallelParser;
+    }
 
 
     // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
@@ -134,4 +359,6 @@ namespace GraphTool
     template class TextEdgeListReader<void>;
     template class TextEdgeListReader<uint64_t>;
     template class TextEdgeListReader<double>;
+    template class TextEdgeListReader<uint32_t>;
+    template class TextEdgeListReader<float>;
 }
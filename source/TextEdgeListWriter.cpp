@@ -13,51 +13,123 @@
 #include "Graph.h"
 #include "GraphWriter.h"
 #include "TextEdgeListWriter.h"
+#include "TextFormatter.h"
 #include "Types.h"
 
 #include <cstddef>
 #include <cstdlib>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <vector>
 
 
 namespace GraphTool
 {
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Number of digits written after the decimal point for floating-point edge data.
+    static const unsigned int kFloatingPointEdgeDataPrecision = 10;
+
+    /// Size of the string buffer used to hold the representation of edge data, beyond which it is truncated.
+    static const size_t kEdgeDataStringCount = 128;
+
+
     // -------- CLASS METHODS ---------------------------------------------- //
     // See "TextEdgeListWriter.h" for documentation.
 
-    template <> int TextEdgeListWriter<void>::StringFromEdgeData(const SEdge<void>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount)
+    template <> size_t TextEdgeListWriter<void>::StringFromEdgeData(const SEdge<void>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount)
     {
         return 0;
     }
 
     // --------
 
-    template <> int TextEdgeListWriter<uint64_t>::StringFromEdgeData(const SEdge<uint64_t>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount)
+    template <> size_t TextEdgeListWriter<uint64_t>::StringFromEdgeData(const SEdge<uint64_t>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount)
+    {
+        if (edgeDataStringCount <= TextFormatter::kMaxUnsignedIntegerLength)
+            return 0;
+        
+        return TextFormatter::FormatUnsignedInteger(edgeDataString, (uint64_t)edgeBuf.edgeData);
+    }
+
+    // --------
+
+    template <> size_t TextEdgeListWriter<double>::StringFromEdgeData(const SEdge<double>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount)
+    {
+        return TextFormatter::FormatFixedPoint(edgeDataString, edgeDataStringCount, edgeBuf.edgeData, kFloatingPointEdgeDataPrecision);
+    }
+
+    // --------
+
+    template <> size_t TextEdgeListWriter<uint32_t>::StringFromEdgeData(const SEdge<uint32_t>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount)
     {
-        return snprintf(edgeDataString, edgeDataStringCount, "%llu", (long long unsigned int)edgeBuf.edgeData);
+        if (edgeDataStringCount <= TextFormatter::kMaxUnsignedIntegerLength)
+            return 0;
+        
+        return TextFormatter::FormatUnsignedInteger(edgeDataString, (uint64_t)edgeBuf.edgeData);
     }
 
     // --------
 
-    template <> int TextEdgeListWriter<double>::StringFromEdgeData(const SEdge<double>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount)
+    template <> size_t TextEdgeListWriter<float>::StringFromEdgeData(const SEdge<float>& edgeBuf, char* const edgeDataString, const size_t edgeDataStringCount)
     {
-        return snprintf(edgeDataString, edgeDataStringCount, "%.10lf", edgeBuf.edgeData);
+        return TextFormatter::FormatFixedPoint(edgeDataString, edgeDataStringCount, (double)edgeBuf.edgeData, kFloatingPointEdgeDataPrecision);
     }
 
 
     // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
     // See "GraphWriter.h" for documentation.
 
+    template <typename TEdgeData> GraphWriter<TEdgeData>* TextEdgeListWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new TextEdgeListWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> void TextEdgeListWriter<TEdgeData>::FormatEdgesToBuffer(std::vector<char>& output, std::vector<char>& secondaryOutput, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass) const
+    {
+        // Each line holds two vertex identifiers, the edge data, and the separators between them.
+        char lineString[(TextFormatter::kMaxUnsignedIntegerLength * 2) + kEdgeDataStringCount + 3];
+        
+        // Format each edge.
+        for (size_t i = 0; i < count; ++i)
+        {
+            // First, format the source and destination vertices.
+            char* position = lineString;
+            
+            position += TextFormatter::FormatUnsignedInteger(position, (uint64_t)buf[i].sourceVertex);
+            *position++ = ' ';
+            position += TextFormatter::FormatUnsignedInteger(position, (uint64_t)buf[i].destinationVertex);
+            
+            // Next, see if edge data are available for formatting.
+            // Edge data that do not fit in the string buffer are truncated, as they always have been.
+            const size_t edgeDataStringLength = StringFromEdgeData(buf[i], &position[1], kEdgeDataStringCount);
+            
+            if (0 < edgeDataStringLength)
+            {
+                *position = ' ';
+                position += (edgeDataStringLength + 1);
+            }
+            
+            // End the line.
+            *position++ = '\n';
+            output.insert(output.end(), lineString, position);
+        }
+    }
+    
+    // --------
+    
     template <typename TEdgeData> FILE* TextEdgeListWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
     {
         // This class writes files in text mode.
-        FILE* graphfile = fopen(filename, "w");
+        FILE* graphfile = this->OpenGraphFileForWrite(filename, true);
 
         if (NULL != graphfile)
         {
             // Write out the number of vertices and edges in the graph.
-            fprintf(graphfile, "%llu\n%llu\n", (long long unsigned int)graph.GetNumVertices(), (long long unsigned int)graph.GetNumEdges());
+            fprintf(graphfile, "%llu\n%llu\n", (long long unsigned int)this->GetNumVerticesToWrite(graph), (long long unsigned int)this->GetNumEdgesToWrite(graph));
         }
 
         return graphfile;
@@ -65,24 +137,31 @@ namespace GraphTool
 
     // --------
 
+    template <typename TEdgeData> bool TextEdgeListWriter<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool TextEdgeListWriter<TEdgeData>::SupportsParallelFormatting(void) const
+    {
+        return true;
+    }
+    
+    // --------
+
+    template <typename TEdgeData> bool TextEdgeListWriter<TEdgeData>::SupportsStreaming(void) const
+    {
+        return true;
+    }
+    
+    // --------
+
     template <typename TEdgeData> void TextEdgeListWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
     {
-        // Write out each edge.
-        for (size_t i = 0; i < count; ++i)
-        {
-            // First, write the source and destination vertices.
-            fprintf(graphfile, "%llu %llu", (long long unsigned int)buf[i].sourceVertex, (long long unsigned int)buf[i].destinationVertex);
-        
-            // Next, see if edge data are available for writing.
-            char edgeDataString[128];
-            const size_t edgeDataStringLength = StringFromEdgeData(buf[i], edgeDataString, sizeof(edgeDataString) / sizeof(edgeDataString[0]));
-        
-            if (0 < edgeDataStringLength)
-                fprintf(graphfile, " %s", edgeDataString);
-        
-            // End the line.
-            fprintf(graphfile, "\n");
-        }
+        // Formatting is shared with the parallel path, so that output is identical regardless of how it is produced.
+        this->WriteFormattedEdgesToFile(graphfile, graph, buf, count, groupedByDestination, currentPass);
     }
 
 
@@ -91,4 +170,6 @@ namespace GraphTool
     template class TextEdgeListWriter<void>;
     template class TextEdgeListWriter<uint64_t>;
     template class TextEdgeListWriter<double>;
+    template class TextEdgeListWriter<uint32_t>;
+    template class TextEdgeListWriter<float>;
 }
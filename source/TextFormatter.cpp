@@ -0,0 +1,235 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file TextFormatter.cpp
+ *   Implementation of fast routines for converting numbers to text.
+ *****************************************************************************/
+
+#include "TextFormatter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Holds the two decimal digits of every number from 0 to 99, so that digits can be produced two at a time.
+    static const char kDigitPairs[] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    /// Holds powers of five, indexed by exponent, up to the maximum supported fixed-point precision.
+    static const uint64_t kPowersOfFive[] = { 1ull, 5ull, 25ull, 125ull, 625ull, 3125ull, 15625ull, 78125ull, 390625ull, 1953125ull, 9765625ull, 48828125ull, 244140625ull };
+
+    /// Holds powers of ten, indexed by exponent, up to the maximum supported fixed-point precision.
+    static const uint64_t kPowersOfTen[] = { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull };
+
+
+    /// Divides a 128-bit value, given as two 64-bit halves, by a power of two, rounding exactly to the nearest integer with ties going to even.
+    /// The quotient must fit in 64 bits.
+    /// @param [in] high Upper 64 bits of the dividend.
+    /// @param [in] low Lower 64 bits of the dividend.
+    /// @param [in] shift Base-2 logarithm of the divisor, which must be between 1 and 127 inclusive.
+    /// @param [in] tieParityOffset Added to the quotient to determine whether it is even when breaking ties, which accounts for any digits that precede the quotient.
+    /// @return Rounded quotient.
+    static uint64_t ShiftRightRounded(const uint64_t high, const uint64_t low, const unsigned int shift, const uint64_t tieParityOffset)
+    {
+        uint64_t quotient, remainderHigh, remainderLow, halfHigh, halfLow;
+
+        if (shift < 64)
+        {
+            quotient = (low >> shift) | (high << (64 - shift));
+            remainderHigh = 0;
+            remainderLow = low & ((1ull << shift) - 1ull);
+            halfHigh = 0;
+            halfLow = 1ull << (shift - 1);
+        }
+        else
+        {
+            quotient = high >> (shift - 64);
+            remainderHigh = high & ((1ull << (shift - 64)) - 1ull);
+            remainderLow = low;
+            halfHigh = ((64 == shift) ? 0ull : (1ull << (shift - 65)));
+            halfLow = ((64 == shift) ? (1ull << 63) : 0ull);
+        }
+
+        if ((remainderHigh > halfHigh) || ((remainderHigh == halfHigh) && (remainderLow > halfLow)))
+            return quotient + 1;
+        else if ((remainderHigh == halfHigh) && (remainderLow == halfLow))
+            return quotient + ((quotient + tieParityOffset) & 1ull);
+        else
+            return quotient;
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "TextFormatter.h" for documentation.
+
+    size_t TextFormatter::FormatFixedPoint(char* const buf, const size_t bufCount, const double value, const unsigned int precision)
+    {
+        if (0 == bufCount)
+            return 0;
+
+        uint64_t valueBits;
+        memcpy((void*)&valueBits, (void*)&value, sizeof(valueBits));
+
+        const bool isNegative = (0ull != (valueBits >> 63));
+        const uint64_t biasedExponent = ((valueBits >> 52) & 0x7ffull);
+        const uint64_t significandBits = (valueBits & ((1ull << 52) - 1ull));
+
+        // The value is m * 2^e, where m is the integer significand and e is the exponent.
+        const uint64_t significand = ((0ull == biasedExponent) ? significandBits : (significandBits | (1ull << 52)));
+        const int64_t exponent = ((0ull == biasedExponent) ? -1074ll : ((int64_t)biasedExponent - 1075ll));
+
+        bool isFastPathPossible = ((precision <= kMaxFastFixedPointPrecision) && (0x7ffull != biasedExponent));
+        uint64_t integerPart = 0;
+        uint64_t fractionalPart = 0;
+
+        if (isFastPathPossible)
+        {
+            if (exponent >= 0)
+            {
+                // Integer values only fit in 64 bits for small exponents, since the significand already occupies 53 bits.
+                if (exponent <= 10)
+                    integerPart = significand << exponent;
+                else
+                    isFastPathPossible = false;
+            }
+            else
+            {
+                // Split into integer and fractional bits, and then compute the fractional digits as round(f * 10^p / 2^s).
+                // Since 10^p = 5^p * 2^p, this is round(f * 5^p / 2^(s - p)), and the product fits comfortably in 128 bits.
+                const unsigned int shift = (unsigned int)(-exponent);
+                const uint64_t fractionalBits = ((shift < 64) ? (significand & ((1ull << shift) - 1ull)) : significand);
+
+                integerPart = ((shift < 64) ? (significand >> shift) : 0ull);
+
+                if (shift <= precision)
+                {
+                    fractionalPart = (fractionalBits * kPowersOfFive[precision]) << (precision - shift);
+                }
+                else if ((shift - precision) < 128)
+                {
+                    const uint64_t productLowPart = (fractionalBits & 0xffffffffull) * kPowersOfFive[precision];
+                    const uint64_t productHighPart = (fractionalBits >> 32) * kPowersOfFive[precision];
+                    const uint64_t productLow = productLowPart + (productHighPart << 32);
+                    const uint64_t productHigh = (productHighPart >> 32) + ((productLow < productLowPart) ? 1ull : 0ull);
+
+                    // Without any fractional digits, ties are broken by the last digit of the integer part.
+                    fractionalPart = ShiftRightRounded(productHigh, productLow, shift - precision, ((0 == precision) ? (integerPart & 1ull) : 0ull));
+                }
+
+                // Rounding up can carry into the integer part.
+                if (kPowersOfTen[precision] == fractionalPart)
+                {
+                    integerPart += 1;
+                    fractionalPart = 0;
+                }
+            }
+        }
+
+        if (!isFastPathPossible)
+        {
+            const int formattedLength = snprintf(buf, bufCount, "%.*lf", (int)precision, value);
+
+            if (formattedLength < 0)
+                return 0;
+            else
+                return (((size_t)formattedLength < bufCount) ? (size_t)formattedLength : (bufCount - 1));
+        }
+
+        // Assemble the text, which is always short, before copying as much as fits.
+        char formatted[kMaxUnsignedIntegerLength + kMaxFastFixedPointPrecision + 2];
+        size_t formattedLength = 0;
+
+        if (isNegative)
+            formatted[formattedLength++] = '-';
+
+        formattedLength += FormatUnsignedInteger(&formatted[formattedLength], integerPart);
+
+        if (0 != precision)
+        {
+            formatted[formattedLength++] = '.';
+
+            for (unsigned int i = precision; i > 0; --i)
+            {
+                formatted[formattedLength + i - 1] = (char)('0' + (fractionalPart % 10ull));
+                fractionalPart /= 10ull;
+            }
+
+            formattedLength += precision;
+        }
+
+        if (formattedLength >= bufCount)
+            formattedLength = bufCount - 1;
+
+        memcpy((void*)buf, (void*)formatted, formattedLength);
+        return formattedLength;
+    }
+
+    // --------
+
+    size_t TextFormatter::FormatUnsignedInteger(char* const buf, const uint64_t value)
+    {
+        // Digits are produced from least to most significant, two at a time, starting at the end of a temporary buffer.
+        char digits[kMaxUnsignedIntegerLength];
+        char* position = &digits[kMaxUnsignedIntegerLength];
+        uint64_t remaining = value;
+
+        while (remaining >= 100ull)
+        {
+            const uint64_t digitPair = remaining % 100ull;
+            remaining /= 100ull;
+
+            position -= 2;
+            memcpy((void*)position, (void*)&kDigitPairs[digitPair << 1], 2);
+        }
+
+        if (remaining >= 10ull)
+        {
+            position -= 2;
+            memcpy((void*)position, (void*)&kDigitPairs[remaining << 1], 2);
+        }
+        else
+        {
+            position -= 1;
+            *position = (char)('0' + remaining);
+        }
+
+        const size_t length = (size_t)(&digits[kMaxUnsignedIntegerLength] - position);
+        memcpy((void*)buf, (void*)position, length);
+        return length;
+    }
+
+    // --------
+
+    size_t TextFormatter::UnsignedIntegerLength(const uint64_t value)
+    {
+        // Digits are counted two at a time, mirroring the way they are produced.
+        size_t length = 1;
+        uint64_t remaining = value;
+
+        while (remaining >= 100ull)
+        {
+            remaining /= 100ull;
+            length += 2;
+        }
+
+        if (remaining >= 10ull)
+            length += 1;
+
+        return length;
+    }
+}
@@ -0,0 +1,215 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file TransformPipeline.cpp
+ *   Implementation of a graph transformation that fuses a sequence of other
+ *   transformations into a single traversal of the graph.
+ *****************************************************************************/
+
+#include "EdgeList.h"
+#include "Graph.h"
+#include "IGraphTransform.h"
+#include "TransformPipeline.h"
+#include "Types.h"
+#include "VertexIndex.h"
+#include "WorkScheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <spindle.h>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "TransformPipeline.h" for documentation.
+    
+    TransformPipeline::TransformPipeline(void) : GraphTransform(), stages(), sharedBuf(NULL), keptDegrees(NULL), workScheduler()
+    {
+        // Nothing to do here.
+    }
+    
+    
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "TransformPipeline.h" for documentation.
+    
+    bool TransformPipeline::AppendTransform(IGraphTransform* const transform)
+    {
+        if ((NULL == transform) || !(transform->CanFuseTransformation()))
+            return false;
+        
+        stages.push_back(transform);
+        return true;
+    }
+    
+    
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "TransformPipeline.h" for documentation.
+    
+    EGraphResult TransformPipeline::TransformVertexIndex(VertexIndex& vertexIndex, const bool topLevelIsDestination)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        if (0 == globalThreadID)
+            keptDegrees = new TEdgeCount[vertexIndex.GetNumVertices()];
+        
+        spindleBarrierGlobal();
+        
+        // Stages may remove edges, which are packed towards the start of each vertex's edges, so the edges of a vertex are never split among several units of work.
+        // Units are instead balanced by the number of edges they hold, and each vertex's edges pass through every stage before moving on.
+        const TEdgeCount* const offsets = vertexIndex.GetFrozenOffsets();
+        TCompactVertexID* const neighborsCompact = vertexIndex.GetFrozenNeighborsCompactWritable();
+        TVertexID* const neighbors = vertexIndex.GetFrozenNeighborsWritable();
+        UEdgeData* const edgeData = vertexIndex.GetFrozenEdgeDataWritable();
+        bool removedEdges = false;
+        
+        workScheduler.ParallelInitialize(offsets, vertexIndex.GetNumVertices(), false);
+        
+        SWorkUnit unit;
+        
+        while (workScheduler.GetWork(unit))
+        {
+            for (TVertexID vertex = unit.vertexStart; vertex < unit.vertexEnd; ++vertex)
+            {
+                const TEdgeID firstEdge = offsets[vertex];
+                const size_t numEdges = (size_t)(offsets[vertex + 1] - firstEdge);
+                UEdgeData* const vertexEdgeData = ((NULL != edgeData) ? &edgeData[firstEdge] : NULL);
+                size_t numKept = 0;
+                
+                if (NULL != neighborsCompact)
+                    numKept = TransformEdgeBatch(vertex, topLevelIsDestination, &neighborsCompact[firstEdge], vertexEdgeData, numEdges);
+                else
+                    numKept = TransformEdgeBatch(vertex, topLevelIsDestination, &neighbors[firstEdge], vertexEdgeData, numEdges);
+                
+                keptDegrees[vertex] = (TEdgeCount)numKept;
+                
+                if (numKept != numEdges)
+                    removedEdges = true;
+            }
+        }
+        
+        sharedBuf[globalThreadID] = (removedEdges ? 1 : 0);
+        
+        spindleBarrierGlobal();
+        
+        // Removing edges leaves gaps at the end of each vertex's edges, which are closed up here, but only if some thread actually removed any.
+        bool anyRemovedEdges = false;
+        
+        for (uint32_t i = 0; i < globalThreadCount; ++i)
+        {
+            if (0 != sharedBuf[i])
+                anyRemovedEdges = true;
+        }
+        
+        if (anyRemovedEdges)
+            vertexIndex.ParallelCompactFrozen(keptDegrees, sharedBuf);
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            delete[] keptDegrees;
+            keptDegrees = NULL;
+        }
+        
+        return EGraphResult::GraphResultSuccess;
+    }
+    
+    
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphTransform.h" for documentation.
+    
+    EGraphResult TransformPipeline::TransformGraph(Graph& graph)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        if (0 == globalThreadID)
+            sharedBuf = new uint64_t[globalThreadCount << 2];
+        
+        spindleBarrierGlobal();
+        
+        // Fused transformations work in place within the compact representation.
+        graph.ParallelFreeze(sharedBuf);
+        
+        if (0 == globalThreadID)
+            BeginFusedTransformation(graph);
+        
+        spindleBarrierGlobal();
+        
+        // All threads must take part in transforming each maintained vertex index, even if an error occurs, so that the barriers within match up.
+        const EGraphResult destinationResult = (graph.HasEdgesByDestination() ? TransformVertexIndex(graph.VertexIndexDestinationWritable(), true) : EGraphResult::GraphResultSuccess);
+        const EGraphResult sourceResult = (graph.HasEdgesBySource() ? TransformVertexIndex(graph.VertexIndexSourceWritable(), false) : EGraphResult::GraphResultSuccess);
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            EndFusedTransformation(graph);
+            
+            delete[] sharedBuf;
+            sharedBuf = NULL;
+        }
+        
+        if (EGraphResult::GraphResultSuccess != destinationResult)
+            return destinationResult;
+        else
+            return sourceResult;
+    }
+    
+    
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphTransform.h" for documentation.
+    
+    void TransformPipeline::BeginFusedTransformation(Graph& graph)
+    {
+        for (auto it = stages.begin(); it != stages.end(); ++it)
+            (*it)->BeginFusedTransformation(graph);
+    }
+    
+    // --------
+    
+    bool TransformPipeline::CanFuseTransformation(void) const
+    {
+        return true;
+    }
+    
+    // --------
+    
+    void TransformPipeline::EndFusedTransformation(Graph& graph)
+    {
+        for (auto it = stages.begin(); it != stages.end(); ++it)
+            (*it)->EndFusedTransformation(graph);
+    }
+    
+    // --------
+    
+    size_t TransformPipeline::TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TCompactVertexID* const neighbors, UEdgeData* const edgeData, const size_t count)
+    {
+        size_t numKept = count;
+        
+        for (auto it = stages.begin(); (it != stages.end()) && (0 != numKept); ++it)
+            numKept = (*it)->TransformEdgeBatch(topLevelVertex, topLevelIsDestination, neighbors, edgeData, numKept);
+        
+        return numKept;
+    }
+    
+    // --------
+    
+    size_t TransformPipeline::TransformEdgeBatch(const TVertexID topLevelVertex, const bool topLevelIsDestination, TVertexID* const neighbors, UEdgeData* const edgeData, const size_t count)
+    {
+        size_t numKept = count;
+        
+        for (auto it = stages.begin(); (it != stages.end()) && (0 != numKept); ++it)
+            numKept = (*it)->TransformEdgeBatch(topLevelVertex, topLevelIsDestination, neighbors, edgeData, numKept);
+        
+        return numKept;
+    }
+}
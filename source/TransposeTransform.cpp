@@ -0,0 +1,37 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file TransposeTransform.cpp
+ *   Implementation of a graph transformation that reverses the direction of
+ *   every edge.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "TransposeTransform.h"
+#include "Types.h"
+
+
+namespace GraphTool
+{
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphTransform.h" for documentation.
+
+    bool TransposeTransform::CanParallelizeTransformation(void)
+    {
+        // Exchanging the two groupings is a constant-time operation, so there is nothing to parallelize.
+        return false;
+    }
+
+    // --------
+
+    EGraphResult TransposeTransform::TransformGraph(Graph& graph)
+    {
+        graph.Transpose();
+        return EGraphResult::GraphResultSuccess;
+    }
+}
@@ -0,0 +1,244 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file VectorSparseWriter.cpp
+ *   Implementation of a graph writer for Grazelle's pre-packed Vector-Sparse
+ *   edge files.
+ *****************************************************************************/
+
+#include "Graph.h"
+#include "GraphWriter.h"
+#include "PlatformFunctions.h"
+#include "Types.h"
+#include "VectorSparseWriter.h"
+#include "VertexIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Number of bits of each lane that hold the vertex at the other end of an edge.
+    static const unsigned int kNeighborBits = 48;
+
+    /// Number of bits of each lane that hold part of the top-level vertex.
+    static const unsigned int kTopLevelVertexBitsPerLane = 15;
+
+    /// Mask that extracts the part of the top-level vertex held in a single lane.
+    static const uint64_t kTopLevelVertexLaneMask = (1ull << kTopLevelVertexBitsPerLane) - 1ull;
+
+    /// Bit of each lane that indicates that the lane holds an edge.
+    static const uint64_t kLaneValidBit = 1ull << 63;
+
+    /// Largest number of vertices whose identifiers can all be encoded, which is limited by the bits available for the vertex at the other end of an edge.
+    static const uint64_t kMaxVertices = 1ull << kNeighborBits;
+
+    /// Number of bytes occupied by the header at the start of the file.
+    static const int64_t kHeaderSize = (int64_t)(4 * sizeof(uint64_t));
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Appends the edge data of each lane of a vector, filling unused lanes with zero.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, held for each edge.
+    /// @param [in,out] edgeDataOutput Buffer to which the edge data should be appended.
+    /// @param [in] edges Edges in the vector.
+    /// @param [in] count Number of edges in the vector.
+    template <typename TEdgeData> static inline void AppendVectorEdgeData(std::vector<char>& edgeDataOutput, const SEdge<TEdgeData>* edges, const unsigned int count)
+    {
+        TEdgeData edgeData[VectorSparseWriter<TEdgeData>::kVectorLanes] = {};
+
+        for (unsigned int lane = 0; lane < count; ++lane)
+            edgeData[lane] = edges[lane].edgeData;
+
+        edgeDataOutput.insert(edgeDataOutput.end(), (const char*)edgeData, (const char*)edgeData + sizeof(edgeData));
+    }
+
+    template <> inline void AppendVectorEdgeData<void>(std::vector<char>& edgeDataOutput, const SEdge<void>* edges, const unsigned int count)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "VectorSparseWriter.h" for documentation.
+
+    template <typename TEdgeData> VectorSparseWriter<TEdgeData>::VectorSparseWriter(void) : GraphWriter<TEdgeData>(), edgeDataSectionPosition(0), pendingEdges(), numPendingEdges(0), numRemainingEdges(0)
+    {
+        // Nothing to do here.
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "VectorSparseWriter.h" for documentation.
+
+    template <typename TEdgeData> void VectorSparseWriter<TEdgeData>::PackVector(std::vector<char>& output, std::vector<char>& edgeDataOutput, const SEdge<TEdgeData>* edges, const unsigned int count, const bool groupedByDestination)
+    {
+        const uint64_t topLevelVertex = (uint64_t)(groupedByDestination ? edges[0].destinationVertex : edges[0].sourceVertex);
+        uint64_t vector[kVectorLanes];
+
+        for (unsigned int lane = 0; lane < kVectorLanes; ++lane)
+        {
+            vector[lane] = ((topLevelVertex >> (kTopLevelVertexBitsPerLane * lane)) & kTopLevelVertexLaneMask) << kNeighborBits;
+
+            if (lane < count)
+                vector[lane] |= kLaneValidBit | (uint64_t)(groupedByDestination ? edges[lane].sourceVertex : edges[lane].destinationVertex);
+        }
+
+        output.insert(output.end(), (const char*)vector, (const char*)vector + sizeof(vector));
+        AppendVectorEdgeData(edgeDataOutput, edges, count);
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "GraphWriter.h" for documentation.
+
+    template <typename TEdgeData> GraphWriter<TEdgeData>* VectorSparseWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new VectorSparseWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* VectorSparseWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        const VertexIndex& vertexIndex = (groupedByDestination ? graph.VertexIndexDestination() : graph.VertexIndexSource());
+        const TVertexCount numVertices = this->GetNumVerticesToWrite(graph);
+
+        if ((uint64_t)numVertices > kMaxVertices)
+            return NULL;
+
+        // Each top-level vertex begins a new vector, so the number of vectors depends on the degree of each vertex in the partition being written.
+        const SGraphPartition& partition = this->GetPartition();
+        uint64_t numVectors = 0;
+
+        for (TVertexID vertex = 0; vertex < vertexIndex.GetNumVertices(); ++vertex)
+        {
+            if (partition.ContainsVertex(vertex))
+                numVectors += ((uint64_t)vertexIndex.GetDegree(vertex) + (kVectorLanes - 1)) / kVectorLanes;
+        }
+
+        FILE* graphfile = this->OpenGraphFileForWrite(filename);
+
+        if (NULL != graphfile)
+        {
+            const uint64_t metadata[4] = { (uint64_t)numVertices, (uint64_t)this->GetNumEdgesToWrite(graph), numVectors, (groupedByDestination ? 1ull : 0ull) };
+            fwrite((const void*)metadata, sizeof(metadata[0]), sizeof(metadata) / sizeof(metadata[0]), graphfile);
+        }
+
+        edgeDataSectionPosition = kHeaderSize + (int64_t)(numVectors * kVectorLanes * sizeof(uint64_t));
+        numPendingEdges = 0;
+        numRemainingEdges = 0;
+
+        return graphfile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> FILE* VectorSparseWriter<TEdgeData>::OpenSecondaryGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    {
+        // Positions within a compressed file are unknown until it is written, so a compressed edge data section is produced separately and appended.
+        if (this->IsGraphFileCompressed())
+            return this->OpenCompressedGraphFileSectionForWrite(filename);
+
+        // The edge data section is written through a second handle to the same file, which the first handle has already created.
+        FILE* edgeDataFile = fopen(filename, "r+b");
+
+        if ((NULL != edgeDataFile) && (0 != fseek64(edgeDataFile, edgeDataSectionPosition, SEEK_SET)))
+        {
+            fclose(edgeDataFile);
+            return NULL;
+        }
+
+        return edgeDataFile;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool VectorSparseWriter<TEdgeData>::SupportsDirectIO(void) const
+    {
+        // Direct I/O truncates the file to the size of the vectors when it is closed, which would race with the edge data section.
+        return false;
+    }
+
+    // --------
+
+    template <> bool VectorSparseWriter<void>::SupportsDirectIO(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool VectorSparseWriter<TEdgeData>::SupportsEdgeSource(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <typename TEdgeData> bool VectorSparseWriter<TEdgeData>::UsesSecondaryGraphFile(void) const
+    {
+        return true;
+    }
+
+    // --------
+
+    template <> bool VectorSparseWriter<void>::UsesSecondaryGraphFile(void) const
+    {
+        return false;
+    }
+
+    // --------
+
+    template <typename TEdgeData> void VectorSparseWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        const VertexIndex& vertexIndex = (groupedByDestination ? graph.VertexIndexDestination() : graph.VertexIndexSource());
+        std::vector<char> output;
+        std::vector<char> edgeDataOutput;
+
+        output.reserve(((count / kVectorLanes) + 1) * kVectorLanes * sizeof(uint64_t));
+
+        // The edges of a top-level vertex may span several buffers, so its degree determines when its last vector is complete.
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (0 == numRemainingEdges)
+                numRemainingEdges = vertexIndex.GetDegree(groupedByDestination ? buf[i].destinationVertex : buf[i].sourceVertex);
+
+            pendingEdges[numPendingEdges] = buf[i];
+            numPendingEdges += 1;
+            numRemainingEdges -= 1;
+
+            if ((kVectorLanes == numPendingEdges) || (0 == numRemainingEdges))
+            {
+                PackVector(output, edgeDataOutput, pendingEdges, numPendingEdges, groupedByDestination);
+                numPendingEdges = 0;
+            }
+        }
+
+        if (!(output.empty()))
+            fwrite((void*)output.data(), sizeof(char), output.size(), graphfile);
+
+        if ((NULL != this->GetSecondaryGraphFile()) && !(edgeDataOutput.empty()))
+            fwrite((void*)edgeDataOutput.data(), sizeof(char), edgeDataOutput.size(), this->GetSecondaryGraphFile());
+    }
+
+
+    // -------- EXPLICIT TEMPLATE INSTANTIATIONS --------------------------- //
+
+    template class VectorSparseWriter<void>;
+    template class VectorSparseWriter<uint64_t>;
+    template class VectorSparseWriter<double>;
+    template class VectorSparseWriter<uint32_t>;
+    template class VectorSparseWriter<float>;
+}
@@ -0,0 +1,148 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file VertexIDMap.cpp
+ *   Implementation of a concurrent hash table that maps arbitrary vertex
+ *   identifiers to dense vertex identifiers.
+ *****************************************************************************/
+
+#include "MemoryTracker.h"
+#include "Types.h"
+#include "VertexIDMap.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+namespace GraphTool
+{
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Determines the number of slots needed to hold the specified number of identifiers, which keeps the table at most two-thirds full.
+    /// @param [in] maxIDs Maximum number of identifiers.
+    /// @return Number of slots, which is a power of two.
+    static inline size_t SlotsForIDs(const TVertexCount maxIDs)
+    {
+        const uint64_t minSlots = maxIDs + (maxIDs >> 1) + 1;
+        size_t numSlots = 1;
+
+        while (numSlots < minSlots)
+            numSlots <<= 1;
+
+        return numSlots;
+    }
+
+
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "VertexIDMap.h" for documentation.
+
+    VertexIDMap::VertexIDMap(void) : slots(NULL), slotMask(0), maxIDs(0), nextDenseID(0), overflowed(false)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    VertexIDMap::~VertexIDMap(void)
+    {
+        Release();
+    }
+
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "VertexIDMap.h" for documentation.
+
+    uint64_t VertexIDMap::EstimateBytes(const TVertexCount maxIDs)
+    {
+        return (uint64_t)SlotsForIDs(maxIDs) * sizeof(SSlot);
+    }
+
+
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "VertexIDMap.h" for documentation.
+
+    bool VertexIDMap::Allocate(const TVertexCount maxIDs)
+    {
+        Release();
+
+        const size_t numSlots = SlotsForIDs(maxIDs);
+
+        slots = new SSlot[numSlots];
+        if (NULL == slots)
+            return false;
+
+        MemoryTracker::RecordAllocation(slots, sizeof(SSlot) * numSlots, MemoryTracker::MemoryCategoryVertexIDMap);
+
+        for (size_t i = 0; i < numSlots; ++i)
+        {
+            slots[i].originalID.store(kEmptySlot, std::memory_order_relaxed);
+            slots[i].denseID.store(kPendingID, std::memory_order_relaxed);
+        }
+
+        slotMask = numSlots - 1;
+        this->maxIDs = maxIDs;
+        nextDenseID.store(0, std::memory_order_relaxed);
+        overflowed.store(false, std::memory_order_relaxed);
+
+        // Make the initialized table visible to any threads that are created afterwards to use it.
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    // --------
+
+    void VertexIDMap::Release(void)
+    {
+        if (NULL != slots)
+        {
+            MemoryTracker::RecordRelease(slots);
+            delete[] slots;
+        }
+
+        slots = NULL;
+        slotMask = 0;
+        maxIDs = 0;
+        nextDenseID.store(0, std::memory_order_relaxed);
+        overflowed.store(false, std::memory_order_relaxed);
+    }
+
+    // --------
+
+    EGraphResult VertexIDMap::WriteToFile(const char* const filename) const
+    {
+        // Invert the table so that identifiers can be written in the order of their dense identifiers.
+        const TVertexCount numIDs = GetNumIDs();
+        std::vector<TVertexID> originalIDs(numIDs, kInvalidID);
+
+        for (size_t i = 0; (NULL != slots) && (i <= slotMask); ++i)
+        {
+            const TVertexID denseID = slots[i].denseID.load(std::memory_order_relaxed);
+
+            if (denseID < numIDs)
+                originalIDs[denseID] = slots[i].originalID.load(std::memory_order_relaxed);
+        }
+
+        FILE* const mapfile = fopen(filename, "w");
+
+        if (NULL == mapfile)
+            return EGraphResult::GraphResultErrorCannotOpenFile;
+
+        bool writeSucceeded = true;
+
+        for (TVertexCount i = 0; (i < numIDs) && writeSucceeded; ++i)
+            writeSucceeded = (0 <= fprintf(mapfile, "%llu %llu\n", (long long unsigned int)i, (long long unsigned int)originalIDs[i]));
+
+        if (0 != fclose(mapfile))
+            writeSucceeded = false;
+
+        return (writeSucceeded ? EGraphResult::GraphResultSuccess : EGraphResult::GraphResultErrorIO);
+    }
+}
@@ -11,18 +11,66 @@
  *   for easy modification and traversal.
  *****************************************************************************/
 
+#include "Arena.h"
+#include "EdgeList.h"
+#include "MemoryTracker.h"
+#include "NUMASpawner.h"
 #include "VertexIndex.h"
 #include "Types.h"
+#include "VersionInfo.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <silo.h>
 #include <spindle.h>
+#include <type_traits>
+#include <utility>
+
+#ifdef __PLATFORM_LINUX
+#include <sys/mman.h>
+#endif
 
 
 namespace GraphTool
 {
+    // -------- LOCALS ----------------------------------------------------- //
+    
+    /// Compares the top-level vertex of an edge in a batch with the specified vertex, for locating the changes to a vertex within a sorted batch.
+    /// @param [in] edge Edge in the batch.
+    /// @param [in] vertex Vertex with which to compare.
+    /// @return `true` if the top-level vertex of the edge is less than the specified vertex, `false` otherwise.
+    static inline bool IsBatchTopLevelVertexLess(const SBatchEdge& edge, const TVertexID vertex)
+    {
+        return (edge.topLevelVertex < vertex);
+    }
+    
+    /// Compares the other vertex of an edge in a batch with the specified vertex, for locating a change within the sorted changes to a single top-level vertex.
+    /// @param [in] edge Edge in the batch.
+    /// @param [in] vertex Vertex with which to compare.
+    /// @return `true` if the other vertex of the edge is less than the specified vertex, `false` otherwise.
+    static inline bool IsBatchOtherVertexLess(const SBatchEdge& edge, const TVertexID vertex)
+    {
+        return (edge.otherVertex < vertex);
+    }
+    
+    /// Determines if the sorted changes to a single top-level vertex include an edge to the specified vertex.
+    /// @param [in] changes First change to the top-level vertex.
+    /// @param [in] changesEnd One past the last change to the top-level vertex.
+    /// @param [in] otherVertex Vertex at the other end of the edge.
+    /// @return `true` if so, `false` otherwise.
+    static inline bool IsBatchOtherVertexPresent(const SBatchEdge* const changes, const SBatchEdge* const changesEnd, const TVertexID otherVertex)
+    {
+        const SBatchEdge* const change = std::lower_bound(changes, changesEnd, otherVertex, &IsBatchOtherVertexLess);
+        return ((change != changesEnd) && (otherVertex == change->otherVertex));
+    }
+    
+    
     // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
     // See "VertexIndex.h" for documentation.
 
-    VertexIndex::VertexIndex(void) : vertexIndex(), numEdges(0), numVerticesPresent(0), numVectors(0)
+    VertexIndex::VertexIndex(void) : vertexIndex(), arenas(), numEdges(0), numVerticesPresent(0), numVectors(0), numFrozenVertices(0), frozenOffsets(NULL), frozenNeighbors(NULL), frozenNeighborsCompact(false), frozenEdgeData(NULL), frozenMapping(NULL), frozenMappingSize(0), preallocatedCursors(NULL), frozenSorted(false), frozenPartitionStarts(), frozenPartitionNUMANodes()
     {
         // Nothing to do here.
     }
@@ -31,29 +79,303 @@ namespace GraphTool
 
     VertexIndex::~VertexIndex(void)
     {
-        for (auto it = vertexIndex.begin(); it != vertexIndex.end(); ++it)
+        ReleaseArenas();
+        ReleaseFrozenArrays();
+        
+        if (NULL != preallocatedCursors)
         {
-            if (NULL != *it)
-            {
-                delete *it;
-                *it = NULL;
-            }
+            MemoryTracker::RecordRelease(preallocatedCursors);
+            delete[] preallocatedCursors;
         }
     }
 
 
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "VertexIndex.h" for documentation.
+    
+    uint64_t VertexIndex::EstimateFrozenBytes(const TVertexCount numVertices, const TVertexCount otherVertexLimit, const TEdgeCount numEdges, const bool keepEdgeData)
+    {
+        const uint64_t neighborSize = ((otherVertexLimit <= kMaxCompactVertexCount) ? sizeof(TCompactVertexID) : sizeof(TVertexID));
+        const uint64_t edgeSize = neighborSize + (keepEdgeData ? sizeof(UEdgeData) : 0);
+        
+        return ((uint64_t)sizeof(TEdgeCount) * (numVertices + 1)) + (edgeSize * numEdges);
+    }
+    
+    // --------
+    
+    uint64_t VertexIndex::EstimateMutableBytes(const TVertexCount numVertices, const TEdgeCount numEdges, const bool keepEdgeData)
+    {
+        const uint64_t alignmentMask = (uint64_t)(Arena::kAllocationAlignment - 1);
+        const uint64_t edgeListSize = ((uint64_t)sizeof(EdgeList) + alignmentMask) & ~alignmentMask;
+        const uint64_t numEdgeLists = ((numVertices < numEdges) ? numVertices : numEdges);
+        
+        return ((uint64_t)sizeof(EdgeList*) * numVertices) + (edgeListSize * numEdgeLists) + EdgeList::EstimateBlockBytes(numEdges, numEdgeLists, keepEdgeData);
+    }
+    
+    // --------
+    
+    uint64_t VertexIndex::EstimatePreallocatedIngressBytes(const TVertexCount numVertices)
+    {
+        return (uint64_t)sizeof(TEdgeCount) * numVertices;
+    }
+    
+    
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "VertexIndex.h" for documentation.
+    
+    void* VertexIndex::AllocateFrozenArray(const size_t elementSize, const std::vector<uint64_t>& partitionStarts, const uint64_t numElements) const
+    {
+        std::vector<SSiloMemorySpec> memorySpecs;
+        
+        // Each non-empty partition contributes one piece of the array, placed on its own NUMA node.
+        for (size_t i = 0; i < partitionStarts.size(); ++i)
+        {
+            const uint64_t partitionEnd = (((i + 1) < partitionStarts.size()) ? partitionStarts[i + 1] : numElements);
+            
+            if (partitionEnd > partitionStarts[i])
+            {
+                SSiloMemorySpec memorySpec;
+                memorySpec.size = elementSize * (size_t)(partitionEnd - partitionStarts[i]);
+                memorySpec.numaNode = frozenPartitionNUMANodes[i];
+                memorySpecs.push_back(memorySpec);
+            }
+        }
+        
+        void* frozenArray = NULL;
+        size_t frozenArraySize = elementSize;
+        
+        if (memorySpecs.empty())
+        {
+            frozenArray = siloSimpleBufferAlloc(elementSize, (frozenPartitionNUMANodes.empty() ? 0 : frozenPartitionNUMANodes[0]));
+        }
+        else if (1 == memorySpecs.size())
+        {
+            frozenArraySize = memorySpecs[0].size;
+            frozenArray = siloSimpleBufferAlloc(memorySpecs[0].size, memorySpecs[0].numaNode);
+        }
+        else
+        {
+            frozenArraySize = elementSize * (size_t)numElements;
+            frozenArray = siloMultinodeArrayAlloc((uint32_t)memorySpecs.size(), memorySpecs.data());
+        }
+        
+        MemoryTracker::RecordAllocation(frozenArray, frozenArraySize, MemoryTracker::MemoryCategoryVertexIndex);
+        return frozenArray;
+    }
+    
+    // --------
+    
+    void VertexIndex::AllocateFrozenEdges(const TVertexCount numVertices, const TVertexCount otherVertexLimit, const bool keepEdgeData)
+    {
+        // Each partition's edges begin at the position of the first edge of its first top-level vertex.
+        std::vector<uint64_t> edgePartitionStarts(frozenPartitionStarts.size());
+        
+        for (size_t i = 0; i < frozenPartitionStarts.size(); ++i)
+            edgePartitionStarts[i] = frozenOffsets[frozenPartitionStarts[i]];
+        
+        const TEdgeCount numFrozenEdges = frozenOffsets[numVertices];
+        
+        // Vertex identifiers are stored at the narrowest width that holds all of them.
+        frozenNeighborsCompact = (otherVertexLimit <= kMaxCompactVertexCount);
+        frozenNeighbors = AllocateFrozenArray((frozenNeighborsCompact ? sizeof(TCompactVertexID) : sizeof(TVertexID)), edgePartitionStarts, numFrozenEdges);
+        frozenEdgeData = (keepEdgeData ? (UEdgeData*)AllocateFrozenArray(sizeof(UEdgeData), edgePartitionStarts, numFrozenEdges) : NULL);
+    }
+    
+    // --------
+    
+    void VertexIndex::AllocateFrozenOffsets(const TVertexCount numVertices)
+    {
+        NUMASpawner::GetUnitRangesByNUMANode(numVertices, frozenPartitionStarts, frozenPartitionNUMANodes);
+        frozenOffsets = (TEdgeCount*)AllocateFrozenArray(sizeof(TEdgeCount), frozenPartitionStarts, numVertices + 1);
+    }
+    
+    // --------
+    
+    void VertexIndex::CopyFrozenEdges(const TEdgeID destinationPosition, const VertexIndex& index, const TEdgeID sourcePosition, const TEdgeCount count, const bool keepEdgeData)
+    {
+        if (0 == count)
+            return;
+        
+        if (frozenNeighborsCompact == index.frozenNeighborsCompact)
+        {
+            const size_t elementSize = (frozenNeighborsCompact ? sizeof(TCompactVertexID) : sizeof(TVertexID));
+            memcpy((void*)((uint8_t*)frozenNeighbors + (elementSize * destinationPosition)), (const void*)((const uint8_t*)index.frozenNeighbors + (elementSize * sourcePosition)), elementSize * count);
+        }
+        else
+        {
+            for (TEdgeCount i = 0; i < count; ++i)
+                SetFrozenNeighbor(destinationPosition + i, index.GetFrozenNeighbor(sourcePosition + i));
+        }
+        
+        if (keepEdgeData)
+        {
+            if (NULL != index.frozenEdgeData)
+                memcpy((void*)&frozenEdgeData[destinationPosition], (const void*)&index.frozenEdgeData[sourcePosition], sizeof(UEdgeData) * count);
+            else
+            {
+                for (TEdgeCount i = 0; i < count; ++i)
+                    frozenEdgeData[destinationPosition + i].Invalidate();
+            }
+        }
+    }
+    
+    // --------
+    
+    Arena& VertexIndex::GetSerialArena(void)
+    {
+        if (arenas.empty())
+        {
+            const int32_t numaNode = siloGetNUMANodeForVirtualAddress((void*)this);
+            arenas.push_back(new Arena((uint32_t)((numaNode < 0) ? 0 : numaNode)));
+        }
+        
+        return *arenas[0];
+    }
+    
+    // --------
+    
+    void VertexIndex::ReleaseArenas(void)
+    {
+        for (auto it = arenas.begin(); it != arenas.end(); ++it)
+            delete *it;
+        
+        arenas.clear();
+    }
+    
+    // --------
+    
+    void VertexIndex::ReleaseFrozenArray(const void* const frozenArray)
+    {
+        if ((NULL == frozenArray) || IsWithinFrozenMapping(frozenArray))
+            return;
+        
+        MemoryTracker::RecordRelease(frozenArray);
+        siloFree((void*)frozenArray);
+    }
+    
+    // --------
+    
+    void VertexIndex::ReleaseFrozenArrays(void)
+    {
+        ReleaseFrozenArray(frozenOffsets);
+        ReleaseFrozenArray(frozenNeighbors);
+        ReleaseFrozenArray(frozenEdgeData);
+        
+        frozenOffsets = NULL;
+        frozenNeighbors = NULL;
+        frozenEdgeData = NULL;
+        
+        ReleaseFrozenMapping();
+    }
+    
+    // --------
+    
+    void VertexIndex::ReleaseFrozenMapping(void)
+    {
+        if ((NULL == frozenMapping) || IsWithinFrozenMapping(frozenOffsets) || IsWithinFrozenMapping(frozenNeighbors) || IsWithinFrozenMapping(frozenEdgeData))
+            return;
+        
+        MemoryTracker::RecordRelease(frozenMapping);
+        
+#ifdef __PLATFORM_LINUX
+        munmap(frozenMapping, frozenMappingSize);
+#endif
+        
+        frozenMapping = NULL;
+        frozenMappingSize = 0;
+    }
+    
+    
     // -------- INSTANCE METHODS ------------------------------------------- //
     // See "VertexIndex.h" for documentation.
 
+    void VertexIndex::AdoptFrozenMapping(void* const mapping, const size_t mappingSize, const TVertexCount numVertices, const TVertexCount numVerticesPresent, const uint64_t numVectors, TEdgeCount* const offsets, void* const neighbors, const bool neighborsCompact, UEdgeData* const edgeData, const bool sorted)
+    {
+        Clear();
+        
+        // The whole region is accounted for as soon as it is mapped, even though its pages are only read from the file as they are first touched.
+        frozenMapping = mapping;
+        frozenMappingSize = mappingSize;
+        MemoryTracker::RecordAllocation(frozenMapping, frozenMappingSize, MemoryTracker::MemoryCategoryVertexIndex);
+        
+        NUMASpawner::GetUnitRangesByNUMANode(numVertices, frozenPartitionStarts, frozenPartitionNUMANodes);
+        numFrozenVertices = numVertices;
+        frozenOffsets = offsets;
+        frozenNeighbors = neighbors;
+        frozenNeighborsCompact = neighborsCompact;
+        frozenEdgeData = edgeData;
+        frozenSorted = sorted;
+        
+        this->numEdges = offsets[numVertices];
+        this->numVerticesPresent = numVerticesPresent;
+        this->numVectors = numVectors;
+    }
+    
+    // --------
+    
+    void VertexIndex::AllocateEdgeData(void)
+    {
+        if (!IsFrozen())
+        {
+            for (auto it = vertexIndex.begin(); it != vertexIndex.end(); ++it)
+            {
+                if (NULL != *it)
+                    (*it)->AllocateEdgeData();
+            }
+            
+            return;
+        }
+        
+        if (NULL != frozenEdgeData)
+            return;
+        
+        std::vector<uint64_t> edgePartitionStarts(frozenPartitionStarts.size());
+        
+        for (size_t i = 0; i < frozenPartitionStarts.size(); ++i)
+            edgePartitionStarts[i] = frozenOffsets[frozenPartitionStarts[i]];
+        
+        const TEdgeCount numFrozenEdges = frozenOffsets[numFrozenVertices];
+        frozenEdgeData = (UEdgeData*)AllocateFrozenArray(sizeof(UEdgeData), edgePartitionStarts, numFrozenEdges);
+        
+        for (TEdgeCount i = 0; i < numFrozenEdges; ++i)
+            frozenEdgeData[i].Invalidate();
+    }
+    
+    // --------
+    
+    void VertexIndex::Clear(void)
+    {
+        ReleaseArenas();
+        std::vector<EdgeList*>().swap(vertexIndex);
+        ReleaseFrozenArrays();
+        
+        if (NULL != preallocatedCursors)
+        {
+            MemoryTracker::RecordRelease(preallocatedCursors);
+            delete[] preallocatedCursors;
+            preallocatedCursors = NULL;
+        }
+        
+        numEdges = 0;
+        numVectors = 0;
+        numVerticesPresent = 0;
+        numFrozenVertices = 0;
+        frozenSorted = false;
+    }
+    
+    // --------
+    
     template <typename TEdgeData> void VertexIndex::InsertEdgeIndexedByDestination(const SEdge<TEdgeData>& edge)
     {
+        Thaw();
+        
         if (edge.destinationVertex >= vertexIndex.size())
             vertexIndex.resize(1 + edge.destinationVertex);
         
         if (NULL == vertexIndex[edge.destinationVertex])
         {
             numVerticesPresent += 1;
-            vertexIndex[edge.destinationVertex] = new EdgeList();
+            vertexIndex[edge.destinationVertex] = EdgeList::CreateInArena(GetSerialArena(), !std::is_void<TEdgeData>::value);
         }
         
         const TEdgeCount oldDegree = vertexIndex[edge.destinationVertex]->GetDegree();
@@ -72,13 +394,15 @@ namespace GraphTool
 
     template <typename TEdgeData> void VertexIndex::InsertEdgeIndexedBySource(const SEdge<TEdgeData>& edge)
     {
+        Thaw();
+        
         if (edge.sourceVertex >= vertexIndex.size())
             vertexIndex.resize(1 + edge.sourceVertex);
 
         if (NULL == vertexIndex[edge.sourceVertex])
         {
             numVerticesPresent += 1;
-            vertexIndex[edge.sourceVertex] = new EdgeList();
+            vertexIndex[edge.sourceVertex] = EdgeList::CreateInArena(GetSerialArena(), !std::is_void<TEdgeData>::value);
         }
         
         const TEdgeCount oldDegree = vertexIndex[edge.sourceVertex]->GetDegree();
@@ -95,107 +419,1364 @@ namespace GraphTool
 
     // --------
 
-    void VertexIndex::ParallelRefreshMetadata(uint64_t* buf)
+    void VertexIndex::ParallelAdoptDegrees(const TEdgeCount* degrees, const TVertexCount numVertices, uint64_t* buf)
     {
-        const uint32_t localThreadID = spindleGetLocalThreadID();
-        const uint32_t localThreadCount = spindleGetLocalThreadCount();
-        
-        const size_t indexDegree = localThreadID;
-        const size_t indexVector = localThreadCount + indexDegree;
-        const size_t indexVerticesPresent = (localThreadCount << 1) + indexDegree;
-        
-        spindleBarrierLocal();
-        
-        buf[indexDegree] = 0;
-        buf[indexVector] = 0;
-        buf[indexVerticesPresent] = 0;
-        
-        for (size_t i = localThreadID; i < vertexIndex.size(); i += localThreadCount)
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+
+        // The buffer holds the number of edges in each thread's range, followed by three counts per thread.
+        uint64_t* const threadCounts = &buf[globalThreadCount];
+
+        // The number of vertices is known up front, so the offsets can be allocated right away.
+        if (0 == globalThreadID)
         {
-            if (NULL != vertexIndex[i])
-            {
-                buf[indexDegree] += vertexIndex[i]->GetDegree();
-                buf[indexVector] += vertexIndex[i]->GetNumVectors();
-                buf[indexVerticesPresent] += 1;
-            }
+            Clear();
+            AllocateFrozenOffsets(numVertices);
+            numFrozenVertices = numVertices;
         }
-        
-        spindleBarrierLocal();
-        
-        if (0 == localThreadID)
+
+        spindleBarrierGlobal();
+
+        // Each thread is responsible for a contiguous range of top-level vertices, whose degrees it sums while gathering metadata.
+        const TVertexID rangeStart = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+
+        buf[globalThreadID] = 0;
+        threadCounts[(globalThreadID * 3)] = 0;
+        threadCounts[(globalThreadID * 3) + 1] = 0;
+        threadCounts[(globalThreadID * 3) + 2] = 0;
+
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
         {
-            numEdges = 0;
-            numVectors = 0;
-            numVerticesPresent = 0;
-            
-            for (size_t i = 0; i < localThreadCount; ++i)
+            const TEdgeCount degree = degrees[i];
+
+            if (0 != degree)
             {
-                numEdges += buf[i];
-                numVectors += buf[i + localThreadCount];
-                numVerticesPresent += buf[i + (localThreadCount << 1)];
+                buf[globalThreadID] += degree;
+                threadCounts[(globalThreadID * 3) + 1] += ((degree + 3) >> 2);
+                threadCounts[(globalThreadID * 3) + 2] += 1;
             }
         }
-    }
-    
-    // --------
-    
-    void VertexIndex::RemoveEdge(const TVertexID indexedVertex, const TVertexID otherVertex)
-    {
-        if (NULL != vertexIndex[indexedVertex])
-        {
-            const TEdgeCount oldDegree = vertexIndex[indexedVertex]->GetDegree();
-            const size_t oldVectors = vertexIndex[indexedVertex]->GetNumVectors();
 
-            vertexIndex[indexedVertex]->RemoveEdge(otherVertex);
+        spindleBarrierGlobal();
 
-            if (oldDegree > vertexIndex[indexedVertex]->GetDegree())
-                numEdges -= 1;
-            
-            if (oldVectors > vertexIndex[indexedVertex]->GetNumVectors())
-                numVectors -= 1;
+        if (0 == globalThreadID)
+        {
+            TEdgeCount numFrozenEdges = 0;
 
-            if (0 == vertexIndex[indexedVertex]->GetDegree())
+            numVectors = 0;
+            numVerticesPresent = 0;
+
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
             {
-                delete vertexIndex[indexedVertex];
-                vertexIndex[indexedVertex] = NULL;
-                numVerticesPresent -= 1;
+                const TEdgeCount rangeEdges = buf[i];
+                buf[i] = numFrozenEdges;
+                numFrozenEdges += rangeEdges;
+
+                numVectors += threadCounts[(i * 3) + 1];
+                numVerticesPresent += threadCounts[(i * 3) + 2];
             }
+
+            frozenOffsets[numVertices] = numFrozenEdges;
+            numEdges = numFrozenEdges;
         }
-    }
 
-    // --------
+        spindleBarrierGlobal();
 
-    void VertexIndex::RemoveVertex(const TVertexID indexedVertex)
-    {
-        if (NULL != vertexIndex[indexedVertex])
+        // Convert each degree into the position of the first edge of its vertex.
+        TEdgeCount position = buf[globalThreadID];
+
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
         {
-            numEdges -= vertexIndex[indexedVertex]->GetDegree();
-            numVectors -= vertexIndex[indexedVertex]->GetNumVectors();
-            
-            delete vertexIndex[indexedVertex];
-            vertexIndex[indexedVertex] = NULL;
-            numVerticesPresent -= 1;
+            frozenOffsets[i] = position;
+            position += degrees[i];
         }
+
+        spindleBarrierGlobal();
     }
 
     // --------
 
-    void VertexIndex::SetNumVertices(const TVertexCount numVertices)
+    void VertexIndex::ParallelAllocateFromDegrees(const bool keepEdgeData, uint64_t* buf)
     {
-        if (numVertices < vertexIndex.size())
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        spindleBarrierLocal();
+        
+        // Each thread is responsible for a contiguous range of top-level vertices.
+        const TVertexCount numVertices = numFrozenVertices;
+        const TVertexID rangeStart = (TVertexID)((numVertices * localThreadID) / localThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (localThreadID + 1)) / localThreadCount);
+        
+        // Sum the degrees in each range so that each thread knows where its portion of the compact arrays begins.
+        buf[localThreadID] = 0;
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+            buf[localThreadID] += preallocatedCursors[i];
+        
+        spindleBarrierLocal();
+        
+        if (0 == localThreadID)
         {
-            for (size_t i = numVertices; i < vertexIndex.size(); ++i)
+            TEdgeCount numFrozenEdges = 0;
+            
+            for (uint32_t i = 0; i < localThreadCount; ++i)
             {
-                if (NULL != vertexIndex[i])
-                {
-                    delete vertexIndex[i];
-                    vertexIndex[i] = NULL;
-                    numVerticesPresent -= 1;
-                }
+                const TEdgeCount rangeEdges = buf[i];
+                buf[i] = numFrozenEdges;
+                numFrozenEdges += rangeEdges;
             }
+            
+            // The compact representation is placed to suit later parallelized regions that span all NUMA nodes, rather than the threads performing ingress.
+            AllocateFrozenOffsets(numVertices);
+            frozenOffsets[numVertices] = numFrozenEdges;
+            frozenSorted = false;
         }
         
-        vertexIndex.resize(numVertices, NULL);
+        spindleBarrierLocal();
+        
+        // Convert each degree into the position of the first edge of its vertex, which is also where the second pass starts placing edges.
+        TEdgeCount position = buf[localThreadID];
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            const TEdgeCount degree = preallocatedCursors[i];
+            
+            frozenOffsets[i] = position;
+            preallocatedCursors[i] = position;
+            position += degree;
+        }
+        
+        spindleBarrierLocal();
+        
+        // Edge arrays can only be placed once the offsets identify where each partition's edges begin.
+        if (0 == localThreadID)
+            AllocateFrozenEdges(numVertices, numVertices, keepEdgeData);
+        
+        spindleBarrierLocal();
+    }
+    
+    // --------
+    
+    void VertexIndex::ParallelApplyBatchFrozen(const VertexIndex& index, const SBatchEdge* insertions, const TEdgeCount numInsertions, const SBatchEdge* deletions, const TEdgeCount numDeletions, const TVertexCount numVertices, const bool keepEdgeData, uint64_t* buf)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        // The buffer holds the number of edges in each thread's range, followed by three counts per thread.
+        uint64_t* const threadCounts = &buf[globalThreadCount];
+        
+        spindleBarrierGlobal();
+        
+        // Each thread is responsible for a contiguous range of top-level vertices and for the changes to those vertices, which are consecutive in each batch.
+        const TVertexID rangeStart = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+        
+        const SBatchEdge* const rangeInsertions = std::lower_bound(insertions, &insertions[numInsertions], rangeStart, &IsBatchTopLevelVertexLess);
+        const SBatchEdge* const rangeInsertionsEnd = std::lower_bound(rangeInsertions, &insertions[numInsertions], rangeEnd, &IsBatchTopLevelVertexLess);
+        const SBatchEdge* const rangeDeletions = std::lower_bound(deletions, &deletions[numDeletions], rangeStart, &IsBatchTopLevelVertexLess);
+        const SBatchEdge* const rangeDeletionsEnd = std::lower_bound(rangeDeletions, &deletions[numDeletions], rangeEnd, &IsBatchTopLevelVertexLess);
+        
+        // The number of vertices is known up front, so the offsets can be allocated before the degrees are known and used to hold them in the meantime.
+        if (0 == globalThreadID)
+        {
+            ReleaseArenas();
+            std::vector<EdgeList*>().swap(vertexIndex);
+            ReleaseFrozenArrays();
+            
+            AllocateFrozenOffsets(numVertices);
+            numFrozenVertices = numVertices;
+            frozenSorted = index.IsFrozenSorted();
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Count the degree of each vertex in this thread's range while gathering metadata.
+        // Only vertices with deletions need their edges examined.
+        const SBatchEdge* insertion = rangeInsertions;
+        const SBatchEdge* deletion = rangeDeletions;
+        
+        buf[globalThreadID] = 0;
+        threadCounts[(globalThreadID * 3)] = 0;
+        threadCounts[(globalThreadID * 3) + 1] = 0;
+        threadCounts[(globalThreadID * 3) + 2] = 0;
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            const TEdgeID edgesStart = ((i < index.numFrozenVertices) ? index.frozenOffsets[i] : 0);
+            const TEdgeID edgesEnd = ((i < index.numFrozenVertices) ? index.frozenOffsets[i + 1] : 0);
+            const SBatchEdge* const vertexDeletions = deletion;
+            TEdgeCount degree = 0;
+            
+            while ((deletion < rangeDeletionsEnd) && (i == deletion->topLevelVertex))
+                deletion += 1;
+            
+            if (vertexDeletions == deletion)
+                degree = edgesEnd - edgesStart;
+            else
+            {
+                for (TEdgeID edge = edgesStart; edge < edgesEnd; ++edge)
+                {
+                    if (!IsBatchOtherVertexPresent(vertexDeletions, deletion, index.GetFrozenNeighbor(edge)))
+                        degree += 1;
+                }
+            }
+            
+            while ((insertion < rangeInsertionsEnd) && (i == insertion->topLevelVertex))
+            {
+                insertion += 1;
+                degree += 1;
+            }
+            
+            if (0 != degree)
+            {
+                threadCounts[(globalThreadID * 3)] += degree;
+                threadCounts[(globalThreadID * 3) + 1] += ((degree + 3) >> 2);
+                threadCounts[(globalThreadID * 3) + 2] += 1;
+            }
+            
+            frozenOffsets[i] = degree;
+            buf[globalThreadID] += degree;
+        }
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            TEdgeCount numFrozenEdges = 0;
+            
+            numEdges = 0;
+            numVectors = 0;
+            numVerticesPresent = 0;
+            
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                const TEdgeCount rangeEdges = buf[i];
+                buf[i] = numFrozenEdges;
+                numFrozenEdges += rangeEdges;
+                
+                numEdges += threadCounts[(i * 3)];
+                numVectors += threadCounts[(i * 3) + 1];
+                numVerticesPresent += threadCounts[(i * 3) + 2];
+            }
+            
+            frozenOffsets[numVertices] = numFrozenEdges;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Convert each degree into the position of the first edge of its vertex.
+        TEdgeCount position = buf[globalThreadID];
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            const TEdgeCount degree = frozenOffsets[i];
+            
+            frozenOffsets[i] = position;
+            position += degree;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Edge arrays can only be placed once the offsets identify where each partition's edges begin.
+        if (0 == globalThreadID)
+            AllocateFrozenEdges(numVertices, numVertices, keepEdgeData);
+        
+        spindleBarrierGlobal();
+        
+        // Fill in the edges of each top-level vertex.
+        // Consecutive vertices without changes occupy consecutive positions in both indices, so their edges are gathered into a single block and copied at once.
+        TEdgeID unchangedSourcePosition = 0;
+        TEdgeID unchangedDestinationPosition = 0;
+        TEdgeCount numUnchangedEdges = 0;
+        
+        insertion = rangeInsertions;
+        deletion = rangeDeletions;
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            const TEdgeID edgesStart = ((i < index.numFrozenVertices) ? index.frozenOffsets[i] : 0);
+            const TEdgeID edgesEnd = ((i < index.numFrozenVertices) ? index.frozenOffsets[i + 1] : 0);
+            const SBatchEdge* const vertexDeletions = deletion;
+            
+            while ((deletion < rangeDeletionsEnd) && (i == deletion->topLevelVertex))
+                deletion += 1;
+            
+            const bool vertexHasChanges = ((vertexDeletions != deletion) || ((insertion < rangeInsertionsEnd) && (i == insertion->topLevelVertex)));
+            
+            if (!vertexHasChanges)
+            {
+                if (0 == numUnchangedEdges)
+                {
+                    unchangedSourcePosition = edgesStart;
+                    unchangedDestinationPosition = frozenOffsets[i];
+                }
+                
+                numUnchangedEdges += edgesEnd - edgesStart;
+                continue;
+            }
+            
+            CopyFrozenEdges(unchangedDestinationPosition, index, unchangedSourcePosition, numUnchangedEdges, keepEdgeData);
+            numUnchangedEdges = 0;
+            
+            TEdgeID position = frozenOffsets[i];
+            
+            for (TEdgeID edge = edgesStart; edge < edgesEnd; ++edge)
+            {
+                const TVertexID otherVertex = index.GetFrozenNeighbor(edge);
+                
+                if (IsBatchOtherVertexPresent(vertexDeletions, deletion, otherVertex))
+                    continue;
+                
+                // Insertions are merged into a sorted index ahead of the first edge that follows them, keeping existing edges ahead of equal insertions.
+                while (frozenSorted && (insertion < rangeInsertionsEnd) && (i == insertion->topLevelVertex) && (insertion->otherVertex < otherVertex))
+                {
+                    SetFrozenNeighbor(position, insertion->otherVertex);
+                    
+                    if (keepEdgeData)
+                        frozenEdgeData[position] = insertion->edgeData;
+                    
+                    insertion += 1;
+                    position += 1;
+                }
+                
+                CopyFrozenEdges(position, index, edge, 1, keepEdgeData);
+                position += 1;
+            }
+            
+            while ((insertion < rangeInsertionsEnd) && (i == insertion->topLevelVertex))
+            {
+                SetFrozenNeighbor(position, insertion->otherVertex);
+                
+                if (keepEdgeData)
+                    frozenEdgeData[position] = insertion->edgeData;
+                
+                insertion += 1;
+                position += 1;
+            }
+        }
+        
+        CopyFrozenEdges(unchangedDestinationPosition, index, unchangedSourcePosition, numUnchangedEdges, keepEdgeData);
+        
+        spindleBarrierGlobal();
+    }
+    
+    // --------
+    
+    void VertexIndex::ParallelBeginPreallocatedIngress(const TVertexCount numVertices)
+    {
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        spindleBarrierLocal();
+        
+        if (0 == localThreadID)
+        {
+            // Discard the existing contents of the index, whichever representation they are in.
+            ReleaseArenas();
+            std::vector<EdgeList*>().swap(vertexIndex);
+            
+            ReleaseFrozenArrays();
+            
+            if (NULL != preallocatedCursors)
+            {
+                MemoryTracker::RecordRelease(preallocatedCursors);
+                delete[] preallocatedCursors;
+            }
+            
+            numEdges = 0;
+            numVectors = 0;
+            numVerticesPresent = 0;
+            
+            // The number of vertices is recorded now but only takes effect once the compact representation is allocated.
+            numFrozenVertices = numVertices;
+            preallocatedCursors = new TEdgeCount[numVertices];
+            MemoryTracker::RecordAllocation(preallocatedCursors, sizeof(TEdgeCount) * (size_t)numVertices, MemoryTracker::MemoryCategoryVertexIndex);
+        }
+        
+        spindleBarrierLocal();
+        
+        for (TVertexID i = (TVertexID)((numVertices * localThreadID) / localThreadCount); i < (TVertexID)((numVertices * (localThreadID + 1)) / localThreadCount); ++i)
+            preallocatedCursors[i] = 0;
+        
+        spindleBarrierLocal();
+    }
+    
+    // --------
+    
+    void VertexIndex::ParallelCompactFrozen(const TEdgeCount* keptDegrees, uint64_t* buf)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        spindleBarrierGlobal();
+        
+        if (!IsFrozen())
+            return;
+        
+        // Each thread is responsible for a contiguous range of top-level vertices.
+        const TVertexCount numVertices = numFrozenVertices;
+        const TVertexID rangeStart = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+        
+        // Edges only ever move towards the start of the arrays, so compaction can happen in place.
+        // First, each thread compacts its own range towards the start of that range, which leaves the offset of the first vertex in the range unchanged.
+        // Metadata for the range are gathered along the way, following the buffer's first location per thread.
+        uint64_t* const threadCounts = &buf[globalThreadCount];
+        TEdgeCount position = ((rangeStart < rangeEnd) ? frozenOffsets[rangeStart] : 0);
+        
+        threadCounts[(globalThreadID * 3)] = 0;
+        threadCounts[(globalThreadID * 3) + 1] = 0;
+        threadCounts[(globalThreadID * 3) + 2] = 0;
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            const TEdgeCount oldPosition = frozenOffsets[i];
+            
+            MoveFrozenNeighbors(position, oldPosition, keptDegrees[i]);
+            
+            if (NULL != frozenEdgeData)
+                memmove((void*)&frozenEdgeData[position], (void*)&frozenEdgeData[oldPosition], sizeof(UEdgeData) * keptDegrees[i]);
+            
+            if (0 != keptDegrees[i])
+            {
+                threadCounts[(globalThreadID * 3)] += keptDegrees[i];
+                threadCounts[(globalThreadID * 3) + 1] += ((keptDegrees[i] + 3) >> 2);
+                threadCounts[(globalThreadID * 3) + 2] += 1;
+            }
+            
+            frozenOffsets[i] = position;
+            position += keptDegrees[i];
+        }
+        
+        buf[globalThreadID] = ((rangeStart < rangeEnd) ? (position - frozenOffsets[rangeStart]) : 0);
+        
+        spindleBarrierGlobal();
+        
+        // Next, a single thread slides each compacted range down into its final position, in order, and records how far each one moved.
+        if (0 == globalThreadID)
+        {
+            TEdgeCount compactedPosition = 0;
+            
+            numEdges = 0;
+            numVectors = 0;
+            numVerticesPresent = 0;
+            
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                numEdges += threadCounts[(i * 3)];
+                numVectors += threadCounts[(i * 3) + 1];
+                numVerticesPresent += threadCounts[(i * 3) + 2];
+            }
+            
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                const TVertexID threadRangeStart = (TVertexID)((numVertices * i) / globalThreadCount);
+                const TVertexID threadRangeEnd = (TVertexID)((numVertices * (i + 1)) / globalThreadCount);
+                const TEdgeCount threadRangeEdges = buf[i];
+                
+                if (threadRangeStart == threadRangeEnd)
+                {
+                    buf[i] = 0;
+                    continue;
+                }
+                
+                const TEdgeCount threadRangePosition = frozenOffsets[threadRangeStart];
+                
+                MoveFrozenNeighbors(compactedPosition, threadRangePosition, threadRangeEdges);
+                
+                if (NULL != frozenEdgeData)
+                    memmove((void*)&frozenEdgeData[compactedPosition], (void*)&frozenEdgeData[threadRangePosition], sizeof(UEdgeData) * threadRangeEdges);
+                
+                buf[i] = threadRangePosition - compactedPosition;
+                compactedPosition += threadRangeEdges;
+            }
+            
+            frozenOffsets[numVertices] = compactedPosition;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Finally, each thread adjusts the offsets in its range to account for the distance its edges moved.
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+            frozenOffsets[i] -= buf[globalThreadID];
+        
+        spindleBarrierGlobal();
+    }
+    
+    // --------
+    
+    void VertexIndex::ParallelEndPreallocatedIngress(void)
+    {
+        spindleBarrierLocal();
+        
+        if (0 == spindleGetLocalThreadID())
+        {
+            MemoryTracker::RecordRelease(preallocatedCursors);
+            delete[] preallocatedCursors;
+            preallocatedCursors = NULL;
+        }
+        
+        spindleBarrierLocal();
+    }
+    
+    // --------
+    
+    void VertexIndex::ParallelFreeze(const bool keepEdgeData, const TVertexCount otherVertexLimit, uint64_t* buf)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        spindleBarrierGlobal();
+        
+        if (IsFrozen())
+            return;
+        
+        // Each thread is responsible for a contiguous range of top-level vertices, such that each task's range is also contiguous and matches the frozen partition for its NUMA node.
+        const TVertexCount numVertices = vertexIndex.size();
+        const TVertexID rangeStart = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+        
+        // Count the edges in each range so that each thread knows where its portion of the frozen arrays begins.
+        buf[globalThreadID] = 0;
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            if (NULL != vertexIndex[i])
+                buf[globalThreadID] += vertexIndex[i]->GetDegree();
+        }
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            TEdgeCount numFrozenEdges = 0;
+            
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                const TEdgeCount rangeEdges = buf[i];
+                buf[i] = numFrozenEdges;
+                numFrozenEdges += rangeEdges;
+            }
+            
+            AllocateFrozenOffsets(numVertices);
+            frozenOffsets[numVertices] = numFrozenEdges;
+            frozenSorted = false;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Fill in the offsets first, since the edge arrays can only be placed once the offsets identify where each partition's edges begin.
+        TEdgeCount position = buf[globalThreadID];
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            frozenOffsets[i] = position;
+            
+            if (NULL != vertexIndex[i])
+                position += vertexIndex[i]->GetDegree();
+        }
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+            AllocateFrozenEdges(numVertices, otherVertexLimit, keepEdgeData);
+        
+        spindleBarrierGlobal();
+        
+        // Copy each edge list into the frozen arrays, so that each thread only writes to memory on its own NUMA node.
+        position = buf[globalThreadID];
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            if (NULL != vertexIndex[i])
+            {
+                for (auto it = vertexIndex[i]->BeginIterator(); it != vertexIndex[i]->EndIterator(); ++it)
+                {
+                    SetFrozenNeighbor(position, it.GetOtherVertex());
+                    
+                    if (keepEdgeData)
+                        frozenEdgeData[position] = it.GetEdgeData();
+                    
+                    position += 1;
+                }
+            }
+        }
+        
+        spindleBarrierGlobal();
+        
+        // All edge lists live in arenas, so destroying the mutable representation only requires returning a few large chunks.
+        for (size_t i = globalThreadID; i < arenas.size(); i += globalThreadCount)
+        {
+            delete arenas[i];
+            arenas[i] = NULL;
+        }
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            numFrozenVertices = numVertices;
+            std::vector<EdgeList*>().swap(vertexIndex);
+            arenas.clear();
+        }
+        
+        spindleBarrierGlobal();
+    }
+    
+    // --------
+    
+    void VertexIndex::ParallelInitializeArenas(const uint32_t numaNode)
+    {
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        spindleBarrierLocal();
+        
+        if (0 == localThreadID)
+        {
+            while (arenas.size() < localThreadCount)
+                arenas.push_back(new Arena(numaNode));
+        }
+        
+        spindleBarrierLocal();
+    }
+    
+    // --------
+    
+    void VertexIndex::ParallelRefreshMetadata(uint64_t* buf)
+    {
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        
+        const size_t indexDegree = localThreadID;
+        const size_t indexVector = localThreadCount + indexDegree;
+        const size_t indexVerticesPresent = (localThreadCount << 1) + indexDegree;
+        
+        spindleBarrierLocal();
+        
+        buf[indexDegree] = 0;
+        buf[indexVector] = 0;
+        buf[indexVerticesPresent] = 0;
+        
+        if (IsFrozen())
+        {
+            for (size_t i = localThreadID; i < numFrozenVertices; i += localThreadCount)
+            {
+                const TEdgeCount degree = frozenOffsets[i + 1] - frozenOffsets[i];
+                
+                if (0 != degree)
+                {
+                    buf[indexDegree] += degree;
+                    buf[indexVector] += ((degree + 3) >> 2);
+                    buf[indexVerticesPresent] += 1;
+                }
+            }
+        }
+        else
+        {
+            for (size_t i = localThreadID; i < vertexIndex.size(); i += localThreadCount)
+            {
+                if (NULL != vertexIndex[i])
+                {
+                    buf[indexDegree] += vertexIndex[i]->GetDegree();
+                    buf[indexVector] += vertexIndex[i]->GetNumVectors();
+                    buf[indexVerticesPresent] += 1;
+                }
+            }
+        }
+        
+        spindleBarrierLocal();
+        
+        if (0 == localThreadID)
+        {
+            numEdges = 0;
+            numVectors = 0;
+            numVerticesPresent = 0;
+            
+            for (size_t i = 0; i < localThreadCount; ++i)
+            {
+                numEdges += buf[i];
+                numVectors += buf[i + localThreadCount];
+                numVerticesPresent += buf[i + (localThreadCount << 1)];
+            }
+        }
+    }
+    
+    // --------
+
+    void VertexIndex::ParallelRelabelFrozen(const TVertexID* newIDs, const TVertexID* oldIDs, const TVertexCount numVertices, uint64_t* buf)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        spindleBarrierGlobal();
+        
+        if (!IsFrozen())
+            return;
+        
+        // The existing frozen arrays are read while their replacements are filled in, so every thread takes note of them before they are replaced.
+        const TVertexCount oldNumVertices = numFrozenVertices;
+        const TEdgeCount* const oldOffsets = frozenOffsets;
+        const void* const oldNeighbors = frozenNeighbors;
+        const bool oldNeighborsCompact = frozenNeighborsCompact;
+        const UEdgeData* const oldEdgeData = frozenEdgeData;
+        
+        // Each thread is responsible for a contiguous range of top-level vertices, identified by their new identifiers.
+        // Vertices beyond the end of the existing index have no edges.
+        const TVertexID rangeStart = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+        
+        auto oldDegree = [oldOffsets, oldNumVertices](const TVertexID oldVertex) -> TEdgeCount
+        {
+            return ((oldVertex < oldNumVertices) ? (oldOffsets[oldVertex + 1] - oldOffsets[oldVertex]) : 0);
+        };
+        
+        buf[globalThreadID] = 0;
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+            buf[globalThreadID] += oldDegree(oldIDs[i]);
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            TEdgeCount numFrozenEdges = 0;
+            
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                const TEdgeCount rangeEdges = buf[i];
+                buf[i] = numFrozenEdges;
+                numFrozenEdges += rangeEdges;
+            }
+            
+            AllocateFrozenOffsets(numVertices);
+            frozenOffsets[numVertices] = numFrozenEdges;
+            numFrozenVertices = numVertices;
+            frozenSorted = false;
+        }
+        
+        spindleBarrierGlobal();
+        
+        TEdgeCount position = buf[globalThreadID];
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            frozenOffsets[i] = position;
+            position += oldDegree(oldIDs[i]);
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Edge arrays can only be placed once the offsets identify where each partition's edges begin.
+        if (0 == globalThreadID)
+            AllocateFrozenEdges(numVertices, numVertices, (NULL != oldEdgeData));
+        
+        spindleBarrierGlobal();
+        
+        // Copy the edges of each top-level vertex from its old position, renaming the vertex at the other end of each one.
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            const TVertexID oldVertex = oldIDs[i];
+            
+            if (oldVertex >= oldNumVertices)
+                continue;
+            
+            TEdgeID position = frozenOffsets[i];
+            
+            for (TEdgeID edge = oldOffsets[oldVertex]; edge < oldOffsets[oldVertex + 1]; ++edge, ++position)
+            {
+                const TVertexID oldNeighbor = (oldNeighborsCompact ? (TVertexID)((const TCompactVertexID*)oldNeighbors)[edge] : ((const TVertexID*)oldNeighbors)[edge]);
+                SetFrozenNeighbor(position, newIDs[oldNeighbor]);
+                
+                if (NULL != oldEdgeData)
+                    frozenEdgeData[position] = oldEdgeData[edge];
+            }
+        }
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            ReleaseFrozenArray(oldOffsets);
+            ReleaseFrozenArray(oldNeighbors);
+            ReleaseFrozenArray(oldEdgeData);
+            ReleaseFrozenMapping();
+        }
+        
+        spindleBarrierGlobal();
+    }
+    
+    // --------
+    
+    void VertexIndex::ParallelSymmetrizeFrozen(const VertexIndex& index, const VertexIndex& transposeIndex, const bool keepEdgeData, uint64_t* buf)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        // The buffer holds the number of edges in each thread's range, followed by three counts per thread.
+        uint64_t* const threadCounts = &buf[globalThreadCount];
+        
+        spindleBarrierGlobal();
+        
+        // Every identifier is less than the size of the larger index, so the result is given that many top-level vertices.
+        const TVertexCount numVertices = ((index.numFrozenVertices > transposeIndex.numFrozenVertices) ? index.numFrozenVertices : transposeIndex.numFrozenVertices);
+        const TVertexID rangeStart = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+        
+        // The number of vertices is known up front, so the offsets can be allocated before the degrees are known and used to hold them in the meantime.
+        if (0 == globalThreadID)
+        {
+            ReleaseArenas();
+            std::vector<EdgeList*>().swap(vertexIndex);
+            ReleaseFrozenArrays();
+            
+            AllocateFrozenOffsets(numVertices);
+            numFrozenVertices = numVertices;
+            frozenSorted = false;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Count the degree of each vertex in this thread's range while gathering metadata.
+        buf[globalThreadID] = 0;
+        threadCounts[(globalThreadID * 3)] = 0;
+        threadCounts[(globalThreadID * 3) + 1] = 0;
+        threadCounts[(globalThreadID * 3) + 2] = 0;
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            TEdgeCount degree = ((i < index.numFrozenVertices) ? (index.frozenOffsets[i + 1] - index.frozenOffsets[i]) : 0);
+            
+            if (i < transposeIndex.numFrozenVertices)
+            {
+                for (TEdgeID edge = transposeIndex.frozenOffsets[i]; edge < transposeIndex.frozenOffsets[i + 1]; ++edge)
+                {
+                    if (i != transposeIndex.GetFrozenNeighbor(edge))
+                        degree += 1;
+                }
+            }
+            
+            if (0 != degree)
+            {
+                threadCounts[(globalThreadID * 3)] += degree;
+                threadCounts[(globalThreadID * 3) + 1] += ((degree + 3) >> 2);
+                threadCounts[(globalThreadID * 3) + 2] += 1;
+            }
+            
+            frozenOffsets[i] = degree;
+            buf[globalThreadID] += degree;
+        }
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            TEdgeCount numFrozenEdges = 0;
+            
+            numEdges = 0;
+            numVectors = 0;
+            numVerticesPresent = 0;
+            
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                const TEdgeCount rangeEdges = buf[i];
+                buf[i] = numFrozenEdges;
+                numFrozenEdges += rangeEdges;
+                
+                numEdges += threadCounts[(i * 3)];
+                numVectors += threadCounts[(i * 3) + 1];
+                numVerticesPresent += threadCounts[(i * 3) + 2];
+            }
+            
+            frozenOffsets[numVertices] = numFrozenEdges;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Convert each degree into the position of the first edge of its vertex.
+        TEdgeCount position = buf[globalThreadID];
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            const TEdgeCount degree = frozenOffsets[i];
+            
+            frozenOffsets[i] = position;
+            position += degree;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Edge arrays can only be placed once the offsets identify where each partition's edges begin.
+        if (0 == globalThreadID)
+            AllocateFrozenEdges(numVertices, numVertices, keepEdgeData);
+        
+        spindleBarrierGlobal();
+        
+        // Copy the edges of each top-level vertex, first from the specified index and then from its transpose.
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            TEdgeID position = frozenOffsets[i];
+            
+            if (i < index.numFrozenVertices)
+            {
+                for (TEdgeID edge = index.frozenOffsets[i]; edge < index.frozenOffsets[i + 1]; ++edge, ++position)
+                {
+                    SetFrozenNeighbor(position, index.GetFrozenNeighbor(edge));
+                    
+                    if (keepEdgeData)
+                    {
+                        if (NULL != index.frozenEdgeData)
+                            frozenEdgeData[position] = index.frozenEdgeData[edge];
+                        else
+                            frozenEdgeData[position].Invalidate();
+                    }
+                }
+            }
+            
+            if (i < transposeIndex.numFrozenVertices)
+            {
+                for (TEdgeID edge = transposeIndex.frozenOffsets[i]; edge < transposeIndex.frozenOffsets[i + 1]; ++edge)
+                {
+                    const TVertexID otherVertex = transposeIndex.GetFrozenNeighbor(edge);
+                    
+                    if (i == otherVertex)
+                        continue;
+                    
+                    SetFrozenNeighbor(position, otherVertex);
+                    
+                    if (keepEdgeData)
+                    {
+                        if (NULL != transposeIndex.frozenEdgeData)
+                            frozenEdgeData[position] = transposeIndex.frozenEdgeData[edge];
+                        else
+                            frozenEdgeData[position].Invalidate();
+                    }
+                    
+                    position += 1;
+                }
+            }
+        }
+        
+        spindleBarrierGlobal();
+    }
+    
+    // --------
+
+    void VertexIndex::ParallelTransposeFrom(const VertexIndex& otherIndex, const bool keepEdgeData, uint64_t* edgeBuf, uint64_t* buf)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        
+        // The buffer holds the partition offsets for each pair of owning thread and scanning thread, followed by a past-the-end element and then three counts per thread.
+        uint64_t* const partitionOffsets = buf;
+        uint64_t* const threadCounts = &buf[(globalThreadCount * globalThreadCount) + 1];
+        
+        spindleBarrierGlobal();
+        
+        // Each thread scans the edges of a contiguous range of top-level vertices in the other index and owns a contiguous range of top-level vertices in this index.
+        // Ranges are the same in both indices and match the frozen partition for each NUMA node.
+        const TVertexCount numVertices = otherIndex.numFrozenVertices;
+        const TVertexID rangeStart = (TVertexID)((numVertices * globalThreadID) / globalThreadCount);
+        const TVertexID rangeEnd = (TVertexID)((numVertices * (globalThreadID + 1)) / globalThreadCount);
+        const TEdgeCount* const otherOffsets = otherIndex.frozenOffsets;
+        
+        // Inverts the range computation above to find the thread that owns each vertex.
+        auto ownerOfVertex = [numVertices, globalThreadCount](const TVertexID vertex) -> uint32_t
+        {
+            return (uint32_t)((((vertex + 1) * globalThreadCount) - 1) / numVertices);
+        };
+        
+        // Count the edges in this thread's range that belong to each owner.
+        std::vector<uint64_t> positions(globalThreadCount, 0);
+        
+        for (TEdgeID edge = otherOffsets[rangeStart]; edge < otherOffsets[rangeEnd]; ++edge)
+            positions[ownerOfVertex(otherIndex.GetFrozenNeighbor(edge))] += 1;
+        
+        for (uint32_t owner = 0; owner < globalThreadCount; ++owner)
+            partitionOffsets[(owner * globalThreadCount) + globalThreadID] = positions[owner];
+        
+        spindleBarrierGlobal();
+        
+        // Lay out each owner's edges contiguously, ordered by the range from which they came, and discard the existing contents of this index.
+        // Each owner's edges then begin exactly where its portion of the frozen arrays begins.
+        if (0 == globalThreadID)
+        {
+            uint64_t position = 0;
+        
+            for (uint32_t i = 0; i < (globalThreadCount * globalThreadCount); ++i)
+            {
+                const uint64_t rangeEdges = partitionOffsets[i];
+                partitionOffsets[i] = position;
+                position += rangeEdges;
+            }
+        
+            partitionOffsets[globalThreadCount * globalThreadCount] = position;
+        
+            ReleaseArenas();
+            std::vector<EdgeList*>().swap(vertexIndex);
+            ReleaseFrozenArrays();
+        
+            AllocateFrozenOffsets(numVertices);
+            frozenOffsets[numVertices] = (TEdgeCount)position;
+            numFrozenVertices = numVertices;
+            frozenSorted = false;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Record the top-level vertex and position of each edge in this thread's range within its owner's partition.
+        for (uint32_t owner = 0; owner < globalThreadCount; ++owner)
+            positions[owner] = partitionOffsets[(owner * globalThreadCount) + globalThreadID];
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            for (TEdgeID edge = otherOffsets[i]; edge < otherOffsets[i + 1]; ++edge)
+            {
+                const uint64_t partitionPosition = positions[ownerOfVertex(otherIndex.GetFrozenNeighbor(edge))]++;
+        
+                edgeBuf[(partitionPosition << 1)] = (uint64_t)i;
+                edgeBuf[(partitionPosition << 1) + 1] = (uint64_t)edge;
+            }
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Count the degree of each vertex owned by this thread, then convert degrees into offsets while gathering metadata.
+        const uint64_t partitionStart = partitionOffsets[globalThreadID * globalThreadCount];
+        const uint64_t partitionEnd = partitionOffsets[(globalThreadID + 1) * globalThreadCount];
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+            frozenOffsets[i] = 0;
+        
+        for (uint64_t i = partitionStart; i < partitionEnd; ++i)
+            frozenOffsets[otherIndex.GetFrozenNeighbor((TEdgeID)edgeBuf[(i << 1) + 1])] += 1;
+        
+        TEdgeCount position = (TEdgeCount)partitionStart;
+        threadCounts[(globalThreadID * 3)] = 0;
+        threadCounts[(globalThreadID * 3) + 1] = 0;
+        threadCounts[(globalThreadID * 3) + 2] = 0;
+        
+        for (TVertexID i = rangeStart; i < rangeEnd; ++i)
+        {
+            const TEdgeCount degree = frozenOffsets[i];
+        
+            if (0 != degree)
+            {
+                threadCounts[(globalThreadID * 3)] += degree;
+                threadCounts[(globalThreadID * 3) + 1] += ((degree + 3) >> 2);
+                threadCounts[(globalThreadID * 3) + 2] += 1;
+            }
+        
+            frozenOffsets[i] = position;
+            position += degree;
+        }
+        
+        spindleBarrierGlobal();
+        
+        // Edge arrays can only be placed once the offsets identify where each partition's edges begin.
+        // Every identifier is less than the number of vertices, so that number determines whether the frozen neighbors can be compact.
+        if (0 == globalThreadID)
+            AllocateFrozenEdges(numVertices, numVertices, keepEdgeData);
+        
+        spindleBarrierGlobal();
+        
+        // Place each edge, advancing the offset of its top-level vertex as a cursor.
+        // Edges arrive in ascending order of their top-level vertex in the other index, which becomes the other vertex here.
+        for (uint64_t i = partitionStart; i < partitionEnd; ++i)
+        {
+            const TEdgeID otherPosition = (TEdgeID)edgeBuf[(i << 1) + 1];
+            const TEdgeID position = frozenOffsets[otherIndex.GetFrozenNeighbor(otherPosition)]++;
+        
+            SetFrozenNeighbor(position, (TVertexID)edgeBuf[(i << 1)]);
+        
+            if (keepEdgeData)
+                frozenEdgeData[position] = otherIndex.frozenEdgeData[otherPosition];
+        }
+        
+        // Each cursor now holds the offset of the next vertex, so shifting them by one restores the offsets.
+        for (TVertexID i = rangeEnd; i > rangeStart; --i)
+            frozenOffsets[i - 1] = (((i - 1) > rangeStart) ? frozenOffsets[i - 2] : (TEdgeCount)partitionStart);
+        
+        spindleBarrierGlobal();
+        
+        if (0 == globalThreadID)
+        {
+            numEdges = 0;
+            numVectors = 0;
+            numVerticesPresent = 0;
+        
+            for (uint32_t i = 0; i < globalThreadCount; ++i)
+            {
+                numEdges += threadCounts[(i * 3)];
+                numVectors += threadCounts[(i * 3) + 1];
+                numVerticesPresent += threadCounts[(i * 3) + 2];
+            }
+        
+            frozenSorted = true;
+        }
+        
+        spindleBarrierGlobal();
+    }
+
+    // --------
+
+    void VertexIndex::RemoveEdge(const TVertexID indexedVertex, const TVertexID otherVertex)
+    {
+        if (IsFrozen())
+        {
+            if (indexedVertex >= numFrozenVertices)
+                return;
+            
+            const TEdgeCount segmentStart = frozenOffsets[indexedVertex];
+            const TEdgeCount segmentEnd = frozenOffsets[indexedVertex + 1];
+            const TEdgeCount oldDegree = segmentEnd - segmentStart;
+            TEdgeCount newDegree = 0;
+            
+            if (frozenSorted)
+            {
+                // Matching edges are contiguous, so their positions can be found by binary search and then removed by shifting the rest of the segment down.
+                TEdgeCount matchStart = segmentStart;
+                TEdgeCount matchEnd = segmentStart;
+                
+                if (frozenNeighborsCompact)
+                {
+                    // A compact neighbor array cannot contain any identifier too large to be stored in it.
+                    if (otherVertex >= kMaxCompactVertexCount)
+                        return;
+                    
+                    const TCompactVertexID* const compactNeighbors = (const TCompactVertexID*)frozenNeighbors;
+                    const auto matchRange = std::equal_range(&compactNeighbors[segmentStart], &compactNeighbors[segmentEnd], (TCompactVertexID)otherVertex);
+                    matchStart = (TEdgeCount)(matchRange.first - compactNeighbors);
+                    matchEnd = (TEdgeCount)(matchRange.second - compactNeighbors);
+                }
+                else
+                {
+                    const TVertexID* const neighbors = (const TVertexID*)frozenNeighbors;
+                    const auto matchRange = std::equal_range(&neighbors[segmentStart], &neighbors[segmentEnd], otherVertex);
+                    matchStart = (TEdgeCount)(matchRange.first - neighbors);
+                    matchEnd = (TEdgeCount)(matchRange.second - neighbors);
+                }
+                
+                if (matchStart == matchEnd)
+                    return;
+                
+                MoveFrozenNeighbors(matchStart, matchEnd, segmentEnd - matchEnd);
+                
+                if (NULL != frozenEdgeData)
+                    memmove((void*)&frozenEdgeData[matchStart], (void*)&frozenEdgeData[matchEnd], sizeof(UEdgeData) * (segmentEnd - matchEnd));
+                
+                newDegree = oldDegree - (matchEnd - matchStart);
+            }
+            else
+            {
+                for (TEdgeCount i = segmentStart; i < segmentEnd; ++i)
+                {
+                    const TVertexID neighbor = GetFrozenNeighbor(i);
+                    
+                    if (otherVertex != neighbor)
+                    {
+                        SetFrozenNeighbor(segmentStart + newDegree, neighbor);
+                        
+                        if (NULL != frozenEdgeData)
+                            frozenEdgeData[segmentStart + newDegree] = frozenEdgeData[i];
+                        
+                        newDegree += 1;
+                    }
+                }
+                
+                if (newDegree == oldDegree)
+                    return;
+            }
+            
+            // Close the gap left at the end of the segment by shifting all subsequent edges down.
+            const TEdgeCount numRemoved = oldDegree - newDegree;
+            const TEdgeCount numFrozenEdges = frozenOffsets[numFrozenVertices];
+            
+            MoveFrozenNeighbors(segmentEnd - numRemoved, segmentEnd, numFrozenEdges - segmentEnd);
+            
+            if (NULL != frozenEdgeData)
+                memmove((void*)&frozenEdgeData[segmentEnd - numRemoved], (void*)&frozenEdgeData[segmentEnd], sizeof(UEdgeData) * (numFrozenEdges - segmentEnd));
+            
+            for (TVertexID i = indexedVertex + 1; i <= numFrozenVertices; ++i)
+                frozenOffsets[i] -= numRemoved;
+            
+            numEdges -= numRemoved;
+            numVectors -= (((oldDegree + 3) >> 2) - ((newDegree + 3) >> 2));
+            
+            if (0 == newDegree)
+                numVerticesPresent -= 1;
+            
+            return;
+        }
+        
+        if (NULL != vertexIndex[indexedVertex])
+        {
+            const TEdgeCount oldDegree = vertexIndex[indexedVertex]->GetDegree();
+            const size_t oldVectors = vertexIndex[indexedVertex]->GetNumVectors();
+
+            vertexIndex[indexedVertex]->RemoveEdge(otherVertex);
+
+            numEdges -= (oldDegree - vertexIndex[indexedVertex]->GetDegree());
+            numVectors -= (oldVectors - vertexIndex[indexedVertex]->GetNumVectors());
+
+            if (0 == vertexIndex[indexedVertex]->GetDegree())
+            {
+                // Edge list memory is reclaimed when its arena is released.
+                vertexIndex[indexedVertex] = NULL;
+                numVerticesPresent -= 1;
+            }
+        }
+    }
+
+    // --------
+
+    void VertexIndex::RemoveVertex(const TVertexID indexedVertex)
+    {
+        Thaw();
+        
+        if (NULL != vertexIndex[indexedVertex])
+        {
+            numEdges -= vertexIndex[indexedVertex]->GetDegree();
+            numVectors -= vertexIndex[indexedVertex]->GetNumVectors();
+            
+            // Edge list memory is reclaimed when its arena is released.
+            vertexIndex[indexedVertex] = NULL;
+            numVerticesPresent -= 1;
+        }
+    }
+
+    // --------
+
+    void VertexIndex::RemoveVertexAndReferencesFrozen(const TVertexID vertex)
+    {
+        if (!IsFrozen())
+            return;
+        
+        TEdgeCount position = 0;
+        
+        numEdges = 0;
+        numVectors = 0;
+        numVerticesPresent = 0;
+        
+        for (TVertexID i = 0; i < numFrozenVertices; ++i)
+        {
+            const TEdgeCount segmentStart = frozenOffsets[i];
+            const TEdgeCount segmentEnd = frozenOffsets[i + 1];
+            
+            frozenOffsets[i] = position;
+            
+            if (vertex == i)
+                continue;
+            
+            for (TEdgeCount j = segmentStart; j < segmentEnd; ++j)
+            {
+                const TVertexID neighbor = GetFrozenNeighbor(j);
+                
+                if (vertex != neighbor)
+                {
+                    SetFrozenNeighbor(position, neighbor);
+                    
+                    if (NULL != frozenEdgeData)
+                        frozenEdgeData[position] = frozenEdgeData[j];
+                    
+                    position += 1;
+                }
+            }
+            
+            const TEdgeCount degree = position - frozenOffsets[i];
+            
+            if (0 != degree)
+            {
+                numEdges += degree;
+                numVectors += ((degree + 3) >> 2);
+                numVerticesPresent += 1;
+            }
+        }
+        
+        frozenOffsets[numFrozenVertices] = position;
+    }
+    
+    // --------
+    
+    void VertexIndex::SetNumVertices(const TVertexCount numVertices)
+    {
+        Thaw();
+        
+        if (numVertices < vertexIndex.size())
+        {
+            for (size_t i = numVertices; i < vertexIndex.size(); ++i)
+            {
+                if (NULL != vertexIndex[i])
+                {
+                    // Edge list memory is reclaimed when its arena is released.
+                    vertexIndex[i] = NULL;
+                    numVerticesPresent -= 1;
+                }
+            }
+        }
+        
+        vertexIndex.resize(numVertices, NULL);
+    }
+    
+    // --------
+    
+    void VertexIndex::Swap(VertexIndex& other)
+    {
+        vertexIndex.swap(other.vertexIndex);
+        arenas.swap(other.arenas);
+        std::swap(numEdges, other.numEdges);
+        std::swap(numVerticesPresent, other.numVerticesPresent);
+        std::swap(numVectors, other.numVectors);
+        std::swap(numFrozenVertices, other.numFrozenVertices);
+        std::swap(frozenOffsets, other.frozenOffsets);
+        std::swap(frozenNeighbors, other.frozenNeighbors);
+        std::swap(frozenNeighborsCompact, other.frozenNeighborsCompact);
+        std::swap(frozenEdgeData, other.frozenEdgeData);
+        std::swap(frozenMapping, other.frozenMapping);
+        std::swap(frozenMappingSize, other.frozenMappingSize);
+        std::swap(preallocatedCursors, other.preallocatedCursors);
+        std::swap(frozenSorted, other.frozenSorted);
+        frozenPartitionStarts.swap(other.frozenPartitionStarts);
+        frozenPartitionNUMANodes.swap(other.frozenPartitionNUMANodes);
+    }
+    
+    // --------
+    
+    void VertexIndex::Thaw(void)
+    {
+        if (!IsFrozen())
+            return;
+        
+        vertexIndex.resize(numFrozenVertices, NULL);
+        
+        for (TVertexID i = 0; i < numFrozenVertices; ++i)
+        {
+            if (frozenOffsets[i] == frozenOffsets[i + 1])
+                continue;
+            
+            vertexIndex[i] = EdgeList::CreateInArena(GetSerialArena(), (NULL != frozenEdgeData));
+            
+            for (TEdgeCount j = frozenOffsets[i]; j < frozenOffsets[i + 1]; ++j)
+            {
+                // The "other" vertex in an edge list is stored as the destination, and edge data are carried over bit-for-bit.
+                if (NULL != frozenEdgeData)
+                {
+                    const SEdge<uint64_t> edge = { i, GetFrozenNeighbor(j), frozenEdgeData[j].u };
+                    vertexIndex[i]->InsertEdgeUsingDestination(edge);
+                }
+                else
+                {
+                    const SEdge<void> edge = { i, GetFrozenNeighbor(j) };
+                    vertexIndex[i]->InsertEdgeUsingDestination(edge);
+                }
+            }
+        }
+        
+        ReleaseFrozenArrays();
+        numFrozenVertices = 0;
+        frozenSorted = false;
     }
     
     
@@ -204,8 +1785,12 @@ namespace GraphTool
     template void VertexIndex::InsertEdgeIndexedByDestination(const SEdge<void>& edge);
     template void VertexIndex::InsertEdgeIndexedByDestination(const SEdge<uint64_t>& edge);
     template void VertexIndex::InsertEdgeIndexedByDestination(const SEdge<double>& edge);
+    template void VertexIndex::InsertEdgeIndexedByDestination(const SEdge<uint32_t>& edge);
+    template void VertexIndex::InsertEdgeIndexedByDestination(const SEdge<float>& edge);
     
     template void VertexIndex::InsertEdgeIndexedBySource(const SEdge<void>& edge);
     template void VertexIndex::InsertEdgeIndexedBySource(const SEdge<uint64_t>& edge);
     template void VertexIndex::InsertEdgeIndexedBySource(const SEdge<double>& edge);
+    template void VertexIndex::InsertEdgeIndexedBySource(const SEdge<uint32_t>& edge);
+    template void VertexIndex::InsertEdgeIndexedBySource(const SEdge<float>& edge);
 }
@@ -0,0 +1,187 @@
+/*****************************************************************************
+ * GraphTool
+ *   Tools for manipulating graphs.
+ *****************************************************************************
+ * Authored by Samuel Grossman
+ * Department of Electrical Engineering, Stanford University
+ * Copyright (c) 2016-2017
+ *************************************************************************//**
+ * @file WorkScheduler.cpp
+ *   Implementation of a scheduler that divides the vertices of a frozen
+ *   vertex index among threads by the number of edges they hold.
+ *****************************************************************************/
+
+#include "NUMASpawner.h"
+#include "Types.h"
+#include "WorkScheduler.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <spindle.h>
+
+
+namespace GraphTool
+{
+    // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
+    // See "WorkScheduler.h" for documentation.
+
+    WorkScheduler::WorkScheduler(void) : offsets(NULL), splitsVertices(false), threadStates(NULL), numThreadStates(0)
+    {
+        // Nothing to do here.
+    }
+
+    // --------
+
+    WorkScheduler::~WorkScheduler(void)
+    {
+        if (NULL != threadStates)
+            delete[] threadStates;
+    }
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+    // See "WorkScheduler.h" for documentation.
+
+    bool WorkScheduler::ClaimUnit(const uint32_t owner, SWorkUnit& unit)
+    {
+        SThreadState& threadState = threadStates[owner];
+
+        // Checking first avoids advancing the counter of a thread whose units are all claimed, which would otherwise keep its cache line bouncing between stealing threads.
+        if (threadState.nextUnit.load(std::memory_order_relaxed) >= threadState.endUnit)
+            return false;
+
+        const uint64_t unitIndex = threadState.nextUnit.fetch_add(1, std::memory_order_relaxed);
+
+        if (unitIndex >= threadState.endUnit)
+            return false;
+
+        DescribeUnit(threadState, unitIndex, unit);
+        return true;
+    }
+
+    // --------
+
+    void WorkScheduler::DescribeUnit(const SThreadState& threadState, const uint64_t unitIndex, SWorkUnit& unit) const
+    {
+        const uint64_t workStart = threadState.taskWorkStart + (unitIndex * threadState.unitWork);
+        const uint64_t workEnd = (((workStart + threadState.unitWork) < threadState.taskWorkEnd) ? (workStart + threadState.unitWork) : threadState.taskWorkEnd);
+
+        if (splitsVertices)
+        {
+            // Work is measured in edges, so the unit begins with whichever vertex holds its first edge and ends before the first vertex whose edges all follow it.
+            unit.vertexStart = FindVertexByWork(threadState.taskVertexStart + 1, threadState.taskVertexEnd, workStart + 1) - 1;
+            unit.vertexEnd = FindVertexByWork(unit.vertexStart, threadState.taskVertexEnd, workEnd);
+            unit.edgeStart = (TEdgeID)workStart;
+            unit.edgeEnd = (TEdgeID)workEnd;
+        }
+        else
+        {
+            // Each vertex belongs to whichever unit holds the work of the vertex itself, which precedes the work of its edges.
+            unit.vertexStart = FindVertexByWork(threadState.taskVertexStart, threadState.taskVertexEnd, workStart);
+            unit.vertexEnd = FindVertexByWork(unit.vertexStart, threadState.taskVertexEnd, workEnd);
+            unit.edgeStart = offsets[unit.vertexStart];
+            unit.edgeEnd = offsets[unit.vertexEnd];
+        }
+    }
+
+    // --------
+
+    TVertexID WorkScheduler::FindVertexByWork(TVertexID vertexStart, TVertexID vertexEnd, const uint64_t work) const
+    {
+        while (vertexStart < vertexEnd)
+        {
+            const TVertexID vertexMiddle = vertexStart + ((vertexEnd - vertexStart) >> 1);
+
+            if (WorkBeforeVertex(vertexMiddle) < work)
+                vertexStart = vertexMiddle + 1;
+            else
+                vertexEnd = vertexMiddle;
+        }
+
+        return vertexStart;
+    }
+
+
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "WorkScheduler.h" for documentation.
+
+    bool WorkScheduler::GetWork(SWorkUnit& unit)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+
+        if (ClaimUnit(globalThreadID, unit))
+            return true;
+
+        // Other threads in the same task work on the same NUMA node, so their units are stolen first.
+        const uint32_t localThreadID = spindleGetLocalThreadID();
+        const uint32_t localThreadCount = spindleGetLocalThreadCount();
+        const uint32_t firstTaskThreadID = globalThreadID - localThreadID;
+
+        for (uint32_t i = 1; i < localThreadCount; ++i)
+        {
+            if (ClaimUnit(firstTaskThreadID + ((localThreadID + i) % localThreadCount), unit))
+                return true;
+        }
+
+        for (uint32_t i = localThreadCount; i < numThreadStates; ++i)
+        {
+            if (ClaimUnit((firstTaskThreadID + i) % numThreadStates, unit))
+                return true;
+        }
+
+        return false;
+    }
+
+    // --------
+
+    void WorkScheduler::ParallelInitialize(const TEdgeCount* const offsets, const TVertexCount numVertices, const bool splitsVertices)
+    {
+        const uint32_t globalThreadID = spindleGetGlobalThreadID();
+        const uint32_t globalThreadCount = spindleGetGlobalThreadCount();
+        const uint64_t localThreadID = (uint64_t)spindleGetLocalThreadID();
+        const uint64_t localThreadCount = (uint64_t)spindleGetLocalThreadCount();
+
+        spindleBarrierGlobal();
+
+        if (0 == globalThreadID)
+        {
+            if (numThreadStates != globalThreadCount)
+            {
+                if (NULL != threadStates)
+                    delete[] threadStates;
+
+                threadStates = new SThreadState[globalThreadCount];
+                numThreadStates = globalThreadCount;
+            }
+
+            this->offsets = offsets;
+            this->splitsVertices = splitsVertices;
+        }
+
+        spindleBarrierGlobal();
+
+        // Every thread in a task computes the same division of the task's work, and then takes note of its own share of the units.
+        uint64_t taskVertexStart = 0;
+        uint64_t taskVertexEnd = 0;
+        NUMASpawner::GetCurrentTaskUnitRange(numVertices, taskVertexStart, taskVertexEnd);
+
+        SThreadState& threadState = threadStates[globalThreadID];
+        threadState.taskVertexStart = (TVertexID)taskVertexStart;
+        threadState.taskVertexEnd = (TVertexID)taskVertexEnd;
+        threadState.taskWorkStart = ((taskVertexStart < taskVertexEnd) ? WorkBeforeVertex((TVertexID)taskVertexStart) : 0);
+        threadState.taskWorkEnd = ((taskVertexStart < taskVertexEnd) ? WorkBeforeVertex((TVertexID)taskVertexEnd) : 0);
+
+        const uint64_t taskWork = threadState.taskWorkEnd - threadState.taskWorkStart;
+        const uint64_t targetUnitWork = (taskWork + (localThreadCount * kUnitsPerThread) - 1) / (localThreadCount * kUnitsPerThread);
+
+        threadState.unitWork = ((targetUnitWork > kMinUnitWork) ? targetUnitWork : kMinUnitWork);
+
+        const uint64_t taskUnits = (taskWork + threadState.unitWork - 1) / threadState.unitWork;
+
+        threadState.nextUnit.store((taskUnits * localThreadID) / localThreadCount, std::memory_order_relaxed);
+        threadState.endUnit = (taskUnits * (localThreadID + 1)) / localThreadCount;
+
+        spindleBarrierGlobal();
+    }
+}
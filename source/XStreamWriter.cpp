@@ -13,34 +13,198 @@
 #include "BinaryEdgeListWriter.h"
 #include "Graph.h"
 #include "Types.h"
+#include "VertexIndex.h"
 #include "XStreamWriter.h"
 
 #include <cstddef>
 #include <cstdlib>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <immintrin.h>
+#include <vector>
 
 
 namespace GraphTool
 {
+    // -------- LOCALS ----------------------------------------------------- //
+
+    /// Option name for specifying the number of streaming partitions into which edges are pre-partitioned.
+    static const char* const kWriterOptionStreamingPartitions = "streampartitions";
+
+    /// Largest number of vertices whose identifiers all fit in X-Stream's 32-bit vertex identifiers.
+    static const uint64_t kMaxVertices = 1ull << 32;
+
+    /// Mask that selects the upper 32 bits of a 64-bit value, which must all be zero for the value to fit in 32 bits.
+    static const uint64_t kUpper32BitsMask = 0xffffffff00000000ull;
+
+
+    // -------- HELPERS ---------------------------------------------------- //
+
+    /// Stores the weight of the specified edge in single precision, which is how X-Stream represents edge weights.
+    /// @tparam TEdgeData Specifies the type of data, such as a weight, to hold for each edge.
+    /// @param [out] packed Location to receive the weight.
+    /// @param [in] edge Edge whose weight should be stored.
+    template <typename TEdgeData> static inline void PackEdgeWeight(uint32_t* const packed, const SEdge<TEdgeData>& edge)
+    {
+        const float weight = (float)edge.edgeData;
+        memcpy((void*)packed, (const void*)&weight, sizeof(weight));
+    }
+
+    /// Determines if every 64-bit value that has been bitwise ORed into the specified vector fits in 32 bits.
+    /// @param [in] values Bitwise OR of the values to check.
+    /// @return `true` if the upper 32 bits of every lane are zero, `false` otherwise.
+    static inline bool VectorFitsIn32Bits(const __m256i values)
+    {
+        return (0 != _mm256_testz_si256(values, _mm256_set1_epi64x((long long)kUpper32BitsMask)));
+    }
+
+
     // -------- CONSTRUCTION AND DESTRUCTION ------------------------------- //
 
-    template <typename TEdgeData> XStreamWriter<TEdgeData>::XStreamWriter(void) : graphTypeIdentifier("1")
+    template <typename TEdgeData> XStreamWriter<TEdgeData>::XStreamWriter(void) : graphTypeIdentifier("1"), numStreamingPartitions(0), packedEdges()
     {
         // Nothing to do here.
     }
 
     // --------
 
-    template <> XStreamWriter<void>::XStreamWriter(void) : graphTypeIdentifier("2")
+    template <> XStreamWriter<void>::XStreamWriter(void) : graphTypeIdentifier("2"), numStreamingPartitions(0), packedEdges()
     {
         // Nothing to do here.
     }
 
+
+    // -------- CLASS METHODS ---------------------------------------------- //
+    // See "XStreamWriter.h" for documentation.
+
+    template <typename TEdgeData> bool XStreamWriter<TEdgeData>::PackEdges(uint32_t* const packed, const SEdge<TEdgeData>* buf, const size_t count)
+    {
+        // Each pair of edges spans 48 bytes, which are loaded as two overlapping vectors that hold the first edge in their lower three lanes and the second edge in their upper three lanes, respectively.
+        // Vertex identifiers of both edges are narrowed into 32-bit lanes 0, 1, 3, and 4, leaving lanes 2 and 5 for the weights.
+        const __m256i firstVertexMask = _mm256_setr_epi64x(-1ll, -1ll, 0ll, 0ll);
+        const __m256i secondVertexMask = _mm256_setr_epi64x(0ll, -1ll, -1ll, 0ll);
+        const __m256i firstIndices = _mm256_setr_epi32(0, 2, 0, 0, 0, 0, 0, 0);
+        const __m256i secondIndices = _mm256_setr_epi32(0, 0, 0, 2, 4, 0, 0, 0);
+        __m256i overflow = _mm256_setzero_si256();
+        uint64_t remainingOverflow = 0ull;
+        size_t i = 0;
+
+        for (; (i + 2) <= count; i += 2)
+        {
+            const __m256i first = _mm256_loadu_si256((const __m256i*)&buf[i]);
+            const __m256i second = _mm256_loadu_si256((const __m256i*)&buf[i].edgeData);
+
+            overflow = _mm256_or_si256(overflow, _mm256_or_si256(_mm256_and_si256(first, firstVertexMask), _mm256_and_si256(second, secondVertexMask)));
+            _mm256_storeu_si256((__m256i*)&packed[3 * i], _mm256_blend_epi32(_mm256_permutevar8x32_epi32(first, firstIndices), _mm256_permutevar8x32_epi32(second, secondIndices), 0x18));
+
+            PackEdgeWeight(&packed[(3 * i) + 2], buf[i]);
+            PackEdgeWeight(&packed[(3 * i) + 5], buf[i + 1]);
+        }
+
+        for (; i < count; ++i)
+        {
+            packed[(3 * i) + 0] = (uint32_t)buf[i].sourceVertex;
+            packed[(3 * i) + 1] = (uint32_t)buf[i].destinationVertex;
+            PackEdgeWeight(&packed[(3 * i) + 2], buf[i]);
+
+            remainingOverflow |= ((uint64_t)buf[i].sourceVertex | (uint64_t)buf[i].destinationVertex);
+        }
+
+        return (VectorFitsIn32Bits(overflow) && (0ull == (remainingOverflow & kUpper32BitsMask)));
+    }
+
+    // --------
+
+    template <> bool XStreamWriter<void>::PackEdges(uint32_t* const packed, const SEdge<void>* buf, const size_t count)
+    {
+        // Each vector holds two edges, whose vertex identifiers are narrowed into the lower four 32-bit lanes.
+        const __m256i packIndices = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+        __m256i overflow = _mm256_setzero_si256();
+        uint64_t remainingOverflow = 0ull;
+        size_t i = 0;
+
+        for (; (i + 2) <= count; i += 2)
+        {
+            const __m256i vertices = _mm256_loadu_si256((const __m256i*)&buf[i]);
+
+            overflow = _mm256_or_si256(overflow, vertices);
+            _mm_storeu_si128((__m128i*)&packed[2 * i], _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(vertices, packIndices)));
+        }
+
+        for (; i < count; ++i)
+        {
+            packed[(2 * i) + 0] = (uint32_t)buf[i].sourceVertex;
+            packed[(2 * i) + 1] = (uint32_t)buf[i].destinationVertex;
+
+            remainingOverflow |= ((uint64_t)buf[i].sourceVertex | (uint64_t)buf[i].destinationVertex);
+        }
+
+        return (VectorFitsIn32Bits(overflow) && (0ull == (remainingOverflow & kUpper32BitsMask)));
+    }
+
+
+    // -------- INSTANCE METHODS ------------------------------------------- //
+    // See "XStreamWriter.h" for documentation.
+
+    template <typename TEdgeData> void XStreamWriter<TEdgeData>::WriteStreamingPartitionsToMetadataFile(FILE* const metafile, const Graph& graph, const bool groupedByDestination) const
+    {
+        const VertexIndex& vertexIndex = (groupedByDestination ? graph.VertexIndexDestination() : graph.VertexIndexSource());
+        const SGraphPartition& partition = this->GetPartition();
+        const uint64_t numVertices = (uint64_t)this->GetNumVerticesToWrite(graph);
+        const uint64_t verticesPerPartition = ((0ull == numVertices) ? 1ull : ((numVertices + (uint64_t)numStreamingPartitions - 1ull) / (uint64_t)numStreamingPartitions));
+        std::vector<uint64_t> partitionEdgeCounts(numStreamingPartitions, 0ull);
+
+        // Edges are written in order of top-level vertex, so the edges of each streaming partition are already consecutive in the file.
+        for (TVertexID vertex = 0; vertex < vertexIndex.GetNumVertices(); ++vertex)
+        {
+            if (partition.ContainsVertex(vertex))
+                partitionEdgeCounts[(size_t)((uint64_t)vertex / verticesPerPartition)] += (uint64_t)vertexIndex.GetDegree(vertex);
+        }
+
+        fputs("[partitions]\n", metafile);
+        fprintf(metafile, "count=%llu\n", (long long unsigned int)numStreamingPartitions);
+        fprintf(metafile, "vertices=%llu\n", (long long unsigned int)verticesPerPartition);
+        fputs("edges=", metafile);
+
+        for (size_t i = 0; i < partitionEdgeCounts.size(); ++i)
+            fprintf(metafile, ((0 == i) ? "%llu" : ",%llu"), (long long unsigned int)partitionEdgeCounts[i]);
+
+        fputs("\n", metafile);
+    }
+
+
+    // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
+    // See "IGraphWriter.h" for documentation.
+
+    template <typename TEdgeData> bool XStreamWriter<TEdgeData>::SubmitOption(const char* const optionName, const char* const optionValue)
+    {
+        if (0 == strcmp(optionName, kWriterOptionStreamingPartitions))
+        {
+            char* valueEnd = NULL;
+            const uint64_t value = (uint64_t)strtoull(optionValue, &valueEnd, 10);
+
+            if (('\0' == optionValue[0]) || ('-' == optionValue[0]) || ('\0' != *valueEnd) || (0 == value) || (value > (uint64_t)UINT32_MAX))
+                return false;
+
+            numStreamingPartitions = (uint32_t)value;
+            return true;
+        }
+
+        return GraphWriter<TEdgeData>::SubmitOption(optionName, optionValue);
+    }
+
     
     // -------- CONCRETE INSTANCE METHODS ---------------------------------- //
     // See "GraphWriter.h" for documentation.
 
+    template <typename TEdgeData> GraphWriter<TEdgeData>* XStreamWriter<TEdgeData>::CreatePartitionWriter(void) const
+    {
+        return new XStreamWriter<TEdgeData>(*this);
+    }
+
+    // --------
+
     template <typename TEdgeData> FILE* XStreamWriter<TEdgeData>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
     {
         // Obtain the filename of the metadata file.
@@ -59,31 +223,62 @@ namespace GraphTool
         fputs("[graph]\n", metafile);
         fprintf(metafile, "type=%s\n", graphTypeIdentifier);
         fprintf(metafile, "name=%s\n", filename);
-        fprintf(metafile, "vertices=%llu\n", (long long unsigned int)graph.GetNumVertices());
-        fprintf(metafile, "edges=%llu\n", (long long unsigned int)graph.GetNumEdges());
+        fprintf(metafile, "vertices=%llu\n", (long long unsigned int)this->GetNumVerticesToWrite(graph));
+        fprintf(metafile, "edges=%llu\n", (long long unsigned int)this->GetNumEdgesToWrite(graph));
+
+        if (0 != numStreamingPartitions)
+            WriteStreamingPartitionsToMetadataFile(metafile, graph, groupedByDestination);
 
         if (ferror(metafile))
+        {
+            fclose(metafile);
             return NULL;
+        }
 
         fclose(metafile);
         
         // Open the binary file that will receive graph data itself.
-        return fopen(filename, "wb");
+        FILE* graphfile = this->OpenGraphFileForWrite(filename);
+
+        if ((NULL != graphfile) && ((uint64_t)this->GetNumVerticesToWrite(graph) > kMaxVertices))
+            this->ReportFormatError();
+
+        return graphfile;
     }
 
     // --------
 
-    template <> FILE* XStreamWriter<uint64_t>::OpenAndInitializeGraphFileForWrite(const char* const filename, const Graph& graph, const bool groupedByDestination)
+    template <typename TEdgeData> bool XStreamWriter<TEdgeData>::SupportsEdgeSource(void) const
     {
-        // X-Stream does not support integer-weighted graphs.
-        return NULL;
+        return true;
     }
 
     // --------
 
-    template <typename TEdgeData> void XStreamWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination)
+    template <typename TEdgeData> bool XStreamWriter<TEdgeData>::SupportsStreaming(void) const
     {
-        fwrite((void*)buf, sizeof(const SEdge<TEdgeData>), count, graphfile);
+        // Streamed edges arrive in the order of the input file, so they cannot be pre-partitioned.
+        return (0 == numStreamingPartitions);
+    }
+
+    // --------
+
+    template <typename TEdgeData> void XStreamWriter<TEdgeData>::WriteEdgesToFile(FILE* const graphfile, const Graph& graph, const SEdge<TEdgeData>* buf, const size_t count, const bool groupedByDestination, const unsigned int currentPass)
+    {
+        // Pack the whole buffer and write it out at once, unless any vertex identifier would be truncated.
+        // Each 64-bit field of an edge is packed into a 32-bit field of X-Stream's record type.
+        const size_t numPackedElements = count * (sizeof(SEdge<TEdgeData>) / sizeof(uint64_t));
+
+        if (packedEdges.size() < (numPackedElements + kPackSlack))
+            packedEdges.resize(numPackedElements + kPackSlack);
+
+        if (!(PackEdges(packedEdges.data(), buf, count)))
+        {
+            this->ReportFormatError();
+            return;
+        }
+
+        fwrite((const void*)packedEdges.data(), sizeof(packedEdges[0]), numPackedElements, graphfile);
     }
 
 
@@ -92,4 +287,6 @@ namespace GraphTool
     template class XStreamWriter<void>;
     template class XStreamWriter<uint64_t>;
     template class XStreamWriter<double>;
+    template class XStreamWriter<uint32_t>;
+    template class XStreamWriter<float>;
 }